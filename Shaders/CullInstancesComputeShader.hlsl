@@ -0,0 +1,139 @@
+// Frustum- and Hi-Z-culls static instances on the GPU and builds the
+// instance stream and DrawIndexedInstancedIndirect arguments for
+// IndirectDrawPipeline
+
+cbuffer CullParams : register(b0)
+{
+    float4 FrustumPlanes[6];    // World space, normals point inwards
+    matrix OcclusionViewProjection; // View the Hi-Z pyramid was rendered with
+    float2 HiZSize;             // Mip 0 size in texels
+    uint HiZMipCount;
+    uint OcclusionEnabled;
+    uint InstanceCount;
+    uint3 Padding;
+};
+
+struct InstanceRecord
+{
+    float4 world0;              // World matrix rows, copied as is into
+    float4 world1;              // the instance stream
+    float4 world2;
+    float4 world3;
+    float3 boundsCenter;        // World-space AABB
+    uint groupIndex;
+    float3 boundsExtents;
+    uint padding;
+};
+
+StructuredBuffer<InstanceRecord> Instances : register(t0);
+Texture2D<float> HiZ : register(t1);                    // Farthest depth per texel
+RWByteAddressBuffer DrawArgs : register(u0);            // D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS, 20 bytes
+RWByteAddressBuffer VisibleInstances : register(u1);    // InstanceData, 68 bytes
+
+static const uint ARGS_STRIDE = 20;
+static const uint INSTANCE_COUNT_OFFSET = 4;
+static const uint START_INSTANCE_OFFSET = 16;
+static const uint INSTANCE_DATA_STRIDE = 68;
+static const uint INVALID_BONE_OFFSET = 0xFFFFFFFF;
+
+bool IsVisible(float3 center, float3 extents)
+{
+    [unroll]
+    for (uint i = 0; i < 6; i++)
+    {
+        float4 plane = FrustumPlanes[i];
+        float distance = dot(plane.xyz, center) + plane.w;
+        float radius = dot(abs(plane.xyz), extents);
+        if (distance + radius < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsOccluded(float3 center, float3 extents)
+{
+    if (OcclusionEnabled == 0)
+    {
+        return false;
+    }
+
+    // Screen rectangle and nearest depth of the box in the pyramid's view
+    float2 minUV = float2(1.0f, 1.0f);
+    float2 maxUV = float2(0.0f, 0.0f);
+    float minDepth = 1.0f;
+
+    [unroll]
+    for (uint i = 0; i < 8; i++)
+    {
+        float3 corner = center + extents * float3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+        float4 clip = mul(float4(corner, 1.0f), OcclusionViewProjection);
+
+        // Boxes crossing the near plane are always drawn
+        if (clip.w <= 0.0f || clip.z < 0.0f)
+        {
+            return false;
+        }
+
+        float3 ndc = clip.xyz / clip.w;
+        float2 uv = float2(ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f);
+        minUV = min(minUV, uv);
+        maxUV = max(maxUV, uv);
+        minDepth = min(minDepth, ndc.z);
+    }
+
+    // Parts outside the previous view have no depth to test against
+    if (any(minUV < 0.0f) || any(maxUV > 1.0f))
+    {
+        return false;
+    }
+
+    // Level where the rectangle spans at most two texels per axis
+    float2 size = (maxUV - minUV) * HiZSize;
+    uint mip = min((uint)ceil(log2(max(max(size.x, size.y), 1.0f))), HiZMipCount - 1);
+    uint2 mipSize = max(uint2(HiZSize) >> mip, uint2(1, 1));
+    uint2 minTexel = min(uint2(minUV * mipSize), mipSize - 1);
+    uint2 maxTexel = min(uint2(maxUV * mipSize), mipSize - 1);
+
+    float maxDepth = 0.0f;
+    for (uint y = minTexel.y; y <= maxTexel.y; y++)
+    {
+        for (uint x = minTexel.x; x <= maxTexel.x; x++)
+        {
+            maxDepth = max(maxDepth, HiZ.Load(int3(x, y, mip)));
+        }
+    }
+
+    return minDepth > maxDepth;
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 dispatchID : SV_DispatchThreadID)
+{
+    uint instanceIndex = dispatchID.x;
+    if (instanceIndex >= InstanceCount)
+    {
+        return;
+    }
+
+    InstanceRecord instance = Instances[instanceIndex];
+    if (!IsVisible(instance.boundsCenter, instance.boundsExtents) ||
+        IsOccluded(instance.boundsCenter, instance.boundsExtents))
+    {
+        return;
+    }
+
+    // Claim a slot in this group's range of the instance stream
+    uint args = instance.groupIndex * ARGS_STRIDE;
+    uint slot;
+    DrawArgs.InterlockedAdd(args + INSTANCE_COUNT_OFFSET, 1, slot);
+    slot += DrawArgs.Load(args + START_INSTANCE_OFFSET);
+
+    uint output = slot * INSTANCE_DATA_STRIDE;
+    VisibleInstances.Store4(output, asuint(instance.world0));
+    VisibleInstances.Store4(output + 16, asuint(instance.world1));
+    VisibleInstances.Store4(output + 32, asuint(instance.world2));
+    VisibleInstances.Store4(output + 48, asuint(instance.world3));
+    VisibleInstances.Store(output + 64, INVALID_BONE_OFFSET);
+}
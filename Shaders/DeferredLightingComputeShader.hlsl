@@ -0,0 +1,176 @@
+// Lights the G-buffer one 16x16 pixel tile per thread group, see
+// DeferredShading.h. Lights come from the same clustered lists as forward
+// shading; pixels nothing was drawn to are left alone.
+
+cbuffer LightingParams : register(b0)
+{
+    row_major float4x4 inverseViewProjection;
+    uint2 screenSize;
+    float2 depthToViewZ;        // viewZ = y / (depth - x)
+};
+
+cbuffer LightBuffer : register(b1)
+{
+    float4 ambientLight;        // w = ambient intensity
+    float4 cameraPosition;
+    uint4 clusterCounts;        // xyz = clusters per axis, w = directional light count
+    float4 clusterParams;       // x = depth slice scale, y = depth slice bias, zw = tiles per pixel
+};
+
+// Must match LightData in Light.h
+struct LightData
+{
+    float4 position;            // w = light type
+    float4 direction;           // w = range
+    float4 color;               // w = intensity
+    float4 attenuation;         // xyz = attenuation, w = inner cone angle
+    float4 shadowParams;        // x = outer cone angle, y = shadow bias, z = shadow strength, w = enabled
+    float4 shadowAtlasRect;     // Tile in atlas UV, xy = offset, zw = size; zero size when unshadowed
+    row_major float4x4 lightSpaceMatrix;    // World to atlas UV and depth when shadowed
+};
+
+static const float LIGHT_POINT = 1.0f;
+static const float LIGHT_SPOT = 2.0f;
+static const uint TILE_SIZE = 16;
+
+Texture2D<float4> albedoBuffer : register(t0);  // rgb = albedo, a = specular intensity
+Texture2D<float4> normalBuffer : register(t1);  // xyz = world normal, w = specular power
+Texture2D<float> depthBuffer : register(t2);
+
+// Clustered lighting, see ClusteredLighting.h
+StructuredBuffer<LightData> lights : register(t4);
+StructuredBuffer<uint2> clusterGrid : register(t5);      // offset, count
+StructuredBuffer<uint> lightIndices : register(t6);
+
+// Cached spot and directional shadows, see ShadowAtlas.h
+Texture2D<float> shadowAtlas : register(t7);
+SamplerComparisonState shadowSampler : register(s1);
+
+RWTexture2D<unorm float4> output : register(u0);
+
+// 1 where the light reaches worldPos, down to 1 - strength in full shadow
+float SampleShadow(LightData light, float3 worldPos)
+{
+    if (light.shadowAtlasRect.z <= 0.0f)
+    {
+        return 1.0f;
+    }
+
+    float4 shadowPos = mul(float4(worldPos, 1.0f), light.lightSpaceMatrix);
+    shadowPos.xyz /= shadowPos.w;
+
+    // Outside the light's volume, and so its tile, nothing is shadowed
+    float2 tileMin = light.shadowAtlasRect.xy;
+    float2 tileMax = light.shadowAtlasRect.xy + light.shadowAtlasRect.zw;
+    if (any(shadowPos.xy < tileMin) || any(shadowPos.xy > tileMax) || shadowPos.z < 0.0f || shadowPos.z > 1.0f)
+    {
+        return 1.0f;
+    }
+
+    // Half a texel in, so filtering never reads the neighbouring tile
+    float2 atlasSize;
+    shadowAtlas.GetDimensions(atlasSize.x, atlasSize.y);
+    float2 halfTexel = 0.5f / atlasSize;
+    float2 uv = clamp(shadowPos.xy, tileMin + halfTexel, tileMax - halfTexel);
+
+    float lit = shadowAtlas.SampleCmpLevelZero(shadowSampler, uv, shadowPos.z - light.shadowParams.y);
+    return lerp(1.0f, lit, light.shadowParams.z);
+}
+
+// Same model as ShadeLight in PixelShader.hlsl
+void ShadeLight(LightData light, float3 normal, float3 worldPos, float3 viewDirection, float specularPower,
+                inout float3 diffuse, inout float3 specular)
+{
+    float3 lightDir;
+    float attenuation = 1.0f;
+
+    if (light.position.w == LIGHT_POINT || light.position.w == LIGHT_SPOT)
+    {
+        float3 toLight = light.position.xyz - worldPos;
+        float distance = length(toLight);
+        if (distance >= light.direction.w)
+        {
+            return;
+        }
+
+        lightDir = toLight / max(distance, 0.0001f);
+        attenuation = 1.0f / (light.attenuation.x + light.attenuation.y * distance +
+                              light.attenuation.z * distance * distance);
+
+        float rangeFade = saturate(1.0f - distance / light.direction.w);
+        attenuation *= rangeFade * rangeFade;
+
+        if (light.position.w == LIGHT_SPOT)
+        {
+            float cosAngle = dot(-lightDir, normalize(light.direction.xyz));
+            float cosInner = cos(light.attenuation.w);
+            float cosOuter = cos(light.shadowParams.x);
+            attenuation *= saturate((cosAngle - cosOuter) / max(cosInner - cosOuter, 0.0001f));
+        }
+    }
+    else
+    {
+        lightDir = normalize(-light.direction.xyz);
+    }
+
+    float diffuseFactor = max(dot(normal, lightDir), 0.0f);
+    float3 reflectDirection = reflect(-lightDir, normal);
+    float specularFactor = pow(max(dot(viewDirection, reflectDirection), 0.0f), specularPower);
+
+    attenuation *= SampleShadow(light, worldPos);
+
+    float3 radiance = light.color.rgb * light.color.w * attenuation;
+    diffuse += radiance * diffuseFactor;
+    specular += radiance * specularFactor * (diffuseFactor > 0.0f ? 1.0f : 0.0f);
+}
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void main(uint3 dispatchID : SV_DispatchThreadID)
+{
+    if (any(dispatchID.xy >= screenSize))
+    {
+        return;
+    }
+
+    // Uncovered pixels keep the back buffer
+    float depth = depthBuffer.Load(int3(dispatchID.xy, 0));
+    if (depth >= 1.0f)
+    {
+        return;
+    }
+
+    float4 albedo = albedoBuffer.Load(int3(dispatchID.xy, 0));
+    float4 normalPower = normalBuffer.Load(int3(dispatchID.xy, 0));
+    float3 normal = normalize(normalPower.xyz);
+
+    // Pixel centre back to world space
+    float2 uv = (float2(dispatchID.xy) + 0.5f) / float2(screenSize);
+    float4 clipPos = float4(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, depth, 1.0f);
+    float4 worldPos = mul(clipPos, inverseViewProjection);
+    worldPos.xyz /= worldPos.w;
+    float3 viewDirection = normalize(cameraPosition.xyz - worldPos.xyz);
+
+    float3 diffuse = float3(0.0f, 0.0f, 0.0f);
+    float3 specular = float3(0.0f, 0.0f, 0.0f);
+
+    for (uint i = 0; i < clusterCounts.w; i++)
+    {
+        ShadeLight(lights[i], normal, worldPos.xyz, viewDirection, normalPower.w, diffuse, specular);
+    }
+
+    float viewZ = depthToViewZ.y / (depth - depthToViewZ.x);
+    uint3 cluster;
+    cluster.xy = min(uint2((float2(dispatchID.xy) + 0.5f) * clusterParams.zw), clusterCounts.xy - 1);
+    cluster.z = (uint)clamp(log(viewZ) * clusterParams.x + clusterParams.y, 0.0f, (float)(clusterCounts.z - 1));
+
+    uint clusterIndex = (cluster.z * clusterCounts.y + cluster.y) * clusterCounts.x + cluster.x;
+    uint2 range = clusterGrid[clusterIndex];
+
+    for (uint j = 0; j < range.y; j++)
+    {
+        ShadeLight(lights[lightIndices[range.x + j]], normal, worldPos.xyz, viewDirection, normalPower.w, diffuse, specular);
+    }
+
+    float3 lighting = ambientLight.rgb * ambientLight.w + diffuse;
+    output[dispatchID.xy] = float4(albedo.rgb * lighting + albedo.a * specular, 1.0f);
+}
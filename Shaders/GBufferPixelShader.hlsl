@@ -0,0 +1,37 @@
+// Writes the deferred path's G-buffer, see DeferredShading.h; lighting
+// happens later in DeferredLightingComputeShader
+
+struct PixelInput
+{
+    float4 position : SV_POSITION;
+    float3 normal : NORMAL;
+    float2 texCoord : TEXCOORD0;
+    float3 worldPos : WORLD_POSITION;
+};
+
+// Must match MaterialConstants in Material.h
+cbuffer MaterialConstants : register(b3)
+{
+    float4 materialAmbient;     // w = opacity
+    float4 materialDiffuse;     // w = specular power
+    float4 materialSpecular;
+};
+
+Texture2D diffuseTexture : register(t0);
+SamplerState textureSampler : register(s0);
+
+struct GBufferOutput
+{
+    float4 albedo : SV_Target0;     // rgb = albedo, a = specular intensity
+    float4 normal : SV_Target1;     // xyz = world normal, w = specular power
+};
+
+GBufferOutput main(PixelInput input)
+{
+    float4 textureColor = diffuseTexture.Sample(textureSampler, input.texCoord);
+
+    GBufferOutput output;
+    output.albedo = float4(textureColor.rgb * materialDiffuse.rgb, dot(materialSpecular.rgb, float3(0.299f, 0.587f, 0.114f)));
+    output.normal = float4(normalize(input.normal), materialDiffuse.w);
+    return output;
+}
@@ -0,0 +1,35 @@
+// Builds one level of the Hi-Z pyramid: every texel keeps the farthest
+// depth of the source texels it covers
+
+cbuffer DownsampleParams : register(b0)
+{
+    uint2 SourceSize;
+    uint2 DestSize;
+};
+
+Texture2D<float> Source : register(t0);     // Scene depth or the previous level
+RWTexture2D<float> Dest : register(u0);
+
+[numthreads(8, 8, 1)]
+void main(uint3 dispatchID : SV_DispatchThreadID)
+{
+    if (any(dispatchID.xy >= DestSize))
+    {
+        return;
+    }
+
+    // Covered source texels, rounded outwards so odd sizes stay conservative
+    uint2 first = (dispatchID.xy * SourceSize) / DestSize;
+    uint2 last = min(((dispatchID.xy + 1) * SourceSize + DestSize - 1) / DestSize, SourceSize) - 1;
+
+    float depth = 0.0f;
+    for (uint y = first.y; y <= last.y; y++)
+    {
+        for (uint x = first.x; x <= last.x; x++)
+        {
+            depth = max(depth, Source.Load(int3(x, y, 0)));
+        }
+    }
+
+    Dest[dispatchID.xy] = depth;
+}
@@ -0,0 +1,53 @@
+// World comes per instance, only the view constants are used
+cbuffer ViewConstants : register(b2)
+{
+    matrix View;
+    matrix Projection;
+};
+
+struct InstancedVertexInput
+{
+    float3 position : POSITION;
+    float3 normal : NORMAL;
+    float2 texCoord : TEXCOORD;
+    float4 world0 : INSTANCE_WORLD0;
+    float4 world1 : INSTANCE_WORLD1;
+    float4 world2 : INSTANCE_WORLD2;
+    float4 world3 : INSTANCE_WORLD3;
+};
+
+struct VertexOutput
+{
+    float4 position : SV_POSITION;
+    float3 normal : NORMAL;
+    float2 texCoord : TEXCOORD0;
+    float3 worldPos : WORLD_POSITION;
+};
+
+VertexOutput main(InstancedVertexInput input)
+{
+    VertexOutput output;
+
+    // Rebuild the instance world matrix (rows are stored untransposed)
+    float4x4 instanceWorld = float4x4(input.world0, input.world1, input.world2, input.world3);
+
+    // Transform vertex position to world space
+    float4 worldPos = mul(float4(input.position, 1.0f), instanceWorld);
+
+    // Transform to view space
+    float4 viewPos = mul(worldPos, View);
+
+    // Transform to projection space
+    output.position = mul(viewPos, Projection);
+
+    // Transform normal to world space
+    output.normal = normalize(mul(input.normal, (float3x3)instanceWorld));
+
+    // Pass through texture coordinates
+    output.texCoord = input.texCoord;
+
+    // Pass world position for lighting calculations
+    output.worldPos = worldPos.xyz;
+
+    return output;
+}
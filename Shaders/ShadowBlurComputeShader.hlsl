@@ -0,0 +1,74 @@
+// One pass of the separable VSM blur. The row pass converts shadow depth to
+// moments as it reads them, the column pass finishes into mip 0 of the
+// moments texture. Each group blurs GROUP_SIZE texels of one row or column
+// of one slice from a line cached in groupshared memory.
+
+#define GROUP_SIZE 128
+#define MAX_RADIUS 8
+
+cbuffer BlurParams : register(b0)
+{
+    uint2 Size;
+    uint FirstSlice;
+    uint Vertical;          // 0: rows, from depth; 1: columns, from the row pass
+    float Exponent;         // EVSM warp, 0 for plain depth moments
+    uint Radius;
+    float2 Padding;
+    float4 Weights[3];      // Center first, then one per texel of distance
+};
+
+Texture2DArray<float> Depth : register(t0);
+Texture2DArray<float2> Rows : register(t1);
+RWTexture2DArray<float2> Dest : register(u0);
+
+groupshared float2 Line[GROUP_SIZE + 2 * MAX_RADIUS];
+
+float2 ToMoments(float depth)
+{
+    float warped = Exponent > 0.0f ? exp(Exponent * depth) : depth;
+    return float2(warped, warped * warped);
+}
+
+float Weight(uint distance)
+{
+    return Weights[distance / 4][distance % 4];
+}
+
+[numthreads(GROUP_SIZE, 1, 1)]
+void main(uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    uint lineLength = Vertical ? Size.y : Size.x;
+    uint slice = FirstSlice + groupID.z;
+    int start = int(groupID.x * GROUP_SIZE) - MAX_RADIUS;
+
+    // Edges clamp, so texels past the border repeat the last one
+    for (uint i = groupIndex; i < GROUP_SIZE + 2 * MAX_RADIUS; i += GROUP_SIZE)
+    {
+        uint along = uint(clamp(start + int(i), 0, int(lineLength) - 1));
+        if (Vertical)
+        {
+            Line[i] = Rows.Load(int4(groupID.y, along, slice, 0));
+        }
+        else
+        {
+            Line[i] = ToMoments(Depth.Load(int4(along, groupID.y, slice, 0)));
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint along = groupID.x * GROUP_SIZE + groupIndex;
+    if (along >= lineLength)
+    {
+        return;
+    }
+
+    uint center = groupIndex + MAX_RADIUS;
+    float2 moments = Line[center] * Weight(0);
+    for (uint r = 1; r <= Radius; r++)
+    {
+        moments += (Line[center - r] + Line[center + r]) * Weight(r);
+    }
+
+    uint2 texel = Vertical ? uint2(groupID.y, along) : uint2(along, groupID.y);
+    Dest[uint3(texel, slice)] = moments;
+}
@@ -0,0 +1,81 @@
+// World comes per instance, only the view constants are used
+cbuffer ViewConstants : register(b2)
+{
+    matrix View;
+    matrix Projection;
+};
+
+// Every character's bones for the frame, indexed from the instance's offset
+StructuredBuffer<float4x4> BonePalette : register(t0);
+
+struct SkinnedInstancedVertexInput
+{
+    float3 position : POSITION;
+    float3 normal : NORMAL;
+    float2 texCoord : TEXCOORD;
+    float4 boneWeights : BLENDWEIGHT;
+    uint4 boneIndices : BLENDINDICES;
+    float4 world0 : INSTANCE_WORLD0;
+    float4 world1 : INSTANCE_WORLD1;
+    float4 world2 : INSTANCE_WORLD2;
+    float4 world3 : INSTANCE_WORLD3;
+    uint boneOffset : INSTANCE_BONES;
+};
+
+struct VertexOutput
+{
+    float4 position : SV_POSITION;
+    float3 normal : NORMAL;
+    float2 texCoord : TEXCOORD0;
+    float3 worldPos : WORLD_POSITION;
+};
+
+VertexOutput main(SkinnedInstancedVertexInput input)
+{
+    VertexOutput output;
+
+    // Initialize skinned position and normal
+    float4 skinnedPos = float4(0, 0, 0, 0);
+    float3 skinnedNormal = float3(0, 0, 0);
+
+    // Apply skinning transformation
+    for(int i = 0; i < 4; i++)
+    {
+        if(input.boneWeights[i] > 0.0f)
+        {
+            float4x4 boneTransform = BonePalette[input.boneOffset + input.boneIndices[i]];
+
+            // Transform position
+            skinnedPos += input.boneWeights[i] * mul(float4(input.position, 1.0f), boneTransform);
+
+            // Transform normal
+            skinnedNormal += input.boneWeights[i] * mul(input.normal, (float3x3)boneTransform);
+        }
+    }
+
+    // Ensure we have a valid position
+    skinnedPos.w = 1.0f;
+
+    // Rebuild the instance world matrix (rows are stored untransposed)
+    float4x4 instanceWorld = float4x4(input.world0, input.world1, input.world2, input.world3);
+
+    // Transform skinned vertex to world space
+    float4 worldPos = mul(skinnedPos, instanceWorld);
+
+    // Transform to view space
+    float4 viewPos = mul(worldPos, View);
+
+    // Transform to projection space
+    output.position = mul(viewPos, Projection);
+
+    // Transform skinned normal to world space
+    output.normal = normalize(mul(skinnedNormal, (float3x3)instanceWorld));
+
+    // Pass through texture coordinates
+    output.texCoord = input.texCoord;
+
+    // Pass world position for lighting calculations
+    output.worldPos = worldPos.xyz;
+
+    return output;
+}
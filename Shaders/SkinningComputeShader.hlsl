@@ -0,0 +1,64 @@
+// Skins a SkinnedVertex stream once into a static Vertex stream that every
+// pass can then draw with the regular vertex shaders
+
+cbuffer SkinningParams : register(b0)
+{
+    uint VertexCount;
+    uint BoneOffset;
+    uint2 Padding;
+};
+
+ByteAddressBuffer SourceVertices : register(t0);          // SkinnedVertex, 64 bytes
+StructuredBuffer<float4x4> BonePalette : register(t1);
+RWByteAddressBuffer OutputVertices : register(u0);        // Vertex, 32 bytes
+
+static const uint SKINNED_VERTEX_STRIDE = 64;
+static const uint VERTEX_STRIDE = 32;
+
+[numthreads(64, 1, 1)]
+void main(uint3 dispatchID : SV_DispatchThreadID)
+{
+    uint vertexIndex = dispatchID.x;
+    if (vertexIndex >= VertexCount)
+    {
+        return;
+    }
+
+    uint source = vertexIndex * SKINNED_VERTEX_STRIDE;
+    float3 position = asfloat(SourceVertices.Load3(source));
+    float3 normal = asfloat(SourceVertices.Load3(source + 12));
+    uint2 texCoord = SourceVertices.Load2(source + 24);
+    float4 boneWeights = asfloat(SourceVertices.Load4(source + 32));
+    uint4 boneIndices = SourceVertices.Load4(source + 48);
+
+    // Initialize skinned position and normal
+    float4 skinnedPos = float4(0, 0, 0, 0);
+    float3 skinnedNormal = float3(0, 0, 0);
+
+    // Apply skinning transformation
+    for(int i = 0; i < 4; i++)
+    {
+        if(boneWeights[i] > 0.0f)
+        {
+            float4x4 boneTransform = BonePalette[BoneOffset + boneIndices[i]];
+
+            skinnedPos += boneWeights[i] * mul(float4(position, 1.0f), boneTransform);
+            skinnedNormal += boneWeights[i] * mul(normal, (float3x3)boneTransform);
+        }
+    }
+
+    // Fall back to the bind pose for unweighted vertices
+    if (dot(boneWeights, float4(1, 1, 1, 1)) <= 0.0f)
+    {
+        skinnedPos = float4(position, 1.0f);
+        skinnedNormal = normal;
+    }
+
+    float lengthSq = dot(skinnedNormal, skinnedNormal);
+    skinnedNormal = lengthSq > 0.0f ? skinnedNormal * rsqrt(lengthSq) : normal;
+
+    uint output = vertexIndex * VERTEX_STRIDE;
+    OutputVertices.Store3(output, asuint(skinnedPos.xyz));
+    OutputVertices.Store3(output + 12, asuint(skinnedNormal));
+    OutputVertices.Store2(output + 24, texCoord);
+}
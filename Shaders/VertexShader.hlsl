@@ -1,6 +1,10 @@
-cbuffer ConstantBuffer : register(b0)
+cbuffer ObjectConstants : register(b0)
 {
     matrix World;
+};
+
+cbuffer ViewConstants : register(b2)
+{
     matrix View;
     matrix Projection;
 };
@@ -1,5 +1,7 @@
 #include "AnimationClip.h"
+#include "Skeleton.h"
 #include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
 #include <algorithm>
 #include <DirectXMath.h>
 
@@ -7,8 +9,57 @@ using namespace GameEngine::Animation;
 using namespace GameEngine::Core;
 using namespace DirectX;
 
+namespace {
+    // Forward steps tried before a jump is treated as a seek
+    constexpr size_t MAX_CURSOR_STEPS = 4;
+
+    // Index of the last key before time (0 if none), resumed from cursor.
+    // Matches the lower_bound based Find*Keyframe, which remains the fallback.
+    template<typename Keyframe, typename FallbackFunc>
+    size_t SeekKeyframe(const std::vector<Keyframe>& keys, float time, std::uint32_t& cursor, FallbackFunc fallback) {
+        size_t index = cursor;
+        bool valid = index < keys.size() && (index == 0 || keys[index].time < time);
+
+        size_t steps = 0;
+        while (valid && index + 1 < keys.size() && keys[index + 1].time < time) {
+            if (++steps > MAX_CURSOR_STEPS) {
+                valid = false;
+                break;
+            }
+            index++;
+        }
+
+        if (!valid) {
+            index = fallback(time);
+        }
+
+        cursor = static_cast<std::uint32_t>(index);
+        return index;
+    }
+}
+
 // AnimationChannel implementation
 DirectX::XMFLOAT3 AnimationChannel::SamplePosition(float time) const {
+    std::uint32_t cursor = 0;
+    return SamplePosition(time, cursor);
+}
+
+DirectX::XMFLOAT4 AnimationChannel::SampleRotation(float time) const {
+    std::uint32_t cursor = 0;
+    return SampleRotation(time, cursor);
+}
+
+DirectX::XMFLOAT3 AnimationChannel::SampleScale(float time) const {
+    std::uint32_t cursor = 0;
+    return SampleScale(time, cursor);
+}
+
+DirectX::XMMATRIX AnimationChannel::SampleTransform(float time) const {
+    KeyframeCursor cursor;
+    return SampleTransform(time, cursor);
+}
+
+DirectX::XMFLOAT3 AnimationChannel::SamplePosition(float time, std::uint32_t& cursor) const {
     if (positionKeys.empty()) {
         return DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
     }
@@ -17,7 +68,8 @@ DirectX::XMFLOAT3 AnimationChannel::SamplePosition(float time) const {
         return positionKeys[0].position;
     }
 
-    size_t keyIndex = FindPositionKeyframe(time);
+    size_t keyIndex = SeekKeyframe(positionKeys, time, cursor,
+        [this](float t) { return FindPositionKeyframe(t); });
 
     if (keyIndex == positionKeys.size() - 1) {
         return positionKeys[keyIndex].position;
@@ -37,7 +89,7 @@ DirectX::XMFLOAT3 AnimationChannel::SamplePosition(float time) const {
     return InterpolatePosition(key1, key2, t);
 }
 
-DirectX::XMFLOAT4 AnimationChannel::SampleRotation(float time) const {
+DirectX::XMFLOAT4 AnimationChannel::SampleRotation(float time, std::uint32_t& cursor) const {
     if (rotationKeys.empty()) {
         return DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f); // Identity quaternion
     }
@@ -46,7 +98,8 @@ DirectX::XMFLOAT4 AnimationChannel::SampleRotation(float time) const {
         return rotationKeys[0].rotation;
     }
 
-    size_t keyIndex = FindRotationKeyframe(time);
+    size_t keyIndex = SeekKeyframe(rotationKeys, time, cursor,
+        [this](float t) { return FindRotationKeyframe(t); });
 
     if (keyIndex == rotationKeys.size() - 1) {
         return rotationKeys[keyIndex].rotation;
@@ -66,7 +119,7 @@ DirectX::XMFLOAT4 AnimationChannel::SampleRotation(float time) const {
     return InterpolateRotation(key1, key2, t);
 }
 
-DirectX::XMFLOAT3 AnimationChannel::SampleScale(float time) const {
+DirectX::XMFLOAT3 AnimationChannel::SampleScale(float time, std::uint32_t& cursor) const {
     if (scaleKeys.empty()) {
         return DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
     }
@@ -75,7 +128,8 @@ DirectX::XMFLOAT3 AnimationChannel::SampleScale(float time) const {
         return scaleKeys[0].scale;
     }
 
-    size_t keyIndex = FindScaleKeyframe(time);
+    size_t keyIndex = SeekKeyframe(scaleKeys, time, cursor,
+        [this](float t) { return FindScaleKeyframe(t); });
 
     if (keyIndex == scaleKeys.size() - 1) {
         return scaleKeys[keyIndex].scale;
@@ -95,10 +149,10 @@ DirectX::XMFLOAT3 AnimationChannel::SampleScale(float time) const {
     return InterpolateScale(key1, key2, t);
 }
 
-DirectX::XMMATRIX AnimationChannel::SampleTransform(float time) const {
-    XMFLOAT3 position = SamplePosition(time);
-    XMFLOAT4 rotation = SampleRotation(time);
-    XMFLOAT3 scale = SampleScale(time);
+DirectX::XMMATRIX AnimationChannel::SampleTransform(float time, KeyframeCursor& cursor) const {
+    XMFLOAT3 position = SamplePosition(time, cursor.position);
+    XMFLOAT4 rotation = SampleRotation(time, cursor.rotation);
+    XMFLOAT3 scale = SampleScale(time, cursor.scale);
 
     // Convert to DirectX vectors
     XMVECTOR positionVec = XMLoadFloat3(&position);
@@ -224,6 +278,11 @@ AnimationClip::AnimationClip(const std::string& name)
 }
 
 void AnimationClip::AddChannel(const AnimationChannel& channel) {
+    if (m_compressed) {
+        LOG_WARNING("Cannot add channel '" << channel.boneName << "' to compressed clip '" << m_name << "'");
+        return;
+    }
+
     m_channels.push_back(channel);
 
     // Update duration based on channel keyframes
@@ -262,7 +321,40 @@ AnimationChannel* AnimationClip::FindChannel(int boneIndex) {
     return (it != m_channels.end()) ? &(*it) : nullptr;
 }
 
+size_t AnimationClip::BindToSkeleton(const Skeleton& skeleton) {
+    size_t bound = 0;
+    for (AnimationChannel& channel : m_channels) {
+        if (!channel.boneName.empty()) {
+            channel.boneIndex = skeleton.FindBone(Core::StringId(channel.boneName));
+        }
+        if (channel.boneIndex >= 0 && static_cast<size_t>(channel.boneIndex) < skeleton.GetBoneCount()) {
+            bound++;
+        } else {
+            channel.boneIndex = -1;
+        }
+    }
+
+    // Compressed tracks are stored by channel position and stay where they are
+    if (!m_compressed) {
+        std::stable_sort(m_channels.begin(), m_channels.end(),
+            [](const AnimationChannel& a, const AnimationChannel& b) {
+                return static_cast<unsigned int>(a.boneIndex) < static_cast<unsigned int>(b.boneIndex);
+            });
+    }
+
+    if (bound < m_channels.size()) {
+        LOG_WARNING("Animation clip '" << m_name << "': " << (m_channels.size() - bound)
+                    << " channels match no bone in the skeleton");
+    }
+    return bound;
+}
+
 void AnimationClip::SampleAnimation(float time, std::vector<DirectX::XMMATRIX>& boneTransforms) const {
+    AnimationCursor cursor;
+    SampleAnimation(time, boneTransforms, cursor);
+}
+
+void AnimationClip::SampleAnimation(float time, std::vector<DirectX::XMMATRIX>& boneTransforms, AnimationCursor& cursor) const {
     if (boneTransforms.empty()) {
         Logger::GetInstance().LogWarning("AnimationClip::SampleAnimation - Empty bone transforms array");
         return;
@@ -276,12 +368,128 @@ void AnimationClip::SampleAnimation(float time, std::vector<DirectX::XMMATRIX>&
         transform = XMMatrixIdentity();
     }
 
+    // A cursor from another clip is simply reset
+    if (cursor.channels.size() != m_channels.size()) {
+        cursor.channels.assign(m_channels.size(), KeyframeCursor());
+    }
+
     // Sample each channel and apply to corresponding bone
-    for (const auto& channel : m_channels) {
-        if (channel.boneIndex >= 0 && channel.boneIndex < static_cast<int>(boneTransforms.size())) {
-            boneTransforms[channel.boneIndex] = channel.SampleTransform(normalizedTime);
+    for (size_t i = 0; i < m_channels.size(); i++) {
+        const AnimationChannel& channel = m_channels[i];
+        if (channel.boneIndex < 0 || channel.boneIndex >= static_cast<int>(boneTransforms.size())) {
+            continue;
+        }
+
+        if (m_compressed) {
+            XMFLOAT3 position(0.0f, 0.0f, 0.0f);
+            XMFLOAT4 rotation(0.0f, 0.0f, 0.0f, 1.0f);
+            XMFLOAT3 scale(1.0f, 1.0f, 1.0f);
+            m_compressed->SampleChannel(i, normalizedTime, cursor.channels[i], position, rotation, scale);
+            boneTransforms[channel.boneIndex] = XMMatrixAffineTransformation(
+                XMLoadFloat3(&scale), XMVectorZero(), XMLoadFloat4(&rotation), XMLoadFloat3(&position));
+        } else {
+            boneTransforms[channel.boneIndex] = channel.SampleTransform(normalizedTime, cursor.channels[i]);
+        }
+    }
+}
+
+void AnimationClip::SampleLocalPose(float time, LocalPose& pose, AnimationCursor& cursor, size_t channelCount,
+                                    const LocalPose* restPose) const {
+    float normalizedTime = NormalizeTime(time);
+    if (restPose && restPose->GetBoneCount() == pose.GetBoneCount()) {
+        std::copy(restPose->translations.begin(), restPose->translations.end(), pose.translations.begin());
+        std::copy(restPose->rotations.begin(), restPose->rotations.end(), pose.rotations.begin());
+        std::copy(restPose->scales.begin(), restPose->scales.end(), pose.scales.begin());
+    } else {
+        pose.SetIdentity();
+    }
+
+    if (cursor.channels.size() != m_channels.size()) {
+        cursor.channels.assign(m_channels.size(), KeyframeCursor());
+    }
+
+    int boneCount = static_cast<int>(pose.GetBoneCount());
+    size_t sampledChannels = std::min(channelCount, m_channels.size());
+    for (size_t i = 0; i < sampledChannels; i++) {
+        const AnimationChannel& channel = m_channels[i];
+        if (channel.boneIndex < 0 || channel.boneIndex >= boneCount) {
+            continue;
         }
+
+        KeyframeCursor& channelCursor = cursor.channels[i];
+        if (m_compressed) {
+            m_compressed->SampleChannel(i, normalizedTime, channelCursor, pose.translations[channel.boneIndex],
+                                        pose.rotations[channel.boneIndex], pose.scales[channel.boneIndex]);
+            continue;
+        }
+
+        // Channels without keys keep the rest pose, or a rotation-only clip would collapse the bones
+        if (!channel.positionKeys.empty()) {
+            pose.translations[channel.boneIndex] = channel.SamplePosition(normalizedTime, channelCursor.position);
+        }
+        if (!channel.rotationKeys.empty()) {
+            pose.rotations[channel.boneIndex] = channel.SampleRotation(normalizedTime, channelCursor.rotation);
+        }
+        if (!channel.scaleKeys.empty()) {
+            pose.scales[channel.boneIndex] = channel.SampleScale(normalizedTime, channelCursor.scale);
+        }
+    }
+}
+
+bool AnimationClip::Compress(const AnimationCompressionSettings& settings) {
+    MEMORY_SCOPE(Animations);
+
+    if (m_compressed) {
+        return true;
+    }
+
+    if (!IsValid()) {
+        LOG_ERROR("Cannot compress invalid animation clip '" << m_name << "'");
+        return false;
+    }
+
+    size_t rawSize = GetMemoryUsage();
+
+    auto compressed = std::make_unique<CompressedAnimation>();
+    if (!compressed->Build(m_channels, m_duration, settings)) {
+        LOG_ERROR("Failed to compress animation clip '" << m_name << "'");
+        return false;
+    }
+
+    // Tracks dense storage could not bring within tolerance, e.g. keys off the sample grid
+    if (compressed->GetMaxPositionError() > settings.positionTolerance ||
+        compressed->GetMaxRotationError() > settings.rotationTolerance ||
+        compressed->GetMaxScaleError() > settings.scaleTolerance) {
+        LOG_WARNING("Animation clip '" << m_name << "' exceeds its compression tolerance: position "
+                    << compressed->GetMaxPositionError() << ", rotation " << compressed->GetMaxRotationError()
+                    << ", scale " << compressed->GetMaxScaleError());
+    }
+
+    // Keep bone names and indices for lookups, drop the raw keys
+    for (auto& channel : m_channels) {
+        std::vector<PositionKeyframe>().swap(channel.positionKeys);
+        std::vector<RotationKeyframe>().swap(channel.rotationKeys);
+        std::vector<ScaleKeyframe>().swap(channel.scaleKeys);
+    }
+    m_compressed = std::move(compressed);
+
+    LOG_DEBUG("Compressed animation clip '" << m_name << "': " << rawSize << " -> " << GetMemoryUsage() << " bytes, "
+              << m_compressed->GetFrameCount() << " frames");
+    return true;
+}
+
+size_t AnimationClip::GetMemoryUsage() const {
+    size_t size = sizeof(*this) + m_channels.capacity() * sizeof(AnimationChannel);
+    for (const auto& channel : m_channels) {
+        size += channel.positionKeys.capacity() * sizeof(PositionKeyframe);
+        size += channel.rotationKeys.capacity() * sizeof(RotationKeyframe);
+        size += channel.scaleKeys.capacity() * sizeof(ScaleKeyframe);
+    }
+
+    if (m_compressed) {
+        size += m_compressed->GetMemoryUsage();
     }
+    return size;
 }
 
 float AnimationClip::NormalizeTime(float time) const {
@@ -324,8 +532,10 @@ bool AnimationClip::IsValid() const {
             return false;
         }
 
-        // At least one type of keyframe should exist
-        if (channel.positionKeys.empty() &&
+        // At least one type of keyframe should exist; compressed clips were
+        // checked before their keys were released
+        if (!m_compressed &&
+            channel.positionKeys.empty() &&
             channel.rotationKeys.empty() &&
             channel.scaleKeys.empty()) {
             return false;
@@ -2,11 +2,17 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <memory>
 #include <DirectXMath.h>
+#include "AnimationPose.h"
+#include "CompressedAnimation.h"
 
 namespace GameEngine {
 namespace Animation {
 
+class Skeleton;
+
 // Animation keyframe types
 struct PositionKeyframe {
     float time;
@@ -29,6 +35,20 @@ struct ScaleKeyframe {
     ScaleKeyframe(float t, const DirectX::XMFLOAT3& s) : time(t), scale(s) {}
 };
 
+// Last keyframe index used per track, so monotonic playback resumes in O(1)
+struct KeyframeCursor {
+    std::uint32_t position = 0;
+    std::uint32_t rotation = 0;
+    std::uint32_t scale = 0;
+};
+
+// Sampling state for one playing clip, one cursor per channel
+struct AnimationCursor {
+    std::vector<KeyframeCursor> channels;
+
+    void Reset() { channels.clear(); }
+};
+
 // Animation channel (per bone)
 struct AnimationChannel {
     std::string boneName;
@@ -46,6 +66,12 @@ struct AnimationChannel {
     DirectX::XMFLOAT3 SampleScale(float time) const;
     DirectX::XMMATRIX SampleTransform(float time) const;
 
+    // Cursor-based sampling; falls back to binary search after seeks and loops
+    DirectX::XMFLOAT3 SamplePosition(float time, std::uint32_t& cursor) const;
+    DirectX::XMFLOAT4 SampleRotation(float time, std::uint32_t& cursor) const;
+    DirectX::XMFLOAT3 SampleScale(float time, std::uint32_t& cursor) const;
+    DirectX::XMMATRIX SampleTransform(float time, KeyframeCursor& cursor) const;
+
 private:
     // Interpolation helpers
     DirectX::XMFLOAT3 InterpolatePosition(const PositionKeyframe& key1, const PositionKeyframe& key2, float t) const;
@@ -61,6 +87,8 @@ private:
 // Animation clip
 class AnimationClip {
 public:
+    static constexpr size_t ALL_CHANNELS = ~static_cast<size_t>(0);
+
     AnimationClip(const std::string& name);
     ~AnimationClip() = default;
 
@@ -78,8 +106,29 @@ public:
     AnimationChannel* FindChannel(const std::string& boneName);
     AnimationChannel* FindChannel(int boneIndex);
 
-    // Animation sampling
+    // Resolves every channel's bone name to its index in skeleton, once at
+    // load time; channels naming no bone get -1 and are skipped. Raw clips
+    // are also reordered parents first, so the leading channels sampled at
+    // reduced LOD are the ones closest to the root. Returns the number of
+    // channels bound.
+    size_t BindToSkeleton(const Skeleton& skeleton);
+
+    // Animation sampling, in local space; Skeleton::LocalToModel applies the hierarchy
     void SampleAnimation(float time, std::vector<DirectX::XMMATRIX>& boneTransforms) const;
+    void SampleAnimation(float time, std::vector<DirectX::XMMATRIX>& boneTransforms, AnimationCursor& cursor) const;
+
+    // Sample into local-space SRT streams; bones without a channel, and
+    // channels without keys of a kind, keep restPose (the skeleton's bind
+    // pose), or identity without one.
+    // channelCount limits sampling to the leading channels (animation LOD).
+    void SampleLocalPose(float time, LocalPose& pose, AnimationCursor& cursor,
+                         size_t channelCount = ALL_CHANNELS, const LocalPose* restPose = nullptr) const;
+
+    // Replace the raw keyframes with quantized, reduced tracks. Channel names
+    // and bone indices are kept; sampling then decodes the compressed data.
+    bool Compress(const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+    bool IsCompressed() const { return m_compressed != nullptr; }
+    size_t GetMemoryUsage() const;
 
     // Time utilities
     float NormalizeTime(float time) const; // Clamp to [0, duration]
@@ -93,6 +142,7 @@ private:
     float m_duration;
     float m_ticksPerSecond;
     std::vector<AnimationChannel> m_channels;
+    std::unique_ptr<CompressedAnimation> m_compressed;
 };
 
 } // namespace Animation
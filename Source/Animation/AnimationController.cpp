@@ -1,5 +1,6 @@
 #include "AnimationController.h"
 #include "../Core/Logger.h"
+#include "../Core/ConfigManager.h"
 #include <algorithm>
 
 namespace GameEngine {
@@ -9,6 +10,12 @@ AnimationController::AnimationController()
     : m_isPlaying(false)
     , m_isPaused(false)
     , m_useStateMachine(false)
+    , m_transitionTablesDirty(false)
+    , m_lod(AnimationLOD::Full)
+    , m_framesSinceSample(0)
+    , m_reducedChannelCount(16)
+    , m_lodResync(true)
+    , m_evaluatedBySystem(false)
 {
 }
 
@@ -17,18 +24,128 @@ void AnimationController::OnStart() {
 }
 
 void AnimationController::OnUpdate(float deltaTime) {
+    // Fallback for controllers the scene's parallel stage did not reach
+    if (m_evaluatedBySystem) {
+        m_evaluatedBySystem = false;
+        return;
+    }
+
+    Evaluate(deltaTime);
+}
+
+void AnimationController::EvaluateFromSystem(float deltaTime) {
+    Evaluate(deltaTime);
+    m_evaluatedBySystem = true;
+}
+
+void AnimationController::Evaluate(float deltaTime) {
     if (!IsEnabled() || m_isPaused) return;
 
+    // Time always advances, so culled characters are in sync when they reappear
     if (m_useStateMachine) {
         UpdateStateMachine(deltaTime);
     } else {
         UpdateAnimations(deltaTime);
     }
 
-    BlendAnimations();
+    if (m_lod == AnimationLOD::Culled) {
+        m_lodResync = true;
+    } else {
+        EvaluatePose(deltaTime);
+    }
+
     CleanupFinishedAnimations();
 }
 
+void AnimationController::SetLOD(AnimationLOD lod) {
+    if (lod != m_lod) {
+        m_lod = lod;
+        m_lodResync = true;
+    }
+}
+
+void AnimationController::EvaluatePose(float deltaTime) {
+    std::uint32_t interval = GetAnimationLODInterval(m_lod);
+    size_t channelCount = (m_lod == AnimationLOD::Reduced) ? m_reducedChannelCount : AnimationClip::ALL_CHANNELS;
+
+    // Full rate, or restarting after a tier change: sample the current time.
+    // A restart samples every channel, so the bones a reduced tier skips
+    // hold a real pose in m_previousPose rather than the identity or a stale one.
+    if (interval <= 1 || m_lodResync) {
+        size_t sampleChannels = m_lodResync ? AnimationClip::ALL_CHANNELS : channelCount;
+        if (BlendAnimations(0.0f, sampleChannels)) {
+            WriteBoneTransforms(m_blendPose);
+            m_previousPose = m_blendPose;
+            m_lodResync = false;
+        }
+
+        // Start a fresh interval on the next frame
+        m_framesSinceSample = interval > 1 ? interval - 1 : 0;
+        return;
+    }
+
+    // Between samples: interpolate towards the pose sampled an interval ahead
+    if (++m_framesSinceSample < interval) {
+        if (m_outputPose.GetBoneCount() != m_blendPose.GetBoneCount()) {
+            return;
+        }
+
+        float t = static_cast<float>(m_framesSinceSample) / static_cast<float>(interval);
+        m_poseBlender.Begin(m_outputPose);
+        m_poseBlender.Add(m_outputPose, m_previousPose, 1.0f - t);
+        m_poseBlender.Add(m_outputPose, m_blendPose, t);
+        m_poseBlender.Finish(m_outputPose);
+
+        WriteBoneTransforms(m_outputPose);
+        return;
+    }
+
+    // New interval: the pose reached now is the start, sample the end pose ahead
+    m_framesSinceSample = 0;
+    std::swap(m_previousPose, m_blendPose);
+    if (BlendAnimations(deltaTime * static_cast<float>(interval), channelCount)) {
+        WriteBoneTransforms(m_previousPose);
+    } else {
+        std::swap(m_previousPose, m_blendPose);
+    }
+}
+
+void AnimationController::SetBoneCount(size_t boneCount) {
+    m_boneTransforms.resize(boneCount, DirectX::XMMatrixIdentity());
+
+    // Size scratch poses up front so BlendAnimations never allocates
+    m_samplePose.Resize(boneCount);
+    m_blendPose.Resize(boneCount);
+    m_previousPose.Resize(boneCount);
+    m_outputPose.Resize(boneCount);
+    m_previousPose.SetIdentity();
+    if (const LocalPose* restPose = GetRestPose()) {
+        m_previousPose = *restPose;
+    }
+    m_modelTransforms.resize(m_skeleton ? boneCount : 0, DirectX::XMMatrixIdentity());
+    m_lodResync = true;
+}
+
+void AnimationController::SetSkeleton(std::shared_ptr<const Skeleton> skeleton) {
+    m_skeleton = std::move(skeleton);
+    SetBoneCount(m_skeleton ? m_skeleton->GetBoneCount() : m_boneTransforms.size());
+}
+
+const LocalPose* AnimationController::GetRestPose() const {
+    if (!m_skeleton || m_skeleton->GetBoneCount() != m_boneTransforms.size()) {
+        return nullptr;
+    }
+    return &m_skeleton->GetBindPose();
+}
+
+void AnimationController::WriteBoneTransforms(const LocalPose& pose) {
+    if (m_skeleton && m_modelTransforms.size() == m_boneTransforms.size()) {
+        m_skeleton->ComputeSkinningMatrices(pose, m_modelTransforms.data(), m_boneTransforms.data(), m_boneTransforms.size());
+    } else {
+        ComposePoseMatrices(pose, m_boneTransforms.data(), m_boneTransforms.size());
+    }
+}
+
 // Animation clip management
 void AnimationController::AddAnimationClip(const std::string& name, std::shared_ptr<AnimationClip> clip) {
     if (!clip) {
@@ -36,17 +153,21 @@ void AnimationController::AddAnimationClip(const std::string& name, std::shared_
         return;
     }
 
-    m_animationClips[name] = clip;
+    if (CONFIG_MANAGER.GetAnimationSettings().compressClips) {
+        clip->Compress();
+    }
+
+    m_animationClips[Core::StringId(name)] = clip;
     LOG_DEBUG("Animation clip added: " << name);
 }
 
-std::shared_ptr<AnimationClip> AnimationController::GetAnimationClip(const std::string& name) const {
+std::shared_ptr<AnimationClip> AnimationController::GetAnimationClip(Core::StringId name) const {
     auto it = m_animationClips.find(name);
     return (it != m_animationClips.end()) ? it->second : nullptr;
 }
 
 void AnimationController::RemoveAnimationClip(const std::string& name) {
-    auto it = m_animationClips.find(name);
+    auto it = m_animationClips.find(Core::StringId(name));
     if (it != m_animationClips.end()) {
         m_animationClips.erase(it);
         LOG_DEBUG("Animation clip removed: " << name);
@@ -107,6 +228,13 @@ void AnimationController::CrossFade(const std::string& animationName, float fade
         return;
     }
 
+    CrossFadeClip(clip, fadeDuration, loop, speed);
+    m_useStateMachine = false;
+
+    LOG_DEBUG("Cross-fading to animation: " << animationName);
+}
+
+void AnimationController::CrossFadeClip(const std::shared_ptr<AnimationClip>& clip, float fadeDuration, bool loop, float speed) {
     // Start fade out for current animations
     for (auto& playingAnim : m_playingAnimations) {
         if (!playingAnim.isBlending) {
@@ -129,9 +257,6 @@ void AnimationController::CrossFade(const std::string& animationName, float fade
 
     m_playingAnimations.push_back(newAnim);
     m_isPlaying = true;
-    m_useStateMachine = false;
-
-    LOG_DEBUG("Cross-fading to animation: " << animationName);
 }
 
 void AnimationController::AddLayer(const std::string& animationName, float weight, bool loop, float speed) {
@@ -176,43 +301,54 @@ void AnimationController::AddState(const std::string& stateName, const std::stri
 
     AnimationState state;
     state.name = stateName;
+    state.id = Core::StringId(stateName);
     state.clip = clip;
     state.loop = loop;
     state.speed = speed;
 
-    m_states[stateName] = state;
+    m_states[state.id] = state;
+    m_transitionTablesDirty = true;
 
     // Set as current state if it's the first one
     if (m_currentState.empty()) {
         m_currentState = stateName;
+        m_currentStateId = state.id;
     }
 
     LOG_DEBUG("Animation state added: " << stateName);
 }
 
-void AnimationController::AddTransition(const std::string& fromState, const std::string& toState, float duration) {
+void AnimationController::AddTransition(const std::string& fromState, const std::string& toState, float duration,
+                                        const std::string& triggerName) {
     AnimationTransition transition;
     transition.fromState = fromState;
     transition.toState = toState;
+    transition.fromId = Core::StringId(fromState);
+    transition.toId = Core::StringId(toState);
     transition.duration = duration;
+    transition.triggerName = triggerName;
+    if (!triggerName.empty()) {
+        transition.triggerId = Core::StringId(triggerName);
+    }
 
     m_transitions.push_back(transition);
+    m_transitionTablesDirty = true;
 
     LOG_DEBUG("Animation transition added: " << fromState << " -> " << toState);
 }
 
-void AnimationController::SetTrigger(const std::string& triggerName) {
-    m_triggers[triggerName] = true;
-    LOG_DEBUG("Animation trigger set: " << triggerName);
+void AnimationController::SetTrigger(Core::StringId trigger) {
+    m_triggers[trigger] = true;
 }
 
 void AnimationController::TransitionToState(const std::string& stateName) {
-    if (m_states.find(stateName) == m_states.end()) {
+    Core::StringId stateId(stateName);
+    if (!FindState(stateId)) {
         LOG_ERROR("Animation state not found: " << stateName);
         return;
     }
 
-    if (m_currentState == stateName) {
+    if (m_currentStateId == stateId) {
         return; // Already in target state
     }
 
@@ -220,11 +356,14 @@ void AnimationController::TransitionToState(const std::string& stateName) {
     m_useStateMachine = true;
 
     // Find and execute transition
-    auto transitions = FindTransitionsFromState(m_currentState);
-    for (auto* transition : transitions) {
-        if (transition->toState == stateName) {
-            StartTransition(*transition);
-            break;
+    CompileTransitionTables();
+    AnimationState* currentState = FindState(m_currentStateId);
+    if (currentState) {
+        for (size_t index : currentState->transitions) {
+            if (m_transitions[index].toId == stateId) {
+                StartTransition(m_transitions[index]);
+                break;
+            }
         }
     }
 
@@ -232,29 +371,29 @@ void AnimationController::TransitionToState(const std::string& stateName) {
 }
 
 // Animation parameters
-void AnimationController::SetFloat(const std::string& name, float value) {
+void AnimationController::SetFloat(Core::StringId name, float value) {
     m_floatParams[name] = value;
 }
 
-void AnimationController::SetInt(const std::string& name, int value) {
+void AnimationController::SetInt(Core::StringId name, int value) {
     m_intParams[name] = value;
 }
 
-void AnimationController::SetBool(const std::string& name, bool value) {
+void AnimationController::SetBool(Core::StringId name, bool value) {
     m_boolParams[name] = value;
 }
 
-float AnimationController::GetFloat(const std::string& name) const {
+float AnimationController::GetFloat(Core::StringId name) const {
     auto it = m_floatParams.find(name);
     return (it != m_floatParams.end()) ? it->second : 0.0f;
 }
 
-int AnimationController::GetInt(const std::string& name) const {
+int AnimationController::GetInt(Core::StringId name) const {
     auto it = m_intParams.find(name);
     return (it != m_intParams.end()) ? it->second : 0;
 }
 
-bool AnimationController::GetBool(const std::string& name) const {
+bool AnimationController::GetBool(Core::StringId name) const {
     auto it = m_boolParams.find(name);
     return (it != m_boolParams.end()) ? it->second : false;
 }
@@ -324,7 +463,7 @@ void AnimationController::UpdateStateMachine(float deltaTime) {
     if (m_currentState.empty()) return;
 
     // Update current state animation
-    AnimationState* currentState = FindState(m_currentState);
+    AnimationState* currentState = FindState(m_currentStateId);
     if (currentState && currentState->clip) {
         // Update or create playing animation for current state
         if (m_playingAnimations.empty()) {
@@ -344,59 +483,72 @@ void AnimationController::UpdateStateMachine(float deltaTime) {
     CheckTransitions();
 }
 
-void AnimationController::BlendAnimations() {
-    if (m_playingAnimations.empty() || m_boneTransforms.empty()) return;
-
-    // Reset bone transforms
-    std::fill(m_boneTransforms.begin(), m_boneTransforms.end(), DirectX::XMMatrixIdentity());
-
-    // Temporary storage for blended transforms
-    std::vector<DirectX::XMMATRIX> tempTransforms(m_boneTransforms.size(), DirectX::XMMatrixIdentity());
+bool AnimationController::BlendAnimations(float lookahead, size_t channelCount) {
+    if (m_playingAnimations.empty() || m_boneTransforms.empty()) return false;
 
     // Normalize weights
     NormalizeWeights();
 
-    // Blend all playing animations
-    for (const auto& playingAnim : m_playingAnimations) {
+    // No-ops once the scratch poses match the skeleton
+    size_t boneCount = m_boneTransforms.size();
+    m_samplePose.Resize(boneCount);
+    m_blendPose.Resize(boneCount);
+    m_previousPose.Resize(boneCount);
+    m_outputPose.Resize(boneCount);
+
+    // Blend all playing animations in local space
+    const LocalPose* restPose = GetRestPose();
+    m_poseBlender.Begin(m_blendPose);
+    for (auto& playingAnim : m_playingAnimations) {
         if (!playingAnim.clip || playingAnim.weight <= 0.0f) continue;
 
-        // Sample animation
-        std::vector<DirectX::XMMATRIX> animTransforms(m_boneTransforms.size(), DirectX::XMMatrixIdentity());
-        playingAnim.clip->SampleAnimation(playingAnim.currentTime, animTransforms);
+        // Reduced-rate tiers sample ahead of the playback time
+        float time = playingAnim.currentTime + lookahead * playingAnim.speed;
+        time = playingAnim.loop ? playingAnim.clip->LoopTime(time) : playingAnim.clip->NormalizeTime(time);
 
-        // Blend with existing transforms
-        for (size_t i = 0; i < m_boneTransforms.size(); i++) {
-            if (playingAnim.weight >= 1.0f) {
-                m_boneTransforms[i] = animTransforms[i];
-            } else {
-                // Linear blend (simplified - should use proper matrix interpolation)
-                DirectX::XMMATRIX blended = DirectX::XMMatrixMultiply(
-                    DirectX::XMMatrixScaling(1.0f - playingAnim.weight, 1.0f - playingAnim.weight, 1.0f - playingAnim.weight),
-                    m_boneTransforms[i]
-                );
-                blended = blended +
-                    DirectX::XMMatrixMultiply(
-                        DirectX::XMMatrixScaling(playingAnim.weight, playingAnim.weight, playingAnim.weight),
-                        animTransforms[i]
-                    );
-                m_boneTransforms[i] = blended;
+        // Sample animation, resuming from last frame's keyframes
+        playingAnim.clip->SampleLocalPose(time, m_samplePose, playingAnim.cursor, channelCount, restPose);
+        m_poseBlender.Add(m_blendPose, m_samplePose, playingAnim.weight);
+    }
+    m_poseBlender.Finish(m_blendPose, restPose);
+
+    // Bones whose channels were skipped hold their last pose
+    if (channelCount != AnimationClip::ALL_CHANNELS) {
+        for (const auto& playingAnim : m_playingAnimations) {
+            if (!playingAnim.clip) continue;
+
+            const auto& channels = playingAnim.clip->GetChannels();
+            for (size_t i = channelCount; i < channels.size(); i++) {
+                int boneIndex = channels[i].boneIndex;
+                if (boneIndex < 0 || static_cast<size_t>(boneIndex) >= boneCount) continue;
+
+                m_blendPose.translations[boneIndex] = m_previousPose.translations[boneIndex];
+                m_blendPose.rotations[boneIndex] = m_previousPose.rotations[boneIndex];
+                m_blendPose.scales[boneIndex] = m_previousPose.scales[boneIndex];
             }
         }
     }
+
+    return true;
 }
 
 void AnimationController::CheckTransitions() {
-    auto transitions = FindTransitionsFromState(m_currentState);
+    CompileTransitionTables();
+
+    AnimationState* currentState = FindState(m_currentStateId);
+    if (!currentState) return;
 
-    for (auto* transition : transitions) {
+    // Only this state's transitions; runs every frame and must not allocate
+    for (size_t index : currentState->transitions) {
+        AnimationTransition* transition = &m_transitions[index];
         bool shouldTransition = false;
 
         // Check trigger condition
-        if (!transition->triggerName.empty()) {
-            auto it = m_triggers.find(transition->triggerName);
+        if (transition->triggerId.IsValid()) {
+            auto it = m_triggers.find(transition->triggerId);
             if (it != m_triggers.end() && it->second) {
                 shouldTransition = true;
-                m_triggers[transition->triggerName] = false; // Reset trigger
+                it->second = false; // Reset trigger
             }
         }
 
@@ -416,13 +568,14 @@ void AnimationController::CheckTransitions() {
 }
 
 void AnimationController::StartTransition(const AnimationTransition& transition) {
-    AnimationState* targetState = FindState(transition.toState);
-    if (!targetState) return;
+    AnimationState* targetState = FindState(transition.toId);
+    if (!targetState || !targetState->clip) return;
 
     // Start cross-fade to new state
-    CrossFade(targetState->clip->GetName(), transition.duration, targetState->loop, targetState->speed);
+    CrossFadeClip(targetState->clip, transition.duration, targetState->loop, targetState->speed);
 
-    m_currentState = transition.toState;
+    m_currentState = targetState->name;
+    m_currentStateId = targetState->id;
     m_targetState.clear();
 
     LOG_DEBUG("Started transition to state: " << transition.toState);
@@ -453,21 +606,27 @@ void AnimationController::NormalizeWeights() {
     }
 }
 
-AnimationState* AnimationController::FindState(const std::string& name) {
-    auto it = m_states.find(name);
+AnimationState* AnimationController::FindState(Core::StringId id) {
+    auto it = m_states.find(id);
     return (it != m_states.end()) ? &it->second : nullptr;
 }
 
-std::vector<AnimationTransition*> AnimationController::FindTransitionsFromState(const std::string& stateName) {
-    std::vector<AnimationTransition*> result;
+void AnimationController::CompileTransitionTables() {
+    if (!m_transitionTablesDirty) return;
+
+    for (auto& entry : m_states) {
+        entry.second.transitions.clear();
+    }
 
-    for (auto& transition : m_transitions) {
-        if (transition.fromState == stateName) {
-            result.push_back(&transition);
+    // Keep declaration order so earlier transitions still win ties
+    for (size_t i = 0; i < m_transitions.size(); i++) {
+        AnimationState* fromState = FindState(m_transitions[i].fromId);
+        if (fromState) {
+            fromState->transitions.push_back(i);
         }
     }
 
-    return result;
+    m_transitionTablesDirty = false;
 }
 
 } // namespace Animation
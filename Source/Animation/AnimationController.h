@@ -1,8 +1,11 @@
 #pragma once
 
 #include "AnimationClip.h"
+#include "AnimationLOD.h"
+#include "Skeleton.h"
 #include "../Scene/Component.h"
 #include "../Scene/Entity.h"
+#include "../Core/StringId.h"
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -13,12 +16,16 @@ namespace Animation {
 // Animation state for state machine
 struct AnimationState {
     std::string name;
+    Core::StringId id;
     std::shared_ptr<AnimationClip> clip;
     bool loop;
     float speed;
     float blendInTime;
     float blendOutTime;
 
+    // Indices into the controller's transitions leaving this state
+    std::vector<size_t> transitions;
+
     AnimationState() : loop(true), speed(1.0f), blendInTime(0.3f), blendOutTime(0.3f) {}
 };
 
@@ -26,12 +33,15 @@ struct AnimationState {
 struct AnimationTransition {
     std::string fromState;
     std::string toState;
+    Core::StringId fromId;
+    Core::StringId toId;
     float duration;
     bool hasExitTime;
     float exitTime; // Normalized time (0-1) in source animation
 
     // Transition conditions (simplified)
     std::string triggerName;
+    Core::StringId triggerId;
 
     AnimationTransition() : duration(0.3f), hasExitTime(false), exitTime(0.9f) {}
 };
@@ -47,6 +57,9 @@ struct PlayingAnimation {
     float blendTime;
     float blendDuration;
 
+    // Keyframe positions from the previous sample
+    AnimationCursor cursor;
+
     PlayingAnimation() : currentTime(0.0f), speed(1.0f), weight(1.0f),
                         loop(true), isBlending(false), blendTime(0.0f), blendDuration(0.0f) {}
 };
@@ -58,9 +71,18 @@ public:
     AnimationController();
     virtual ~AnimationController() = default;
 
+    // Each controller only evaluates its own state and pose
+    static Scene::ComponentUpdateDesc GetUpdateDesc() {
+        Scene::ComponentUpdateDesc desc;
+        desc.reads = Scene::ACCESS_ANIMATION;
+        desc.writes = Scene::ACCESS_ANIMATION;
+        desc.parallelChunks = true;
+        return desc;
+    }
+
     // Animation clip management
     void AddAnimationClip(const std::string& name, std::shared_ptr<AnimationClip> clip);
-    std::shared_ptr<AnimationClip> GetAnimationClip(const std::string& name) const;
+    std::shared_ptr<AnimationClip> GetAnimationClip(Core::StringId name) const;
     void RemoveAnimationClip(const std::string& name);
 
     // Simple animation playback
@@ -77,20 +99,22 @@ public:
 
     // State machine
     void AddState(const std::string& stateName, const std::string& clipName, bool loop = true, float speed = 1.0f);
-    void AddTransition(const std::string& fromState, const std::string& toState, float duration = 0.3f);
-    void SetTrigger(const std::string& triggerName);
+    void AddTransition(const std::string& fromState, const std::string& toState, float duration = 0.3f,
+                       const std::string& triggerName = std::string());
+    void SetTrigger(Core::StringId trigger);
     void TransitionToState(const std::string& stateName);
 
     const std::string& GetCurrentState() const { return m_currentState; }
 
-    // Animation parameters
-    void SetFloat(const std::string& name, float value);
-    void SetInt(const std::string& name, int value);
-    void SetBool(const std::string& name, bool value);
+    // Animation parameters, keyed by hashed name; pass constexpr IDs
+    // ("Speed"_id) from per-frame gameplay code
+    void SetFloat(Core::StringId name, float value);
+    void SetInt(Core::StringId name, int value);
+    void SetBool(Core::StringId name, bool value);
 
-    float GetFloat(const std::string& name) const;
-    int GetInt(const std::string& name) const;
-    bool GetBool(const std::string& name) const;
+    float GetFloat(Core::StringId name) const;
+    int GetInt(Core::StringId name) const;
+    bool GetBool(Core::StringId name) const;
 
     // Animation info
     bool IsPlaying() const { return m_isPlaying; }
@@ -99,9 +123,29 @@ public:
     float GetNormalizedTime() const; // 0-1
     std::string GetCurrentAnimationName() const;
 
-    // Bone transforms output
+    // Bone transforms output: skinning matrices (inverse bind * model) with
+    // a skeleton, local transforms without one
     const std::vector<DirectX::XMMATRIX>& GetBoneTransforms() const { return m_boneTransforms; }
-    void SetBoneCount(size_t boneCount) { m_boneTransforms.resize(boneCount, DirectX::XMMatrixIdentity()); }
+    void SetBoneCount(size_t boneCount);
+
+    // Sizes the pose to the skeleton's bones; unanimated bones then hold the
+    // bind pose. Clips must be bound to it (AnimationClip::BindToSkeleton).
+    void SetSkeleton(std::shared_ptr<const Skeleton> skeleton);
+    const std::shared_ptr<const Skeleton>& GetSkeleton() const { return m_skeleton; }
+    // Model-space bone transforms from the last evaluation; empty without a skeleton
+    const std::vector<DirectX::XMMATRIX>& GetModelTransforms() const { return m_modelTransforms; }
+
+    // Update tier, normally chosen by the scene from visibility and screen size
+    void SetLOD(AnimationLOD lod);
+    AnimationLOD GetLOD() const { return m_lod; }
+    void SetReducedChannelCount(size_t channelCount) { m_reducedChannelCount = channelCount; }
+
+    // Advance playback and sample the pose. Touches only this controller and
+    // its read-only clips, so controllers can be evaluated concurrently.
+    void Evaluate(float deltaTime);
+
+    // Called by the scene's animation stage; the next OnUpdate is skipped
+    void EvaluateFromSystem(float deltaTime);
 
     // Component lifecycle
     virtual void OnStart() override;
@@ -109,13 +153,15 @@ public:
 
 private:
     // Animation storage
-    std::unordered_map<std::string, std::shared_ptr<AnimationClip>> m_animationClips;
+    std::unordered_map<Core::StringId, std::shared_ptr<AnimationClip>> m_animationClips;
 
-    // State machine
-    std::unordered_map<std::string, AnimationState> m_states;
+    // State machine; per-state transition tables are rebuilt when dirty
+    std::unordered_map<Core::StringId, AnimationState> m_states;
     std::vector<AnimationTransition> m_transitions;
     std::string m_currentState;
     std::string m_targetState;
+    Core::StringId m_currentStateId;
+    bool m_transitionTablesDirty;
 
     // Currently playing animations (for layering/blending)
     std::vector<PlayingAnimation> m_playingAnimations;
@@ -126,26 +172,49 @@ private:
     bool m_useStateMachine;
 
     // Parameters
-    std::unordered_map<std::string, float> m_floatParams;
-    std::unordered_map<std::string, int> m_intParams;
-    std::unordered_map<std::string, bool> m_boolParams;
-    std::unordered_map<std::string, bool> m_triggers;
+    std::unordered_map<Core::StringId, float> m_floatParams;
+    std::unordered_map<Core::StringId, int> m_intParams;
+    std::unordered_map<Core::StringId, bool> m_boolParams;
+    std::unordered_map<Core::StringId, bool> m_triggers;
 
     // Output
+    std::shared_ptr<const Skeleton> m_skeleton;
     std::vector<DirectX::XMMATRIX> m_boneTransforms;
+    std::vector<DirectX::XMMATRIX> m_modelTransforms;
+
+    // Per-frame scratch poses, sized with the bone count and reused
+    LocalPose m_samplePose;
+    LocalPose m_blendPose;
+    PoseBlender m_poseBlender;
+
+    // LOD: reduced-rate tiers interpolate from m_previousPose to m_blendPose,
+    // which is sampled one interval ahead
+    AnimationLOD m_lod;
+    LocalPose m_previousPose;
+    LocalPose m_outputPose;
+    std::uint32_t m_framesSinceSample;
+    size_t m_reducedChannelCount;
+    bool m_lodResync;
+
+    // Set when the scene stage has already evaluated this frame
+    bool m_evaluatedBySystem;
 
     // Internal methods
     void UpdateAnimations(float deltaTime);
     void UpdateStateMachine(float deltaTime);
-    void BlendAnimations();
+    void EvaluatePose(float deltaTime);
+    bool BlendAnimations(float lookahead, size_t channelCount);
+    void WriteBoneTransforms(const LocalPose& pose);
+    const LocalPose* GetRestPose() const;
     void CheckTransitions();
     void StartTransition(const AnimationTransition& transition);
+    void CompileTransitionTables();
+    void CrossFadeClip(const std::shared_ptr<AnimationClip>& clip, float fadeDuration, bool loop, float speed);
 
     // Helper methods
     void CleanupFinishedAnimations();
     void NormalizeWeights();
-    AnimationState* FindState(const std::string& name);
-    std::vector<AnimationTransition*> FindTransitionsFromState(const std::string& stateName);
+    AnimationState* FindState(Core::StringId id);
 };
 
 } // namespace Animation
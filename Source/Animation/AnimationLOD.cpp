@@ -0,0 +1,29 @@
+#include "AnimationLOD.h"
+#include "../Core/ConfigManager.h"
+
+namespace GameEngine {
+namespace Animation {
+
+AnimationLOD SelectAnimationLOD(const Core::AnimationSettings& settings, bool visible, float screenSize) {
+    if (!settings.enableLOD) {
+        return AnimationLOD::Full;
+    }
+
+    if (!visible) {
+        return settings.cullOffscreen ? AnimationLOD::Culled : AnimationLOD::QuarterRate;
+    }
+
+    if (screenSize < settings.reducedScreenSize) {
+        return AnimationLOD::Reduced;
+    }
+    if (screenSize < settings.quarterRateScreenSize) {
+        return AnimationLOD::QuarterRate;
+    }
+    if (screenSize < settings.halfRateScreenSize) {
+        return AnimationLOD::HalfRate;
+    }
+    return AnimationLOD::Full;
+}
+
+} // namespace Animation
+} // namespace GameEngine
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GameEngine {
+
+// Forward declarations
+namespace Core {
+    struct AnimationSettings;
+}
+
+namespace Animation {
+
+// Animation update tiers, most to least expensive
+enum class AnimationLOD : std::uint8_t {
+    Full,        // Sample every frame
+    HalfRate,    // Sample every 2nd frame, interpolate in between
+    QuarterRate, // Sample every 4th frame, interpolate in between
+    Reduced,     // Quarter rate, and only the leading channels are sampled
+    Culled       // Off-screen: time advances, nothing is sampled
+};
+
+// Frames between samples for a tier (0 for Culled)
+inline std::uint32_t GetAnimationLODInterval(AnimationLOD lod) {
+    switch (lod) {
+        case AnimationLOD::Full:        return 1;
+        case AnimationLOD::HalfRate:    return 2;
+        case AnimationLOD::QuarterRate: return 4;
+        case AnimationLOD::Reduced:     return 4;
+        default:                        return 0;
+    }
+}
+
+// Pick a tier from visibility and projected size (bounding sphere diameter
+// as a fraction of the screen height)
+AnimationLOD SelectAnimationLOD(const Core::AnimationSettings& settings, bool visible, float screenSize);
+
+} // namespace Animation
+} // namespace GameEngine
@@ -0,0 +1,106 @@
+#include "AnimationPose.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace GameEngine {
+namespace Animation {
+
+void LocalPose::Resize(size_t boneCount) {
+    translations.resize(boneCount);
+    rotations.resize(boneCount);
+    scales.resize(boneCount);
+}
+
+void LocalPose::SetIdentity() {
+    std::fill(translations.begin(), translations.end(), XMFLOAT3(0.0f, 0.0f, 0.0f));
+    std::fill(rotations.begin(), rotations.end(), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    std::fill(scales.begin(), scales.end(), XMFLOAT3(1.0f, 1.0f, 1.0f));
+}
+
+void PoseBlender::Begin(LocalPose& target) {
+    m_totalWeight = 0.0f;
+
+    // Accumulators start at zero, not identity
+    std::fill(target.translations.begin(), target.translations.end(), XMFLOAT3(0.0f, 0.0f, 0.0f));
+    std::fill(target.rotations.begin(), target.rotations.end(), XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f));
+    std::fill(target.scales.begin(), target.scales.end(), XMFLOAT3(0.0f, 0.0f, 0.0f));
+}
+
+void PoseBlender::Add(LocalPose& target, const LocalPose& source, float weight) {
+    if (weight <= 0.0f) {
+        return;
+    }
+
+    size_t boneCount = std::min(target.GetBoneCount(), source.GetBoneCount());
+    XMVECTOR w = XMVectorReplicate(weight);
+
+    for (size_t i = 0; i < boneCount; i++) {
+        XMVECTOR translation = XMLoadFloat3(&target.translations[i]);
+        translation = XMVectorMultiplyAdd(XMLoadFloat3(&source.translations[i]), w, translation);
+        XMStoreFloat3(&target.translations[i], translation);
+
+        XMVECTOR scale = XMLoadFloat3(&target.scales[i]);
+        scale = XMVectorMultiplyAdd(XMLoadFloat3(&source.scales[i]), w, scale);
+        XMStoreFloat3(&target.scales[i], scale);
+
+        // Flip to the accumulator's hemisphere so q and -q don't cancel out
+        XMVECTOR accumulated = XMLoadFloat4(&target.rotations[i]);
+        XMVECTOR rotation = XMLoadFloat4(&source.rotations[i]);
+        XMVECTOR sign = XMVectorSelect(XMVectorReplicate(1.0f), XMVectorReplicate(-1.0f),
+                                       XMVectorLess(XMVector4Dot(accumulated, rotation), XMVectorZero()));
+        accumulated = XMVectorMultiplyAdd(rotation, XMVectorMultiply(w, sign), accumulated);
+        XMStoreFloat4(&target.rotations[i], accumulated);
+    }
+
+    m_totalWeight += weight;
+}
+
+void PoseBlender::Finish(LocalPose& target, const LocalPose* restPose) {
+    // Remaining weight blends towards the rest pose
+    float restWeight = std::max(0.0f, 1.0f - m_totalWeight);
+    if (restPose && restWeight > 0.0f) {
+        Add(target, *restPose, restWeight);
+        m_totalWeight -= restWeight;
+        restWeight = 0.0f;
+    }
+    XMVECTOR rest = XMVectorReplicate(restWeight);
+    XMVECTOR identityRotation = XMQuaternionIdentity();
+
+    size_t boneCount = target.GetBoneCount();
+    for (size_t i = 0; i < boneCount; i++) {
+        if (restWeight > 0.0f) {
+            XMVECTOR scale = XMLoadFloat3(&target.scales[i]);
+            XMStoreFloat3(&target.scales[i], XMVectorAdd(scale, rest));
+
+            XMVECTOR accumulated = XMLoadFloat4(&target.rotations[i]);
+            XMVECTOR sign = XMVectorSelect(XMVectorReplicate(1.0f), XMVectorReplicate(-1.0f),
+                                           XMVectorLess(XMVector4Dot(accumulated, identityRotation), XMVectorZero()));
+            accumulated = XMVectorMultiplyAdd(identityRotation, XMVectorMultiply(rest, sign), accumulated);
+            XMStoreFloat4(&target.rotations[i], accumulated);
+        }
+
+        // nlerp: renormalize, falling back to identity for degenerate sums
+        XMVECTOR rotation = XMLoadFloat4(&target.rotations[i]);
+        if (XMVectorGetX(XMVector4LengthSq(rotation)) > 1e-8f) {
+            XMStoreFloat4(&target.rotations[i], XMQuaternionNormalize(rotation));
+        }
+        else {
+            XMStoreFloat4(&target.rotations[i], identityRotation);
+        }
+    }
+}
+
+void ComposePoseMatrices(const LocalPose& pose, XMMATRIX* matrices, size_t count) {
+    size_t boneCount = std::min(count, pose.GetBoneCount());
+    XMVECTOR origin = XMVectorZero();
+
+    for (size_t i = 0; i < boneCount; i++) {
+        matrices[i] = XMMatrixAffineTransformation(XMLoadFloat3(&pose.scales[i]), origin,
+                                                   XMLoadFloat4(&pose.rotations[i]),
+                                                   XMLoadFloat3(&pose.translations[i]));
+    }
+}
+
+} // namespace Animation
+} // namespace GameEngine
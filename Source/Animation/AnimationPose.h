@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+
+namespace GameEngine {
+namespace Animation {
+
+// Local-space bone transforms stored as separate translation, rotation
+// (quaternion) and scale streams. Buffers are sized once per skeleton and
+// reused every frame.
+struct LocalPose {
+    std::vector<DirectX::XMFLOAT3> translations;
+    std::vector<DirectX::XMFLOAT4> rotations;
+    std::vector<DirectX::XMFLOAT3> scales;
+
+    size_t GetBoneCount() const { return translations.size(); }
+
+    // No allocation when the size is unchanged
+    void Resize(size_t boneCount);
+    void SetIdentity();
+};
+
+// Weighted pose accumulation. Begin, add each layer, then Finish:
+//   translation/scale: weighted sum
+//   rotation: weighted sum on one hemisphere, renormalized (nlerp)
+// Weight left over when the layers sum to less than one goes to the rest
+// pose: the skeleton's bind pose, or the identity transform without one.
+class PoseBlender {
+public:
+    PoseBlender() : m_totalWeight(0.0f) {}
+
+    void Begin(LocalPose& target);
+    void Add(LocalPose& target, const LocalPose& source, float weight);
+    void Finish(LocalPose& target, const LocalPose* restPose = nullptr);
+
+    float GetTotalWeight() const { return m_totalWeight; }
+
+private:
+    float m_totalWeight;
+};
+
+// Compose scale * rotation * translation for every bone
+void ComposePoseMatrices(const LocalPose& pose, DirectX::XMMATRIX* matrices, size_t count);
+
+} // namespace Animation
+} // namespace GameEngine
@@ -0,0 +1,421 @@
+#include "CompressedAnimation.h"
+#include "AnimationClip.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+
+using namespace DirectX;
+
+namespace GameEngine {
+namespace Animation {
+
+namespace {
+    constexpr float QUANTIZE_16 = 65535.0f;
+    constexpr float QUANTIZE_15 = 32767.0f;
+    constexpr float SMALLEST_THREE_RANGE = 0.70710678f; // 1 / sqrt(2)
+    constexpr size_t MAX_CURSOR_STEPS = 4;
+    constexpr std::uint32_t MAX_SPARSE_FRAMES = 0xFFFF;
+    constexpr int MAX_REDUCTION_ATTEMPTS = 4;   // Halvings of the reduction tolerance before going dense
+
+    std::uint16_t Quantize(float value, float minimum, float extent, float steps) {
+        if (extent <= 0.0f) {
+            return 0;
+        }
+        float normalized = std::clamp((value - minimum) / extent, 0.0f, 1.0f);
+        return static_cast<std::uint16_t>(normalized * steps + 0.5f);
+    }
+
+    float Dequantize(std::uint16_t value, float minimum, float extent, float steps) {
+        return minimum + extent * (static_cast<float>(value) / steps);
+    }
+
+    XMVECTOR InterpolateKeys(XMVECTOR a, XMVECTOR b, float t, bool rotation) {
+        if (!rotation) {
+            return XMVectorLerp(a, b, t);
+        }
+
+        // nlerp on the shorter arc
+        if (XMVectorGetX(XMVector4Dot(a, b)) < 0.0f) {
+            b = XMVectorNegate(b);
+        }
+        return XMQuaternionNormalize(XMVectorLerp(a, b, t));
+    }
+
+    float KeyError(XMVECTOR expected, XMVECTOR actual, bool rotation) {
+        if (rotation) {
+            float dot = std::min(1.0f, std::fabs(XMVectorGetX(XMVector4Dot(expected, actual))));
+            return 2.0f * std::acos(dot);
+        }
+        XMVECTOR difference = XMVectorAbs(XMVectorSubtract(expected, actual));
+        return std::max(XMVectorGetX(difference), std::max(XMVectorGetY(difference), XMVectorGetZ(difference)));
+    }
+}
+
+CompressedAnimation::CompressedAnimation()
+    : m_sampleRate(30.0f)
+    , m_frameCount(0)
+    , m_maxErrors{ 0.0f, 0.0f, 0.0f }
+{
+}
+
+bool CompressedAnimation::Build(const std::vector<AnimationChannel>& channels, float duration,
+                                const AnimationCompressionSettings& settings) {
+    m_channels.clear();
+    m_keyData.clear();
+    m_frames.clear();
+    std::fill(std::begin(m_maxErrors), std::end(m_maxErrors), 0.0f);
+
+    if (settings.sampleRate <= 0.0f) {
+        return false;
+    }
+
+    m_sampleRate = settings.sampleRate;
+    m_frameCount = static_cast<std::uint32_t>(std::ceil(std::max(duration, 0.0f) * m_sampleRate)) + 1;
+
+    std::vector<XMFLOAT4> positions(m_frameCount);
+    std::vector<XMFLOAT4> rotations(m_frameCount);
+    std::vector<XMFLOAT4> scales(m_frameCount);
+    std::vector<ReferenceKey> references;
+
+    // Source keys past the end are never played
+    float lastFrame = static_cast<float>(m_frameCount - 1);
+    auto addReference = [&](float time, const XMFLOAT4& value) {
+        if (time <= duration) {
+            references.push_back({ std::min(time * m_sampleRate, lastFrame), value });
+        }
+    };
+
+    m_channels.resize(channels.size());
+    for (size_t c = 0; c < channels.size(); c++) {
+        const AnimationChannel& source = channels[c];
+        Channel& channel = m_channels[c];
+
+        // Resample at the fixed rate; keys are then addressed by frame number
+        KeyframeCursor cursor;
+        for (std::uint32_t f = 0; f < m_frameCount; f++) {
+            float time = std::min(static_cast<float>(f) / m_sampleRate, duration);
+
+            XMFLOAT3 position = source.SamplePosition(time, cursor.position);
+            XMFLOAT4 rotation = source.SampleRotation(time, cursor.rotation);
+            XMFLOAT3 scale = source.SampleScale(time, cursor.scale);
+
+            positions[f] = XMFLOAT4(position.x, position.y, position.z, 0.0f);
+            scales[f] = XMFLOAT4(scale.x, scale.y, scale.z, 0.0f);
+
+            // Keep consecutive rotations on one hemisphere so reduction sees the short arc
+            XMVECTOR q = XMQuaternionNormalize(XMLoadFloat4(&rotation));
+            if (f > 0 && XMVectorGetX(XMVector4Dot(q, XMLoadFloat4(&rotations[f - 1]))) < 0.0f) {
+                q = XMVectorNegate(q);
+            }
+            XMStoreFloat4(&rotations[f], q);
+        }
+
+        if (!source.positionKeys.empty()) {
+            references.clear();
+            for (const PositionKeyframe& key : source.positionKeys) {
+                addReference(key.time, XMFLOAT4(key.position.x, key.position.y, key.position.z, 0.0f));
+            }
+            float error = BuildTrack(channel.position, TrackKind::Position, positions, references,
+                                     settings.positionTolerance, settings);
+            m_maxErrors[0] = std::max(m_maxErrors[0], error);
+        }
+        if (!source.rotationKeys.empty()) {
+            references.clear();
+            for (const RotationKeyframe& key : source.rotationKeys) {
+                XMFLOAT4 rotation;
+                XMStoreFloat4(&rotation, XMQuaternionNormalize(XMLoadFloat4(&key.rotation)));
+                addReference(key.time, rotation);
+            }
+            float error = BuildTrack(channel.rotation, TrackKind::Rotation, rotations, references,
+                                     settings.rotationTolerance, settings);
+            m_maxErrors[1] = std::max(m_maxErrors[1], error);
+        }
+        if (!source.scaleKeys.empty()) {
+            references.clear();
+            for (const ScaleKeyframe& key : source.scaleKeys) {
+                addReference(key.time, XMFLOAT4(key.scale.x, key.scale.y, key.scale.z, 0.0f));
+            }
+            float error = BuildTrack(channel.scale, TrackKind::Scale, scales, references,
+                                     settings.scaleTolerance, settings);
+            m_maxErrors[2] = std::max(m_maxErrors[2], error);
+        }
+    }
+
+    m_keyData.shrink_to_fit();
+    m_frames.shrink_to_fit();
+    return true;
+}
+
+float CompressedAnimation::BuildTrack(Track& track, TrackKind kind, const std::vector<XMFLOAT4>& samples,
+                                      const std::vector<ReferenceKey>& references, float tolerance,
+                                      const AnimationCompressionSettings& settings) {
+    size_t keyDataSize = m_keyData.size();
+    size_t frameDataSize = m_frames.size();
+
+    // Reduction alone uses up the whole tolerance, leaving nothing for
+    // quantization, so tighten it until the decoded keys fit. The last
+    // attempt keeps every frame that is not exactly linear.
+    float reductionTolerance = tolerance;
+    float error = 0.0f;
+    for (int attempt = 0; attempt <= MAX_REDUCTION_ATTEMPTS; attempt++) {
+        if (attempt == MAX_REDUCTION_ATTEMPTS) {
+            reductionTolerance = 0.0f;
+        }
+
+        track = Track();
+        EncodeTrack(track, kind, samples, reductionTolerance, settings);
+        error = MeasureTrackError(track, kind, samples, references);
+        if (error <= tolerance || attempt == MAX_REDUCTION_ATTEMPTS) {
+            break;
+        }
+
+        m_keyData.resize(keyDataSize);
+        m_frames.resize(frameDataSize);
+        reductionTolerance *= 0.5f;
+    }
+    return error;
+}
+
+float CompressedAnimation::MeasureTrackError(const Track& track, TrackKind kind, const std::vector<XMFLOAT4>& samples,
+                                             const std::vector<ReferenceKey>& references) const {
+    bool rotation = kind == TrackKind::Rotation;
+    float error = 0.0f;
+
+    // The source keys themselves, then the resampled curve between them
+    std::uint32_t cursor = 0;
+    for (const ReferenceKey& reference : references) {
+        XMVECTOR decoded = SampleTrack(track, kind, reference.frame, cursor);
+        error = std::max(error, KeyError(XMLoadFloat4(&reference.value), decoded, rotation));
+    }
+
+    cursor = 0;
+    for (std::uint32_t f = 0; f < static_cast<std::uint32_t>(samples.size()); f++) {
+        XMVECTOR decoded = SampleTrack(track, kind, static_cast<float>(f), cursor);
+        error = std::max(error, KeyError(XMLoadFloat4(&samples[f]), decoded, rotation));
+    }
+    return error;
+}
+
+void CompressedAnimation::EncodeTrack(Track& track, TrackKind kind, const std::vector<XMFLOAT4>& samples,
+                                      float tolerance, const AnimationCompressionSettings& settings) {
+    bool rotation = kind == TrackKind::Rotation;
+    std::uint32_t frameCount = static_cast<std::uint32_t>(samples.size());
+
+    // Constant-track collapsing
+    XMVECTOR first = XMLoadFloat4(&samples[0]);
+    bool constant = true;
+    for (std::uint32_t f = 1; f < frameCount && constant; f++) {
+        constant = KeyError(first, XMLoadFloat4(&samples[f]), rotation) <= tolerance;
+    }
+
+    if (constant) {
+        track.format = TrackFormat::Constant;
+        track.keyCount = 1;
+        track.base = samples[0];
+        return;
+    }
+
+    // Keyframe reduction: extend each segment while linear interpolation
+    // between its end keys stays within tolerance of every skipped frame
+    std::vector<std::uint32_t> kept;
+    kept.push_back(0);
+    std::uint32_t anchor = 0;
+    for (std::uint32_t end = anchor + 2; end < frameCount; end++) {
+        XMVECTOR a = XMLoadFloat4(&samples[anchor]);
+        XMVECTOR b = XMLoadFloat4(&samples[end]);
+        float span = static_cast<float>(end - anchor);
+
+        bool fits = true;
+        for (std::uint32_t f = anchor + 1; f < end && fits; f++) {
+            XMVECTOR predicted = InterpolateKeys(a, b, static_cast<float>(f - anchor) / span, rotation);
+            fits = KeyError(predicted, XMLoadFloat4(&samples[f]), rotation) <= tolerance;
+        }
+
+        if (!fits) {
+            anchor = end - 1;
+            kept.push_back(anchor);
+        }
+    }
+    kept.push_back(frameCount - 1);
+
+    // Frame numbers cost 2 bytes per key, only worth it when reduction paid off
+    bool sparse = frameCount <= MAX_SPARSE_FRAMES &&
+                  static_cast<float>(kept.size()) <= settings.denseThreshold * static_cast<float>(frameCount);
+    if (!sparse) {
+        kept.resize(frameCount);
+        for (std::uint32_t f = 0; f < frameCount; f++) {
+            kept[f] = f;
+        }
+    }
+
+    track.format = sparse ? TrackFormat::Sparse : TrackFormat::Dense;
+    track.keyCount = static_cast<std::uint32_t>(kept.size());
+    track.dataOffset = static_cast<std::uint32_t>(m_keyData.size());
+    track.frameOffset = static_cast<std::uint32_t>(m_frames.size());
+
+    // Quantization range over the kept keys
+    if (!rotation) {
+        XMVECTOR minimum = XMLoadFloat4(&samples[kept[0]]);
+        XMVECTOR maximum = minimum;
+        for (std::uint32_t frame : kept) {
+            XMVECTOR value = XMLoadFloat4(&samples[frame]);
+            minimum = XMVectorMin(minimum, value);
+            maximum = XMVectorMax(maximum, value);
+        }
+        XMStoreFloat4(&track.base, minimum);
+        XMStoreFloat3(&track.extent, XMVectorSubtract(maximum, minimum));
+    }
+
+    for (std::uint32_t frame : kept) {
+        EncodeKey(track, kind, samples[frame]);
+        if (sparse) {
+            m_frames.push_back(static_cast<std::uint16_t>(frame));
+        }
+    }
+}
+
+void CompressedAnimation::EncodeKey(const Track& track, TrackKind kind, const XMFLOAT4& value) {
+    if (kind != TrackKind::Rotation) {
+        m_keyData.push_back(Quantize(value.x, track.base.x, track.extent.x, QUANTIZE_16));
+        m_keyData.push_back(Quantize(value.y, track.base.y, track.extent.y, QUANTIZE_16));
+        m_keyData.push_back(Quantize(value.z, track.base.z, track.extent.z, QUANTIZE_16));
+        return;
+    }
+
+    // Smallest three: drop the largest component (recomputed on decode) and
+    // store its index in the top bits of the first two words
+    float components[4] = { value.x, value.y, value.z, value.w };
+    std::uint32_t largest = 0;
+    for (std::uint32_t i = 1; i < 4; i++) {
+        if (std::fabs(components[i]) > std::fabs(components[largest])) {
+            largest = i;
+        }
+    }
+
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    std::uint16_t packed[3];
+    for (std::uint32_t i = 0, j = 0; i < 4; i++) {
+        if (i != largest) {
+            packed[j++] = Quantize(components[i] * sign, -SMALLEST_THREE_RANGE, 2.0f * SMALLEST_THREE_RANGE, QUANTIZE_15);
+        }
+    }
+
+    m_keyData.push_back(static_cast<std::uint16_t>(((largest >> 1) << 15) | packed[0]));
+    m_keyData.push_back(static_cast<std::uint16_t>(((largest & 1) << 15) | packed[1]));
+    m_keyData.push_back(packed[2]);
+}
+
+XMVECTOR CompressedAnimation::DecodeKey(const Track& track, TrackKind kind, std::uint32_t key) const {
+    const std::uint16_t* data = &m_keyData[track.dataOffset + key * 3];
+
+    if (kind != TrackKind::Rotation) {
+        return XMVectorSet(Dequantize(data[0], track.base.x, track.extent.x, QUANTIZE_16),
+                           Dequantize(data[1], track.base.y, track.extent.y, QUANTIZE_16),
+                           Dequantize(data[2], track.base.z, track.extent.z, QUANTIZE_16),
+                           0.0f);
+    }
+
+    std::uint32_t largest = ((data[0] >> 15) << 1) | (data[1] >> 15);
+    float small[3] = {
+        Dequantize(data[0] & 0x7FFF, -SMALLEST_THREE_RANGE, 2.0f * SMALLEST_THREE_RANGE, QUANTIZE_15),
+        Dequantize(data[1] & 0x7FFF, -SMALLEST_THREE_RANGE, 2.0f * SMALLEST_THREE_RANGE, QUANTIZE_15),
+        Dequantize(data[2] & 0x7FFF, -SMALLEST_THREE_RANGE, 2.0f * SMALLEST_THREE_RANGE, QUANTIZE_15)
+    };
+
+    float components[4];
+    float sumSquares = small[0] * small[0] + small[1] * small[1] + small[2] * small[2];
+    for (std::uint32_t i = 0, j = 0; i < 4; i++) {
+        components[i] = (i == largest) ? std::sqrt(std::max(0.0f, 1.0f - sumSquares)) : small[j++];
+    }
+
+    return XMQuaternionNormalize(XMVectorSet(components[0], components[1], components[2], components[3]));
+}
+
+XMVECTOR CompressedAnimation::SampleTrack(const Track& track, TrackKind kind, float frame, std::uint32_t& cursor) const {
+    bool rotation = kind == TrackKind::Rotation;
+
+    switch (track.format) {
+        case TrackFormat::Empty:
+            return rotation ? XMQuaternionIdentity()
+                            : (kind == TrackKind::Scale ? XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f) : XMVectorZero());
+        case TrackFormat::Constant:
+            return XMLoadFloat4(&track.base);
+        default:
+            break;
+    }
+
+    std::uint32_t lastKey = track.keyCount - 1;
+    std::uint32_t key;
+    float t;
+
+    if (track.format == TrackFormat::Dense) {
+        // Times are implied by the fixed rate
+        key = std::min(static_cast<std::uint32_t>(frame), lastKey);
+        t = frame - static_cast<float>(key);
+    }
+    else {
+        const std::uint16_t* frames = &m_frames[track.frameOffset];
+
+        // Resume from the previous key, fall back to a binary search on seeks
+        key = cursor;
+        bool valid = key < lastKey && static_cast<float>(frames[key]) <= frame;
+        size_t steps = 0;
+        while (valid && key + 1 < lastKey && static_cast<float>(frames[key + 1]) <= frame) {
+            if (++steps > MAX_CURSOR_STEPS) {
+                valid = false;
+                break;
+            }
+            key++;
+        }
+
+        if (!valid) {
+            const std::uint16_t* next = std::upper_bound(frames, frames + track.keyCount, static_cast<std::uint16_t>(frame));
+            key = static_cast<std::uint32_t>(std::max<std::ptrdiff_t>(next - frames - 1, 0));
+            key = std::min(key, lastKey);
+        }
+        cursor = key;
+
+        if (key >= lastKey) {
+            t = 0.0f;
+        }
+        else {
+            float start = static_cast<float>(frames[key]);
+            float span = static_cast<float>(frames[key + 1]) - start;
+            t = span > 0.0f ? std::clamp((frame - start) / span, 0.0f, 1.0f) : 0.0f;
+        }
+    }
+
+    XMVECTOR a = DecodeKey(track, kind, key);
+    if (key >= lastKey || t <= 0.0f) {
+        return a;
+    }
+    return InterpolateKeys(a, DecodeKey(track, kind, key + 1), t, rotation);
+}
+
+void CompressedAnimation::SampleChannel(size_t channelIndex, float time, KeyframeCursor& cursor,
+                                        XMFLOAT3& translation, XMFLOAT4& rotation, XMFLOAT3& scale) const {
+    const Channel& channel = m_channels[channelIndex];
+    float frame = std::clamp(time * m_sampleRate, 0.0f, static_cast<float>(m_frameCount > 0 ? m_frameCount - 1 : 0));
+
+    // Tracks without keys leave the caller's value, usually the rest pose
+    if (channel.position.format != TrackFormat::Empty) {
+        XMStoreFloat3(&translation, SampleTrack(channel.position, TrackKind::Position, frame, cursor.position));
+    }
+    if (channel.rotation.format != TrackFormat::Empty) {
+        XMStoreFloat4(&rotation, SampleTrack(channel.rotation, TrackKind::Rotation, frame, cursor.rotation));
+    }
+    if (channel.scale.format != TrackFormat::Empty) {
+        XMStoreFloat3(&scale, SampleTrack(channel.scale, TrackKind::Scale, frame, cursor.scale));
+    }
+}
+
+size_t CompressedAnimation::GetMemoryUsage() const {
+    return sizeof(*this) +
+           m_channels.capacity() * sizeof(Channel) +
+           m_keyData.capacity() * sizeof(std::uint16_t) +
+           m_frames.capacity() * sizeof(std::uint16_t);
+}
+
+} // namespace Animation
+} // namespace GameEngine
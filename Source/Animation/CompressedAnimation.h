@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <DirectXMath.h>
+
+namespace GameEngine {
+namespace Animation {
+
+// Forward declarations
+struct AnimationChannel;
+struct KeyframeCursor;
+
+// Tolerances for the lossy compression pass
+struct AnimationCompressionSettings {
+    float sampleRate = 30.0f;          // Keys per second of the resampled tracks
+    float positionTolerance = 0.001f;  // Max translation error, in model units
+    float rotationTolerance = 0.001f;  // Max rotation error, in radians
+    float scaleTolerance = 0.001f;     // Max scale error per axis
+    float denseThreshold = 0.75f;      // Skip frame indices when reduction keeps more than this fraction
+};
+
+// Compact replacement for an AnimationClip's keyframe vectors. Each track is
+// resampled at a fixed rate, then stored as one of:
+//   Constant: a single value, for tracks that never move beyond tolerance
+//   Dense:    every frame, with times implied by the sample rate
+//   Sparse:   only the frames reduction kept, plus 16-bit frame numbers
+// Positions and scales are quantized to 16 bits per axis over the track's
+// range; rotations use smallest-three encoding in 48 bits. Each encoded track
+// is decoded and checked against the source keys; reduction is tightened
+// until the quantized result holds the tolerance there, or the track is
+// stored dense.
+class CompressedAnimation {
+public:
+    enum class TrackFormat : std::uint8_t {
+        Empty,
+        Constant,
+        Dense,
+        Sparse
+    };
+
+    struct Track {
+        TrackFormat format = TrackFormat::Empty;
+        std::uint32_t keyCount = 0;
+        std::uint32_t dataOffset = 0;   // First key in m_keyData (3 values per key)
+        std::uint32_t frameOffset = 0;  // First frame number in m_frames, sparse only
+        DirectX::XMFLOAT4 base = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f); // Constant value or range minimum
+        DirectX::XMFLOAT3 extent = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);     // Range size, position and scale
+    };
+
+    struct Channel {
+        Track position;
+        Track rotation;
+        Track scale;
+    };
+
+    CompressedAnimation();
+
+    // Compress every channel; the source keyframes can be released afterwards
+    bool Build(const std::vector<AnimationChannel>& channels, float duration,
+               const AnimationCompressionSettings& settings);
+
+    // Decode one channel at time, resuming sparse key searches from cursor.
+    // Outputs whose track has no keys are left unchanged.
+    void SampleChannel(size_t channelIndex, float time, KeyframeCursor& cursor,
+                       DirectX::XMFLOAT3& translation, DirectX::XMFLOAT4& rotation, DirectX::XMFLOAT3& scale) const;
+
+    // Largest decoded error at any source key or resampled frame, over all
+    // tracks of a kind; above the tolerance only when dense storage still misses it
+    float GetMaxPositionError() const { return m_maxErrors[0]; }
+    float GetMaxRotationError() const { return m_maxErrors[1]; }
+    float GetMaxScaleError() const { return m_maxErrors[2]; }
+
+    size_t GetChannelCount() const { return m_channels.size(); }
+    std::uint32_t GetFrameCount() const { return m_frameCount; }
+    size_t GetMemoryUsage() const;
+
+private:
+    enum class TrackKind {
+        Position,
+        Rotation,
+        Scale
+    };
+
+    // Source value the decoded track must reproduce, at a frame position
+    struct ReferenceKey {
+        float frame;
+        DirectX::XMFLOAT4 value;
+    };
+
+    // Encode, then verify against the references; returns the error reached
+    float BuildTrack(Track& track, TrackKind kind, const std::vector<DirectX::XMFLOAT4>& samples,
+                     const std::vector<ReferenceKey>& references, float tolerance,
+                     const AnimationCompressionSettings& settings);
+    void EncodeTrack(Track& track, TrackKind kind, const std::vector<DirectX::XMFLOAT4>& samples,
+                     float tolerance, const AnimationCompressionSettings& settings);
+    float MeasureTrackError(const Track& track, TrackKind kind, const std::vector<DirectX::XMFLOAT4>& samples,
+                            const std::vector<ReferenceKey>& references) const;
+    void EncodeKey(const Track& track, TrackKind kind, const DirectX::XMFLOAT4& value);
+    DirectX::XMVECTOR DecodeKey(const Track& track, TrackKind kind, std::uint32_t key) const;
+    DirectX::XMVECTOR SampleTrack(const Track& track, TrackKind kind, float frame, std::uint32_t& cursor) const;
+
+    std::vector<Channel> m_channels;
+    std::vector<std::uint16_t> m_keyData;
+    std::vector<std::uint16_t> m_frames;
+    float m_sampleRate;
+    std::uint32_t m_frameCount;
+    float m_maxErrors[3];       // Indexed by TrackKind
+};
+
+} // namespace Animation
+} // namespace GameEngine
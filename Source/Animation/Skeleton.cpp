@@ -0,0 +1,109 @@
+#include "Skeleton.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace GameEngine {
+namespace Animation {
+
+bool Skeleton::Build(const std::vector<SkeletonBone>& bones, std::vector<int>* remap) {
+    const int boneCount = static_cast<int>(bones.size());
+    std::vector<int> order;
+    std::vector<int> sortedIndex(bones.size(), INVALID_BONE);
+    std::vector<int> ancestors;
+    order.reserve(bones.size());
+
+    // Each bone goes after its unplaced ancestors, so sorted input keeps its order
+    for (int i = 0; i < boneCount; i++) {
+        ancestors.clear();
+        for (int bone = i; bone != INVALID_BONE && sortedIndex[bone] == INVALID_BONE; bone = bones[bone].parentIndex) {
+            if (bones[bone].parentIndex < INVALID_BONE || bones[bone].parentIndex >= boneCount) {
+                LOG_ERROR("Bone '" << bones[bone].name << "' has an invalid parent index " << bones[bone].parentIndex);
+                return false;
+            }
+            if (ancestors.size() >= bones.size()) {
+                LOG_ERROR("Bone hierarchy above '" << bones[i].name << "' has a cycle");
+                return false;
+            }
+            ancestors.push_back(bone);
+        }
+
+        for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it) {
+            sortedIndex[*it] = static_cast<int>(order.size());
+            order.push_back(*it);
+        }
+    }
+
+    m_names.resize(bones.size());
+    m_parentIndices.resize(bones.size());
+    m_inverseBind.resize(bones.size());
+    m_preTransforms.clear();
+    m_bindPose.Resize(bones.size());
+    m_boneIndices.clear();
+
+    XMMATRIX identity = XMMatrixIdentity();
+    bool hasPreTransforms = std::any_of(bones.begin(), bones.end(), [&](const SkeletonBone& bone) {
+        return !XMMatrixIsIdentity(XMLoadFloat4x4(&bone.preTransform));
+    });
+    if (hasPreTransforms) {
+        m_preTransforms.resize(bones.size(), identity);
+    }
+
+    for (int i = 0; i < boneCount; i++) {
+        const SkeletonBone& bone = bones[order[i]];
+        m_names[i] = bone.name;
+        m_parentIndices[i] = bone.parentIndex == INVALID_BONE ? INVALID_BONE : sortedIndex[bone.parentIndex];
+        m_inverseBind[i] = XMLoadFloat4x4(&bone.inverseBind);
+        if (hasPreTransforms) {
+            m_preTransforms[i] = XMLoadFloat4x4(&bone.preTransform);
+        }
+        m_bindPose.translations[i] = bone.translation;
+        m_bindPose.rotations[i] = bone.rotation;
+        m_bindPose.scales[i] = bone.scale;
+
+        if (!m_boneIndices.emplace(Core::StringId(bone.name), i).second) {
+            LOG_WARNING("Duplicate bone name '" << bone.name << "', channels bind to the first");
+        }
+    }
+
+    if (remap) {
+        *remap = std::move(sortedIndex);
+    }
+    return true;
+}
+
+int Skeleton::FindBone(Core::StringId name) const {
+    auto it = m_boneIndices.find(name);
+    return it != m_boneIndices.end() ? it->second : INVALID_BONE;
+}
+
+void Skeleton::LocalToModel(const XMMATRIX* local, XMMATRIX* model, size_t count) const {
+    size_t boneCount = std::min(count, m_parentIndices.size());
+    for (size_t i = 0; i < boneCount; i++) {
+        XMMATRIX transform = m_preTransforms.empty() ? local[i] : XMMatrixMultiply(local[i], m_preTransforms[i]);
+        int parent = m_parentIndices[i];
+        model[i] = parent == INVALID_BONE ? transform : XMMatrixMultiply(transform, model[parent]);
+    }
+}
+
+void Skeleton::ComputeSkinningMatrices(const LocalPose& pose, XMMATRIX* model, XMMATRIX* skinning, size_t count) const {
+    size_t boneCount = std::min({ count, m_parentIndices.size(), pose.GetBoneCount() });
+    XMVECTOR origin = XMVectorZero();
+
+    // Parents come first, so model[parent] is final by the time a child reads it
+    for (size_t i = 0; i < boneCount; i++) {
+        XMMATRIX local = XMMatrixAffineTransformation(XMLoadFloat3(&pose.scales[i]), origin,
+                                                      XMLoadFloat4(&pose.rotations[i]),
+                                                      XMLoadFloat3(&pose.translations[i]));
+        if (!m_preTransforms.empty()) {
+            local = XMMatrixMultiply(local, m_preTransforms[i]);
+        }
+        int parent = m_parentIndices[i];
+        model[i] = parent == INVALID_BONE ? local : XMMatrixMultiply(local, model[parent]);
+        skinning[i] = XMMatrixMultiply(m_inverseBind[i], model[i]);
+    }
+}
+
+} // namespace Animation
+} // namespace GameEngine
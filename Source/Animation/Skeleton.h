@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <DirectXMath.h>
+#include "AnimationPose.h"
+#include "../Core/StringId.h"
+
+namespace GameEngine {
+namespace Animation {
+
+// One bone as a loader describes it, before sorting
+struct SkeletonBone {
+    std::string name;
+    int parentIndex = -1;                                   // Into the array passed to Build, -1 for roots
+
+    // Bind pose relative to the parent
+    DirectX::XMFLOAT3 translation = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+    DirectX::XMFLOAT4 rotation = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+    DirectX::XMFLOAT3 scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+
+    // Non-bone nodes between the bone and its parent bone (or the model
+    // root), such as an exporter's "Armature" node. Applied after the local
+    // pose, so it survives animation channels replacing the bind pose.
+    DirectX::XMFLOAT4X4 preTransform = DirectX::XMFLOAT4X4(1.0f, 0.0f, 0.0f, 0.0f,
+                                                           0.0f, 1.0f, 0.0f, 0.0f,
+                                                           0.0f, 0.0f, 1.0f, 0.0f,
+                                                           0.0f, 0.0f, 0.0f, 1.0f);
+
+    // Model space to bone space in the bind pose (Assimp's offset matrix)
+    DirectX::XMFLOAT4X4 inverseBind = DirectX::XMFLOAT4X4(1.0f, 0.0f, 0.0f, 0.0f,
+                                                          0.0f, 1.0f, 0.0f, 0.0f,
+                                                          0.0f, 0.0f, 1.0f, 0.0f,
+                                                          0.0f, 0.0f, 0.0f, 1.0f);
+};
+
+// Bone hierarchy shared by the meshes and clips made for it.
+//
+// Bones are stored parents first, so every parent index is lower than its
+// child's and local-to-model is one linear pass over a flat parent-index
+// array, with no recursion and no lookups by name. Names are only resolved
+// at load time: clips bind their channels to bone indices once
+// (AnimationClip::BindToSkeleton) and skinned vertices use the sorted
+// indices Build hands back.
+class Skeleton {
+public:
+    static constexpr int INVALID_BONE = -1;
+
+    Skeleton() = default;
+    ~Skeleton() = default;
+
+    // Sorts the bones parents first, keeping the given order where it
+    // already is. remap, if given, receives the sorted index of each input
+    // bone. Fails on parent cycles and out-of-range parents.
+    bool Build(const std::vector<SkeletonBone>& bones, std::vector<int>* remap = nullptr);
+
+    size_t GetBoneCount() const { return m_parentIndices.size(); }
+    const std::string& GetBoneName(int bone) const { return m_names[bone]; }
+    int GetParentIndex(int bone) const { return m_parentIndices[bone]; }
+    const std::vector<int>& GetParentIndices() const { return m_parentIndices; }
+
+    // Load time only; INVALID_BONE if absent
+    int FindBone(Core::StringId name) const;
+
+    // Local transforms of the bind pose; poses start from it, not identity
+    const LocalPose& GetBindPose() const { return m_bindPose; }
+    const std::vector<DirectX::XMMATRIX>& GetInverseBindMatrices() const { return m_inverseBind; }
+
+    // model[i] = local[i] * preTransform[i] * model[parent[i]], in index order
+    void LocalToModel(const DirectX::XMMATRIX* local, DirectX::XMMATRIX* model, size_t count) const;
+
+    // Composes the pose, resolves the hierarchy and applies the inverse bind
+    // matrices in the same pass: skinning[i] = inverseBind[i] * model[i].
+    // model receives the model-space bone transforms.
+    void ComputeSkinningMatrices(const LocalPose& pose, DirectX::XMMATRIX* model,
+                                 DirectX::XMMATRIX* skinning, size_t count) const;
+
+private:
+    std::vector<std::string> m_names;
+    std::vector<int> m_parentIndices;
+    std::vector<DirectX::XMMATRIX> m_inverseBind;
+    std::vector<DirectX::XMMATRIX> m_preTransforms;    // Empty when every bone's is identity
+    LocalPose m_bindPose;
+    std::unordered_map<Core::StringId, int> m_boneIndices;
+};
+
+} // namespace Animation
+} // namespace GameEngine
@@ -0,0 +1,45 @@
+#include <Windows.h>
+#include <cstdlib>
+#include "BenchmarkRunner.h"
+#include "../Core/Logger.h"
+
+using namespace GameEngine;
+
+// DX11GameEngineBenchmark --scene cubes|skinned|lights|hierarchy [--count n]
+//     [--frames n] [--warmup n] [--width n] [--height n] [--output path]
+// Exits with 0 once the report is written, 1 on bad arguments and -1 when
+// the run could not start or was interrupted.
+
+// Console entry point for compatibility
+int main() {
+    return WinMain(GetModuleHandle(nullptr), nullptr, GetCommandLineA(), SW_SHOWDEFAULT);
+}
+
+// Windows entry point
+int WINAPI WinMain(
+    _In_ HINSTANCE hInstance,
+    _In_opt_ HINSTANCE hPrevInstance,
+    _In_ LPSTR lpCmdLine,
+    _In_ int nCmdShow
+) {
+    // Started before the engine so option errors reach the log
+    Core::Logger::GetInstance().Initialize("benchmark.log", Core::LogLevel::Info);
+
+    Benchmark::BenchmarkOptions options;
+    if (!options.Parse(__argc, __argv)) {
+        Core::Logger::GetInstance().Flush();
+        return 1;
+    }
+
+    Benchmark::BenchmarkRunner runner(options);
+    if (!runner.InitializeManual(hInstance, "DX11 Game Engine Benchmark", options.width, options.height)) {
+        MessageBoxW(nullptr, L"Failed to initialize benchmark", L"Error", MB_ICONERROR);
+        return -1;
+    }
+
+    runner.Run();
+    bool completed = runner.HasCompleted();
+    runner.Shutdown();
+
+    return completed ? 0 : -1;
+}
@@ -0,0 +1,416 @@
+#include "BenchmarkRunner.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Logger.h"
+#include "../Core/Profiler.h"
+#include "../Mesh/Material.h"
+#include "../Renderer/RenderQueue.h"
+#include "../Scene/Entity.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneManager.h"
+#include "../Scene/Transform.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace GameEngine {
+namespace Benchmark {
+
+namespace {
+
+double ToMilliseconds(std::int64_t microseconds) {
+    return static_cast<double>(microseconds) / 1000.0;
+}
+
+// Nearest-rank percentile of sorted values
+double Percentile(const std::vector<double>& sorted, double percentile) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+    return sorted[std::min(std::max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+}
+
+void WriteJsonSummary(std::ostringstream& json, const BenchmarkSummary& summary) {
+    json << "{\"mean\":" << summary.mean << ",\"p50\":" << summary.p50 << ",\"p95\":" << summary.p95
+         << ",\"p99\":" << summary.p99 << ",\"max\":" << summary.max << "}";
+}
+
+void WriteCsvSummary(std::ostringstream& csv, const std::string& metric, const BenchmarkSummary& summary) {
+    csv << metric << "," << summary.mean << "," << summary.p50 << "," << summary.p95 << ","
+        << summary.p99 << "," << summary.max << "\n";
+}
+
+bool ParseUnsigned(const char* text, unsigned int& value) {
+    char* end = nullptr;
+    unsigned long parsed = std::strtoul(text, &end, 10);
+    if (!end || *end != '\0' || end == text) {
+        return false;
+    }
+    value = static_cast<unsigned int>(parsed);
+    return true;
+}
+
+} // namespace
+
+bool BenchmarkOptions::Parse(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (i + 1 >= argc) {
+            LOG_ERROR("Missing value for benchmark option " << argument);
+            return false;
+        }
+        const char* value = argv[++i];
+
+        unsigned int number = 0;
+        bool valid = true;
+        if (argument == "--scene") {
+            valid = ParseScenario(value, scenario);
+        }
+        else if (argument == "--count") {
+            valid = ParseUnsigned(value, count);
+        }
+        else if (argument == "--frames") {
+            valid = ParseUnsigned(value, frames) && frames > 0;
+        }
+        else if (argument == "--warmup") {
+            valid = ParseUnsigned(value, warmupFrames);
+        }
+        else if (argument == "--width") {
+            valid = ParseUnsigned(value, number) && number > 0;
+            width = static_cast<int>(number);
+        }
+        else if (argument == "--height") {
+            valid = ParseUnsigned(value, number) && number > 0;
+            height = static_cast<int>(number);
+        }
+        else if (argument == "--output") {
+            outputPath = value;
+        }
+        else {
+            LOG_ERROR("Unknown benchmark option " << argument);
+            return false;
+        }
+
+        if (!valid) {
+            LOG_ERROR("Invalid value for benchmark option " << argument << ": " << value);
+            return false;
+        }
+    }
+
+    if (count == 0) {
+        count = GetDefaultCount(scenario);
+    }
+    if (outputPath.empty()) {
+        outputPath = FILE_SYSTEM.CombinePaths("Benchmarks", GetScenarioName(scenario));
+    }
+    return true;
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options)
+    : m_options(options)
+    , m_frameIndex(0)
+    , m_completed(false)
+    , m_previousVSync(false)
+    , m_previousMaxFPS(0)
+{
+}
+
+bool BenchmarkRunner::OnInitialize() {
+    auto& renderer = GetRenderer();
+
+    // Uncapped, so the numbers show the frame cost rather than the display
+    // rate; the frame limiter would otherwise still sleep to maxFPS
+    m_previousVSync = renderer.GetVSync();
+    m_previousMaxFPS = renderer.GetMaxFPS();
+    renderer.SetVSync(false);
+    renderer.SetMaxFPS(0);
+
+    BenchmarkMaterials materials;
+    if (!LoadShaders(materials)) {
+        return false;
+    }
+
+    m_scene = SCENE_MANAGER.CreateScene("Benchmark");
+    if (!m_scene) {
+        return false;
+    }
+    SCENE_MANAGER.SetActiveScene(m_scene);
+
+    // Shadow casters batch and skin the same way as the main pass
+    for (Renderer::RenderQueue* queue : { &m_scene->GetRenderQueue(), &m_scene->GetShadowQueue() }) {
+        if (m_instancedShader) {
+            queue->SetInstancingShader(m_instancedShader, m_instancedLayouts);
+        }
+        if (m_skinnedInstancedShader) {
+            queue->SetSkinningShader(m_skinnedInstancedShader, m_skinnedInstancedLayouts);
+        }
+        if (m_skinnedShader) {
+            queue->SetSkinningFallbackShader(m_skinnedShader, m_skinnedLayouts);
+        }
+    }
+
+    if (!BuildBenchmarkScene(m_options.scenario, m_options.count, *m_scene, renderer, materials, m_sceneInfo)) {
+        LOG_ERROR("Failed to build benchmark scene " << GetScenarioName(m_options.scenario));
+        return false;
+    }
+
+    m_samples.reserve(m_options.frames);
+    UpdateCamera();
+
+    LOG_INFO("Benchmark " << GetScenarioName(m_options.scenario) << " x" << m_options.count << ": "
+             << m_options.warmupFrames << " warmup + " << m_options.frames << " measured frames");
+    return true;
+}
+
+bool BenchmarkRunner::LoadShaders(BenchmarkMaterials& materials) {
+    auto& renderer = GetRenderer();
+
+    if (!renderer.LoadVertexShader(L"Shaders/VertexShader.hlsl", m_vertexShader, m_inputLayouts, Mesh::StaticVertexLayouts)) {
+        LOG_ERROR("Failed to load benchmark vertex shader");
+        return false;
+    }
+
+    // Lit shader first; the point light scenario means little without it
+    if (!renderer.LoadPixelShader(L"Shaders/PixelShader.hlsl.txt", m_pixelShader)) {
+        LOG_WARNING("Failed to load PixelShader.hlsl.txt, trying SimplePixelShader.hlsl.txt");
+        if (!renderer.LoadPixelShader(L"Shaders/SimplePixelShader.hlsl.txt", m_pixelShader)) {
+            LOG_ERROR("Failed to load benchmark pixel shader");
+            return false;
+        }
+    }
+
+    // Optional paths; without them the scene falls back to per-object draws
+    if (!renderer.LoadVertexShader(L"Shaders/InstancedVertexShader.hlsl", m_instancedShader, m_instancedLayouts,
+                                   Mesh::InstancedVertexLayouts)) {
+        LOG_WARNING("Instancing shader unavailable, benchmark draws without instancing");
+    }
+    if (!renderer.LoadVertexShader(L"Shaders/SkinnedInstancedVertexShader.hlsl", m_skinnedInstancedShader,
+                                   m_skinnedInstancedLayouts, Mesh::SkinnedInstancedVertexLayouts)) {
+        LOG_WARNING("Instanced skinning shader unavailable");
+    }
+    if (!renderer.LoadVertexShader(L"Shaders/SkinnedVertexShader.hlsl.txt", m_skinnedShader, m_skinnedLayouts,
+                                   Mesh::SkinnedVertexLayouts)) {
+        LOG_WARNING("Skinning shader unavailable");
+    }
+
+    materials.staticMaterial = std::make_shared<Mesh::Material>("BenchmarkStatic");
+    materials.staticMaterial->SetDiffuse(DirectX::XMFLOAT3(0.7f, 0.7f, 0.75f));
+    materials.staticMaterial->SetShaders(m_vertexShader, m_inputLayouts, m_pixelShader);
+
+    if (m_skinnedShader) {
+        materials.skinnedMaterial = std::make_shared<Mesh::Material>("BenchmarkSkinned");
+        materials.skinnedMaterial->SetDiffuse(DirectX::XMFLOAT3(0.8f, 0.6f, 0.5f));
+        materials.skinnedMaterial->SetShaders(m_skinnedShader, m_skinnedLayouts, m_pixelShader);
+    }
+    return true;
+}
+
+void BenchmarkRunner::OnUpdate(float deltaTime) {
+    RecordPreviousFrame(deltaTime);
+    if (m_completed) {
+        return;
+    }
+
+    // Deep hierarchy: turning the roots dirties every chain below them
+    float angle = static_cast<float>(m_frameIndex) * 2.0f;
+    for (Scene::Entity* root : m_sceneInfo.animatedRoots) {
+        root->GetTransform()->SetLocalRotation(0.0f, angle, 0.0f);
+    }
+
+    UpdateCamera();
+
+    std::int64_t begin = Core::Profiler::Now();
+    SCENE_MANAGER.Update(SIMULATION_STEP);
+    m_current = FrameSample();
+    m_current.sceneUpdateMilliseconds = ToMilliseconds(Core::Profiler::Now() - begin);
+}
+
+void BenchmarkRunner::OnRender() {
+    if (m_completed) {
+        return;
+    }
+
+    std::int64_t begin = Core::Profiler::Now();
+    SCENE_MANAGER.Render(&GetRenderer());
+    m_current.sceneRenderMilliseconds = ToMilliseconds(Core::Profiler::Now() - begin);
+    m_frameIndex++;
+}
+
+void BenchmarkRunner::OnShutdown() {
+    if (!m_completed) {
+        LOG_WARNING("Benchmark stopped after " << m_samples.size() << " of " << m_options.frames << " frames, no report written");
+    }
+    SCENE_MANAGER.UnloadAllScenes();
+    m_scene.reset();
+
+    auto& renderer = GetRenderer();
+    renderer.SetVSync(m_previousVSync);
+    renderer.SetMaxFPS(m_previousMaxFPS);
+}
+
+void BenchmarkRunner::OnKeyboard(int key, bool isDown) {
+    // Debug keys would change the workload mid-run; only exit is honoured
+    if (isDown && key == CONFIG_MANAGER.GetKeyBinding("Exit", VK_ESCAPE)) {
+        SetRunning(false);
+    }
+}
+
+void BenchmarkRunner::UpdateCamera() {
+    // One orbit across the measured frames; warmup holds the starting view
+    unsigned int measured = m_frameIndex > m_options.warmupFrames ? m_frameIndex - m_options.warmupFrames : 0;
+    float angle = DirectX::XM_2PI * static_cast<float>(measured) / static_cast<float>(m_options.frames);
+    float height = m_sceneInfo.height + std::sin(angle * 2.0f) * m_sceneInfo.height * 0.25f;
+
+    SetCameraPosition(Math::Vector3(std::cos(angle) * m_sceneInfo.radius, height, std::sin(angle) * m_sceneInfo.radius));
+    SetCameraTarget(Math::Vector3(0.0f, 0.0f, 0.0f));
+}
+
+void BenchmarkRunner::RecordPreviousFrame(float deltaTime) {
+    // Profiler and renderer stats describe the frame that just ended
+    if (m_frameIndex <= m_options.warmupFrames || m_completed) {
+        return;
+    }
+
+    const Core::ProfileFrameStats& profile = PROFILER.GetFrameStats();
+    const Renderer::RenderFrameStats& render = GetRenderer().GetLastFrameStats();
+
+    FrameSample sample = m_current;
+    sample.frameMilliseconds = static_cast<double>(deltaTime) * 1000.0;
+    sample.cpuMilliseconds = profile.cpuMilliseconds;
+    sample.gpuMilliseconds = profile.gpuMilliseconds;
+    sample.drawCalls = render.drawCalls;
+    sample.trianglesDrawn = render.trianglesDrawn;
+    sample.stateChanges = render.stateChanges;
+    sample.bufferMaps = render.bufferMaps;
+    m_samples.push_back(sample);
+
+    for (const Core::ProfileScopeTotal& scope : profile.cpuScopes) {
+        m_scopeSamples[std::string("cpu/") + (scope.name ? scope.name : "Unnamed")].push_back(scope.milliseconds);
+    }
+    for (const Core::ProfileScopeTotal& scope : profile.gpuScopes) {
+        m_scopeSamples[std::string("gpu/") + (scope.name ? scope.name : "Unnamed")].push_back(scope.milliseconds);
+    }
+
+    if (m_samples.size() >= m_options.frames) {
+        m_completed = true;
+        WriteReport();
+        SetRunning(false);
+    }
+}
+
+BenchmarkSummary BenchmarkRunner::Summarize(std::vector<double> values) {
+    BenchmarkSummary summary;
+    if (values.empty()) {
+        return summary;
+    }
+
+    std::sort(values.begin(), values.end());
+    double total = 0.0;
+    for (double value : values) {
+        total += value;
+    }
+    summary.mean = total / values.size();
+    summary.p50 = Percentile(values, 50.0);
+    summary.p95 = Percentile(values, 95.0);
+    summary.p99 = Percentile(values, 99.0);
+    summary.max = values.back();
+    return summary;
+}
+
+bool BenchmarkRunner::WriteReport() const {
+    std::vector<double> frameTimes, cpuTimes, gpuTimes, updateTimes, renderTimes, drawCalls, triangles, stateChanges, bufferMaps;
+    for (const FrameSample& sample : m_samples) {
+        frameTimes.push_back(sample.frameMilliseconds);
+        cpuTimes.push_back(sample.cpuMilliseconds);
+        gpuTimes.push_back(sample.gpuMilliseconds);
+        updateTimes.push_back(sample.sceneUpdateMilliseconds);
+        renderTimes.push_back(sample.sceneRenderMilliseconds);
+        drawCalls.push_back(sample.drawCalls);
+        triangles.push_back(static_cast<double>(sample.trianglesDrawn));
+        stateChanges.push_back(sample.stateChanges);
+        bufferMaps.push_back(sample.bufferMaps);
+    }
+
+    struct Metric {
+        std::string name;
+        BenchmarkSummary summary;
+    };
+    std::vector<Metric> metrics = {
+        { "frame_ms", Summarize(frameTimes) },
+        { "cpu_ms", Summarize(cpuTimes) },
+        { "gpu_ms", Summarize(gpuTimes) },
+        { "scene_update_ms", Summarize(updateTimes) },
+        { "scene_render_ms", Summarize(renderTimes) },
+        { "draw_calls", Summarize(drawCalls) },
+        { "triangles", Summarize(triangles) },
+        { "state_changes", Summarize(stateChanges) },
+        { "buffer_maps", Summarize(bufferMaps) }
+    };
+    std::vector<Metric> scopes;
+    for (const auto& entry : m_scopeSamples) {
+        scopes.push_back({ entry.first, Summarize(entry.second) });
+    }
+
+    std::string directory = FILE_SYSTEM.GetDirectoryPath(m_options.outputPath);
+    if (!directory.empty()) {
+        FILE_SYSTEM.CreateDirectories(directory);
+    }
+
+    // Summary: one object per metric, scopes keyed by "cpu/Name" and "gpu/Name"
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4);
+    json << "{\"scenario\":\"" << GetScenarioName(m_options.scenario) << "\",\"count\":" << m_options.count
+         << ",\"frames\":" << m_samples.size() << ",\"warmupFrames\":" << m_options.warmupFrames
+         << ",\"width\":" << GetRenderer().GetWidth() << ",\"height\":" << GetRenderer().GetHeight()
+         << ",\"entities\":" << (m_scene ? m_scene->GetEntityCount() : 0) << ",\n\"metrics\":{";
+    for (size_t i = 0; i < metrics.size(); i++) {
+        json << (i > 0 ? ",\n" : "\n") << "\"" << metrics[i].name << "\":";
+        WriteJsonSummary(json, metrics[i].summary);
+    }
+    json << "\n},\n\"scopes\":{";
+    for (size_t i = 0; i < scopes.size(); i++) {
+        json << (i > 0 ? ",\n" : "\n") << "\"" << scopes[i].name << "\":";
+        WriteJsonSummary(json, scopes[i].summary);
+    }
+    json << "\n}}\n";
+
+    std::ostringstream csv;
+    csv << std::fixed << std::setprecision(4);
+    csv << "metric,mean,p50,p95,p99,max\n";
+    for (const Metric& metric : metrics) {
+        WriteCsvSummary(csv, metric.name, metric.summary);
+    }
+    for (const Metric& scope : scopes) {
+        WriteCsvSummary(csv, scope.name, scope.summary);
+    }
+
+    // Raw samples for plotting and for comparing runs frame by frame
+    std::ostringstream frames;
+    frames << std::fixed << std::setprecision(4);
+    frames << "frame,frame_ms,cpu_ms,gpu_ms,scene_update_ms,scene_render_ms,draw_calls,triangles,state_changes,buffer_maps\n";
+    for (size_t i = 0; i < m_samples.size(); i++) {
+        const FrameSample& sample = m_samples[i];
+        frames << i << "," << sample.frameMilliseconds << "," << sample.cpuMilliseconds << "," << sample.gpuMilliseconds << ","
+               << sample.sceneUpdateMilliseconds << "," << sample.sceneRenderMilliseconds << "," << sample.drawCalls << ","
+               << sample.trianglesDrawn << "," << sample.stateChanges << "," << sample.bufferMaps << "\n";
+    }
+
+    bool written = FILE_SYSTEM.WriteTextFile(m_options.outputPath + ".json", json.str())
+        && FILE_SYSTEM.WriteTextFile(m_options.outputPath + ".csv", csv.str())
+        && FILE_SYSTEM.WriteTextFile(m_options.outputPath + "_frames.csv", frames.str());
+    if (!written) {
+        LOG_ERROR("Failed to write benchmark report: " << m_options.outputPath);
+        return false;
+    }
+
+    const BenchmarkSummary& frame = metrics[0].summary;
+    LOG_INFO("Benchmark " << GetScenarioName(m_options.scenario) << " x" << m_options.count << ": frame p50 "
+             << frame.p50 << " ms, p95 " << frame.p95 << " ms, p99 " << frame.p99 << " ms; report "
+             << m_options.outputPath << ".json");
+    return true;
+}
+
+} // namespace Benchmark
+} // namespace GameEngine
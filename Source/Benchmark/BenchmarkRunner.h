@@ -0,0 +1,108 @@
+#pragma once
+
+#include "BenchmarkScenes.h"
+#include "../Core/Engine.h"
+#include "../Mesh/Vertex.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GameEngine {
+namespace Scene { class Scene; }
+
+namespace Benchmark {
+
+struct BenchmarkOptions {
+    BenchmarkScenario scenario = BenchmarkScenario::Cubes;
+    unsigned int count = 0;             // 0 uses the scenario's default
+    unsigned int frames = 1000;         // Measured frames, one camera orbit
+    unsigned int warmupFrames = 120;    // Rendered but not measured
+    int width = 1280;
+    int height = 720;
+    std::string outputPath;             // Report files are <outputPath>.json/.csv; empty uses Benchmarks/<scenario>
+
+    // --scene name --count n --frames n --warmup n --width n --height n --output path
+    bool Parse(int argc, char** argv);
+};
+
+// Mean and percentiles of one metric over the measured frames
+struct BenchmarkSummary {
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Runs one scripted scenario for a fixed number of frames and writes a report.
+//
+// Simulation steps by a constant delta and the camera follows an orbit keyed
+// to the frame index, so every run does the same work and only the timings
+// differ. Frame times come from the engine timer (the full frame, including
+// waits), CPU and GPU times and top-level scopes from the profiler, and
+// counters from the renderer's frame stats.
+class BenchmarkRunner : public Core::Engine {
+public:
+    explicit BenchmarkRunner(const BenchmarkOptions& options);
+
+    const BenchmarkOptions& GetOptions() const { return m_options; }
+    bool HasCompleted() const { return m_completed; }
+
+protected:
+    bool OnInitialize() override;
+    void OnUpdate(float deltaTime) override;
+    void OnRender() override;
+    void OnShutdown() override;
+    void OnKeyboard(int key, bool isDown) override;
+
+private:
+    struct FrameSample {
+        double frameMilliseconds = 0.0;
+        double cpuMilliseconds = 0.0;
+        double gpuMilliseconds = 0.0;
+        double sceneUpdateMilliseconds = 0.0;
+        double sceneRenderMilliseconds = 0.0;
+        UINT drawCalls = 0;
+        std::uint64_t trianglesDrawn = 0;
+        UINT stateChanges = 0;
+        UINT bufferMaps = 0;
+    };
+
+    bool LoadShaders(BenchmarkMaterials& materials);
+    void UpdateCamera();
+    void RecordPreviousFrame(float deltaTime);
+    bool WriteReport() const;
+
+    static BenchmarkSummary Summarize(std::vector<double> values);
+
+    BenchmarkOptions m_options;
+    BenchmarkSceneInfo m_sceneInfo;
+    std::shared_ptr<Scene::Scene> m_scene;
+
+    // Fixed step for scene updates, independent of the measured frame time
+    static constexpr float SIMULATION_STEP = 1.0f / 60.0f;
+
+    unsigned int m_frameIndex;
+    bool m_completed;
+    bool m_previousVSync;           // Pacing restored on shutdown
+    int m_previousMaxFPS;
+    FrameSample m_current;          // Filled during a frame, stored once its timings resolve
+    std::vector<FrameSample> m_samples;
+    std::map<std::string, std::vector<double>> m_scopeSamples;   // "cpu/Name" and "gpu/Name"
+
+    // Shaders shared by all benchmark materials
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_vertexShader;
+    Mesh::VertexInputLayouts m_inputLayouts;
+    Microsoft::WRL::ComPtr<ID3D11PixelShader> m_pixelShader;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_skinnedShader;
+    Mesh::VertexInputLayouts m_skinnedLayouts;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_instancedShader;
+    Mesh::VertexInputLayouts m_instancedLayouts;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_skinnedInstancedShader;
+    Mesh::VertexInputLayouts m_skinnedInstancedLayouts;
+};
+
+} // namespace Benchmark
+} // namespace GameEngine
@@ -0,0 +1,319 @@
+#include "BenchmarkScenes.h"
+#include "../Animation/AnimationClip.h"
+#include "../Animation/AnimationController.h"
+#include "../Animation/Skeleton.h"
+#include "../Core/Logger.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshManager.h"
+#include "../Renderer/D3D11Renderer.h"
+#include "../Renderer/Light.h"
+#include "../Scene/Entity.h"
+#include "../Scene/MeshRenderer.h"
+#include "../Scene/Scene.h"
+#include "../Scene/Transform.h"
+#include <algorithm>
+#include <cmath>
+
+namespace GameEngine {
+namespace Benchmark {
+
+namespace {
+
+const char* const SCENARIO_NAMES[static_cast<int>(BenchmarkScenario::Count)] = {
+    "cubes",
+    "skinned",
+    "lights",
+    "hierarchy"
+};
+
+const unsigned int DEFAULT_COUNTS[static_cast<int>(BenchmarkScenario::Count)] = {
+    10000,
+    500,
+    256,
+    8192
+};
+
+constexpr float CUBE_SPACING = 2.0f;
+constexpr float CHARACTER_SPACING = 2.5f;
+constexpr unsigned int LIGHT_FIELD_CUBES = 1024;    // Lit by the point light scenario
+constexpr unsigned int HIERARCHY_DEPTH = 32;
+
+// Procedural character: a column of bones, each skinned to a ring segment
+constexpr unsigned int CHARACTER_BONES = 4;
+constexpr unsigned int RINGS_PER_BONE = 4;
+constexpr unsigned int RING_SIDES = 8;
+constexpr float BONE_LENGTH = 0.5f;
+constexpr float CHARACTER_RADIUS = 0.25f;
+
+// Centered square grid position of one of count items
+DirectX::XMFLOAT3 GetGridPosition(unsigned int index, unsigned int count, float spacing) {
+    unsigned int side = std::max(1u, static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(count)))));
+    float offset = (side - 1) * spacing * 0.5f;
+    return DirectX::XMFLOAT3((index % side) * spacing - offset, 0.0f, (index / side) * spacing - offset);
+}
+
+float GetGridRadius(unsigned int count, float spacing) {
+    return std::ceil(std::sqrt(static_cast<float>(std::max(count, 1u)))) * spacing * 0.5f;
+}
+
+Scene::Entity* CreateMeshEntity(Scene::Scene& scene, const std::string& name, std::shared_ptr<Mesh::Mesh> mesh,
+                                const BenchmarkMaterials& materials, bool isStatic) {
+    Scene::Entity* entity = scene.CreateEntity(name);
+    Scene::MeshRenderer* renderer = entity->AddComponent<Scene::MeshRenderer>();
+    renderer->SetMesh(mesh);
+    renderer->SetMaterial(materials.staticMaterial);
+    renderer->SetStatic(isStatic);
+    return entity;
+}
+
+void BuildCubeField(unsigned int count, Scene::Scene& scene, const BenchmarkMaterials& materials) {
+    std::shared_ptr<Mesh::Mesh> cube = MESH_MANAGER.GetCube(1.0f);
+    for (unsigned int i = 0; i < count; i++) {
+        Scene::Entity* entity = CreateMeshEntity(scene, "Cube", cube, materials, true);
+        DirectX::XMFLOAT3 position = GetGridPosition(i, count, CUBE_SPACING);
+        entity->GetTransform()->SetLocalPosition(position.x, 0.5f, position.z);
+    }
+}
+
+std::shared_ptr<Mesh::Mesh> CreateCharacterMesh(Renderer::D3D11Renderer& renderer) {
+    std::vector<Mesh::SkinnedVertex> vertices;
+    std::vector<UINT> indices;
+    const unsigned int levels = CHARACTER_BONES * RINGS_PER_BONE + 1;
+    const float levelHeight = BONE_LENGTH / RINGS_PER_BONE;
+
+    for (unsigned int level = 0; level < levels; level++) {
+        // Blend between the two nearest bones so the joints bend smoothly
+        float bonePosition = std::max(static_cast<float>(level) / RINGS_PER_BONE - 0.5f, 0.0f);
+        unsigned int bone = std::min(static_cast<unsigned int>(bonePosition), CHARACTER_BONES - 1);
+        unsigned int nextBone = std::min(bone + 1, CHARACTER_BONES - 1);
+        float blend = nextBone != bone ? bonePosition - bone : 0.0f;
+
+        for (unsigned int side = 0; side < RING_SIDES; side++) {
+            float angle = DirectX::XM_2PI * side / RING_SIDES;
+            DirectX::XMFLOAT3 normal(std::cos(angle), 0.0f, std::sin(angle));
+            Mesh::SkinnedVertex vertex(
+                DirectX::XMFLOAT3(normal.x * CHARACTER_RADIUS, level * levelHeight, normal.z * CHARACTER_RADIUS),
+                normal, DirectX::XMFLOAT2(static_cast<float>(side) / RING_SIDES, static_cast<float>(level) / (levels - 1)));
+            vertex.AddBoneData(bone, 1.0f - blend);
+            if (blend > 0.0f) {
+                vertex.AddBoneData(nextBone, blend);
+            }
+            vertices.push_back(vertex);
+        }
+    }
+
+    for (unsigned int level = 0; level + 1 < levels; level++) {
+        for (unsigned int side = 0; side < RING_SIDES; side++) {
+            UINT a = level * RING_SIDES + side;
+            UINT b = level * RING_SIDES + (side + 1) % RING_SIDES;
+            UINT c = a + RING_SIDES;
+            UINT d = b + RING_SIDES;
+            indices.insert(indices.end(), { a, c, b, b, c, d });
+        }
+    }
+
+    auto mesh = std::make_shared<Mesh::Mesh>("BenchmarkCharacter");
+    if (!mesh->CreateFromSkinnedData(vertices, indices, &renderer)) {
+        return nullptr;
+    }
+    return mesh;
+}
+
+// Chain of bones up the column, each jointed where the previous one ends
+std::shared_ptr<Animation::Skeleton> CreateCharacterSkeleton() {
+    std::vector<Animation::SkeletonBone> bones(CHARACTER_BONES);
+    for (unsigned int bone = 0; bone < CHARACTER_BONES; bone++) {
+        bones[bone].name = "Bone" + std::to_string(bone);
+        bones[bone].parentIndex = static_cast<int>(bone) - 1;
+        bones[bone].translation.y = bone > 0 ? BONE_LENGTH : 0.0f;
+        DirectX::XMStoreFloat4x4(&bones[bone].inverseBind, DirectX::XMMatrixTranslation(0.0f, -(bone * BONE_LENGTH), 0.0f));
+    }
+
+    auto skeleton = std::make_shared<Animation::Skeleton>();
+    return skeleton->Build(bones) ? skeleton : nullptr;
+}
+
+// Every bone sways around Z, alternating direction up the column
+std::shared_ptr<Animation::AnimationClip> CreateSwayClip() {
+    auto clip = std::make_shared<Animation::AnimationClip>("Sway");
+    clip->SetDuration(1.0f);
+    clip->SetTicksPerSecond(1.0f);
+
+    for (unsigned int bone = 0; bone < CHARACTER_BONES; bone++) {
+        float angle = DirectX::XMConvertToRadians(bone % 2 == 0 ? 20.0f : -20.0f);
+        Animation::AnimationChannel channel;
+        channel.boneName = "Bone" + std::to_string(bone);
+        channel.boneIndex = static_cast<int>(bone);
+        for (int key = 0; key <= 4; key++) {
+            float time = key * 0.25f;
+            float keyAngle = key == 1 ? angle : (key == 3 ? -angle : 0.0f);
+            DirectX::XMFLOAT4 rotation;
+            DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionRotationRollPitchYaw(0.0f, 0.0f, keyAngle));
+            channel.rotationKeys.push_back(Animation::RotationKeyframe(time, rotation));
+        }
+        clip->AddChannel(channel);
+    }
+    return clip;
+}
+
+bool BuildCharacters(unsigned int count, Scene::Scene& scene, Renderer::D3D11Renderer& renderer,
+                     const BenchmarkMaterials& materials) {
+    std::shared_ptr<Mesh::Mesh> mesh = CreateCharacterMesh(renderer);
+    if (!mesh) {
+        LOG_ERROR("Failed to create benchmark character mesh");
+        return false;
+    }
+    std::shared_ptr<Animation::Skeleton> skeleton = CreateCharacterSkeleton();
+    std::shared_ptr<Animation::AnimationClip> clip = CreateSwayClip();
+    if (skeleton) {
+        mesh->SetSkeleton(skeleton);
+        clip->BindToSkeleton(*skeleton);
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        Scene::Entity* entity = scene.CreateEntity("Character");
+        DirectX::XMFLOAT3 position = GetGridPosition(i, count, CHARACTER_SPACING);
+        entity->GetTransform()->SetLocalPosition(position);
+
+        Scene::MeshRenderer* meshRenderer = entity->AddComponent<Scene::MeshRenderer>();
+        meshRenderer->SetMesh(mesh);
+        meshRenderer->SetMaterial(materials.skinnedMaterial ? materials.skinnedMaterial : materials.staticMaterial);
+
+        // Varied speeds keep the characters out of phase
+        Animation::AnimationController* animator = entity->AddComponent<Animation::AnimationController>();
+        animator->SetBoneCount(CHARACTER_BONES);
+        animator->SetSkeleton(skeleton);
+        animator->AddAnimationClip("Sway", clip);
+        animator->Play("Sway", true, 0.8f + (i % 5) * 0.1f);
+    }
+    return true;
+}
+
+void BuildLights(unsigned int count, Scene::Scene& scene, Renderer::D3D11Renderer& renderer,
+                 const BenchmarkMaterials& materials) {
+    BuildCubeField(LIGHT_FIELD_CUBES, scene, materials);
+
+    std::shared_ptr<Mesh::Mesh> ground = MESH_MANAGER.GetPlane(1.0f, 1.0f);
+    float fieldSize = GetGridRadius(LIGHT_FIELD_CUBES, CUBE_SPACING) * 2.0f;
+    Scene::Entity* groundEntity = CreateMeshEntity(scene, "Ground", ground, materials, true);
+    groundEntity->GetTransform()->SetLocalScale(fieldSize, 1.0f, fieldSize);
+
+    // Lights sit between the cubes at two heights; no shadows, so the cost is culling and shading
+    auto& lightManager = renderer.GetLightManager();
+    float lightSpacing = fieldSize / std::ceil(std::sqrt(static_cast<float>(std::max(count, 1u))));
+    for (unsigned int i = 0; i < count; i++) {
+        DirectX::XMFLOAT3 position = GetGridPosition(i, count, lightSpacing);
+        auto light = std::make_shared<Renderer::PointLight>();
+        light->SetPosition(position.x, i % 2 == 0 ? 1.5f : 3.0f, position.z);
+        light->SetColor(0.3f + (i % 3) * 0.35f, 0.3f + ((i / 3) % 3) * 0.35f, 0.3f + ((i / 9) % 3) * 0.35f);
+        light->SetIntensity(1.5f);
+        light->SetRange(lightSpacing * 1.5f);
+        light->SetCastShadows(false);
+        lightManager.AddLight(light);
+    }
+}
+
+void BuildHierarchy(unsigned int count, Scene::Scene& scene, const BenchmarkMaterials& materials,
+                    BenchmarkSceneInfo& info) {
+    std::shared_ptr<Mesh::Mesh> cube = MESH_MANAGER.GetCube(0.4f);
+    unsigned int chains = std::max(1u, (count + HIERARCHY_DEPTH - 1) / HIERARCHY_DEPTH);
+
+    unsigned int created = 0;
+    for (unsigned int chain = 0; chain < chains && created < count; chain++) {
+        Scene::Entity* parent = nullptr;
+        for (unsigned int depth = 0; depth < HIERARCHY_DEPTH && created < count; depth++, created++) {
+            Scene::Entity* entity = CreateMeshEntity(scene, "Node", cube, materials, false);
+            Scene::Transform* transform = entity->GetTransform();
+            if (parent) {
+                // A small offset and twist per level makes each chain a helix
+                entity->SetParent(parent);
+                transform->SetLocalPosition(0.0f, 0.5f, 0.15f);
+                transform->SetLocalRotation(0.0f, 11.25f, 0.0f);
+            }
+            else {
+                DirectX::XMFLOAT3 position = GetGridPosition(chain, chains, CUBE_SPACING * 2.0f);
+                transform->SetLocalPosition(position);
+                info.animatedRoots.push_back(entity);
+            }
+            parent = entity;
+        }
+    }
+}
+
+} // namespace
+
+const char* GetScenarioName(BenchmarkScenario scenario) {
+    int index = static_cast<int>(scenario);
+    return index >= 0 && index < static_cast<int>(BenchmarkScenario::Count) ? SCENARIO_NAMES[index] : "unknown";
+}
+
+bool ParseScenario(const std::string& name, BenchmarkScenario& scenario) {
+    for (int i = 0; i < static_cast<int>(BenchmarkScenario::Count); i++) {
+        if (name == SCENARIO_NAMES[i]) {
+            scenario = static_cast<BenchmarkScenario>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned int GetDefaultCount(BenchmarkScenario scenario) {
+    int index = static_cast<int>(scenario);
+    return index >= 0 && index < static_cast<int>(BenchmarkScenario::Count) ? DEFAULT_COUNTS[index] : 0;
+}
+
+bool BuildBenchmarkScene(BenchmarkScenario scenario, unsigned int count, Scene::Scene& scene,
+                         Renderer::D3D11Renderer& renderer, const BenchmarkMaterials& materials,
+                         BenchmarkSceneInfo& info) {
+    info = BenchmarkSceneInfo();
+
+    // A sun so every scenario is lit the same way
+    auto sun = std::make_shared<Renderer::DirectionalLight>();
+    sun->SetDirection(DirectX::XMFLOAT3(0.5f, -1.0f, 0.3f));
+    sun->SetColor(1.0f, 0.95f, 0.8f);
+    sun->SetIntensity(scenario == BenchmarkScenario::PointLights ? 0.2f : 1.0f);
+    sun->SetCastShadows(false);
+    renderer.GetLightManager().AddLight(sun);
+
+    switch (scenario) {
+    case BenchmarkScenario::Cubes:
+        BuildCubeField(count, scene, materials);
+        info.radius = GetGridRadius(count, CUBE_SPACING) * 1.2f + 5.0f;
+        info.height = info.radius * 0.5f;
+        break;
+
+    case BenchmarkScenario::SkinnedCharacters:
+        if (!BuildCharacters(count, scene, renderer, materials)) {
+            return false;
+        }
+        info.radius = GetGridRadius(count, CHARACTER_SPACING) * 1.2f + 5.0f;
+        info.height = info.radius * 0.4f;
+        break;
+
+    case BenchmarkScenario::PointLights:
+        BuildLights(count, scene, renderer, materials);
+        info.radius = GetGridRadius(LIGHT_FIELD_CUBES, CUBE_SPACING) * 1.2f + 5.0f;
+        info.height = info.radius * 0.5f;
+        break;
+
+    case BenchmarkScenario::DeepHierarchy:
+        BuildHierarchy(count, scene, materials, info);
+        info.radius = GetGridRadius(static_cast<unsigned int>(info.animatedRoots.size()), CUBE_SPACING * 2.0f) * 1.2f + 10.0f;
+        info.height = HIERARCHY_DEPTH * 0.5f;
+        break;
+
+    default:
+        LOG_ERROR("Unknown benchmark scenario");
+        return false;
+    }
+
+    // Static geometry takes the batching path it would in a game
+    scene.BuildStaticBatches(&renderer);
+
+    LOG_INFO("Benchmark scene '" << GetScenarioName(scenario) << "': " << scene.GetEntityCount() << " entities, "
+             << renderer.GetLightManager().GetLightCount() << " lights");
+    return true;
+}
+
+} // namespace Benchmark
+} // namespace GameEngine
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer { class D3D11Renderer; }
+namespace Mesh { class Material; }
+namespace Scene { class Scene; class Entity; }
+
+namespace Benchmark {
+
+// Each scenario stresses one subsystem and nothing else changes between runs
+enum class BenchmarkScenario {
+    Cubes,              // Count static cubes from MeshManager::GetCube: batching and culling
+    SkinnedCharacters,  // Count animated characters: animation, bone palette, skinning
+    PointLights,        // Count point lights over a fixed field of cubes: light culling and shading
+    DeepHierarchy,      // Count entities in chains of HIERARCHY_DEPTH, roots moved every frame
+    Count
+};
+
+const char* GetScenarioName(BenchmarkScenario scenario);
+bool ParseScenario(const std::string& name, BenchmarkScenario& scenario);
+unsigned int GetDefaultCount(BenchmarkScenario scenario);
+
+struct BenchmarkMaterials {
+    std::shared_ptr<Mesh::Material> staticMaterial;
+    std::shared_ptr<Mesh::Material> skinnedMaterial;
+};
+
+// What the runner needs to drive a built scene
+struct BenchmarkSceneInfo {
+    float radius = 10.0f;                       // Camera orbit radius that keeps the scene in view
+    float height = 5.0f;
+    std::vector<Scene::Entity*> animatedRoots;  // Rotated by the runner every frame
+};
+
+// Fill scene with the scenario's content; lights go to the renderer's light manager
+bool BuildBenchmarkScene(BenchmarkScenario scenario, unsigned int count, Scene::Scene& scene,
+                         Renderer::D3D11Renderer& renderer, const BenchmarkMaterials& materials,
+                         BenchmarkSceneInfo& info);
+
+} // namespace Benchmark
+} // namespace GameEngine
@@ -0,0 +1,274 @@
+#include "AssetArchive.h"
+#include "Logger.h"
+#include <lz4.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace GameEngine {
+namespace Core {
+
+namespace {
+
+constexpr size_t SECTION_ALIGNMENT = 16;
+
+struct ArchiveHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t reserved;
+    std::uint64_t indexOffset;
+    std::uint64_t pathOffset;
+    std::uint64_t pathSize;
+    std::uint64_t fileSize;
+};
+
+size_t Align(size_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+bool SectionFits(std::uint64_t offset, std::uint64_t size, size_t fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+// Writes data at the next aligned offset and returns where it starts
+size_t WriteSection(std::ofstream& file, size_t& offset, const void* data, size_t size) {
+    static const char padding[SECTION_ALIGNMENT] = {};
+    size_t start = Align(offset);
+    file.write(padding, static_cast<std::streamsize>(start - offset));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    offset = start + size;
+    return start;
+}
+
+} // namespace
+
+bool AssetArchive::Build(const std::string& sourceDirectory, const std::string& archivePath,
+                         const ArchiveBuildOptions& options) {
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(sourceDirectory, error);
+         !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+        if (it->is_regular_file(error) && it->path().extension() != EXTENSION) {
+            files.push_back(it->path());
+        }
+    }
+    if (error) {
+        LOG_ERROR("Failed to scan " << sourceDirectory << " for archiving: " << error.message());
+        return false;
+    }
+
+    // Neighbouring paths end up next to each other in the file
+    std::vector<std::pair<std::string, std::filesystem::path>> sources;
+    sources.reserve(files.size());
+    for (const auto& file : files) {
+        sources.emplace_back(NormalizePath(file.lexically_relative(sourceDirectory).generic_string()), file);
+    }
+    std::sort(sources.begin(), sources.end());
+
+    std::string tempPath = archivePath + ".tmp";
+    std::ofstream output(tempPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        LOG_ERROR("Failed to create archive: " << tempPath);
+        return false;
+    }
+
+    ArchiveHeader header = {};
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t offset = sizeof(header);
+
+    std::vector<ArchiveEntry> entries;
+    std::string paths;
+    std::vector<char> compressed;
+    entries.reserve(sources.size());
+
+    for (const auto& [path, source] : sources) {
+        MappedFile file;
+        file.OpenOnDisk(source);
+        size_t size = file.GetSize();
+
+        ArchiveEntry entry = {};
+        entry.pathHash = HashPath(path);
+        entry.pathOffset = static_cast<std::uint32_t>(paths.size());
+        entry.pathLength = static_cast<std::uint32_t>(path.size());
+        entry.size = size;
+        paths += path;
+
+        const void* stored = file.GetData();
+        size_t storedSize = size;
+        if (options.compress && size > 0 && size <= LZ4_MAX_INPUT_SIZE) {
+            compressed.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(size))));
+            int compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(file.GetData()), compressed.data(),
+                                                      static_cast<int>(size), static_cast<int>(compressed.size()));
+            if (compressedSize > 0 && compressedSize < size * options.maxCompressedRatio) {
+                stored = compressed.data();
+                storedSize = static_cast<size_t>(compressedSize);
+                entry.compression = static_cast<std::uint32_t>(ArchiveCompression::LZ4);
+            }
+        }
+
+        entry.storedSize = storedSize;
+        entry.offset = WriteSection(output, offset, stored, storedSize);
+        entries.push_back(entry);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const ArchiveEntry& a, const ArchiveEntry& b) {
+        return a.pathHash < b.pathHash;
+    });
+
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.entryCount = static_cast<std::uint32_t>(entries.size());
+    header.indexOffset = WriteSection(output, offset, entries.data(), entries.size() * sizeof(ArchiveEntry));
+    header.pathOffset = WriteSection(output, offset, paths.data(), paths.size());
+    header.pathSize = paths.size();
+    header.fileSize = offset;
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.close();
+
+    if (!output) {
+        LOG_ERROR("Failed to write archive: " << tempPath);
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    // Swap in the finished file, so readers never see a partial archive
+    std::filesystem::rename(tempPath, archivePath, error);
+    if (error) {
+        LOG_ERROR("Failed to replace archive " << archivePath << ": " << error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    LOG_INFO("Archived " << entries.size() << " files from " << sourceDirectory << " into " << archivePath
+             << " (" << offset << " bytes)");
+    return true;
+}
+
+bool AssetArchive::Open(const std::string& path) {
+    m_file = MappedFile();
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_paths = nullptr;
+    m_pathSize = 0;
+
+    // Archives are never looked up inside other archives
+    MappedFile file;
+    if (!file.OpenOnDisk(path) || file.GetSize() < sizeof(ArchiveHeader)) {
+        LOG_ERROR("Failed to map archive: " << path);
+        return false;
+    }
+
+    const std::uint8_t* data = file.GetData();
+    size_t size = file.GetSize();
+    ArchiveHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != MAGIC || header.version != VERSION) {
+        LOG_ERROR("Archive " << path << " has an unsupported format version");
+        return false;
+    }
+
+    bool valid = header.fileSize == size
+        && header.indexOffset % SECTION_ALIGNMENT == 0
+        && SectionFits(header.indexOffset, std::uint64_t(header.entryCount) * sizeof(ArchiveEntry), size)
+        && SectionFits(header.pathOffset, header.pathSize, size);
+
+    const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(data + header.indexOffset);
+    for (std::uint32_t i = 0; valid && i < header.entryCount; i++) {
+        const ArchiveEntry& entry = entries[i];
+        valid = SectionFits(entry.offset, entry.storedSize, size)
+            && SectionFits(entry.pathOffset, entry.pathLength, header.pathSize)
+            && entry.compression <= static_cast<std::uint32_t>(ArchiveCompression::LZ4)
+            && (i == 0 || entries[i - 1].pathHash <= entry.pathHash);
+    }
+
+    if (!valid) {
+        LOG_ERROR("Archive " << path << " is corrupt");
+        return false;
+    }
+
+    m_file = std::move(file);
+    m_path = path;
+    m_entries = entries;
+    m_entryCount = header.entryCount;
+    m_paths = reinterpret_cast<const char*>(data + header.pathOffset);
+    m_pathSize = header.pathSize;
+
+    LOG_INFO("Opened archive " << path << " with " << m_entryCount << " files");
+    return true;
+}
+
+const ArchiveEntry* AssetArchive::FindEntry(std::string_view path) const {
+    std::uint64_t hash = HashPath(path);
+    const ArchiveEntry* end = m_entries + m_entryCount;
+    const ArchiveEntry* it = std::lower_bound(m_entries, end, hash, [](const ArchiveEntry& entry, std::uint64_t value) {
+        return entry.pathHash < value;
+    });
+
+    // Different paths may share a hash
+    for (; it != end && it->pathHash == hash; ++it) {
+        if (GetEntryPath(*it) == path) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view AssetArchive::GetEntryPath(const ArchiveEntry& entry) const {
+    return std::string_view(m_paths + entry.pathOffset, entry.pathLength);
+}
+
+const std::uint8_t* AssetArchive::GetStoredData(const ArchiveEntry& entry) const {
+    if (entry.compression != static_cast<std::uint32_t>(ArchiveCompression::None)) {
+        return nullptr;
+    }
+    return m_file.GetData() + entry.offset;
+}
+
+bool AssetArchive::Read(const ArchiveEntry& entry, std::vector<std::uint8_t>& outData) const {
+    const std::uint8_t* stored = m_file.GetData() + entry.offset;
+    outData.resize(static_cast<size_t>(entry.size));
+
+    if (entry.compression == static_cast<std::uint32_t>(ArchiveCompression::None)) {
+        std::memcpy(outData.data(), stored, outData.size());
+        return true;
+    }
+
+    int decompressed = LZ4_decompress_safe(reinterpret_cast<const char*>(stored), reinterpret_cast<char*>(outData.data()),
+                                           static_cast<int>(entry.storedSize), static_cast<int>(outData.size()));
+    if (decompressed < 0 || static_cast<std::uint64_t>(decompressed) != entry.size) {
+        LOG_ERROR("Failed to decompress " << GetEntryPath(entry) << " from archive " << m_path);
+        outData.clear();
+        return false;
+    }
+    return true;
+}
+
+std::string AssetArchive::NormalizePath(std::string_view path) {
+    std::string normalized(path);
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](unsigned char c) {
+        return c == '\\' ? '/' : static_cast<char>(std::tolower(c));
+    });
+    normalized = std::filesystem::path(normalized).lexically_normal().generic_string();
+    if (!normalized.empty() && normalized.back() == '/') {
+        normalized.pop_back();
+    }
+    return normalized == "." ? std::string() : normalized;
+}
+
+std::uint64_t AssetArchive::HashPath(std::string_view normalizedPath) {
+    // 64-bit FNV-1a; paths are compared as well, so collisions only cost time
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : normalizedPath) {
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace Core
+} // namespace GameEngine
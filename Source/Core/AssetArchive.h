@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "FileSystem.h"
+
+namespace GameEngine {
+namespace Core {
+
+enum class ArchiveCompression : std::uint32_t {
+    None = 0,
+    LZ4 = 1
+};
+
+// Index record of one file in an archive, read straight from the mapping
+struct ArchiveEntry {
+    std::uint64_t pathHash;
+    std::uint64_t offset;           // Stored bytes, 16-byte aligned
+    std::uint64_t storedSize;
+    std::uint64_t size;             // Size once decompressed
+    std::uint32_t pathOffset;       // Into the path table
+    std::uint32_t pathLength;
+    std::uint32_t compression;      // ArchiveCompression
+    std::uint32_t reserved;
+};
+
+struct ArchiveBuildOptions {
+    bool compress = true;
+    float maxCompressedRatio = 0.9f;    // Entries that shrink less than this are stored raw
+};
+
+// Packed asset archives.
+//
+// An archive holds a whole asset directory in one file, so a cold start
+// opens and maps one file instead of scanning directories and opening every
+// asset. Files are found through an index sorted by the 64-bit FNV-1a hash
+// of their normalized path. Each entry is stored raw or LZ4-compressed,
+// whichever the builder found worth it; raw entries are served straight
+// from the mapping without a copy.
+//
+// Layout: ArchiveHeader, the 16-byte aligned entry data, then the index
+// and the path table. Mount archives through FileSystem::MountArchive to
+// make them transparent to loaders.
+class AssetArchive {
+public:
+    static constexpr std::uint32_t MAGIC = 0x4B415047;    // "GPAK"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr const char* EXTENSION = ".gpak";
+
+    AssetArchive() = default;
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    // Pack every file below sourceDirectory, with paths relative to it
+    static bool Build(const std::string& sourceDirectory, const std::string& archivePath,
+                      const ArchiveBuildOptions& options = ArchiveBuildOptions());
+
+    bool Open(const std::string& path);
+    bool IsOpen() const { return m_file.IsValid(); }
+    const std::string& GetPath() const { return m_path; }
+
+    // Lookups take paths in NormalizePath form
+    const ArchiveEntry* FindEntry(std::string_view path) const;
+    size_t GetEntryCount() const { return m_entryCount; }
+    const ArchiveEntry& GetEntry(size_t index) const { return m_entries[index]; }
+    std::string_view GetEntryPath(const ArchiveEntry& entry) const;
+
+    // Bytes of a raw entry inside the mapping; null for compressed entries
+    const std::uint8_t* GetStoredData(const ArchiveEntry& entry) const;
+    // Decompressed (or copied) contents
+    bool Read(const ArchiveEntry& entry, std::vector<std::uint8_t>& outData) const;
+
+    // Lowercase, forward slashes, no "." or ".." segments or trailing slash
+    static std::string NormalizePath(std::string_view path);
+    static std::uint64_t HashPath(std::string_view normalizedPath);
+
+private:
+    MappedFile m_file;
+    std::string m_path;
+    const ArchiveEntry* m_entries = nullptr;
+    size_t m_entryCount = 0;
+    const char* m_paths = nullptr;
+    size_t m_pathSize = 0;
+};
+
+} // namespace Core
+} // namespace GameEngine
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GameEngine {
+namespace Core {
+
+// Thread-safe cache of shared assets, safe to use from loader and worker
+// threads as well as the main thread.
+//
+// Entries are spread over shards by key hash, each behind its own mutex,
+// so threads working on different assets rarely wait on each other. The
+// first GetOrLoad of a missing key runs the loader outside any lock; later
+// callers for the same key wait on its future instead of loading again.
+//
+// The cache holds a reference to every asset, so an asset nobody uses any
+// more stays cached until Trim finds the cache over budget and drops such
+// entries least recently used first. Assets still referenced elsewhere are
+// never evicted.
+template<typename Key, typename T, typename Hash = std::hash<Key>>
+class AssetCache {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    using Loader = std::function<std::shared_ptr<T>()>;
+    using SizeFunction = std::function<size_t(const T&)>;
+
+    explicit AssetCache(SizeFunction sizeOf = nullptr) : m_sizeOf(std::move(sizeOf)), m_clock(0), m_size(0), m_count(0) {}
+
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    // Cached asset or null; loads in flight are not waited for
+    std::shared_ptr<T> Find(const Key& key);
+    bool Contains(const Key& key) const;
+    // Cached asset, the result of a load already in flight, or load() run
+    // on this thread and cached if it succeeds. If load() throws, the entry
+    // is dropped, waiters get the exception and it is rethrown here.
+    std::shared_ptr<T> GetOrLoad(const Key& key, const Loader& load);
+    // Adds or replaces an entry
+    void Insert(const Key& key, std::shared_ptr<T> asset);
+    bool Remove(const Key& key);
+    void Clear();
+
+    // Calls function(key, asset) for every cached asset with its shard
+    // locked; it must not call back into the cache
+    template<typename Function>
+    void ForEach(Function&& function) const;
+
+    // Evicts unreferenced assets, least recently used first, until the
+    // cache fits budgetBytes or nothing evictable is left. Cheap when
+    // already within budget. Returns how many entries were dropped.
+    size_t Trim(size_t budgetBytes);
+
+    size_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+    size_t GetMemoryUsage() const { return m_size.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        std::shared_ptr<T> asset;
+        std::shared_future<std::shared_ptr<T>> loading;     // Valid while a load is in flight
+        size_t size = 0;
+        std::uint64_t lastUsed = 0;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Entry, Hash> entries;
+    };
+
+    Shard& GetShard(const Key& key) { return m_shards[Hash()(key) % SHARD_COUNT]; }
+
+    // Shard must be locked
+    void Store(Entry& entry, std::shared_ptr<T> asset);
+    void Drop(Entry& entry);
+
+    SizeFunction m_sizeOf;
+    std::array<Shard, SHARD_COUNT> m_shards;
+    std::atomic<std::uint64_t> m_clock;
+    std::atomic<size_t> m_size;
+    std::atomic<size_t> m_count;
+};
+
+template<typename Key, typename T, typename Hash>
+std::shared_ptr<T> AssetCache<Key, T, Hash>::Find(const Key& key) {
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || !it->second.asset) {
+        return nullptr;
+    }
+    it->second.lastUsed = m_clock.fetch_add(1, std::memory_order_relaxed);
+    return it->second.asset;
+}
+
+template<typename Key, typename T, typename Hash>
+bool AssetCache<Key, T, Hash>::Contains(const Key& key) const {
+    const Shard& shard = m_shards[Hash()(key) % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() && it->second.asset;
+}
+
+template<typename Key, typename T, typename Hash>
+std::shared_ptr<T> AssetCache<Key, T, Hash>::GetOrLoad(const Key& key, const Loader& load) {
+    Shard& shard = GetShard(key);
+    std::promise<std::shared_ptr<T>> promise;
+    std::shared_future<std::shared_ptr<T>> loading;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Entry& entry = shard.entries[key];
+        if (entry.asset) {
+            entry.lastUsed = m_clock.fetch_add(1, std::memory_order_relaxed);
+            return entry.asset;
+        }
+        if (entry.loading.valid()) {
+            loading = entry.loading;
+        }
+        else {
+            entry.loading = promise.get_future().share();
+        }
+    }
+
+    // Someone else is loading it
+    if (loading.valid()) {
+        return loading.get();
+    }
+
+    std::shared_ptr<T> asset;
+    try {
+        asset = load ? load() : nullptr;
+    }
+    catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end() && !it->second.asset) {
+                shard.entries.erase(it);
+            }
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (asset) {
+            // Re-created if Remove or Clear ran meanwhile; the asset is in use now
+            Entry& entry = it != shard.entries.end() ? it->second : shard.entries[key];
+            entry.loading = std::shared_future<std::shared_ptr<T>>();
+            Store(entry, asset);
+        }
+        else if (it != shard.entries.end() && !it->second.asset) {
+            shard.entries.erase(it);
+        }
+    }
+    promise.set_value(asset);
+    return asset;
+}
+
+template<typename Key, typename T, typename Hash>
+void AssetCache<Key, T, Hash>::Insert(const Key& key, std::shared_ptr<T> asset) {
+    if (!asset) {
+        return;
+    }
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Store(shard.entries[key], std::move(asset));
+}
+
+template<typename Key, typename T, typename Hash>
+bool AssetCache<Key, T, Hash>::Remove(const Key& key) {
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || !it->second.asset) {
+        return false;
+    }
+    Drop(it->second);
+    // A load in flight keeps its entry so its waiters still share it
+    if (!it->second.loading.valid()) {
+        shard.entries.erase(it);
+    }
+    return true;
+}
+
+template<typename Key, typename T, typename Hash>
+void AssetCache<Key, T, Hash>::Clear() {
+    for (Shard& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            Drop(it->second);
+            it = it->second.loading.valid() ? std::next(it) : shard.entries.erase(it);
+        }
+    }
+}
+
+template<typename Key, typename T, typename Hash>
+template<typename Function>
+void AssetCache<Key, T, Hash>::ForEach(Function&& function) const {
+    for (const Shard& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [key, entry] : shard.entries) {
+            if (entry.asset) {
+                function(key, entry.asset);
+            }
+        }
+    }
+}
+
+template<typename Key, typename T, typename Hash>
+size_t AssetCache<Key, T, Hash>::Trim(size_t budgetBytes) {
+    if (m_size.load(std::memory_order_relaxed) <= budgetBytes) {
+        return 0;
+    }
+
+    // Only the cache holds these; nobody can take a new reference without
+    // going through the shard lock
+    std::vector<std::tuple<std::uint64_t, size_t, Key>> candidates;
+    for (size_t i = 0; i < SHARD_COUNT; i++) {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        for (const auto& [key, entry] : m_shards[i].entries) {
+            if (entry.asset && entry.asset.use_count() == 1) {
+                candidates.emplace_back(entry.lastUsed, i, key);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return std::get<0>(a) < std::get<0>(b);
+    });
+
+    size_t evicted = 0;
+    for (const auto& [lastUsed, shardIndex, key] : candidates) {
+        if (m_size.load(std::memory_order_relaxed) <= budgetBytes) {
+            break;
+        }
+
+        Shard& shard = m_shards[shardIndex];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        // Skip entries used or replaced since the scan
+        if (it == shard.entries.end() || !it->second.asset || it->second.asset.use_count() != 1 ||
+            it->second.lastUsed != lastUsed) {
+            continue;
+        }
+        Drop(it->second);
+        shard.entries.erase(it);
+        evicted++;
+    }
+    return evicted;
+}
+
+template<typename Key, typename T, typename Hash>
+void AssetCache<Key, T, Hash>::Store(Entry& entry, std::shared_ptr<T> asset) {
+    Drop(entry);
+    entry.size = m_sizeOf ? m_sizeOf(*asset) : 0;
+    entry.asset = std::move(asset);
+    entry.lastUsed = m_clock.fetch_add(1, std::memory_order_relaxed);
+    m_size.fetch_add(entry.size, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename Key, typename T, typename Hash>
+void AssetCache<Key, T, Hash>::Drop(Entry& entry) {
+    if (!entry.asset) {
+        return;
+    }
+    m_size.fetch_sub(entry.size, std::memory_order_relaxed);
+    m_count.fetch_sub(1, std::memory_order_relaxed);
+    entry.asset.reset();
+    entry.size = 0;
+}
+
+} // namespace Core
+} // namespace GameEngine
@@ -64,6 +64,11 @@ bool ConfigManager::LoadConfig(const std::string& configFile) {
         DeserializeEngineSettings(engineNode);
     }
 
+    auto animationNode = root.GetFirstChild("Animation");
+    if (animationNode.IsValid()) {
+        DeserializeAnimationSettings(animationNode);
+    }
+
     // Load custom settings
     auto customNode = root.GetFirstChild("Custom");
     if (customNode.IsValid()) {
@@ -74,7 +79,7 @@ bool ConfigManager::LoadConfig(const std::string& configFile) {
                     std::string key = settingNode.GetAttributeValue("key");
                     std::string value = settingNode.GetAttributeValue("value");
                     if (!key.empty()) {
-                        m_customSettings[categoryName][key] = value;
+                        StoreSetting(categoryName, key, value);
                     }
                 }
             }
@@ -98,6 +103,7 @@ bool ConfigManager::SaveConfig(const std::string& configFile) {
     SerializeAssetSettings(root);
     SerializeInputSettings(root);
     SerializeEngineSettings(root);
+    SerializeAnimationSettings(root);
 
     // Serialize custom settings
     if (!m_customSettings.empty()) {
@@ -150,6 +156,10 @@ void ConfigManager::SetEngineSettings(const EngineSettings& settings) {
     m_engineSettings = settings;
 }
 
+void ConfigManager::SetAnimationSettings(const AnimationSettings& settings) {
+    m_animationSettings = settings;
+}
+
 void ConfigManager::SetKeyBinding(const std::string& action, int keyCode) {
     m_inputSettings.keyBindings[action] = keyCode;
 }
@@ -181,12 +191,129 @@ bool ConfigManager::ValidateSettings() {
         valid = false;
     }
 
+    if (m_graphicsSettings.maxFrameLatency < 1 || m_graphicsSettings.maxFrameLatency > 3) {
+        Logger::GetInstance().LogWarning("Invalid max frame latency, resetting to 1");
+        m_graphicsSettings.maxFrameLatency = 1;
+        valid = false;
+    }
+
+    if (m_graphicsSettings.textureBudgetMB < 16 || m_graphicsSettings.textureBudgetMB > 16384) {
+        Logger::GetInstance().LogWarning("Invalid texture budget, resetting to 512 MB");
+        m_graphicsSettings.textureBudgetMB = 512;
+        valid = false;
+    }
+
+    if (m_graphicsSettings.occlusionBufferWidth < 64 || m_graphicsSettings.occlusionBufferWidth > 1024) {
+        Logger::GetInstance().LogWarning("Invalid occlusion buffer width, resetting to 256");
+        m_graphicsSettings.occlusionBufferWidth = 256;
+        valid = false;
+    }
+
+    if (m_graphicsSettings.renderStatsInterval < 0.0f || m_graphicsSettings.renderStatsInterval > 3600.0f) {
+        Logger::GetInstance().LogWarning("Invalid render stats interval, resetting to 0 (disabled)");
+        m_graphicsSettings.renderStatsInterval = 0.0f;
+        valid = false;
+    }
+
+    if (m_graphicsSettings.renderPath != "Forward" && m_graphicsSettings.renderPath != "DepthPrepass" &&
+        m_graphicsSettings.renderPath != "Deferred") {
+        Logger::GetInstance().LogWarning("Invalid render path, resetting to Forward");
+        m_graphicsSettings.renderPath = "Forward";
+        valid = false;
+    }
+
+    if (m_graphicsSettings.shadowFilter != "None" && m_graphicsSettings.shadowFilter != "PCF" &&
+        m_graphicsSettings.shadowFilter != "PCSS" && m_graphicsSettings.shadowFilter != "VSM") {
+        Logger::GetInstance().LogWarning("Invalid shadow filter, resetting to PCF");
+        m_graphicsSettings.shadowFilter = "PCF";
+        valid = false;
+    }
+
     // Validate asset settings
     if (!FILE_SYSTEM.DirectoryExists(m_assetSettings.assetsDirectory)) {
         Logger::GetInstance().LogWarning("Assets directory doesn't exist: " + m_assetSettings.assetsDirectory);
         FILE_SYSTEM.CreateDirectories(m_assetSettings.assetsDirectory);
     }
 
+    if (m_assetSettings.loaderThreadCount < 1 || m_assetSettings.loaderThreadCount > 16) {
+        Logger::GetInstance().LogWarning("Invalid loader thread count, resetting to 2");
+        m_assetSettings.loaderThreadCount = 2;
+        valid = false;
+    }
+
+    if (m_assetSettings.meshLODCount < 1 || m_assetSettings.meshLODCount > 8) {
+        Logger::GetInstance().LogWarning("Invalid mesh LOD count, resetting to 4");
+        m_assetSettings.meshLODCount = 4;
+        valid = false;
+    }
+
+    if (m_assetSettings.meshLODReduction < 0.1f || m_assetSettings.meshLODReduction > 0.9f) {
+        Logger::GetInstance().LogWarning("Invalid mesh LOD reduction, resetting to 0.5");
+        m_assetSettings.meshLODReduction = 0.5f;
+        valid = false;
+    }
+
+    // Validate engine settings
+    if (m_engineSettings.fixedUpdateRate < 10 || m_engineSettings.fixedUpdateRate > 240) {
+        Logger::GetInstance().LogWarning("Invalid fixed update rate, resetting to 60");
+        m_engineSettings.fixedUpdateRate = 60;
+        valid = false;
+    }
+
+    if (m_engineSettings.maxFixedSteps < 1 || m_engineSettings.maxFixedSteps > 20) {
+        Logger::GetInstance().LogWarning("Invalid max fixed steps, resetting to 5");
+        m_engineSettings.maxFixedSteps = 5;
+        valid = false;
+    }
+
+    if (m_engineSettings.componentUpdateBatchSize < 1) {
+        Logger::GetInstance().LogWarning("Invalid component update batch size, resetting to 64");
+        m_engineSettings.componentUpdateBatchSize = 64;
+        valid = false;
+    }
+
+    if (m_engineSettings.meshMemoryBudgetMB < 0) {
+        Logger::GetInstance().LogWarning("Invalid mesh memory budget, resetting to 1024 MB");
+        m_engineSettings.meshMemoryBudgetMB = 1024;
+        valid = false;
+    }
+
+    if (m_engineSettings.textureMemoryBudgetMB < 0) {
+        Logger::GetInstance().LogWarning("Invalid texture memory budget, resetting to 2048 MB");
+        m_engineSettings.textureMemoryBudgetMB = 2048;
+        valid = false;
+    }
+
+    if (m_engineSettings.animationMemoryBudgetMB < 0) {
+        Logger::GetInstance().LogWarning("Invalid animation memory budget, resetting to 256 MB");
+        m_engineSettings.animationMemoryBudgetMB = 256;
+        valid = false;
+    }
+
+    if (m_engineSettings.sceneMemoryBudgetMB < 0) {
+        Logger::GetInstance().LogWarning("Invalid scene memory budget, resetting to 512 MB");
+        m_engineSettings.sceneMemoryBudgetMB = 512;
+        valid = false;
+    }
+
+    if (m_engineSettings.xmlMemoryBudgetMB < 0) {
+        Logger::GetInstance().LogWarning("Invalid XML memory budget, resetting to 64 MB");
+        m_engineSettings.xmlMemoryBudgetMB = 64;
+        valid = false;
+    }
+
+    if (m_engineSettings.logMemoryBudgetMB < 0) {
+        Logger::GetInstance().LogWarning("Invalid log memory budget, resetting to 32 MB");
+        m_engineSettings.logMemoryBudgetMB = 32;
+        valid = false;
+    }
+
+    if (m_engineSettings.rendererMemoryBudgetMB < 0) {
+        Logger::GetInstance().LogWarning("Invalid renderer memory budget, resetting to 1024 MB");
+        m_engineSettings.rendererMemoryBudgetMB = 1024;
+        valid = false;
+    }
+
     // Validate input settings
     if (m_inputSettings.mouseSensitivity < 0.1f || m_inputSettings.mouseSensitivity > 10.0f) {
         Logger::GetInstance().LogWarning("Invalid mouse sensitivity, resetting to 1.0");
@@ -194,15 +321,46 @@ bool ConfigManager::ValidateSettings() {
         valid = false;
     }
 
+    if (m_inputSettings.gamepadPollInterval < 0.1f || m_inputSettings.gamepadPollInterval > 10.0f) {
+        Logger::GetInstance().LogWarning("Invalid gamepad poll interval, resetting to 1.0");
+        m_inputSettings.gamepadPollInterval = 1.0f;
+        valid = false;
+    }
+
+    // Validate animation settings
+    if (m_animationSettings.reducedChannelCount < 1) {
+        Logger::GetInstance().LogWarning("Invalid reduced animation channel count, resetting to 16");
+        m_animationSettings.reducedChannelCount = 16;
+        valid = false;
+    }
+
+    if (m_animationSettings.updateBatchSize < 1) {
+        Logger::GetInstance().LogWarning("Invalid animation update batch size, resetting to 4");
+        m_animationSettings.updateBatchSize = 4;
+        valid = false;
+    }
+
     return valid;
 }
 
 void ConfigManager::ResetToDefaults() {
     InitializeDefaultSettings();
     m_customSettings.clear();
+    m_settingTable.clear();
     Logger::GetInstance().LogInfo("Configuration reset to defaults");
 }
 
+void ConfigManager::StoreSetting(const std::string& category, const std::string& key, const std::string& value) {
+    m_customSettings[category][key] = value;
+
+    SettingValue& setting = m_settingTable[GetSettingKey(category, key)];
+    setting = SettingValue();
+    setting.text = value;
+    setting.isInt = ParseXmlValue(value, setting.intValue);
+    setting.isFloat = ParseXmlValue(value, setting.floatValue);
+    ParseXmlValue(value, setting.boolValue);
+}
+
 bool ConfigManager::CreateConfigBackup() {
     if (!FILE_SYSTEM.FileExists(m_configFile)) {
         return false;
@@ -243,10 +401,18 @@ void ConfigManager::SerializeGraphicsSettings(XmlNode& parentNode) {
     graphicsNode.SetAttribute("fullscreen", m_graphicsSettings.fullscreen);
     graphicsNode.SetAttribute("vsync", m_graphicsSettings.vsync);
     graphicsNode.SetAttribute("maxFPS", m_graphicsSettings.maxFPS);
+    graphicsNode.SetAttribute("maxFrameLatency", m_graphicsSettings.maxFrameLatency);
     graphicsNode.SetAttribute("enableShadows", m_graphicsSettings.enableShadows);
     graphicsNode.SetAttribute("enableLighting", m_graphicsSettings.enableLighting);
     graphicsNode.SetAttribute("shadowQuality", m_graphicsSettings.shadowQuality);
     graphicsNode.SetAttribute("shaderPath", m_graphicsSettings.shaderPath);
+    graphicsNode.SetAttribute("textureStreaming", m_graphicsSettings.textureStreaming);
+    graphicsNode.SetAttribute("textureBudgetMB", m_graphicsSettings.textureBudgetMB);
+    graphicsNode.SetAttribute("occlusionCulling", m_graphicsSettings.occlusionCulling);
+    graphicsNode.SetAttribute("occlusionBufferWidth", m_graphicsSettings.occlusionBufferWidth);
+    graphicsNode.SetAttribute("renderStatsInterval", m_graphicsSettings.renderStatsInterval);
+    graphicsNode.SetAttribute("renderPath", m_graphicsSettings.renderPath);
+    graphicsNode.SetAttribute("shadowFilter", m_graphicsSettings.shadowFilter);
 }
 
 void ConfigManager::SerializeAssetSettings(XmlNode& parentNode) {
@@ -258,6 +424,14 @@ void ConfigManager::SerializeAssetSettings(XmlNode& parentNode) {
     assetsNode.SetAttribute("audioDirectory", m_assetSettings.audioDirectory);
     assetsNode.SetAttribute("enableAssetCache", m_assetSettings.enableAssetCache);
     assetsNode.SetAttribute("maxCacheSize", m_assetSettings.maxCacheSize);
+    assetsNode.SetAttribute("loaderThreadCount", m_assetSettings.loaderThreadCount);
+    assetsNode.SetAttribute("compressTextures", m_assetSettings.compressTextures);
+    assetsNode.SetAttribute("useBC7", m_assetSettings.useBC7);
+    assetsNode.SetAttribute("meshLODCount", m_assetSettings.meshLODCount);
+    assetsNode.SetAttribute("meshLODReduction", m_assetSettings.meshLODReduction);
+    assetsNode.SetAttribute("compactVertices", m_assetSettings.compactVertices);
+    assetsNode.SetAttribute("optimizeMeshes", m_assetSettings.optimizeMeshes);
+    assetsNode.SetAttribute("archiveFile", m_assetSettings.archiveFile);
 }
 
 void ConfigManager::SerializeInputSettings(XmlNode& parentNode) {
@@ -265,6 +439,8 @@ void ConfigManager::SerializeInputSettings(XmlNode& parentNode) {
 
     inputNode.SetAttribute("mouseSensitivity", m_inputSettings.mouseSensitivity);
     inputNode.SetAttribute("invertMouse", m_inputSettings.invertMouse);
+    inputNode.SetAttribute("rawInput", m_inputSettings.rawInput);
+    inputNode.SetAttribute("gamepadPollInterval", m_inputSettings.gamepadPollInterval);
 
     // Serialize key bindings
     if (!m_inputSettings.keyBindings.empty()) {
@@ -285,6 +461,34 @@ void ConfigManager::SerializeEngineSettings(XmlNode& parentNode) {
     engineNode.SetAttribute("enableLogging", m_engineSettings.enableLogging);
     engineNode.SetAttribute("enableDebugOutput", m_engineSettings.enableDebugOutput);
     engineNode.SetAttribute("maxLogFileSize", m_engineSettings.maxLogFileSize);
+    engineNode.SetAttribute("workerThreadCount", m_engineSettings.workerThreadCount);
+    engineNode.SetAttribute("fixedTimestep", m_engineSettings.fixedTimestep);
+    engineNode.SetAttribute("fixedUpdateRate", m_engineSettings.fixedUpdateRate);
+    engineNode.SetAttribute("maxFixedSteps", m_engineSettings.maxFixedSteps);
+    engineNode.SetAttribute("parallelComponentUpdate", m_engineSettings.parallelComponentUpdate);
+    engineNode.SetAttribute("componentUpdateBatchSize", m_engineSettings.componentUpdateBatchSize);
+    engineNode.SetAttribute("hotReload", m_engineSettings.hotReload);
+    engineNode.SetAttribute("meshMemoryBudgetMB", m_engineSettings.meshMemoryBudgetMB);
+    engineNode.SetAttribute("textureMemoryBudgetMB", m_engineSettings.textureMemoryBudgetMB);
+    engineNode.SetAttribute("animationMemoryBudgetMB", m_engineSettings.animationMemoryBudgetMB);
+    engineNode.SetAttribute("sceneMemoryBudgetMB", m_engineSettings.sceneMemoryBudgetMB);
+    engineNode.SetAttribute("xmlMemoryBudgetMB", m_engineSettings.xmlMemoryBudgetMB);
+    engineNode.SetAttribute("logMemoryBudgetMB", m_engineSettings.logMemoryBudgetMB);
+    engineNode.SetAttribute("rendererMemoryBudgetMB", m_engineSettings.rendererMemoryBudgetMB);
+}
+
+void ConfigManager::SerializeAnimationSettings(XmlNode& parentNode) {
+    auto animationNode = parentNode.AppendChild("Animation");
+
+    animationNode.SetAttribute("enableLOD", m_animationSettings.enableLOD);
+    animationNode.SetAttribute("cullOffscreen", m_animationSettings.cullOffscreen);
+    animationNode.SetAttribute("halfRateScreenSize", m_animationSettings.halfRateScreenSize);
+    animationNode.SetAttribute("quarterRateScreenSize", m_animationSettings.quarterRateScreenSize);
+    animationNode.SetAttribute("reducedScreenSize", m_animationSettings.reducedScreenSize);
+    animationNode.SetAttribute("reducedChannelCount", m_animationSettings.reducedChannelCount);
+    animationNode.SetAttribute("compressClips", m_animationSettings.compressClips);
+    animationNode.SetAttribute("parallelUpdate", m_animationSettings.parallelUpdate);
+    animationNode.SetAttribute("updateBatchSize", m_animationSettings.updateBatchSize);
 }
 
 void ConfigManager::DeserializeGraphicsSettings(const XmlNode& parentNode) {
@@ -293,10 +497,18 @@ void ConfigManager::DeserializeGraphicsSettings(const XmlNode& parentNode) {
     m_graphicsSettings.fullscreen = parentNode.GetAttributeValueAsBool("fullscreen", false);
     m_graphicsSettings.vsync = parentNode.GetAttributeValueAsBool("vsync", true);
     m_graphicsSettings.maxFPS = parentNode.GetAttributeValueAsInt("maxFPS", 60);
+    m_graphicsSettings.maxFrameLatency = parentNode.GetAttributeValueAsInt("maxFrameLatency", 1);
     m_graphicsSettings.enableShadows = parentNode.GetAttributeValueAsBool("enableShadows", true);
     m_graphicsSettings.enableLighting = parentNode.GetAttributeValueAsBool("enableLighting", true);
     m_graphicsSettings.shadowQuality = parentNode.GetAttributeValueAsFloat("shadowQuality", 1.0f);
     m_graphicsSettings.shaderPath = parentNode.GetAttributeValue("shaderPath", "Shaders");
+    m_graphicsSettings.textureStreaming = parentNode.GetAttributeValueAsBool("textureStreaming", true);
+    m_graphicsSettings.textureBudgetMB = parentNode.GetAttributeValueAsInt("textureBudgetMB", 512);
+    m_graphicsSettings.occlusionCulling = parentNode.GetAttributeValueAsBool("occlusionCulling", true);
+    m_graphicsSettings.occlusionBufferWidth = parentNode.GetAttributeValueAsInt("occlusionBufferWidth", 256);
+    m_graphicsSettings.renderStatsInterval = parentNode.GetAttributeValueAsFloat("renderStatsInterval", 0.0f);
+    m_graphicsSettings.renderPath = parentNode.GetAttributeValue("renderPath", "Forward");
+    m_graphicsSettings.shadowFilter = parentNode.GetAttributeValue("shadowFilter", "PCF");
 }
 
 void ConfigManager::DeserializeAssetSettings(const XmlNode& parentNode) {
@@ -306,11 +518,21 @@ void ConfigManager::DeserializeAssetSettings(const XmlNode& parentNode) {
     m_assetSettings.audioDirectory = parentNode.GetAttributeValue("audioDirectory", "Audio");
     m_assetSettings.enableAssetCache = parentNode.GetAttributeValueAsBool("enableAssetCache", true);
     m_assetSettings.maxCacheSize = parentNode.GetAttributeValueAsInt("maxCacheSize", 512);
+    m_assetSettings.loaderThreadCount = parentNode.GetAttributeValueAsInt("loaderThreadCount", 2);
+    m_assetSettings.compressTextures = parentNode.GetAttributeValueAsBool("compressTextures", true);
+    m_assetSettings.useBC7 = parentNode.GetAttributeValueAsBool("useBC7", false);
+    m_assetSettings.meshLODCount = parentNode.GetAttributeValueAsInt("meshLODCount", 4);
+    m_assetSettings.meshLODReduction = parentNode.GetAttributeValueAsFloat("meshLODReduction", 0.5f);
+    m_assetSettings.compactVertices = parentNode.GetAttributeValueAsBool("compactVertices", false);
+    m_assetSettings.optimizeMeshes = parentNode.GetAttributeValueAsBool("optimizeMeshes", true);
+    m_assetSettings.archiveFile = parentNode.GetAttributeValue("archiveFile", "");
 }
 
 void ConfigManager::DeserializeInputSettings(const XmlNode& parentNode) {
     m_inputSettings.mouseSensitivity = parentNode.GetAttributeValueAsFloat("mouseSensitivity", 1.0f);
     m_inputSettings.invertMouse = parentNode.GetAttributeValueAsBool("invertMouse", false);
+    m_inputSettings.rawInput = parentNode.GetAttributeValueAsBool("rawInput", true);
+    m_inputSettings.gamepadPollInterval = parentNode.GetAttributeValueAsFloat("gamepadPollInterval", 1.0f);
 
     // Deserialize key bindings
     auto bindingsNode = parentNode.GetFirstChild("KeyBindings");
@@ -332,6 +554,32 @@ void ConfigManager::DeserializeEngineSettings(const XmlNode& parentNode) {
     m_engineSettings.enableLogging = parentNode.GetAttributeValueAsBool("enableLogging", true);
     m_engineSettings.enableDebugOutput = parentNode.GetAttributeValueAsBool("enableDebugOutput", false);
     m_engineSettings.maxLogFileSize = parentNode.GetAttributeValueAsInt("maxLogFileSize", 10);
+    m_engineSettings.workerThreadCount = parentNode.GetAttributeValueAsInt("workerThreadCount", 0);
+    m_engineSettings.fixedTimestep = parentNode.GetAttributeValueAsBool("fixedTimestep", false);
+    m_engineSettings.fixedUpdateRate = parentNode.GetAttributeValueAsInt("fixedUpdateRate", 60);
+    m_engineSettings.maxFixedSteps = parentNode.GetAttributeValueAsInt("maxFixedSteps", 5);
+    m_engineSettings.parallelComponentUpdate = parentNode.GetAttributeValueAsBool("parallelComponentUpdate", true);
+    m_engineSettings.componentUpdateBatchSize = parentNode.GetAttributeValueAsInt("componentUpdateBatchSize", 64);
+    m_engineSettings.hotReload = parentNode.GetAttributeValueAsBool("hotReload", true);
+    m_engineSettings.meshMemoryBudgetMB = parentNode.GetAttributeValueAsInt("meshMemoryBudgetMB", 1024);
+    m_engineSettings.textureMemoryBudgetMB = parentNode.GetAttributeValueAsInt("textureMemoryBudgetMB", 2048);
+    m_engineSettings.animationMemoryBudgetMB = parentNode.GetAttributeValueAsInt("animationMemoryBudgetMB", 256);
+    m_engineSettings.sceneMemoryBudgetMB = parentNode.GetAttributeValueAsInt("sceneMemoryBudgetMB", 512);
+    m_engineSettings.xmlMemoryBudgetMB = parentNode.GetAttributeValueAsInt("xmlMemoryBudgetMB", 64);
+    m_engineSettings.logMemoryBudgetMB = parentNode.GetAttributeValueAsInt("logMemoryBudgetMB", 32);
+    m_engineSettings.rendererMemoryBudgetMB = parentNode.GetAttributeValueAsInt("rendererMemoryBudgetMB", 1024);
+}
+
+void ConfigManager::DeserializeAnimationSettings(const XmlNode& parentNode) {
+    m_animationSettings.enableLOD = parentNode.GetAttributeValueAsBool("enableLOD", true);
+    m_animationSettings.cullOffscreen = parentNode.GetAttributeValueAsBool("cullOffscreen", true);
+    m_animationSettings.halfRateScreenSize = parentNode.GetAttributeValueAsFloat("halfRateScreenSize", 0.25f);
+    m_animationSettings.quarterRateScreenSize = parentNode.GetAttributeValueAsFloat("quarterRateScreenSize", 0.1f);
+    m_animationSettings.reducedScreenSize = parentNode.GetAttributeValueAsFloat("reducedScreenSize", 0.04f);
+    m_animationSettings.reducedChannelCount = parentNode.GetAttributeValueAsInt("reducedChannelCount", 16);
+    m_animationSettings.compressClips = parentNode.GetAttributeValueAsBool("compressClips", true);
+    m_animationSettings.parallelUpdate = parentNode.GetAttributeValueAsBool("parallelUpdate", true);
+    m_animationSettings.updateBatchSize = parentNode.GetAttributeValueAsInt("updateBatchSize", 4);
 }
 
 void ConfigManager::InitializeDefaultSettings() {
@@ -361,6 +609,9 @@ void ConfigManager::InitializeDefaultSettings() {
 
     // Engine defaults
     m_engineSettings = EngineSettings{};
+
+    // Animation defaults
+    m_animationSettings = AnimationSettings{};
 }
 
 void ConfigManager::ApplySettings() {
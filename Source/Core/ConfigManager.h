@@ -1,6 +1,8 @@
 #pragma once
 
+#include "StringId.h"
 #include "XmlManager.h"
+#include <cstdint>
 #include <unordered_map>
 #include <string>
 
@@ -13,10 +15,18 @@ struct GraphicsSettings {
     bool fullscreen = false;
     bool vsync = true;
     int maxFPS = 60;
+    int maxFrameLatency = 1; // Frames the CPU may queue ahead of the display; lower is less input lag
     bool enableShadows = true;
     bool enableLighting = true;
     float shadowQuality = 1.0f;
     std::string shaderPath = "Shaders";
+    bool textureStreaming = true;
+    int textureBudgetMB = 512; // VRAM for streamed texture mips
+    bool occlusionCulling = true; // Software occluder buffer for queued draws, Hi-Z for GPU-driven ones
+    int occlusionBufferWidth = 256; // Software occlusion buffer width in pixels, height follows the aspect ratio
+    float renderStatsInterval = 0.0f; // Seconds between render statistics log lines, 0 disables
+    std::string renderPath = "Forward"; // Forward, DepthPrepass or Deferred; the last two shade each pixel once
+    std::string shadowFilter = "PCF"; // None, PCF, PCSS or VSM; VSM blurs moments for soft shadows at a fixed cost
 };
 
 struct AssetSettings {
@@ -25,12 +35,22 @@ struct AssetSettings {
     std::string texturesDirectory = "Textures";
     std::string audioDirectory = "Audio";
     bool enableAssetCache = true;
-    int maxCacheSize = 512; // MB
+    int maxCacheSize = 512; // MB of cached meshes before unused ones are evicted
+    int loaderThreadCount = 2; // Background threads for asynchronous file I/O and decoding
+    bool compressTextures = true; // Block-compress cooked textures
+    bool useBC7 = false; // BC7 instead of BC1/BC3 for colour textures, slower to cook
+    int meshLODCount = 4; // Detail levels generated for imported meshes, including the full mesh
+    float meshLODReduction = 0.5f; // Fraction of triangles each LOD keeps from the previous one
+    bool compactVertices = false; // Cook meshes into compact vertex formats; shaders need per-format input layouts
+    bool optimizeMeshes = true; // Reorder imported meshes for vertex cache, overdraw and vertex fetch
+    std::string archiveFile = ""; // Packed archive mounted over the assets directory; empty for loose files only
 };
 
 struct InputSettings {
     float mouseSensitivity = 1.0f;
     bool invertMouse = false;
+    bool rawInput = true; // Keyboard and mouse through WM_INPUT; false reads window key and button messages
+    float gamepadPollInterval = 1.0f; // Seconds between checks for a gamepad in an empty slot
     std::unordered_map<std::string, int> keyBindings;
 };
 
@@ -40,6 +60,32 @@ struct EngineSettings {
     bool enableLogging = true;
     bool enableDebugOutput = false;
     int maxLogFileSize = 10; // MB
+    int workerThreadCount = 0; // 0 = one per hardware thread
+    bool fixedTimestep = false; // Simulate in fixed steps (OnFixedUpdate) and interpolate transforms for rendering
+    int fixedUpdateRate = 60; // Fixed steps per second
+    int maxFixedSteps = 5; // Steps per frame before simulation time is dropped to catch up
+    bool parallelComponentUpdate = true; // Run non-conflicting component systems on the job system; off keeps type order
+    int componentUpdateBatchSize = 64; // Components per job for types that update in chunks
+    bool hotReload = true; // Watch assets, shaders and this file, reloading them when they change on disk
+    int meshMemoryBudgetMB = 1024; // CPU + GPU per subsystem before a warning is logged, 0 disables
+    int textureMemoryBudgetMB = 2048;
+    int animationMemoryBudgetMB = 256;
+    int sceneMemoryBudgetMB = 512;
+    int xmlMemoryBudgetMB = 64;
+    int logMemoryBudgetMB = 32;
+    int rendererMemoryBudgetMB = 1024;
+};
+
+struct AnimationSettings {
+    bool enableLOD = true;
+    bool cullOffscreen = true;           // Off-screen characters advance time without sampling
+    float halfRateScreenSize = 0.25f;    // Screen height fractions below which each tier starts
+    float quarterRateScreenSize = 0.1f;
+    float reducedScreenSize = 0.04f;
+    int reducedChannelCount = 16;        // Channels still sampled at the reduced tier
+    bool compressClips = true;           // Quantize and reduce keyframes when clips are registered
+    bool parallelUpdate = true;          // Evaluate controllers on the job system before other components
+    int updateBatchSize = 4;             // Minimum controllers per job
 };
 
 class ConfigManager {
@@ -56,16 +102,20 @@ public:
     const AssetSettings& GetAssetSettings() const { return m_assetSettings; }
     const InputSettings& GetInputSettings() const { return m_inputSettings; }
     const EngineSettings& GetEngineSettings() const { return m_engineSettings; }
+    const AnimationSettings& GetAnimationSettings() const { return m_animationSettings; }
 
     // Settings modification
     void SetGraphicsSettings(const GraphicsSettings& settings);
     void SetAssetSettings(const AssetSettings& settings);
     void SetInputSettings(const InputSettings& settings);
     void SetEngineSettings(const EngineSettings& settings);
+    void SetAnimationSettings(const AnimationSettings& settings);
 
-    // Individual setting access
+    // Custom settings. Values are converted once when set or loaded and
+    // looked up by hashed name, so numeric reads never allocate and are
+    // fine in per-frame code; literals hash at compile time.
     template<typename T>
-    T GetSetting(const std::string& category, const std::string& key, const T& defaultValue = T{});
+    T GetSetting(StringId category, StringId key, const T& defaultValue = T{}) const;
 
     template<typename T>
     void SetSetting(const std::string& category, const std::string& key, const T& value);
@@ -97,48 +147,64 @@ private:
     void SerializeAssetSettings(XmlNode& parentNode);
     void SerializeInputSettings(XmlNode& parentNode);
     void SerializeEngineSettings(XmlNode& parentNode);
+    void SerializeAnimationSettings(XmlNode& parentNode);
 
     void DeserializeGraphicsSettings(const XmlNode& parentNode);
     void DeserializeAssetSettings(const XmlNode& parentNode);
     void DeserializeInputSettings(const XmlNode& parentNode);
     void DeserializeEngineSettings(const XmlNode& parentNode);
+    void DeserializeAnimationSettings(const XmlNode& parentNode);
 
     // Default initialization
     void InitializeDefaultSettings();
 
+    // Custom setting with its pre-converted forms
+    struct SettingValue {
+        std::string text;
+        int intValue = 0;
+        float floatValue = 0.0f;
+        bool boolValue = false;
+        bool isInt = false;
+        bool isFloat = false;
+    };
+
+    static std::uint64_t GetSettingKey(StringId category, StringId key) {
+        return (std::uint64_t(category.GetHash()) << 32) | key.GetHash();
+    }
+    void StoreSetting(const std::string& category, const std::string& key, const std::string& value);
+
 private:
     GraphicsSettings m_graphicsSettings;
     AssetSettings m_assetSettings;
     InputSettings m_inputSettings;
     EngineSettings m_engineSettings;
+    AnimationSettings m_animationSettings;
 
     std::string m_configFile = "config.xml";
     bool m_settingsLoaded = false;
 
-    // Additional runtime settings
+    // Additional runtime settings, by name for saving and by hash for lookups
     std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_customSettings;
+    std::unordered_map<std::uint64_t, SettingValue> m_settingTable;
 };
 
 // Template implementations
 template<typename T>
-T ConfigManager::GetSetting(const std::string& category, const std::string& key, const T& defaultValue) {
-    auto categoryIt = m_customSettings.find(category);
-    if (categoryIt != m_customSettings.end()) {
-        auto keyIt = categoryIt->second.find(key);
-        if (keyIt != categoryIt->second.end()) {
-            // Convert string to T - basic implementation
-            if constexpr (std::is_same_v<T, std::string>) {
-                return keyIt->second;
-            } else if constexpr (std::is_same_v<T, int>) {
-                try { return std::stoi(keyIt->second); }
-                catch (...) { return defaultValue; }
-            } else if constexpr (std::is_same_v<T, float>) {
-                try { return std::stof(keyIt->second); }
-                catch (...) { return defaultValue; }
-            } else if constexpr (std::is_same_v<T, bool>) {
-                return keyIt->second == "true" || keyIt->second == "1";
-            }
-        }
+T ConfigManager::GetSetting(StringId category, StringId key, const T& defaultValue) const {
+    auto it = m_settingTable.find(GetSettingKey(category, key));
+    if (it == m_settingTable.end()) {
+        return defaultValue;
+    }
+
+    const SettingValue& value = it->second;
+    if constexpr (std::is_same_v<T, std::string>) {
+        return value.text;
+    } else if constexpr (std::is_same_v<T, int>) {
+        return value.isInt ? value.intValue : defaultValue;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return value.isFloat ? value.floatValue : defaultValue;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return value.boolValue;
     }
     return defaultValue;
 }
@@ -157,7 +223,7 @@ void ConfigManager::SetSetting(const std::string& category, const std::string& k
         stringValue = value ? "true" : "false";
     }
 
-    m_customSettings[category][key] = stringValue;
+    StoreSetting(category, key, stringValue);
 }
 
 // Convenience macro
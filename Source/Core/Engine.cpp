@@ -1,7 +1,18 @@
 #include "Engine.h"
 #include "ConfigManager.h"
+#include "FileSystem.h"
 #include "SettingsInterface.h"
+#include "JobSystem.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include "../Renderer/Texture.h"
+#include "../Scene/SceneManager.h"
+#include "../Input/InputManager.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
 
 namespace GameEngine {
 namespace Core {
@@ -20,6 +31,11 @@ Engine::Engine()
     , m_fov(DirectX::XM_PIDIV4)
     , m_nearPlane(0.1f)
     , m_farPlane(1000.0f)
+    , m_fixedTimestep(false)
+    , m_fixedDeltaTime(1.0f / 60.0f)
+    , m_fixedAccumulator(0.0f)
+    , m_interpolationAlpha(1.0f)
+    , m_maxFixedSteps(5)
     , m_frameTimeAccumulator(0.0f)
     , m_frameCount(0)
 {
@@ -67,6 +83,18 @@ bool Engine::Initialize(HINSTANCE hInstance, const std::string& configFile) {
     Logger::GetInstance().SetEnabled(engineSettings.enableLogging);
 
     LOG_INFO("Configuration loaded from: " + configFile);
+    m_startupMemory = MEMORY_TRACKER.TakeSnapshot();
+
+    // Start worker threads before any subsystem wants to fan out
+    if (!JOB_SYSTEM.Initialize(static_cast<unsigned int>(std::max(engineSettings.workerThreadCount, 0)))) {
+        LOG_WARNING("Job system unavailable, running single-threaded");
+    }
+
+    // Packed assets shadow the loose files before anything is loaded
+    if (!assetSettings.archiveFile.empty() &&
+        !FILE_SYSTEM.MountArchive(assetSettings.archiveFile, assetSettings.assetsDirectory)) {
+        LOG_WARNING("Asset archive unavailable, using loose files: " + assetSettings.archiveFile);
+    }
 
     // Create and initialize window
     m_window = std::make_unique<Window>();
@@ -83,6 +111,12 @@ bool Engine::Initialize(HINSTANCE hInstance, const std::string& configFile) {
     m_window->OnKeyboard = [this](int key, bool isDown) { OnKeyboard(key, isDown); };
     m_window->OnMouseMove = [this](int x, int y, bool dragging) { OnMouseMove(x, y, dragging); };
     m_window->OnMouseButton = [this](int button, bool isDown) { OnMouseButton(button, isDown); };
+    m_window->OnMessage = [](UINT message, WPARAM wParam, LPARAM lParam) {
+        Input::InputManager::GetInstance().HandleWindowMessage(message, wParam, lParam);
+    };
+
+    // Keys, buttons and the mouse arrive as queued window messages from here on
+    Input::InputManager::GetInstance().Initialize(m_window->GetHandle(), CONFIG_MANAGER.GetInputSettings().rawInput);
 
     // Create and initialize renderer
     m_renderer = std::make_unique<Renderer::D3D11Renderer>();
@@ -94,6 +128,17 @@ bool Engine::Initialize(HINSTANCE hInstance, const std::string& configFile) {
         return false;
     }
 
+    // Loads from any thread, including the loader threads, go through its cache
+    MESH_MANAGER.Initialize(m_renderer.get());
+
+    // Background asset loading; without it async loads complete synchronously
+    if (!ASYNC_LOADER.Initialize(m_renderer.get(), static_cast<unsigned int>(assetSettings.loaderThreadCount))) {
+        LOG_WARNING("Async loader unavailable, assets will load on the main thread");
+    }
+
+    // Streamed world cells load their material textures through it
+    SCENE_MANAGER.GetWorldStreamer().SetRenderer(m_renderer.get());
+
     // Create and initialize timer
     m_timer = std::make_unique<Timer>();
     m_timer->Start();
@@ -106,6 +151,13 @@ bool Engine::Initialize(HINSTANCE hInstance, const std::string& configFile) {
     SETTINGS_INTERFACE.Initialize(m_window.get(), m_renderer.get());
     SETTINGS_INTERFACE.ApplyAllSettings();
 
+    ApplyTimestepSettings();
+    ApplyMemoryBudgets();
+
+    if (engineSettings.hotReload) {
+        StartHotReload();
+    }
+
     // Call derived class initialization
     if (!OnInitialize()) {
         LOG_ERROR("Derived class initialization failed");
@@ -185,6 +237,8 @@ void Engine::ReloadConfiguration() {
             CONFIG_MANAGER.RestoreConfigBackup();
         } else {
             LOG_INFO("Configuration reloaded successfully");
+            ApplyTimestepSettings();
+            ApplyMemoryBudgets();
             OnConfigurationChanged();
         }
     } else {
@@ -217,6 +271,13 @@ void Engine::Run() {
             continue;
         }
 
+        // Hold the frame until the swap chain has room, so input and
+        // simulation are as fresh as possible when the frame is shown
+        m_renderer->WaitForFrame();
+
+        // Waiting is idle time, so the profiled frame starts here
+        PROFILER.BeginFrame();
+
         // Update timer
         m_timer->Update();
 
@@ -226,6 +287,9 @@ void Engine::Run() {
         // Render frame
         Render();
 
+        PROFILER.EndFrame();
+        MEMORY_TRACKER.EndFrame();
+
         // Performance tracking
         m_frameTimeAccumulator += m_timer->GetDeltaTime();
         m_frameCount++;
@@ -252,11 +316,18 @@ void Engine::Shutdown() {
     OnShutdown();
 
     // Shutdown systems in reverse order
+    m_fileWatcher.reset();
+    ASYNC_LOADER.Shutdown();
+    MESH_MANAGER.Shutdown();
+    TEXTURE_MANAGER.UnloadAll();
+
     if (m_renderer) {
         m_renderer->Shutdown();
         m_renderer.reset();
     }
 
+    Input::InputManager::GetInstance().Shutdown();
+
     if (m_window) {
         m_window->Shutdown();
         m_window.reset();
@@ -264,6 +335,13 @@ void Engine::Shutdown() {
 
     m_timer.reset();
 
+    // Stop workers after every system that might still queue jobs is gone
+    JOB_SYSTEM.Shutdown();
+    FILE_SYSTEM.UnmountAllArchives();
+
+    // Every system above is gone, so growth since startup is what leaked
+    MEMORY_TRACKER.LogSnapshot(MEMORY_TRACKER.TakeSnapshot(), &m_startupMemory);
+
     // Save configuration before shutdown
     if (m_configurationLoaded && !m_configFile.empty()) {
         SaveConfiguration(m_configFile);
@@ -278,30 +356,174 @@ void Engine::Shutdown() {
 }
 
 void Engine::Update() {
+    PROFILE_SCOPE("Update");
     float deltaTime = m_timer->GetDeltaTime();
 
-    // Update window title with FPS
+    // Apply the input queued since the last frame
+    Input::InputManager::GetInstance().Update();
+
+    // Update window title with FPS and the last frame's CPU/GPU split
     static float titleUpdateTimer = 0.0f;
     titleUpdateTimer += deltaTime;
     if (titleUpdateTimer >= 1.0f) {
-        std::string title = "DX11 Game Engine - FPS: " + std::to_string(static_cast<int>(m_timer->GetFPS()));
+        const ProfileFrameStats& stats = PROFILER.GetFrameStats();
+        char timings[64];
+        snprintf(timings, sizeof(timings), " - CPU %.2f ms, GPU %.2f ms", stats.cpuMilliseconds, stats.gpuMilliseconds);
+        std::string title = "DX11 Game Engine - FPS: " + std::to_string(static_cast<int>(m_timer->GetFPS())) + timings;
         m_window->SetTitle(title);
         titleUpdateTimer = 0.0f;
     }
 
+    // Reload files that changed on disk
+    if (m_fileWatcher) {
+        m_fileWatcher->Update();
+    }
+
+    // Hand finished background loads to their owners
+    ASYNC_LOADER.Update();
+
+    // Cached assets nothing uses any more go once the caches are over budget
+    MESH_MANAGER.TrimCache(static_cast<size_t>(CONFIG_MANAGER.GetAssetSettings().maxCacheSize) * 1024 * 1024);
+    TEXTURE_MANAGER.TrimCache(static_cast<size_t>(CONFIG_MANAGER.GetGraphicsSettings().textureBudgetMB) * 1024 * 1024);
+
+    if (m_fixedTimestep) {
+        FixedUpdate(deltaTime);
+    }
+
     // Call derived class update
     OnUpdate(deltaTime);
 }
 
+void Engine::FixedUpdate(float deltaTime) {
+    PROFILE_SCOPE("FixedUpdate");
+    // A hitch (breakpoint, window drag) would otherwise be simulated all at once
+    const float MAX_FRAME_TIME = 0.25f;
+    m_fixedAccumulator += std::min(deltaTime, MAX_FRAME_TIME);
+
+    int steps = 0;
+    while (m_fixedAccumulator >= m_fixedDeltaTime && steps < m_maxFixedSteps) {
+        SCENE_MANAGER.FixedUpdate(m_fixedDeltaTime);
+        OnFixedUpdate(m_fixedDeltaTime);
+        m_fixedAccumulator -= m_fixedDeltaTime;
+        steps++;
+    }
+
+    // Still behind after the step budget: drop the time instead of spiralling
+    if (m_fixedAccumulator >= m_fixedDeltaTime) {
+        LOG_DEBUG("Fixed timestep fell behind, dropping " << (m_fixedAccumulator * 1000.0f) << "ms");
+        m_fixedAccumulator = std::fmod(m_fixedAccumulator, m_fixedDeltaTime);
+    }
+
+    m_interpolationAlpha = m_fixedAccumulator / m_fixedDeltaTime;
+    SCENE_MANAGER.SetInterpolationAlpha(m_interpolationAlpha);
+}
+
+void Engine::ApplyTimestepSettings() {
+    const auto& engineSettings = CONFIG_MANAGER.GetEngineSettings();
+    m_fixedTimestep = engineSettings.fixedTimestep;
+    m_fixedDeltaTime = 1.0f / static_cast<float>(std::max(engineSettings.fixedUpdateRate, 1));
+    m_maxFixedSteps = std::max(engineSettings.maxFixedSteps, 1);
+    m_fixedAccumulator = 0.0f;
+    m_interpolationAlpha = 1.0f;
+
+    if (m_fixedTimestep) {
+        LOG_INFO("Fixed timestep: " << engineSettings.fixedUpdateRate << " Hz, up to " << m_maxFixedSteps << " steps per frame");
+    }
+}
+
+void Engine::ApplyMemoryBudgets() {
+    const auto& engineSettings = CONFIG_MANAGER.GetEngineSettings();
+    const std::int64_t megabyte = 1024 * 1024;
+    auto& tracker = MEMORY_TRACKER;
+    tracker.SetBudget(MemoryCategory::Meshes, engineSettings.meshMemoryBudgetMB * megabyte);
+    tracker.SetBudget(MemoryCategory::Textures, engineSettings.textureMemoryBudgetMB * megabyte);
+    tracker.SetBudget(MemoryCategory::Animations, engineSettings.animationMemoryBudgetMB * megabyte);
+    tracker.SetBudget(MemoryCategory::Scene, engineSettings.sceneMemoryBudgetMB * megabyte);
+    tracker.SetBudget(MemoryCategory::Xml, engineSettings.xmlMemoryBudgetMB * megabyte);
+    tracker.SetBudget(MemoryCategory::Logs, engineSettings.logMemoryBudgetMB * megabyte);
+    tracker.SetBudget(MemoryCategory::Renderer, engineSettings.rendererMemoryBudgetMB * megabyte);
+
+    if (!MemoryTracker::IsHeapTracked()) {
+        LOG_INFO("Heap tracking is compiled out, memory budgets only cover GPU resources");
+    }
+}
+
+void Engine::StartHotReload() {
+    const auto& assetSettings = CONFIG_MANAGER.GetAssetSettings();
+    m_fileWatcher = std::make_unique<FileWatcher>();
+
+    const std::string shaderDirectory = "Shaders";
+    bool watchingAssets = m_fileWatcher->AddDirectory(assetSettings.assetsDirectory);
+    bool watchingShaders = m_fileWatcher->AddDirectory(shaderDirectory);
+
+    std::string configDirectory;
+    if (!m_configFile.empty()) {
+        configDirectory = std::filesystem::path(m_configFile).parent_path().string();
+        m_fileWatcher->AddDirectory(configDirectory.empty() ? "." : configDirectory, false);
+    }
+
+    if (!m_fileWatcher->Start()) {
+        LOG_WARNING("Hot reload unavailable");
+        m_fileWatcher.reset();
+        return;
+    }
+
+    // Removed files keep their last loaded version until something replaces them
+    if (!m_configFile.empty()) {
+        m_fileWatcher->SubscribeFile(m_configFile, [this](const FileChange& change) {
+            if (change.type != FileChangeType::Removed) {
+                ReloadConfiguration();
+            }
+        });
+    }
+
+    if (watchingShaders) {
+        m_fileWatcher->Subscribe(shaderDirectory, { "hlsl", "hlsli", "txt" }, [this](const FileChange& change) {
+            if (change.type == FileChangeType::Removed) {
+                return;
+            }
+            LOG_INFO("Shader changed: " << change.path);
+            m_renderer->GetShaderCache().Clear();
+            OnAssetReloaded(change.path);
+        });
+    }
+
+    if (watchingAssets) {
+        m_fileWatcher->Subscribe(assetSettings.assetsDirectory, { "dds", "png", "jpg", "jpeg", "bmp", "tga", "tif", "tiff" },
+            [this](const FileChange& change) {
+                if (change.type != FileChangeType::Removed &&
+                    TEXTURE_MANAGER.ReloadTexture(std::filesystem::path(change.path).wstring(), m_renderer->GetDevice())) {
+                    OnAssetReloaded(change.path);
+                }
+            });
+
+        m_fileWatcher->Subscribe(assetSettings.assetsDirectory, { "fbx", "obj", "gltf", "glb", "dae", "3ds", "blend" },
+            [this](const FileChange& change) {
+                if (change.type != FileChangeType::Removed && MESH_MANAGER.ReloadMesh(change.path)) {
+                    OnAssetReloaded(change.path);
+                }
+            });
+    }
+}
+
 void Engine::Render() {
+    PROFILE_SCOPE("Render");
+
     // Begin frame
     m_renderer->BeginFrame(0.1f, 0.1f, 0.2f, 1.0f); // Dark blue background
 
-    // Call derived class render
+    // Publish camera matrices for scene rendering
+    m_renderer->SetViewProjection(m_viewMatrix, m_projectionMatrix);
+
+    // Call derived class render. No GPU scope around it: the passes it
+    // records are the top-level scopes the overlay and frame stats total.
     OnRender();
 
     // End frame
     m_renderer->EndFrame();
+
+    // Act on the mip feedback gathered while rendering
+    TEXTURE_MANAGER.UpdateStreaming(m_renderer->GetDevice(), m_renderer->GetContext());
 }
 
 void Engine::OnWindowResize(int width, int height) {
@@ -382,6 +604,13 @@ void Engine::OnKeyboard(int key, bool isDown) {
         // Toggle VSync
         SETTINGS_INTERFACE.ToggleVSync();
     }
+    else if (key == VK_F3) {
+        m_renderer->SetProfilerOverlayEnabled(!m_renderer->IsProfilerOverlayEnabled());
+    }
+    else if (key == VK_F4) {
+        // Trace of the next few seconds for chrome://tracing
+        PROFILER.StartCapture(300, "profile.json");
+    }
 
     // Handle additional game-specific keys
     switch (key) {
@@ -396,6 +625,8 @@ void Engine::OnKeyboard(int key, bool isDown) {
             LOG_INFO("Performance:");
             LOG_INFO("  F11: Toggle fullscreen");
             LOG_INFO("  F2: Toggle VSync");
+            LOG_INFO("  F3: Toggle profiler overlay");
+            LOG_INFO("  F4: Capture 300 frames to profile.json (Chrome trace)");
             LOG_INFO("");
             LOG_INFO("System:");
             LOG_INFO("  F5: Reload configuration");
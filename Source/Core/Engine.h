@@ -6,6 +6,8 @@
 #include "Logger.h"
 #include "Window.h"
 #include "ConfigManager.h"
+#include "FileWatcher.h"
+#include "MemoryTracker.h"
 #include "../Renderer/D3D11Renderer.h"
 #include "../Mesh/MeshManager.h"
 #include "../Math/Matrix4.h"
@@ -42,6 +44,8 @@ public:
     Renderer::D3D11Renderer& GetRenderer() { return *m_renderer; }
     Timer& GetTimer() { return *m_timer; }
     Mesh::MeshManager& GetMeshManager() { return Mesh::MeshManager::GetInstance(); }
+    // Null unless EngineSettings::hotReload is on
+    FileWatcher* GetFileWatcher() { return m_fileWatcher.get(); }
 
     bool IsRunning() const { return m_isRunning; }
     void SetRunning(bool running) { m_isRunning = running; }
@@ -58,10 +62,21 @@ public:
     const Math::Matrix4& GetViewMatrix() const { return m_viewMatrix; }
     const Math::Matrix4& GetProjectionMatrix() const { return m_projectionMatrix; }
 
+    // Fixed-timestep simulation (EngineSettings::fixedTimestep)
+    bool IsFixedTimestep() const { return m_fixedTimestep; }
+    float GetFixedDeltaTime() const { return m_fixedDeltaTime; }
+    // Fraction of a fixed step accumulated since the last one, already handed
+    // to SceneManager::SetInterpolationAlpha
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+
 protected:
     // Virtual methods for game logic
     virtual bool OnInitialize() { return true; }
     virtual void OnUpdate(float deltaTime) {}
+    // Called zero or more times per frame with a constant step when fixed
+    // timestep is enabled, before OnUpdate and right after each
+    // SceneManager::FixedUpdate; drive game simulation from here
+    virtual void OnFixedUpdate(float fixedDeltaTime) {}
     virtual void OnRender() {}
     virtual void OnShutdown() {}
 
@@ -72,6 +87,9 @@ protected:
     virtual void OnMouseMove(int x, int y, bool dragging);
     virtual void OnMouseButton(int button, bool isDown);
     virtual void OnConfigurationChanged() {}  // Called when config is reloaded
+    // Called after hot reload handled a changed shader, texture or mesh file;
+    // shaders are only recompiled when the game loads them again
+    virtual void OnAssetReloaded(const std::string& path) {}
 
     virtual ~Engine();
 
@@ -80,6 +98,10 @@ protected:
     Engine& operator=(const Engine&) = delete;
 
     void Update();
+    void FixedUpdate(float deltaTime);
+    void ApplyTimestepSettings();
+    void ApplyMemoryBudgets();
+    void StartHotReload();
     void Render();
     void UpdateViewMatrix();
     void UpdateProjectionMatrix();
@@ -88,6 +110,7 @@ protected:
     std::unique_ptr<Window> m_window;
     std::unique_ptr<Renderer::D3D11Renderer> m_renderer;
     std::unique_ptr<Timer> m_timer;
+    std::unique_ptr<FileWatcher> m_fileWatcher;
 
     // Engine state
     bool m_isRunning;
@@ -107,9 +130,19 @@ protected:
     float m_nearPlane;
     float m_farPlane;
 
+    // Fixed timestep
+    bool m_fixedTimestep;
+    float m_fixedDeltaTime;
+    float m_fixedAccumulator;
+    float m_interpolationAlpha;
+    int m_maxFixedSteps;
+
     // Performance tracking
     float m_frameTimeAccumulator;
     int m_frameCount;
+
+    // Memory once logging is up; what remains above it at shutdown was never freed
+    MemorySnapshot m_startupMemory;
 };
 
 } // namespace Core
@@ -1,8 +1,11 @@
 #include "FileSystem.h"
+#include "AssetArchive.h"
 #include "Logger.h"
 #include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <regex>
+#include <unordered_set>
 
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
@@ -18,16 +21,150 @@
 #undef CopyFile
 #undef MoveFile
 #undef GetCurrentDirectory
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 using namespace GameEngine::Core;
 
+namespace {
+
+// Both normalized; every path is under the empty root
+bool IsUnderDirectory(const std::string& path, const std::string& directory) {
+    return directory.empty() || (path.size() > directory.size()
+        && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/');
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    Open(path);
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_owner, other.m_owner);
+#ifdef _WIN32
+        std::swap(m_file, other.m_file);
+        std::swap(m_mapping, other.m_mapping);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+    if (FileSystem::GetInstance().OpenFromArchive(path, *this)) {
+        return true;
+    }
+    return OpenOnDisk(path);
+}
+
+bool MappedFile::OpenOnDisk(const std::filesystem::path& path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        Close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        Close();
+        return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    // The mapping keeps the file alive, so the descriptor can go right away
+    struct stat status;
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+        void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const uint8_t*>(data);
+            m_size = static_cast<size_t>(status.st_size);
+        }
+    }
+    close(descriptor);
+#endif
+
+    return m_data != nullptr;
+}
+
+void MappedFile::Close() {
+    if (m_owner) {
+        // Borrowed from an archive; nothing of our own is mapped
+        m_owner.reset();
+        m_data = nullptr;
+        m_size = 0;
+        return;
+    }
+
+#ifdef _WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
 FileSystem& FileSystem::GetInstance() {
     static FileSystem instance;
     return instance;
 }
 
 bool FileSystem::FileExists(const std::string& path) const {
+    ArchiveLookup lookup;
+    if (FindInArchives(path, lookup)) {
+        return true;
+    }
+
     try {
         return std::filesystem::exists(path) && std::filesystem::is_regular_file(path);
     } catch (const std::filesystem::filesystem_error& e) {
@@ -168,6 +305,16 @@ bool FileSystem::MoveFile(const std::string& source, const std::string& destinat
 }
 
 bool FileSystem::ReadTextFile(const std::string& path, std::string& outContent) const {
+    ArchiveLookup lookup;
+    if (FindInArchives(path, lookup)) {
+        std::vector<uint8_t> data;
+        if (!lookup.archive->Read(*lookup.entry, data)) {
+            return false;
+        }
+        outContent.assign(data.begin(), data.end());
+        return true;
+    }
+
     try {
         auto file = OpenFileForReading(path, FileMode::Read);
         if (!file || !file->is_open()) {
@@ -211,6 +358,11 @@ bool FileSystem::WriteTextFile(const std::string& path, const std::string& conte
 }
 
 bool FileSystem::ReadBinaryFile(const std::string& path, std::vector<uint8_t>& outData) const {
+    ArchiveLookup lookup;
+    if (FindInArchives(path, lookup)) {
+        return lookup.archive->Read(*lookup.entry, outData);
+    }
+
     try {
         auto file = OpenFileForReading(path, FileMode::ReadBinary);
         if (!file || !file->is_open()) {
@@ -253,6 +405,106 @@ bool FileSystem::WriteBinaryFile(const std::string& path, const std::vector<uint
     }
 }
 
+MappedFile FileSystem::MapFile(const std::string& path) const {
+    MappedFile file(path);
+    if (!file.IsValid()) {
+        Logger::GetInstance().LogError("FileSystem::MapFile - Cannot map file: " + path);
+    }
+    return file;
+}
+
+size_t FileSystem::ReadBinaryFiles(const std::vector<std::string>& paths, std::vector<std::vector<uint8_t>>& outData) const {
+    outData.clear();
+    outData.resize(paths.size());
+    size_t readCount = 0;
+
+    std::vector<size_t> diskReads;
+    for (size_t i = 0; i < paths.size(); i++) {
+        ArchiveLookup lookup;
+        if (!FindInArchives(paths[i], lookup)) {
+            diskReads.push_back(i);
+        }
+        else if (lookup.archive->Read(*lookup.entry, outData[i])) {
+            readCount++;
+        }
+    }
+
+#ifdef _WIN32
+    // Overlapped reads, one batch of handles in flight at a time
+    constexpr size_t BATCH_SIZE = 64;
+
+    struct PendingRead {
+        HANDLE file = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        bool issued = false;
+    };
+
+    for (size_t first = 0; first < diskReads.size(); first += BATCH_SIZE) {
+        size_t count = std::min(BATCH_SIZE, diskReads.size() - first);
+        std::vector<PendingRead> reads(count);
+
+        for (size_t i = 0; i < count; i++) {
+            PendingRead& read = reads[i];
+            std::vector<uint8_t>& data = outData[diskReads[first + i]];
+            std::wstring widePath = std::filesystem::path(paths[diskReads[first + i]]).wstring();
+
+            read.file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+            LARGE_INTEGER size;
+            if (read.file == INVALID_HANDLE_VALUE || !GetFileSizeEx(read.file, &size) || size.QuadPart > MAXDWORD) {
+                continue;
+            }
+            if (size.QuadPart == 0) {
+                readCount++;
+                continue;
+            }
+
+            data.resize(static_cast<size_t>(size.QuadPart));
+            read.overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+            if (!read.overlapped.hEvent) {
+                data.clear();
+                continue;
+            }
+
+            BOOL done = ReadFile(read.file, data.data(), static_cast<DWORD>(data.size()), nullptr, &read.overlapped);
+            read.issued = done || GetLastError() == ERROR_IO_PENDING;
+            if (!read.issued) {
+                data.clear();
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            PendingRead& read = reads[i];
+            std::vector<uint8_t>& data = outData[diskReads[first + i]];
+            if (read.issued) {
+                DWORD transferred = 0;
+                if (GetOverlappedResult(read.file, &read.overlapped, &transferred, TRUE) && transferred == data.size()) {
+                    readCount++;
+                }
+                else {
+                    Logger::GetInstance().LogError("FileSystem::ReadBinaryFiles - Read failed: " + paths[diskReads[first + i]]);
+                    data.clear();
+                }
+            }
+            if (read.overlapped.hEvent) {
+                CloseHandle(read.overlapped.hEvent);
+            }
+            if (read.file != INVALID_HANDLE_VALUE) {
+                CloseHandle(read.file);
+            }
+        }
+    }
+#else
+    for (size_t index : diskReads) {
+        if (ReadBinaryFile(paths[index], outData[index])) {
+            readCount++;
+        }
+    }
+#endif
+
+    return readCount;
+}
+
 std::unique_ptr<std::ifstream> FileSystem::OpenFileForReading(const std::string& path, FileMode mode) const {
     auto file = std::make_unique<std::ifstream>(path, GetOpenMode(mode));
     if (!file->is_open()) {
@@ -285,6 +537,11 @@ FileInfo FileSystem::GetFileInfo(const std::string& path) const {
 }
 
 size_t FileSystem::GetFileSize(const std::string& path) const {
+    ArchiveLookup lookup;
+    if (FindInArchives(path, lookup)) {
+        return static_cast<size_t>(lookup.entry->size);
+    }
+
     try {
         if (!FileExists(path)) {
             return 0;
@@ -297,6 +554,12 @@ size_t FileSystem::GetFileSize(const std::string& path) const {
 }
 
 std::filesystem::file_time_type FileSystem::GetLastWriteTime(const std::string& path) const {
+    // Archived files all date from when their archive was written
+    ArchiveLookup lookup;
+    if (FindInArchives(path, lookup)) {
+        return lookup.writeTime;
+    }
+
     try {
         if (!FileExists(path) && !DirectoryExists(path)) {
             return std::filesystem::file_time_type{};
@@ -312,6 +575,24 @@ std::vector<std::string> FileSystem::GetFilesInDirectory(const std::string& path
     const std::string& extension, bool recursive) const {
     std::vector<std::string> files;
 
+    // Archived files first; loose copies of them are not listed twice
+    std::vector<std::string> archived;
+    ListArchiveFiles(path, recursive, archived);
+    std::unordered_set<std::string> archivedPaths;
+    for (const auto& filePath : archived) {
+        if (extension.empty() || GetFileExtension(filePath) == extension) {
+            files.push_back(filePath);
+        }
+        archivedPaths.insert(AssetArchive::NormalizePath(filePath));
+    }
+
+    auto addFile = [&](const std::string& filePath) {
+        if ((extension.empty() || GetFileExtension(filePath) == extension)
+            && (archivedPaths.empty() || archivedPaths.count(AssetArchive::NormalizePath(filePath)) == 0)) {
+            files.push_back(filePath);
+        }
+    };
+
     try {
         if (!DirectoryExists(path)) {
             return files;
@@ -320,21 +601,13 @@ std::vector<std::string> FileSystem::GetFilesInDirectory(const std::string& path
         if (recursive) {
             for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
                 if (entry.is_regular_file()) {
-                    std::string filePath = entry.path().string();
-
-                    if (extension.empty() || GetFileExtension(filePath) == extension) {
-                        files.push_back(filePath);
-                    }
+                    addFile(entry.path().string());
                 }
             }
         } else {
             for (const auto& entry : std::filesystem::directory_iterator(path)) {
                 if (entry.is_regular_file()) {
-                    std::string filePath = entry.path().string();
-
-                    if (extension.empty() || GetFileExtension(filePath) == extension) {
-                        files.push_back(filePath);
-                    }
+                    addFile(entry.path().string());
                 }
             }
         }
@@ -485,22 +758,33 @@ std::vector<std::string> FileSystem::FindFiles(const std::string& pattern,
     try {
         std::regex regexPattern(pattern, std::regex_constants::icase);
 
+        std::vector<std::string> archived;
+        ListArchiveFiles(actualSearchPath, recursive, archived);
+        std::unordered_set<std::string> archivedPaths;
+        for (const auto& filePath : archived) {
+            if (std::regex_match(GetFileName(filePath), regexPattern)) {
+                foundFiles.push_back(filePath);
+            }
+            archivedPaths.insert(AssetArchive::NormalizePath(filePath));
+        }
+
+        auto addFile = [&](const std::filesystem::path& filePath) {
+            if (std::regex_match(filePath.filename().string(), regexPattern)
+                && (archivedPaths.empty() || archivedPaths.count(AssetArchive::NormalizePath(filePath.string())) == 0)) {
+                foundFiles.push_back(filePath.string());
+            }
+        };
+
         if (recursive) {
             for (const auto& entry : std::filesystem::recursive_directory_iterator(actualSearchPath)) {
                 if (entry.is_regular_file()) {
-                    std::string filename = entry.path().filename().string();
-                    if (std::regex_match(filename, regexPattern)) {
-                        foundFiles.push_back(entry.path().string());
-                    }
+                    addFile(entry.path());
                 }
             }
         } else {
             for (const auto& entry : std::filesystem::directory_iterator(actualSearchPath)) {
                 if (entry.is_regular_file()) {
-                    std::string filename = entry.path().filename().string();
-                    if (std::regex_match(filename, regexPattern)) {
-                        foundFiles.push_back(entry.path().string());
-                    }
+                    addFile(entry.path());
                 }
             }
         }
@@ -549,6 +833,133 @@ bool FileSystem::HasFileChanged(const std::string& path, std::filesystem::file_t
     return false;
 }
 
+bool FileSystem::MountArchive(const std::string& archivePath, const std::string& mountPoint) {
+    auto archive = std::make_shared<AssetArchive>();
+    if (!archive->Open(archivePath)) {
+        return false;
+    }
+
+    ArchiveMount mount;
+    mount.archive = archive;
+    mount.mountPoint = AssetArchive::NormalizePath(mountPoint);
+    mount.absoluteMountPoint = AssetArchive::NormalizePath(GetAbsolutePath(mountPoint));
+    mount.originalMountPoint = mountPoint;
+    try {
+        mount.writeTime = std::filesystem::last_write_time(archivePath);
+    } catch (const std::filesystem::filesystem_error&) {
+        mount.writeTime = std::filesystem::file_time_type{};
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_archiveMutex);
+    m_archives.push_back(std::move(mount));
+
+    Logger::GetInstance().LogInfo("Mounted archive " + archivePath + " at " + mountPoint);
+    return true;
+}
+
+void FileSystem::UnmountAllArchives() {
+    // Files opened from an archive keep it mapped until they close
+    std::unique_lock<std::shared_mutex> lock(m_archiveMutex);
+    m_archives.clear();
+}
+
+size_t FileSystem::GetMountedArchiveCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_archiveMutex);
+    return m_archives.size();
+}
+
+bool FileSystem::FindInArchives(const std::filesystem::path& path, ArchiveLookup& outLookup) const {
+    std::shared_lock<std::shared_mutex> lock(m_archiveMutex);
+    if (m_archives.empty()) {
+        return false;
+    }
+
+    std::string normalized = AssetArchive::NormalizePath(path.generic_u8string());
+    bool absolute = path.is_absolute();
+    for (auto it = m_archives.rbegin(); it != m_archives.rend(); ++it) {
+        const std::string& mountPoint = absolute ? it->absoluteMountPoint : it->mountPoint;
+        if (!IsUnderDirectory(normalized, mountPoint)) {
+            continue;
+        }
+
+        std::string_view relative = normalized;
+        relative.remove_prefix(mountPoint.empty() ? 0 : mountPoint.size() + 1);
+
+        if (const ArchiveEntry* entry = it->archive->FindEntry(relative)) {
+            outLookup.archive = it->archive;
+            outLookup.entry = entry;
+            outLookup.writeTime = it->writeTime;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FileSystem::OpenFromArchive(const std::filesystem::path& path, MappedFile& outFile) const {
+    ArchiveLookup lookup;
+    if (!FindInArchives(path, lookup) || lookup.entry->size == 0) {
+        return false;
+    }
+
+    // Raw entries are borrowed from the archive's mapping; compressed ones
+    // are decompressed into a buffer the view owns
+    if (const uint8_t* stored = lookup.archive->GetStoredData(*lookup.entry)) {
+        outFile.m_owner = lookup.archive;
+        outFile.m_data = stored;
+    }
+    else {
+        auto buffer = std::make_shared<std::vector<uint8_t>>();
+        if (!lookup.archive->Read(*lookup.entry, *buffer)) {
+            return false;
+        }
+        outFile.m_data = buffer->data();
+        outFile.m_owner = std::move(buffer);
+    }
+    outFile.m_size = static_cast<size_t>(lookup.entry->size);
+    return true;
+}
+
+void FileSystem::ListArchiveFiles(const std::string& directory, bool recursive, std::vector<std::string>& outFiles) const {
+    std::shared_lock<std::shared_mutex> lock(m_archiveMutex);
+    if (m_archives.empty()) {
+        return;
+    }
+
+    std::string normalized = AssetArchive::NormalizePath(directory);
+    bool absolute = std::filesystem::path(directory).is_absolute();
+    for (const ArchiveMount& mount : m_archives) {
+        const std::string& mountPoint = absolute ? mount.absoluteMountPoint : mount.mountPoint;
+
+        // Listing inside the mount, or (recursively) a directory containing it
+        std::string prefix;
+        std::string base = directory;
+        if (normalized != mountPoint) {
+            if (IsUnderDirectory(normalized, mountPoint)) {
+                prefix = normalized.substr(mountPoint.empty() ? 0 : mountPoint.size() + 1) + "/";
+            }
+            else if (recursive && IsUnderDirectory(mountPoint, normalized)) {
+                base = mount.originalMountPoint;
+            }
+            else {
+                continue;
+            }
+        }
+
+        const AssetArchive& archive = *mount.archive;
+        for (size_t i = 0; i < archive.GetEntryCount(); i++) {
+            std::string_view entryPath = archive.GetEntryPath(archive.GetEntry(i));
+            if (entryPath.compare(0, prefix.size(), prefix) != 0) {
+                continue;
+            }
+            entryPath.remove_prefix(prefix.size());
+            if (!recursive && entryPath.find('/') != std::string_view::npos) {
+                continue;
+            }
+            outFiles.push_back(CombinePaths(base, std::string(entryPath)));
+        }
+    }
+}
+
 std::ios_base::openmode FileSystem::GetOpenMode(FileMode mode) const {
     switch (mode) {
         case FileMode::Read:
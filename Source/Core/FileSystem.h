@@ -1,14 +1,20 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 #include <filesystem>
 #include <memory>
+#include <shared_mutex>
 
 namespace GameEngine {
 namespace Core {
 
+class AssetArchive;
+struct ArchiveEntry;
+
 enum class FileMode {
     Read,
     Write,
@@ -27,6 +33,43 @@ struct FileInfo {
     std::filesystem::file_time_type lastWriteTime;
 };
 
+// Read-only view of a whole file, unmapped on destruction. Loaders parse
+// straight from the mapped pages instead of copying the file into a buffer
+// first. Empty and missing files give an invalid view.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Files inside a mounted archive are served from it
+    bool Open(const std::filesystem::path& path);
+    // Maps the loose file, bypassing mounted archives
+    bool OpenOnDisk(const std::filesystem::path& path);
+    void Close();
+
+    bool IsValid() const { return m_data != nullptr; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    std::string_view GetText() const { return std::string_view(reinterpret_cast<const char*>(m_data), m_size); }
+
+private:
+    friend class FileSystem;
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::shared_ptr<const void> m_owner;    // Archive or decompressed buffer holding m_data
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
 class FileSystem {
 public:
     static FileSystem& GetInstance();
@@ -47,6 +90,13 @@ public:
     bool ReadBinaryFile(const std::string& path, std::vector<uint8_t>& outData) const;
     bool WriteBinaryFile(const std::string& path, const std::vector<uint8_t>& data) const;
 
+    // Zero-copy read access; the view stays valid while the MappedFile lives
+    MappedFile MapFile(const std::string& path) const;
+
+    // Reads many small files with their I/O in flight together. Files that
+    // fail are left empty in outData; returns how many were read.
+    size_t ReadBinaryFiles(const std::vector<std::string>& paths, std::vector<std::vector<uint8_t>>& outData) const;
+
     // File streaming
     std::unique_ptr<std::ifstream> OpenFileForReading(const std::string& path, FileMode mode = FileMode::Read) const;
     std::unique_ptr<std::ofstream> OpenFileForWriting(const std::string& path, FileMode mode = FileMode::Write) const;
@@ -81,6 +131,13 @@ public:
     std::string GetTexturePath(const std::string& filename) const;
     std::string GetShaderPath(const std::string& filename) const;
 
+    // Packed archives. Files in a mounted archive appear under mountPoint to
+    // every read, lookup and listing here, ahead of loose files; later mounts
+    // take precedence.
+    bool MountArchive(const std::string& archivePath, const std::string& mountPoint);
+    void UnmountAllArchives();
+    size_t GetMountedArchiveCount() const;
+
     // Search functionality
     std::vector<std::string> FindFiles(const std::string& pattern,
         const std::string& searchPath = "", bool recursive = true) const;
@@ -92,6 +149,8 @@ public:
     bool HasFileChanged(const std::string& path, std::filesystem::file_time_type& lastKnownTime) const;
 
 private:
+    friend class MappedFile;
+
     FileSystem() = default;
     ~FileSystem() = default;
     FileSystem(const FileSystem&) = delete;
@@ -100,10 +159,31 @@ private:
     std::ios_base::openmode GetOpenMode(FileMode mode) const;
     bool IsValidPath(const std::string& path) const;
 
+    struct ArchiveMount {
+        std::shared_ptr<const AssetArchive> archive;
+        std::string mountPoint;             // Normalized, relative
+        std::string absoluteMountPoint;     // Normalized, absolute
+        std::string originalMountPoint;     // As given, used to build listed paths
+        std::filesystem::file_time_type writeTime;
+    };
+
+    struct ArchiveLookup {
+        std::shared_ptr<const AssetArchive> archive;
+        const ArchiveEntry* entry = nullptr;
+        std::filesystem::file_time_type writeTime;
+    };
+
+    bool FindInArchives(const std::filesystem::path& path, ArchiveLookup& outLookup) const;
+    bool OpenFromArchive(const std::filesystem::path& path, MappedFile& outFile) const;
+    void ListArchiveFiles(const std::string& directory, bool recursive, std::vector<std::string>& outFiles) const;
+
 private:
     std::string m_assetsDirectory = "Assets";
     mutable std::string m_currentDirectory;
     mutable std::string m_executableDirectory;
+
+    std::vector<ArchiveMount> m_archives;
+    mutable std::shared_mutex m_archiveMutex;
 };
 
 // Convenience macros
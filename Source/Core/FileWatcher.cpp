@@ -0,0 +1,379 @@
+#include "FileWatcher.h"
+#include "AssetArchive.h"
+#include "FileSystem.h"
+#include "Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace GameEngine {
+namespace Core {
+
+namespace {
+
+#ifdef _WIN32
+constexpr DWORD CHANGE_BUFFER_SIZE = 64 * 1024;
+constexpr DWORD CHANGE_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+#else
+constexpr std::chrono::seconds SCAN_INTERVAL(1);
+#endif
+
+bool IsUnderDirectory(const std::string& path, const std::string& directory) {
+    return directory.empty() || (path.size() > directory.size()
+        && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/');
+}
+
+} // namespace
+
+FileWatcher::FileWatcher()
+    : m_nextSubscriptionId(1)
+    , m_settleTime(200)
+    , m_running(false)
+    , m_stopEvent(nullptr)
+{
+}
+
+FileWatcher::~FileWatcher() {
+    Stop();
+}
+
+bool FileWatcher::AddDirectory(const std::string& directory, bool recursive) {
+    if (m_running) {
+        LOG_WARNING("Cannot watch " << directory << " while the file watcher is running");
+        return false;
+    }
+    if (!FILE_SYSTEM.DirectoryExists(directory)) {
+        LOG_WARNING("Cannot watch missing directory: " << directory);
+        return false;
+    }
+
+    m_directories.push_back({ directory, recursive });
+    return true;
+}
+
+bool FileWatcher::Start() {
+    if (m_running) {
+        return true;
+    }
+    if (m_directories.empty()) {
+        LOG_WARNING("File watcher has no directories to watch");
+        return false;
+    }
+
+#ifdef _WIN32
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!m_stopEvent) {
+        LOG_ERROR("Failed to create file watcher stop event");
+        return false;
+    }
+#endif
+
+    m_running = true;
+    m_thread = std::thread(&FileWatcher::Run, this);
+
+    LOG_INFO("File watcher started on " << m_directories.size() << " directories");
+    return true;
+}
+
+void FileWatcher::Stop() {
+    if (!m_running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_running = false;
+    }
+    m_stopCondition.notify_all();
+#ifdef _WIN32
+    SetEvent(m_stopEvent);
+#endif
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+#ifdef _WIN32
+    CloseHandle(m_stopEvent);
+    m_stopEvent = nullptr;
+#endif
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.clear();
+}
+
+std::uint32_t FileWatcher::Subscribe(const std::string& directory, const std::vector<std::string>& extensions,
+                                     Callback callback) {
+    Subscription subscription;
+    subscription.id = m_nextSubscriptionId++;
+    subscription.directory = directory.empty() ? std::string() : AssetArchive::NormalizePath(directory);
+    subscription.extensions = extensions;
+    subscription.callback = std::move(callback);
+    m_subscriptions.push_back(std::move(subscription));
+    return m_subscriptions.back().id;
+}
+
+std::uint32_t FileWatcher::SubscribeFile(const std::string& path, Callback callback) {
+    Subscription subscription;
+    subscription.id = m_nextSubscriptionId++;
+    subscription.file = AssetArchive::NormalizePath(path);
+    subscription.callback = std::move(callback);
+    m_subscriptions.push_back(std::move(subscription));
+    return m_subscriptions.back().id;
+}
+
+void FileWatcher::Unsubscribe(std::uint32_t id) {
+    m_subscriptions.erase(std::remove_if(m_subscriptions.begin(), m_subscriptions.end(),
+        [id](const Subscription& subscription) { return subscription.id == id; }), m_subscriptions.end());
+}
+
+void FileWatcher::Update() {
+    Clock::time_point now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            if (now - it->second.lastSeen >= m_settleTime) {
+                m_settled.push_back(std::move(it->second.change));
+                it = m_pending.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    if (m_settled.empty()) {
+        return;
+    }
+
+    std::sort(m_settled.begin(), m_settled.end(), [](const FileChange& a, const FileChange& b) {
+        return a.path < b.path;
+    });
+
+    // Callbacks may subscribe or unsubscribe, so dispatch from a copy
+    std::vector<Subscription> subscriptions = m_subscriptions;
+    for (const FileChange& change : m_settled) {
+        std::string normalized = AssetArchive::NormalizePath(change.path);
+        for (const Subscription& subscription : subscriptions) {
+            if (Matches(subscription, normalized)) {
+                subscription.callback(change);
+            }
+        }
+    }
+    m_settled.clear();
+}
+
+bool FileWatcher::Matches(const Subscription& subscription, const std::string& normalizedPath) const {
+    if (!subscription.file.empty()) {
+        return normalizedPath == subscription.file;
+    }
+    if (!IsUnderDirectory(normalizedPath, subscription.directory)) {
+        return false;
+    }
+    if (subscription.extensions.empty()) {
+        return true;
+    }
+
+    size_t dot = normalizedPath.find_last_of("./");
+    if (dot == std::string::npos || normalizedPath[dot] != '.') {
+        return false;
+    }
+    std::string extension = normalizedPath.substr(dot + 1);
+    return std::find(subscription.extensions.begin(), subscription.extensions.end(), extension)
+        != subscription.extensions.end();
+}
+
+void FileWatcher::Record(const std::string& path, FileChangeType type) {
+    std::string key = AssetArchive::NormalizePath(path);
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+
+    auto it = m_pending.find(key);
+    if (it == m_pending.end()) {
+        m_pending.emplace(std::move(key), PendingChange{ FileChange{ path, type }, Clock::now() });
+        return;
+    }
+
+    // Fold the new change into the one still settling
+    FileChangeType previous = it->second.change.type;
+    if (previous == FileChangeType::Added && type == FileChangeType::Removed) {
+        m_pending.erase(it);    // Temporary file, gone before anyone cared
+        return;
+    }
+    if (previous == FileChangeType::Added) {
+        type = FileChangeType::Added;
+    }
+    else if (previous == FileChangeType::Removed && type == FileChangeType::Added) {
+        type = FileChangeType::Modified;
+    }
+    it->second.change.type = type;
+    it->second.lastSeen = Clock::now();
+}
+
+#ifdef _WIN32
+
+void FileWatcher::Run() {
+    struct DirectoryHandle {
+        const WatchedDirectory* directory = nullptr;
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        std::vector<DWORD> buffer;      // DWORD-aligned as ReadDirectoryChangesW requires
+    };
+
+    std::vector<DirectoryHandle> handles(m_directories.size());
+    std::vector<HANDLE> waits;
+    std::vector<size_t> waitDirectories;
+    waits.push_back(static_cast<HANDLE>(m_stopEvent));
+
+    auto issueRead = [](DirectoryHandle& handle) {
+        ResetEvent(handle.overlapped.hEvent);
+        return ReadDirectoryChangesW(handle.handle, handle.buffer.data(), CHANGE_BUFFER_SIZE,
+                                     handle.directory->recursive, CHANGE_FILTER, nullptr, &handle.overlapped, nullptr) != FALSE;
+    };
+
+    for (size_t i = 0; i < m_directories.size(); i++) {
+        DirectoryHandle& handle = handles[i];
+        handle.directory = &m_directories[i];
+        handle.buffer.resize(CHANGE_BUFFER_SIZE / sizeof(DWORD));
+
+        std::wstring widePath = std::filesystem::path(handle.directory->path).wstring();
+        handle.handle = CreateFileW(widePath.c_str(), FILE_LIST_DIRECTORY,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        handle.overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (handle.handle == INVALID_HANDLE_VALUE || !handle.overlapped.hEvent || !issueRead(handle)) {
+            LOG_ERROR("Failed to watch directory: " << handle.directory->path);
+            continue;
+        }
+
+        waits.push_back(handle.overlapped.hEvent);
+        waitDirectories.push_back(i);
+    }
+
+    while (m_running && waits.size() > 1) {
+        DWORD result = WaitForMultipleObjects(static_cast<DWORD>(waits.size()), waits.data(), FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0 || result < WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + waits.size()) {
+            break;
+        }
+
+        DirectoryHandle& handle = handles[waitDirectories[result - WAIT_OBJECT_0 - 1]];
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(handle.handle, &handle.overlapped, &bytes, FALSE) || bytes == 0) {
+            LOG_WARNING("File change buffer overflowed in " << handle.directory->path << ", some changes were missed");
+        }
+        else {
+            const std::uint8_t* entry = reinterpret_cast<const std::uint8_t*>(handle.buffer.data());
+            for (;;) {
+                const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(entry);
+                std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                std::filesystem::path path = std::filesystem::path(handle.directory->path) / name;
+
+                std::error_code error;
+                switch (info->Action) {
+                    case FILE_ACTION_ADDED:
+                    case FILE_ACTION_RENAMED_NEW_NAME:
+                        Record(path.string(), FileChangeType::Added);
+                        break;
+                    case FILE_ACTION_REMOVED:
+                    case FILE_ACTION_RENAMED_OLD_NAME:
+                        Record(path.string(), FileChangeType::Removed);
+                        break;
+                    case FILE_ACTION_MODIFIED:
+                        // Directories report changes to their contents as their own
+                        if (!std::filesystem::is_directory(path, error)) {
+                            Record(path.string(), FileChangeType::Modified);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+
+                if (info->NextEntryOffset == 0) {
+                    break;
+                }
+                entry += info->NextEntryOffset;
+            }
+        }
+
+        if (!issueRead(handle)) {
+            LOG_ERROR("Stopped watching directory: " << handle.directory->path);
+        }
+    }
+
+    for (DirectoryHandle& handle : handles) {
+        if (handle.handle != INVALID_HANDLE_VALUE) {
+            CancelIoEx(handle.handle, &handle.overlapped);
+            DWORD bytes = 0;
+            GetOverlappedResult(handle.handle, &handle.overlapped, &bytes, TRUE);
+            CloseHandle(handle.handle);
+        }
+        if (handle.overlapped.hEvent) {
+            CloseHandle(handle.overlapped.hEvent);
+        }
+    }
+}
+
+#else
+
+void FileWatcher::Run() {
+    // No change notifications here; compare write times on a slow timer
+    std::unordered_map<std::string, std::filesystem::file_time_type> known;
+    auto scan = [this](std::unordered_map<std::string, std::filesystem::file_time_type>& files) {
+        for (const WatchedDirectory& directory : m_directories) {
+            std::error_code error;
+            if (directory.recursive) {
+                for (auto it = std::filesystem::recursive_directory_iterator(directory.path, error);
+                     !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+                    if (it->is_regular_file(error)) {
+                        files[it->path().string()] = it->last_write_time(error);
+                    }
+                }
+            }
+            else {
+                for (auto it = std::filesystem::directory_iterator(directory.path, error);
+                     !error && it != std::filesystem::directory_iterator(); it.increment(error)) {
+                    if (it->is_regular_file(error)) {
+                        files[it->path().string()] = it->last_write_time(error);
+                    }
+                }
+            }
+        }
+    };
+    scan(known);
+
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    while (!m_stopCondition.wait_for(lock, SCAN_INTERVAL, [this]() { return !m_running; })) {
+        std::unordered_map<std::string, std::filesystem::file_time_type> current;
+        scan(current);
+
+        for (const auto& [path, time] : current) {
+            auto it = known.find(path);
+            if (it == known.end()) {
+                Record(path, FileChangeType::Added);
+            }
+            else if (it->second != time) {
+                Record(path, FileChangeType::Modified);
+            }
+        }
+        for (const auto& [path, time] : known) {
+            if (current.find(path) == current.end()) {
+                Record(path, FileChangeType::Removed);
+            }
+        }
+        known = std::move(current);
+    }
+}
+
+#endif
+
+} // namespace Core
+} // namespace GameEngine
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace GameEngine {
+namespace Core {
+
+enum class FileChangeType {
+    Added,
+    Modified,
+    Removed
+};
+
+struct FileChange {
+    std::string path;       // Watched directory joined with the file's relative path
+    FileChangeType type;
+};
+
+// Watches directory trees for file changes on a background thread.
+//
+// On Windows the thread blocks in ReadDirectoryChangesW, so idle watching
+// costs nothing; elsewhere it rescans the trees once a second. Changes are
+// coalesced per file and handed to subscribers from Update on the calling
+// thread once a file has been quiet for the settle time, so an editor
+// saving in several writes triggers one reload of the finished file.
+class FileWatcher {
+public:
+    using Callback = std::function<void(const FileChange& change)>;
+
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Directories must be added before Start
+    bool AddDirectory(const std::string& directory, bool recursive = true);
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return m_running; }
+
+    // Changes to files below directory (empty for any) whose extension is
+    // listed (lowercase, no dot; empty for any). Returns an ID for Unsubscribe.
+    std::uint32_t Subscribe(const std::string& directory, const std::vector<std::string>& extensions, Callback callback);
+    // Changes to one file
+    std::uint32_t SubscribeFile(const std::string& path, Callback callback);
+    void Unsubscribe(std::uint32_t id);
+
+    void SetSettleTime(std::chrono::milliseconds settleTime) { m_settleTime = settleTime; }
+
+    // Deliver settled changes to subscribers; call once per frame
+    void Update();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct WatchedDirectory {
+        std::string path;
+        bool recursive;
+    };
+
+    struct Subscription {
+        std::uint32_t id;
+        std::string directory;              // Normalized; empty for any
+        std::string file;                   // Normalized; set for SubscribeFile
+        std::vector<std::string> extensions;
+        Callback callback;
+    };
+
+    struct PendingChange {
+        FileChange change;
+        Clock::time_point lastSeen;
+    };
+
+    void Run();
+    void Record(const std::string& path, FileChangeType type);
+    bool Matches(const Subscription& subscription, const std::string& normalizedPath) const;
+
+    std::vector<WatchedDirectory> m_directories;
+    std::vector<Subscription> m_subscriptions;
+    std::uint32_t m_nextSubscriptionId;
+    std::chrono::milliseconds m_settleTime;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+    void* m_stopEvent;                      // Wakes the Windows thread out of its wait
+
+    // Written by the watch thread, drained by Update; keyed by normalized path
+    std::mutex m_pendingMutex;
+    std::unordered_map<std::string, PendingChange> m_pending;
+    std::vector<FileChange> m_settled;      // Scratch for Update
+};
+
+} // namespace Core
+} // namespace GameEngine
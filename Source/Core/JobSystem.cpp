@@ -0,0 +1,277 @@
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <system_error>
+
+namespace GameEngine {
+namespace Core {
+
+namespace {
+    // Queue owned by the calling thread; 0 for the main thread and any
+    // thread the job system did not create
+    thread_local unsigned int t_queueIndex = 0;
+}
+
+JobSystem& JobSystem::GetInstance() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::JobSystem()
+    : m_pendingJobs(0)
+    , m_running(false)
+    , m_initialized(false)
+{
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+bool JobSystem::Initialize(unsigned int workerCount) {
+    if (m_initialized) {
+        return true;
+    }
+
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_queues.clear();
+    for (unsigned int i = 0; i <= workerCount; i++) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_running = true;
+    m_initialized = true;
+
+    try {
+        for (unsigned int i = 1; i <= workerCount; i++) {
+            m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+        }
+    }
+    catch (const std::system_error& e) {
+        LOG_ERROR("Failed to start job worker thread: " << e.what());
+        Shutdown();
+        return false;
+    }
+
+    LOG_INFO("Job system started with " << workerCount << " worker threads");
+    return true;
+}
+
+void JobSystem::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_running = false;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+
+    // Finish anything still queued so no counter is left waiting
+    while (TryRunOne(0)) {
+    }
+
+    m_initialized = false;
+    m_queues.clear();
+    m_pendingJobs = 0;
+
+    LOG_INFO("Job system shut down");
+}
+
+void JobSystem::Run(JobFunction job, JobCounter* counter) {
+    if (counter) {
+        counter->m_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Push(Job{ std::move(job), counter });
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, JobFunction job, JobCounter* counter) {
+    if (counter) {
+        counter->m_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        // Complete() decrements under the same lock, so this check can't race it
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (dependency.m_value.load(std::memory_order_acquire) > 0) {
+            dependency.m_continuations.push_back({ std::move(job), counter });
+            return;
+        }
+    }
+
+    Push(Job{ std::move(job), counter });
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    unsigned int queueIndex = GetCurrentQueueIndex();
+
+    while (!counter.IsDone()) {
+        if (!TryRunOne(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Make sure the last Complete() has released the counter before the caller destroys it
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::ParallelFor(std::uint32_t count, const std::function<void(std::uint32_t, std::uint32_t)>& body,
+                            std::uint32_t minBatchSize) {
+    if (count == 0) {
+        return;
+    }
+
+    minBatchSize = std::max(minBatchSize, 1u);
+    if (!m_initialized || m_workers.empty() || count <= minBatchSize) {
+        body(0, count);
+        return;
+    }
+
+    // A few batches per thread so stealing can even out uneven work
+    std::uint32_t threadCount = static_cast<std::uint32_t>(m_workers.size()) + 1;
+    std::uint32_t batchSize = std::max(minBatchSize, (count + threadCount * 4 - 1) / (threadCount * 4));
+
+    JobCounter counter;
+    std::uint32_t begin = 0;
+    while (count - begin > batchSize) {
+        std::uint32_t end = begin + batchSize;
+        Run([&body, begin, end]() { body(begin, end); }, &counter);
+        begin = end;
+    }
+
+    // The caller takes the last batch itself
+    body(begin, count);
+    Wait(counter);
+}
+
+void JobSystem::WorkerLoop(unsigned int queueIndex) {
+    t_queueIndex = queueIndex;
+
+    while (m_running) {
+        if (TryRunOne(queueIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait(lock, [this]() {
+            return !m_running || m_pendingJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void JobSystem::Push(Job job) {
+    // Without workers jobs run immediately on the caller
+    if (!m_initialized) {
+        Execute(job);
+        return;
+    }
+
+    WorkQueue& queue = *m_queues[GetCurrentQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    m_pendingJobs.fetch_add(1, std::memory_order_release);
+
+    // Taking the wake mutex closes the window between a worker's check and its sleep
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wakeCondition.notify_one();
+}
+
+bool JobSystem::TryPop(unsigned int queueIndex, Job& job) {
+    WorkQueue& queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+
+    // Newest first: its data is most likely still in cache
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::TrySteal(unsigned int thiefIndex, Job& job) {
+    unsigned int queueCount = static_cast<unsigned int>(m_queues.size());
+
+    for (unsigned int offset = 1; offset < queueCount; offset++) {
+        WorkQueue& victim = *m_queues[(thiefIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty()) {
+            continue;
+        }
+
+        // Oldest first: usually the largest remaining piece of work
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+bool JobSystem::TryRunOne(unsigned int queueIndex) {
+    if (m_queues.empty()) {
+        return false;
+    }
+
+    Job job;
+    if (TryPop(queueIndex, job) || TrySteal(queueIndex, job)) {
+        Execute(job);
+        return true;
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(Job& job) {
+    if (job.function) {
+        PROFILE_SCOPE("Job");
+        job.function();
+    }
+    Complete(job.counter);
+}
+
+void JobSystem::Complete(JobCounter* counter) {
+    if (!counter) {
+        return;
+    }
+
+    std::vector<JobCounter::Continuation> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            released.swap(counter->m_continuations);
+        }
+    }
+
+    // The counter may be gone now; only touch the released jobs
+    for (auto& continuation : released) {
+        Push(Job{ std::move(continuation.function), continuation.counter });
+    }
+}
+
+unsigned int JobSystem::GetCurrentQueueIndex() const {
+    return t_queueIndex < m_queues.size() ? t_queueIndex : 0;
+}
+
+} // namespace Core
+} // namespace GameEngine
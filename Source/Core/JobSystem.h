@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GameEngine {
+namespace Core {
+
+using JobFunction = std::function<void()>;
+
+// Tracks outstanding jobs. A counter reaches zero when every job that was
+// submitted with it has finished; jobs can be made to wait on a counter.
+class JobCounter {
+public:
+    JobCounter() : m_value(0) {}
+
+    bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+    int GetValue() const { return m_value.load(std::memory_order_acquire); }
+
+private:
+    struct Continuation {
+        JobFunction function;
+        JobCounter* counter;
+    };
+
+    std::atomic<int> m_value;
+
+    // Jobs released when the counter drops to zero
+    std::mutex m_mutex;
+    std::vector<Continuation> m_continuations;
+
+    friend class JobSystem;
+};
+
+// Work-stealing thread pool.
+//
+// Each worker owns a deque: it pushes and pops its own jobs at the back and
+// steals from the front of other workers' deques when it runs dry. The main
+// thread owns slot 0 and helps execute jobs while it waits on a counter.
+class JobSystem {
+public:
+    static JobSystem& GetInstance();
+
+    // workerCount of 0 uses one worker per hardware thread, minus the main thread
+    bool Initialize(unsigned int workerCount = 0);
+    void Shutdown();
+
+    bool IsInitialized() const { return m_initialized; }
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+    // Queue a job; counter (optional) is incremented now and decremented on completion
+    void Run(JobFunction job, JobCounter* counter = nullptr);
+
+    // Queue a job that only starts once dependency has reached zero
+    void RunAfter(JobCounter& dependency, JobFunction job, JobCounter* counter = nullptr);
+
+    // Block until counter reaches zero, running queued jobs meanwhile
+    void Wait(JobCounter& counter);
+
+    // Split [0, count) into batches of at least minBatchSize and run
+    // body(begin, end) for each across all threads. Returns when all are done.
+    void ParallelFor(std::uint32_t count, const std::function<void(std::uint32_t, std::uint32_t)>& body,
+                     std::uint32_t minBatchSize = 64);
+
+private:
+    JobSystem();
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    struct Job {
+        JobFunction function;
+        JobCounter* counter;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(unsigned int queueIndex);
+    void Push(Job job);
+    bool TryPop(unsigned int queueIndex, Job& job);
+    bool TrySteal(unsigned int thiefIndex, Job& job);
+    bool TryRunOne(unsigned int queueIndex);
+    void Execute(Job& job);
+    void Complete(JobCounter* counter);
+
+    unsigned int GetCurrentQueueIndex() const;
+
+    // Slot 0 belongs to the main thread, workers use 1..N
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    // Sleeping workers wait here when no jobs are queued
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<int> m_pendingJobs;
+
+    std::atomic<bool> m_running;
+    bool m_initialized;
+};
+
+} // namespace Core
+} // namespace GameEngine
+
+#define JOB_SYSTEM GameEngine::Core::JobSystem::GetInstance()
@@ -1,9 +1,17 @@
 #include "Logger.h"
-#include <chrono>
-#include <iomanip>
+#include <cstdio>
 
 namespace GameEngine {
 	namespace Core {
+		namespace {
+			constexpr std::uint64_t RING_MASK = Logger::RING_CAPACITY - 1;
+			static_assert((Logger::RING_CAPACITY & RING_MASK) == 0, "Log ring capacity must be a power of two");
+
+			// The writer wakes at least this often; producers only signal it for
+			// errors and once the ring is a quarter full
+			constexpr std::chrono::milliseconds WRITE_INTERVAL(10);
+		}
+
 		Logger& Logger::GetInstance() {
 			static Logger instance;
 			return instance;
@@ -14,14 +22,14 @@ namespace GameEngine {
 		}
 
 		void Logger::Initialize(const std::string& filename, LogLevel minLevel) {
-			std::lock_guard<std::recursive_mutex> lock(m_logMutex);
+			std::lock_guard<std::mutex> lock(m_lifetimeMutex);
+			MEMORY_SCOPE(Logs);
 
-			if (m_initialized) {
+			SetMinLogLevel(minLevel);
+			if (m_initialized.load(std::memory_order_acquire)) {
 				return;
 			}
 
-			m_minLogLevel = minLevel;
-
 			// Open log file
 			m_logFile.open(filename, std::ios::out | std::ios::app);
 			if (!m_logFile.is_open()) {
@@ -29,81 +37,245 @@ namespace GameEngine {
 				return;
 			}
 
-			m_initialized = true;
+			// The ring outlives Shutdown so late producers never touch freed memory
+			if (!m_records) {
+				m_records.reset(new LogRecord[RING_CAPACITY]);
+			}
+			for (std::uint32_t i = 0; i < RING_CAPACITY; i++) {
+				m_records[i].sequence.store(i, std::memory_order_relaxed);
+			}
+			m_enqueuePosition.store(0, std::memory_order_relaxed);
+			m_writtenPosition.store(0, std::memory_order_relaxed);
+			m_dropped.store(0, std::memory_order_relaxed);
+			m_totalDropped.store(0, std::memory_order_relaxed);
+			m_cachedSecond = 0;
+
+			m_stopWriter.store(false, std::memory_order_relaxed);
+			m_writer = std::thread(&Logger::WriterThread, this);
+			m_initialized.store(true, std::memory_order_release);
 
 			// Log initialization message
 			Log(LogLevel::Info, "Logger initialized");
 		}
 
 		void Logger::Shutdown() {
-			std::lock_guard<std::recursive_mutex> lock(m_logMutex);
+			std::lock_guard<std::mutex> lock(m_lifetimeMutex);
 
-			if (!m_initialized) {
+			if (!m_initialized.load(std::memory_order_acquire)) {
 				return;
 			}
 
 			Log(LogLevel::Info, "Logger shutting down");
+			m_initialized.store(false, std::memory_order_release);
+
+			// The writer drains whatever is queued before it exits
+			m_stopWriter.store(true, std::memory_order_release);
+			WakeWriter();
+			if (m_writer.joinable()) {
+				m_writer.join();
+			}
 
 			if (m_logFile.is_open()) {
 				m_logFile.close();
 			}
-
-			m_initialized = false;
 		}
 
-		void Logger::LogDebug(const std::string& message) {
-			Log(LogLevel::Debug, message);
+		void Logger::LogDebug(std::string message) {
+			Log(LogLevel::Debug, std::move(message));
 		}
 
-		void Logger::LogInfo(const std::string& message) {
-			Log(LogLevel::Info, message);
+		void Logger::LogInfo(std::string message) {
+			Log(LogLevel::Info, std::move(message));
 		}
 
-		void Logger::LogWarning(const std::string& message) {
-			Log(LogLevel::Warning, message);
+		void Logger::LogWarning(std::string message) {
+			Log(LogLevel::Warning, std::move(message));
 		}
 
-		void Logger::LogError(const std::string& message) {
-			Log(LogLevel::Error, message);
+		void Logger::LogError(std::string message) {
+			Log(LogLevel::Error, std::move(message));
 		}
 
-		void Logger::Log(LogLevel level, const std::string& message) {
-			if (!m_enabled || level < m_minLogLevel) {
+		void Logger::Flush() {
+			if (!m_initialized.load(std::memory_order_acquire)) {
 				return;
 			}
 
-			std::lock_guard<std::recursive_mutex> lock(m_logMutex);
+			std::uint64_t target = m_enqueuePosition.load(std::memory_order_acquire);
+			WakeWriter();
+			while (m_writtenPosition.load(std::memory_order_acquire) < target &&
+				   !m_stopWriter.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+		}
 
-			if (!m_initialized) {
+		void Logger::Log(LogLevel level, std::string message) {
+			if (!ShouldLog(level) || !m_initialized.load(std::memory_order_acquire)) {
 				return;
 			}
 
-			std::string logEntry = GetTimeStamp() + " [" + LogLevelToString(level) + "] " + message;
+			Clock::time_point time = Clock::now();
+			std::uint64_t position = 0;
+			while (!TryPush(level, time, message, position)) {
+				// Full: chatty levels give way, warnings and errors wait for the writer
+				if (level < LogLevel::Warning) {
+					m_dropped.fetch_add(1, std::memory_order_relaxed);
+					m_totalDropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				WakeWriter();
+				std::this_thread::yield();
+				if (m_stopWriter.load(std::memory_order_acquire)) {
+					return;
+				}
+			}
+
+			if (level == LogLevel::Error) {
+				WakeWriter();
+				while (m_writtenPosition.load(std::memory_order_acquire) <= position &&
+					   !m_stopWriter.load(std::memory_order_acquire)) {
+					std::this_thread::yield();
+				}
+			}
+			else if (position - m_writtenPosition.load(std::memory_order_relaxed) >= RING_CAPACITY / 4) {
+				WakeWriter();
+			}
+		}
+
+		bool Logger::TryPush(LogLevel level, Clock::time_point time, std::string& message, std::uint64_t& position) {
+			// Bounded MPMC ring (Vyukov); each slot's sequence says whose turn it is
+			std::uint64_t pos = m_enqueuePosition.load(std::memory_order_relaxed);
+			LogRecord* record = nullptr;
+			for (;;) {
+				record = &m_records[pos & RING_MASK];
+				std::uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+				std::int64_t difference = static_cast<std::int64_t>(sequence) - static_cast<std::int64_t>(pos);
+				if (difference == 0) {
+					if (m_enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				}
+				else if (difference < 0) {
+					return false;
+				}
+				else {
+					pos = m_enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
 
-			// Write to console
-			std::cout << logEntry << std::endl;
+			record->level = level;
+			record->time = time;
+			record->message = std::move(message);
+			record->sequence.store(pos + 1, std::memory_order_release);
+			position = pos;
+			return true;
+		}
+
+		void Logger::WakeWriter() {
+			m_wakeCondition.notify_one();
+		}
+
+		void Logger::WriterThread() {
+			MEMORY_SCOPE(Logs);
+			std::string batch;
+			batch.reserve(64 * 1024);
+
+			for (;;) {
+				// Read the flag first so everything queued before Shutdown is drained
+				bool stopping = m_stopWriter.load(std::memory_order_acquire);
+				size_t count = Drain(batch);
+				if (stopping) {
+					break;
+				}
+				if (count == 0) {
+					std::unique_lock<std::mutex> lock(m_wakeMutex);
+					m_wakeCondition.wait_for(lock, WRITE_INTERVAL);
+				}
+			}
+		}
+
+		size_t Logger::Drain(std::string& batch) {
+			size_t count = 0;
+			std::uint64_t pos = m_writtenPosition.load(std::memory_order_relaxed);
+
+			std::uint32_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+			if (dropped > 0) {
+				AppendTimeStamp(batch, Clock::now());
+				batch += " [";
+				batch += LogLevelToString(LogLevel::Warning);
+				batch += "] ";
+				batch += std::to_string(dropped);
+				batch += " log messages dropped, the log ring was full\n";
+			}
+
+			for (;;) {
+				LogRecord& record = m_records[pos & RING_MASK];
+				if (record.sequence.load(std::memory_order_acquire) != pos + 1) {
+					break;
+				}
+
+				AppendTimeStamp(batch, record.time);
+				batch += " [";
+				batch += LogLevelToString(record.level);
+				batch += "] ";
+				batch += record.message;
+				batch += '\n';
+
+				// Free the text here rather than in the next producer's move into the slot
+				std::string().swap(record.message);
+				record.sequence.store(pos + RING_CAPACITY, std::memory_order_release);
+				pos++;
+				count++;
+
+				// Publish progress in chunks so waiting errors and Flush see it
+				if ((count & 1023) == 0) {
+					WriteBatch(batch);
+					batch.clear();
+					m_writtenPosition.store(pos, std::memory_order_release);
+				}
+			}
+
+			if (!batch.empty()) {
+				WriteBatch(batch);
+				batch.clear();
+			}
+			m_writtenPosition.store(pos, std::memory_order_release);
+			return count;
+		}
+
+		void Logger::WriteBatch(const std::string& batch) {
+			std::cout.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+			std::cout.flush();
 
-			// Write to file
 			if (m_logFile.is_open()) {
-				m_logFile << logEntry << std::endl;
+				m_logFile.write(batch.data(), static_cast<std::streamsize>(batch.size()));
 				m_logFile.flush();
 			}
 		}
 
-		std::string Logger::GetTimeStamp() const {
-			auto now = std::chrono::system_clock::now();
-			auto time_t = std::chrono::system_clock::to_time_t(now);
-			auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-				now.time_since_epoch()) % 1000;
+		void Logger::AppendTimeStamp(std::string& out, Clock::time_point time) {
+			std::time_t seconds = Clock::to_time_t(time);
+			auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) % 1000;
 
-			std::stringstream ss;
-			ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-			ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
+			// localtime and strftime only run once per second of log output
+			if (seconds != m_cachedSecond || m_cachedTimeStamp[0] == '\0') {
+				std::tm local = {};
+#ifdef _WIN32
+				localtime_s(&local, &seconds);
+#else
+				localtime_r(&seconds, &local);
+#endif
+				std::strftime(m_cachedTimeStamp, sizeof(m_cachedTimeStamp), "%Y-%m-%d %H:%M:%S", &local);
+				m_cachedSecond = seconds;
+			}
 
-			return ss.str();
+			char millis[8];
+			std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(ms.count()));
+			out += m_cachedTimeStamp;
+			out += millis;
 		}
 
-		std::string Logger::LogLevelToString(LogLevel level) const {
+		const char* Logger::LogLevelToString(LogLevel level) const {
 			switch (level) {
 			case LogLevel::Debug:   return "DEBUG";
 			case LogLevel::Info:    return "INFO ";
@@ -113,4 +285,4 @@ namespace GameEngine {
 			}
 		}
 	} // namespace Core
-} // namespace GameEngine
\ No newline at end of file
+} // namespace GameEngine
@@ -5,6 +5,24 @@
 #include <sstream>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include "MemoryTracker.h"
+
+// Levels below this are compiled out of the LOG_* macros; the message is
+// still type-checked but never formatted. Override with -DLOG_COMPILE_LEVEL=n
+// (0 = Debug, 1 = Info, 2 = Warning, 3 = Error).
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL 1
+#else
+#define LOG_COMPILE_LEVEL 0
+#endif
+#endif
 
 namespace GameEngine {
 	namespace Core {
@@ -15,62 +33,107 @@ namespace GameEngine {
 			Error = 3
 		};
 
+		// Asynchronous logger. Callers push messages into a bounded
+		// multi-producer ring without taking a lock; a writer thread drains it,
+		// formats timestamps (cached per second) and writes each batch to the
+		// console and the log file with a single flush.
+		//
+		// When the ring is full, Debug and Info messages are dropped and counted;
+		// warnings wait for space. Errors also wait until they are written, so
+		// they reach the file before a crash that may follow.
 		class Logger {
 		public:
+			static constexpr std::uint32_t RING_CAPACITY = 8192;   // Power of two
+
 			static Logger& GetInstance();
 
+			// A second call only changes the minimum level
 			void Initialize(const std::string& filename = "engine.log", LogLevel minLevel = LogLevel::Info);
 			void Shutdown();
 
-			void LogDebug(const std::string& message);
-			void LogInfo(const std::string& message);
-			void LogWarning(const std::string& message);
-			void LogError(const std::string& message);
+			void LogDebug(std::string message);
+			void LogInfo(std::string message);
+			void LogWarning(std::string message);
+			void LogError(std::string message);
+
+			// Block until everything logged so far is written
+			void Flush();
+
+			void SetMinLogLevel(LogLevel level) { m_minLogLevel.store(level, std::memory_order_relaxed); }
+			LogLevel GetMinLogLevel() const { return m_minLogLevel.load(std::memory_order_relaxed); }
 
-			void SetMinLogLevel(LogLevel level) { m_minLogLevel = level; }
-			LogLevel GetMinLogLevel() const { return m_minLogLevel; }
+			void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+			bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
 
-			void SetEnabled(bool enabled) { m_enabled = enabled; }
-			bool IsEnabled() const { return m_enabled; }
+			// Checked by the macros before a message is formatted
+			bool ShouldLog(LogLevel level) const {
+				return IsEnabled() && level >= GetMinLogLevel();
+			}
+
+			// Messages lost to a full ring since Initialize
+			std::uint64_t GetDroppedCount() const { return m_totalDropped.load(std::memory_order_relaxed); }
 
 		private:
+			using Clock = std::chrono::system_clock;
+
+			struct LogRecord {
+				std::atomic<std::uint64_t> sequence;
+				LogLevel level;
+				Clock::time_point time;
+				std::string message;
+			};
+
 			Logger() = default;
 			~Logger();
 
-			void Log(LogLevel level, const std::string& message);
-			std::string GetTimeStamp() const;
-			std::string LogLevelToString(LogLevel level) const;
+			void Log(LogLevel level, std::string message);
+			bool TryPush(LogLevel level, Clock::time_point time, std::string& message, std::uint64_t& position);
+			void WakeWriter();
+
+			void WriterThread();
+			size_t Drain(std::string& batch);
+			void WriteBatch(const std::string& batch);
+			void AppendTimeStamp(std::string& out, Clock::time_point time);
+			const char* LogLevelToString(LogLevel level) const;
 
+			// Ring shared by producers and the writer
+			std::unique_ptr<LogRecord[]> m_records;
+			std::atomic<std::uint64_t> m_enqueuePosition{ 0 };
+			std::atomic<std::uint64_t> m_writtenPosition{ 0 };   // Only advanced by the writer
+			std::atomic<std::uint32_t> m_dropped{ 0 };
+			std::atomic<std::uint64_t> m_totalDropped{ 0 };
+
+			// Writer thread
+			std::thread m_writer;
+			std::mutex m_wakeMutex;
+			std::condition_variable m_wakeCondition;
+			std::atomic<bool> m_stopWriter{ false };
+
+			// Writer-only state
 			std::ofstream m_logFile;
-			LogLevel m_minLogLevel = LogLevel::Info;
-			std::recursive_mutex m_logMutex;
-			bool m_initialized = false;
-			bool m_enabled = true;
+			std::time_t m_cachedSecond = 0;
+			char m_cachedTimeStamp[32] = {};
+
+			std::mutex m_lifetimeMutex;   // Initialize and Shutdown
+			std::atomic<LogLevel> m_minLogLevel{ LogLevel::Info };
+			std::atomic<bool> m_initialized{ false };
+			std::atomic<bool> m_enabled{ true };
 		};
 
 		// Macros for convenient logging
-#define LOG_DEBUG(msg) do { \
-    std::stringstream ss; \
-    ss << msg; \
-    GameEngine::Core::Logger::GetInstance().LogDebug(ss.str()); \
-} while(0)
-
-#define LOG_INFO(msg) do { \
-    std::stringstream ss; \
-    ss << msg; \
-    GameEngine::Core::Logger::GetInstance().LogInfo(ss.str()); \
-} while(0)
-
-#define LOG_WARNING(msg) do { \
-    std::stringstream ss; \
-    ss << msg; \
-    GameEngine::Core::Logger::GetInstance().LogWarning(ss.str()); \
+#define LOG_AT_LEVEL(level, method, msg) do { \
+    if (static_cast<int>(level) >= LOG_COMPILE_LEVEL && \
+        GameEngine::Core::Logger::GetInstance().ShouldLog(level)) { \
+        MEMORY_SCOPE(Logs); \
+        std::ostringstream ss; \
+        ss << msg; \
+        GameEngine::Core::Logger::GetInstance().method(ss.str()); \
+    } \
 } while(0)
 
-#define LOG_ERROR(msg) do { \
-    std::stringstream ss; \
-    ss << msg; \
-    GameEngine::Core::Logger::GetInstance().LogError(ss.str()); \
-} while(0)
+#define LOG_DEBUG(msg) LOG_AT_LEVEL(GameEngine::Core::LogLevel::Debug, LogDebug, msg)
+#define LOG_INFO(msg) LOG_AT_LEVEL(GameEngine::Core::LogLevel::Info, LogInfo, msg)
+#define LOG_WARNING(msg) LOG_AT_LEVEL(GameEngine::Core::LogLevel::Warning, LogWarning, msg)
+#define LOG_ERROR(msg) LOG_AT_LEVEL(GameEngine::Core::LogLevel::Error, LogError, msg)
 	} // namespace Core
 } // namespace GameEngine
@@ -0,0 +1,281 @@
+#include "MemoryTracker.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace GameEngine {
+namespace Core {
+
+namespace {
+
+// Own cache line each, so threads allocating for different subsystems do not contend
+struct alignas(64) CategoryCounters {
+    std::atomic<std::int64_t> cpuBytes;
+    std::atomic<std::int64_t> cpuAllocations;
+    std::atomic<std::int64_t> gpuBytes;
+};
+
+// Zero-initialized before any constructor runs, so operator new can use
+// them during static initialization
+CategoryCounters g_counters[MEMORY_CATEGORY_COUNT];
+thread_local MemoryCategory t_category = MemoryCategory::Other;
+
+const char* const CATEGORY_NAMES[MEMORY_CATEGORY_COUNT] = {
+    "Other",
+    "Meshes",
+    "Textures",
+    "Animations",
+    "Scene",
+    "XML",
+    "Logs",
+    "Renderer",
+};
+
+double ToMegabytes(std::int64_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+const char* GetMemoryCategoryName(MemoryCategory category) {
+    size_t index = static_cast<size_t>(category);
+    return index < MEMORY_CATEGORY_COUNT ? CATEGORY_NAMES[index] : "Unknown";
+}
+
+std::int64_t MemorySnapshot::GetTotalCpuBytes() const {
+    std::int64_t total = 0;
+    for (const MemoryCategoryUsage& usage : categories) {
+        total += usage.cpuBytes;
+    }
+    return total;
+}
+
+std::int64_t MemorySnapshot::GetTotalGpuBytes() const {
+    std::int64_t total = 0;
+    for (const MemoryCategoryUsage& usage : categories) {
+        total += usage.gpuBytes;
+    }
+    return total;
+}
+
+MemoryTracker& MemoryTracker::GetInstance() {
+    static MemoryTracker instance;
+    return instance;
+}
+
+MemoryTracker::MemoryTracker()
+    : m_videoMemoryUsage(0)
+    , m_videoMemoryBudget(0)
+    , m_frameIndex(0)
+    , m_videoOverBudget(false)
+{
+    for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        m_budgets[i].store(0, std::memory_order_relaxed);
+        m_peaks[i] = 0;
+        m_overBudget[i] = false;
+    }
+}
+
+MemoryCategory MemoryTracker::GetCurrentCategory() {
+    return t_category;
+}
+
+MemoryCategory MemoryTracker::SetCurrentCategory(MemoryCategory category) {
+    MemoryCategory previous = t_category;
+    t_category = category;
+    return previous;
+}
+
+void MemoryTracker::TrackCpu(MemoryCategory category, std::int64_t bytes, std::int64_t allocations) {
+    CategoryCounters& counters = g_counters[static_cast<size_t>(category)];
+    counters.cpuBytes.fetch_add(bytes, std::memory_order_relaxed);
+    counters.cpuAllocations.fetch_add(allocations, std::memory_order_relaxed);
+}
+
+void MemoryTracker::TrackGpu(MemoryCategory category, std::int64_t bytes) {
+    g_counters[static_cast<size_t>(category)].gpuBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+bool MemoryTracker::IsHeapTracked() {
+#ifdef ENGINE_TRACK_HEAP
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryTracker::SetBudget(MemoryCategory category, std::int64_t bytes) {
+    m_budgets[static_cast<size_t>(category)].store(std::max<std::int64_t>(bytes, 0), std::memory_order_relaxed);
+}
+
+void MemoryTracker::SetVideoMemoryInfo(std::int64_t usage, std::int64_t budget) {
+    m_videoMemoryUsage.store(usage, std::memory_order_relaxed);
+    m_videoMemoryBudget.store(budget, std::memory_order_relaxed);
+}
+
+MemorySnapshot MemoryTracker::TakeSnapshot() const {
+    MemorySnapshot snapshot;
+    snapshot.frameIndex = m_frameIndex;
+    for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        MemoryCategoryUsage& usage = snapshot.categories[i];
+        usage.cpuBytes = g_counters[i].cpuBytes.load(std::memory_order_relaxed);
+        usage.cpuAllocations = g_counters[i].cpuAllocations.load(std::memory_order_relaxed);
+        usage.gpuBytes = g_counters[i].gpuBytes.load(std::memory_order_relaxed);
+        usage.peakBytes = std::max(m_peaks[i], usage.GetTotalBytes());
+        usage.budgetBytes = m_budgets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.videoMemoryUsage = m_videoMemoryUsage.load(std::memory_order_relaxed);
+    snapshot.videoMemoryBudget = m_videoMemoryBudget.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+MemorySnapshot MemoryTracker::Diff(const MemorySnapshot& later, const MemorySnapshot& earlier) {
+    MemorySnapshot diff = later;
+    diff.frameIndex = later.frameIndex - earlier.frameIndex;
+    for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        diff.categories[i].cpuBytes -= earlier.categories[i].cpuBytes;
+        diff.categories[i].cpuAllocations -= earlier.categories[i].cpuAllocations;
+        diff.categories[i].gpuBytes -= earlier.categories[i].gpuBytes;
+        diff.categories[i].peakBytes -= earlier.categories[i].peakBytes;
+    }
+    diff.videoMemoryUsage -= earlier.videoMemoryUsage;
+    return diff;
+}
+
+void MemoryTracker::EndFrame() {
+    m_frameIndex++;
+    MemorySnapshot snapshot = TakeSnapshot();
+
+    bool exceeded = false;
+    for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        const MemoryCategoryUsage& usage = snapshot.categories[i];
+        m_peaks[i] = usage.peakBytes;
+
+        bool over = usage.IsOverBudget();
+        if (over && !m_overBudget[i]) {
+            LOG_WARNING("Memory budget exceeded: " << CATEGORY_NAMES[i] << " uses " << ToMegabytes(usage.GetTotalBytes())
+                        << " MB of " << ToMegabytes(usage.budgetBytes) << " MB");
+            exceeded = true;
+        }
+        m_overBudget[i] = over;
+    }
+
+    bool videoOver = snapshot.videoMemoryBudget > 0 && snapshot.videoMemoryUsage > snapshot.videoMemoryBudget;
+    if (videoOver && !m_videoOverBudget) {
+        LOG_WARNING("Video memory over the OS budget (" << ToMegabytes(snapshot.videoMemoryUsage) << " MB of "
+                    << ToMegabytes(snapshot.videoMemoryBudget) << " MB), expect resources to be paged out");
+        exceeded = true;
+    }
+    m_videoOverBudget = videoOver;
+
+    if (exceeded) {
+        LogSnapshot(snapshot);
+    }
+}
+
+void MemoryTracker::LogSnapshot(const MemorySnapshot& snapshot, const MemorySnapshot* baseline) const {
+    if (baseline) {
+        MemorySnapshot diff = Diff(snapshot, *baseline);
+        LOG_INFO("Memory change over " << diff.frameIndex << " frames: CPU " << ToMegabytes(diff.GetTotalCpuBytes())
+                 << " MB, GPU " << ToMegabytes(diff.GetTotalGpuBytes()) << " MB, video "
+                 << ToMegabytes(diff.videoMemoryUsage) << " MB");
+        for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+            const MemoryCategoryUsage& usage = diff.categories[i];
+            if (usage.cpuAllocations != 0 || usage.cpuBytes != 0 || usage.gpuBytes != 0) {
+                LOG_INFO("  " << CATEGORY_NAMES[i] << ": CPU " << ToMegabytes(usage.cpuBytes) << " MB in "
+                         << usage.cpuAllocations << " blocks, GPU " << ToMegabytes(usage.gpuBytes) << " MB");
+            }
+        }
+        return;
+    }
+
+    LOG_INFO("Memory: CPU " << ToMegabytes(snapshot.GetTotalCpuBytes()) << " MB"
+             << (IsHeapTracked() ? "" : " (heap not tracked)") << ", GPU " << ToMegabytes(snapshot.GetTotalGpuBytes())
+             << " MB, video " << ToMegabytes(snapshot.videoMemoryUsage) << " of "
+             << ToMegabytes(snapshot.videoMemoryBudget) << " MB");
+    for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        const MemoryCategoryUsage& usage = snapshot.categories[i];
+        if (usage.cpuAllocations == 0 && usage.gpuBytes == 0) {
+            continue;
+        }
+
+        if (usage.budgetBytes > 0) {
+            LOG_INFO("  " << CATEGORY_NAMES[i] << ": CPU " << ToMegabytes(usage.cpuBytes) << " MB in "
+                     << usage.cpuAllocations << " blocks, GPU " << ToMegabytes(usage.gpuBytes) << " MB, peak "
+                     << ToMegabytes(usage.peakBytes) << " MB, budget " << ToMegabytes(usage.budgetBytes) << " MB");
+        }
+        else {
+            LOG_INFO("  " << CATEGORY_NAMES[i] << ": CPU " << ToMegabytes(usage.cpuBytes) << " MB in "
+                     << usage.cpuAllocations << " blocks, GPU " << ToMegabytes(usage.gpuBytes) << " MB, peak "
+                     << ToMegabytes(usage.peakBytes) << " MB");
+        }
+    }
+}
+
+} // namespace Core
+} // namespace GameEngine
+
+#ifdef ENGINE_TRACK_HEAP
+
+// Global allocation hooks. The aligned (std::align_val_t) forms are left to
+// the runtime and go untracked; everything else gets a header.
+namespace {
+
+using GameEngine::Core::MemoryCategory;
+using GameEngine::Core::MemoryTracker;
+
+// Keeps the block after it at the default new alignment
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) HeapHeader {
+    std::size_t size;
+    MemoryCategory category;
+};
+
+void* TrackedAllocate(std::size_t size) noexcept {
+    HeapHeader* header = static_cast<HeapHeader*>(std::malloc(sizeof(HeapHeader) + size));
+    if (!header) {
+        return nullptr;
+    }
+    header->size = size;
+    header->category = MemoryTracker::GetCurrentCategory();
+    MemoryTracker::TrackCpu(header->category, static_cast<std::int64_t>(size), 1);
+    return header + 1;
+}
+
+void TrackedFree(void* block) noexcept {
+    if (!block) {
+        return;
+    }
+    HeapHeader* header = static_cast<HeapHeader*>(block) - 1;
+    MemoryTracker::TrackCpu(header->category, -static_cast<std::int64_t>(header->size), -1);
+    std::free(header);
+}
+
+void* TrackedAllocateOrThrow(std::size_t size) {
+    for (;;) {
+        if (void* block = TrackedAllocate(size)) {
+            return block;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return TrackedAllocateOrThrow(size); }
+void* operator new[](std::size_t size) { return TrackedAllocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+
+void operator delete(void* block) noexcept { TrackedFree(block); }
+void operator delete[](void* block) noexcept { TrackedFree(block); }
+void operator delete(void* block, std::size_t) noexcept { TrackedFree(block); }
+void operator delete[](void* block, std::size_t) noexcept { TrackedFree(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { TrackedFree(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { TrackedFree(block); }
+
+#endif
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace GameEngine {
+namespace Core {
+
+// Subsystems memory is charged to
+enum class MemoryCategory : std::uint8_t {
+    Other,
+    Meshes,
+    Textures,
+    Animations,
+    Scene,
+    Xml,
+    Logs,
+    Renderer,       // Render targets, shadow maps and other buffers the renderer owns
+    Count
+};
+
+constexpr size_t MEMORY_CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Count);
+
+const char* GetMemoryCategoryName(MemoryCategory category);
+
+struct MemoryCategoryUsage {
+    std::int64_t cpuBytes = 0;          // Live heap blocks; 0 unless built with ENGINE_TRACK_HEAP
+    std::int64_t cpuAllocations = 0;
+    std::int64_t gpuBytes = 0;          // Live D3D resources passed to Renderer::TrackGpuMemory
+    std::int64_t peakBytes = 0;         // Highest CPU + GPU total seen at a frame end
+    std::int64_t budgetBytes = 0;       // CPU + GPU, 0 for none
+
+    std::int64_t GetTotalBytes() const { return cpuBytes + gpuBytes; }
+    bool IsOverBudget() const { return budgetBytes > 0 && GetTotalBytes() > budgetBytes; }
+};
+
+// Usage at one point in time. Diffing two shows what grew in between.
+struct MemorySnapshot {
+    std::uint64_t frameIndex = 0;
+    MemoryCategoryUsage categories[MEMORY_CATEGORY_COUNT];
+    std::int64_t videoMemoryUsage = 0;      // Whole process as DXGI sees it, 0 when unavailable
+    std::int64_t videoMemoryBudget = 0;     // What the OS grants before it starts evicting
+
+    const MemoryCategoryUsage& Get(MemoryCategory category) const { return categories[static_cast<size_t>(category)]; }
+    std::int64_t GetTotalCpuBytes() const;
+    std::int64_t GetTotalGpuBytes() const;
+};
+
+// Per-subsystem memory accounting.
+//
+// CPU: built with ENGINE_TRACK_HEAP, the global operator new and delete put
+// a small header in front of every block recording its size and the calling
+// thread's category, so a free is charged back to the category that
+// allocated whichever thread frees it. Threads pick their category with
+// MEMORY_SCOPE; allocations outside any scope count as Other.
+// GPU: resources are charged when created through Renderer::TrackGpuMemory
+// and credited back when D3D destroys them. DXGI's figure for the whole
+// process, and the budget the OS gives it, are sampled once a frame.
+//
+// Counters are relaxed atomics: each is exact, but a snapshot taken while
+// other threads allocate is not consistent across counters.
+class MemoryTracker {
+public:
+    static MemoryTracker& GetInstance();
+
+    // Category the calling thread's allocations are charged to; Set returns the previous one
+    static MemoryCategory GetCurrentCategory();
+    static MemoryCategory SetCurrentCategory(MemoryCategory category);
+
+    // Any thread; negative sizes release
+    static void TrackCpu(MemoryCategory category, std::int64_t bytes, std::int64_t allocations);
+    static void TrackGpu(MemoryCategory category, std::int64_t bytes);
+
+    static bool IsHeapTracked();
+
+    // CPU + GPU bytes, 0 for no budget
+    void SetBudget(MemoryCategory category, std::int64_t bytes);
+    void SetVideoMemoryInfo(std::int64_t usage, std::int64_t budget);
+
+    MemorySnapshot TakeSnapshot() const;
+
+    // later - earlier per counter; budgets come from later
+    static MemorySnapshot Diff(const MemorySnapshot& later, const MemorySnapshot& earlier);
+
+    // Main thread, once per frame: updates peaks and warns once each time a
+    // category, or the process's video memory, goes over its budget
+    void EndFrame();
+
+    // One line per category in use; with a baseline, what changed since it instead
+    void LogSnapshot(const MemorySnapshot& snapshot, const MemorySnapshot* baseline = nullptr) const;
+
+private:
+    MemoryTracker();
+    ~MemoryTracker() = default;
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    std::atomic<std::int64_t> m_budgets[MEMORY_CATEGORY_COUNT];
+    std::atomic<std::int64_t> m_videoMemoryUsage;
+    std::atomic<std::int64_t> m_videoMemoryBudget;
+
+    // Main thread only
+    std::uint64_t m_frameIndex;
+    std::int64_t m_peaks[MEMORY_CATEGORY_COUNT];
+    bool m_overBudget[MEMORY_CATEGORY_COUNT];
+    bool m_videoOverBudget;
+};
+
+// Charges allocations made by this thread in the enclosing scope to a category
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryCategory category)
+        : m_previous(MemoryTracker::SetCurrentCategory(category)) {}
+    ~MemoryScope() { MemoryTracker::SetCurrentCategory(m_previous); }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryCategory m_previous;
+};
+
+} // namespace Core
+} // namespace GameEngine
+
+#define MEMORY_TRACKER GameEngine::Core::MemoryTracker::GetInstance()
+
+#define MEMORY_CONCAT_INNER(a, b) a##b
+#define MEMORY_CONCAT(a, b) MEMORY_CONCAT_INNER(a, b)
+#define MEMORY_SCOPE(category) \
+    GameEngine::Core::MemoryScope MEMORY_CONCAT(memoryScope_, __LINE__)(GameEngine::Core::MemoryCategory::category)
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace GameEngine {
+namespace Core {
+
+// Fixed-size object allocator. Objects live in pages that never move and
+// freed slots go on an intrusive free list, so spawn/despawn churn reuses
+// memory instead of going to the heap per object. Release drops all pages
+// at once when the owner is done with every object.
+template<typename T, std::size_t PageSize = 256>
+class PoolAllocator {
+public:
+    PoolAllocator() : m_freeList(nullptr), m_liveCount(0) {}
+    // Pages go with the pool; the owner destroys its objects first
+    ~PoolAllocator() = default;
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    template<typename... Args>
+    T* Create(Args&&... args);
+    void Destroy(T* object);
+
+    // Frees every page; fails and keeps them while objects are still live
+    bool Release();
+
+    std::size_t GetLiveCount() const { return m_liveCount; }
+    std::size_t GetCapacity() const { return m_pages.size() * PageSize; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_pages;
+    Slot* m_freeList;
+    std::size_t m_liveCount;
+};
+
+// unique_ptr deleter that hands objects back to their pool; without a pool
+// the object came from new
+template<typename T>
+struct PoolDeleter {
+    PoolAllocator<T>* pool = nullptr;
+
+    void operator()(T* object) const {
+        if (pool) {
+            pool->Destroy(object);
+        }
+        else {
+            delete object;
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Template implementations
+
+template<typename T, std::size_t PageSize>
+template<typename... Args>
+T* PoolAllocator<T, PageSize>::Create(Args&&... args) {
+    if (!m_freeList) {
+        // Thread the new page onto the free list in address order
+        m_pages.push_back(std::make_unique<Slot[]>(PageSize));
+        Slot* page = m_pages.back().get();
+        for (std::size_t i = 0; i + 1 < PageSize; i++) {
+            page[i].next = &page[i + 1];
+        }
+        page[PageSize - 1].next = nullptr;
+        m_freeList = page;
+    }
+
+    Slot* slot = m_freeList;
+    m_freeList = slot->next;
+    m_liveCount++;
+    return new (slot->storage) T(std::forward<Args>(args)...);
+}
+
+template<typename T, std::size_t PageSize>
+void PoolAllocator<T, PageSize>::Destroy(T* object) {
+    if (!object) {
+        return;
+    }
+
+    object->~T();
+
+    Slot* slot = reinterpret_cast<Slot*>(object);
+    slot->next = m_freeList;
+    m_freeList = slot;
+    m_liveCount--;
+}
+
+template<typename T, std::size_t PageSize>
+bool PoolAllocator<T, PageSize>::Release() {
+    if (m_liveCount > 0) {
+        return false;
+    }
+
+    m_pages.clear();
+    m_freeList = nullptr;
+    return true;
+}
+
+} // namespace Core
+} // namespace GameEngine
@@ -0,0 +1,271 @@
+#include "Profiler.h"
+#include "FileSystem.h"
+#include "Logger.h"
+#include <windows.h>
+#include <cstring>
+#include <sstream>
+
+namespace GameEngine {
+namespace Core {
+
+namespace {
+
+// Chrome trace process ids for the two timelines
+constexpr int CPU_PROCESS_ID = 1;
+constexpr int GPU_PROCESS_ID = 2;
+
+std::int64_t GetTickFrequency() {
+    static const std::int64_t frequency = [] {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return static_cast<std::int64_t>(value.QuadPart);
+    }();
+    return frequency;
+}
+
+std::int64_t GetStartTicks() {
+    static const std::int64_t start = [] {
+        LARGE_INTEGER value;
+        QueryPerformanceCounter(&value);
+        return static_cast<std::int64_t>(value.QuadPart);
+    }();
+    return start;
+}
+
+void WriteJsonString(std::ostringstream& stream, const char* text) {
+    stream << '"';
+    for (const char* c = text ? text : ""; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            stream << '\\';
+        }
+        stream << *c;
+    }
+    stream << '"';
+}
+
+} // namespace
+
+Profiler& Profiler::GetInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler()
+    : m_enabled(true)
+    , m_mainThreadId(0)
+    , m_frameBegin(0)
+    , m_frameIndex(0)
+    , m_gpuMilliseconds(0.0)
+    , m_gpuFrameReady(false)
+    , m_captureFramesLeft(0)
+{
+    GetStartTicks();
+}
+
+std::int64_t Profiler::Now() {
+    LARGE_INTEGER value;
+    QueryPerformanceCounter(&value);
+    std::int64_t ticks = static_cast<std::int64_t>(value.QuadPart) - GetStartTicks();
+    std::int64_t frequency = GetTickFrequency();
+
+    // Split to keep the multiplication from overflowing on long runs
+    return (ticks / frequency) * 1000000 + (ticks % frequency) * 1000000 / frequency;
+}
+
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        m_threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = m_threadBuffers.back().get();
+        buffer->threadId = static_cast<std::uint32_t>(m_threadBuffers.size() - 1);
+    }
+    return *buffer;
+}
+
+std::uint16_t Profiler::PushDepth() {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    return buffer.depth++;
+}
+
+void Profiler::PopDepth() {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    if (buffer.depth > 0) {
+        buffer.depth--;
+    }
+}
+
+void Profiler::RecordScope(const char* name, std::int64_t begin, std::int64_t end, std::uint16_t depth) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+
+    // The reader is at most one frame behind; drop rather than overwrite unread events
+    std::uint32_t write = buffer.writeIndex.load(std::memory_order_relaxed);
+    std::uint32_t read = buffer.readIndex.load(std::memory_order_acquire);
+    if (write - read >= ThreadBuffer::CAPACITY) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ProfileEvent& event = buffer.events[write % ThreadBuffer::CAPACITY];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    event.threadId = buffer.threadId;
+    event.depth = depth;
+    buffer.writeIndex.store(write + 1, std::memory_order_release);
+}
+
+void Profiler::BeginFrame() {
+    m_mainThreadId = GetThreadBuffer().threadId;
+    m_frameBegin = Now();
+}
+
+void Profiler::EndFrame() {
+    if (!IsEnabled()) {
+        return;
+    }
+
+    std::int64_t frameEnd = Now();
+
+    // Drain every thread's buffer
+    m_frameEvents.clear();
+    unsigned int dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        for (const auto& buffer : m_threadBuffers) {
+            std::uint32_t write = buffer->writeIndex.load(std::memory_order_acquire);
+            std::uint32_t read = buffer->readIndex.load(std::memory_order_relaxed);
+            for (; read != write; read++) {
+                m_frameEvents.push_back(buffer->events[read % ThreadBuffer::CAPACITY]);
+            }
+            buffer->readIndex.store(write, std::memory_order_release);
+            dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    m_frameStats.frameIndex = m_frameIndex++;
+    m_frameStats.cpuMilliseconds = static_cast<double>(frameEnd - m_frameBegin) / 1000.0;
+    m_frameStats.droppedEvents = dropped;
+    m_frameStats.cpuScopes.clear();
+    for (const ProfileEvent& event : m_frameEvents) {
+        if (event.threadId == m_mainThreadId && event.depth == 0) {
+            AddTotal(m_frameStats.cpuScopes, event);
+        }
+    }
+
+    // GPU stats stay at the last resolved frame until a newer one arrives
+    std::vector<ProfileEvent> gpuEvents;
+    {
+        std::lock_guard<std::mutex> lock(m_gpuMutex);
+        if (m_gpuFrameReady) {
+            gpuEvents.swap(m_gpuEvents);
+            m_frameStats.gpuMilliseconds = m_gpuMilliseconds;
+            m_gpuFrameReady = false;
+
+            m_frameStats.gpuScopes.clear();
+            for (const ProfileEvent& event : gpuEvents) {
+                if (event.depth == 0) {
+                    AddTotal(m_frameStats.gpuScopes, event);
+                }
+            }
+        }
+    }
+
+    if (m_captureFramesLeft > 0) {
+        ProfileEvent frame;
+        frame.name = "Frame";
+        frame.begin = m_frameBegin;
+        frame.end = frameEnd;
+        frame.threadId = m_mainThreadId;
+        m_captureEvents.push_back(frame);
+        m_captureEvents.insert(m_captureEvents.end(), m_frameEvents.begin(), m_frameEvents.end());
+        m_captureEvents.insert(m_captureEvents.end(), gpuEvents.begin(), gpuEvents.end());
+
+        if (--m_captureFramesLeft == 0) {
+            if (ExportChromeTrace(m_capturePath, m_captureEvents)) {
+                LOG_INFO("Profiler capture written to " << m_capturePath << " (" << m_captureEvents.size() << " events)");
+            }
+            m_captureEvents.clear();
+            m_captureEvents.shrink_to_fit();
+        }
+    }
+}
+
+void Profiler::SubmitGpuFrame(const std::vector<ProfileEvent>& events, double gpuMilliseconds) {
+    std::lock_guard<std::mutex> lock(m_gpuMutex);
+    m_gpuEvents = events;
+    m_gpuMilliseconds = gpuMilliseconds;
+    m_gpuFrameReady = true;
+}
+
+void Profiler::StartCapture(unsigned int frameCount, const std::string& path) {
+    if (frameCount == 0 || path.empty()) {
+        return;
+    }
+
+    m_capturePath = path;
+    m_captureEvents.clear();
+    m_captureFramesLeft = frameCount;
+    LOG_INFO("Profiler capturing " << frameCount << " frames");
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path, const std::vector<ProfileEvent>& events) const {
+    std::ostringstream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << CPU_PROCESS_ID << ",\"args\":{\"name\":\"CPU\"}},\n";
+    json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << GPU_PROCESS_ID << ",\"args\":{\"name\":\"GPU\"}},\n";
+    json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << CPU_PROCESS_ID << ",\"tid\":" << m_mainThreadId
+         << ",\"args\":{\"name\":\"Main\"}}";
+
+    for (const ProfileEvent& event : events) {
+        bool gpu = event.threadId == GPU_THREAD_ID;
+        json << ",\n{\"name\":";
+        WriteJsonString(json, event.name);
+        json << ",\"ph\":\"X\",\"ts\":" << event.begin << ",\"dur\":" << (event.end - event.begin)
+             << ",\"pid\":" << (gpu ? GPU_PROCESS_ID : CPU_PROCESS_ID) << ",\"tid\":" << (gpu ? 0 : event.threadId) << "}";
+    }
+    json << "\n]}\n";
+
+    if (!FILE_SYSTEM.WriteTextFile(path, json.str())) {
+        LOG_ERROR("Failed to write profiler trace: " << path);
+        return false;
+    }
+    return true;
+}
+
+void Profiler::AddTotal(std::vector<ProfileScopeTotal>& totals, const ProfileEvent& event) {
+    double milliseconds = static_cast<double>(event.end - event.begin) / 1000.0;
+    for (ProfileScopeTotal& total : totals) {
+        if (total.name == event.name || (total.name && event.name && std::strcmp(total.name, event.name) == 0)) {
+            total.milliseconds += milliseconds;
+            return;
+        }
+    }
+
+    ProfileScopeTotal total;
+    total.name = event.name;
+    total.milliseconds = milliseconds;
+    totals.push_back(total);
+}
+
+ProfileScope::ProfileScope(const char* name)
+    : m_name(name)
+    , m_begin(-1)
+    , m_depth(0)
+{
+    if (PROFILER.IsEnabled()) {
+        m_depth = PROFILER.PushDepth();
+        m_begin = Profiler::Now();
+    }
+}
+
+ProfileScope::~ProfileScope() {
+    if (m_begin >= 0) {
+        std::int64_t end = Profiler::Now();
+        PROFILER.PopDepth();
+        PROFILER.RecordScope(m_name, m_begin, end, m_depth);
+    }
+}
+
+} // namespace Core
+} // namespace GameEngine
@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace GameEngine {
+namespace Core {
+
+// One timed scope. Names are not copied; pass string literals.
+struct ProfileEvent {
+    const char* name = nullptr;
+    std::int64_t begin = 0;         // Microseconds since the profiler started
+    std::int64_t end = 0;
+    std::uint32_t threadId = 0;     // GPU_THREAD_ID for GPU scopes
+    std::uint16_t depth = 0;
+};
+
+// Time spent in one named top-level scope during a frame
+struct ProfileScopeTotal {
+    const char* name = nullptr;
+    double milliseconds = 0.0;
+};
+
+struct ProfileFrameStats {
+    std::uint64_t frameIndex = 0;
+    double cpuMilliseconds = 0.0;               // Main thread, BeginFrame to EndFrame
+    double gpuMilliseconds = 0.0;               // Latest resolved GPU frame, a few frames behind
+    std::vector<ProfileScopeTotal> cpuScopes;   // Depth-0 scopes on the main thread
+    std::vector<ProfileScopeTotal> gpuScopes;   // Depth-0 GPU scopes
+    unsigned int droppedEvents = 0;             // Lost to full thread buffers this frame
+};
+
+// Hierarchical CPU profiler.
+//
+// PROFILE_SCOPE times the enclosing block with QueryPerformanceCounter and
+// appends the result to a buffer owned by the calling thread: a fixed ring
+// written by that thread and drained by the main thread in EndFrame, so
+// recording never takes a lock. GPU timings arrive from the renderer's GPU
+// profiler once their queries resolve. The last frame is summarized for the
+// overlay, and a capture of several frames can be exported as a Chrome
+// trace (chrome://tracing or ui.perfetto.dev).
+class Profiler {
+public:
+    static constexpr std::uint32_t GPU_THREAD_ID = 0xFFFFFFFF;
+
+    static Profiler& GetInstance();
+
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Main thread, once per frame
+    void BeginFrame();
+    void EndFrame();
+
+    // Called by ProfileScope; any thread
+    static std::int64_t Now();
+    void RecordScope(const char* name, std::int64_t begin, std::int64_t end, std::uint16_t depth);
+    std::uint16_t PushDepth();
+    void PopDepth();
+
+    // GPU scopes of one frame, placed on the trace relative to the frame's CPU start
+    void SubmitGpuFrame(const std::vector<ProfileEvent>& events, double gpuMilliseconds);
+
+    // Record the next frameCount frames and write them to path as a Chrome trace
+    void StartCapture(unsigned int frameCount, const std::string& path);
+    bool IsCapturing() const { return m_captureFramesLeft > 0; }
+    bool ExportChromeTrace(const std::string& path, const std::vector<ProfileEvent>& events) const;
+
+    // Main thread only
+    const ProfileFrameStats& GetFrameStats() const { return m_frameStats; }
+    std::int64_t GetFrameBeginTime() const { return m_frameBegin; }
+
+private:
+    Profiler();
+    ~Profiler() = default;
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Single producer (the owning thread), single consumer (EndFrame)
+    struct ThreadBuffer {
+        static constexpr std::uint32_t CAPACITY = 8192;
+
+        ProfileEvent events[CAPACITY];
+        std::atomic<std::uint32_t> writeIndex{ 0 };
+        std::atomic<std::uint32_t> readIndex{ 0 };
+        std::atomic<std::uint32_t> dropped{ 0 };
+        std::uint32_t threadId = 0;
+        std::uint16_t depth = 0;
+    };
+
+    ThreadBuffer& GetThreadBuffer();
+    static void AddTotal(std::vector<ProfileScopeTotal>& totals, const ProfileEvent& event);
+
+    std::atomic<bool> m_enabled;
+
+    // Buffers live as long as the profiler; threads only register once
+    std::mutex m_registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+
+    std::uint32_t m_mainThreadId;
+    std::int64_t m_frameBegin;
+    std::uint64_t m_frameIndex;
+    std::vector<ProfileEvent> m_frameEvents;
+    ProfileFrameStats m_frameStats;
+
+    // GPU results are handed over from the render thread
+    std::mutex m_gpuMutex;
+    std::vector<ProfileEvent> m_gpuEvents;
+    double m_gpuMilliseconds;
+    bool m_gpuFrameReady;
+
+    unsigned int m_captureFramesLeft;
+    std::string m_capturePath;
+    std::vector<ProfileEvent> m_captureEvents;
+};
+
+// Times the enclosing scope
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_begin;
+    std::uint16_t m_depth;
+};
+
+} // namespace Core
+} // namespace GameEngine
+
+#define PROFILER GameEngine::Core::Profiler::GetInstance()
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) GameEngine::Core::ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
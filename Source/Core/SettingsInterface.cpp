@@ -44,9 +44,13 @@ void SettingsInterface::ApplyGraphicsSettings() {
     // Apply VSync and FPS settings
     m_renderer->SetVSync(settings.vsync);
     m_renderer->SetMaxFPS(settings.maxFPS);
+    m_renderer->SetMaxFrameLatency(settings.maxFrameLatency);
+    m_renderer->SetStatsLogInterval(settings.renderStatsInterval);
+    m_renderer->SetRenderPath(Renderer::ParseRenderPath(settings.renderPath));
+    m_renderer->GetShadowMapManager().SetFilter(Renderer::ParseShadowFilter(settings.shadowFilter));
 
     LOG_INFO("Graphics settings applied - VSync: " << (settings.vsync ? "ON" : "OFF") <<
-             ", Max FPS: " << settings.maxFPS);
+             ", Max FPS: " << settings.maxFPS << ", Max frame latency: " << settings.maxFrameLatency);
 }
 
 void SettingsInterface::ApplyInputSettings() {
@@ -55,8 +59,10 @@ void SettingsInterface::ApplyInputSettings() {
     // Apply mouse sensitivity
     auto& inputManager = Input::InputManager::GetInstance();
     inputManager.SetMouseSensitivity(settings.mouseSensitivity);
+    inputManager.SetGamepadPollInterval(settings.gamepadPollInterval);
 
-    LOG_INFO("Input settings applied - Mouse sensitivity: " << settings.mouseSensitivity);
+    LOG_INFO("Input settings applied - Mouse sensitivity: " << settings.mouseSensitivity <<
+             ", Gamepad poll interval: " << settings.gamepadPollInterval << "s");
 }
 
 void SettingsInterface::ApplyPerformanceSettings() {
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace GameEngine {
+namespace Core {
+
+// 32-bit FNV-1a hash of a name, used in place of std::string keys on hot
+// paths. Literals hash at compile time when the ID is constexpr, e.g.
+//   constexpr StringId SPEED = "Speed"_id;
+// Lookups by ID never allocate and compare a single integer.
+class StringId {
+public:
+    constexpr StringId() : m_hash(0) {}
+    constexpr explicit StringId(std::uint32_t hash) : m_hash(hash) {}
+    constexpr StringId(const char* name) : m_hash(Hash(name)) {}
+    StringId(const std::string& name) : m_hash(Hash(name.data(), name.size())) {}
+
+    constexpr std::uint32_t GetHash() const { return m_hash; }
+    constexpr bool IsValid() const { return m_hash != 0; }
+
+    constexpr bool operator==(StringId other) const { return m_hash == other.m_hash; }
+    constexpr bool operator!=(StringId other) const { return m_hash != other.m_hash; }
+    constexpr bool operator<(StringId other) const { return m_hash < other.m_hash; }
+
+    static constexpr std::uint32_t Hash(const char* name, size_t length) {
+        std::uint32_t hash = FNV_OFFSET_BASIS;
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ static_cast<std::uint8_t>(name[i])) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    static constexpr std::uint32_t Hash(const char* name) {
+        std::uint32_t hash = FNV_OFFSET_BASIS;
+        for (; name && *name; name++) {
+            hash = (hash ^ static_cast<std::uint8_t>(*name)) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+private:
+    static constexpr std::uint32_t FNV_OFFSET_BASIS = 2166136261u;
+    static constexpr std::uint32_t FNV_PRIME = 16777619u;
+
+    std::uint32_t m_hash;
+};
+
+inline std::ostream& operator<<(std::ostream& stream, StringId id) {
+    return stream << "#" << std::hex << id.GetHash() << std::dec;
+}
+
+namespace Literals {
+    constexpr StringId operator""_id(const char* name, size_t length) {
+        return StringId(StringId::Hash(name, length));
+    }
+} // namespace Literals
+
+} // namespace Core
+} // namespace GameEngine
+
+// The hash is already well distributed; use it directly as the bucket key
+namespace std {
+template<>
+struct hash<GameEngine::Core::StringId> {
+    size_t operator()(GameEngine::Core::StringId id) const noexcept { return id.GetHash(); }
+};
+} // namespace std
@@ -128,6 +128,10 @@ LRESULT CALLBACK Window::WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
 }
 
 LRESULT Window::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) {
+    if (OnMessage) {
+        OnMessage(uMsg, wParam, lParam);
+    }
+
     switch (uMsg) {
         case WM_CLOSE:
             if (OnClose) {
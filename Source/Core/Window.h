@@ -38,6 +38,8 @@ public:
     std::function<void(int, int, bool)> OnMouseMove;
     std::function<void(int, bool)> OnMouseButton;
     std::function<void(int, bool)> OnKeyboard;
+    // Every message, before the window handles it (input queues raw input from here)
+    std::function<void(UINT, WPARAM, LPARAM)> OnMessage;
 
 private:
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
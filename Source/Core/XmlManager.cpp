@@ -1,12 +1,73 @@
 #include "XmlManager.h"
 #include "Logger.h"
+#include "MemoryTracker.h"
 #include "FileSystem.h"
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 
 using namespace GameEngine::Core;
 
+namespace {
+
+// Parsed documents nothing else holds are kept up to this size
+constexpr size_t DOCUMENT_CACHE_BUDGET = 8 * 1024 * 1024;
+
+// Leading whitespace and '+' as std::stoi/std::stof accepted them
+std::string_view TrimNumber(std::string_view text) {
+	size_t start = 0;
+	while (start < text.size() && std::isspace(static_cast<unsigned char>(text[start]))) {
+		start++;
+	}
+	if (start < text.size() && text[start] == '+') {
+		start++;
+	}
+	return text.substr(start);
+}
+
+bool EqualsIgnoreCase(std::string_view text, std::string_view word) {
+	return text.size() == word.size() && std::equal(text.begin(), text.end(), word.begin(), [](char a, char b) {
+		return std::tolower(static_cast<unsigned char>(a)) == b;
+	});
+}
+
+std::string_view ValueOf(const rapidxml::xml_base<>* base) {
+	return base ? std::string_view(base->value(), base->value_size()) : std::string_view();
+}
+
+} // namespace
+
+bool GameEngine::Core::ParseXmlValue(std::string_view text, int& outValue) {
+	text = TrimNumber(text);
+	int value = 0;
+	auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (text.empty() || result.ec != std::errc()) {
+		return false;
+	}
+	outValue = value;
+	return true;
+}
+
+bool GameEngine::Core::ParseXmlValue(std::string_view text, float& outValue) {
+	text = TrimNumber(text);
+	float value = 0.0f;
+	auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (text.empty() || result.ec != std::errc()) {
+		return false;
+	}
+	outValue = value;
+	return true;
+}
+
+bool GameEngine::Core::ParseXmlValue(std::string_view text, bool& outValue) {
+	if (text.empty()) {
+		return false;
+	}
+	outValue = EqualsIgnoreCase(text, "true") || text == "1" || EqualsIgnoreCase(text, "yes") || EqualsIgnoreCase(text, "on");
+	return true;
+}
+
 // XmlAttribute implementation
 XmlAttribute::XmlAttribute(rapidxml::xml_attribute<>* attr) : m_attribute(attr) {}
 
@@ -19,31 +80,18 @@ std::string XmlAttribute::GetValue() const {
 }
 
 int XmlAttribute::GetValueAsInt(int defaultValue) const {
-	try {
-		std::string value = GetValue();
-		return value.empty() ? defaultValue : std::stoi(value);
-	}
-	catch (const std::exception&) {
-		return defaultValue;
-	}
+	ParseXmlValue(ValueOf(m_attribute), defaultValue);
+	return defaultValue;
 }
 
 float XmlAttribute::GetValueAsFloat(float defaultValue) const {
-	try {
-		std::string value = GetValue();
-		return value.empty() ? defaultValue : std::stof(value);
-	}
-	catch (const std::exception&) {
-		return defaultValue;
-	}
+	ParseXmlValue(ValueOf(m_attribute), defaultValue);
+	return defaultValue;
 }
 
 bool XmlAttribute::GetValueAsBool(bool defaultValue) const {
-	std::string value = GetValue();
-	if (value.empty()) return defaultValue;
-
-	std::transform(value.begin(), value.end(), value.begin(), ::tolower);
-	return (value == "true" || value == "1" || value == "yes" || value == "on");
+	ParseXmlValue(ValueOf(m_attribute), defaultValue);
+	return defaultValue;
 }
 
 // XmlNode implementation
@@ -69,31 +117,18 @@ void XmlNode::SetValue(const std::string& value) {
 }
 
 int XmlNode::GetValueAsInt(int defaultValue) const {
-	try {
-		std::string value = GetValue();
-		return value.empty() ? defaultValue : std::stoi(value);
-	}
-	catch (const std::exception&) {
-		return defaultValue;
-	}
+	ParseXmlValue(ValueOf(m_node), defaultValue);
+	return defaultValue;
 }
 
 float XmlNode::GetValueAsFloat(float defaultValue) const {
-	try {
-		std::string value = GetValue();
-		return value.empty() ? defaultValue : std::stof(value);
-	}
-	catch (const std::exception&) {
-		return defaultValue;
-	}
+	ParseXmlValue(ValueOf(m_node), defaultValue);
+	return defaultValue;
 }
 
 bool XmlNode::GetValueAsBool(bool defaultValue) const {
-	std::string value = GetValue();
-	if (value.empty()) return defaultValue;
-
-	std::transform(value.begin(), value.end(), value.begin(), ::tolower);
-	return (value == "true" || value == "1" || value == "yes" || value == "on");
+	ParseXmlValue(ValueOf(m_node), defaultValue);
+	return defaultValue;
 }
 
 XmlAttribute XmlNode::GetAttribute(const std::string& name) const {
@@ -324,6 +359,8 @@ XmlDocument::~XmlDocument() {
 }
 
 bool XmlDocument::LoadFromFile(const std::string& filename) {
+	MEMORY_SCOPE(Xml);
+
 	Clear();
 
 	try {
@@ -332,14 +369,16 @@ bool XmlDocument::LoadFromFile(const std::string& filename) {
 			return false;
 		}
 
-		std::string content;
-		if (!FILE_SYSTEM.ReadTextFile(filename, content)) {
+		// Parse buffer is filled straight from the mapped file
+		MappedFile file = FILE_SYSTEM.MapFile(filename);
+		if (!file.IsValid()) {
 			Logger::GetInstance().LogError("XmlDocument::LoadFromFile - Failed to read file: " + filename);
 			return false;
 		}
 
-		if (LoadFromString(content)) {
+		if (LoadFromMemory(reinterpret_cast<const char*>(file.GetData()), file.GetSize())) {
 			m_filename = filename;
+			m_writeTime = FILE_SYSTEM.GetLastWriteTime(filename);
 			return true;
 		}
 
@@ -352,17 +391,24 @@ bool XmlDocument::LoadFromFile(const std::string& filename) {
 }
 
 bool XmlDocument::LoadFromString(const std::string& xmlContent) {
+	return LoadFromMemory(xmlContent.data(), xmlContent.size());
+}
+
+bool XmlDocument::LoadFromMemory(const char* data, size_t size) {
+	MEMORY_SCOPE(Xml);
+
 	Clear();
 
 	try {
-		if (xmlContent.empty()) {
-			Logger::GetInstance().LogError("XmlDocument::LoadFromString - Empty XML content");
+		if (!data || size == 0) {
+			Logger::GetInstance().LogError("XmlDocument::LoadFromMemory - Empty XML content");
 			return false;
 		}
 
-		m_xmlContent.resize(xmlContent.size() + 1);
-		std::copy(xmlContent.begin(), xmlContent.end(), m_xmlContent.begin());
-		m_xmlContent[xmlContent.size()] = '\0';
+		// rapidxml parses in place, so it gets its own terminated copy
+		m_xmlContent.resize(size + 1);
+		std::copy(data, data + size, m_xmlContent.begin());
+		m_xmlContent[size] = '\0';
 
 		m_document.parse<0>(m_xmlContent.data());
 		m_loaded = true;
@@ -371,12 +417,12 @@ bool XmlDocument::LoadFromString(const std::string& xmlContent) {
 		return true;
 	}
 	catch (const rapidxml::parse_error& e) {
-		Logger::GetInstance().LogError("XmlDocument::LoadFromString - Parse error: " + std::string(e.what()));
+		Logger::GetInstance().LogError("XmlDocument::LoadFromMemory - Parse error: " + std::string(e.what()));
 		Clear();
 		return false;
 	}
 	catch (const std::exception& e) {
-		Logger::GetInstance().LogError("XmlDocument::LoadFromString - Exception: " + std::string(e.what()));
+		Logger::GetInstance().LogError("XmlDocument::LoadFromMemory - Exception: " + std::string(e.what()));
 		Clear();
 		return false;
 	}
@@ -475,8 +521,8 @@ void XmlDocument::PrintNode(const rapidxml::xml_node<>* node, std::string& resul
 void XmlDocument::Clear() {
 	m_document.clear();
 	m_xmlContent.clear();
-	ClearAllocatedStrings();
 	m_filename.clear();
+	m_writeTime = std::filesystem::file_time_type();
 	m_loaded = false;
 }
 
@@ -574,15 +620,7 @@ void XmlDocument::AddDeclaration(const std::string& version,
 }
 
 char* XmlDocument::AllocateString(const std::string& str) {
-	auto buffer = std::make_unique<char[]>(str.length() + 1);
-	std::strcpy(buffer.get(), str.c_str());
-	char* result = buffer.get();
-	m_allocatedStrings.push_back(std::move(buffer));
-	return result;
-}
-
-void XmlDocument::ClearAllocatedStrings() {
-	m_allocatedStrings.clear();
+	return m_document.allocate_string(str.c_str(), str.size() + 1);
 }
 
 // XmlManager implementation
@@ -591,26 +629,29 @@ XmlManager& XmlManager::GetInstance() {
 	return instance;
 }
 
+XmlManager::XmlManager()
+	: m_documentCache([](const XmlDocument& document) { return document.GetMemoryUsage(); }) {
+}
+
 std::shared_ptr<XmlDocument> XmlManager::LoadDocument(const std::string& filename) {
-	// Check cache first
-	auto it = m_documentCache.find(filename);
-	if (it != m_documentCache.end()) {
-		if (auto existing = it->second.lock()) {
-			return existing;
-		}
-		else {
-			m_documentCache.erase(it);
+	MEMORY_SCOPE(Xml);
+
+	// An edited file replaces its cached document
+	if (auto cached = m_documentCache.Find(filename)) {
+		if (cached->GetWriteTime() == FILE_SYSTEM.GetLastWriteTime(filename)) {
+			return cached;
 		}
+		m_documentCache.Remove(filename);
 	}
 
-	// Load new document
-	auto document = std::make_shared<XmlDocument>();
-	if (document->LoadFromFile(filename)) {
-		m_documentCache[filename] = document;
-		return document;
-	}
+	// Threads asking for the same file share one parse
+	auto document = m_documentCache.GetOrLoad(filename, [&filename]() -> std::shared_ptr<XmlDocument> {
+		auto document = std::make_shared<XmlDocument>();
+		return document->LoadFromFile(filename) ? document : nullptr;
+	});
 
-	return nullptr;
+	m_documentCache.Trim(DOCUMENT_CACHE_BUDGET);
+	return document;
 }
 
 std::shared_ptr<XmlDocument> XmlManager::CreateDocument() {
@@ -627,16 +668,15 @@ bool XmlManager::SaveDocument(std::shared_ptr<XmlDocument> document, const std::
 }
 
 void XmlManager::ClearCache() {
-	m_documentCache.clear();
+	m_documentCache.Clear();
 }
 
 bool XmlManager::IsDocumentCached(const std::string& filename) const {
-	auto it = m_documentCache.find(filename);
-	return it != m_documentCache.end() && !it->second.expired();
+	return m_documentCache.Contains(filename);
 }
 
 void XmlManager::RemoveFromCache(const std::string& filename) {
-	m_documentCache.erase(filename);
+	m_documentCache.Remove(filename);
 }
 
 bool XmlManager::ValidateXmlFile(const std::string& filename) const {
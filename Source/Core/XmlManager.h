@@ -1,12 +1,15 @@
 #pragma once
 
+#include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <functional>
 #include "rapidxml.hpp"
 #include "rapidxml_utils.hpp"
+#include "AssetCache.h"
 
 namespace GameEngine {
 namespace Core {
@@ -15,6 +18,12 @@ namespace Core {
 class XmlNode;
 class XmlDocument;
 
+// Value conversions used by the wrappers, reading straight from the parse
+// buffer. False leaves outValue alone when text is empty or not a number.
+bool ParseXmlValue(std::string_view text, int& outValue);
+bool ParseXmlValue(std::string_view text, float& outValue);
+bool ParseXmlValue(std::string_view text, bool& outValue);
+
 // XML attribute wrapper
 class XmlAttribute {
 public:
@@ -127,6 +136,7 @@ public:
     // Loading and saving
     bool LoadFromFile(const std::string& filename);
     bool LoadFromString(const std::string& xmlContent);
+    bool LoadFromMemory(const char* data, size_t size);
     bool SaveToFile(const std::string& filename, bool formatted = true) const;
     std::string SaveToString(bool formatted = true) const;
 
@@ -144,6 +154,8 @@ public:
 
     // Document information
     std::string GetFilename() const { return m_filename; }
+    std::filesystem::file_time_type GetWriteTime() const { return m_writeTime; }
+    size_t GetMemoryUsage() const { return m_xmlContent.size(); }    // Parse buffer; nodes come on top
     std::string GetEncoding() const;
     void SetEncoding(const std::string& encoding);
 
@@ -156,13 +168,11 @@ private:
     rapidxml::xml_document<> m_document;
     std::vector<char> m_xmlContent;
     std::string m_filename;
+    std::filesystem::file_time_type m_writeTime;
     bool m_loaded;
 
-    // Memory management for RapidXML
-    std::vector<std::unique_ptr<char[]>> m_allocatedStrings;
-
+    // Copies into the document's memory pool, released by Clear
     char* AllocateString(const std::string& str);
-    void ClearAllocatedStrings();
     void PrintNode(const rapidxml::xml_node<>* node, std::string& result, int indent, bool formatted) const;
 };
 
@@ -171,7 +181,8 @@ class XmlManager {
 public:
     static XmlManager& GetInstance();
 
-    // Document management
+    // Document management. Loaded documents are cached and shared between
+    // callers until the file changes on disk; safe from any thread.
     std::shared_ptr<XmlDocument> LoadDocument(const std::string& filename);
     std::shared_ptr<XmlDocument> CreateDocument();
     bool SaveDocument(std::shared_ptr<XmlDocument> document, const std::string& filename);
@@ -203,12 +214,12 @@ public:
                           std::function<void(T&, const XmlNode&)> deserializer);
 
 private:
-    XmlManager() = default;
+    XmlManager();
     ~XmlManager() = default;
     XmlManager(const XmlManager&) = delete;
     XmlManager& operator=(const XmlManager&) = delete;
 
-    std::unordered_map<std::string, std::weak_ptr<XmlDocument>> m_documentCache;
+    AssetCache<std::string, XmlDocument> m_documentCache;
 };
 
 // Convenience macros
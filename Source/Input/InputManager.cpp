@@ -7,6 +7,60 @@
 namespace GameEngine {
 namespace Input {
 
+namespace {
+
+// GamepadState::buttons order
+constexpr WORD GAMEPAD_BUTTON_MASKS[14] = {
+    XINPUT_GAMEPAD_DPAD_UP, XINPUT_GAMEPAD_DPAD_DOWN, XINPUT_GAMEPAD_DPAD_LEFT, XINPUT_GAMEPAD_DPAD_RIGHT,
+    XINPUT_GAMEPAD_START, XINPUT_GAMEPAD_BACK, XINPUT_GAMEPAD_LEFT_THUMB, XINPUT_GAMEPAD_RIGHT_THUMB,
+    XINPUT_GAMEPAD_LEFT_SHOULDER, XINPUT_GAMEPAD_RIGHT_SHOULDER,
+    XINPUT_GAMEPAD_A, XINPUT_GAMEPAD_B, XINPUT_GAMEPAD_X, XINPUT_GAMEPAD_Y
+};
+
+// Key states mirroring each MouseButton, as GetAsyncKeyState reported them
+constexpr int MOUSE_BUTTON_KEYS[5] = { VK_LBUTTON, VK_RBUTTON, VK_MBUTTON, VK_XBUTTON1, VK_XBUTTON2 };
+
+// Raw mouse button transitions, per MouseButton
+constexpr USHORT RAW_BUTTON_DOWN[5] = {
+    RI_MOUSE_LEFT_BUTTON_DOWN, RI_MOUSE_RIGHT_BUTTON_DOWN, RI_MOUSE_MIDDLE_BUTTON_DOWN,
+    RI_MOUSE_BUTTON_4_DOWN, RI_MOUSE_BUTTON_5_DOWN
+};
+constexpr USHORT RAW_BUTTON_UP[5] = {
+    RI_MOUSE_LEFT_BUTTON_UP, RI_MOUSE_RIGHT_BUTTON_UP, RI_MOUSE_MIDDLE_BUTTON_UP,
+    RI_MOUSE_BUTTON_4_UP, RI_MOUSE_BUTTON_5_UP
+};
+
+// HID usages for RegisterRawInputDevices
+constexpr USHORT HID_USAGE_PAGE_GENERIC = 0x01;
+constexpr USHORT HID_USAGE_GENERIC_MOUSE = 0x02;
+constexpr USHORT HID_USAGE_GENERIC_KEYBOARD = 0x06;
+
+// Shift, Ctrl and Alt arrive as the generic key; track the sides separately
+int ResolveVirtualKey(int key, UINT scanCode, bool extended) {
+    switch (key) {
+        case VK_SHIFT: {
+            UINT side = MapVirtualKey(scanCode, MAPVK_VSC_TO_VK_EX);
+            return side != 0 ? static_cast<int>(side) : VK_LSHIFT;
+        }
+        case VK_CONTROL: return extended ? VK_RCONTROL : VK_LCONTROL;
+        case VK_MENU: return extended ? VK_RMENU : VK_LMENU;
+        default: return key & 0xFF;
+    }
+}
+
+// States derived from others after each update, never set by events
+bool IsDerivedKey(int key) {
+    switch (key) {
+        case VK_SHIFT: case VK_CONTROL: case VK_MENU:
+        case VK_LBUTTON: case VK_RBUTTON: case VK_MBUTTON: case VK_XBUTTON1: case VK_XBUTTON2:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
 InputManager& InputManager::GetInstance() {
     static InputManager instance;
     return instance;
@@ -16,13 +70,17 @@ InputManager::~InputManager() {
     Shutdown();
 }
 
-bool InputManager::Initialize(HWND hwnd) {
+bool InputManager::Initialize(HWND hwnd, bool rawInput) {
     if (m_initialized) {
         LOG_WARNING("InputManager already initialized");
         return true;
     }
 
     m_hwnd = hwnd;
+    QueryPerformanceFrequency(&m_timerFrequency);
+    QueryPerformanceCounter(&m_timerStart);
+    m_pendingEvents.clear();
+    m_frameEvents.clear();
 
     // Initialize keyboard state
     memset(m_currentKeyStates, 0, sizeof(m_currentKeyStates));
@@ -35,15 +93,23 @@ bool InputManager::Initialize(HWND hwnd) {
     m_cursorVisible = true;
     m_mouseSensitivity = 1.0f;
 
-    // Initialize gamepad states
+    // Initialize gamepad states; every slot is checked on the first update
     for (int i = 0; i < MAX_GAMEPADS; i++) {
         m_currentGamepadStates[i] = GamepadState();
         m_previousGamepadStates[i] = GamepadState();
+        m_gamepadNextPoll[i] = 0.0;
+    }
+    m_gamepadPollInterval = 1.0f;
+
+    // Raw input keeps legacy messages too, so window callbacks still see keys
+    m_rawInput = rawInput && RegisterRawInput();
+    if (rawInput && !m_rawInput) {
+        LOG_WARNING("Raw input registration failed, reading window messages instead");
     }
 
     m_initialized = true;
 
-    LOG_INFO("InputManager initialized successfully");
+    LOG_INFO("InputManager initialized successfully (" << (m_rawInput ? "raw input" : "window messages") << ")");
     return true;
 }
 
@@ -65,6 +131,18 @@ void InputManager::Shutdown() {
         SetGamepadVibration(i, 0.0f, 0.0f);
     }
 
+    if (m_rawInput) {
+        RAWINPUTDEVICE devices[2] = {};
+        devices[0].usUsagePage = HID_USAGE_PAGE_GENERIC;
+        devices[0].usUsage = HID_USAGE_GENERIC_MOUSE;
+        devices[0].dwFlags = RIDEV_REMOVE;
+        devices[1].usUsagePage = HID_USAGE_PAGE_GENERIC;
+        devices[1].usUsage = HID_USAGE_GENERIC_KEYBOARD;
+        devices[1].dwFlags = RIDEV_REMOVE;
+        RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE));
+        m_rawInput = false;
+    }
+
     m_initialized = false;
 
     LOG_INFO("InputManager shut down");
@@ -80,10 +158,12 @@ void InputManager::Update() {
         m_previousGamepadStates[i] = m_currentGamepadStates[i];
     }
 
-    // Update current states
-    UpdateKeyboardState();
+    // Update current states: keys and buttons from the queue instead of
+    // polling every virtual key
+    ApplyEvents();
     UpdateMouseState();
     UpdateGamepadState();
+    UpdateActions();
 }
 
 // Keyboard input methods
@@ -172,29 +252,9 @@ bool InputManager::IsGamepadConnected(int gamepadIndex) const {
 
 bool InputManager::IsGamepadButtonDown(int gamepadIndex, GamepadButton button) const {
     if (gamepadIndex < 0 || gamepadIndex >= MAX_GAMEPADS) return false;
-    if (!m_currentGamepadStates[gamepadIndex].connected) return false;
-
-    // Map GamepadButton to array index
-    int buttonIndex = 0;
-    switch (button) {
-        case GamepadButton::DPadUp: buttonIndex = 0; break;
-        case GamepadButton::DPadDown: buttonIndex = 1; break;
-        case GamepadButton::DPadLeft: buttonIndex = 2; break;
-        case GamepadButton::DPadRight: buttonIndex = 3; break;
-        case GamepadButton::Start: buttonIndex = 4; break;
-        case GamepadButton::Back: buttonIndex = 5; break;
-        case GamepadButton::LeftThumb: buttonIndex = 6; break;
-        case GamepadButton::RightThumb: buttonIndex = 7; break;
-        case GamepadButton::LeftShoulder: buttonIndex = 8; break;
-        case GamepadButton::RightShoulder: buttonIndex = 9; break;
-        case GamepadButton::A: buttonIndex = 10; break;
-        case GamepadButton::B: buttonIndex = 11; break;
-        case GamepadButton::X: buttonIndex = 12; break;
-        case GamepadButton::Y: buttonIndex = 13; break;
-        default: return false;
-    }
-
-    return m_currentGamepadStates[gamepadIndex].buttons[buttonIndex];
+
+    int buttonIndex = GetGamepadButtonIndex(button);
+    return buttonIndex >= 0 && m_currentGamepadStates[gamepadIndex].buttons[buttonIndex];
 }
 
 bool InputManager::IsGamepadButtonPressed(int gamepadIndex, GamepadButton button) const {
@@ -262,59 +322,61 @@ void InputManager::SetGamepadVibration(int gamepadIndex, float leftMotor, float
     XInputSetState(gamepadIndex, &vibration);
 }
 
-// Window message handling
+// Window message handling: only queues events, Update applies them
 void InputManager::HandleWindowMessage(UINT message, WPARAM wParam, LPARAM lParam) {
+    if (!m_initialized) return;
+
     switch (message) {
-        case WM_KEYDOWN:
-        case WM_SYSKEYDOWN:
-            if (m_keyCallback) {
-                KeyCode key = static_cast<KeyCode>(wParam);
-                InputState state = IsKeyPressed(key) ? InputState::Pressed : InputState::Held;
-                TriggerKeyCallback(key, state);
+        case WM_INPUT:
+            if (m_rawInput) {
+                HandleRawInput(reinterpret_cast<HRAWINPUT>(lParam));
             }
             break;
 
+        case WM_KEYDOWN:
+        case WM_SYSKEYDOWN:
         case WM_KEYUP:
         case WM_SYSKEYUP:
-            if (m_keyCallback) {
-                KeyCode key = static_cast<KeyCode>(wParam);
-                TriggerKeyCallback(key, InputState::Released);
+            if (!m_rawInput) {
+                bool down = (message == WM_KEYDOWN || message == WM_SYSKEYDOWN);
+                UINT scanCode = (lParam >> 16) & 0xFF;
+                bool extended = (lParam & (1 << 24)) != 0;
+                QueueEvent(InputEvent::Type::Key, ResolveVirtualKey(static_cast<int>(wParam), scanCode, extended), down);
             }
             break;
 
         case WM_LBUTTONDOWN:
-            if (m_mouseButtonCallback) {
-                TriggerMouseButtonCallback(MouseButton::Left, InputState::Pressed);
-            }
-            break;
-
         case WM_LBUTTONUP:
-            if (m_mouseButtonCallback) {
-                TriggerMouseButtonCallback(MouseButton::Left, InputState::Released);
+            if (!m_rawInput) {
+                QueueEvent(InputEvent::Type::MouseButton, static_cast<int>(MouseButton::Left), message == WM_LBUTTONDOWN);
             }
             break;
 
         case WM_RBUTTONDOWN:
-            if (m_mouseButtonCallback) {
-                TriggerMouseButtonCallback(MouseButton::Right, InputState::Pressed);
+        case WM_RBUTTONUP:
+            if (!m_rawInput) {
+                QueueEvent(InputEvent::Type::MouseButton, static_cast<int>(MouseButton::Right), message == WM_RBUTTONDOWN);
             }
             break;
 
-        case WM_RBUTTONUP:
-            if (m_mouseButtonCallback) {
-                TriggerMouseButtonCallback(MouseButton::Right, InputState::Released);
+        case WM_MBUTTONDOWN:
+        case WM_MBUTTONUP:
+            if (!m_rawInput) {
+                QueueEvent(InputEvent::Type::MouseButton, static_cast<int>(MouseButton::Middle), message == WM_MBUTTONDOWN);
             }
             break;
 
-        case WM_MBUTTONDOWN:
-            if (m_mouseButtonCallback) {
-                TriggerMouseButtonCallback(MouseButton::Middle, InputState::Pressed);
+        case WM_XBUTTONDOWN:
+        case WM_XBUTTONUP:
+            if (!m_rawInput) {
+                MouseButton button = GET_XBUTTON_WPARAM(wParam) == XBUTTON1 ? MouseButton::X1 : MouseButton::X2;
+                QueueEvent(InputEvent::Type::MouseButton, static_cast<int>(button), message == WM_XBUTTONDOWN);
             }
             break;
 
-        case WM_MBUTTONUP:
-            if (m_mouseButtonCallback) {
-                TriggerMouseButtonCallback(MouseButton::Middle, InputState::Released);
+        case WM_MOUSEWHEEL:
+            if (!m_rawInput) {
+                QueueEvent(InputEvent::Type::MouseWheel, 0, false, 0, GET_WHEEL_DELTA_WPARAM(wParam));
             }
             break;
 
@@ -328,105 +390,219 @@ void InputManager::HandleWindowMessage(UINT message, WPARAM wParam, LPARAM lPara
             }
             break;
 
-        case WM_MOUSEWHEEL:
-            if (m_mouseWheelCallback) {
-                int delta = GET_WHEEL_DELTA_WPARAM(wParam);
-                m_mouseWheelCallback(delta);
+        case WM_KILLFOCUS:
+            // Releases happen while another window has focus; don't leave keys stuck
+            QueueReleaseAll();
+            break;
+
+        case WM_DEVICECHANGE:
+            // A pad may have been plugged in, check the empty slots now
+            for (int i = 0; i < MAX_GAMEPADS; i++) {
+                m_gamepadNextPoll[i] = 0.0;
             }
             break;
     }
 }
 
 // Input binding methods
-void InputManager::BindKey(const std::string& action, KeyCode key) {
-    InputBinding binding;
-    binding.type = InputBinding::Key;
-    binding.key = key;
-    m_inputBindings[action].push_back(binding);
+void InputManager::BindKey(Core::StringId action, KeyCode key) {
+    BindSource(action, &m_currentKeyStates[static_cast<int>(key) & 0xFF]);
 }
 
-void InputManager::BindMouseButton(const std::string& action, MouseButton button) {
-    InputBinding binding;
-    binding.type = InputBinding::MouseBtn;
-    binding.mouseButton = button;
-    m_inputBindings[action].push_back(binding);
+void InputManager::BindMouseButton(Core::StringId action, MouseButton button) {
+    int buttonIndex = static_cast<int>(button);
+    if (buttonIndex < 0 || buttonIndex >= 5) return;
+
+    BindSource(action, &m_currentMouseState.buttons[buttonIndex]);
 }
 
-void InputManager::BindGamepadButton(const std::string& action, int gamepadIndex, GamepadButton button) {
-    InputBinding binding;
-    binding.type = InputBinding::GamepadBtn;
-    binding.gamepad.gamepadIndex = gamepadIndex;
-    binding.gamepad.button = button;
-    m_inputBindings[action].push_back(binding);
+void InputManager::BindGamepadButton(Core::StringId action, int gamepadIndex, GamepadButton button) {
+    int buttonIndex = GetGamepadButtonIndex(button);
+    if (gamepadIndex < 0 || gamepadIndex >= MAX_GAMEPADS || buttonIndex < 0) {
+        LOG_WARNING("Ignoring gamepad binding for " << action << ": invalid gamepad or button");
+        return;
+    }
+
+    BindSource(action, &m_currentGamepadStates[gamepadIndex].buttons[buttonIndex]);
 }
 
-bool InputManager::IsActionPressed(const std::string& action) const {
-    auto it = m_inputBindings.find(action);
-    if (it == m_inputBindings.end()) return false;
+void InputManager::ClearBindings() {
+    m_actions.clear();
+    m_actionIndices.clear();
+}
 
-    for (const auto& binding : it->second) {
-        switch (binding.type) {
-            case InputBinding::Key:
-                if (IsKeyPressed(binding.key)) return true;
-                break;
-            case InputBinding::MouseBtn:
-                if (IsMouseButtonPressed(binding.mouseButton)) return true;
-                break;
-            case InputBinding::GamepadBtn:
-                if (IsGamepadButtonPressed(binding.gamepad.gamepadIndex, binding.gamepad.button)) return true;
-                break;
-        }
-    }
+bool InputManager::IsActionPressed(Core::StringId action) const {
+    const ActionState* state = FindAction(action);
+    return state && state->current && !state->previous;
+}
 
-    return false;
+bool InputManager::IsActionHeld(Core::StringId action) const {
+    const ActionState* state = FindAction(action);
+    return state && state->current;
 }
 
-bool InputManager::IsActionHeld(const std::string& action) const {
-    auto it = m_inputBindings.find(action);
-    if (it == m_inputBindings.end()) return false;
+bool InputManager::IsActionReleased(Core::StringId action) const {
+    const ActionState* state = FindAction(action);
+    return state && !state->current && state->previous;
+}
 
-    for (const auto& binding : it->second) {
-        switch (binding.type) {
-            case InputBinding::Key:
-                if (IsKeyDown(binding.key)) return true;
-                break;
-            case InputBinding::MouseBtn:
-                if (IsMouseButtonDown(binding.mouseButton)) return true;
-                break;
-            case InputBinding::GamepadBtn:
-                if (IsGamepadButtonDown(binding.gamepad.gamepadIndex, binding.gamepad.button)) return true;
-                break;
+// Private methods
+bool InputManager::RegisterRawInput() {
+    RAWINPUTDEVICE devices[2] = {};
+    devices[0].usUsagePage = HID_USAGE_PAGE_GENERIC;
+    devices[0].usUsage = HID_USAGE_GENERIC_MOUSE;
+    devices[0].hwndTarget = m_hwnd;
+    devices[1].usUsagePage = HID_USAGE_PAGE_GENERIC;
+    devices[1].usUsage = HID_USAGE_GENERIC_KEYBOARD;
+    devices[1].hwndTarget = m_hwnd;
+
+    return RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE)) != FALSE;
+}
+
+void InputManager::HandleRawInput(HRAWINPUT handle) {
+    // Only the mouse and keyboard are registered, so one RAWINPUT always fits
+    RAWINPUT input;
+    UINT size = sizeof(input);
+    if (GetRawInputData(handle, RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1)) {
+        return;
+    }
+
+    if (input.header.dwType == RIM_TYPEKEYBOARD) {
+        const RAWKEYBOARD& keyboard = input.data.keyboard;
+        // 0xFF is sent for the prefix of some escaped sequences
+        if (keyboard.VKey == 0xFF) return;
+
+        bool extended = (keyboard.Flags & RI_KEY_E0) != 0;
+        bool down = (keyboard.Flags & RI_KEY_BREAK) == 0;
+        QueueEvent(InputEvent::Type::Key, ResolveVirtualKey(keyboard.VKey, keyboard.MakeCode, extended), down);
+    }
+    else if (input.header.dwType == RIM_TYPEMOUSE) {
+        const RAWMOUSE& mouse = input.data.mouse;
+
+        // Tablets and remote sessions report absolute positions; the cursor covers those
+        if ((mouse.usFlags & MOUSE_MOVE_ABSOLUTE) == 0 && (mouse.lLastX != 0 || mouse.lLastY != 0)) {
+            QueueEvent(InputEvent::Type::MouseMove, 0, false, mouse.lLastX, mouse.lLastY);
+        }
+
+        for (int i = 0; i < 5; i++) {
+            if (mouse.usButtonFlags & RAW_BUTTON_DOWN[i]) {
+                QueueEvent(InputEvent::Type::MouseButton, i, true);
+            }
+            if (mouse.usButtonFlags & RAW_BUTTON_UP[i]) {
+                QueueEvent(InputEvent::Type::MouseButton, i, false);
+            }
+        }
+
+        if (mouse.usButtonFlags & RI_MOUSE_WHEEL) {
+            QueueEvent(InputEvent::Type::MouseWheel, 0, false, 0, static_cast<SHORT>(mouse.usButtonData));
+        }
+    }
+}
+
+void InputManager::QueueEvent(InputEvent::Type type, int code, bool down, int deltaX, int deltaY) {
+    InputEvent event;
+    event.type = type;
+    event.code = code;
+    event.down = down;
+    event.deltaX = deltaX;
+    event.deltaY = deltaY;
+    event.time = GetTime();
+    m_pendingEvents.push_back(event);
+}
+
+void InputManager::QueueReleaseAll() {
+    // State once the events already queued are applied
+    bool keys[256];
+    bool buttons[5];
+    memcpy(keys, m_currentKeyStates, sizeof(keys));
+    memcpy(buttons, m_currentMouseState.buttons, sizeof(buttons));
+    for (const InputEvent& event : m_pendingEvents) {
+        if (event.type == InputEvent::Type::Key) {
+            keys[event.code] = event.down;
+        } else if (event.type == InputEvent::Type::MouseButton) {
+            buttons[event.code] = event.down;
         }
     }
 
-    return false;
+    for (int i = 0; i < 256; i++) {
+        if (keys[i] && !IsDerivedKey(i)) {
+            QueueEvent(InputEvent::Type::Key, i, false);
+        }
+    }
+    for (int i = 0; i < 5; i++) {
+        if (buttons[i]) {
+            QueueEvent(InputEvent::Type::MouseButton, i, false);
+        }
+    }
 }
 
-bool InputManager::IsActionReleased(const std::string& action) const {
-    auto it = m_inputBindings.find(action);
-    if (it == m_inputBindings.end()) return false;
+void InputManager::ApplyEvents() {
+    m_frameEvents.clear();
+    m_currentMouseState.deltaX = 0;
+    m_currentMouseState.deltaY = 0;
+    m_currentMouseState.wheelDelta = 0;
 
-    for (const auto& binding : it->second) {
-        switch (binding.type) {
-            case InputBinding::Key:
-                if (IsKeyReleased(binding.key)) return true;
+    // A key or button changes at most once per frame. A second change waits
+    // for the next one, so a tap shorter than a frame still reads as pressed.
+    bool keyChanged[256] = {};
+    bool buttonChanged[5] = {};
+    m_deferredEvents.clear();
+
+    for (const InputEvent& event : m_pendingEvents) {
+        switch (event.type) {
+            case InputEvent::Type::Key: {
+                if (keyChanged[event.code]) {
+                    m_deferredEvents.push_back(event);
+                    continue;
+                }
+                // Auto-repeat and duplicate releases change nothing
+                if (m_currentKeyStates[event.code] == event.down) {
+                    continue;
+                }
+                m_currentKeyStates[event.code] = event.down;
+                keyChanged[event.code] = true;
+                TriggerKeyCallback(static_cast<KeyCode>(event.code), event.down ? InputState::Pressed : InputState::Released);
                 break;
-            case InputBinding::MouseBtn:
-                if (IsMouseButtonReleased(binding.mouseButton)) return true;
+            }
+
+            case InputEvent::Type::MouseButton: {
+                if (buttonChanged[event.code]) {
+                    m_deferredEvents.push_back(event);
+                    continue;
+                }
+                if (m_currentMouseState.buttons[event.code] == event.down) {
+                    continue;
+                }
+                m_currentMouseState.buttons[event.code] = event.down;
+                buttonChanged[event.code] = true;
+                TriggerMouseButtonCallback(static_cast<MouseButton>(event.code), event.down ? InputState::Pressed : InputState::Released);
                 break;
-            case InputBinding::GamepadBtn:
-                if (IsGamepadButtonReleased(binding.gamepad.gamepadIndex, binding.gamepad.button)) return true;
+            }
+
+            case InputEvent::Type::MouseMove:
+                m_currentMouseState.deltaX += event.deltaX;
+                m_currentMouseState.deltaY += event.deltaY;
+                break;
+
+            case InputEvent::Type::MouseWheel:
+                m_currentMouseState.wheelDelta += event.deltaY;
+                if (m_mouseWheelCallback) {
+                    m_mouseWheelCallback(event.deltaY);
+                }
                 break;
         }
+
+        m_frameEvents.push_back(event);
     }
 
-    return false;
-}
+    m_pendingEvents.swap(m_deferredEvents);
 
-// Private methods
-void InputManager::UpdateKeyboardState() {
-    for (int i = 0; i < 256; i++) {
-        m_currentKeyStates[i] = (GetAsyncKeyState(i) & 0x8000) != 0;
+    // Generic modifiers and mouse keys read as GetAsyncKeyState reports them
+    m_currentKeyStates[VK_SHIFT] = m_currentKeyStates[VK_LSHIFT] || m_currentKeyStates[VK_RSHIFT];
+    m_currentKeyStates[VK_CONTROL] = m_currentKeyStates[VK_LCONTROL] || m_currentKeyStates[VK_RCONTROL];
+    m_currentKeyStates[VK_MENU] = m_currentKeyStates[VK_LMENU] || m_currentKeyStates[VK_RMENU];
+    for (int i = 0; i < 5; i++) {
+        m_currentKeyStates[MOUSE_BUTTON_KEYS[i]] = m_currentMouseState.buttons[i];
     }
 }
 
@@ -436,53 +612,46 @@ void InputManager::UpdateMouseState() {
     GetCursorPos(&cursorPos);
     ScreenToClient(m_hwnd, &cursorPos);
 
-    // Calculate delta with sensitivity applied
-    int rawDeltaX = cursorPos.x - m_currentMouseState.x;
-    int rawDeltaY = cursorPos.y - m_currentMouseState.y;
+    // Raw counts were summed from the queue; they keep coming at the edge of
+    // the screen or a locked cursor, where the position stops changing
+    int rawDeltaX = m_currentMouseState.deltaX;
+    int rawDeltaY = m_currentMouseState.deltaY;
+    if (!m_rawInput) {
+        rawDeltaX = cursorPos.x - m_currentMouseState.x;
+        rawDeltaY = cursorPos.y - m_currentMouseState.y;
+    }
+
+    // Apply sensitivity
     m_currentMouseState.deltaX = static_cast<int>(rawDeltaX * m_mouseSensitivity);
     m_currentMouseState.deltaY = static_cast<int>(rawDeltaY * m_mouseSensitivity);
 
     // Update position
     m_currentMouseState.x = cursorPos.x;
     m_currentMouseState.y = cursorPos.y;
-
-    // Update button states
-    m_currentMouseState.buttons[0] = (GetAsyncKeyState(VK_LBUTTON) & 0x8000) != 0;
-    m_currentMouseState.buttons[1] = (GetAsyncKeyState(VK_RBUTTON) & 0x8000) != 0;
-    m_currentMouseState.buttons[2] = (GetAsyncKeyState(VK_MBUTTON) & 0x8000) != 0;
-    m_currentMouseState.buttons[3] = (GetAsyncKeyState(VK_XBUTTON1) & 0x8000) != 0;
-    m_currentMouseState.buttons[4] = (GetAsyncKeyState(VK_XBUTTON2) & 0x8000) != 0;
-
-    // Reset wheel delta (it's handled by window messages)
-    m_currentMouseState.wheelDelta = 0;
 }
 
 void InputManager::UpdateGamepadState() {
+    double now = GetTime();
+
     for (int i = 0; i < MAX_GAMEPADS; i++) {
+        GamepadState& gamepadState = m_currentGamepadStates[i];
+
+        // XInputGetState on an empty slot is slow, so those wait their turn
+        if (!gamepadState.connected && now < m_gamepadNextPoll[i]) {
+            continue;
+        }
+
         XINPUT_STATE xinputState;
         DWORD result = XInputGetState(i, &xinputState);
 
-        GamepadState& gamepadState = m_currentGamepadStates[i];
-
         if (result == ERROR_SUCCESS) {
             gamepadState.connected = true;
 
             // Update button states
             WORD buttons = xinputState.Gamepad.wButtons;
-            gamepadState.buttons[0] = (buttons & XINPUT_GAMEPAD_DPAD_UP) != 0;
-            gamepadState.buttons[1] = (buttons & XINPUT_GAMEPAD_DPAD_DOWN) != 0;
-            gamepadState.buttons[2] = (buttons & XINPUT_GAMEPAD_DPAD_LEFT) != 0;
-            gamepadState.buttons[3] = (buttons & XINPUT_GAMEPAD_DPAD_RIGHT) != 0;
-            gamepadState.buttons[4] = (buttons & XINPUT_GAMEPAD_START) != 0;
-            gamepadState.buttons[5] = (buttons & XINPUT_GAMEPAD_BACK) != 0;
-            gamepadState.buttons[6] = (buttons & XINPUT_GAMEPAD_LEFT_THUMB) != 0;
-            gamepadState.buttons[7] = (buttons & XINPUT_GAMEPAD_RIGHT_THUMB) != 0;
-            gamepadState.buttons[8] = (buttons & XINPUT_GAMEPAD_LEFT_SHOULDER) != 0;
-            gamepadState.buttons[9] = (buttons & XINPUT_GAMEPAD_RIGHT_SHOULDER) != 0;
-            gamepadState.buttons[10] = (buttons & XINPUT_GAMEPAD_A) != 0;
-            gamepadState.buttons[11] = (buttons & XINPUT_GAMEPAD_B) != 0;
-            gamepadState.buttons[12] = (buttons & XINPUT_GAMEPAD_X) != 0;
-            gamepadState.buttons[13] = (buttons & XINPUT_GAMEPAD_Y) != 0;
+            for (int b = 0; b < 14; b++) {
+                gamepadState.buttons[b] = (buttons & GAMEPAD_BUTTON_MASKS[b]) != 0;
+            }
 
             // Update triggers
             gamepadState.leftTrigger = NormalizeTriggerValue(xinputState.Gamepad.bLeftTrigger);
@@ -494,11 +663,57 @@ void InputManager::UpdateGamepadState() {
             gamepadState.rightStickX = NormalizeStickValue(xinputState.Gamepad.sThumbRX);
             gamepadState.rightStickY = NormalizeStickValue(xinputState.Gamepad.sThumbRY);
         } else {
-            gamepadState.connected = false;
+            // Clear everything so bindings and held buttons read as released
+            gamepadState = GamepadState();
+            m_gamepadNextPoll[i] = now + m_gamepadPollInterval;
+        }
+
+        if (m_gamepadButtonCallback) {
+            const GamepadState& previous = m_previousGamepadStates[i];
+            for (int b = 0; b < 14; b++) {
+                if (gamepadState.buttons[b] != previous.buttons[b]) {
+                    TriggerGamepadButtonCallback(i, static_cast<GamepadButton>(GAMEPAD_BUTTON_MASKS[b]),
+                                                 gamepadState.buttons[b] ? InputState::Pressed : InputState::Released);
+                }
+            }
+        }
+    }
+}
+
+void InputManager::UpdateActions() {
+    for (ActionState& action : m_actions) {
+        action.previous = action.current;
+        action.current = false;
+        for (const bool* source : action.sources) {
+            if (*source) {
+                action.current = true;
+                break;
+            }
         }
     }
 }
 
+void InputManager::BindSource(Core::StringId action, const bool* source) {
+    auto it = m_actionIndices.find(action);
+    if (it == m_actionIndices.end()) {
+        it = m_actionIndices.emplace(action, m_actions.size()).first;
+        m_actions.push_back({ action, {}, false, false });
+    }
+
+    m_actions[it->second].sources.push_back(source);
+}
+
+const InputManager::ActionState* InputManager::FindAction(Core::StringId action) const {
+    auto it = m_actionIndices.find(action);
+    return it != m_actionIndices.end() ? &m_actions[it->second] : nullptr;
+}
+
+double InputManager::GetTime() const {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return static_cast<double>(now.QuadPart - m_timerStart.QuadPart) / static_cast<double>(m_timerFrequency.QuadPart);
+}
+
 InputState InputManager::GetKeyState(KeyCode key) const {
     int keyIndex = static_cast<int>(key);
     bool current = m_currentKeyStates[keyIndex];
@@ -524,10 +739,11 @@ InputState InputManager::GetMouseButtonState(MouseButton button) const {
 InputState InputManager::GetGamepadButtonState(int gamepadIndex, GamepadButton button) const {
     if (gamepadIndex < 0 || gamepadIndex >= MAX_GAMEPADS) return InputState::None;
 
-    bool current = IsGamepadButtonDown(gamepadIndex, button);
+    int buttonIndex = GetGamepadButtonIndex(button);
+    if (buttonIndex < 0) return InputState::None;
 
-    // Get previous state (simplified for now)
-    bool previous = false; // Would need proper tracking
+    bool current = m_currentGamepadStates[gamepadIndex].buttons[buttonIndex];
+    bool previous = m_previousGamepadStates[gamepadIndex].buttons[buttonIndex];
 
     if (current && !previous) return InputState::Pressed;
     if (current && previous) return InputState::Held;
@@ -553,6 +769,15 @@ void InputManager::TriggerGamepadButtonCallback(int gamepadIndex, GamepadButton
     }
 }
 
+int InputManager::GetGamepadButtonIndex(GamepadButton button) {
+    for (int i = 0; i < 14; i++) {
+        if (GAMEPAD_BUTTON_MASKS[i] == static_cast<WORD>(button)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 float InputManager::NormalizeStickValue(SHORT value, SHORT deadzone) const {
     if (value > deadzone) {
         return static_cast<float>(value - deadzone) / (32767 - deadzone);
@@ -2,6 +2,8 @@
 
 #include <Windows.h>
 #include <Xinput.h>
+#include "../Core/StringId.h"
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 #include <functional>
@@ -116,6 +118,23 @@ struct GamepadState {
     }
 };
 
+// One change of input, in arrival order. Key and button events carry the
+// new down state; mouse moves carry raw counts and the wheel its delta.
+struct InputEvent {
+    enum class Type {
+        Key,
+        MouseButton,
+        MouseMove,
+        MouseWheel
+    };
+
+    Type type;
+    int code;           // Virtual key or MouseButton index
+    bool down;
+    int deltaX, deltaY; // Mouse move counts, or wheel delta in deltaY
+    double time;        // Seconds since Initialize, taken when the message arrived
+};
+
 // Input event callbacks
 using KeyCallback = std::function<void(KeyCode key, InputState state)>;
 using MouseButtonCallback = std::function<void(MouseButton button, InputState state, int x, int y)>;
@@ -129,13 +148,17 @@ public:
 
     ~InputManager();
 
-    // Initialization
-    bool Initialize(HWND hwnd);
+    // Initialization; without raw input, window key and button messages feed the queue
+    bool Initialize(HWND hwnd, bool rawInput = true);
     void Shutdown();
 
-    // Update (call every frame)
+    // Update (call every frame): applies the queued events to the frame's state
     void Update();
 
+    // Events applied by the last Update, oldest first
+    const std::vector<InputEvent>& GetEvents() const { return m_frameEvents; }
+    bool IsRawInputActive() const { return m_rawInput; }
+
     // Keyboard input
     bool IsKeyDown(KeyCode key) const;
     bool IsKeyUp(KeyCode key) const;
@@ -175,6 +198,11 @@ public:
     // Vibration
     void SetGamepadVibration(int gamepadIndex, float leftMotor, float rightMotor);
 
+    // Empty slots are checked this often instead of every frame; a device
+    // change notification checks them straight away
+    void SetGamepadPollInterval(float seconds) { m_gamepadPollInterval = seconds; }
+    float GetGamepadPollInterval() const { return m_gamepadPollInterval; }
+
     // Event callbacks
     void SetKeyCallback(KeyCallback callback) { m_keyCallback = callback; }
     void SetMouseButtonCallback(MouseButtonCallback callback) { m_mouseButtonCallback = callback; }
@@ -185,14 +213,16 @@ public:
     // Window message handling
     void HandleWindowMessage(UINT message, WPARAM wParam, LPARAM lParam);
 
-    // Input binding system
-    void BindKey(const std::string& action, KeyCode key);
-    void BindMouseButton(const std::string& action, MouseButton button);
-    void BindGamepadButton(const std::string& action, int gamepadIndex, GamepadButton button);
+    // Input binding system. Bindings resolve to the state they read when
+    // made, and each Update evaluates every action once.
+    void BindKey(Core::StringId action, KeyCode key);
+    void BindMouseButton(Core::StringId action, MouseButton button);
+    void BindGamepadButton(Core::StringId action, int gamepadIndex, GamepadButton button);
+    void ClearBindings();
 
-    bool IsActionPressed(const std::string& action) const;
-    bool IsActionHeld(const std::string& action) const;
-    bool IsActionReleased(const std::string& action) const;
+    bool IsActionPressed(Core::StringId action) const;
+    bool IsActionHeld(Core::StringId action) const;
+    bool IsActionReleased(Core::StringId action) const;
 
 private:
     InputManager() = default;
@@ -202,6 +232,14 @@ private:
     // Internal state
     HWND m_hwnd;
     bool m_initialized;
+    bool m_rawInput;
+
+    // Event queue: filled by HandleWindowMessage, drained by Update
+    std::vector<InputEvent> m_pendingEvents;
+    std::vector<InputEvent> m_frameEvents;
+    std::vector<InputEvent> m_deferredEvents;
+    LARGE_INTEGER m_timerFrequency;
+    LARGE_INTEGER m_timerStart;
 
     // Keyboard state
     bool m_currentKeyStates[256];
@@ -218,6 +256,8 @@ private:
     static constexpr int MAX_GAMEPADS = 4;
     GamepadState m_currentGamepadStates[MAX_GAMEPADS];
     GamepadState m_previousGamepadStates[MAX_GAMEPADS];
+    double m_gamepadNextPoll[MAX_GAMEPADS];  // Time an empty slot is checked again
+    float m_gamepadPollInterval;
 
     // Callbacks
     KeyCallback m_keyCallback;
@@ -226,25 +266,29 @@ private:
     MouseWheelCallback m_mouseWheelCallback;
     GamepadButtonCallback m_gamepadButtonCallback;
 
-    // Input binding system
-    struct InputBinding {
-        enum Type { Key, MouseBtn, GamepadBtn } type;
-        union {
-            KeyCode key;
-            MouseButton mouseButton;
-            struct {
-                int gamepadIndex;
-                GamepadButton button;
-            } gamepad;
-        };
+    // Actions: each binding is a pointer to the state flag it reads
+    struct ActionState {
+        Core::StringId id;
+        std::vector<const bool*> sources;
+        bool current;
+        bool previous;
     };
 
-    std::unordered_map<std::string, std::vector<InputBinding>> m_inputBindings;
+    std::vector<ActionState> m_actions;
+    std::unordered_map<Core::StringId, size_t> m_actionIndices;
 
     // Internal methods
-    void UpdateKeyboardState();
+    bool RegisterRawInput();
+    void HandleRawInput(HRAWINPUT handle);
+    void QueueEvent(InputEvent::Type type, int code, bool down, int deltaX = 0, int deltaY = 0);
+    void QueueReleaseAll();
+    void ApplyEvents();
     void UpdateMouseState();
     void UpdateGamepadState();
+    void UpdateActions();
+    void BindSource(Core::StringId action, const bool* source);
+    const ActionState* FindAction(Core::StringId action) const;
+    double GetTime() const;
 
     InputState GetKeyState(KeyCode key) const;
     InputState GetMouseButtonState(MouseButton button) const;
@@ -255,6 +299,7 @@ private:
     void TriggerGamepadButtonCallback(int gamepadIndex, GamepadButton button, InputState state);
 
     // Utility functions
+    static int GetGamepadButtonIndex(GamepadButton button);
     float NormalizeStickValue(SHORT value, SHORT deadzone = XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE) const;
     float NormalizeTriggerValue(BYTE value) const;
 };
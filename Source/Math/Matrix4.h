@@ -92,21 +92,19 @@ public:
     }
 
     // Get components
+    // Read straight from the rows instead of storing the whole matrix
     Vector3 GetTranslation() const {
-        DirectX::XMFLOAT4X4 matrix;
-        DirectX::XMStoreFloat4x4(&matrix, m_matrix);
-        return Vector3(matrix._41, matrix._42, matrix._43);
+        return Vector3(m_matrix.r[3]);
     }
 
     Vector3 GetScale() const {
-        DirectX::XMFLOAT4X4 matrix;
-        DirectX::XMStoreFloat4x4(&matrix, m_matrix);
-
-        Vector3 scale;
-        scale.x = Vector3(matrix._11, matrix._12, matrix._13).Length();
-        scale.y = Vector3(matrix._21, matrix._22, matrix._23).Length();
-        scale.z = Vector3(matrix._31, matrix._32, matrix._33).Length();
-        return scale;
+        using namespace DirectX;
+        XMVECTOR x = XMVector3LengthSq(m_matrix.r[0]);
+        XMVECTOR y = XMVector3LengthSq(m_matrix.r[1]);
+        XMVECTOR z = XMVector3LengthSq(m_matrix.r[2]);
+        // One square root for all three axes
+        XMVECTOR xy = XMVectorMergeXY(x, y);
+        return Vector3(XMVectorSqrt(XMVectorPermute<0, 1, 4, 5>(xy, z)));
     }
 
     // Convert to DirectX types
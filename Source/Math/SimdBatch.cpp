@@ -0,0 +1,375 @@
+#include "SimdBatch.h"
+#include <DirectXMath.h>
+#include <atomic>
+#include <cmath>
+#if SIMD_BATCH_AVX2 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+using namespace DirectX;
+
+namespace GameEngine {
+namespace Math {
+namespace Simd {
+
+#if SIMD_BATCH_AVX2
+// SimdBatchAVX2.cpp, built with AVX2 code generation. Each returns how many
+// leading items it did, a multiple of eight; the rest go to the scalar path.
+namespace Avx2 {
+std::size_t TransformPoints(const float* matrix, ConstVector3SoA points, Vector3SoA out, std::size_t count);
+std::size_t TransformBounds(const float* matrix, ConstVector3SoA centers, ConstVector3SoA extents,
+                            Vector3SoA outCenters, Vector3SoA outExtents, std::size_t count);
+std::size_t TestSpheresFrustum(const float* planes, ConstVector3SoA centers, const float* radii,
+                               std::uint8_t* visible, std::size_t count);
+std::size_t NlerpQuaternions(ConstQuaternionSoA from, ConstQuaternionSoA to, float t,
+                             QuaternionSoA out, std::size_t count);
+} // namespace Avx2
+#endif
+
+namespace {
+
+// One item at a time; also finishes the wider paths' remainders
+
+void TransformPointsScalar(const float* m, ConstVector3SoA points, Vector3SoA out, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+        float x = points.x[i];
+        float y = points.y[i];
+        float z = points.z[i];
+        out.x[i] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        out.y[i] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        out.z[i] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+}
+
+void TransformBoundsScalar(const float* m, ConstVector3SoA centers, ConstVector3SoA extents,
+                           Vector3SoA outCenters, Vector3SoA outExtents, std::size_t begin, std::size_t end) {
+    TransformPointsScalar(m, centers, outCenters, begin, end);
+    for (std::size_t i = begin; i < end; i++) {
+        float x = extents.x[i];
+        float y = extents.y[i];
+        float z = extents.z[i];
+        outExtents.x[i] = x * std::fabs(m[0]) + y * std::fabs(m[4]) + z * std::fabs(m[8]);
+        outExtents.y[i] = x * std::fabs(m[1]) + y * std::fabs(m[5]) + z * std::fabs(m[9]);
+        outExtents.z[i] = x * std::fabs(m[2]) + y * std::fabs(m[6]) + z * std::fabs(m[10]);
+    }
+}
+
+void TestSpheresFrustumScalar(const float* planes, ConstVector3SoA centers, const float* radii,
+                              std::uint8_t* visible, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+        bool inside = true;
+        for (int p = 0; p < 6; p++) {
+            const float* plane = planes + p * 4;
+            float distance = centers.x[i] * plane[0] + centers.y[i] * plane[1] + centers.z[i] * plane[2] + plane[3];
+            inside = inside && distance >= -radii[i];
+        }
+        visible[i] = inside ? 1 : 0;
+    }
+}
+
+void NlerpQuaternionsScalar(ConstQuaternionSoA from, ConstQuaternionSoA to, float t,
+                            QuaternionSoA out, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+        float dot = from.x[i] * to.x[i] + from.y[i] * to.y[i] + from.z[i] * to.z[i] + from.w[i] * to.w[i];
+        float s = dot < 0.0f ? -t : t;
+        float x = from.x[i] * (1.0f - t) + to.x[i] * s;
+        float y = from.y[i] * (1.0f - t) + to.y[i] * s;
+        float z = from.z[i] * (1.0f - t) + to.z[i] * s;
+        float w = from.w[i] * (1.0f - t) + to.w[i] * s;
+
+        // Opposite rotations blended halfway cancel out; identity then
+        float lengthSquared = x * x + y * y + z * z + w * w;
+        if (lengthSquared > 1e-8f) {
+            float inverse = 1.0f / std::sqrt(lengthSquared);
+            out.x[i] = x * inverse;
+            out.y[i] = y * inverse;
+            out.z[i] = z * inverse;
+            out.w[i] = w * inverse;
+        } else {
+            out.x[i] = 0.0f;
+            out.y[i] = 0.0f;
+            out.z[i] = 0.0f;
+            out.w[i] = 1.0f;
+        }
+    }
+}
+
+// Four items per register through DirectXMath
+
+XMVECTOR Load4(const float* values) {
+    return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(values));
+}
+
+void Store4(float* values, FXMVECTOR v) {
+    XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(values), v);
+}
+
+void TransformPointsVector4(const float* m, ConstVector3SoA points, Vector3SoA out, std::size_t count) {
+    XMVECTOR r[12];
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 3; column++) {
+            r[row * 3 + column] = XMVectorReplicate(m[row * 4 + column]);
+        }
+    }
+
+    std::size_t end = count & ~std::size_t(3);
+    for (std::size_t i = 0; i < end; i += 4) {
+        XMVECTOR x = Load4(points.x + i);
+        XMVECTOR y = Load4(points.y + i);
+        XMVECTOR z = Load4(points.z + i);
+        Store4(out.x + i, XMVectorMultiplyAdd(x, r[0], XMVectorMultiplyAdd(y, r[3], XMVectorMultiplyAdd(z, r[6], r[9]))));
+        Store4(out.y + i, XMVectorMultiplyAdd(x, r[1], XMVectorMultiplyAdd(y, r[4], XMVectorMultiplyAdd(z, r[7], r[10]))));
+        Store4(out.z + i, XMVectorMultiplyAdd(x, r[2], XMVectorMultiplyAdd(y, r[5], XMVectorMultiplyAdd(z, r[8], r[11]))));
+    }
+    TransformPointsScalar(m, points, out, end, count);
+}
+
+void TransformBoundsVector4(const float* m, ConstVector3SoA centers, ConstVector3SoA extents,
+                            Vector3SoA outCenters, Vector3SoA outExtents, std::size_t count) {
+    TransformPointsVector4(m, centers, outCenters, count);
+
+    XMVECTOR a[9];
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            a[row * 3 + column] = XMVectorReplicate(std::fabs(m[row * 4 + column]));
+        }
+    }
+
+    std::size_t end = count & ~std::size_t(3);
+    for (std::size_t i = 0; i < end; i += 4) {
+        XMVECTOR x = Load4(extents.x + i);
+        XMVECTOR y = Load4(extents.y + i);
+        XMVECTOR z = Load4(extents.z + i);
+        Store4(outExtents.x + i, XMVectorMultiplyAdd(x, a[0], XMVectorMultiplyAdd(y, a[3], XMVectorMultiply(z, a[6]))));
+        Store4(outExtents.y + i, XMVectorMultiplyAdd(x, a[1], XMVectorMultiplyAdd(y, a[4], XMVectorMultiply(z, a[7]))));
+        Store4(outExtents.z + i, XMVectorMultiplyAdd(x, a[2], XMVectorMultiplyAdd(y, a[5], XMVectorMultiply(z, a[8]))));
+    }
+
+    // Centers are done; only the extents remain for the tail
+    for (std::size_t i = end; i < count; i++) {
+        float x = extents.x[i];
+        float y = extents.y[i];
+        float z = extents.z[i];
+        outExtents.x[i] = x * std::fabs(m[0]) + y * std::fabs(m[4]) + z * std::fabs(m[8]);
+        outExtents.y[i] = x * std::fabs(m[1]) + y * std::fabs(m[5]) + z * std::fabs(m[9]);
+        outExtents.z[i] = x * std::fabs(m[2]) + y * std::fabs(m[6]) + z * std::fabs(m[10]);
+    }
+}
+
+void TestSpheresFrustumVector4(const float* planes, ConstVector3SoA centers, const float* radii,
+                               std::uint8_t* visible, std::size_t count) {
+    XMVECTOR planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++) {
+        planeX[p] = XMVectorReplicate(planes[p * 4 + 0]);
+        planeY[p] = XMVectorReplicate(planes[p * 4 + 1]);
+        planeZ[p] = XMVectorReplicate(planes[p * 4 + 2]);
+        planeW[p] = XMVectorReplicate(planes[p * 4 + 3]);
+    }
+
+    std::size_t end = count & ~std::size_t(3);
+    for (std::size_t i = 0; i < end; i += 4) {
+        XMVECTOR x = Load4(centers.x + i);
+        XMVECTOR y = Load4(centers.y + i);
+        XMVECTOR z = Load4(centers.z + i);
+        XMVECTOR negativeRadius = XMVectorNegate(Load4(radii + i));
+
+        XMVECTOR inside = XMVectorTrueInt();
+        for (int p = 0; p < 6; p++) {
+            XMVECTOR distance = XMVectorMultiplyAdd(x, planeX[p],
+                XMVectorMultiplyAdd(y, planeY[p], XMVectorMultiplyAdd(z, planeZ[p], planeW[p])));
+            inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(distance, negativeRadius));
+        }
+
+        XMUINT4 mask;
+        XMStoreUInt4(&mask, inside);
+        visible[i + 0] = mask.x ? 1 : 0;
+        visible[i + 1] = mask.y ? 1 : 0;
+        visible[i + 2] = mask.z ? 1 : 0;
+        visible[i + 3] = mask.w ? 1 : 0;
+    }
+    TestSpheresFrustumScalar(planes, centers, radii, visible, end, count);
+}
+
+void NlerpQuaternionsVector4(ConstQuaternionSoA from, ConstQuaternionSoA to, float t,
+                             QuaternionSoA out, std::size_t count) {
+    const XMVECTOR zero = XMVectorZero();
+    const XMVECTOR one = XMVectorSplatOne();
+    const XMVECTOR epsilon = XMVectorReplicate(1e-8f);
+    const XMVECTOR weight = XMVectorReplicate(t);
+    const XMVECTOR restWeight = XMVectorReplicate(1.0f - t);
+
+    std::size_t end = count & ~std::size_t(3);
+    for (std::size_t i = 0; i < end; i += 4) {
+        XMVECTOR ax = Load4(from.x + i);
+        XMVECTOR ay = Load4(from.y + i);
+        XMVECTOR az = Load4(from.z + i);
+        XMVECTOR aw = Load4(from.w + i);
+        XMVECTOR bx = Load4(to.x + i);
+        XMVECTOR by = Load4(to.y + i);
+        XMVECTOR bz = Load4(to.z + i);
+        XMVECTOR bw = Load4(to.w + i);
+
+        XMVECTOR dot = XMVectorMultiplyAdd(ax, bx, XMVectorMultiplyAdd(ay, by,
+                       XMVectorMultiplyAdd(az, bz, XMVectorMultiply(aw, bw))));
+        XMVECTOR s = XMVectorSelect(weight, XMVectorNegate(weight), XMVectorLess(dot, zero));
+
+        XMVECTOR x = XMVectorMultiplyAdd(bx, s, XMVectorMultiply(ax, restWeight));
+        XMVECTOR y = XMVectorMultiplyAdd(by, s, XMVectorMultiply(ay, restWeight));
+        XMVECTOR z = XMVectorMultiplyAdd(bz, s, XMVectorMultiply(az, restWeight));
+        XMVECTOR w = XMVectorMultiplyAdd(bw, s, XMVectorMultiply(aw, restWeight));
+
+        XMVECTOR lengthSquared = XMVectorMultiplyAdd(x, x, XMVectorMultiplyAdd(y, y,
+                                 XMVectorMultiplyAdd(z, z, XMVectorMultiply(w, w))));
+        XMVECTOR valid = XMVectorGreater(lengthSquared, epsilon);
+        XMVECTOR inverse = XMVectorDivide(one, XMVectorSqrt(XMVectorSelect(one, lengthSquared, valid)));
+
+        Store4(out.x + i, XMVectorSelect(zero, XMVectorMultiply(x, inverse), valid));
+        Store4(out.y + i, XMVectorSelect(zero, XMVectorMultiply(y, inverse), valid));
+        Store4(out.z + i, XMVectorSelect(zero, XMVectorMultiply(z, inverse), valid));
+        Store4(out.w + i, XMVectorSelect(one, XMVectorMultiply(w, inverse), valid));
+    }
+    NlerpQuaternionsScalar(from, to, t, out, end, count);
+}
+
+bool CpuSupportsAvx2() {
+#if SIMD_BATCH_AVX2 && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // AVX needs OS support for saving the YMM registers as well
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif SIMD_BATCH_AVX2 && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+InstructionSet DetectInstructionSet() {
+    if (CpuSupportsAvx2()) {
+        return InstructionSet::AVX2;
+    }
+#if defined(_XM_NO_INTRINSICS_)
+    return InstructionSet::Scalar;
+#else
+    return InstructionSet::Vector4;
+#endif
+}
+
+std::atomic<InstructionSet>& ActiveInstructionSet() {
+    static std::atomic<InstructionSet> active(GetSupportedInstructionSet());
+    return active;
+}
+
+} // namespace
+
+InstructionSet GetSupportedInstructionSet() {
+    static const InstructionSet supported = DetectInstructionSet();
+    return supported;
+}
+
+InstructionSet GetInstructionSet() {
+    return ActiveInstructionSet().load(std::memory_order_relaxed);
+}
+
+void SetInstructionSet(InstructionSet set) {
+    if (static_cast<int>(set) > static_cast<int>(GetSupportedInstructionSet())) {
+        set = GetSupportedInstructionSet();
+    }
+    ActiveInstructionSet().store(set, std::memory_order_relaxed);
+}
+
+const char* GetInstructionSetName(InstructionSet set) {
+    switch (set) {
+    case InstructionSet::Vector4: return "Vector4";
+    case InstructionSet::AVX2: return "AVX2";
+    default: return "Scalar";
+    }
+}
+
+void TransformPoints(const float* matrix, ConstVector3SoA points, Vector3SoA out, std::size_t count) {
+    switch (GetInstructionSet()) {
+#if SIMD_BATCH_AVX2
+    case InstructionSet::AVX2:
+        TransformPointsScalar(matrix, points, out, Avx2::TransformPoints(matrix, points, out, count), count);
+        break;
+#endif
+    case InstructionSet::Vector4: TransformPointsVector4(matrix, points, out, count); break;
+    default: TransformPointsScalar(matrix, points, out, 0, count); break;
+    }
+}
+
+void TransformBounds(const float* matrix, ConstVector3SoA centers, ConstVector3SoA extents,
+                     Vector3SoA outCenters, Vector3SoA outExtents, std::size_t count) {
+    switch (GetInstructionSet()) {
+#if SIMD_BATCH_AVX2
+    case InstructionSet::AVX2:
+        TransformBoundsScalar(matrix, centers, extents, outCenters, outExtents,
+                              Avx2::TransformBounds(matrix, centers, extents, outCenters, outExtents, count), count);
+        break;
+#endif
+    case InstructionSet::Vector4: TransformBoundsVector4(matrix, centers, extents, outCenters, outExtents, count); break;
+    default: TransformBoundsScalar(matrix, centers, extents, outCenters, outExtents, 0, count); break;
+    }
+}
+
+void TestSpheresFrustum(const float* planes, ConstVector3SoA centers, const float* radii,
+                        std::uint8_t* visible, std::size_t count) {
+    switch (GetInstructionSet()) {
+#if SIMD_BATCH_AVX2
+    case InstructionSet::AVX2:
+        TestSpheresFrustumScalar(planes, centers, radii, visible,
+                                 Avx2::TestSpheresFrustum(planes, centers, radii, visible, count), count);
+        break;
+#endif
+    case InstructionSet::Vector4: TestSpheresFrustumVector4(planes, centers, radii, visible, count); break;
+    default: TestSpheresFrustumScalar(planes, centers, radii, visible, 0, count); break;
+    }
+}
+
+void NlerpQuaternions(ConstQuaternionSoA from, ConstQuaternionSoA to, float t,
+                      QuaternionSoA out, std::size_t count) {
+    switch (GetInstructionSet()) {
+#if SIMD_BATCH_AVX2
+    case InstructionSet::AVX2:
+        NlerpQuaternionsScalar(from, to, t, out, Avx2::NlerpQuaternions(from, to, t, out, count), count);
+        break;
+#endif
+    case InstructionSet::Vector4: NlerpQuaternionsVector4(from, to, t, out, count); break;
+    default: NlerpQuaternionsScalar(from, to, t, out, 0, count); break;
+    }
+}
+
+void ExtractFrustumPlanes(const float* viewProjection, float* planes) {
+    // Planes from the columns of the row-vector matrix, normals pointing in
+    XMMATRIX columns = XMMatrixTranspose(XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(viewProjection)));
+    const XMVECTOR unnormalized[6] = {
+        XMVectorAdd(columns.r[3], columns.r[0]),        // Left
+        XMVectorSubtract(columns.r[3], columns.r[0]),   // Right
+        XMVectorAdd(columns.r[3], columns.r[1]),        // Bottom
+        XMVectorSubtract(columns.r[3], columns.r[1]),   // Top
+        columns.r[2],                                   // Near
+        XMVectorSubtract(columns.r[3], columns.r[2])    // Far
+    };
+
+    for (int p = 0; p < 6; p++) {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(planes + p * 4), XMPlaneNormalize(unnormalized[p]));
+    }
+}
+
+} // namespace Simd
+} // namespace Math
+} // namespace GameEngine
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// x86 builds compile the AVX2 kernels; they only run after a CPU check
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_BATCH_AVX2 1
+#else
+#define SIMD_BATCH_AVX2 0
+#endif
+
+namespace GameEngine {
+namespace Math {
+namespace Simd {
+
+// Batch kernels over structure-of-arrays data, run with the widest
+// instruction set the CPU supports. The AVX2 path processes eight items per
+// step, the Vector4 path four (DirectXMath, so SSE2 or NEON) and the scalar
+// path one; each handles its own remainder, so counts need no padding.
+//
+// Matrices are 16 floats in XMFLOAT4X4 order and transform row vectors, as
+// DirectXMath does: p' = p * M. Planes are (a, b, c, d) with normals pointing
+// into the volume. This header avoids DirectXMath on purpose so the AVX2
+// translation unit does not instantiate inline code other units could share.
+
+enum class InstructionSet {
+    Scalar,
+    Vector4,
+    AVX2
+};
+
+// Best set this CPU and OS support, detected once
+InstructionSet GetSupportedInstructionSet();
+InstructionSet GetInstructionSet();
+// Force a narrower path, e.g. to compare them; clamped to what is supported
+void SetInstructionSet(InstructionSet set);
+const char* GetInstructionSetName(InstructionSet set);
+
+struct Vector3SoA {
+    float* x;
+    float* y;
+    float* z;
+};
+
+struct ConstVector3SoA {
+    const float* x;
+    const float* y;
+    const float* z;
+};
+
+struct QuaternionSoA {
+    float* x;
+    float* y;
+    float* z;
+    float* w;
+};
+
+struct ConstQuaternionSoA {
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* w;
+};
+
+// Affine point transform; the w column is ignored. out may alias points.
+void TransformPoints(const float* matrix, ConstVector3SoA points, Vector3SoA out, std::size_t count);
+
+// Axis-aligned boxes as center and extents: the transformed box is the
+// tightest AABB around each rotated box. outCenters may alias centers and
+// outExtents extents.
+void TransformBounds(const float* matrix, ConstVector3SoA centers, ConstVector3SoA extents,
+                     Vector3SoA outCenters, Vector3SoA outExtents, std::size_t count);
+
+// visible[i] = 1 when sphere i touches all six planes' inner half-spaces
+void TestSpheresFrustum(const float* planes, ConstVector3SoA centers, const float* radii,
+                        std::uint8_t* visible, std::size_t count);
+
+// Normalized lerp t of the way from each from to the matching to rotation,
+// along the shorter arc. out may alias either input.
+void NlerpQuaternions(ConstQuaternionSoA from, ConstQuaternionSoA to, float t,
+                      QuaternionSoA out, std::size_t count);
+
+// The six normalized planes of a row-vector view-projection (left, right,
+// bottom, top, near, far), in the form TestSpheresFrustum takes
+void ExtractFrustumPlanes(const float* viewProjection, float* planes);
+
+} // namespace Simd
+} // namespace Math
+} // namespace GameEngine
@@ -0,0 +1,150 @@
+// Built with AVX2 code generation (see CMakeLists.txt); only reached through
+// SimdBatch.cpp once the CPU check passed. Keep includes to the intrinsics:
+// inline functions from other headers instantiated here could be picked by
+// the linker for callers on CPUs without AVX. Each kernel does whole groups
+// of eight and returns how many items it did; SimdBatch.cpp does the rest.
+#include "SimdBatch.h"
+
+#if SIMD_BATCH_AVX2
+#include <immintrin.h>
+
+namespace GameEngine {
+namespace Math {
+namespace Simd {
+namespace Avx2 {
+
+namespace {
+
+inline __m256 MultiplyAdd(__m256 a, __m256 b, __m256 c) {
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+}
+
+inline __m256 Abs(float value) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), _mm256_set1_ps(value));
+}
+
+} // namespace
+
+std::size_t TransformPoints(const float* m, ConstVector3SoA points, Vector3SoA out, std::size_t count) {
+    const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+    const __m256 m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]), m6 = _mm256_set1_ps(m[6]);
+    const __m256 m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]), m10 = _mm256_set1_ps(m[10]);
+    const __m256 m12 = _mm256_set1_ps(m[12]), m13 = _mm256_set1_ps(m[13]), m14 = _mm256_set1_ps(m[14]);
+
+    std::size_t end = count & ~std::size_t(7);
+    for (std::size_t i = 0; i < end; i += 8) {
+        __m256 x = _mm256_loadu_ps(points.x + i);
+        __m256 y = _mm256_loadu_ps(points.y + i);
+        __m256 z = _mm256_loadu_ps(points.z + i);
+        _mm256_storeu_ps(out.x + i, MultiplyAdd(x, m0, MultiplyAdd(y, m4, MultiplyAdd(z, m8, m12))));
+        _mm256_storeu_ps(out.y + i, MultiplyAdd(x, m1, MultiplyAdd(y, m5, MultiplyAdd(z, m9, m13))));
+        _mm256_storeu_ps(out.z + i, MultiplyAdd(x, m2, MultiplyAdd(y, m6, MultiplyAdd(z, m10, m14))));
+    }
+
+    return end;
+}
+
+std::size_t TransformBounds(const float* m, ConstVector3SoA centers, ConstVector3SoA extents,
+                            Vector3SoA outCenters, Vector3SoA outExtents, std::size_t count) {
+    // Centers of the remainder are left to the caller with its extents
+    Avx2::TransformPoints(m, centers, outCenters, count);
+
+    const __m256 a0 = Abs(m[0]), a1 = Abs(m[1]), a2 = Abs(m[2]);
+    const __m256 a4 = Abs(m[4]), a5 = Abs(m[5]), a6 = Abs(m[6]);
+    const __m256 a8 = Abs(m[8]), a9 = Abs(m[9]), a10 = Abs(m[10]);
+
+    std::size_t end = count & ~std::size_t(7);
+    for (std::size_t i = 0; i < end; i += 8) {
+        __m256 x = _mm256_loadu_ps(extents.x + i);
+        __m256 y = _mm256_loadu_ps(extents.y + i);
+        __m256 z = _mm256_loadu_ps(extents.z + i);
+        _mm256_storeu_ps(outExtents.x + i, MultiplyAdd(x, a0, MultiplyAdd(y, a4, _mm256_mul_ps(z, a8))));
+        _mm256_storeu_ps(outExtents.y + i, MultiplyAdd(x, a1, MultiplyAdd(y, a5, _mm256_mul_ps(z, a9))));
+        _mm256_storeu_ps(outExtents.z + i, MultiplyAdd(x, a2, MultiplyAdd(y, a6, _mm256_mul_ps(z, a10))));
+    }
+
+    return end;
+}
+
+std::size_t TestSpheresFrustum(const float* planes, ConstVector3SoA centers, const float* radii,
+                               std::uint8_t* visible, std::size_t count) {
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++) {
+        planeX[p] = _mm256_set1_ps(planes[p * 4 + 0]);
+        planeY[p] = _mm256_set1_ps(planes[p * 4 + 1]);
+        planeZ[p] = _mm256_set1_ps(planes[p * 4 + 2]);
+        planeW[p] = _mm256_set1_ps(planes[p * 4 + 3]);
+    }
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    std::size_t end = count & ~std::size_t(7);
+    for (std::size_t i = 0; i < end; i += 8) {
+        __m256 x = _mm256_loadu_ps(centers.x + i);
+        __m256 y = _mm256_loadu_ps(centers.y + i);
+        __m256 z = _mm256_loadu_ps(centers.z + i);
+        __m256 negativeRadius = _mm256_xor_ps(_mm256_loadu_ps(radii + i), signBit);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m256 distance = MultiplyAdd(x, planeX[p], MultiplyAdd(y, planeY[p], MultiplyAdd(z, planeZ[p], planeW[p])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        }
+
+        // One bit per lane, spread into bytes
+        int mask = _mm256_movemask_ps(inside);
+        for (int lane = 0; lane < 8; lane++) {
+            visible[i + lane] = static_cast<std::uint8_t>((mask >> lane) & 1);
+        }
+    }
+
+    return end;
+}
+
+std::size_t NlerpQuaternions(ConstQuaternionSoA from, ConstQuaternionSoA to, float t,
+                             QuaternionSoA out, std::size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 epsilon = _mm256_set1_ps(1e-8f);
+    const __m256 weight = _mm256_set1_ps(t);
+    const __m256 negativeWeight = _mm256_set1_ps(-t);
+    const __m256 restWeight = _mm256_set1_ps(1.0f - t);
+
+    std::size_t end = count & ~std::size_t(7);
+    for (std::size_t i = 0; i < end; i += 8) {
+        __m256 ax = _mm256_loadu_ps(from.x + i);
+        __m256 ay = _mm256_loadu_ps(from.y + i);
+        __m256 az = _mm256_loadu_ps(from.z + i);
+        __m256 aw = _mm256_loadu_ps(from.w + i);
+        __m256 bx = _mm256_loadu_ps(to.x + i);
+        __m256 by = _mm256_loadu_ps(to.y + i);
+        __m256 bz = _mm256_loadu_ps(to.z + i);
+        __m256 bw = _mm256_loadu_ps(to.w + i);
+
+        __m256 dot = MultiplyAdd(ax, bx, MultiplyAdd(ay, by, MultiplyAdd(az, bz, _mm256_mul_ps(aw, bw))));
+        __m256 s = _mm256_blendv_ps(weight, negativeWeight, _mm256_cmp_ps(dot, zero, _CMP_LT_OQ));
+
+        __m256 x = MultiplyAdd(bx, s, _mm256_mul_ps(ax, restWeight));
+        __m256 y = MultiplyAdd(by, s, _mm256_mul_ps(ay, restWeight));
+        __m256 z = MultiplyAdd(bz, s, _mm256_mul_ps(az, restWeight));
+        __m256 w = MultiplyAdd(bw, s, _mm256_mul_ps(aw, restWeight));
+
+        // Full-precision reciprocal square root to match the other paths
+        __m256 lengthSquared = MultiplyAdd(x, x, MultiplyAdd(y, y, MultiplyAdd(z, z, _mm256_mul_ps(w, w))));
+        __m256 valid = _mm256_cmp_ps(lengthSquared, epsilon, _CMP_GT_OQ);
+        __m256 inverse = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_blendv_ps(one, lengthSquared, valid)));
+
+        _mm256_storeu_ps(out.x + i, _mm256_blendv_ps(zero, _mm256_mul_ps(x, inverse), valid));
+        _mm256_storeu_ps(out.y + i, _mm256_blendv_ps(zero, _mm256_mul_ps(y, inverse), valid));
+        _mm256_storeu_ps(out.z + i, _mm256_blendv_ps(zero, _mm256_mul_ps(z, inverse), valid));
+        _mm256_storeu_ps(out.w + i, _mm256_blendv_ps(one, _mm256_mul_ps(w, inverse), valid));
+    }
+
+    return end;
+}
+
+} // namespace Avx2
+} // namespace Simd
+} // namespace Math
+} // namespace GameEngine
+
+#endif
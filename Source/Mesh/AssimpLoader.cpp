@@ -1,5 +1,6 @@
 #include "AssimpLoader.h"
 #include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
 #include "../Renderer/D3D11Renderer.h"
 #include "../Renderer/Texture.h"
 #include <filesystem>
@@ -61,12 +62,16 @@ bool AssimpLoader::LoadMesh(const std::string& filename, std::shared_ptr<Mesh>&
     outMesh = std::make_shared<Mesh>();
     m_bones.clear();
     m_boneMapping.clear();
+    m_skeleton.reset();
     m_animations.clear();
     m_hasAnimations = false;
 
-    // Check for animations first
+    // Skeleton first, so vertices and channels get their final bone indices
     if (scene->mNumAnimations > 0) {
-        m_hasAnimations = true;
+        CollectBones(scene);
+        m_hasAnimations = BuildSkeleton(scene);
+    }
+    if (m_hasAnimations) {
         ProcessAnimations(scene);
         Logger::GetInstance().LogInfo("Found " + std::to_string(scene->mNumAnimations) + " animations");
     }
@@ -83,7 +88,7 @@ bool AssimpLoader::LoadMesh(const std::string& filename, std::shared_ptr<Mesh>&
 
     // If we have animations, setup bone data
     if (m_hasAnimations) {
-        outMesh->SetBones(m_bones);
+        outMesh->SetSkeleton(m_skeleton);
         outMesh->SetAnimated(true);
         Logger::GetInstance().LogInfo("Mesh loaded with " + std::to_string(m_bones.size()) + " bones");
     }
@@ -204,12 +209,10 @@ void AssimpLoader::ProcessBones(aiMesh* mesh, std::vector<SkinnedVertex>& vertic
         aiBone* bone = mesh->mBones[i];
         std::string boneName = bone->mName.C_Str();
 
+        // Every mesh bone is in the skeleton already
         int boneIndex = FindBone(boneName);
         if (boneIndex == -1) {
-            // Add new bone
-            DirectX::XMMATRIX offsetMatrix = ConvertMatrix(bone->mOffsetMatrix);
-            AddBone(boneName, offsetMatrix);
-            boneIndex = static_cast<int>(m_bones.size() - 1);
+            continue;
         }
 
         // Apply bone weights to vertices
@@ -250,19 +253,134 @@ void AssimpLoader::ProcessBones(aiMesh* mesh, std::vector<SkinnedVertex>& vertic
 }
 
 void AssimpLoader::ProcessAnimations(const aiScene* scene) {
+    MEMORY_SCOPE(Animations);
+
     for (unsigned int i = 0; i < scene->mNumAnimations; i++) {
         aiAnimation* animation = scene->mAnimations[i];
 
-        AnimationData animData;
-        animData.name = animation->mName.C_Str();
-        animData.duration = static_cast<float>(animation->mDuration);
-        animData.ticksPerSecond = static_cast<float>(animation->mTicksPerSecond);
+        float ticksPerSecond = static_cast<float>(animation->mTicksPerSecond);
+        if (ticksPerSecond == 0.0f) {
+            ticksPerSecond = 25.0f; // Default value
+        }
+
+        // Key times are converted from ticks to seconds
+        auto clip = std::make_shared<Animation::AnimationClip>(animation->mName.C_Str());
+        clip->SetTicksPerSecond(ticksPerSecond);
+        for (unsigned int c = 0; c < animation->mNumChannels; c++) {
+            const aiNodeAnim* nodeAnim = animation->mChannels[c];
+
+            Animation::AnimationChannel channel;
+            channel.boneName = nodeAnim->mNodeName.C_Str();
+            for (unsigned int k = 0; k < nodeAnim->mNumPositionKeys; k++) {
+                const aiVectorKey& key = nodeAnim->mPositionKeys[k];
+                channel.positionKeys.emplace_back(static_cast<float>(key.mTime) / ticksPerSecond, ConvertVector3(key.mValue));
+            }
+            for (unsigned int k = 0; k < nodeAnim->mNumRotationKeys; k++) {
+                const aiQuatKey& key = nodeAnim->mRotationKeys[k];
+                DirectX::XMFLOAT4 rotation(key.mValue.x, key.mValue.y, key.mValue.z, key.mValue.w);
+                channel.rotationKeys.emplace_back(static_cast<float>(key.mTime) / ticksPerSecond, rotation);
+            }
+            for (unsigned int k = 0; k < nodeAnim->mNumScalingKeys; k++) {
+                const aiVectorKey& key = nodeAnim->mScalingKeys[k];
+                channel.scaleKeys.emplace_back(static_cast<float>(key.mTime) / ticksPerSecond, ConvertVector3(key.mValue));
+            }
+            clip->AddChannel(channel);
+        }
+        clip->SetDuration(static_cast<float>(animation->mDuration) / ticksPerSecond);
+
+        // Names are resolved here, never while playing
+        clip->BindToSkeleton(*m_skeleton);
+        m_animations.push_back(clip);
+    }
+}
+
+void AssimpLoader::CollectBones(const aiScene* scene) {
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        const aiMesh* mesh = scene->mMeshes[i];
+        for (unsigned int b = 0; b < mesh->mNumBones; b++) {
+            const aiBone* bone = mesh->mBones[b];
+            if (FindBone(bone->mName.C_Str()) == -1) {
+                AddBone(bone->mName.C_Str(), ConvertMatrix(bone->mOffsetMatrix));
+            }
+        }
+    }
 
-        if (animData.ticksPerSecond == 0.0f) {
-            animData.ticksPerSecond = 25.0f; // Default value
+    // Animated nodes that skin nothing still carry their children
+    for (unsigned int i = 0; i < scene->mNumAnimations; i++) {
+        const aiAnimation* animation = scene->mAnimations[i];
+        for (unsigned int c = 0; c < animation->mNumChannels; c++) {
+            const aiString& nodeName = animation->mChannels[c]->mNodeName;
+            if (FindBone(nodeName.C_Str()) == -1 && scene->mRootNode->FindNode(nodeName)) {
+                AddBone(nodeName.C_Str(), DirectX::XMMatrixIdentity());
+            }
         }
+    }
+}
 
-        m_animations.push_back(animData);
+bool AssimpLoader::BuildSkeleton(const aiScene* scene) {
+    MEMORY_SCOPE(Animations);
+
+    if (m_bones.empty()) {
+        return false;
+    }
+
+    std::vector<Animation::SkeletonBone> bones(m_bones.size());
+    for (size_t i = 0; i < m_bones.size(); i++) {
+        bones[i].name = m_bones[i].name;
+        DirectX::XMStoreFloat4x4(&bones[i].inverseBind, m_bones[i].offsetMatrix);
+    }
+    CollectBoneParents(scene->mRootNode, -1, DirectX::XMMatrixIdentity(), bones);
+
+    auto skeleton = std::make_shared<Animation::Skeleton>();
+    std::vector<int> remap;
+    if (!skeleton->Build(bones, &remap)) {
+        Logger::GetInstance().LogError("AssimpLoader - Invalid bone hierarchy, animations skipped");
+        return false;
+    }
+
+    // Bone indices from here on are skeleton indices
+    std::vector<BoneInfo> sortedBones(m_bones.size());
+    for (size_t i = 0; i < m_bones.size(); i++) {
+        int index = remap[i];
+        sortedBones[index] = m_bones[i];
+        sortedBones[index].parentIndex = skeleton->GetParentIndex(index);
+        m_boneMapping[m_bones[i].name] = index;
+    }
+    m_bones = std::move(sortedBones);
+    m_skeleton = skeleton;
+    return true;
+}
+
+void AssimpLoader::CollectBoneParents(const aiNode* node, int parentBone, const DirectX::XMMATRIX& toParentBone,
+                                      std::vector<Animation::SkeletonBone>& bones) {
+    DirectX::XMMATRIX nodeTransform = ConvertMatrix(node->mTransformation);
+    DirectX::XMMATRIX toChildren;
+
+    int boneIndex = FindBone(node->mName.C_Str());
+    if (boneIndex != -1) {
+        Animation::SkeletonBone& bone = bones[boneIndex];
+        bone.parentIndex = parentBone;
+
+        // Animation channels replace the bone's own transform, so the nodes
+        // between it and its parent bone are kept apart as its pre-transform
+        DirectX::XMStoreFloat4x4(&bone.preTransform, toParentBone);
+
+        DirectX::XMVECTOR scale, rotation, translation;
+        if (DirectX::XMMatrixDecompose(&scale, &rotation, &translation, nodeTransform)) {
+            DirectX::XMStoreFloat3(&bone.scale, scale);
+            DirectX::XMStoreFloat4(&bone.rotation, rotation);
+            DirectX::XMStoreFloat3(&bone.translation, translation);
+        }
+
+        parentBone = boneIndex;
+        toChildren = DirectX::XMMatrixIdentity();
+    }
+    else {
+        toChildren = DirectX::XMMatrixMultiply(nodeTransform, toParentBone);
+    }
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++) {
+        CollectBoneParents(node->mChildren[i], parentBone, toChildren, bones);
     }
 }
 
@@ -14,6 +14,8 @@
 #include "Vertex.h"
 #include "Material.h"
 #include "../Math/Matrix4.h"
+#include "../Animation/AnimationClip.h"
+#include "../Animation/Skeleton.h"
 
 namespace GameEngine {
 namespace Mesh {
@@ -32,13 +34,6 @@ struct BoneInfo {
     BoneInfo() : parentIndex(-1), offsetMatrix(DirectX::XMMatrixIdentity()) {}
 };
 
-struct AnimationData {
-    std::string name;
-    float duration;
-    float ticksPerSecond;
-    // Animation channels will be added later
-};
-
 class AssimpLoader {
 public:
     AssimpLoader();
@@ -53,9 +48,11 @@ public:
     static DirectX::XMFLOAT3 ConvertVector3(const aiVector3D& vector);
     static DirectX::XMFLOAT2 ConvertVector2(const aiVector3D& vector);
 
-    // Getters for loaded data
+    // Getters for loaded data. Bones are in skeleton order, parents first,
+    // and clips are bound to the skeleton.
     const std::vector<BoneInfo>& GetBones() const { return m_bones; }
-    const std::vector<AnimationData>& GetAnimations() const { return m_animations; }
+    const std::shared_ptr<Animation::Skeleton>& GetSkeleton() const { return m_skeleton; }
+    const std::vector<std::shared_ptr<Animation::AnimationClip>>& GetAnimations() const { return m_animations; }
     bool HasAnimations() const { return !m_animations.empty(); }
 
 private:
@@ -69,6 +66,13 @@ private:
 
     void ProcessBones(aiMesh* mesh, std::vector<SkinnedVertex>& vertices);
     void ProcessAnimations(const aiScene* scene);
+
+    // Skeleton: every mesh bone and animated node, with parents and bind
+    // poses taken from the node tree; sorts m_bones parents first
+    void CollectBones(const aiScene* scene);
+    bool BuildSkeleton(const aiScene* scene);
+    void CollectBoneParents(const aiNode* node, int parentBone, const DirectX::XMMATRIX& toParentBone,
+                            std::vector<Animation::SkeletonBone>& bones);
     void ProcessMaterials(const aiScene* scene, const std::string& directory,
                          std::vector<std::shared_ptr<Material>>& materials,
                          Renderer::D3D11Renderer* renderer);
@@ -85,7 +89,8 @@ private:
 private:
     Assimp::Importer m_importer;
     std::vector<BoneInfo> m_bones;
-    std::vector<AnimationData> m_animations;
+    std::shared_ptr<Animation::Skeleton> m_skeleton;
+    std::vector<std::shared_ptr<Animation::AnimationClip>> m_animations;
     std::unordered_map<std::string, int> m_boneMapping;
 
     // Current processing state
@@ -0,0 +1,260 @@
+#include "AsyncLoader.h"
+#include "Mesh.h"
+#include "MeshManager.h"
+#include "../Renderer/D3D11Renderer.h"
+#include "../Renderer/Texture.h"
+#include "../Core/Logger.h"
+#include <objbase.h>
+#include <algorithm>
+
+namespace GameEngine {
+namespace Mesh {
+
+AsyncLoader& AsyncLoader::GetInstance() {
+    static AsyncLoader instance;
+    return instance;
+}
+
+AsyncLoader::AsyncLoader()
+    : m_renderer(nullptr)
+    , m_nextSequence(0)
+    , m_inFlight(0)
+    , m_running(false)
+    , m_nextPendingId(1)
+    , m_initialized(false)
+{
+}
+
+AsyncLoader::~AsyncLoader() {
+    Shutdown();
+}
+
+bool AsyncLoader::Initialize(Renderer::D3D11Renderer* renderer, unsigned int threadCount) {
+    if (m_initialized) {
+        LOG_WARNING("AsyncLoader already initialized");
+        return true;
+    }
+
+    if (!renderer || !renderer->GetDevice()) {
+        LOG_ERROR("Cannot initialize AsyncLoader without a renderer");
+        return false;
+    }
+
+    m_renderer = renderer;
+
+    // Magenta checkerboard for textures that are still on their way
+    if (!m_placeholderTexture) {
+        auto placeholder = std::make_shared<Renderer::Texture>();
+        if (placeholder->CreateCheckerboard(64, 64, renderer->GetDevice(), 0xFFFF00FF, 0xFF000000, 8)) {
+            m_placeholderTexture = placeholder;
+        }
+    }
+
+    m_running = true;
+    threadCount = std::max(threadCount, 1u);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&AsyncLoader::WorkerLoop, this);
+    }
+
+    m_initialized = true;
+    LOG_INFO("AsyncLoader initialized with " << threadCount << " loader threads");
+    return true;
+}
+
+void AsyncLoader::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_running = false;
+    }
+    m_queueCondition.notify_all();
+
+    // Loads in flight finish; the rest resolve as cancelled
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+
+    while (!m_queue.empty()) {
+        m_queue.top().cancel();
+        m_queue.pop();
+    }
+
+    // Deliver whatever finished so callers see a final state
+    m_initialized = false;
+    Update();
+
+    m_pendingMeshes.clear();
+    m_pendingTextures.clear();
+    m_placeholderMesh.reset();
+    m_placeholderTexture.reset();
+    m_renderer = nullptr;
+
+    LOG_INFO("AsyncLoader shutdown complete");
+}
+
+void AsyncLoader::Update() {
+    {
+        std::lock_guard<std::mutex> lock(m_completionMutex);
+        m_completionScratch.swap(m_completions);
+    }
+
+    for (auto& completion : m_completionScratch) {
+        completion();
+    }
+    m_completionScratch.clear();
+}
+
+AssetHandle<Mesh> AsyncLoader::LoadMesh(const std::string& filename, LoadPriority priority,
+                                        std::function<void(const std::shared_ptr<Mesh>&)> onLoaded) {
+    if (auto cached = MESH_MANAGER.GetMesh(filename)) {
+        if (onLoaded) {
+            onLoaded(cached);
+        }
+        return MakeReadyHandle(cached);
+    }
+
+    return LoadShared<Mesh>(m_pendingMeshes, filename, priority, m_placeholderMesh,
+        [filename]() {
+            return MESH_MANAGER.LoadMesh(filename);
+        },
+        onLoaded);
+}
+
+AssetHandle<Renderer::Texture> AsyncLoader::LoadTexture(const std::wstring& filename, LoadPriority priority,
+                                                        std::function<void(const std::shared_ptr<Renderer::Texture>&)> onLoaded) {
+    if (auto cached = TEXTURE_MANAGER.GetTexture(filename)) {
+        if (onLoaded) {
+            onLoaded(cached);
+        }
+        return MakeReadyHandle(cached);
+    }
+
+    ID3D11Device* device = m_renderer ? m_renderer->GetDevice() : nullptr;
+    return LoadShared<Renderer::Texture>(m_pendingTextures, filename, priority, m_placeholderTexture,
+        [filename, device]() -> std::shared_ptr<Renderer::Texture> {
+            return device ? TEXTURE_MANAGER.LoadTexture(filename, device) : nullptr;
+        },
+        onLoaded);
+}
+
+template<typename T, typename Key>
+AssetHandle<T> AsyncLoader::LoadShared(std::unordered_map<Key, PendingLoad<T>>& pending, const Key& key,
+                                       LoadPriority priority, std::shared_ptr<T> placeholder,
+                                       std::function<std::shared_ptr<T>()> load,
+                                       std::function<void(const std::shared_ptr<T>&)> onLoaded) {
+    auto it = pending.find(key);
+    if (it != pending.end() && it->second.handle.IsPending()) {
+        if (onLoaded) {
+            it->second.callbacks.push_back(onLoaded);
+        }
+        return it->second.handle;
+    }
+
+    // A cancelled request may still be queued; its waiters move to the new one
+    PendingLoad<T>& entry = pending[key];
+    entry.id = m_nextPendingId++;
+    if (onLoaded) {
+        entry.callbacks.push_back(onLoaded);
+    }
+
+    std::uint64_t id = entry.id;
+    AssetHandle<T> handle = Submit<T>(placeholder, priority, load,
+        [&pending, key, id](const std::shared_ptr<T>& asset) {
+            auto found = pending.find(key);
+            if (found == pending.end() || found->second.id != id) {
+                return;
+            }
+
+            auto callbacks = std::move(found->second.callbacks);
+            pending.erase(found);
+
+            for (auto& callback : callbacks) {
+                callback(asset);
+            }
+        });
+
+    // Already resolved when running without loader threads
+    it = pending.find(key);
+    if (it != pending.end() && it->second.id == id) {
+        it->second.handle = handle;
+    }
+    return handle;
+}
+
+void AsyncLoader::Enqueue(LoadPriority priority, std::function<void()> work, std::function<void()> onComplete) {
+    auto run = [this, work, onComplete]() {
+        if (work) {
+            work();
+        }
+        if (onComplete) {
+            PostCompletion(onComplete);
+        }
+    };
+
+    if (!m_initialized) {
+        run();
+        Update();
+        return;
+    }
+
+    // Not started by shutdown: completion still runs so owners can clean up
+    auto cancel = [this, onComplete]() {
+        if (onComplete) {
+            PostCompletion(onComplete);
+        }
+    };
+    Push(Job{ priority, 0, run, cancel });
+}
+
+size_t AsyncLoader::GetQueuedCount() const {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_queue.size();
+}
+
+void AsyncLoader::Push(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        job.sequence = m_nextSequence++;
+        m_queue.push(std::move(job));
+    }
+    m_queueCondition.notify_one();
+}
+
+void AsyncLoader::PostCompletion(std::function<void()> completion) {
+    std::lock_guard<std::mutex> lock(m_completionMutex);
+    m_completions.push_back(std::move(completion));
+}
+
+void AsyncLoader::WorkerLoop() {
+    // WIC decoding needs COM on every thread that uses it
+    HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(lock, [this]() { return !m_running || !m_queue.empty(); });
+            if (!m_running) {
+                break;
+            }
+
+            job = m_queue.top();
+            m_queue.pop();
+            m_inFlight.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        job.run();
+        m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    if (SUCCEEDED(comResult)) {
+        CoUninitialize();
+    }
+}
+
+} // namespace Mesh
+} // namespace GameEngine
@@ -0,0 +1,306 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace GameEngine {
+
+// Forward declarations
+namespace Renderer {
+    class D3D11Renderer;
+    class Texture;
+}
+
+namespace Mesh {
+
+class Mesh;
+
+enum class LoadPriority {
+    Low = 0,        // Prefetch and distant streaming
+    Normal = 1,
+    High = 2,       // Visible soon
+    Critical = 3    // Needed this frame
+};
+
+enum class LoadState {
+    Queued,
+    Loading,
+    Ready,
+    Failed,
+    Cancelled
+};
+
+namespace Internal {
+
+// Shared by a handle and the loader thread working on it
+template<typename T>
+struct LoadRequestState {
+    std::atomic<LoadState> state{ LoadState::Queued };
+    std::atomic<bool> cancelRequested{ false };
+    std::shared_ptr<T> placeholder;
+    std::shared_ptr<T> asset;               // Written before state becomes Ready
+    std::promise<std::shared_ptr<T>> promise;
+    std::shared_future<std::shared_ptr<T>> future;
+
+    // Exactly one of the loader and Cancel() gets to move out of Queued
+    bool TryBegin() {
+        LoadState expected = LoadState::Queued;
+        return state.compare_exchange_strong(expected, LoadState::Loading, std::memory_order_acq_rel);
+    }
+};
+
+} // namespace Internal
+
+// Result of an asynchronous load. Until the asset is ready, Get() returns
+// the placeholder so callers can render something in the meantime.
+template<typename T>
+class AssetHandle {
+public:
+    AssetHandle() = default;
+
+    bool IsValid() const { return m_request != nullptr; }
+    LoadState GetState() const { return m_request ? m_request->state.load(std::memory_order_acquire) : LoadState::Failed; }
+    bool IsReady() const { return GetState() == LoadState::Ready; }
+    bool IsPending() const {
+        LoadState state = GetState();
+        return m_request && (state == LoadState::Queued || state == LoadState::Loading);
+    }
+
+    // Loaded asset once ready, otherwise the placeholder (may be null)
+    std::shared_ptr<T> Get() const {
+        if (!m_request) {
+            return nullptr;
+        }
+        return IsReady() ? m_request->asset : m_request->placeholder;
+    }
+
+    // Resolves to the asset, or null if the load failed or was cancelled
+    std::shared_future<std::shared_ptr<T>> GetFuture() const {
+        return m_request ? m_request->future : std::shared_future<std::shared_ptr<T>>();
+    }
+
+    // Drop a queued load; one already in flight finishes but is discarded
+    void Cancel() {
+        if (!m_request) {
+            return;
+        }
+
+        LoadState expected = LoadState::Queued;
+        if (m_request->state.compare_exchange_strong(expected, LoadState::Cancelled, std::memory_order_acq_rel)) {
+            m_request->promise.set_value(nullptr);
+        }
+        else {
+            m_request->cancelRequested.store(true, std::memory_order_release);
+        }
+    }
+
+private:
+    std::shared_ptr<Internal::LoadRequestState<T>> m_request;
+
+    friend class AsyncLoader;
+};
+
+// Background loading for meshes and textures.
+//
+// Loads run on dedicated loader threads rather than the job system so that
+// blocking file I/O never stalls frame jobs. Reading, Assimp import, WIC
+// decoding and GPU resource creation all happen there; ID3D11Device is
+// free-threaded and nothing touches the immediate context. Requests are
+// served highest priority first, oldest first within a priority.
+//
+// Loads go through the thread-safe MeshManager and TextureManager caches,
+// so a file already being loaded synchronously elsewhere is not loaded
+// twice. Completion callbacks run on the main thread in Update().
+class AsyncLoader {
+public:
+    static AsyncLoader& GetInstance();
+
+    bool Initialize(Renderer::D3D11Renderer* renderer, unsigned int threadCount = 2);
+    void Shutdown();
+
+    bool IsInitialized() const { return m_initialized; }
+
+    // Run completion callbacks of finished loads; call once per frame
+    void Update();
+
+    // Queue a mesh or texture load. Cached assets resolve immediately; a
+    // path already in flight shares the existing request.
+    AssetHandle<Mesh> LoadMesh(const std::string& filename, LoadPriority priority = LoadPriority::Normal,
+                               std::function<void(const std::shared_ptr<Mesh>&)> onLoaded = nullptr);
+    AssetHandle<Renderer::Texture> LoadTexture(const std::wstring& filename, LoadPriority priority = LoadPriority::Normal,
+                                               std::function<void(const std::shared_ptr<Renderer::Texture>&)> onLoaded = nullptr);
+
+    // Run work on a loader thread, then onComplete on the main thread in Update()
+    void Enqueue(LoadPriority priority, std::function<void()> work, std::function<void()> onComplete = nullptr);
+
+    // Stand-ins returned by handles while loading
+    void SetPlaceholderMesh(std::shared_ptr<Mesh> mesh) { m_placeholderMesh = mesh; }
+    void SetPlaceholderTexture(std::shared_ptr<Renderer::Texture> texture) { m_placeholderTexture = texture; }
+    std::shared_ptr<Renderer::Texture> GetPlaceholderTexture() const { return m_placeholderTexture; }
+
+    // Statistics
+    size_t GetQueuedCount() const;
+    int GetInFlightCount() const { return m_inFlight.load(std::memory_order_acquire); }
+
+private:
+    AsyncLoader();
+    ~AsyncLoader();
+
+    AsyncLoader(const AsyncLoader&) = delete;
+    AsyncLoader& operator=(const AsyncLoader&) = delete;
+
+    struct Job {
+        LoadPriority priority;
+        std::uint64_t sequence;
+        std::function<void()> run;
+        std::function<void()> cancel;   // Used for jobs still queued at shutdown
+    };
+
+    struct JobOrder {
+        bool operator()(const Job& a, const Job& b) const {
+            if (a.priority != b.priority) {
+                return a.priority < b.priority;
+            }
+            return a.sequence > b.sequence;
+        }
+    };
+
+    template<typename T>
+    AssetHandle<T> Submit(std::shared_ptr<T> placeholder, LoadPriority priority,
+                          std::function<std::shared_ptr<T>()> load,
+                          std::function<void(const std::shared_ptr<T>&)> onComplete);
+
+    template<typename T>
+    static AssetHandle<T> MakeReadyHandle(std::shared_ptr<T> asset);
+
+    template<typename T>
+    struct PendingLoad;
+
+    // Merge with an in-flight request for key or start a new one
+    template<typename T, typename Key>
+    AssetHandle<T> LoadShared(std::unordered_map<Key, PendingLoad<T>>& pending, const Key& key,
+                              LoadPriority priority, std::shared_ptr<T> placeholder,
+                              std::function<std::shared_ptr<T>()> load,
+                              std::function<void(const std::shared_ptr<T>&)> onLoaded);
+
+    void Push(Job job);
+    void PostCompletion(std::function<void()> completion);
+    void WorkerLoop();
+
+    Renderer::D3D11Renderer* m_renderer;
+
+    std::vector<std::thread> m_threads;
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::priority_queue<Job, std::vector<Job>, JobOrder> m_queue;
+    std::uint64_t m_nextSequence;
+    std::atomic<int> m_inFlight;
+    bool m_running;
+
+    // Finished loads waiting for Update() on the main thread
+    std::mutex m_completionMutex;
+    std::vector<std::function<void()>> m_completions;
+    std::vector<std::function<void()>> m_completionScratch;
+
+    // Requests in flight per path, so duplicates share one load (main thread only)
+    template<typename T>
+    struct PendingLoad {
+        AssetHandle<T> handle;
+        std::uint64_t id = 0;
+        std::vector<std::function<void(const std::shared_ptr<T>&)>> callbacks;
+    };
+    std::unordered_map<std::string, PendingLoad<Mesh>> m_pendingMeshes;
+    std::unordered_map<std::wstring, PendingLoad<Renderer::Texture>> m_pendingTextures;
+    std::uint64_t m_nextPendingId;
+
+    std::shared_ptr<Mesh> m_placeholderMesh;
+    std::shared_ptr<Renderer::Texture> m_placeholderTexture;
+
+    bool m_initialized;
+};
+
+template<typename T>
+AssetHandle<T> AsyncLoader::MakeReadyHandle(std::shared_ptr<T> asset) {
+    AssetHandle<T> handle;
+    handle.m_request = std::make_shared<Internal::LoadRequestState<T>>();
+    handle.m_request->future = handle.m_request->promise.get_future().share();
+    handle.m_request->asset = asset;
+    handle.m_request->promise.set_value(asset);
+    handle.m_request->state.store(LoadState::Ready, std::memory_order_release);
+    return handle;
+}
+
+template<typename T>
+AssetHandle<T> AsyncLoader::Submit(std::shared_ptr<T> placeholder, LoadPriority priority,
+                                   std::function<std::shared_ptr<T>()> load,
+                                   std::function<void(const std::shared_ptr<T>&)> onComplete) {
+    AssetHandle<T> handle;
+    auto request = std::make_shared<Internal::LoadRequestState<T>>();
+    request->placeholder = placeholder;
+    request->future = request->promise.get_future().share();
+    handle.m_request = request;
+
+    auto run = [this, request, load, onComplete]() {
+        if (!request->TryBegin()) {
+            // Cancelled while queued; Cancel() already resolved the future
+            PostCompletion([request, onComplete]() {
+                if (onComplete) {
+                    onComplete(nullptr);
+                }
+            });
+            return;
+        }
+
+        std::shared_ptr<T> asset = load();
+
+        if (request->cancelRequested.load(std::memory_order_acquire)) {
+            asset.reset();
+            request->state.store(LoadState::Cancelled, std::memory_order_release);
+        }
+        else if (asset) {
+            request->asset = asset;
+            request->state.store(LoadState::Ready, std::memory_order_release);
+        }
+        else {
+            request->state.store(LoadState::Failed, std::memory_order_release);
+        }
+        request->promise.set_value(asset);
+
+        PostCompletion([asset, onComplete]() {
+            if (onComplete) {
+                onComplete(asset);
+            }
+        });
+    };
+
+    auto cancel = [request]() {
+        LoadState expected = LoadState::Queued;
+        if (request->state.compare_exchange_strong(expected, LoadState::Cancelled, std::memory_order_acq_rel)) {
+            request->promise.set_value(nullptr);
+        }
+    };
+
+    // Without loader threads the load happens now
+    if (!m_initialized) {
+        run();
+        Update();
+        return handle;
+    }
+
+    Push(Job{ priority, 0, run, cancel });
+    return handle;
+}
+
+} // namespace Mesh
+} // namespace GameEngine
+
+#define ASYNC_LOADER GameEngine::Mesh::AsyncLoader::GetInstance()
@@ -1,54 +1,177 @@
 #include "Material.h"
+#include "../Renderer/Texture.h"
+#include "../Renderer/ContextStateCache.h"
+#include "../Renderer/D3D11Renderer.h"
+#include "../Renderer/GpuMemory.h"
+#include "../Renderer/ShaderCache.h"
 #include "../Core/Logger.h"
-// TODO: Add texture loading library like DirectXTex or WIC
+#include <filesystem>
 
 namespace GameEngine {
 namespace Mesh {
 
+namespace {
+
+std::shared_ptr<Renderer::Texture> LoadTextureAsset(ID3D11Device* device, const std::string& filename) {
+    if (!device || filename.empty()) {
+        return nullptr;
+    }
+    return TEXTURE_MANAGER.LoadTexture(std::filesystem::path(filename).wstring(), device);
+}
+
+ID3D11ShaderResourceView* GetView(const std::shared_ptr<Renderer::Texture>& asset,
+                                  const ComPtr<ID3D11ShaderResourceView>& view) {
+    return asset ? asset->GetSRV() : view.Get();
+}
+
+} // namespace
+
 ComPtr<ID3D11ShaderResourceView> Material::s_defaultTexture = nullptr;
 
 Material::Material(const std::string& name)
     : m_name(name)
+    , m_constantsDirty(true)
 {
 }
 
 bool Material::LoadDiffuseTexture(ID3D11Device* device, const std::string& filename) {
-    // TODO: Implement texture loading using DirectXTex or WIC
-    // For now, we'll use the default texture
+    m_diffuseTexturePath = filename;
+    m_diffuseAsset = LoadTextureAsset(device, filename);
+    m_diffuseTexture.Reset();
+    if (m_diffuseAsset) {
+        return true;
+    }
+
+    // Keep something bound so the material still renders
     if (!s_defaultTexture) {
         CreateDefaultTexture(device);
     }
-
     m_diffuseTexture = s_defaultTexture;
-    LOG_INFO("Loaded diffuse texture: " << filename << " (using default texture for now)");
-    return true;
+    LOG_WARNING("Failed to load diffuse texture: " << filename << " (using default texture)");
+    return false;
 }
 
 bool Material::LoadNormalTexture(ID3D11Device* device, const std::string& filename) {
-    // TODO: Implement texture loading
-    LOG_INFO("Normal texture loading not implemented yet: " << filename);
-    return false;
+    m_normalTexturePath = filename;
+    m_normalAsset = LoadTextureAsset(device, filename);
+    m_normalTexture.Reset();
+    return m_normalAsset != nullptr;
 }
 
 bool Material::LoadSpecularTexture(ID3D11Device* device, const std::string& filename) {
-    // TODO: Implement texture loading
-    LOG_INFO("Specular texture loading not implemented yet: " << filename);
-    return false;
+    m_specularTexturePath = filename;
+    m_specularAsset = LoadTextureAsset(device, filename);
+    m_specularTexture.Reset();
+    return m_specularAsset != nullptr;
+}
+
+ID3D11ShaderResourceView* Material::GetDiffuseTexture() const {
+    return GetView(m_diffuseAsset, m_diffuseTexture);
+}
+
+ID3D11ShaderResourceView* Material::GetNormalTexture() const {
+    return GetView(m_normalAsset, m_normalTexture);
+}
+
+ID3D11ShaderResourceView* Material::GetSpecularTexture() const {
+    return GetView(m_specularAsset, m_specularTexture);
+}
+
+void Material::RequestTextureResolution(UINT pixels) {
+    for (const auto* asset : { &m_diffuseAsset, &m_normalAsset, &m_specularAsset }) {
+        if (*asset) {
+            (*asset)->RequestResolution(pixels);
+        }
+    }
+}
+
+std::uint32_t Material::GetShaderFeatures() const {
+    return HasNormalTexture() ? Renderer::ShaderFeature::NormalMap : Renderer::ShaderFeature::None;
+}
+
+bool Material::PrepareConstants(ID3D11Device* device) {
+    if (!m_constantsDirty) {
+        return m_constantBuffer != nullptr;
+    }
+    if (!device) {
+        return false;
+    }
+
+    // Bound in place of a missing diffuse map
+    CreateDefaultTexture(device);
+
+    MaterialConstants constants;
+    constants.ambient = DirectX::XMFLOAT4(m_properties.ambient.x, m_properties.ambient.y, m_properties.ambient.z,
+                                          m_properties.opacity);
+    constants.diffuse = DirectX::XMFLOAT4(m_properties.diffuse.x, m_properties.diffuse.y, m_properties.diffuse.z,
+                                          m_properties.specularPower);
+    constants.specular = DirectX::XMFLOAT4(m_properties.specular.x, m_properties.specular.y, m_properties.specular.z, 0.0f);
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.ByteWidth = sizeof(MaterialConstants);
+    bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem = &constants;
+
+    ComPtr<ID3D11Buffer> buffer;
+    if (FAILED(device->CreateBuffer(&bufferDesc, &initData, &buffer))) {
+        LOG_ERROR("Failed to create constant buffer for material: " << m_name);
+        return false;
+    }
+    Renderer::TrackGpuMemory(buffer.Get(), Core::MemoryCategory::Meshes);
+
+    m_constantBuffer = buffer;
+    m_constantsDirty = false;
+    return true;
+}
+
+void Material::GetTextureTable(ID3D11ShaderResourceView* (&views)[TEXTURE_COUNT]) const {
+    ID3D11ShaderResourceView* diffuse = GetDiffuseTexture();
+    views[0] = diffuse ? diffuse : s_defaultTexture.Get();
+    views[1] = GetNormalTexture();
+    views[2] = GetSpecularTexture();
 }
 
 void Material::Apply(ID3D11DeviceContext* context, UINT textureSlot, UINT samplerSlot) {
-    // Apply diffuse texture
-    if (m_diffuseTexture) {
-        ID3D11ShaderResourceView* textures[] = { m_diffuseTexture.Get() };
-        context->PSSetShaderResources(textureSlot, 1, textures);
+    if (m_constantsDirty) {
+        ComPtr<ID3D11Device> device;
+        context->GetDevice(&device);
+        PrepareConstants(device.Get());
+    }
+    if (m_constantBuffer) {
+        ID3D11Buffer* buffers[] = { m_constantBuffer.Get() };
+        context->PSSetConstantBuffers(Renderer::D3D11Renderer::MATERIAL_CONSTANT_SLOT, 1, buffers);
+    }
+
+    ID3D11ShaderResourceView* textures[TEXTURE_COUNT];
+    GetTextureTable(textures);
+    context->PSSetShaderResources(textureSlot, TEXTURE_COUNT, textures);
+
+    if (m_samplerState) {
+        ID3D11SamplerState* samplers[] = { m_samplerState.Get() };
+        context->PSSetSamplers(samplerSlot, 1, samplers);
     }
-    else if (s_defaultTexture) {
-        ID3D11ShaderResourceView* textures[] = { s_defaultTexture.Get() };
-        context->PSSetShaderResources(textureSlot, 1, textures);
+}
+
+void Material::Apply(Renderer::ContextStateCache& stateCache, UINT textureSlot, UINT samplerSlot) {
+    if (m_constantsDirty) {
+        ComPtr<ID3D11Device> device;
+        stateCache.GetContext()->GetDevice(&device);
+        PrepareConstants(device.Get());
+    }
+    if (m_constantBuffer) {
+        stateCache.SetConstantBuffer(Renderer::D3D11Renderer::MATERIAL_CONSTANT_SLOT, m_constantBuffer.Get(), false, true);
     }
 
-    // TODO: Apply other textures (normal, specular) to additional slots
-    // TODO: Create and apply material constant buffer with properties
+    ID3D11ShaderResourceView* textures[TEXTURE_COUNT];
+    GetTextureTable(textures);
+    stateCache.SetShaderResources(textureSlot, TEXTURE_COUNT, textures);
+
+    if (m_samplerState) {
+        stateCache.SetSampler(samplerSlot, m_samplerState.Get());
+    }
 }
 
 void Material::CreateDefaultTexture(ID3D11Device* device) {
@@ -88,6 +211,8 @@ void Material::CreateDefaultTexture(ID3D11Device* device) {
     HRESULT hr = device->CreateTexture2D(&textureDesc, &initData, &texture);
 
     if (SUCCEEDED(hr)) {
+        Renderer::TrackGpuMemory(texture.Get(), Core::MemoryCategory::Textures);
+
         D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
         srvDesc.Format = textureDesc.Format;
         srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
@@ -1,11 +1,20 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <DirectXMath.h>
 #include <d3d11.h>
 #include <wrl/client.h>
+#include "Vertex.h"
 
 namespace GameEngine {
+
+// Forward declaration
+namespace Renderer {
+    class Texture;
+    class ContextStateCache;
+}
+
 namespace Mesh {
 
 using Microsoft::WRL::ComPtr;
@@ -18,51 +27,138 @@ struct MaterialProperties {
     float opacity = 1.0f;
 };
 
+// GPU layout of MaterialProperties; must match MaterialConstants in PixelShader.hlsl
+struct MaterialConstants {
+    DirectX::XMFLOAT4 ambient;      // w = opacity
+    DirectX::XMFLOAT4 diffuse;      // w = specular power
+    DirectX::XMFLOAT4 specular;
+};
+
 class Material {
 public:
     Material(const std::string& name = "DefaultMaterial");
     ~Material() = default;
 
-    // Property setters
     void SetName(const std::string& name) { m_name = name; }
-    void SetAmbient(const DirectX::XMFLOAT3& ambient) { m_properties.ambient = ambient; }
-    void SetDiffuse(const DirectX::XMFLOAT3& diffuse) { m_properties.diffuse = diffuse; }
-    void SetSpecular(const DirectX::XMFLOAT3& specular) { m_properties.specular = specular; }
-    void SetSpecularPower(float power) { m_properties.specularPower = power; }
-    void SetOpacity(float opacity) { m_properties.opacity = opacity; }
+
+    // Property setters; the constant buffer is rebuilt on the next Apply
+    void SetAmbient(const DirectX::XMFLOAT3& ambient) { m_properties.ambient = ambient; m_constantsDirty = true; }
+    void SetDiffuse(const DirectX::XMFLOAT3& diffuse) { m_properties.diffuse = diffuse; m_constantsDirty = true; }
+    void SetSpecular(const DirectX::XMFLOAT3& specular) { m_properties.specular = specular; m_constantsDirty = true; }
+    void SetSpecularPower(float power) { m_properties.specularPower = power; m_constantsDirty = true; }
+    void SetOpacity(float opacity) { m_properties.opacity = opacity; m_constantsDirty = true; }
+    void SetProperties(const MaterialProperties& properties) { m_properties = properties; m_constantsDirty = true; }
 
     // Texture management
-    void SetDiffuseTexture(ComPtr<ID3D11ShaderResourceView> texture) { m_diffuseTexture = texture; }
-    void SetNormalTexture(ComPtr<ID3D11ShaderResourceView> texture) { m_normalTexture = texture; }
-    void SetSpecularTexture(ComPtr<ID3D11ShaderResourceView> texture) { m_specularTexture = texture; }
+    void SetDiffuseTexture(ComPtr<ID3D11ShaderResourceView> texture) { m_diffuseTexture = texture; m_diffuseAsset.reset(); m_diffuseTexturePath.clear(); }
+    void SetNormalTexture(ComPtr<ID3D11ShaderResourceView> texture) { m_normalTexture = texture; m_normalAsset.reset(); m_normalTexturePath.clear(); }
+    void SetSpecularTexture(ComPtr<ID3D11ShaderResourceView> texture) { m_specularTexture = texture; m_specularAsset.reset(); m_specularTexturePath.clear(); }
+
+    // Shader binding (optional, the current shaders are used when unset)
+    void SetShaders(ComPtr<ID3D11VertexShader> vertexShader, ComPtr<ID3D11InputLayout> inputLayout,
+                    ComPtr<ID3D11PixelShader> pixelShader) {
+        m_vertexShader = vertexShader;
+        m_inputLayouts = VertexInputLayouts();
+        m_inputLayouts.layouts[static_cast<UINT>(VertexFormat::Standard)] = inputLayout;
+        m_pixelShader = pixelShader;
+    }
+    // Same, with a layout per vertex format so compact meshes can use the shader
+    void SetShaders(ComPtr<ID3D11VertexShader> vertexShader, const VertexInputLayouts& inputLayouts,
+                    ComPtr<ID3D11PixelShader> pixelShader) {
+        m_vertexShader = vertexShader;
+        m_inputLayouts = inputLayouts;
+        m_pixelShader = pixelShader;
+    }
+
+    // Fixed-function states (optional, the pass's states are used when unset).
+    // Take them from the renderer's StateObjectCache so equal states share
+    // one object and redundant binds are filtered.
+    void SetSamplerState(ID3D11SamplerState* sampler) { m_samplerState = sampler; }
+    void SetBlendState(ID3D11BlendState* state) { m_blendState = state; }
+    void SetRasterizerState(ID3D11RasterizerState* state) { m_rasterizerState = state; }
 
     bool LoadDiffuseTexture(ID3D11Device* device, const std::string& filename);
     bool LoadNormalTexture(ID3D11Device* device, const std::string& filename);
     bool LoadSpecularTexture(ID3D11Device* device, const std::string& filename);
 
+    // Source paths of loaded textures, empty when set directly
+    const std::string& GetDiffuseTexturePath() const { return m_diffuseTexturePath; }
+    const std::string& GetNormalTexturePath() const { return m_normalTexturePath; }
+    const std::string& GetSpecularTexturePath() const { return m_specularTexturePath; }
+
     // Getters
     const std::string& GetName() const { return m_name; }
     const MaterialProperties& GetProperties() const { return m_properties; }
 
-    ID3D11ShaderResourceView* GetDiffuseTexture() const { return m_diffuseTexture.Get(); }
-    ID3D11ShaderResourceView* GetNormalTexture() const { return m_normalTexture.Get(); }
-    ID3D11ShaderResourceView* GetSpecularTexture() const { return m_specularTexture.Get(); }
+    ID3D11ShaderResourceView* GetDiffuseTexture() const;
+    ID3D11ShaderResourceView* GetNormalTexture() const;
+    ID3D11ShaderResourceView* GetSpecularTexture() const;
+
+    ID3D11VertexShader* GetVertexShader() const { return m_vertexShader.Get(); }
+    ID3D11InputLayout* GetInputLayout(VertexFormat format = VertexFormat::Standard) const { return m_inputLayouts.Get(format); }
+    ID3D11PixelShader* GetPixelShader() const { return m_pixelShader.Get(); }
+    ID3D11SamplerState* GetSamplerState() const { return m_samplerState.Get(); }
+    ID3D11BlendState* GetBlendState() const { return m_blendState.Get(); }
+    ID3D11RasterizerState* GetRasterizerState() const { return m_rasterizerState.Get(); }
+
+    bool HasDiffuseTexture() const { return GetDiffuseTexture() != nullptr; }
+    bool HasNormalTexture() const { return GetNormalTexture() != nullptr; }
+    bool HasSpecularTexture() const { return GetSpecularTexture() != nullptr; }
 
-    bool HasDiffuseTexture() const { return m_diffuseTexture != nullptr; }
-    bool HasNormalTexture() const { return m_normalTexture != nullptr; }
-    bool HasSpecularTexture() const { return m_specularTexture != nullptr; }
+    // Streaming feedback: on-screen size in pixels of something using this material
+    void RequestTextureResolution(UINT pixels);
 
-    // Rendering
+    // Shader permutation (ShaderFeature bits) this material's textures need
+    std::uint32_t GetShaderFeatures() const;
+
+    // Creates the immutable constant buffer if the properties changed since
+    // it was built. Call on one thread before recording on deferred contexts,
+    // Apply would otherwise create it during recording.
+    bool PrepareConstants(ID3D11Device* device);
+    ID3D11Buffer* GetConstantBuffer() const { return m_constantBuffer.Get(); }
+
+    // Rendering: constant buffer, texture table (diffuse, normal, specular
+    // from textureSlot) and sampler, one bind each. Blend and rasterizer
+    // states are left to the caller, which knows the pass's defaults to
+    // fall back to.
     void Apply(ID3D11DeviceContext* context, UINT textureSlot = 0, UINT samplerSlot = 0);
+    // Same, skipping binds that are already in place
+    void Apply(Renderer::ContextStateCache& stateCache, UINT textureSlot = 0, UINT samplerSlot = 0);
 
 private:
+    static constexpr UINT TEXTURE_COUNT = 3;
+
+    // Views to bind from textureSlot; a missing diffuse map falls back to white
+    void GetTextureTable(ID3D11ShaderResourceView* (&views)[TEXTURE_COUNT]) const;
+
     std::string m_name;
     MaterialProperties m_properties;
 
+    // Properties as uploaded; rebuilt rather than updated, materials rarely change
+    ComPtr<ID3D11Buffer> m_constantBuffer;
+    bool m_constantsDirty;
+
     ComPtr<ID3D11ShaderResourceView> m_diffuseTexture;
     ComPtr<ID3D11ShaderResourceView> m_normalTexture;
     ComPtr<ID3D11ShaderResourceView> m_specularTexture;
 
+    // Textures loaded from file; their views change as mips stream
+    std::shared_ptr<Renderer::Texture> m_diffuseAsset;
+    std::shared_ptr<Renderer::Texture> m_normalAsset;
+    std::shared_ptr<Renderer::Texture> m_specularAsset;
+
+    std::string m_diffuseTexturePath;
+    std::string m_normalTexturePath;
+    std::string m_specularTexturePath;
+
+    ComPtr<ID3D11VertexShader> m_vertexShader;
+    VertexInputLayouts m_inputLayouts;
+    ComPtr<ID3D11PixelShader> m_pixelShader;
+
+    ComPtr<ID3D11SamplerState> m_samplerState;
+    ComPtr<ID3D11BlendState> m_blendState;
+    ComPtr<ID3D11RasterizerState> m_rasterizerState;
+
     // Default white texture for materials without textures
     static ComPtr<ID3D11ShaderResourceView> s_defaultTexture;
     static void CreateDefaultTexture(ID3D11Device* device);
@@ -1,19 +1,100 @@
 #include "Mesh.h"
 #include "AssimpLoader.h"
+#include "MeshCooker.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
 #include "../Renderer/D3D11Renderer.h"
+#include "../Core/ConfigManager.h"
 #include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace GameEngine {
 namespace Mesh {
 
+namespace {
+
+// Screen size below which LOD 1 is used; each further level halves it
+constexpr float LOD_FIRST_SCREEN_SIZE = 0.5f;
+
+// A level that keeps more than this share of the previous one is not worth it
+constexpr float LOD_MIN_GAIN = 0.9f;
+
+// Largest quantization step (mesh units) for SNORM16 positions; bigger meshes keep float positions
+constexpr float MAX_POSITION_QUANTIZATION_STEP = 0.001f;
+
+// Half floats lose sub-texel precision on large tiling UVs
+constexpr float MAX_HALF_TEXCOORD = 4.0f;
+
+// Bone indices must fit UINT8
+constexpr unsigned int MAX_COMPACT_BONE_INDEX = 255;
+
+// Cache misses the overdraw ordering may add, relative to the cache-only order
+constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+// Vertices in their new order; those mapped to INVALID_INDEX are dropped
+template <typename VertexType>
+std::vector<VertexType> RemapVertices(const std::vector<VertexType>& vertices, const std::vector<UINT>& remap,
+                                      size_t count) {
+    std::vector<VertexType> result(count);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        if (remap[i] != MeshOptimizer::INVALID_INDEX) {
+            result[remap[i]] = vertices[i];
+        }
+    }
+    return result;
+}
+
+// Quantized positions span the largest half extent of the bounds
+float HalfExtent(const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax) {
+    return 0.5f * std::max({ boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z });
+}
+
+DirectX::PackedVector::XMBYTEN4 PackNormal(const DirectX::XMFLOAT3& normal) {
+    DirectX::PackedVector::XMBYTEN4 packed;
+    DirectX::PackedVector::XMStoreByteN4(&packed, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&normal)));
+    return packed;
+}
+
+DirectX::PackedVector::XMHALF2 PackTexCoord(const DirectX::XMFLOAT2& texCoord) {
+    DirectX::PackedVector::XMHALF2 packed;
+    DirectX::PackedVector::XMStoreHalf2(&packed, DirectX::XMLoadFloat2(&texCoord));
+    return packed;
+}
+
+// Rounds weights to bytes that still sum to exactly one
+DirectX::PackedVector::XMUBYTEN4 PackWeights(const DirectX::XMFLOAT4& weights) {
+    const float source[4] = { weights.x, weights.y, weights.z, weights.w };
+    std::uint8_t bytes[4];
+    int total = 0;
+    int largest = 0;
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = static_cast<std::uint8_t>(std::clamp(source[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        total += bytes[i];
+        if (source[i] > source[largest]) {
+            largest = i;
+        }
+    }
+    if (total > 0) {
+        bytes[largest] = static_cast<std::uint8_t>(std::clamp(bytes[largest] + 255 - total, 0, 255));
+    }
+    return DirectX::PackedVector::XMUBYTEN4(bytes[0], bytes[1], bytes[2], bytes[3]);
+}
+
+} // namespace
+
 Mesh::Mesh(const std::string& name)
     : m_name(name)
+    , m_baseVertex(0)
+    , m_baseIndex(0)
     , m_vertexCount(0)
     , m_indexCount(0)
     , m_isAnimated(false)
     , m_isLoaded(false)
+    , m_vertexFormat(VertexFormat::Standard)
+    , m_indexFormat(DXGI_FORMAT_R32_UINT)
     , m_boundingBoxMin(-1.0f, -1.0f, -1.0f)
     , m_boundingBoxMax(1.0f, 1.0f, 1.0f)
 {
@@ -39,11 +120,79 @@ bool Mesh::LoadFromFile(const std::string& filename, Renderer::D3D11Renderer* re
     return false;
 }
 
+void Mesh::ReplaceGeometry(Mesh&& source) {
+    std::vector<SubMesh> previous = std::move(m_subMeshes);
+
+    m_vertices = std::move(source.m_vertices);
+    m_skinnedVertices = std::move(source.m_skinnedVertices);
+    m_indices = std::move(source.m_indices);
+    m_vertexBuffer = std::move(source.m_vertexBuffer);
+    m_indexBuffer = std::move(source.m_indexBuffer);
+    m_skinningSourceView = std::move(source.m_skinningSourceView);
+    m_baseVertex = source.m_baseVertex;
+    m_baseIndex = source.m_baseIndex;
+    m_vertexCount = source.m_vertexCount;
+    m_indexCount = source.m_indexCount;
+    m_isAnimated = source.m_isAnimated;
+    m_isLoaded = source.m_isLoaded;
+    m_vertexFormat = source.m_vertexFormat;
+    m_indexFormat = source.m_indexFormat;
+    m_subMeshes = std::move(source.m_subMeshes);
+    m_lods = std::move(source.m_lods);
+    m_skeleton = std::move(source.m_skeleton);
+    m_boundingBoxMin = source.m_boundingBoxMin;
+    m_boundingBoxMax = source.m_boundingBoxMax;
+
+    // Materials assigned since the load survive; submeshes the file added use its own
+    for (size_t i = 0; i < m_subMeshes.size() && i < previous.size(); i++) {
+        m_subMeshes[i].material = previous[i].material;
+    }
+}
+
 std::shared_ptr<Mesh> Mesh::CreateFromFile(const std::string& filename, Renderer::D3D11Renderer* renderer) {
+    MEMORY_SCOPE(Meshes);
+
+    if (MeshCooker::IsCookedPath(filename)) {
+        return MeshCooker::Load(filename, renderer);
+    }
+
+    // Prefer the cooked copy; a stale or unreadable one falls back to import
+    bool useCache = CONFIG_MANAGER.GetAssetSettings().enableAssetCache;
+    if (useCache && MeshCooker::IsUpToDate(filename)) {
+        if (auto mesh = MeshCooker::Load(MeshCooker::GetCookedPath(filename), renderer)) {
+            mesh->m_name = filename;
+            return mesh;
+        }
+    }
+
     AssimpLoader loader;
     std::shared_ptr<Mesh> mesh;
 
     if (loader.LoadMesh(filename, mesh, renderer)) {
+        const auto& assetSettings = CONFIG_MANAGER.GetAssetSettings();
+        if (assetSettings.meshLODCount > 1) {
+            mesh->GenerateLODs(renderer, static_cast<UINT>(assetSettings.meshLODCount), assetSettings.meshLODReduction);
+        }
+        if (assetSettings.optimizeMeshes) {
+            mesh->Optimize(renderer);
+        }
+        if (assetSettings.compactVertices) {
+            mesh->SetVertexFormat(renderer, mesh->ChooseVertexFormat());
+        }
+
+        if (useCache) {
+            std::vector<CookedBone> bones;
+#ifdef ASSIMP_ENABLED
+            for (const BoneInfo& bone : loader.GetBones()) {
+                CookedBone cooked;
+                cooked.name = bone.name;
+                cooked.parentIndex = bone.parentIndex;
+                DirectX::XMStoreFloat4x4(&cooked.offsetMatrix, bone.offsetMatrix);
+                bones.push_back(cooked);
+            }
+#endif
+            MeshCooker::Cook(*mesh, MeshCooker::GetCookedPath(filename), bones);
+        }
         return mesh;
     }
 
@@ -53,6 +202,8 @@ std::shared_ptr<Mesh> Mesh::CreateFromFile(const std::string& filename, Renderer
 
 bool Mesh::CreateFromData(const std::vector<Vertex>& vertices, const std::vector<UINT>& indices,
                          Renderer::D3D11Renderer* renderer) {
+    MEMORY_SCOPE(Meshes);
+
     if (vertices.empty() || indices.empty() || !renderer) {
         LOG_ERROR("Invalid mesh data or renderer");
         return false;
@@ -84,6 +235,8 @@ bool Mesh::CreateFromData(const std::vector<Vertex>& vertices, const std::vector
 
 bool Mesh::CreateFromSkinnedData(const std::vector<SkinnedVertex>& vertices, const std::vector<UINT>& indices,
                                 Renderer::D3D11Renderer* renderer) {
+    MEMORY_SCOPE(Meshes);
+
     if (vertices.empty() || indices.empty() || !renderer) {
         LOG_ERROR("Invalid skinned mesh data or renderer");
         return false;
@@ -128,7 +281,7 @@ bool Mesh::CreateFromSkinnedData(const std::vector<SkinnedVertex>& vertices, con
     return true;
 }
 
-void Mesh::Render(Renderer::D3D11Renderer* renderer, const Math::Matrix4& worldMatrix) {
+void Mesh::Render(Renderer::D3D11Renderer* renderer, const Math::Matrix4& worldMatrix, Material* material) {
     if (!m_isLoaded || !renderer) {
         return;
     }
@@ -138,35 +291,41 @@ void Mesh::Render(Renderer::D3D11Renderer* renderer, const Math::Matrix4& worldM
     // For now, we'll assume they're already set
 
     // Set vertex buffer
-    UINT stride = m_isAnimated ? sizeof(SkinnedVertex) : sizeof(Vertex);
-    renderer->SetVertexBuffer(m_vertexBuffer.Get(), stride);
+    renderer->SetVertexBuffer(m_vertexBuffer.Get(), GetVertexStride());
 
     // Set index buffer
-    renderer->SetIndexBuffer(m_indexBuffer.Get());
+    renderer->SetIndexBuffer(m_indexBuffer.Get(), m_indexFormat);
 
     // Set primitive topology
     renderer->SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
     // Render all submeshes
     for (UINT i = 0; i < m_subMeshes.size(); i++) {
-        RenderSubMesh(renderer, i, worldMatrix);
+        RenderSubMesh(renderer, i, worldMatrix, material);
     }
 }
 
-void Mesh::RenderSubMesh(Renderer::D3D11Renderer* renderer, UINT subMeshIndex, const Math::Matrix4& worldMatrix) {
+void Mesh::RenderSubMesh(Renderer::D3D11Renderer* renderer, UINT subMeshIndex, const Math::Matrix4& worldMatrix,
+                         Material* material) {
     if (subMeshIndex >= m_subMeshes.size() || !renderer) {
         return;
     }
 
     const SubMesh& subMesh = m_subMeshes[subMeshIndex];
 
-    // Apply material if available
-    if (subMesh.material) {
-        subMesh.material->Apply(renderer->GetContext());
+    // The renderer's default stands in so nothing is left from the previous draw
+    if (!material) {
+        material = subMesh.material.get();
+    }
+    if (!material) {
+        material = renderer->GetDefaultMaterial();
+    }
+    if (material) {
+        material->Apply(renderer->GetStateCache());
     }
 
     // Draw the submesh
-    renderer->DrawIndexed(subMesh.indexCount, subMesh.startIndex);
+    renderer->DrawIndexed(subMesh.indexCount, m_baseIndex + subMesh.startIndex, m_baseVertex);
 }
 
 void Mesh::AddSubMesh(UINT startIndex, UINT indexCount, std::shared_ptr<Material> material) {
@@ -200,18 +359,41 @@ std::shared_ptr<Material> Mesh::GetMaterial(UINT subMeshIndex) const {
 }
 
 bool Mesh::CreateBuffers(Renderer::D3D11Renderer* renderer) {
+    DXGI_FORMAT indexFormat = GetIndexFormat(m_vertexCount);
+    std::vector<std::uint8_t> indices = EncodeIndices(m_indices, indexFormat);
+
+    if (m_vertexFormat != VertexFormat::Standard) {
+        std::vector<std::uint8_t> encoded = EncodeVertices(m_vertexFormat);
+        if (encoded.empty()) {
+            LOG_ERROR("Cannot encode vertices of mesh '" << m_name << "'");
+            return false;
+        }
+        return CreateBuffers(renderer, encoded.data(), indices.data(), indexFormat);
+    }
+
+    const void* vertexData = m_isAnimated
+        ? static_cast<const void*>(m_skinnedVertices.data())
+        : static_cast<const void*>(m_vertices.data());
+    return CreateBuffers(renderer, vertexData, indices.data(), indexFormat);
+}
+
+bool Mesh::CreateBuffers(Renderer::D3D11Renderer* renderer, const void* vertexData, const void* indexData,
+                         DXGI_FORMAT indexFormat) {
     // Create vertex buffer
-    if (m_isAnimated) {
-        m_vertexBuffer = renderer->CreateVertexBuffer(
-            m_skinnedVertices.data(),
-            static_cast<UINT>(m_skinnedVertices.size() * sizeof(SkinnedVertex))
-        );
+    UINT size = m_vertexCount * GetVertexStride();
+    m_skinningSourceView.Reset();
+    m_baseVertex = 0;
+    m_baseIndex = 0;
+    if (m_isAnimated && m_vertexFormat == VertexFormat::Standard) {
+        // Also readable as a raw buffer so compute skinning can use it as input
+        m_vertexBuffer = renderer->CreateRawBuffer(vertexData, size,
+                                                   D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE);
+        if (m_vertexBuffer) {
+            m_skinningSourceView = renderer->CreateRawShaderResourceView(m_vertexBuffer.Get(), size);
+        }
     }
     else {
-        m_vertexBuffer = renderer->CreateVertexBuffer(
-            m_vertices.data(),
-            static_cast<UINT>(m_vertices.size() * sizeof(Vertex))
-        );
+        m_vertexBuffer = renderer->CreateVertexBuffer(vertexData, size);
     }
 
     if (!m_vertexBuffer) {
@@ -220,15 +402,387 @@ bool Mesh::CreateBuffers(Renderer::D3D11Renderer* renderer) {
     }
 
     // Create index buffer
-    m_indexBuffer = renderer->CreateIndexBuffer(m_indices.data(), static_cast<UINT>(m_indices.size()));
+    m_indexBuffer = renderer->CreateIndexBuffer(indexData, m_indexCount, indexFormat);
     if (!m_indexBuffer) {
         LOG_ERROR("Failed to create index buffer");
         return false;
     }
+    m_indexFormat = indexFormat;
+
+    return true;
+}
+
+void Mesh::SetSharedBuffers(ComPtr<ID3D11Buffer> vertexBuffer, ComPtr<ID3D11Buffer> indexBuffer,
+                            INT baseVertex, UINT baseIndex) {
+    m_vertexBuffer = vertexBuffer;
+    m_indexBuffer = indexBuffer;
+    m_baseVertex = baseVertex;
+    m_baseIndex = baseIndex;
+}
+
+UINT Mesh::GetVertexStride(VertexFormat format, bool animated) {
+    switch (format) {
+    case VertexFormat::Compact:
+        return animated ? sizeof(CompactSkinnedVertex) : sizeof(CompactVertex);
+    case VertexFormat::Quantized:
+        return sizeof(QuantizedVertex);
+    default:
+        return animated ? sizeof(SkinnedVertex) : sizeof(Vertex);
+    }
+}
+
+DXGI_FORMAT Mesh::GetIndexFormat(UINT vertexCount) {
+    return vertexCount < 65536 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+std::vector<std::uint8_t> Mesh::EncodeIndices(const std::vector<UINT>& indices, DXGI_FORMAT format) {
+    if (format != DXGI_FORMAT_R16_UINT) {
+        std::vector<std::uint8_t> encoded(indices.size() * sizeof(UINT));
+        std::memcpy(encoded.data(), indices.data(), encoded.size());
+        return encoded;
+    }
+
+    std::vector<std::uint8_t> encoded(indices.size() * sizeof(std::uint16_t));
+    std::uint16_t* output = reinterpret_cast<std::uint16_t*>(encoded.data());
+    for (size_t i = 0; i < indices.size(); i++) {
+        output[i] = static_cast<std::uint16_t>(indices[i]);
+    }
+    return encoded;
+}
+
+size_t Mesh::GetMemoryUsage() const {
+    size_t cpuBytes = m_vertices.size() * sizeof(Vertex) + m_skinnedVertices.size() * sizeof(SkinnedVertex)
+        + m_indices.size() * sizeof(UINT);
+    size_t gpuBytes = size_t(m_vertexCount) * GetVertexStride() + size_t(m_indexCount) * GetIndexStride();
+    return cpuBytes + gpuBytes;
+}
+
+bool Mesh::SetVertexFormat(Renderer::D3D11Renderer* renderer, VertexFormat format) {
+    if (format == m_vertexFormat) {
+        return true;
+    }
+
+    size_t cpuVertexCount = m_isAnimated ? m_skinnedVertices.size() : m_vertices.size();
+    if (!renderer || cpuVertexCount != m_vertexCount || cpuVertexCount == 0 || m_indices.size() != m_indexCount ||
+        format == VertexFormat::Count || (format == VertexFormat::Quantized && m_isAnimated)) {
+        return false;
+    }
+
+    // Keep the current buffers if the new ones cannot be created
+    ComPtr<ID3D11Buffer> vertexBuffer = m_vertexBuffer;
+    ComPtr<ID3D11Buffer> indexBuffer = m_indexBuffer;
+    ComPtr<ID3D11ShaderResourceView> skinningSourceView = m_skinningSourceView;
+    INT baseVertex = m_baseVertex;
+    UINT baseIndex = m_baseIndex;
+    VertexFormat previous = m_vertexFormat;
+    UINT previousStride = GetVertexStride();
+
+    m_vertexFormat = format;
+    if (!CreateBuffers(renderer)) {
+        m_vertexFormat = previous;
+        m_vertexBuffer = vertexBuffer;
+        m_indexBuffer = indexBuffer;
+        m_skinningSourceView = skinningSourceView;
+        m_baseVertex = baseVertex;
+        m_baseIndex = baseIndex;
+        return false;
+    }
+
+    LOG_DEBUG("Mesh '" << m_name << "' vertex stride " << previousStride << " -> " << GetVertexStride() << " bytes");
+    return true;
+}
+
+VertexFormat Mesh::ChooseVertexFormat() const {
+    if (m_isAnimated) {
+        for (const SkinnedVertex& vertex : m_skinnedVertices) {
+            if (vertex.boneIndices.x > MAX_COMPACT_BONE_INDEX || vertex.boneIndices.y > MAX_COMPACT_BONE_INDEX ||
+                vertex.boneIndices.z > MAX_COMPACT_BONE_INDEX || vertex.boneIndices.w > MAX_COMPACT_BONE_INDEX ||
+                std::abs(vertex.texCoord.x) > MAX_HALF_TEXCOORD || std::abs(vertex.texCoord.y) > MAX_HALF_TEXCOORD) {
+                return VertexFormat::Standard;
+            }
+        }
+        return VertexFormat::Compact;
+    }
+
+    for (const Vertex& vertex : m_vertices) {
+        if (std::abs(vertex.texCoord.x) > MAX_HALF_TEXCOORD || std::abs(vertex.texCoord.y) > MAX_HALF_TEXCOORD) {
+            return VertexFormat::Standard;
+        }
+    }
+
+    // SNORM16 spans the largest half extent in 32767 steps
+    float halfExtent = HalfExtent(m_boundingBoxMin, m_boundingBoxMax);
+    return halfExtent / 32767.0f <= MAX_POSITION_QUANTIZATION_STEP ? VertexFormat::Quantized : VertexFormat::Compact;
+}
+
+DirectX::XMMATRIX Mesh::GetPositionDequantization() const {
+    if (m_vertexFormat != VertexFormat::Quantized) {
+        return DirectX::XMMatrixIdentity();
+    }
+
+    float halfExtent = HalfExtent(m_boundingBoxMin, m_boundingBoxMax);
+    float scale = halfExtent > 0.0f ? halfExtent : 1.0f;
+    return DirectX::XMMatrixScaling(scale, scale, scale) *
+           DirectX::XMMatrixTranslation(0.5f * (m_boundingBoxMin.x + m_boundingBoxMax.x),
+                                        0.5f * (m_boundingBoxMin.y + m_boundingBoxMax.y),
+                                        0.5f * (m_boundingBoxMin.z + m_boundingBoxMax.z));
+}
+
+std::vector<std::uint8_t> Mesh::EncodeVertices(VertexFormat format) const {
+    size_t cpuVertexCount = m_isAnimated ? m_skinnedVertices.size() : m_vertices.size();
+    if (cpuVertexCount != m_vertexCount || format == VertexFormat::Count ||
+        (format == VertexFormat::Quantized && m_isAnimated)) {
+        return {};
+    }
+    std::vector<std::uint8_t> encoded(static_cast<size_t>(m_vertexCount) * GetVertexStride(format, m_isAnimated));
+
+    if (format == VertexFormat::Standard) {
+        const void* source = m_isAnimated
+            ? static_cast<const void*>(m_skinnedVertices.data())
+            : static_cast<const void*>(m_vertices.data());
+        std::memcpy(encoded.data(), source, encoded.size());
+        return encoded;
+    }
+
+    if (m_isAnimated) {
+        CompactSkinnedVertex* output = reinterpret_cast<CompactSkinnedVertex*>(encoded.data());
+        for (UINT i = 0; i < m_vertexCount; i++) {
+            const SkinnedVertex& vertex = m_skinnedVertices[i];
+            output[i].position = vertex.position;
+            output[i].normal = PackNormal(vertex.normal);
+            output[i].texCoord = PackTexCoord(vertex.texCoord);
+            output[i].boneWeights = PackWeights(vertex.boneWeights);
+            output[i].boneIndices = DirectX::PackedVector::XMUBYTE4(
+                static_cast<std::uint8_t>(std::min(vertex.boneIndices.x, MAX_COMPACT_BONE_INDEX)),
+                static_cast<std::uint8_t>(std::min(vertex.boneIndices.y, MAX_COMPACT_BONE_INDEX)),
+                static_cast<std::uint8_t>(std::min(vertex.boneIndices.z, MAX_COMPACT_BONE_INDEX)),
+                static_cast<std::uint8_t>(std::min(vertex.boneIndices.w, MAX_COMPACT_BONE_INDEX)));
+        }
+        return encoded;
+    }
+
+    if (format == VertexFormat::Compact) {
+        CompactVertex* output = reinterpret_cast<CompactVertex*>(encoded.data());
+        for (UINT i = 0; i < m_vertexCount; i++) {
+            output[i].position = m_vertices[i].position;
+            output[i].normal = PackNormal(m_vertices[i].normal);
+            output[i].texCoord = PackTexCoord(m_vertices[i].texCoord);
+        }
+        return encoded;
+    }
+
+    // Quantized: inverse of GetPositionDequantization
+    DirectX::XMVECTOR center = DirectX::XMVectorScale(
+        DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&m_boundingBoxMin), DirectX::XMLoadFloat3(&m_boundingBoxMax)), 0.5f);
+    float halfExtent = HalfExtent(m_boundingBoxMin, m_boundingBoxMax);
+    float inverseScale = halfExtent > 0.0f ? 1.0f / halfExtent : 1.0f;
+
+    QuantizedVertex* output = reinterpret_cast<QuantizedVertex*>(encoded.data());
+    for (UINT i = 0; i < m_vertexCount; i++) {
+        DirectX::XMVECTOR position = DirectX::XMVectorScale(
+            DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&m_vertices[i].position), center), inverseScale);
+        DirectX::PackedVector::XMStoreShortN4(&output[i].position, DirectX::XMVectorSetW(position, 0.0f));
+        output[i].normal = PackNormal(m_vertices[i].normal);
+        output[i].texCoord = PackTexCoord(m_vertices[i].texCoord);
+    }
+    return encoded;
+}
+
+bool Mesh::GenerateLODs(Renderer::D3D11Renderer* renderer, UINT levelCount, float reduction) {
+    size_t cpuVertexCount = m_isAnimated ? m_skinnedVertices.size() : m_vertices.size();
+    if (!renderer || cpuVertexCount == 0 || m_indices.empty() || m_subMeshes.empty() ||
+        levelCount < 2 || reduction <= 0.0f || reduction >= 1.0f) {
+        return false;
+    }
+
+    std::vector<DirectX::XMFLOAT3> positions = GetPositions();
+
+    // Regenerating replaces any earlier levels
+    UINT baseIndexCount = 0;
+    std::vector<LODRange> previous;
+    for (const SubMesh& subMesh : m_subMeshes) {
+        baseIndexCount = std::max(baseIndexCount, subMesh.startIndex + subMesh.indexCount);
+        previous.push_back({ subMesh.startIndex, subMesh.indexCount });
+    }
+    if (baseIndexCount > m_indices.size()) {
+        return false;
+    }
+
+    std::vector<UINT> indices(m_indices.begin(), m_indices.begin() + baseIndexCount);
+    std::vector<MeshLOD> lods;
+    float screenSize = LOD_FIRST_SCREEN_SIZE;
+
+    for (UINT level = 1; level < levelCount; level++) {
+        MeshLOD lod;
+        lod.screenSize = screenSize;
+
+        size_t before = 0;
+        size_t after = 0;
+        size_t levelStart = indices.size();
+        for (const LODRange& source : previous) {
+            size_t target = static_cast<size_t>(source.indexCount * reduction) / 3 * 3;
+            std::vector<UINT> simplified = MeshSimplifier::Simplify(positions, indices.data() + source.startIndex,
+                                                                    source.indexCount, target);
+
+            lod.subMeshes.push_back({ static_cast<UINT>(indices.size()), static_cast<UINT>(simplified.size()) });
+            indices.insert(indices.end(), simplified.begin(), simplified.end());
+            before += source.indexCount;
+            after += simplified.size();
+        }
+
+        if (after > before * LOD_MIN_GAIN) {
+            indices.resize(levelStart);
+            break;
+        }
+
+        previous = lod.subMeshes;
+        lods.push_back(std::move(lod));
+        screenSize *= 0.5f;
+    }
+
+    if (lods.empty()) {
+        return false;
+    }
+
+    DXGI_FORMAT indexFormat = GetIndexFormat(m_vertexCount);
+    std::vector<std::uint8_t> encoded = EncodeIndices(indices, indexFormat);
+    ComPtr<ID3D11Buffer> indexBuffer = renderer->CreateIndexBuffer(encoded.data(), static_cast<UINT>(indices.size()),
+                                                                   indexFormat);
+    if (!indexBuffer) {
+        LOG_ERROR("Failed to create LOD index buffer for mesh '" << m_name << "'");
+        return false;
+    }
+
+    m_indices = std::move(indices);
+    m_indexCount = static_cast<UINT>(m_indices.size());
+    m_indexBuffer = indexBuffer;
+    m_indexFormat = indexFormat;
+    m_baseIndex = 0;
+    m_lods = std::move(lods);
+
+    LOG_INFO("Generated " << m_lods.size() << " LODs for mesh '" << m_name << "', coarsest has "
+             << (m_indices.size() - m_lods.back().subMeshes.front().startIndex) / 3 << " triangles");
+    return true;
+}
+
+bool Mesh::Optimize(Renderer::D3D11Renderer* renderer) {
+    size_t cpuVertexCount = m_isAnimated ? m_skinnedVertices.size() : m_vertices.size();
+    if (!renderer || cpuVertexCount != m_vertexCount || cpuVertexCount == 0 || m_indices.size() != m_indexCount) {
+        return false;
+    }
+
+    std::vector<DirectX::XMFLOAT3> positions = GetPositions();
+    std::vector<UINT> indices = m_indices;
+    float acmrBefore = MeshOptimizer::ComputeACMR(indices.data(), indices.size(), cpuVertexCount);
+
+    // Every range is drawn on its own, so each is ordered on its own
+    auto optimizeRange = [&indices, &positions, cpuVertexCount](UINT start, UINT count) {
+        if (static_cast<size_t>(start) + count <= indices.size()) {
+            MeshOptimizer::OptimizeVertexCache(indices.data() + start, count, cpuVertexCount);
+            MeshOptimizer::OptimizeOverdraw(indices.data() + start, count, positions, OVERDRAW_THRESHOLD);
+        }
+    };
+    for (const SubMesh& subMesh : m_subMeshes) {
+        optimizeRange(subMesh.startIndex, subMesh.indexCount);
+    }
+    for (const MeshLOD& lod : m_lods) {
+        for (const LODRange& range : lod.subMeshes) {
+            optimizeRange(range.startIndex, range.indexCount);
+        }
+    }
+
+    std::vector<UINT> remap;
+    size_t usedCount = MeshOptimizer::OptimizeVertexFetch(remap, indices.data(), indices.size(), cpuVertexCount);
+    float acmrAfter = MeshOptimizer::ComputeACMR(indices.data(), indices.size(), usedCount);
+
+    // Keep the current geometry if the new buffers cannot be created
+    std::vector<Vertex> vertices;
+    std::vector<SkinnedVertex> skinnedVertices;
+    if (m_isAnimated) {
+        skinnedVertices = RemapVertices(m_skinnedVertices, remap, usedCount);
+        std::swap(m_skinnedVertices, skinnedVertices);
+    }
+    else {
+        vertices = RemapVertices(m_vertices, remap, usedCount);
+        std::swap(m_vertices, vertices);
+    }
+    std::swap(m_indices, indices);
+    ComPtr<ID3D11Buffer> vertexBuffer = m_vertexBuffer;
+    ComPtr<ID3D11Buffer> indexBuffer = m_indexBuffer;
+    ComPtr<ID3D11ShaderResourceView> skinningSourceView = m_skinningSourceView;
+    INT baseVertex = m_baseVertex;
+    UINT baseIndex = m_baseIndex;
+    UINT vertexCount = m_vertexCount;
+    DXGI_FORMAT indexFormat = m_indexFormat;
+
+    m_vertexCount = static_cast<UINT>(usedCount);
+    if (!CreateBuffers(renderer)) {
+        std::swap(m_skinnedVertices, skinnedVertices);
+        std::swap(m_vertices, vertices);
+        std::swap(m_indices, indices);
+        m_vertexBuffer = vertexBuffer;
+        m_indexBuffer = indexBuffer;
+        m_skinningSourceView = skinningSourceView;
+        m_baseVertex = baseVertex;
+        m_baseIndex = baseIndex;
+        m_vertexCount = vertexCount;
+        m_indexFormat = indexFormat;
+        LOG_ERROR("Failed to recreate buffers for optimized mesh '" << m_name << "'");
+        return false;
+    }
 
+    LOG_DEBUG("Optimized mesh '" << m_name << "': ACMR " << acmrBefore << " -> " << acmrAfter << ", "
+              << (m_indexFormat == DXGI_FORMAT_R16_UINT ? 16 : 32) << "-bit indices");
     return true;
 }
 
+LODRange Mesh::GetLODRange(UINT lod, UINT subMeshIndex) const {
+    if (lod == 0 || lod > m_lods.size()) {
+        const SubMesh& subMesh = m_subMeshes[subMeshIndex];
+        return { subMesh.startIndex, subMesh.indexCount };
+    }
+    return m_lods[lod - 1].subMeshes[subMeshIndex];
+}
+
+UINT Mesh::SelectLOD(float screenSize, UINT currentLOD, float hysteresis) const {
+    UINT lod = 0;
+    for (UINT level = 1; level <= m_lods.size(); level++) {
+        // Thresholds already crossed need a clear change in size to cross back
+        float threshold = m_lods[level - 1].screenSize;
+        threshold *= level <= currentLOD ? 1.0f + hysteresis : 1.0f - hysteresis;
+        if (screenSize >= threshold) {
+            break;
+        }
+        lod = level;
+    }
+    return lod;
+}
+
+DirectX::BoundingBox Mesh::GetBoundingBox() const {
+    DirectX::BoundingBox box;
+    DirectX::BoundingBox::CreateFromPoints(box,
+        DirectX::XMLoadFloat3(&m_boundingBoxMin),
+        DirectX::XMLoadFloat3(&m_boundingBoxMax));
+    return box;
+}
+
+std::vector<DirectX::XMFLOAT3> Mesh::GetPositions() const {
+    std::vector<DirectX::XMFLOAT3> positions;
+    if (m_isAnimated) {
+        positions.reserve(m_skinnedVertices.size());
+        for (const SkinnedVertex& vertex : m_skinnedVertices) {
+            positions.push_back(vertex.position);
+        }
+    }
+    else {
+        positions.reserve(m_vertices.size());
+        for (const Vertex& vertex : m_vertices) {
+            positions.push_back(vertex.position);
+        }
+    }
+    return positions;
+}
+
 void Mesh::CalculateBoundingBox() {
     if (m_vertices.empty()) {
         return;
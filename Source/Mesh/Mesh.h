@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <d3d11.h>
+#include <DirectXCollision.h>
 #include <wrl/client.h>
 #include "Vertex.h"
 #include "Material.h"
@@ -13,13 +14,13 @@ namespace Mesh {
 
 using Microsoft::WRL::ComPtr;
 
+} // namespace Mesh
+
 // Forward declarations
 namespace Animation {
-    struct Bone;
+    class Skeleton;
 }
 
-} // namespace Mesh
-
 namespace Renderer {
     class D3D11Renderer;
 }
@@ -35,6 +36,18 @@ struct SubMesh {
         : startIndex(start), indexCount(count), material(mat) {}
 };
 
+// Index range of one submesh at a coarser level of detail
+struct LODRange {
+    UINT startIndex;
+    UINT indexCount;
+};
+
+// Simplified index set drawn with the full-detail vertex buffer
+struct MeshLOD {
+    float screenSize;               // Used while the mesh covers less than this fraction of the screen
+    std::vector<LODRange> subMeshes;
+};
+
 class Mesh {
 public:
     Mesh(const std::string& name = "");
@@ -48,9 +61,15 @@ public:
     bool CreateFromSkinnedData(const std::vector<SkinnedVertex>& vertices, const std::vector<UINT>& indices,
                               GameEngine::Renderer::D3D11Renderer* renderer);
 
-    // Rendering
-    void Render(GameEngine::Renderer::D3D11Renderer* renderer, const Math::Matrix4& worldMatrix);
-    void RenderSubMesh(GameEngine::Renderer::D3D11Renderer* renderer, UINT subMeshIndex, const Math::Matrix4& worldMatrix);
+    // Hot reload: take source's geometry, buffers and skeleton. The name and
+    // the materials of submeshes both meshes have are kept.
+    void ReplaceGeometry(Mesh&& source);
+
+    // Rendering; a material passed in replaces the submeshes' own
+    void Render(GameEngine::Renderer::D3D11Renderer* renderer, const Math::Matrix4& worldMatrix,
+                Material* material = nullptr);
+    void RenderSubMesh(GameEngine::Renderer::D3D11Renderer* renderer, UINT subMeshIndex, const Math::Matrix4& worldMatrix,
+                       Material* material = nullptr);
 
     // Getters
     const std::string& GetName() const { return m_name; }
@@ -60,18 +79,75 @@ public:
     bool IsAnimated() const { return m_isAnimated; }
     bool IsLoaded() const { return m_isLoaded; }
 
+    // GPU buffer access for batched submission
+    ID3D11Buffer* GetVertexBuffer() const { return m_vertexBuffer.Get(); }
+    ID3D11Buffer* GetIndexBuffer() const { return m_indexBuffer.Get(); }
+    UINT GetVertexStride() const { return GetVertexStride(m_vertexFormat, m_isAnimated); }
+    static UINT GetVertexStride(VertexFormat format, bool animated);
+
+    // 16-bit whenever every vertex is addressable with it; the CPU copy stays 32-bit
+    DXGI_FORMAT GetIndexFormat() const { return m_indexFormat; }
+    UINT GetIndexStride() const { return m_indexFormat == DXGI_FORMAT_R16_UINT ? 2 : 4; }
+    static DXGI_FORMAT GetIndexFormat(UINT vertexCount);
+
+    // CPU copy plus GPU buffers, in bytes
+    size_t GetMemoryUsage() const;
+
+    // GPU vertex stream format. Changing it re-encodes the vertex buffer from
+    // the CPU copy, which stays full precision.
+    VertexFormat GetVertexFormat() const { return m_vertexFormat; }
+    bool SetVertexFormat(GameEngine::Renderer::D3D11Renderer* renderer, VertexFormat format);
+
+    // Smallest format this mesh fits without visible error
+    VertexFormat ChooseVertexFormat() const;
+
+    // Reorders triangles within every submesh and LOD range for the
+    // post-transform cache and then overdraw, renumbers vertices in fetch
+    // order and recreates the buffers. Needs the CPU copy; drops vertices
+    // no triangle uses.
+    bool Optimize(GameEngine::Renderer::D3D11Renderer* renderer);
+
+    // Maps quantized positions back to mesh space; identity for other formats.
+    // Uniform scale, so it can be folded into the world matrix without
+    // skewing normals.
+    DirectX::XMMATRIX GetPositionDequantization() const;
+
+    // Offsets into the vertex/index buffers, non-zero once packed by StaticMeshBatcher
+    INT GetBaseVertex() const { return m_baseVertex; }
+    UINT GetBaseIndex() const { return m_baseIndex; }
+
+    // Raw view of the skinned vertex buffer for compute skinning, null for static meshes
+    ID3D11ShaderResourceView* GetSkinningSourceView() const { return m_skinningSourceView.Get(); }
+
+    // Local-space bounds
+    const DirectX::XMFLOAT3& GetBoundingBoxMin() const { return m_boundingBoxMin; }
+    const DirectX::XMFLOAT3& GetBoundingBoxMax() const { return m_boundingBoxMax; }
+    DirectX::BoundingBox GetBoundingBox() const;
+
     // SubMesh management
     void AddSubMesh(UINT startIndex, UINT indexCount, std::shared_ptr<Material> material = nullptr);
     SubMesh& GetSubMesh(UINT index) { return m_subMeshes[index]; }
     const SubMesh& GetSubMesh(UINT index) const { return m_subMeshes[index]; }
 
+    // Levels of detail. Level 0 is the submesh table itself; coarser levels
+    // index the same vertices, so switching costs nothing but the draw range.
+    bool GenerateLODs(GameEngine::Renderer::D3D11Renderer* renderer, UINT levelCount, float reduction);
+    UINT GetLODCount() const { return static_cast<UINT>(m_lods.size()) + 1; }
+    const MeshLOD& GetLOD(UINT lod) const { return m_lods[lod - 1]; }
+    LODRange GetLODRange(UINT lod, UINT subMeshIndex) const;
+
+    // Level for a screen size (as fraction of screen height), biased towards
+    // currentLOD by the hysteresis fraction so objects near a threshold do not pop
+    UINT SelectLOD(float screenSize, UINT currentLOD, float hysteresis) const;
+
     // Material management
     void SetMaterial(std::shared_ptr<Material> material, UINT subMeshIndex = 0);
     std::shared_ptr<Material> GetMaterial(UINT subMeshIndex = 0) const;
 
-    // Animation support (will be implemented later)
-    // const std::vector<Animation::Bone>& GetBones() const { return m_bones; }
-    // bool HasSkeleton() const { return !m_bones.empty(); }
+    // Skeleton the skinned vertices' bone indices refer to
+    void SetSkeleton(std::shared_ptr<const Animation::Skeleton> skeleton) { m_skeleton = std::move(skeleton); }
+    const std::shared_ptr<const Animation::Skeleton>& GetSkeleton() const { return m_skeleton; }
+    bool HasSkeleton() const { return m_skeleton != nullptr; }
 
     // Static mesh creation helpers
     static std::shared_ptr<Mesh> CreateCube(GameEngine::Renderer::D3D11Renderer* renderer, float size = 1.0f);
@@ -80,6 +156,18 @@ public:
 
 protected:
     bool CreateBuffers(GameEngine::Renderer::D3D11Renderer* renderer);
+    // Upload from caller-owned memory; m_vertexCount, m_indexCount and m_isAnimated must be set
+    bool CreateBuffers(GameEngine::Renderer::D3D11Renderer* renderer, const void* vertexData, const void* indexData,
+                       DXGI_FORMAT indexFormat);
+    // Draw from buffers shared with other meshes
+    void SetSharedBuffers(ComPtr<ID3D11Buffer> vertexBuffer, ComPtr<ID3D11Buffer> indexBuffer,
+                          INT baseVertex, UINT baseIndex);
+
+    // GPU vertex stream in the given format built from the CPU copy
+    std::vector<std::uint8_t> EncodeVertices(VertexFormat format) const;
+    // Index stream in the given format
+    static std::vector<std::uint8_t> EncodeIndices(const std::vector<UINT>& indices, DXGI_FORMAT format);
+    std::vector<DirectX::XMFLOAT3> GetPositions() const;
     void CalculateBoundingBox();
 
 private:
@@ -93,22 +181,33 @@ private:
     // DirectX buffers
     ComPtr<ID3D11Buffer> m_vertexBuffer;
     ComPtr<ID3D11Buffer> m_indexBuffer;
+    ComPtr<ID3D11ShaderResourceView> m_skinningSourceView;
+    INT m_baseVertex;
+    UINT m_baseIndex;
 
     // Mesh info
     UINT m_vertexCount;
     UINT m_indexCount;
     bool m_isAnimated;
     bool m_isLoaded;
+    VertexFormat m_vertexFormat;
+    DXGI_FORMAT m_indexFormat;
 
     // Sub-meshes and materials
     std::vector<SubMesh> m_subMeshes;
 
-    // Animation data (placeholder for now)
-    // std::vector<Animation::Bone> m_bones;
+    // Coarser levels (1..n), their indices follow the full-detail ones
+    std::vector<MeshLOD> m_lods;
+
+    std::shared_ptr<const Animation::Skeleton> m_skeleton;
 
     // Bounding box
     DirectX::XMFLOAT3 m_boundingBoxMin;
     DirectX::XMFLOAT3 m_boundingBoxMax;
+
+    // Writes and loads the CPU-side data directly
+    friend class MeshCooker;
+    friend class StaticMeshBatcher;
 };
 
 } // namespace Mesh
@@ -0,0 +1,362 @@
+#include "MeshCooker.h"
+#include "Mesh.h"
+#include "../Renderer/D3D11Renderer.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace GameEngine {
+namespace Mesh {
+
+namespace {
+
+constexpr std::uint32_t FLAG_ANIMATED = 1u << 0;
+constexpr size_t SECTION_ALIGNMENT = 16;
+constexpr size_t NAME_LENGTH = 64;
+constexpr size_t PATH_LENGTH = 260;
+
+struct CookedMeshHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint32_t vertexStride;
+    std::uint32_t vertexCount;
+    std::uint32_t indexCount;
+    std::uint32_t subMeshCount;
+    std::uint32_t materialCount;
+    std::uint32_t boneCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    std::uint32_t lodCount;         // Levels beyond the full-detail submeshes
+    std::uint32_t vertexFormat;     // VertexFormat of the vertex section
+    std::uint32_t indexStride;      // 2 or 4 bytes
+    std::uint64_t vertexOffset;
+    std::uint64_t indexOffset;
+    std::uint64_t subMeshOffset;
+    std::uint64_t materialOffset;
+    std::uint64_t boneOffset;
+    std::uint64_t lodOffset;        // lodCount screen sizes
+    std::uint64_t lodRangeOffset;   // lodCount * subMeshCount index ranges
+    std::uint64_t fileSize;
+};
+
+struct CookedSubMesh {
+    std::uint32_t startIndex;
+    std::uint32_t indexCount;
+    std::int32_t materialIndex;     // -1 for none
+};
+
+struct CookedLODRange {
+    std::uint32_t startIndex;
+    std::uint32_t indexCount;
+};
+
+struct CookedMaterial {
+    char name[NAME_LENGTH];
+    MaterialProperties properties;
+    char diffuseTexture[PATH_LENGTH];
+    char normalTexture[PATH_LENGTH];
+    char specularTexture[PATH_LENGTH];
+};
+
+struct CookedBoneRecord {
+    char name[NAME_LENGTH];
+    std::int32_t parentIndex;
+    DirectX::XMFLOAT4X4 offsetMatrix;
+};
+
+void CopyString(char* destination, size_t capacity, const std::string& source) {
+    size_t length = std::min(source.size(), capacity - 1);
+    std::memcpy(destination, source.data(), length);
+    std::memset(destination + length, 0, capacity - length);
+}
+
+std::string ReadString(const char* source, size_t capacity) {
+    return std::string(source, strnlen(source, capacity));
+}
+
+size_t Align(size_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+// Appends a section at the next aligned offset and returns where it starts
+size_t AppendSection(std::vector<uint8_t>& buffer, const void* data, size_t size) {
+    size_t offset = Align(buffer.size());
+    buffer.resize(offset + size, 0);
+    if (size > 0) {
+        std::memcpy(buffer.data() + offset, data, size);
+    }
+    return offset;
+}
+
+bool SectionFits(std::uint64_t offset, std::uint64_t size, size_t fileSize) {
+    return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+} // namespace
+
+bool MeshCooker::Cook(const Mesh& mesh, const std::string& path, const std::vector<CookedBone>& bones) {
+    std::vector<std::uint8_t> vertexData = mesh.EncodeVertices(mesh.m_vertexFormat);
+    if (vertexData.empty() || mesh.m_indices.size() != mesh.m_indexCount || mesh.m_indexCount == 0) {
+        LOG_WARNING("Cannot cook mesh '" << mesh.m_name << "' without its CPU-side geometry");
+        return false;
+    }
+    std::vector<std::uint8_t> indexData = Mesh::EncodeIndices(mesh.m_indices, mesh.m_indexFormat);
+
+    // Materials are shared between submeshes, store each once
+    std::vector<std::shared_ptr<Material>> materials;
+    std::vector<CookedSubMesh> subMeshes;
+    subMeshes.reserve(mesh.m_subMeshes.size());
+    for (const SubMesh& subMesh : mesh.m_subMeshes) {
+        CookedSubMesh cooked = { subMesh.startIndex, subMesh.indexCount, -1 };
+        if (subMesh.material) {
+            auto it = std::find(materials.begin(), materials.end(), subMesh.material);
+            cooked.materialIndex = static_cast<std::int32_t>(it - materials.begin());
+            if (it == materials.end()) {
+                materials.push_back(subMesh.material);
+            }
+        }
+        subMeshes.push_back(cooked);
+    }
+
+    std::vector<CookedMaterial> cookedMaterials(materials.size());
+    for (size_t i = 0; i < materials.size(); i++) {
+        CopyString(cookedMaterials[i].name, NAME_LENGTH, materials[i]->GetName());
+        cookedMaterials[i].properties = materials[i]->GetProperties();
+        CopyString(cookedMaterials[i].diffuseTexture, PATH_LENGTH, materials[i]->GetDiffuseTexturePath());
+        CopyString(cookedMaterials[i].normalTexture, PATH_LENGTH, materials[i]->GetNormalTexturePath());
+        CopyString(cookedMaterials[i].specularTexture, PATH_LENGTH, materials[i]->GetSpecularTexturePath());
+    }
+
+    std::vector<CookedBoneRecord> cookedBones(bones.size());
+    for (size_t i = 0; i < bones.size(); i++) {
+        CopyString(cookedBones[i].name, NAME_LENGTH, bones[i].name);
+        cookedBones[i].parentIndex = bones[i].parentIndex;
+        cookedBones[i].offsetMatrix = bones[i].offsetMatrix;
+    }
+
+    std::vector<float> lodScreenSizes;
+    std::vector<CookedLODRange> lodRanges;
+    for (UINT lod = 1; lod < mesh.GetLODCount(); lod++) {
+        lodScreenSizes.push_back(mesh.GetLOD(lod).screenSize);
+        for (UINT i = 0; i < mesh.GetSubMeshCount(); i++) {
+            LODRange range = mesh.GetLODRange(lod, i);
+            lodRanges.push_back({ range.startIndex, range.indexCount });
+        }
+    }
+
+    CookedMeshHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.flags = mesh.m_isAnimated ? FLAG_ANIMATED : 0;
+    header.vertexStride = mesh.GetVertexStride();
+    header.vertexFormat = static_cast<std::uint32_t>(mesh.m_vertexFormat);
+    header.indexStride = mesh.GetIndexStride();
+    header.vertexCount = mesh.m_vertexCount;
+    header.indexCount = mesh.m_indexCount;
+    header.subMeshCount = static_cast<std::uint32_t>(subMeshes.size());
+    header.materialCount = static_cast<std::uint32_t>(cookedMaterials.size());
+    header.boneCount = static_cast<std::uint32_t>(cookedBones.size());
+    header.lodCount = static_cast<std::uint32_t>(lodScreenSizes.size());
+    std::memcpy(header.boundsMin, &mesh.m_boundingBoxMin, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, &mesh.m_boundingBoxMax, sizeof(header.boundsMax));
+
+    std::vector<uint8_t> buffer(sizeof(CookedMeshHeader), 0);
+    header.vertexOffset = AppendSection(buffer, vertexData.data(), vertexData.size());
+    header.indexOffset = AppendSection(buffer, indexData.data(), indexData.size());
+    header.subMeshOffset = AppendSection(buffer, subMeshes.data(), subMeshes.size() * sizeof(CookedSubMesh));
+    header.materialOffset = AppendSection(buffer, cookedMaterials.data(), cookedMaterials.size() * sizeof(CookedMaterial));
+    header.boneOffset = AppendSection(buffer, cookedBones.data(), cookedBones.size() * sizeof(CookedBoneRecord));
+    header.lodOffset = AppendSection(buffer, lodScreenSizes.data(), lodScreenSizes.size() * sizeof(float));
+    header.lodRangeOffset = AppendSection(buffer, lodRanges.data(), lodRanges.size() * sizeof(CookedLODRange));
+    header.fileSize = buffer.size();
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    // Write beside the target and swap in, so readers never see a partial file
+    std::string tempPath = path + ".tmp";
+    if (!FILE_SYSTEM.WriteBinaryFile(tempPath, buffer)) {
+        LOG_ERROR("Failed to write cooked mesh: " << tempPath);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR("Failed to replace cooked mesh " << path << ": " << error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    LOG_INFO("Cooked mesh '" << mesh.m_name << "' to " << path << " (" << buffer.size() << " bytes)");
+    return true;
+}
+
+std::shared_ptr<Mesh> MeshCooker::Load(const std::string& path, Renderer::D3D11Renderer* renderer,
+                                       std::vector<CookedBone>* outBones) {
+    MEMORY_SCOPE(Meshes);
+
+    if (!renderer) {
+        LOG_ERROR("Cannot load cooked mesh without a renderer");
+        return nullptr;
+    }
+
+    Core::MappedFile view(path);
+    if (!view.GetData() || view.GetSize() < sizeof(CookedMeshHeader)) {
+        LOG_ERROR("Failed to map cooked mesh: " << path);
+        return nullptr;
+    }
+
+    const uint8_t* data = view.GetData();
+    CookedMeshHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != MAGIC || header.version != VERSION) {
+        LOG_WARNING("Cooked mesh " << path << " has an unsupported format version");
+        return nullptr;
+    }
+
+    bool animated = (header.flags & FLAG_ANIMATED) != 0;
+    VertexFormat format = static_cast<VertexFormat>(header.vertexFormat);
+    bool knownFormat = header.vertexFormat < VertexFormatCount && !(animated && format == VertexFormat::Quantized);
+    std::uint32_t expectedStride = knownFormat ? Mesh::GetVertexStride(format, animated) : 0;
+    size_t size = view.GetSize();
+    bool valid = header.fileSize == size
+        && knownFormat
+        && header.vertexStride == expectedStride
+        && header.vertexCount > 0 && header.indexCount > 0
+        && (header.indexStride == 4 || (header.indexStride == 2 && header.vertexCount < 65536))
+        && SectionFits(header.vertexOffset, static_cast<std::uint64_t>(header.vertexCount) * header.vertexStride, size)
+        && SectionFits(header.indexOffset, static_cast<std::uint64_t>(header.indexCount) * header.indexStride, size)
+        && SectionFits(header.subMeshOffset, static_cast<std::uint64_t>(header.subMeshCount) * sizeof(CookedSubMesh), size)
+        && SectionFits(header.materialOffset, static_cast<std::uint64_t>(header.materialCount) * sizeof(CookedMaterial), size)
+        && SectionFits(header.boneOffset, static_cast<std::uint64_t>(header.boneCount) * sizeof(CookedBoneRecord), size)
+        && SectionFits(header.lodOffset, static_cast<std::uint64_t>(header.lodCount) * sizeof(float), size)
+        && SectionFits(header.lodRangeOffset,
+                       static_cast<std::uint64_t>(header.lodCount) * header.subMeshCount * sizeof(CookedLODRange), size);
+    if (!valid) {
+        LOG_ERROR("Cooked mesh " << path << " is corrupt or truncated");
+        return nullptr;
+    }
+
+    auto mesh = std::make_shared<Mesh>(path);
+    mesh->m_vertexCount = header.vertexCount;
+    mesh->m_indexCount = header.indexCount;
+    mesh->m_isAnimated = animated;
+    mesh->m_vertexFormat = format;
+    std::memcpy(&mesh->m_boundingBoxMin, header.boundsMin, sizeof(header.boundsMin));
+    std::memcpy(&mesh->m_boundingBoxMax, header.boundsMax, sizeof(header.boundsMax));
+
+    // Buffers are initialised straight from the mapped pages
+    DXGI_FORMAT indexFormat = header.indexStride == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+    if (!mesh->CreateBuffers(renderer, data + header.vertexOffset, data + header.indexOffset, indexFormat)) {
+        LOG_ERROR("Failed to create buffers for cooked mesh: " << path);
+        return nullptr;
+    }
+
+    std::vector<std::shared_ptr<Material>> materials;
+    materials.reserve(header.materialCount);
+    const CookedMaterial* cookedMaterials = reinterpret_cast<const CookedMaterial*>(data + header.materialOffset);
+    for (std::uint32_t i = 0; i < header.materialCount; i++) {
+        const CookedMaterial& cooked = cookedMaterials[i];
+        auto material = std::make_shared<Material>(ReadString(cooked.name, NAME_LENGTH));
+        material->SetProperties(cooked.properties);
+
+        std::string diffuse = ReadString(cooked.diffuseTexture, PATH_LENGTH);
+        std::string normal = ReadString(cooked.normalTexture, PATH_LENGTH);
+        std::string specular = ReadString(cooked.specularTexture, PATH_LENGTH);
+        if (!diffuse.empty()) {
+            material->LoadDiffuseTexture(renderer->GetDevice(), diffuse);
+        }
+        if (!normal.empty()) {
+            material->LoadNormalTexture(renderer->GetDevice(), normal);
+        }
+        if (!specular.empty()) {
+            material->LoadSpecularTexture(renderer->GetDevice(), specular);
+        }
+        materials.push_back(material);
+    }
+
+    const CookedSubMesh* subMeshes = reinterpret_cast<const CookedSubMesh*>(data + header.subMeshOffset);
+    for (std::uint32_t i = 0; i < header.subMeshCount; i++) {
+        const CookedSubMesh& cooked = subMeshes[i];
+        if (static_cast<std::uint64_t>(cooked.startIndex) + cooked.indexCount > header.indexCount) {
+            LOG_WARNING("Skipping out of range submesh " << i << " in " << path);
+            continue;
+        }
+
+        std::shared_ptr<Material> material;
+        if (cooked.materialIndex >= 0 && static_cast<std::uint32_t>(cooked.materialIndex) < materials.size()) {
+            material = materials[cooked.materialIndex];
+        }
+        mesh->AddSubMesh(cooked.startIndex, cooked.indexCount, material);
+    }
+
+    if (mesh->m_subMeshes.empty()) {
+        mesh->AddSubMesh(0, mesh->m_indexCount);
+    }
+
+    // LOD tables only line up when every stored submesh was kept
+    if (mesh->m_subMeshes.size() == header.subMeshCount) {
+        const float* screenSizes = reinterpret_cast<const float*>(data + header.lodOffset);
+        const CookedLODRange* ranges = reinterpret_cast<const CookedLODRange*>(data + header.lodRangeOffset);
+        for (std::uint32_t lod = 0; lod < header.lodCount; lod++) {
+            MeshLOD level;
+            level.screenSize = screenSizes[lod];
+            for (std::uint32_t i = 0; i < header.subMeshCount; i++) {
+                const CookedLODRange& range = ranges[lod * header.subMeshCount + i];
+                if (static_cast<std::uint64_t>(range.startIndex) + range.indexCount > header.indexCount) {
+                    break;
+                }
+                level.subMeshes.push_back({ range.startIndex, range.indexCount });
+            }
+            if (level.subMeshes.size() != header.subMeshCount) {
+                LOG_WARNING("Ignoring LODs past level " << lod << " in " << path);
+                break;
+            }
+            mesh->m_lods.push_back(std::move(level));
+        }
+    }
+
+    if (outBones) {
+        const CookedBoneRecord* bones = reinterpret_cast<const CookedBoneRecord*>(data + header.boneOffset);
+        outBones->clear();
+        outBones->reserve(header.boneCount);
+        for (std::uint32_t i = 0; i < header.boneCount; i++) {
+            CookedBone bone;
+            bone.name = ReadString(bones[i].name, NAME_LENGTH);
+            bone.parentIndex = bones[i].parentIndex;
+            bone.offsetMatrix = bones[i].offsetMatrix;
+            outBones->push_back(bone);
+        }
+    }
+
+    mesh->m_isLoaded = true;
+    LOG_DEBUG("Loaded cooked mesh " << path << " with " << header.vertexCount << " vertices and "
+              << header.indexCount << " indices");
+    return mesh;
+}
+
+std::string MeshCooker::GetCookedPath(const std::string& sourcePath) {
+    return sourcePath + EXTENSION;
+}
+
+bool MeshCooker::IsCookedPath(const std::string& path) {
+    size_t length = std::strlen(EXTENSION);
+    return path.size() > length && path.compare(path.size() - length, length, EXTENSION) == 0;
+}
+
+bool MeshCooker::IsUpToDate(const std::string& sourcePath) {
+    std::string cookedPath = GetCookedPath(sourcePath);
+    if (!FILE_SYSTEM.FileExists(cookedPath)) {
+        return false;
+    }
+    // A missing source leaves the cooked copy as the only data there is
+    return !FILE_SYSTEM.FileExists(sourcePath) || !FILE_SYSTEM.IsFileNewer(sourcePath, cookedPath);
+}
+
+} // namespace Mesh
+} // namespace GameEngine
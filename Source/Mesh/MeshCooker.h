@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <DirectXMath.h>
+
+namespace GameEngine {
+
+// Forward declaration
+namespace Renderer {
+    class D3D11Renderer;
+}
+
+namespace Mesh {
+
+class Mesh;
+
+// Bone record stored alongside skinned geometry
+struct CookedBone {
+    std::string name;
+    int parentIndex = -1;
+    DirectX::XMFLOAT4X4 offsetMatrix;
+};
+
+// Binary cooked meshes.
+//
+// A cooked file holds everything the importer would otherwise recompute:
+// the vertex and index blobs already in the mesh's GPU formats (16-bit
+// indices for meshes under 65536 vertices), the submesh table, LOD index
+// ranges, bounds, bones and material records.
+// Loading maps the file and creates the GPU buffers straight from the
+// mapped view, so no intermediate copies are made and the imported mesh
+// keeps no CPU-side geometry.
+//
+// Layout: CookedMeshHeader, then 16-byte aligned sections at the offsets
+// it lists. Files written by a different version are rejected and recooked.
+class MeshCooker {
+public:
+    static constexpr std::uint32_t MAGIC = 0x434D4547;    // "GEMC"
+    static constexpr std::uint32_t VERSION = 4;
+    static constexpr const char* EXTENSION = ".gmesh";
+
+    // Write mesh (which must still hold its CPU geometry) to path
+    static bool Cook(const Mesh& mesh, const std::string& path,
+                     const std::vector<CookedBone>& bones = std::vector<CookedBone>());
+
+    // Map a cooked file and build the mesh from it; bones are optional output
+    static std::shared_ptr<Mesh> Load(const std::string& path, Renderer::D3D11Renderer* renderer,
+                                      std::vector<CookedBone>* outBones = nullptr);
+
+    // Cooked files sit next to their source: model.fbx -> model.fbx.gmesh
+    static std::string GetCookedPath(const std::string& sourcePath);
+    static bool IsCookedPath(const std::string& path);
+
+    // True when the cooked file exists and is newer than its source
+    static bool IsUpToDate(const std::string& sourcePath);
+};
+
+} // namespace Mesh
+} // namespace GameEngine
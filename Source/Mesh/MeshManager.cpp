@@ -1,6 +1,8 @@
 #include "MeshManager.h"
 #include "../Renderer/D3D11Renderer.h"
+#include "../Core/AssetArchive.h"
 #include "../Core/Logger.h"
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -12,6 +14,13 @@ MeshManager& MeshManager::GetInstance() {
     return instance;
 }
 
+MeshManager::MeshManager()
+    : m_renderer(nullptr)
+    , m_meshes([](const Mesh& mesh) { return mesh.GetMemoryUsage(); })
+    , m_initialized(false)
+{
+}
+
 void MeshManager::Initialize(Renderer::D3D11Renderer* renderer) {
     if (m_initialized) {
         LOG_WARNING("MeshManager already initialized");
@@ -51,54 +60,34 @@ std::shared_ptr<Mesh> MeshManager::LoadMesh(const std::string& filename) {
         return nullptr;
     }
 
-    // Check if mesh is already loaded
-    auto it = m_meshes.find(filename);
-    if (it != m_meshes.end()) {
-        auto mesh = it->second.lock();
-        if (mesh) {
-            LOG_DEBUG("Returning cached mesh: " << filename);
-            return mesh;
-        }
-        else {
-            // Weak pointer is expired, remove it
-            m_meshes.erase(it);
-        }
-    }
+    // Another thread loading the same file finishes the load for both
+    Renderer::D3D11Renderer* renderer = m_renderer;
+    auto mesh = m_meshes.GetOrLoad(filename, [&filename, renderer]() {
+        LOG_INFO("Loading new mesh: " << filename);
+        return Mesh::CreateFromFile(filename, renderer);
+    });
 
-    // Load new mesh
-    LOG_INFO("Loading new mesh: " << filename);
-    auto mesh = Mesh::CreateFromFile(filename, m_renderer);
+    if (!mesh) {
+        LOG_ERROR("Failed to load mesh: " << filename);
+    }
+    return mesh;
+}
 
-    if (mesh) {
-        m_meshes[filename] = mesh;
-        LOG_INFO("Successfully loaded and cached mesh: " << filename);
-        return mesh;
+AssetHandle<Mesh> MeshManager::LoadMeshAsync(const std::string& filename, LoadPriority priority) {
+    if (!m_initialized) {
+        LOG_ERROR("MeshManager not initialized");
+        return AssetHandle<Mesh>();
     }
 
-    LOG_ERROR("Failed to load mesh: " << filename);
-    return nullptr;
+    return ASYNC_LOADER.LoadMesh(filename, priority);
 }
 
 std::shared_ptr<Mesh> MeshManager::GetMesh(const std::string& name) {
-    auto it = m_meshes.find(name);
-    if (it != m_meshes.end()) {
-        auto mesh = it->second.lock();
-        if (mesh) {
-            return mesh;
-        }
-        else {
-            // Clean up expired weak pointer
-            m_meshes.erase(it);
-        }
-    }
-
-    return nullptr;
+    return m_meshes.Find(name);
 }
 
 bool MeshManager::UnloadMesh(const std::string& name) {
-    auto it = m_meshes.find(name);
-    if (it != m_meshes.end()) {
-        m_meshes.erase(it);
+    if (m_meshes.Remove(name)) {
         LOG_INFO("Unloaded mesh: " << name);
         return true;
     }
@@ -108,108 +97,169 @@ bool MeshManager::UnloadMesh(const std::string& name) {
 }
 
 void MeshManager::UnloadAllMeshes() {
-    size_t count = m_meshes.size();
-    m_meshes.clear();
+    size_t count = m_meshes.GetCount();
+    m_meshes.Clear();
 
     if (count > 0) {
         LOG_INFO("Unloaded " << count << " meshes");
     }
 }
 
-std::shared_ptr<Mesh> MeshManager::GetCube(float size) {
-    std::string key = GeneratePrimitiveKey("cube", size);
+bool MeshManager::ReloadMesh(const std::string& filename) {
+    if (!m_initialized) {
+        return false;
+    }
 
-    // Check cache
-    auto mesh = GetMesh(key);
-    if (mesh) {
-        return mesh;
+    // Callers spell paths differently, so compare normalized forms
+    std::string changed = Core::AssetArchive::NormalizePath(filename);
+    std::vector<std::pair<std::string, std::shared_ptr<Mesh>>> matches;
+    m_meshes.ForEach([&](const std::string& name, const std::shared_ptr<Mesh>& mesh) {
+        if (!IsPrimitiveName(name) && Core::AssetArchive::NormalizePath(name) == changed) {
+            matches.emplace_back(name, mesh);
+        }
+    });
+
+    bool reloaded = false;
+    for (auto& [name, existing] : matches) {
+        auto mesh = Mesh::CreateFromFile(name, m_renderer);
+        if (!mesh) {
+            LOG_WARNING("Keeping previous mesh, reload failed: " << name);
+            continue;
+        }
+
+        // Renderers and user code may have changed its materials since it loaded
+        existing->ReplaceGeometry(std::move(*mesh));
+        // Re-measure the entry
+        m_meshes.Insert(name, existing);
+        reloaded = true;
+        LOG_INFO("Reloaded mesh: " << name);
     }
+    return reloaded;
+}
 
-    // Create new cube
-    mesh = Mesh::CreateCube(m_renderer, size);
+std::string MeshManager::FindMeshName(const std::shared_ptr<Mesh>& mesh) const {
+    std::string name;
     if (mesh) {
-        m_meshes[key] = mesh;
-        LOG_DEBUG("Created and cached cube with size: " << size);
+        m_meshes.ForEach([&](const std::string& key, const std::shared_ptr<Mesh>& cached) {
+            if (cached == mesh) {
+                name = key;
+            }
+        });
     }
-
-    return mesh;
+    return name;
 }
 
-std::shared_ptr<Mesh> MeshManager::GetSphere(float radius, UINT segments) {
-    std::string key = GeneratePrimitiveKey("sphere", radius, 0.0f, segments);
-
-    // Check cache
-    auto mesh = GetMesh(key);
+std::shared_ptr<Mesh> MeshManager::ResolveMesh(const std::string& name) {
+    auto mesh = GetMesh(name);
     if (mesh) {
         return mesh;
     }
 
-    // Create new sphere
-    mesh = Mesh::CreateSphere(m_renderer, radius, segments);
-    if (mesh) {
-        m_meshes[key] = mesh;
-        LOG_DEBUG("Created and cached sphere with radius: " << radius << ", segments: " << segments);
+    if (IsPrimitiveName(name)) {
+        std::string params = name;
+        size_t separator = params.find('_');
+        std::string type = params.substr(0, separator);
+        std::replace(params.begin(), params.end(), '_', ' ');
+        std::istringstream stream(params.substr(separator + 1));
+        float first = 0.0f;
+        float second = 0.0f;
+        stream >> first >> second;
+
+        if (type == "cube") {
+            return GetCube(first);
+        }
+        if (type == "sphere") {
+            return GetSphere(first, second > 0.0f ? static_cast<UINT>(second) : 16);
+        }
+        return GetPlane(first, second > 0.0f ? second : first);
     }
 
-    return mesh;
+    return LoadMesh(name);
 }
 
-std::shared_ptr<Mesh> MeshManager::GetPlane(float width, float height) {
-    std::string key = GeneratePrimitiveKey("plane", width, height);
+bool MeshManager::IsPrimitiveName(const std::string& name) {
+    // Primitive names come from GeneratePrimitiveKey: type_param1[_param2][_param3]
+    size_t separator = name.find('_');
+    if (separator == std::string::npos) {
+        return false;
+    }
+    std::string type = name.substr(0, separator);
+    return type == "cube" || type == "sphere" || type == "plane";
+}
 
-    // Check cache
-    auto mesh = GetMesh(key);
-    if (mesh) {
+std::shared_ptr<Mesh> MeshManager::GetCube(float size) {
+    std::string key = GeneratePrimitiveKey("cube", size);
+
+    return m_meshes.GetOrLoad(key, [&]() {
+        auto mesh = Mesh::CreateCube(m_renderer, size);
+        if (mesh) {
+            LOG_DEBUG("Created and cached cube with size: " << size);
+        }
         return mesh;
-    }
+    });
+}
 
-    // Create new plane
-    mesh = Mesh::CreatePlane(m_renderer, width, height);
-    if (mesh) {
-        m_meshes[key] = mesh;
-        LOG_DEBUG("Created and cached plane with size: " << width << "x" << height);
-    }
+std::shared_ptr<Mesh> MeshManager::GetSphere(float radius, UINT segments) {
+    std::string key = GeneratePrimitiveKey("sphere", radius, 0.0f, segments);
 
-    return mesh;
+    return m_meshes.GetOrLoad(key, [&]() {
+        auto mesh = Mesh::CreateSphere(m_renderer, radius, segments);
+        if (mesh) {
+            LOG_DEBUG("Created and cached sphere with radius: " << radius << ", segments: " << segments);
+        }
+        return mesh;
+    });
+}
+
+std::shared_ptr<Mesh> MeshManager::GetPlane(float width, float height) {
+    std::string key = GeneratePrimitiveKey("plane", width, height);
+
+    return m_meshes.GetOrLoad(key, [&]() {
+        auto mesh = Mesh::CreatePlane(m_renderer, width, height);
+        if (mesh) {
+            LOG_DEBUG("Created and cached plane with size: " << width << "x" << height);
+        }
+        return mesh;
+    });
 }
 
 void MeshManager::PrintStatistics() const {
     LOG_INFO("=== MeshManager Statistics ===");
-    LOG_INFO("Total cached meshes: " << m_meshes.size());
+    LOG_INFO("Total cached meshes: " << m_meshes.GetCount());
 
-    size_t loadedCount = 0;
-    size_t expiredCount = 0;
+    size_t usedCount = 0;
+    size_t unusedCount = 0;
 
-    for (const auto& pair : m_meshes) {
-        if (pair.second.lock()) {
-            loadedCount++;
-            LOG_DEBUG("  - " << pair.first << " (loaded)");
+    m_meshes.ForEach([&](const std::string& name, const std::shared_ptr<Mesh>& mesh) {
+        // The cache itself holds one reference
+        if (mesh.use_count() > 1) {
+            usedCount++;
+            LOG_DEBUG("  - " << name << " (in use)");
         } else {
-            expiredCount++;
-            LOG_DEBUG("  - " << pair.first << " (expired)");
+            unusedCount++;
+            LOG_DEBUG("  - " << name << " (unused)");
         }
-    }
+    });
 
-    LOG_INFO("Active meshes: " << loadedCount);
-    LOG_INFO("Expired entries: " << expiredCount);
+    LOG_INFO("Active meshes: " << usedCount);
+    LOG_INFO("Unused meshes: " << unusedCount);
+    LOG_INFO("Memory: " << (m_meshes.GetMemoryUsage() / 1024) << " KB");
     LOG_INFO("===============================");
 }
 
 void MeshManager::ClearUnusedMeshes() {
-    auto it = m_meshes.begin();
-    size_t removedCount = 0;
+    size_t removedCount = m_meshes.Trim(0);
 
-    while (it != m_meshes.end()) {
-        if (it->second.expired()) {
-            it = m_meshes.erase(it);
-            removedCount++;
-        } else {
-            ++it;
-        }
+    if (removedCount > 0) {
+        LOG_INFO("Cleared " << removedCount << " unused meshes");
     }
+}
+
+void MeshManager::TrimCache(size_t budgetBytes) {
+    size_t removedCount = m_meshes.Trim(budgetBytes);
 
     if (removedCount > 0) {
-        LOG_INFO("Cleared " << removedCount << " unused mesh entries");
+        LOG_DEBUG("Evicted " << removedCount << " unused meshes to stay within " << (budgetBytes / (1024 * 1024)) << " MB");
     }
 }
 
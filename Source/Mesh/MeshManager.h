@@ -3,6 +3,8 @@
 #include <unordered_map>
 #include <string>
 #include "Mesh.h"
+#include "AsyncLoader.h"
+#include "../Core/AssetCache.h"
 
 namespace GameEngine {
 
@@ -13,6 +15,9 @@ namespace Renderer {
 
 namespace Mesh {
 
+// Cache of loaded and primitive meshes. Safe to call from any thread:
+// loader and worker threads may load meshes while the main thread renders,
+// and simultaneous requests for one file share a single load.
 class MeshManager {
 public:
     static MeshManager& GetInstance();
@@ -22,9 +27,23 @@ public:
 
     // Mesh loading and management
     std::shared_ptr<Mesh> LoadMesh(const std::string& filename);
+    // Loads on the AsyncLoader threads; the handle yields the placeholder until ready
+    AssetHandle<Mesh> LoadMeshAsync(const std::string& filename, LoadPriority priority = LoadPriority::Normal);
+    void RegisterMesh(const std::string& name, std::shared_ptr<Mesh> mesh) { m_meshes.Insert(name, std::move(mesh)); }
     std::shared_ptr<Mesh> GetMesh(const std::string& name);
     bool UnloadMesh(const std::string& name);
     void UnloadAllMeshes();
+    // Re-import a changed file into the cached meshes loaded from it, so
+    // existing references pick up the new data. Returns true if any were.
+    bool ReloadMesh(const std::string& filename);
+
+    // Cache name a loaded mesh is registered under, empty if it is not cached
+    std::string FindMeshName(const std::shared_ptr<Mesh>& mesh) const;
+    // Inverse for saved references: the cached mesh, a primitive rebuilt
+    // from its name, or a load from file
+    std::shared_ptr<Mesh> ResolveMesh(const std::string& name);
+    // True for cache names produced by GetCube/GetSphere/GetPlane
+    static bool IsPrimitiveName(const std::string& name);
 
     // Primitive creation (cached)
     std::shared_ptr<Mesh> GetCube(float size = 1.0f);
@@ -32,14 +51,17 @@ public:
     std::shared_ptr<Mesh> GetPlane(float width = 1.0f, float height = 1.0f);
 
     // Statistics
-    size_t GetLoadedMeshCount() const { return m_meshes.size(); }
+    size_t GetLoadedMeshCount() const { return m_meshes.GetCount(); }
+    size_t GetMemoryUsage() const { return m_meshes.GetMemoryUsage(); }
     void PrintStatistics() const;
 
     // Resource management
     void ClearUnusedMeshes(); // Remove meshes with only one reference (the manager)
+    // Drop unused meshes, least recently used first, while over budget
+    void TrimCache(size_t budgetBytes);
 
 private:
-    MeshManager() = default;
+    MeshManager();
     ~MeshManager() = default;
 
     // Non-copyable
@@ -50,7 +72,7 @@ private:
 
 private:
     Renderer::D3D11Renderer* m_renderer;
-    std::unordered_map<std::string, std::weak_ptr<Mesh>> m_meshes;
+    Core::AssetCache<std::string, Mesh> m_meshes;
     bool m_initialized;
 };
 
@@ -0,0 +1,326 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace GameEngine {
+namespace Mesh {
+
+namespace {
+
+// Forsyth's scoring constants, tuned for a 32-entry LRU model of the cache
+constexpr size_t MODEL_CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+// Hardware-like FIFO cache used to measure orderings and find cluster boundaries
+constexpr UINT FIFO_CACHE_SIZE = 16;
+
+constexpr size_t INVALID_TRIANGLE = std::numeric_limits<size_t>::max();
+
+// A vertex hits while fewer than FIFO_CACHE_SIZE misses came after its own
+class FifoCache {
+public:
+    explicit FifoCache(size_t vertexCount) : m_timestamps(vertexCount, 0), m_time(FIFO_CACHE_SIZE + 1) {}
+
+    // 1 on a miss, 0 on a hit
+    UINT Access(UINT vertex) {
+        if (m_time - m_timestamps[vertex] > FIFO_CACHE_SIZE) {
+            m_timestamps[vertex] = m_time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    UINT AccessTriangle(const UINT* triangle) {
+        return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+    }
+
+    void Flush() { m_time += FIFO_CACHE_SIZE + 1; }
+
+private:
+    std::vector<UINT> m_timestamps;
+    UINT m_time;
+};
+
+struct Cluster {
+    size_t start;       // Triangles
+    size_t end;
+    float sortKey;
+};
+
+float VertexScore(int cachePosition, UINT remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        // The last triangle's vertices score lower so the order does not turn back on itself
+        if (cachePosition < 3) {
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            float scale = 1.0f / static_cast<float>(MODEL_CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale, CACHE_DECAY_POWER);
+        }
+    }
+
+    // Vertices with few triangles left are finished off before they drop out
+    return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+}
+
+bool IndicesInRange(const UINT* indices, size_t indexCount, size_t vertexCount) {
+    return std::all_of(indices, indices + indexCount, [vertexCount](UINT index) { return index < vertexCount; });
+}
+
+} // namespace
+
+void MeshOptimizer::OptimizeVertexCache(UINT* indices, size_t indexCount, size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || !IndicesInRange(indices, triangleCount * 3, vertexCount)) {
+        return;
+    }
+    const std::vector<UINT> source(indices, indices + triangleCount * 3);
+
+    // Unemitted triangles around each vertex; lists shrink as triangles are emitted
+    std::vector<UINT> remaining(vertexCount, 0);
+    for (UINT index : source) {
+        remaining[index]++;
+    }
+    std::vector<UINT> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<UINT> adjacency(source.size());
+    std::vector<UINT> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < source.size(); i++) {
+        adjacency[fill[source[i]]++] = static_cast<UINT>(i / 3);
+    }
+
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        scores[v] = VertexScore(-1, remaining[v]);
+    }
+    auto triangleScore = [&source, &scores](size_t triangle) {
+        return scores[source[triangle * 3]] + scores[source[triangle * 3 + 1]] + scores[source[triangle * 3 + 2]];
+    };
+
+    // Start where vertices are closest to finished, usually a border
+    size_t best = 0;
+    float bestScore = triangleScore(0);
+    for (size_t t = 1; t < triangleCount; t++) {
+        float score = triangleScore(t);
+        if (score > bestScore) {
+            best = t;
+            bestScore = score;
+        }
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    UINT cache[MODEL_CACHE_SIZE + 3];
+    UINT updated[MODEL_CACHE_SIZE + 3];
+    size_t cacheCount = 0;
+    size_t cursor = 0;
+
+    for (size_t output = 0; output < triangleCount; output++) {
+        if (best == INVALID_TRIANGLE) {
+            // Nothing cached touches an unemitted triangle; resume in input order
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = cursor;
+        }
+
+        const UINT* triangle = &source[best * 3];
+        std::copy(triangle, triangle + 3, indices + output * 3);
+        emitted[best] = true;
+
+        for (int k = 0; k < 3; k++) {
+            UINT vertex = triangle[k];
+            UINT* list = &adjacency[offsets[vertex]];
+            UINT count = remaining[vertex];
+            for (UINT j = 0; j < count; j++) {
+                if (list[j] == best) {
+                    list[j] = list[count - 1];
+                    break;
+                }
+            }
+            remaining[vertex]--;
+        }
+
+        // The triangle's vertices move to the front; entries pushed past the end fall out
+        size_t updatedCount = 0;
+        for (int k = 0; k < 3; k++) {
+            if (std::find(updated, updated + updatedCount, triangle[k]) == updated + updatedCount) {
+                updated[updatedCount++] = triangle[k];
+            }
+        }
+        for (size_t i = 0; i < cacheCount; i++) {
+            if (cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2]) {
+                updated[updatedCount++] = cache[i];
+            }
+        }
+        for (size_t i = 0; i < updatedCount; i++) {
+            UINT vertex = updated[i];
+            scores[vertex] = VertexScore(i < MODEL_CACHE_SIZE ? static_cast<int>(i) : -1, remaining[vertex]);
+        }
+        cacheCount = std::min(updatedCount, MODEL_CACHE_SIZE);
+        std::copy(updated, updated + cacheCount, cache);
+
+        // Next is the best unemitted triangle that reuses a cached vertex
+        best = INVALID_TRIANGLE;
+        bestScore = 0.0f;
+        for (size_t i = 0; i < cacheCount; i++) {
+            UINT vertex = cache[i];
+            const UINT* list = &adjacency[offsets[vertex]];
+            for (UINT j = 0; j < remaining[vertex]; j++) {
+                float score = triangleScore(list[j]);
+                if (score > bestScore) {
+                    best = list[j];
+                    bestScore = score;
+                }
+            }
+        }
+    }
+}
+
+void MeshOptimizer::OptimizeOverdraw(UINT* indices, size_t indexCount, const std::vector<DirectX::XMFLOAT3>& positions,
+                                     float threshold) {
+    using namespace DirectX;
+
+    const size_t triangleCount = indexCount / 3;
+    const size_t vertexCount = positions.size();
+    if (triangleCount < 2 || !IndicesInRange(indices, triangleCount * 3, vertexCount)) {
+        return;
+    }
+    const std::vector<UINT> source(indices, indices + triangleCount * 3);
+    FifoCache cache(vertexCount);
+
+    // Hard boundaries: the cache order restarted, every vertex of the triangle missed
+    std::vector<size_t> hardStarts;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (cache.AccessTriangle(&source[t * 3]) == 3 || t == 0) {
+            hardStarts.push_back(t);
+        }
+    }
+    hardStarts.push_back(triangleCount);
+
+    // Soft boundaries: start a new cluster, with a cold cache, once the
+    // current one has earned back its initial misses
+    std::vector<Cluster> clusters;
+    for (size_t h = 0; h + 1 < hardStarts.size(); h++) {
+        const size_t start = hardStarts[h];
+        const size_t end = hardStarts[h + 1];
+
+        cache.Flush();
+        UINT clusterMisses = 0;
+        for (size_t t = start; t < end; t++) {
+            clusterMisses += cache.AccessTriangle(&source[t * 3]);
+        }
+        float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+        cache.Flush();
+        size_t softStart = start;
+        UINT runningMisses = 0;
+        for (size_t t = start; t < end; t++) {
+            runningMisses += cache.AccessTriangle(&source[t * 3]);
+            if (static_cast<float>(runningMisses) <= clusterThreshold * static_cast<float>(t + 1 - softStart)) {
+                clusters.push_back({ softStart, t + 1, 0.0f });
+                softStart = t + 1;
+                runningMisses = 0;
+                cache.Flush();
+            }
+        }
+        if (softStart < end) {
+            clusters.push_back({ softStart, end, 0.0f });
+        }
+    }
+    if (clusters.size() < 2) {
+        return;
+    }
+
+    // Area-weighted centroid and normal of each cluster
+    std::vector<XMVECTOR> centroids(clusters.size());
+    std::vector<XMVECTOR> normals(clusters.size());
+    XMVECTOR meshCentroid = XMVectorZero();
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusters.size(); c++) {
+        XMVECTOR centroid = XMVectorZero();
+        XMVECTOR normal = XMVectorZero();
+        float area = 0.0f;
+        for (size_t t = clusters[c].start; t < clusters[c].end; t++) {
+            XMVECTOR p0 = XMLoadFloat3(&positions[source[t * 3]]);
+            XMVECTOR p1 = XMLoadFloat3(&positions[source[t * 3 + 1]]);
+            XMVECTOR p2 = XMLoadFloat3(&positions[source[t * 3 + 2]]);
+            XMVECTOR cross = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+            float triangleArea = XMVectorGetX(XMVector3Length(cross));
+
+            centroid = XMVectorAdd(centroid, XMVectorScale(XMVectorAdd(XMVectorAdd(p0, p1), p2), triangleArea / 3.0f));
+            normal = XMVectorAdd(normal, cross);
+            area += triangleArea;
+        }
+
+        meshCentroid = XMVectorAdd(meshCentroid, centroid);
+        meshArea += area;
+        centroids[c] = area > 0.0f ? XMVectorScale(centroid, 1.0f / area) : centroid;
+        normals[c] = XMVector3Normalize(normal);
+    }
+    if (meshArea <= 0.0f) {
+        return;
+    }
+    meshCentroid = XMVectorScale(meshCentroid, 1.0f / meshArea);
+
+    // Clusters facing outward from the centre occlude the rest, so they go first
+    for (size_t c = 0; c < clusters.size(); c++) {
+        clusters[c].sortKey = XMVectorGetX(XMVector3Dot(XMVectorSubtract(centroids[c], meshCentroid), normals[c]));
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    UINT* output = indices;
+    for (const Cluster& cluster : clusters) {
+        output = std::copy(source.begin() + cluster.start * 3, source.begin() + cluster.end * 3, output);
+    }
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(std::vector<UINT>& remap, UINT* indices, size_t indexCount,
+                                          size_t vertexCount) {
+    remap.assign(vertexCount, INVALID_INDEX);
+    if (!IndicesInRange(indices, indexCount, vertexCount)) {
+        for (size_t v = 0; v < vertexCount; v++) {
+            remap[v] = static_cast<UINT>(v);
+        }
+        return vertexCount;
+    }
+
+    UINT next = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        UINT& index = indices[i];
+        if (remap[index] == INVALID_INDEX) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    return next;
+}
+
+float MeshOptimizer::ComputeACMR(const UINT* indices, size_t indexCount, size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || !IndicesInRange(indices, triangleCount * 3, vertexCount)) {
+        return 0.0f;
+    }
+
+    FifoCache cache(vertexCount);
+    std::uint64_t misses = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+        misses += cache.AccessTriangle(indices + t * 3);
+    }
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+} // namespace Mesh
+} // namespace GameEngine
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+namespace GameEngine {
+namespace Mesh {
+
+// Reorders indexed triangle lists for the GPU's vertex pipeline.
+//
+// Triangles are first ordered for the post-transform vertex cache with
+// Forsyth's linear-speed algorithm, then cut into clusters where that order
+// restarts (Tipsify-style) and the clusters sorted so those facing away from
+// the mesh centre, the likely occluders, draw first. Splitting only where
+// the cache is cold bounds what the overdraw pass costs in cache misses.
+// Last, vertices are renumbered in first-use order so the vertex fetch walks
+// memory forwards.
+class MeshOptimizer {
+public:
+    static constexpr UINT INVALID_INDEX = 0xFFFFFFFFu;
+
+    // Reorder triangles in place; lists with out-of-range indices are left alone
+    static void OptimizeVertexCache(UINT* indices, size_t indexCount, size_t vertexCount);
+
+    // Reorder cache-ordered triangles in place by cluster. Clusters may be
+    // split further while their miss rate stays within threshold (>= 1) of
+    // the unsplit order.
+    static void OptimizeOverdraw(UINT* indices, size_t indexCount, const std::vector<DirectX::XMFLOAT3>& positions,
+                                 float threshold);
+
+    // Renumber vertices in order of first use and rewrite indices to match.
+    // remap receives the new index of each vertex, INVALID_INDEX for unused
+    // ones; returns how many are used.
+    static size_t OptimizeVertexFetch(std::vector<UINT>& remap, UINT* indices, size_t indexCount, size_t vertexCount);
+
+    // Average vertex shader runs per triangle through a FIFO cache; 0.5 is
+    // ideal for regular grids, 3 means no reuse at all
+    static float ComputeACMR(const UINT* indices, size_t indexCount, size_t vertexCount);
+};
+
+} // namespace Mesh
+} // namespace GameEngine
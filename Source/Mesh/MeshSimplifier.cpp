@@ -0,0 +1,282 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace GameEngine {
+namespace Mesh {
+
+namespace {
+
+// Passes over the whole mesh before giving up on reaching the target
+constexpr int MAX_PASSES = 64;
+
+// Collapses that turn a face by more than this (cosine) are rejected
+constexpr float MIN_NORMAL_ALIGNMENT = 0.2f;
+
+// Symmetric 4x4 plane quadric: xx xy xz xw yy yz yw zz zw ww
+struct Quadric {
+    double m[10] = {};
+
+    void AddPlane(double a, double b, double c, double d, double weight) {
+        m[0] += weight * a * a; m[1] += weight * a * b; m[2] += weight * a * c; m[3] += weight * a * d;
+        m[4] += weight * b * b; m[5] += weight * b * c; m[6] += weight * b * d;
+        m[7] += weight * c * c; m[8] += weight * c * d;
+        m[9] += weight * d * d;
+    }
+
+    void Add(const Quadric& other) {
+        for (int i = 0; i < 10; i++) {
+            m[i] += other.m[i];
+        }
+    }
+
+    double Evaluate(const DirectX::XMFLOAT3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x
+             + m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y
+             + m[7] * z * z + 2.0 * m[8] * z
+             + m[9];
+    }
+};
+
+struct Collapse {
+    double cost;
+    UINT source;
+    UINT target;
+};
+
+std::uint64_t EdgeKey(UINT a, UINT b) {
+    return a < b ? (static_cast<std::uint64_t>(a) << 32) | b : (static_cast<std::uint64_t>(b) << 32) | a;
+}
+
+std::uint64_t PositionKey(const DirectX::XMFLOAT3& p) {
+    std::uint32_t bits[3];
+    std::memcpy(bits, &p, sizeof(bits));
+    std::uint64_t hash = bits[0];
+    hash = hash * 0x9E3779B97F4A7C15ull ^ bits[1];
+    hash = hash * 0x9E3779B97F4A7C15ull ^ bits[2];
+    return hash;
+}
+
+DirectX::XMVECTOR TriangleNormal(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, const DirectX::XMFLOAT3& c) {
+    DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&a);
+    return DirectX::XMVector3Cross(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&b), p0),
+                                   DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&c), p0));
+}
+
+} // namespace
+
+std::vector<UINT> MeshSimplifier::Simplify(const std::vector<DirectX::XMFLOAT3>& positions,
+                                           const UINT* indices, size_t indexCount, size_t targetIndexCount) {
+    std::vector<UINT> result(indices, indices + (indexCount - indexCount % 3));
+    const size_t vertexCount = positions.size();
+    if (result.size() <= targetIndexCount || vertexCount == 0) {
+        return result;
+    }
+
+    for (UINT index : result) {
+        if (index >= vertexCount) {
+            return result;
+        }
+    }
+
+    // Vertices at the same position are one point of the surface
+    std::vector<UINT> weld(vertexCount);
+    {
+        std::unordered_map<std::uint64_t, UINT> firstAtPosition;
+        firstAtPosition.reserve(vertexCount);
+        for (UINT v = 0; v < vertexCount; v++) {
+            auto it = firstAtPosition.emplace(PositionKey(positions[v]), v).first;
+            const DirectX::XMFLOAT3& other = positions[it->second];
+            bool same = other.x == positions[v].x && other.y == positions[v].y && other.z == positions[v].z;
+            weld[v] = same ? it->second : v;
+        }
+    }
+
+    // Seam vertices (several used copies at one position) stay put
+    std::vector<UINT> copies(vertexCount, 0);
+    std::vector<std::uint8_t> used(vertexCount, 0);
+    for (UINT index : result) {
+        if (!used[index]) {
+            used[index] = 1;
+            copies[weld[index]]++;
+        }
+    }
+
+    std::vector<std::uint8_t> lockedPosition(vertexCount, 0);
+    for (UINT v = 0; v < vertexCount; v++) {
+        if (copies[v] > 1) {
+            lockedPosition[v] = 1;
+        }
+    }
+
+    // So do open borders and non-manifold edges
+    {
+        std::unordered_map<std::uint64_t, UINT> edgeUse;
+        edgeUse.reserve(result.size());
+        for (size_t t = 0; t < result.size(); t += 3) {
+            for (int e = 0; e < 3; e++) {
+                edgeUse[EdgeKey(weld[result[t + e]], weld[result[t + (e + 1) % 3]])]++;
+            }
+        }
+        for (const auto& edge : edgeUse) {
+            if (edge.second != 2) {
+                lockedPosition[static_cast<UINT>(edge.first >> 32)] = 1;
+                lockedPosition[static_cast<UINT>(edge.first & 0xFFFFFFFFu)] = 1;
+            }
+        }
+    }
+
+    // Area-weighted plane quadrics per welded position
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t < result.size(); t += 3) {
+        DirectX::XMVECTOR normal = TriangleNormal(positions[result[t]], positions[result[t + 1]], positions[result[t + 2]]);
+        float doubleArea = DirectX::XMVectorGetX(DirectX::XMVector3Length(normal));
+        if (doubleArea <= 0.0f) {
+            continue;
+        }
+
+        DirectX::XMFLOAT3 n;
+        DirectX::XMStoreFloat3(&n, DirectX::XMVectorScale(normal, 1.0f / doubleArea));
+        const DirectX::XMFLOAT3& p = positions[result[t]];
+        double d = -(static_cast<double>(n.x) * p.x + static_cast<double>(n.y) * p.y + static_cast<double>(n.z) * p.z);
+        for (int corner = 0; corner < 3; corner++) {
+            quadrics[weld[result[t + corner]]].AddPlane(n.x, n.y, n.z, d, doubleArea * 0.5);
+        }
+    }
+
+    std::vector<UINT> triangleOffsets;
+    std::vector<UINT> vertexTriangles;
+    std::vector<Collapse> candidates;
+    std::vector<std::uint8_t> touched(vertexCount);
+
+    for (int pass = 0; pass < MAX_PASSES && result.size() > targetIndexCount; pass++) {
+        const size_t triangleCount = result.size() / 3;
+
+        // Triangles around each vertex
+        triangleOffsets.assign(vertexCount + 1, 0);
+        for (UINT index : result) {
+            triangleOffsets[index + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; v++) {
+            triangleOffsets[v + 1] += triangleOffsets[v];
+        }
+        vertexTriangles.resize(result.size());
+        {
+            std::vector<UINT> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++) {
+                vertexTriangles[cursor[result[i]]++] = static_cast<UINT>(i / 3);
+            }
+        }
+
+        // Cheapest direction of every edge that may collapse
+        candidates.clear();
+        for (size_t t = 0; t < result.size(); t += 3) {
+            for (int e = 0; e < 3; e++) {
+                UINT a = result[t + e];
+                UINT b = result[t + (e + 1) % 3];
+                if (a > b || weld[a] == weld[b]) {
+                    continue;   // Each shared edge is seen from both sides
+                }
+
+                bool lockedA = lockedPosition[weld[a]] != 0;
+                bool lockedB = lockedPosition[weld[b]] != 0;
+                if (lockedA && lockedB) {
+                    continue;
+                }
+
+                Quadric combined = quadrics[weld[a]];
+                combined.Add(quadrics[weld[b]]);
+                double costAToB = lockedA ? std::numeric_limits<double>::max() : combined.Evaluate(positions[b]);
+                double costBToA = lockedB ? std::numeric_limits<double>::max() : combined.Evaluate(positions[a]);
+                candidates.push_back(costAToB <= costBToA ? Collapse{ costAToB, a, b } : Collapse{ costBToA, b, a });
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+            [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t remaining = triangleCount;
+        const size_t targetTriangles = targetIndexCount / 3;
+        size_t collapses = 0;
+
+        for (const Collapse& collapse : candidates) {
+            if (remaining <= targetTriangles) {
+                break;
+            }
+
+            UINT source = collapse.source;
+            UINT target = collapse.target;
+            if (touched[weld[source]] || touched[weld[target]]) {
+                continue;
+            }
+
+            // Reject collapses that flip or squash a surviving triangle
+            bool acceptable = true;
+            size_t removed = 0;
+            for (UINT i = triangleOffsets[source]; i < triangleOffsets[source + 1] && acceptable; i++) {
+                const UINT* corners = &result[vertexTriangles[i] * 3];
+                if (weld[corners[0]] == weld[target] || weld[corners[1]] == weld[target] || weld[corners[2]] == weld[target]) {
+                    removed++;
+                    continue;
+                }
+
+                DirectX::XMFLOAT3 moved[3];
+                for (int c = 0; c < 3; c++) {
+                    moved[c] = positions[corners[c] == source ? target : corners[c]];
+                }
+                DirectX::XMVECTOR before = TriangleNormal(positions[corners[0]], positions[corners[1]], positions[corners[2]]);
+                DirectX::XMVECTOR after = TriangleNormal(moved[0], moved[1], moved[2]);
+                float alignment = DirectX::XMVectorGetX(DirectX::XMVector3Dot(before, after));
+                float scale = DirectX::XMVectorGetX(DirectX::XMVector3Length(before)) *
+                              DirectX::XMVectorGetX(DirectX::XMVector3Length(after));
+                if (scale <= 0.0f || alignment < MIN_NORMAL_ALIGNMENT * scale) {
+                    acceptable = false;
+                }
+            }
+            if (!acceptable) {
+                continue;
+            }
+
+            // Neighbourhood changes, so nothing around it collapses again this pass
+            for (UINT i = triangleOffsets[source]; i < triangleOffsets[source + 1]; i++) {
+                UINT* corners = &result[vertexTriangles[i] * 3];
+                for (int c = 0; c < 3; c++) {
+                    touched[weld[corners[c]]] = 1;
+                    if (corners[c] == source) {
+                        corners[c] = target;
+                    }
+                }
+            }
+
+            quadrics[weld[target]].Add(quadrics[weld[source]]);
+            remaining -= removed;
+            collapses++;
+        }
+
+        // Drop triangles that lost an edge
+        size_t write = 0;
+        for (size_t t = 0; t < result.size(); t += 3) {
+            UINT w0 = weld[result[t]], w1 = weld[result[t + 1]], w2 = weld[result[t + 2]];
+            if (w0 != w1 && w1 != w2 && w0 != w2) {
+                result[write++] = result[t];
+                result[write++] = result[t + 1];
+                result[write++] = result[t + 2];
+            }
+        }
+        result.resize(write);
+
+        if (collapses == 0) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+} // namespace Mesh
+} // namespace GameEngine
@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+namespace GameEngine {
+namespace Mesh {
+
+// Quadric error metric simplification of indexed triangle lists.
+//
+// Vertices are collapsed onto one of their neighbours, so the result only
+// rewrites indices and can share the original vertex buffer. Collapses run
+// in passes, cheapest first by summed plane quadrics, rejecting any that
+// would flip a triangle. Open borders and vertices duplicated for UV or
+// normal seams never move, which keeps outlines and texture charts intact.
+class MeshSimplifier {
+public:
+    // Simplify a triangle list towards targetIndexCount indices. Stops early
+    // when no acceptable collapse remains, so the result may be larger.
+    static std::vector<UINT> Simplify(const std::vector<DirectX::XMFLOAT3>& positions,
+                                      const UINT* indices, size_t indexCount, size_t targetIndexCount);
+};
+
+} // namespace Mesh
+} // namespace GameEngine
@@ -0,0 +1,137 @@
+#include "StaticMeshBatcher.h"
+#include "Mesh.h"
+#include "../Renderer/D3D11Renderer.h"
+#include "../Renderer/GpuMemory.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+
+namespace GameEngine {
+namespace Mesh {
+
+namespace {
+
+Microsoft::WRL::ComPtr<ID3D11Buffer> CreateSharedBuffer(ID3D11Device* device, std::uint64_t size, UINT bindFlags) {
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.ByteWidth = static_cast<UINT>(size);
+    desc.BindFlags = bindFlags;
+
+    Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+    if (FAILED(device->CreateBuffer(&desc, nullptr, &buffer))) {
+        return nullptr;
+    }
+    Renderer::TrackGpuMemory(buffer.Get(), Core::MemoryCategory::Meshes);
+    return buffer;
+}
+
+void CopyRange(ID3D11DeviceContext* context, ID3D11Buffer* destination, UINT destinationOffset,
+               ID3D11Buffer* source, UINT sourceOffset, UINT size) {
+    D3D11_BOX box = { sourceOffset, 0, 0, sourceOffset + size, 1, 1 };
+    context->CopySubresourceRegion(destination, 0, destinationOffset, 0, 0, source, 0, &box);
+}
+
+} // namespace
+
+UINT StaticMeshBatcher::Build(const std::vector<std::shared_ptr<Mesh>>& meshes, Renderer::D3D11Renderer* renderer) {
+    Clear();
+    if (!renderer || !renderer->GetDevice()) {
+        return 0;
+    }
+
+    std::vector<Mesh*> candidates;
+    candidates.reserve(meshes.size());
+    for (const auto& mesh : meshes) {
+        if (mesh && mesh->IsLoaded() && !mesh->IsAnimated() && mesh->GetVertexBuffer() && mesh->GetIndexBuffer()) {
+            candidates.push_back(mesh.get());
+        }
+    }
+
+    // Group by stride and index format, largest first so big meshes do not strand small ones
+    std::sort(candidates.begin(), candidates.end(), [](const Mesh* a, const Mesh* b) {
+        if (a->GetVertexStride() != b->GetVertexStride()) {
+            return a->GetVertexStride() < b->GetVertexStride();
+        }
+        if (a->GetIndexStride() != b->GetIndexStride()) {
+            return a->GetIndexStride() < b->GetIndexStride();
+        }
+        if (a->GetVertexCount() != b->GetVertexCount()) {
+            return a->GetVertexCount() > b->GetVertexCount();
+        }
+        return a < b;
+    });
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    ID3D11Device* device = renderer->GetDevice();
+    ID3D11DeviceContext* context = renderer->GetContext();
+
+    size_t start = 0;
+    while (start < candidates.size()) {
+        const UINT stride = candidates[start]->GetVertexStride();
+        const UINT indexStride = candidates[start]->GetIndexStride();
+
+        // Fill one buffer pair up to the size limit
+        size_t end = start;
+        std::uint64_t vertexBytes = 0;
+        std::uint64_t indexBytes = 0;
+        while (end < candidates.size() && candidates[end]->GetVertexStride() == stride &&
+               candidates[end]->GetIndexStride() == indexStride) {
+            std::uint64_t meshVertexBytes = static_cast<std::uint64_t>(candidates[end]->GetVertexCount()) * stride;
+            std::uint64_t meshIndexBytes = static_cast<std::uint64_t>(candidates[end]->GetIndexCount()) * indexStride;
+            if (end > start && (vertexBytes + meshVertexBytes > MAX_BUFFER_BYTES ||
+                                indexBytes + meshIndexBytes > MAX_BUFFER_BYTES)) {
+                break;
+            }
+            vertexBytes += meshVertexBytes;
+            indexBytes += meshIndexBytes;
+            end++;
+        }
+
+        // A lone mesh gains nothing from moving
+        if (end - start < 2) {
+            start = end;
+            continue;
+        }
+
+        SharedBuffers shared;
+        shared.vertexBuffer = CreateSharedBuffer(device, vertexBytes, D3D11_BIND_VERTEX_BUFFER);
+        shared.indexBuffer = CreateSharedBuffer(device, indexBytes, D3D11_BIND_INDEX_BUFFER);
+        if (!shared.vertexBuffer || !shared.indexBuffer) {
+            LOG_ERROR("Failed to create static batch buffers (" << vertexBytes << " + " << indexBytes << " bytes)");
+            start = end;
+            continue;
+        }
+
+        UINT baseVertex = 0;
+        UINT baseIndex = 0;
+        for (size_t i = start; i < end; i++) {
+            Mesh* mesh = candidates[i];
+            CopyRange(context, shared.vertexBuffer.Get(), baseVertex * stride, mesh->GetVertexBuffer(),
+                      static_cast<UINT>(mesh->GetBaseVertex()) * stride, mesh->GetVertexCount() * stride);
+            CopyRange(context, shared.indexBuffer.Get(), baseIndex * indexStride, mesh->GetIndexBuffer(),
+                      mesh->GetBaseIndex() * indexStride, mesh->GetIndexCount() * indexStride);
+
+            mesh->SetSharedBuffers(shared.vertexBuffer, shared.indexBuffer, static_cast<INT>(baseVertex), baseIndex);
+            baseVertex += mesh->GetVertexCount();
+            baseIndex += mesh->GetIndexCount();
+        }
+
+        m_stats.meshCount += static_cast<UINT>(end - start);
+        m_stats.vertexBytes += vertexBytes;
+        m_stats.indexBytes += indexBytes;
+        m_buffers.push_back(std::move(shared));
+        start = end;
+    }
+
+    m_stats.bufferCount = static_cast<UINT>(m_buffers.size());
+    LOG_INFO("Packed " << m_stats.meshCount << " static meshes into " << m_stats.bufferCount << " buffer pairs ("
+             << (m_stats.vertexBytes + m_stats.indexBytes) / 1024 << " KB)");
+    return m_stats.meshCount;
+}
+
+void StaticMeshBatcher::Clear() {
+    m_buffers.clear();
+    m_stats = StaticBatchStats();
+}
+
+} // namespace Mesh
+} // namespace GameEngine
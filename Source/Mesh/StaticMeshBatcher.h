@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <d3d11.h>
+#include <wrl/client.h>
+
+namespace GameEngine {
+
+// Forward declaration
+namespace Renderer {
+    class D3D11Renderer;
+}
+
+namespace Mesh {
+
+class Mesh;
+
+// Shared geometry statistics
+struct StaticBatchStats {
+    UINT meshCount = 0;
+    UINT bufferCount = 0;           // Vertex/index buffer pairs
+    std::uint64_t vertexBytes = 0;
+    std::uint64_t indexBytes = 0;
+};
+
+// Packs static meshes into a few large vertex/index buffers.
+//
+// Meshes are grouped by vertex stride and index format and copied on the
+// GPU, so cooked meshes without CPU-side geometry can be packed too. Since
+// the base vertex is added after the index fetch, 16-bit meshes stay 16-bit
+// however large the shared buffer gets. Each packed mesh keeps its own
+// indices and submesh ranges and draws from the shared buffers with a base
+// vertex and base index, so consecutive draws of packed meshes need no IA
+// rebinds. Skinned meshes stay in their own buffers, compute skinning reads
+// them as a whole.
+class StaticMeshBatcher {
+public:
+    // Largest shared buffer; bigger groups are split
+    static constexpr UINT MAX_BUFFER_BYTES = 64 * 1024 * 1024;
+
+    // Pack the given meshes (duplicates and skinned meshes are skipped),
+    // returns how many were packed. Meshes already packed by an earlier
+    // Build move into the new buffers.
+    UINT Build(const std::vector<std::shared_ptr<Mesh>>& meshes, Renderer::D3D11Renderer* renderer);
+
+    // Drop the batcher's references; packed meshes keep their buffers alive
+    void Clear();
+
+    const StaticBatchStats& GetStats() const { return m_stats; }
+
+private:
+    struct SharedBuffers {
+        Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
+    };
+
+    std::vector<SharedBuffers> m_buffers;
+    StaticBatchStats m_stats;
+};
+
+} // namespace Mesh
+} // namespace GameEngine
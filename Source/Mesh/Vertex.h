@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
 #include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include <wrl/client.h>
 
 namespace GameEngine {
 namespace Mesh {
@@ -66,6 +69,53 @@ struct SkinnedVertex {
     }
 };
 
+// GPU vertex stream layouts. The CPU copy of a mesh always stays in
+// Vertex/SkinnedVertex; compact formats are encoded when the mesh is cooked.
+// Every compact attribute uses a DXGI format the input assembler expands to
+// float, so the same shaders run on all formats through a matching layout.
+enum class VertexFormat : std::uint8_t {
+    Standard = 0,   // Full precision Vertex / SkinnedVertex
+    Compact,        // Half UVs, SNORM8 normals, UNORM8 weights and UINT8 bone indices
+    Quantized,      // Compact with SNORM16 positions relative to the bounds, static meshes only
+    Count
+};
+
+static constexpr UINT VertexFormatCount = static_cast<UINT>(VertexFormat::Count);
+
+// 20 bytes instead of 32
+struct CompactVertex {
+    DirectX::XMFLOAT3 position;
+    DirectX::PackedVector::XMBYTEN4 normal;
+    DirectX::PackedVector::XMHALF2 texCoord;
+};
+
+// 16 bytes; position is (p - bounds centre) / largest half extent
+struct QuantizedVertex {
+    DirectX::PackedVector::XMSHORTN4 position;
+    DirectX::PackedVector::XMBYTEN4 normal;
+    DirectX::PackedVector::XMHALF2 texCoord;
+};
+
+// 28 bytes instead of 64. Starts like CompactVertex so static layouts can
+// draw it in the bind pose.
+struct CompactSkinnedVertex {
+    DirectX::XMFLOAT3 position;
+    DirectX::PackedVector::XMBYTEN4 normal;
+    DirectX::PackedVector::XMHALF2 texCoord;
+    DirectX::PackedVector::XMUBYTEN4 boneWeights;
+    DirectX::PackedVector::XMUBYTE4 boneIndices;
+};
+
+static_assert(sizeof(CompactVertex) == 20, "CompactVertex must match CompactVertexInputLayout");
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must match QuantizedVertexInputLayout");
+static_assert(sizeof(CompactSkinnedVertex) == 28, "CompactSkinnedVertex must match CompactSkinnedVertexInputLayout");
+
+// Per-instance data streamed in vertex buffer slot 1 for instanced draws
+struct InstanceData {
+    DirectX::XMFLOAT4X4 world;
+    unsigned int boneOffset; // First bone palette matrix, skinned instances only
+};
+
 // Input layout descriptions for DirectX
 static const D3D11_INPUT_ELEMENT_DESC VertexInputLayout[] = {
     {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
@@ -81,8 +131,127 @@ static const D3D11_INPUT_ELEMENT_DESC SkinnedVertexInputLayout[] = {
     {"BLENDINDICES", 0, DXGI_FORMAT_R32G32B32A32_UINT, 0, 48, D3D11_INPUT_PER_VERTEX_DATA, 0}
 };
 
+// Static vertex in slot 0 plus world matrix rows per instance in slot 1
+static const D3D11_INPUT_ELEMENT_DESC InstancedVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"INSTANCE_WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1}
+};
+
+// Skinned vertex in slot 0 plus world rows and bone palette offset per instance in slot 1
+static const D3D11_INPUT_ELEMENT_DESC SkinnedInstancedVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"BLENDWEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"BLENDINDICES", 0, DXGI_FORMAT_R32G32B32A32_UINT, 0, 48, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"INSTANCE_WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_BONES", 0, DXGI_FORMAT_R32_UINT, 1, 64, D3D11_INPUT_PER_INSTANCE_DATA, 1}
+};
+
+static const D3D11_INPUT_ELEMENT_DESC CompactVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0}
+};
+
+static const D3D11_INPUT_ELEMENT_DESC QuantizedVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0}
+};
+
+static const D3D11_INPUT_ELEMENT_DESC CompactSkinnedVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"BLENDWEIGHT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 20, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0}
+};
+
+static const D3D11_INPUT_ELEMENT_DESC CompactInstancedVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"INSTANCE_WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1}
+};
+
+static const D3D11_INPUT_ELEMENT_DESC QuantizedInstancedVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_SNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"INSTANCE_WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1}
+};
+
+static const D3D11_INPUT_ELEMENT_DESC CompactSkinnedInstancedVertexInputLayout[] = {
+    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"NORMAL", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"BLENDWEIGHT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 20, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    {"INSTANCE_WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"INSTANCE_BONES", 0, DXGI_FORMAT_R32_UINT, 1, 64, D3D11_INPUT_PER_INSTANCE_DATA, 1}
+};
+
 static constexpr UINT VertexInputLayoutCount = sizeof(VertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC);
 static constexpr UINT SkinnedVertexInputLayoutCount = sizeof(SkinnedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC);
+static constexpr UINT InstancedVertexInputLayoutCount = sizeof(InstancedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC);
+static constexpr UINT SkinnedInstancedVertexInputLayoutCount = sizeof(SkinnedInstancedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC);
+
+// Element table for one vertex format, null where the format does not apply
+struct VertexLayoutDesc {
+    const D3D11_INPUT_ELEMENT_DESC* elements;
+    UINT elementCount;
+};
+
+// Per-format tables for each kind of vertex shader, indexed by VertexFormat
+static const VertexLayoutDesc StaticVertexLayouts[VertexFormatCount] = {
+    { VertexInputLayout, VertexInputLayoutCount },
+    { CompactVertexInputLayout, sizeof(CompactVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC) },
+    { QuantizedVertexInputLayout, sizeof(QuantizedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC) }
+};
+
+static const VertexLayoutDesc SkinnedVertexLayouts[VertexFormatCount] = {
+    { SkinnedVertexInputLayout, SkinnedVertexInputLayoutCount },
+    { CompactSkinnedVertexInputLayout, sizeof(CompactSkinnedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC) },
+    { nullptr, 0 }
+};
+
+static const VertexLayoutDesc InstancedVertexLayouts[VertexFormatCount] = {
+    { InstancedVertexInputLayout, InstancedVertexInputLayoutCount },
+    { CompactInstancedVertexInputLayout, sizeof(CompactInstancedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC) },
+    { QuantizedInstancedVertexInputLayout, sizeof(QuantizedInstancedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC) }
+};
+
+static const VertexLayoutDesc SkinnedInstancedVertexLayouts[VertexFormatCount] = {
+    { SkinnedInstancedVertexInputLayout, SkinnedInstancedVertexInputLayoutCount },
+    { CompactSkinnedInstancedVertexInputLayout,
+      sizeof(CompactSkinnedInstancedVertexInputLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC) },
+    { nullptr, 0 }
+};
+
+// Input layouts of one vertex shader, one per vertex format
+struct VertexInputLayouts {
+    Microsoft::WRL::ComPtr<ID3D11InputLayout> layouts[VertexFormatCount];
+
+    ID3D11InputLayout* Get(VertexFormat format) const { return layouts[static_cast<UINT>(format)].Get(); }
+};
 
 } // namespace Mesh
 } // namespace GameEngine
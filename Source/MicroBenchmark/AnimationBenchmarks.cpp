@@ -0,0 +1,262 @@
+#include "MicroBenchmark.h"
+#include "../Animation/AnimationClip.h"
+#include "../Animation/AnimationController.h"
+#include "../Animation/Skeleton.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace GameEngine;
+using namespace GameEngine::Benchmark;
+
+namespace {
+
+constexpr float CLIP_DURATION = 2.0f;
+constexpr float FRAME_TIME = 1.0f / 60.0f;
+
+// Position, rotation and scale keys evenly spread over the clip
+Animation::AnimationChannel CreateChannel(int boneIndex, int keyCount) {
+    Animation::AnimationChannel channel;
+    channel.boneIndex = boneIndex;
+    for (int key = 0; key < keyCount; key++) {
+        float time = CLIP_DURATION * key / (keyCount - 1);
+        float angle = time * (1.0f + boneIndex * 0.1f);
+        DirectX::XMFLOAT4 rotation;
+        DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionRotationRollPitchYaw(angle * 0.3f, angle, angle * 0.1f));
+        channel.positionKeys.push_back(Animation::PositionKeyframe(time, DirectX::XMFLOAT3(0.0f, 0.5f + time * 0.01f, 0.0f)));
+        channel.rotationKeys.push_back(Animation::RotationKeyframe(time, rotation));
+        channel.scaleKeys.push_back(Animation::ScaleKeyframe(time, DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f)));
+    }
+    return channel;
+}
+
+std::shared_ptr<Animation::AnimationClip> CreateClip(const std::string& name, int boneCount, int keyCount) {
+    auto clip = std::make_shared<Animation::AnimationClip>(name);
+    clip->SetDuration(CLIP_DURATION);
+    clip->SetTicksPerSecond(1.0f);
+    for (int bone = 0; bone < boneCount; bone++) {
+        clip->AddChannel(CreateChannel(bone, keyCount));
+    }
+    return clip;
+}
+
+// Rotation keys only, as a sway or aim clip is authored
+std::shared_ptr<Animation::AnimationClip> CreateRotationClip(const std::string& name, int boneCount, int keyCount) {
+    auto clip = std::make_shared<Animation::AnimationClip>(name);
+    clip->SetDuration(CLIP_DURATION);
+    clip->SetTicksPerSecond(1.0f);
+    for (int bone = 0; bone < boneCount; bone++) {
+        Animation::AnimationChannel channel = CreateChannel(bone, keyCount);
+        channel.positionKeys.clear();
+        channel.scaleKeys.clear();
+        clip->AddChannel(channel);
+    }
+    return clip;
+}
+
+// Playback order: small forward steps that wrap, as a looping character samples
+float NextTime(float time) {
+    time += FRAME_TIME;
+    return time >= CLIP_DURATION ? time - CLIP_DURATION : time;
+}
+
+// Largest per-axis difference, as the compression tolerances are defined
+float AxisError(const DirectX::XMFLOAT3& expected, const DirectX::XMFLOAT3& actual) {
+    return std::max(std::fabs(expected.x - actual.x), std::max(std::fabs(expected.y - actual.y), std::fabs(expected.z - actual.z)));
+}
+
+// Angle between two rotations, in radians
+float RotationError(const DirectX::XMFLOAT4& expected, const DirectX::XMFLOAT4& actual) {
+    float dot = DirectX::XMVectorGetX(DirectX::XMVector4Dot(DirectX::XMLoadFloat4(&expected), DirectX::XMLoadFloat4(&actual)));
+    return 2.0f * std::acos(std::min(1.0f, std::fabs(dot)));
+}
+
+// Samples the compressed clip at every source key's time and checks the
+// decoded value against the key itself
+bool IsWithinTolerance(const Animation::AnimationClip& clip, const std::vector<Animation::AnimationChannel>& source,
+                       const Animation::AnimationCompressionSettings& settings, size_t boneCount) {
+    Animation::LocalPose pose;
+    pose.Resize(boneCount);
+    Animation::AnimationCursor cursor;
+
+    for (const Animation::AnimationChannel& channel : source) {
+        for (const Animation::PositionKeyframe& key : channel.positionKeys) {
+            clip.SampleLocalPose(key.time, pose, cursor);
+            if (AxisError(key.position, pose.translations[channel.boneIndex]) > settings.positionTolerance) {
+                return false;
+            }
+        }
+        for (const Animation::RotationKeyframe& key : channel.rotationKeys) {
+            clip.SampleLocalPose(key.time, pose, cursor);
+            if (RotationError(key.rotation, pose.rotations[channel.boneIndex]) > settings.rotationTolerance) {
+                return false;
+            }
+        }
+        for (const Animation::ScaleKeyframe& key : channel.scaleKeys) {
+            clip.SampleLocalPose(key.time, pose, cursor);
+            if (AxisError(key.scale, pose.scales[channel.boneIndex]) > settings.scaleTolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void BM_AnimationChannelSampleTransform(MicroBenchmarkState& state) {
+    Animation::AnimationChannel channel = CreateChannel(0, static_cast<int>(state.GetArgument()));
+    float time = 0.0f;
+
+    for (auto _ : state) {
+        DirectX::XMMATRIX transform = channel.SampleTransform(time);
+        DoNotOptimize(transform);
+        time = NextTime(time);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+MICRO_BENCHMARK(BM_AnimationChannelSampleTransform)->Argument(8)->Argument(64)->Argument(512);
+
+// Same keys through the cursor overload, for comparison with the search above
+void BM_AnimationChannelSampleTransformCursor(MicroBenchmarkState& state) {
+    Animation::AnimationChannel channel = CreateChannel(0, static_cast<int>(state.GetArgument()));
+    Animation::KeyframeCursor cursor;
+    float time = 0.0f;
+
+    for (auto _ : state) {
+        DirectX::XMMATRIX transform = channel.SampleTransform(time, cursor);
+        DoNotOptimize(transform);
+        time = NextTime(time);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+MICRO_BENCHMARK(BM_AnimationChannelSampleTransformCursor)->Argument(8)->Argument(64)->Argument(512);
+
+void BM_AnimationClipSampleAnimation(MicroBenchmarkState& state) {
+    int boneCount = static_cast<int>(state.GetArgument());
+    std::shared_ptr<Animation::AnimationClip> clip = CreateClip("Sample", boneCount, 60);
+    std::vector<DirectX::XMMATRIX> bones(static_cast<size_t>(boneCount), DirectX::XMMatrixIdentity());
+    float time = 0.0f;
+
+    for (auto _ : state) {
+        clip->SampleAnimation(time, bones);
+        DoNotOptimize(bones.data());
+        time = NextTime(time);
+    }
+    state.SetItemsProcessed(state.GetIterations() * boneCount);
+}
+MICRO_BENCHMARK(BM_AnimationClipSampleAnimation)->Argument(32)->Argument(128);
+
+// Argument is the key count per track; 60 keys over the two seconds fall
+// between the 30 Hz frames the compressor resamples to, so decoding at the
+// key times checks the error against the source rather than the resampling
+void BM_AnimationClipCompress(MicroBenchmarkState& state) {
+    constexpr int BONE_COUNT = 32;
+    int keyCount = static_cast<int>(state.GetArgument());
+    Animation::AnimationCompressionSettings settings;
+
+    std::shared_ptr<Animation::AnimationClip> checked = CreateClip("Compress", BONE_COUNT, keyCount);
+    std::vector<Animation::AnimationChannel> source = checked->GetChannels();
+    if (!checked->Compress(settings) || !IsWithinTolerance(*checked, source, settings, BONE_COUNT)) {
+        state.SkipWithError("Compressed clip differs from its source keys by more than the tolerance");
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::shared_ptr<Animation::AnimationClip> clip = CreateClip("Compress", BONE_COUNT, keyCount);
+        state.ResumeTiming();
+
+        DoNotOptimize(clip->Compress(settings));
+    }
+    state.SetItemsProcessed(state.GetIterations() * BONE_COUNT);
+}
+MICRO_BENCHMARK(BM_AnimationClipCompress)->Argument(60)->Argument(240);
+
+// Two weighted layers, so every frame blends both poses into the output
+void BM_AnimationControllerBlendAnimations(MicroBenchmarkState& state) {
+    int boneCount = static_cast<int>(state.GetArgument());
+    Animation::AnimationController controller;
+    controller.SetBoneCount(static_cast<size_t>(boneCount));
+    controller.AddAnimationClip("Walk", CreateClip("Walk", boneCount, 60));
+    controller.AddAnimationClip("Wave", CreateClip("Wave", boneCount, 30));
+    controller.Play("Walk");
+    controller.AddLayer("Wave", 0.5f);
+
+    for (auto _ : state) {
+        controller.Evaluate(FRAME_TIME);
+        DoNotOptimize(controller.GetBoneTransforms().data());
+    }
+    state.SetItemsProcessed(state.GetIterations() * boneCount);
+}
+MICRO_BENCHMARK(BM_AnimationControllerBlendAnimations)->Argument(32)->Argument(128);
+
+// A rotation-only clip, raw and compressed, has to keep the bind
+// translations; timing covers the compressed path
+void BM_AnimationClipSampleRotationOnly(MicroBenchmarkState& state) {
+    int boneCount = static_cast<int>(state.GetArgument());
+    Animation::LocalPose bindPose;
+    bindPose.Resize(static_cast<size_t>(boneCount));
+    bindPose.SetIdentity();
+    for (int bone = 0; bone < boneCount; bone++) {
+        bindPose.translations[bone] = DirectX::XMFLOAT3(0.0f, 0.5f, 0.1f * bone);
+    }
+
+    std::shared_ptr<Animation::AnimationClip> clip = CreateRotationClip("Sway", boneCount, 60);
+    Animation::LocalPose pose = bindPose;
+    Animation::AnimationCursor cursor;
+    auto keepsBindTranslations = [&]() {
+        for (float time = 0.0f; time < CLIP_DURATION; time += 0.25f) {
+            clip->SampleLocalPose(time, pose, cursor, Animation::AnimationClip::ALL_CHANNELS, &bindPose);
+            for (int bone = 0; bone < boneCount; bone++) {
+                if (AxisError(bindPose.translations[bone], pose.translations[bone]) > 0.0f) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    if (!keepsBindTranslations()) {
+        state.SkipWithError("Raw rotation-only clip overwrote the bind translations");
+    }
+    else if (!clip->Compress(Animation::AnimationCompressionSettings()) || !keepsBindTranslations()) {
+        state.SkipWithError("Compressed rotation-only clip overwrote the bind translations");
+    }
+
+    float time = 0.0f;
+    for (auto _ : state) {
+        clip->SampleLocalPose(time, pose, cursor, Animation::AnimationClip::ALL_CHANNELS, &bindPose);
+        DoNotOptimize(pose.rotations.data());
+        time = NextTime(time);
+    }
+    state.SetItemsProcessed(state.GetIterations() * boneCount);
+}
+MICRO_BENCHMARK(BM_AnimationClipSampleRotationOnly)->Argument(32)->Argument(128);
+
+// Local pose to skinning matrices in one pass over a branching skeleton
+void BM_SkeletonComputeSkinningMatrices(MicroBenchmarkState& state) {
+    int boneCount = static_cast<int>(state.GetArgument());
+    std::vector<Animation::SkeletonBone> bones(static_cast<size_t>(boneCount));
+    for (int bone = 0; bone < boneCount; bone++) {
+        bones[bone].name = "Bone" + std::to_string(bone);
+        bones[bone].parentIndex = bone > 0 ? (bone - 1) / 2 : -1;
+        bones[bone].translation = DirectX::XMFLOAT3(0.0f, 0.5f, 0.0f);
+    }
+    Animation::Skeleton skeleton;
+    skeleton.Build(bones);
+
+    std::shared_ptr<Animation::AnimationClip> clip = CreateClip("Pose", boneCount, 60);
+    Animation::LocalPose pose = skeleton.GetBindPose();
+    Animation::AnimationCursor cursor;
+    clip->SampleLocalPose(0.5f, pose, cursor, Animation::AnimationClip::ALL_CHANNELS, &skeleton.GetBindPose());
+
+    std::vector<DirectX::XMMATRIX> model(static_cast<size_t>(boneCount));
+    std::vector<DirectX::XMMATRIX> skinning(static_cast<size_t>(boneCount));
+    for (auto _ : state) {
+        skeleton.ComputeSkinningMatrices(pose, model.data(), skinning.data(), skinning.size());
+        DoNotOptimize(skinning.data());
+    }
+    state.SetItemsProcessed(state.GetIterations() * boneCount);
+}
+MICRO_BENCHMARK(BM_SkeletonComputeSkinningMatrices)->Argument(32)->Argument(128);
+
+} // namespace
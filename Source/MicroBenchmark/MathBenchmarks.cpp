@@ -0,0 +1,156 @@
+#include "MicroBenchmark.h"
+#include "../Math/Matrix4.h"
+#include "../Math/SimdBatch.h"
+#include <vector>
+
+using namespace GameEngine;
+using namespace GameEngine::Benchmark;
+
+namespace {
+
+std::vector<Math::Matrix4> CreateMatrices(std::int64_t count) {
+    std::vector<Math::Matrix4> matrices;
+    matrices.reserve(static_cast<size_t>(count));
+    for (std::int64_t i = 0; i < count; i++) {
+        float f = static_cast<float>(i);
+        matrices.push_back(Math::Matrix4::Scale(1.0f + f * 0.001f) *
+                           Math::Matrix4::RotationYawPitchRoll(f * 0.1f, f * 0.05f, f * 0.02f) *
+                           Math::Matrix4::Translation(f, -f, f * 0.5f));
+    }
+    return matrices;
+}
+
+// World * view * projection for a batch, the per-object cost of the old constant path
+void BM_Matrix4Multiply(MicroBenchmarkState& state) {
+    std::vector<Math::Matrix4> worlds = CreateMatrices(state.GetArgument());
+    Math::Matrix4 view = Math::Matrix4::LookAt(Math::Vector3(0.0f, 5.0f, -10.0f), Math::Vector3::Zero(), Math::Vector3::Up());
+    Math::Matrix4 projection = Math::Matrix4::Perspective(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+    for (auto _ : state) {
+        for (const Math::Matrix4& world : worlds) {
+            Math::Matrix4 worldViewProjection = world * view * projection;
+            DoNotOptimize(worldViewProjection);
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArgument());
+}
+MICRO_BENCHMARK(BM_Matrix4Multiply)->Argument(64)->Argument(4096);
+
+void BM_Matrix4Inverse(MicroBenchmarkState& state) {
+    std::vector<Math::Matrix4> matrices = CreateMatrices(state.GetArgument());
+
+    for (auto _ : state) {
+        for (const Math::Matrix4& matrix : matrices) {
+            Math::Matrix4 inverse = matrix.Inverse();
+            DoNotOptimize(inverse);
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArgument());
+}
+MICRO_BENCHMARK(BM_Matrix4Inverse)->Argument(64)->Argument(4096);
+
+void BM_Matrix4Transpose(MicroBenchmarkState& state) {
+    std::vector<Math::Matrix4> matrices = CreateMatrices(state.GetArgument());
+
+    for (auto _ : state) {
+        for (const Math::Matrix4& matrix : matrices) {
+            Math::Matrix4 transposed = matrix.Transpose();
+            DoNotOptimize(transposed);
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArgument());
+}
+MICRO_BENCHMARK(BM_Matrix4Transpose)->Argument(4096);
+
+// Scale * rotation * translation from components, as transforms rebuild their local matrix
+void BM_Matrix4Compose(MicroBenchmarkState& state) {
+    std::int64_t count = state.GetArgument();
+
+    for (auto _ : state) {
+        for (std::int64_t i = 0; i < count; i++) {
+            float f = static_cast<float>(i);
+            Math::Matrix4 matrix = Math::Matrix4::Scale(1.0f) *
+                                   Math::Matrix4::RotationYawPitchRoll(f, f * 0.5f, 0.0f) *
+                                   Math::Matrix4::Translation(f, 0.0f, f);
+            DoNotOptimize(matrix);
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+MICRO_BENCHMARK(BM_Matrix4Compose)->Argument(4096);
+
+void BM_Matrix4TransformPoint(MicroBenchmarkState& state) {
+    Math::Matrix4 matrix = CreateMatrices(2).back();
+    std::vector<Math::Vector3> points(static_cast<size_t>(state.GetArgument()), Math::Vector3(1.0f, 2.0f, 3.0f));
+
+    for (auto _ : state) {
+        for (const Math::Vector3& point : points) {
+            Math::Vector3 transformed = matrix.TransformPoint(point);
+            DoNotOptimize(transformed);
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArgument());
+}
+MICRO_BENCHMARK(BM_Matrix4TransformPoint)->Argument(4096);
+
+// The same SoA batch on each instruction set; compare against BM_Matrix4TransformPoint
+void TransformPointsBatch(MicroBenchmarkState& state, Math::Simd::InstructionSet set) {
+    DirectX::XMFLOAT4X4 matrix = CreateMatrices(2).back().ToXMFLOAT4X4();
+    size_t count = static_cast<size_t>(state.GetArgument());
+    std::vector<float> x(count, 1.0f), y(count, 2.0f), z(count, 3.0f);
+    std::vector<float> outX(count), outY(count), outZ(count);
+
+    Math::Simd::InstructionSet previous = Math::Simd::GetInstructionSet();
+    Math::Simd::SetInstructionSet(set);
+    for (auto _ : state) {
+        Math::Simd::TransformPoints(&matrix._11, { x.data(), y.data(), z.data() },
+                                    { outX.data(), outY.data(), outZ.data() }, count);
+        DoNotOptimize(outX.data());
+    }
+    Math::Simd::SetInstructionSet(previous);
+    state.SetItemsProcessed(state.GetIterations() * state.GetArgument());
+}
+
+void BM_BatchTransformPointsScalar(MicroBenchmarkState& state) {
+    TransformPointsBatch(state, Math::Simd::InstructionSet::Scalar);
+}
+MICRO_BENCHMARK(BM_BatchTransformPointsScalar)->Argument(4096);
+
+void BM_BatchTransformPointsVector4(MicroBenchmarkState& state) {
+    TransformPointsBatch(state, Math::Simd::InstructionSet::Vector4);
+}
+MICRO_BENCHMARK(BM_BatchTransformPointsVector4)->Argument(4096);
+
+// Falls back to the widest supported set on CPUs without AVX2
+void BM_BatchTransformPointsAVX2(MicroBenchmarkState& state) {
+    TransformPointsBatch(state, Math::Simd::InstructionSet::AVX2);
+}
+MICRO_BENCHMARK(BM_BatchTransformPointsAVX2)->Argument(4096);
+
+// Spheres spread through and around the view, as animation LOD tests them
+void BM_BatchSphereFrustum(MicroBenchmarkState& state) {
+    Math::Matrix4 view = Math::Matrix4::LookAt(Math::Vector3(0.0f, 5.0f, -10.0f), Math::Vector3::Zero(), Math::Vector3::Up());
+    Math::Matrix4 projection = Math::Matrix4::Perspective(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+    DirectX::XMFLOAT4X4 viewProjection = (view * projection).ToXMFLOAT4X4();
+    float planes[24];
+    Math::Simd::ExtractFrustumPlanes(&viewProjection._11, planes);
+
+    size_t count = static_cast<size_t>(state.GetArgument());
+    std::vector<float> x(count), y(count), z(count), radii(count, 1.0f);
+    std::vector<std::uint8_t> visible(count);
+    for (size_t i = 0; i < count; i++) {
+        float f = static_cast<float>(i);
+        x[i] = (static_cast<float>(i % 64) - 32.0f) * 4.0f;
+        y[i] = static_cast<float>(i % 7);
+        z[i] = f * 0.1f - 20.0f;
+    }
+
+    for (auto _ : state) {
+        Math::Simd::TestSpheresFrustum(planes, { x.data(), y.data(), z.data() }, radii.data(), visible.data(), count);
+        DoNotOptimize(visible.data());
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArgument());
+}
+MICRO_BENCHMARK(BM_BatchSphereFrustum)->Argument(4096);
+
+} // namespace
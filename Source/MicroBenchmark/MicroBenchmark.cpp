@@ -0,0 +1,231 @@
+#include "MicroBenchmark.h"
+#include "../Core/FileSystem.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace GameEngine {
+namespace Benchmark {
+
+namespace {
+
+constexpr std::int64_t MAX_ITERATIONS = 1000000000;
+
+// Measured iterations first grow by at most this factor between calibration runs
+constexpr double MAX_GROWTH = 100.0;
+
+MicroBenchmarkState RunOnce(const MicroBenchmark& benchmark, std::int64_t iterations, std::int64_t argument) {
+    MicroBenchmarkState state(iterations, argument);
+    benchmark.GetFunction()(state);
+    return state;
+}
+
+double GetNanosecondsPerIteration(const MicroBenchmarkState& state) {
+    return state.GetElapsedSeconds() * 1e9 / static_cast<double>(std::max<std::int64_t>(state.GetIterations(), 1));
+}
+
+std::string GetCaseName(const MicroBenchmark& benchmark, std::int64_t argument, bool hasArgument) {
+    std::string name = benchmark.GetName();
+    if (hasArgument) {
+        name += "/" + std::to_string(argument);
+    }
+    return name;
+}
+
+} // namespace
+
+MicroBenchmarkState::MicroBenchmarkState(std::int64_t iterations, std::int64_t argument)
+    : m_iterations(iterations)
+    , m_argument(argument)
+    , m_itemsProcessed(0)
+    , m_elapsed(Clock::duration::zero())
+    , m_running(false)
+{
+}
+
+bool MicroBenchmarkState::Iterator::operator!=(const Iterator&) const {
+    if (remaining > 0) {
+        return true;
+    }
+    // The loop is done; stop the clock before the benchmark's teardown
+    state->PauseTiming();
+    return false;
+}
+
+MicroBenchmarkState::Iterator MicroBenchmarkState::begin() {
+    ResumeTiming();
+    return Iterator{ this, HasError() ? 0 : m_iterations };
+}
+
+void MicroBenchmarkState::PauseTiming() {
+    if (m_running) {
+        m_elapsed += Clock::now() - m_start;
+        m_running = false;
+    }
+}
+
+void MicroBenchmarkState::ResumeTiming() {
+    if (!m_running) {
+        m_start = Clock::now();
+        m_running = true;
+    }
+}
+
+MicroBenchmark::MicroBenchmark(const char* name, MicroBenchmarkFunction function)
+    : m_name(name)
+    , m_function(function)
+{
+}
+
+std::vector<MicroBenchmark*>& GetMicroBenchmarks() {
+    // Function-local so registration from other translation units is safe
+    static std::vector<MicroBenchmark*> benchmarks;
+    return benchmarks;
+}
+
+MicroBenchmark* RegisterMicroBenchmark(const char* name, MicroBenchmarkFunction function) {
+    // Lives for the whole process, like the static that holds it
+    MicroBenchmark* benchmark = new MicroBenchmark(name, function);
+    GetMicroBenchmarks().push_back(benchmark);
+    return benchmark;
+}
+
+bool MicroBenchmarkOptions::Parse(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", argument.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (argument == "--filter") {
+            filter = value;
+        }
+        else if (argument == "--min-time") {
+            minTime = std::atof(value);
+            if (minTime <= 0.0) {
+                std::fprintf(stderr, "Invalid --min-time %s\n", value);
+                return false;
+            }
+        }
+        else if (argument == "--repetitions") {
+            int count = std::atoi(value);
+            if (count <= 0) {
+                std::fprintf(stderr, "Invalid --repetitions %s\n", value);
+                return false;
+            }
+            repetitions = static_cast<unsigned int>(count);
+        }
+        else if (argument == "--output") {
+            outputPath = value;
+        }
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", argument.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<MicroBenchmarkResult> RunMicroBenchmarks(const MicroBenchmarkOptions& options) {
+    std::vector<MicroBenchmarkResult> results;
+    std::printf("%-48s %14s %14s %14s %16s\n", "Benchmark", "Iterations", "Median ns", "Min ns", "Items/s");
+
+    for (MicroBenchmark* benchmark : GetMicroBenchmarks()) {
+        bool hasArgument = !benchmark->GetArguments().empty();
+        std::vector<std::int64_t> arguments = hasArgument ? benchmark->GetArguments() : std::vector<std::int64_t>{ 0 };
+
+        for (std::int64_t argument : arguments) {
+            std::string name = GetCaseName(*benchmark, argument, hasArgument);
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+
+            MicroBenchmarkResult result;
+            result.name = name;
+
+            // Grow the iteration count until one run lasts minTime
+            std::int64_t iterations = 1;
+            for (;;) {
+                MicroBenchmarkState state = RunOnce(*benchmark, iterations, argument);
+                if (state.HasError()) {
+                    result.error = state.GetError();
+                    break;
+                }
+                double elapsed = state.GetElapsedSeconds();
+                if (elapsed >= options.minTime || iterations >= MAX_ITERATIONS) {
+                    break;
+                }
+                double growth = elapsed > 0.0 ? std::min(options.minTime * 1.4 / elapsed, MAX_GROWTH) : MAX_GROWTH;
+                iterations = std::min(std::max(static_cast<std::int64_t>(iterations * growth), iterations + 1), MAX_ITERATIONS);
+            }
+
+            if (!result.error.empty()) {
+                results.push_back(result);
+                std::printf("%-48s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+                continue;
+            }
+
+            std::vector<double> timings;
+            std::int64_t items = 0;
+            double seconds = 0.0;
+            for (unsigned int repetition = 0; repetition < options.repetitions; repetition++) {
+                MicroBenchmarkState state = RunOnce(*benchmark, iterations, argument);
+                timings.push_back(GetNanosecondsPerIteration(state));
+                items += state.GetItemsProcessed();
+                seconds += state.GetElapsedSeconds();
+            }
+            std::sort(timings.begin(), timings.end());
+
+            result.iterations = iterations;
+            result.nanosecondsPerIteration = timings[timings.size() / 2];
+            result.minNanosecondsPerIteration = timings.front();
+            result.itemsPerSecond = seconds > 0.0 ? static_cast<double>(items) / seconds : 0.0;
+            results.push_back(result);
+
+            std::printf("%-48s %14lld %14.1f %14.1f %16.0f\n", result.name.c_str(), static_cast<long long>(result.iterations),
+                        result.nanosecondsPerIteration, result.minNanosecondsPerIteration, result.itemsPerSecond);
+        }
+    }
+    return results;
+}
+
+bool WriteMicroBenchmarkResults(const std::string& path, const std::vector<MicroBenchmarkResult>& results) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+
+    if (FILE_SYSTEM.GetFileExtension(path) == "csv") {
+        out << "name,iterations,ns_per_iteration,min_ns_per_iteration,items_per_second,error\n";
+        for (const MicroBenchmarkResult& result : results) {
+            out << result.name << "," << result.iterations << "," << result.nanosecondsPerIteration << ","
+                << result.minNanosecondsPerIteration << "," << result.itemsPerSecond << ",\"" << result.error << "\"\n";
+        }
+    }
+    else {
+        out << "{\"benchmarks\":[";
+        for (size_t i = 0; i < results.size(); i++) {
+            const MicroBenchmarkResult& result = results[i];
+            out << (i > 0 ? ",\n" : "\n") << "{\"name\":\"" << result.name << "\",\"iterations\":" << result.iterations
+                << ",\"ns_per_iteration\":" << result.nanosecondsPerIteration
+                << ",\"min_ns_per_iteration\":" << result.minNanosecondsPerIteration
+                << ",\"items_per_second\":" << result.itemsPerSecond;
+            if (!result.error.empty()) {
+                out << ",\"error_message\":\"" << result.error << "\"";
+            }
+            out << "}";
+        }
+        out << "\n]}\n";
+    }
+
+    std::string directory = FILE_SYSTEM.GetDirectoryPath(path);
+    if (!directory.empty()) {
+        FILE_SYSTEM.CreateDirectories(directory);
+    }
+    return FILE_SYSTEM.WriteTextFile(path, out.str());
+}
+
+} // namespace Benchmark
+} // namespace GameEngine
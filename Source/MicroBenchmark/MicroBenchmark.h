@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace GameEngine {
+namespace Benchmark {
+
+// Timing state handed to a micro benchmark. The body runs the measured
+// work inside the range-for loop and the harness picks the iteration
+// count:
+//
+//     void BM_Something(MicroBenchmarkState& state) {
+//         Setup(state.GetArgument());
+//         for (auto _ : state) {
+//             DoNotOptimize(Work());
+//         }
+//         state.SetItemsProcessed(state.GetIterations() * state.GetArgument());
+//     }
+//     MICRO_BENCHMARK(BM_Something)->Argument(64)->Argument(1024);
+class MicroBenchmarkState {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    MicroBenchmarkState(std::int64_t iterations, std::int64_t argument);
+
+    struct Iterator {
+        MicroBenchmarkState* state;
+        std::int64_t remaining;
+
+        bool operator!=(const Iterator&) const;
+        void operator++() { remaining--; }
+        int operator*() const { return 0; }
+    };
+
+    Iterator begin();
+    Iterator end() { return Iterator{ this, 0 }; }
+
+    // Leave per-iteration setup out of the measurement
+    void PauseTiming();
+    void ResumeTiming();
+
+    std::int64_t GetArgument() const { return m_argument; }
+    std::int64_t GetIterations() const { return m_iterations; }
+    void SetItemsProcessed(std::int64_t items) { m_itemsProcessed = items; }
+    std::int64_t GetItemsProcessed() const { return m_itemsProcessed; }
+
+    double GetElapsedSeconds() const { return std::chrono::duration<double>(m_elapsed).count(); }
+
+    // Fail the case from a correctness check: the loop then runs no
+    // iterations, and the harness reports the message instead of timings
+    void SkipWithError(const char* message) { m_error = message; }
+    bool HasError() const { return !m_error.empty(); }
+    const std::string& GetError() const { return m_error; }
+
+private:
+    std::int64_t m_iterations;
+    std::int64_t m_argument;
+    std::int64_t m_itemsProcessed;
+    Clock::time_point m_start;
+    Clock::duration m_elapsed;
+    bool m_running;
+    std::string m_error;
+};
+
+using MicroBenchmarkFunction = void (*)(MicroBenchmarkState&);
+
+// A registered benchmark; each argument runs as its own case
+class MicroBenchmark {
+public:
+    MicroBenchmark(const char* name, MicroBenchmarkFunction function);
+
+    MicroBenchmark* Argument(std::int64_t argument) { m_arguments.push_back(argument); return this; }
+
+    const char* GetName() const { return m_name; }
+    MicroBenchmarkFunction GetFunction() const { return m_function; }
+    const std::vector<std::int64_t>& GetArguments() const { return m_arguments; }
+
+private:
+    const char* m_name;
+    MicroBenchmarkFunction m_function;
+    std::vector<std::int64_t> m_arguments;
+};
+
+struct MicroBenchmarkResult {
+    std::string name;                   // "BM_Name/argument"
+    std::int64_t iterations = 0;
+    double nanosecondsPerIteration = 0.0;   // Median over repetitions
+    double minNanosecondsPerIteration = 0.0;
+    double itemsPerSecond = 0.0;            // 0 when the benchmark reports no items
+    std::string error;                      // From SkipWithError; the timings are 0 then
+};
+
+struct MicroBenchmarkOptions {
+    std::string filter;         // Substring of the case name; empty runs everything
+    double minTime = 0.25;      // Seconds each repetition runs for at least
+    unsigned int repetitions = 5;
+    std::string outputPath;     // .json or .csv by extension; empty prints only
+
+    // --filter text --min-time seconds --repetitions n --output path
+    bool Parse(int argc, char** argv);
+};
+
+std::vector<MicroBenchmark*>& GetMicroBenchmarks();
+MicroBenchmark* RegisterMicroBenchmark(const char* name, MicroBenchmarkFunction function);
+
+std::vector<MicroBenchmarkResult> RunMicroBenchmarks(const MicroBenchmarkOptions& options);
+bool WriteMicroBenchmarkResults(const std::string& path, const std::vector<MicroBenchmarkResult>& results);
+
+// Keep the optimizer from discarding a result the benchmark never uses
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    static const void* volatile sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+#define MICRO_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define MICRO_BENCHMARK_CONCAT(a, b) MICRO_BENCHMARK_CONCAT_INNER(a, b)
+#define MICRO_BENCHMARK(function) \
+    static GameEngine::Benchmark::MicroBenchmark* MICRO_BENCHMARK_CONCAT(s_microBenchmark, __LINE__) = \
+        GameEngine::Benchmark::RegisterMicroBenchmark(#function, function)
+
+} // namespace Benchmark
+} // namespace GameEngine
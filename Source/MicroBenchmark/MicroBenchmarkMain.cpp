@@ -0,0 +1,33 @@
+#include "MicroBenchmark.h"
+#include <cstdio>
+
+using namespace GameEngine;
+
+// DX11GameEngineMicroBenchmark [--filter text] [--min-time seconds]
+//     [--repetitions n] [--output results.json|results.csv]
+// Headless: no window or D3D device is created, so it runs on build agents.
+int main(int argc, char** argv) {
+    Benchmark::MicroBenchmarkOptions options;
+    if (!options.Parse(argc, argv)) {
+        return 1;
+    }
+
+    std::vector<Benchmark::MicroBenchmarkResult> results = Benchmark::RunMicroBenchmarks(options);
+    if (results.empty()) {
+        std::fprintf(stderr, "No benchmark matches '%s'\n", options.filter.c_str());
+        return 1;
+    }
+
+    if (!options.outputPath.empty() && !Benchmark::WriteMicroBenchmarkResults(options.outputPath, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", options.outputPath.c_str());
+        return 1;
+    }
+
+    // Benchmarks that check their results fail the run when a check does
+    for (const Benchmark::MicroBenchmarkResult& result : results) {
+        if (!result.error.empty()) {
+            return 1;
+        }
+    }
+    return 0;
+}
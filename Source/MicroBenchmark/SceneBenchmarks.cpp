@@ -0,0 +1,149 @@
+#include "MicroBenchmark.h"
+#include "../Animation/AnimationController.h"
+#include "../Scene/Entity.h"
+#include "../Scene/MeshRenderer.h"
+#include "../Scene/Scene.h"
+#include "../Scene/Transform.h"
+#include <vector>
+
+using namespace GameEngine;
+using namespace GameEngine::Benchmark;
+
+namespace {
+
+using SceneBase = GameEngine::Scene::Scene;
+
+// Exposes the destroy queue flush the scene runs at the start of Update
+class BenchmarkScene : public SceneBase {
+public:
+    BenchmarkScene() : SceneBase("MicroBenchmark") {}
+    using SceneBase::ProcessPendingDestroy;
+};
+
+// Dirty the root of a chain and read the leaf, which walks the whole chain
+void BM_TransformGetWorldMatrixDeep(MicroBenchmarkState& state) {
+    BenchmarkScene scene;
+    std::int64_t depth = state.GetArgument();
+
+    Scene::Entity* root = scene.CreateEntity("Root");
+    Scene::Entity* leaf = root;
+    for (std::int64_t i = 1; i < depth; i++) {
+        Scene::Entity* child = scene.CreateEntity("Node");
+        child->SetParent(leaf);
+        child->GetTransform()->SetLocalPosition(0.0f, 1.0f, 0.0f);
+        child->GetTransform()->SetLocalRotation(0.0f, 10.0f, 0.0f);
+        leaf = child;
+    }
+
+    float angle = 0.0f;
+    for (auto _ : state) {
+        root->GetTransform()->SetLocalRotation(0.0f, angle, 0.0f);
+        DirectX::XMMATRIX world = leaf->GetTransform()->GetWorldMatrix();
+        DoNotOptimize(world);
+        angle += 1.0f;
+    }
+    state.SetItemsProcessed(state.GetIterations() * depth);
+}
+MICRO_BENCHMARK(BM_TransformGetWorldMatrixDeep)->Argument(8)->Argument(64)->Argument(256);
+
+// Two component types per entity, so the lookup is not trivially the only pool
+void BM_EntityGetComponent(MicroBenchmarkState& state) {
+    BenchmarkScene scene;
+    std::vector<Scene::Entity*> entities;
+    for (std::int64_t i = 0; i < state.GetArgument(); i++) {
+        Scene::Entity* entity = scene.CreateEntity("Entity");
+        entity->AddComponent<Scene::MeshRenderer>();
+        if (i % 2 == 0) {
+            entity->AddComponent<Animation::AnimationController>();
+        }
+        entities.push_back(entity);
+    }
+
+    for (auto _ : state) {
+        for (Scene::Entity* entity : entities) {
+            Scene::MeshRenderer* renderer = entity->GetComponent<Scene::MeshRenderer>();
+            Animation::AnimationController* animator = entity->GetComponent<Animation::AnimationController>();
+            DoNotOptimize(renderer);
+            DoNotOptimize(animator);
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArgument() * 2);
+}
+MICRO_BENCHMARK(BM_EntityGetComponent)->Argument(1024)->Argument(16384);
+
+// Queue every entity of a populated scene and time only the flush
+void BM_SceneProcessPendingDestroy(MicroBenchmarkState& state) {
+    std::int64_t count = state.GetArgument();
+    BenchmarkScene scene;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<Scene::Entity*> entities;
+        for (std::int64_t i = 0; i < count; i++) {
+            Scene::Entity* entity = scene.CreateEntity("Entity");
+            entity->AddComponent<Scene::MeshRenderer>();
+            entities.push_back(entity);
+        }
+        for (Scene::Entity* entity : entities) {
+            scene.DestroyEntity(entity);
+        }
+        state.ResumeTiming();
+
+        scene.ProcessPendingDestroy();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+MICRO_BENCHMARK(BM_SceneProcessPendingDestroy)->Argument(256)->Argument(4096)->Argument(10000);
+
+// Bullet-style churn: spawn a wave, flush its destruction, repeat. After the
+// first wave every entity and transform comes from a recycled pool slot.
+void BM_SceneSpawnDespawnChurn(MicroBenchmarkState& state) {
+    std::int64_t count = state.GetArgument();
+    BenchmarkScene scene;
+    std::vector<Scene::Entity*> entities;
+    entities.reserve(static_cast<size_t>(count));
+
+    for (auto _ : state) {
+        for (std::int64_t i = 0; i < count; i++) {
+            Scene::Entity* entity = scene.CreateEntity("Bullet");
+            entity->AddComponent<Scene::MeshRenderer>();
+            entities.push_back(entity);
+        }
+        for (Scene::Entity* entity : entities) {
+            scene.DestroyEntity(entity);
+        }
+        scene.ProcessPendingDestroy();
+        entities.clear();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+MICRO_BENCHMARK(BM_SceneSpawnDespawnChurn)->Argument(256)->Argument(4096);
+
+// Repeated script-style lookups in a large scene; each query should only
+// touch its few matches
+void BM_SceneFindByNameAndTags(MicroBenchmarkState& state) {
+    constexpr Scene::TagMask ENEMY_TAG = 1u << 0;
+    constexpr Scene::TagMask BOSS_TAG = 1u << 1;
+
+    BenchmarkScene scene;
+    for (std::int64_t i = 0; i < state.GetArgument(); i++) {
+        Scene::Entity* entity = scene.CreateEntity(i % 1000 == 0 ? "Boss" : "Bullet");
+        if (i % 100 == 0) {
+            entity->AddTags(ENEMY_TAG);
+        }
+        if (i % 1000 == 0) {
+            entity->AddTags(BOSS_TAG);
+        }
+    }
+
+    for (auto _ : state) {
+        Scene::Entity* boss = scene.FindEntityByName("Boss");
+        std::vector<Scene::Entity*> bosses = scene.FindEntitiesWithTags(ENEMY_TAG | BOSS_TAG);
+        DoNotOptimize(boss);
+        DoNotOptimize(bosses);
+    }
+    state.SetItemsProcessed(state.GetIterations() * 2);
+}
+MICRO_BENCHMARK(BM_SceneFindByNameAndTags)->Argument(1024)->Argument(65536);
+
+} // namespace
@@ -0,0 +1,38 @@
+#include "MicroBenchmark.h"
+#include "../Core/XmlManager.h"
+#include <sstream>
+#include <string>
+
+using namespace GameEngine;
+using namespace GameEngine::Benchmark;
+
+namespace {
+
+// A scene-like document: one element per entity with attributes and a child
+std::string CreateDocument(std::int64_t entityCount) {
+    std::ostringstream xml;
+    xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Scene name=\"MicroBenchmark\">\n";
+    for (std::int64_t i = 0; i < entityCount; i++) {
+        xml << "  <Entity id=\"" << i << "\" name=\"Entity" << i << "\" active=\"true\">\n"
+            << "    <Transform x=\"" << i * 0.5f << "\" y=\"1.0\" z=\"" << -i * 0.25f << "\" rotationY=\"" << (i % 360) << "\"/>\n"
+            << "    <MeshRenderer mesh=\"Assets/Models/Cube.mesh\" castShadows=\"true\">Material" << (i % 8) << "</MeshRenderer>\n"
+            << "  </Entity>\n";
+    }
+    xml << "</Scene>\n";
+    return xml.str();
+}
+
+void BM_XmlDocumentLoadFromString(MicroBenchmarkState& state) {
+    std::string content = CreateDocument(state.GetArgument());
+
+    for (auto _ : state) {
+        Core::XmlDocument document;
+        bool loaded = document.LoadFromString(content);
+        DoNotOptimize(loaded);
+    }
+    // Items are bytes, so the rate reads as parse throughput
+    state.SetItemsProcessed(state.GetIterations() * static_cast<std::int64_t>(content.size()));
+}
+MICRO_BENCHMARK(BM_XmlDocumentLoadFromString)->Argument(16)->Argument(1024);
+
+} // namespace
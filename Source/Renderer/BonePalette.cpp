@@ -0,0 +1,113 @@
+#include "BonePalette.h"
+#include "GpuMemory.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace GameEngine {
+namespace Renderer {
+
+BonePalette::BonePalette()
+    : m_capacity(0)
+    , m_uploaded(false)
+{
+    m_matrices.reserve(1024);
+}
+
+void BonePalette::Reset() {
+    // Keep capacity so steady-state frames don't reallocate
+    m_matrices.clear();
+    m_uploaded = false;
+}
+
+std::uint32_t BonePalette::Allocate(const DirectX::XMMATRIX* boneTransforms, std::uint32_t boneCount) {
+    if (!boneTransforms || boneCount == 0) {
+        return INVALID_OFFSET;
+    }
+
+    std::uint32_t offset = static_cast<std::uint32_t>(m_matrices.size());
+    m_matrices.resize(offset + boneCount);
+
+    // Transposed like every other matrix the shaders read
+    for (std::uint32_t i = 0; i < boneCount; i++) {
+        DirectX::XMStoreFloat4x4(&m_matrices[offset + i], DirectX::XMMatrixTranspose(boneTransforms[i]));
+    }
+
+    m_uploaded = false;
+    return offset;
+}
+
+bool BonePalette::Upload(ID3D11Device* device, ID3D11DeviceContext* context) {
+    if (m_matrices.empty()) {
+        return false;
+    }
+    if (m_uploaded) {
+        return true;
+    }
+
+    std::uint32_t matrixCount = static_cast<std::uint32_t>(m_matrices.size());
+    if (matrixCount > m_capacity) {
+        std::uint32_t newCapacity = std::max(m_capacity * 2, matrixCount);
+        if (!CreateBuffer(device, newCapacity)) {
+            return false;
+        }
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = context->Map(m_buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to map bone palette");
+        return false;
+    }
+
+    std::memcpy(mappedResource.pData, m_matrices.data(), matrixCount * sizeof(DirectX::XMFLOAT4X4));
+    context->Unmap(m_buffer.Get(), 0);
+
+    m_uploaded = true;
+    return true;
+}
+
+void BonePalette::Bind(ID3D11DeviceContext* context, UINT slot) const {
+    ID3D11ShaderResourceView* view = m_shaderResourceView.Get();
+    context->VSSetShaderResources(slot, 1, &view);
+}
+
+bool BonePalette::CreateBuffer(ID3D11Device* device, std::uint32_t capacity) {
+    m_shaderResourceView.Reset();
+    m_buffer.Reset();
+    m_capacity = 0;
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+    bufferDesc.ByteWidth = capacity * sizeof(DirectX::XMFLOAT4X4);
+    bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    bufferDesc.StructureByteStride = sizeof(DirectX::XMFLOAT4X4);
+
+    HRESULT hr = device->CreateBuffer(&bufferDesc, nullptr, m_buffer.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create bone palette for " << capacity << " matrices");
+        return false;
+    }
+    TrackGpuMemory(m_buffer.Get(), Core::MemoryCategory::Animations);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+    srvDesc.Buffer.FirstElement = 0;
+    srvDesc.Buffer.NumElements = capacity;
+
+    hr = device->CreateShaderResourceView(m_buffer.Get(), &srvDesc, m_shaderResourceView.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create bone palette view");
+        m_buffer.Reset();
+        return false;
+    }
+
+    m_capacity = capacity;
+    return true;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer {
+
+// Every skinned character's bone matrices for one frame, packed back to back
+// into a single dynamic StructuredBuffer<float4x4>. Each draw reads its bones
+// starting at the offset returned by Allocate, so there is no per-draw bone
+// upload and no fixed bone limit.
+//
+// Frame lifecycle: Reset, Allocate once per character, Upload, Bind.
+class BonePalette {
+public:
+    static constexpr std::uint32_t INVALID_OFFSET = 0xFFFFFFFFu;
+
+    BonePalette();
+    ~BonePalette() = default;
+
+    void Reset();
+
+    // Copy (transposed) bone matrices into the frame palette, returns their first index
+    std::uint32_t Allocate(const DirectX::XMMATRIX* boneTransforms, std::uint32_t boneCount);
+
+    // Stream the frame's matrices with one map; grows the GPU buffer as needed
+    bool Upload(ID3D11Device* device, ID3D11DeviceContext* context);
+
+    // Bind the palette SRV to a vertex shader slot
+    void Bind(ID3D11DeviceContext* context, UINT slot = 0) const;
+
+    ID3D11ShaderResourceView* GetShaderResourceView() const { return m_shaderResourceView.Get(); }
+    // CPU copy of the frame's matrices, already transposed
+    const DirectX::XMFLOAT4X4* GetMatrices() const { return m_matrices.data(); }
+    std::uint32_t GetMatrixCount() const { return static_cast<std::uint32_t>(m_matrices.size()); }
+    std::uint32_t GetCapacity() const { return m_capacity; }
+    bool IsEmpty() const { return m_matrices.empty(); }
+
+private:
+    bool CreateBuffer(ID3D11Device* device, std::uint32_t capacity);
+
+    std::vector<DirectX::XMFLOAT4X4> m_matrices;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_buffer;
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_shaderResourceView;
+    std::uint32_t m_capacity;
+    bool m_uploaded;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,337 @@
+#include "ClusteredLighting.h"
+#include "GpuMemory.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+    bool SphereIntersectsBox(const DirectX::XMFLOAT3& center, float radius,
+                             const DirectX::XMFLOAT3& minimum, const DirectX::XMFLOAT3& maximum) {
+        float distanceSq = 0.0f;
+        const float* c = &center.x;
+        const float* lo = &minimum.x;
+        const float* hi = &maximum.x;
+        for (int axis = 0; axis < 3; axis++) {
+            float v = std::clamp(c[axis], lo[axis], hi[axis]) - c[axis];
+            distanceSq += v * v;
+        }
+        return distanceSq <= radius * radius;
+    }
+
+    // Tile covering an NDC coordinate, clamped to the grid
+    std::uint32_t NdcToTile(float ndc, std::uint32_t tileCount) {
+        int tile = static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(tileCount)));
+        return static_cast<std::uint32_t>(std::clamp(tile, 0, static_cast<int>(tileCount) - 1));
+    }
+}
+
+ClusteredLighting::ClusteredLighting()
+    : m_directionalCount(0)
+    , m_nearZ(0.0f)
+    , m_farZ(0.0f)
+    , m_depthSliceScale(0.0f)
+    , m_depthSliceBias(0.0f)
+    , m_tileScale(0.0f, 0.0f)
+{
+    std::memset(&m_boundsProjection, 0, sizeof(m_boundsProjection));
+    m_grid.resize(CLUSTER_COUNT, DirectX::XMUINT2(0, 0));
+    m_sliceIndices.resize(CLUSTERS_Z);
+}
+
+void ClusteredLighting::Build(const std::vector<LightData>& lights, const DirectX::XMMATRIX& view,
+                              const DirectX::XMMATRIX& projection, UINT screenWidth, UINT screenHeight) {
+    m_lights.clear();
+    m_bounds.clear();
+    m_lightIndices.clear();
+    std::fill(m_grid.begin(), m_grid.end(), DirectX::XMUINT2(0, 0));
+
+    // Directional lights apply everywhere and are never clustered
+    for (const LightData& light : lights) {
+        if (light.shadowParams.w > 0.0f && static_cast<LightType>(static_cast<int>(light.position.w)) == LightType::Directional) {
+            m_lights.push_back(light);
+        }
+    }
+    m_directionalCount = static_cast<std::uint32_t>(m_lights.size());
+
+    // Left-handed perspective: _33 = f / (f - n), _43 = -n * f / (f - n)
+    DirectX::XMFLOAT4X4 p;
+    DirectX::XMStoreFloat4x4(&p, projection);
+    float nearZ = (p._33 != 0.0f) ? -p._43 / p._33 : 0.0f;
+    float farZ = (p._33 != 1.0f) ? p._43 / (1.0f - p._33) : 0.0f;
+    if (!(nearZ > 0.0f) || !(farZ > nearZ) || screenWidth == 0 || screenHeight == 0) {
+        return;
+    }
+
+    if (std::memcmp(&p, &m_boundsProjection, sizeof(p)) != 0 || m_clusterBounds.empty()) {
+        UpdateClusterBounds(projection, nearZ, farZ);
+        m_boundsProjection = p;
+    }
+
+    m_tileScale = DirectX::XMFLOAT2(static_cast<float>(CLUSTERS_X) / static_cast<float>(screenWidth),
+                                    static_cast<float>(CLUSTERS_Y) / static_cast<float>(screenHeight));
+
+    // View-space bounding sphere and conservative cluster range per local light
+    for (const LightData& light : lights) {
+        LightType type = static_cast<LightType>(static_cast<int>(light.position.w));
+        if (light.shadowParams.w <= 0.0f || (type != LightType::Point && type != LightType::Spot)) {
+            continue;
+        }
+
+        DirectX::XMVECTOR position = DirectX::XMVectorSet(light.position.x, light.position.y, light.position.z, 1.0f);
+        float range = light.direction.w;
+        float radius = range;
+        DirectX::XMVECTOR center = position;
+
+        if (type == LightType::Spot) {
+            // Conservative sphere around the lit region, a cone of half-angle a
+            // capped at distance range: up to 45 degrees the sphere through the
+            // apex and the rim of a cone whose axis is range long, otherwise
+            // the sphere on the rim circle. Both also contain the cap.
+            DirectX::XMVECTOR axis = DirectX::XMVector3Normalize(
+                DirectX::XMVectorSet(light.direction.x, light.direction.y, light.direction.z, 0.0f));
+            float angle = light.shadowParams.x;
+            if (angle <= DirectX::XM_PIDIV4) {
+                float cosAngle = std::cos(angle);
+                radius = range / (2.0f * cosAngle * cosAngle);
+                center = DirectX::XMVectorMultiplyAdd(axis, DirectX::XMVectorReplicate(radius), position);
+            } else {
+                radius = range * std::sin(angle);
+                center = DirectX::XMVectorMultiplyAdd(axis, DirectX::XMVectorReplicate(range * std::cos(angle)), position);
+            }
+        }
+
+        if (radius <= 0.0f) {
+            continue;
+        }
+
+        LightBounds bounds;
+        DirectX::XMStoreFloat3(&bounds.center, DirectX::XMVector3TransformCoord(center, view));
+        bounds.radius = radius;
+
+        float minDepth = std::max(bounds.center.z - radius, nearZ);
+        float maxDepth = std::min(bounds.center.z + radius, farZ);
+        if (minDepth > maxDepth) {
+            continue;
+        }
+
+        // Project the depth-clipped box around the sphere; extremes lie on its corners
+        float ndcMinX = FLT_MAX, ndcMaxX = -FLT_MAX;
+        float ndcMinY = FLT_MAX, ndcMaxY = -FLT_MAX;
+        float depths[2] = { minDepth, maxDepth };
+        for (float depth : depths) {
+            for (float side = -1.0f; side <= 1.0f; side += 2.0f) {
+                float x = p._11 * (bounds.center.x + side * radius) / depth;
+                float y = p._22 * (bounds.center.y + side * radius) / depth;
+                ndcMinX = std::min(ndcMinX, x);
+                ndcMaxX = std::max(ndcMaxX, x);
+                ndcMinY = std::min(ndcMinY, y);
+                ndcMaxY = std::max(ndcMaxY, y);
+            }
+        }
+
+        if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f) {
+            continue;
+        }
+
+        // Tile rows count down from the top of the screen
+        bounds.minX = NdcToTile(ndcMinX, CLUSTERS_X);
+        bounds.maxX = NdcToTile(ndcMaxX, CLUSTERS_X);
+        bounds.minY = NdcToTile(-ndcMaxY, CLUSTERS_Y);
+        bounds.maxY = NdcToTile(-ndcMinY, CLUSTERS_Y);
+        bounds.minZ = DepthToSlice(minDepth);
+        bounds.maxZ = DepthToSlice(maxDepth);
+
+        bounds.lightIndex = static_cast<std::uint32_t>(m_lights.size());
+        m_lights.push_back(light);
+        m_bounds.push_back(bounds);
+    }
+
+    if (m_bounds.empty()) {
+        return;
+    }
+
+    // Slices are independent; each fills its own index list
+    JOB_SYSTEM.ParallelFor(CLUSTERS_Z, [this](std::uint32_t begin, std::uint32_t end) {
+        for (std::uint32_t slice = begin; slice < end; slice++) {
+            AssignSlice(slice);
+        }
+    }, 1);
+
+    // Concatenate in slice order and rebase the grid offsets
+    for (std::uint32_t slice = 0; slice < CLUSTERS_Z; slice++) {
+        std::uint32_t base = static_cast<std::uint32_t>(m_lightIndices.size());
+        std::uint32_t first = slice * CLUSTERS_X * CLUSTERS_Y;
+        for (std::uint32_t i = 0; i < CLUSTERS_X * CLUSTERS_Y; i++) {
+            m_grid[first + i].x += base;
+        }
+
+        const std::vector<std::uint32_t>& indices = m_sliceIndices[slice];
+        m_lightIndices.insert(m_lightIndices.end(), indices.begin(), indices.end());
+    }
+}
+
+void ClusteredLighting::AssignSlice(std::uint32_t slice) {
+    std::vector<std::uint32_t>& indices = m_sliceIndices[slice];
+    indices.clear();
+
+    for (std::uint32_t y = 0; y < CLUSTERS_Y; y++) {
+        for (std::uint32_t x = 0; x < CLUSTERS_X; x++) {
+            std::uint32_t cluster = (slice * CLUSTERS_Y + y) * CLUSTERS_X + x;
+            const ClusterBounds& clusterBounds = m_clusterBounds[cluster];
+            std::uint32_t offset = static_cast<std::uint32_t>(indices.size());
+
+            for (const LightBounds& bounds : m_bounds) {
+                if (slice < bounds.minZ || slice > bounds.maxZ ||
+                    y < bounds.minY || y > bounds.maxY ||
+                    x < bounds.minX || x > bounds.maxX) {
+                    continue;
+                }
+
+                if (SphereIntersectsBox(bounds.center, bounds.radius, clusterBounds.minimum, clusterBounds.maximum)) {
+                    indices.push_back(bounds.lightIndex);
+                }
+            }
+
+            m_grid[cluster] = DirectX::XMUINT2(offset, static_cast<std::uint32_t>(indices.size()) - offset);
+        }
+    }
+}
+
+void ClusteredLighting::UpdateClusterBounds(const DirectX::XMMATRIX& projection, float nearZ, float farZ) {
+    DirectX::XMFLOAT4X4 p;
+    DirectX::XMStoreFloat4x4(&p, projection);
+
+    m_nearZ = nearZ;
+    m_farZ = farZ;
+
+    float logRatio = std::log(farZ / nearZ);
+    m_depthSliceScale = static_cast<float>(CLUSTERS_Z) / logRatio;
+    m_depthSliceBias = -static_cast<float>(CLUSTERS_Z) * std::log(nearZ) / logRatio;
+
+    m_clusterBounds.resize(CLUSTER_COUNT);
+    for (std::uint32_t slice = 0; slice < CLUSTERS_Z; slice++) {
+        float depth0 = nearZ * std::pow(farZ / nearZ, static_cast<float>(slice) / CLUSTERS_Z);
+        float depth1 = nearZ * std::pow(farZ / nearZ, static_cast<float>(slice + 1) / CLUSTERS_Z);
+
+        for (std::uint32_t y = 0; y < CLUSTERS_Y; y++) {
+            float ndcTop = 1.0f - 2.0f * static_cast<float>(y) / CLUSTERS_Y;
+            float ndcBottom = 1.0f - 2.0f * static_cast<float>(y + 1) / CLUSTERS_Y;
+
+            for (std::uint32_t x = 0; x < CLUSTERS_X; x++) {
+                float ndcLeft = -1.0f + 2.0f * static_cast<float>(x) / CLUSTERS_X;
+                float ndcRight = -1.0f + 2.0f * static_cast<float>(x + 1) / CLUSTERS_X;
+
+                // The tile's corner rays at both slice depths
+                ClusterBounds& bounds = m_clusterBounds[(slice * CLUSTERS_Y + y) * CLUSTERS_X + x];
+                bounds.minimum = DirectX::XMFLOAT3(FLT_MAX, FLT_MAX, depth0);
+                bounds.maximum = DirectX::XMFLOAT3(-FLT_MAX, -FLT_MAX, depth1);
+                for (float depth : { depth0, depth1 }) {
+                    for (float ndcX : { ndcLeft, ndcRight }) {
+                        float viewX = ndcX * depth / p._11;
+                        bounds.minimum.x = std::min(bounds.minimum.x, viewX);
+                        bounds.maximum.x = std::max(bounds.maximum.x, viewX);
+                    }
+                    for (float ndcY : { ndcBottom, ndcTop }) {
+                        float viewY = ndcY * depth / p._22;
+                        bounds.minimum.y = std::min(bounds.minimum.y, viewY);
+                        bounds.maximum.y = std::max(bounds.maximum.y, viewY);
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::uint32_t ClusteredLighting::DepthToSlice(float depth) const {
+    int slice = static_cast<int>(std::floor(std::log(depth) * m_depthSliceScale + m_depthSliceBias));
+    return static_cast<std::uint32_t>(std::clamp(slice, 0, static_cast<int>(CLUSTERS_Z) - 1));
+}
+
+bool ClusteredLighting::Upload(ID3D11Device* device, ID3D11DeviceContext* context) {
+    if (!m_lightBuffer.Update(device, context, m_lights.data(), GetLightCount(), sizeof(LightData))) {
+        LOG_ERROR("Failed to upload clustered light data");
+        return false;
+    }
+    if (!m_gridBuffer.Update(device, context, m_grid.data(), CLUSTER_COUNT, sizeof(DirectX::XMUINT2))) {
+        LOG_ERROR("Failed to upload light cluster grid");
+        return false;
+    }
+    if (!m_indexBuffer.Update(device, context, m_lightIndices.data(), GetLightIndexCount(), sizeof(std::uint32_t))) {
+        LOG_ERROR("Failed to upload light index list");
+        return false;
+    }
+    return true;
+}
+
+void ClusteredLighting::Bind(ID3D11DeviceContext* context) const {
+    static_assert(CLUSTER_GRID_SLOT == LIGHT_DATA_SLOT + 1 && LIGHT_INDEX_SLOT == LIGHT_DATA_SLOT + 2,
+                  "Clustered lighting slots must be consecutive");
+
+    ID3D11ShaderResourceView* views[3] = { m_lightBuffer.view.Get(), m_gridBuffer.view.Get(), m_indexBuffer.view.Get() };
+    context->PSSetShaderResources(LIGHT_DATA_SLOT, 3, views);
+}
+
+void ClusteredLighting::BindCompute(ID3D11DeviceContext* context) const {
+    ID3D11ShaderResourceView* views[3] = { m_lightBuffer.view.Get(), m_gridBuffer.view.Get(), m_indexBuffer.view.Get() };
+    context->CSSetShaderResources(LIGHT_DATA_SLOT, 3, views);
+}
+
+bool ClusteredLighting::GpuBuffer::Update(ID3D11Device* device, ID3D11DeviceContext* context, const void* data,
+                                          std::uint32_t count, std::uint32_t stride) {
+    // Counts in the grid keep the shader from reading a stale buffer
+    if (count == 0) {
+        return true;
+    }
+
+    if (count > capacity) {
+        view.Reset();
+        buffer.Reset();
+        capacity = 0;
+
+        std::uint32_t newCapacity = std::max(count, 64u);
+        newCapacity = std::max(newCapacity, count + count / 2);
+
+        D3D11_BUFFER_DESC bufferDesc = {};
+        bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+        bufferDesc.ByteWidth = newCapacity * stride;
+        bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        bufferDesc.StructureByteStride = stride;
+
+        if (FAILED(device->CreateBuffer(&bufferDesc, nullptr, buffer.GetAddressOf()))) {
+            return false;
+        }
+        TrackGpuMemory(buffer.Get(), Core::MemoryCategory::Renderer);
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.FirstElement = 0;
+        srvDesc.Buffer.NumElements = newCapacity;
+
+        if (FAILED(device->CreateShaderResourceView(buffer.Get(), &srvDesc, view.GetAddressOf()))) {
+            buffer.Reset();
+            return false;
+        }
+
+        capacity = newCapacity;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if (FAILED(context->Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+        return false;
+    }
+    std::memcpy(mappedResource.pData, data, static_cast<size_t>(count) * stride);
+    context->Unmap(buffer.Get(), 0);
+    return true;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
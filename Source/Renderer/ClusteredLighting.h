@@ -0,0 +1,118 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <vector>
+#include "Light.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+// Per-frame light lists for clustered forward shading.
+//
+// The view frustum is split into CLUSTERS_X x CLUSTERS_Y screen tiles and
+// CLUSTERS_Z exponential depth slices. Each frame the visible point and spot
+// lights are assigned to every cluster their bounding sphere touches, one
+// job per depth slice. The pixel shader finds its cluster from screen
+// position and view depth and only shades the lights listed there.
+//
+// GPU layout, all StructuredBuffers bound to the pixel shader:
+//   LIGHT_DATA_SLOT:    LightData[], directional lights first
+//   CLUSTER_GRID_SLOT:  uint2[] (offset, count) into the index list per cluster
+//   LIGHT_INDEX_SLOT:   uint[] light indices, grouped by cluster
+class ClusteredLighting {
+public:
+    static constexpr std::uint32_t CLUSTERS_X = 16;
+    static constexpr std::uint32_t CLUSTERS_Y = 9;
+    static constexpr std::uint32_t CLUSTERS_Z = 24;
+    static constexpr std::uint32_t CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+    static constexpr UINT LIGHT_DATA_SLOT = 4;
+    static constexpr UINT CLUSTER_GRID_SLOT = 5;
+    static constexpr UINT LIGHT_INDEX_SLOT = 6;
+
+    ClusteredLighting();
+    ~ClusteredLighting() = default;
+
+    // Assign lights to clusters for this view. view and projection are the
+    // row-vector camera matrices; the projection must be a perspective one.
+    void Build(const std::vector<LightData>& lights, const DirectX::XMMATRIX& view,
+               const DirectX::XMMATRIX& projection, UINT screenWidth, UINT screenHeight);
+
+    // Stream the frame's lists with one map per buffer; grows buffers as needed
+    bool Upload(ID3D11Device* device, ID3D11DeviceContext* context);
+
+    // Bind the three light buffers to the pixel shader
+    void Bind(ID3D11DeviceContext* context) const;
+    // Same slots on the compute shader, for deferred lighting
+    void BindCompute(ID3D11DeviceContext* context) const;
+
+    // Slice i covers view depth [near * (far / near)^(i / Z), ...);
+    // the shader computes slice = log(z) * scale + bias
+    float GetDepthSliceScale() const { return m_depthSliceScale; }
+    float GetDepthSliceBias() const { return m_depthSliceBias; }
+    const DirectX::XMFLOAT2& GetTileScale() const { return m_tileScale; }
+
+    std::uint32_t GetDirectionalLightCount() const { return m_directionalCount; }
+    std::uint32_t GetLightCount() const { return static_cast<std::uint32_t>(m_lights.size()); }
+    std::uint32_t GetLightIndexCount() const { return static_cast<std::uint32_t>(m_lightIndices.size()); }
+
+private:
+    // View-space bounds of one local light, plus the clusters it may touch
+    struct LightBounds {
+        DirectX::XMFLOAT3 center;
+        float radius;
+        std::uint32_t lightIndex;
+        std::uint32_t minX, maxX;
+        std::uint32_t minY, maxY;
+        std::uint32_t minZ, maxZ;
+    };
+
+    struct ClusterBounds {
+        DirectX::XMFLOAT3 minimum;
+        DirectX::XMFLOAT3 maximum;
+    };
+
+    // One dynamic StructuredBuffer and its view
+    struct GpuBuffer {
+        Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> view;
+        std::uint32_t capacity = 0;
+
+        bool Update(ID3D11Device* device, ID3D11DeviceContext* context, const void* data,
+                    std::uint32_t count, std::uint32_t stride);
+    };
+
+    void UpdateClusterBounds(const DirectX::XMMATRIX& projection, float nearZ, float farZ);
+    void AssignSlice(std::uint32_t slice);
+    std::uint32_t DepthToSlice(float depth) const;
+
+    // CPU side of the GPU lists
+    std::vector<LightData> m_lights;
+    std::vector<DirectX::XMUINT2> m_grid;
+    std::vector<std::uint32_t> m_lightIndices;
+    std::uint32_t m_directionalCount;
+
+    // Per-frame assignment scratch, kept to avoid reallocating
+    std::vector<LightBounds> m_bounds;
+    std::vector<std::vector<std::uint32_t>> m_sliceIndices;
+
+    // Cluster AABBs, rebuilt only when the projection changes
+    std::vector<ClusterBounds> m_clusterBounds;
+    DirectX::XMFLOAT4X4 m_boundsProjection;
+
+    float m_nearZ;
+    float m_farZ;
+    float m_depthSliceScale;
+    float m_depthSliceBias;
+    DirectX::XMFLOAT2 m_tileScale;
+
+    GpuBuffer m_lightBuffer;
+    GpuBuffer m_gridBuffer;
+    GpuBuffer m_indexBuffer;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,96 @@
+#include "ComputeSkinning.h"
+#include "D3D11Renderer.h"
+#include "../Mesh/Mesh.h"
+#include "../Core/Logger.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+bool SkinnedVertexOutput::Resize(D3D11Renderer* renderer, UINT count) {
+    if (buffer && count <= vertexCount) {
+        return true;
+    }
+
+    view.Reset();
+    vertexCount = 0;
+
+    UINT size = count * sizeof(Mesh::Vertex);
+    buffer = renderer->CreateRawBuffer(nullptr, size, D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_UNORDERED_ACCESS);
+    if (!buffer) {
+        return false;
+    }
+
+    view = renderer->CreateRawUnorderedAccessView(buffer.Get(), size);
+    if (!view) {
+        buffer.Reset();
+        return false;
+    }
+
+    vertexCount = count;
+    return true;
+}
+
+bool ComputeSkinner::Begin(D3D11Renderer* renderer, ID3D11ShaderResourceView* bonePalette) {
+    if (!m_shader || !bonePalette) {
+        return false;
+    }
+
+    if (!m_paramsBuffer) {
+        m_paramsBuffer = renderer->CreateConstantBuffer(sizeof(SkinningParams));
+        if (!m_paramsBuffer) {
+            LOG_ERROR("Failed to create skinning parameter buffer");
+            return false;
+        }
+    }
+
+    ID3D11DeviceContext* context = renderer->GetContext();
+    context->CSSetShader(m_shader.Get(), nullptr, 0);
+    context->CSSetConstantBuffers(0, 1, m_paramsBuffer.GetAddressOf());
+    context->CSSetShaderResources(1, 1, &bonePalette);
+    return true;
+}
+
+bool ComputeSkinner::Dispatch(D3D11Renderer* renderer, const Mesh::Mesh& mesh, std::uint32_t boneOffset,
+                              SkinnedVertexOutput& output) {
+    ID3D11ShaderResourceView* source = mesh.GetSkinningSourceView();
+    UINT vertexCount = mesh.GetVertexCount();
+    if (!source || vertexCount == 0) {
+        return false;
+    }
+
+    if (!output.Resize(renderer, vertexCount)) {
+        LOG_ERROR("Failed to create skinned vertex output for '" << mesh.GetName() << "'");
+        return false;
+    }
+
+    ID3D11DeviceContext* context = renderer->GetContext();
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if (FAILED(context->Map(m_paramsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+        return false;
+    }
+    SkinningParams* params = static_cast<SkinningParams*>(mappedResource.pData);
+    params->vertexCount = vertexCount;
+    params->boneOffset = boneOffset;
+    params->padding[0] = 0;
+    params->padding[1] = 0;
+    context->Unmap(m_paramsBuffer.Get(), 0);
+
+    context->CSSetShaderResources(0, 1, &source);
+    context->CSSetUnorderedAccessViews(0, 1, output.view.GetAddressOf(), nullptr);
+    context->Dispatch((vertexCount + THREAD_GROUP_SIZE - 1) / THREAD_GROUP_SIZE, 1, 1);
+    return true;
+}
+
+void ComputeSkinner::End(D3D11Renderer* renderer) {
+    ID3D11DeviceContext* context = renderer->GetContext();
+
+    ID3D11ShaderResourceView* nullViews[2] = { nullptr, nullptr };
+    ID3D11UnorderedAccessView* nullUAV = nullptr;
+    context->CSSetShaderResources(0, 2, nullViews);
+    context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+}
+
+} // namespace Renderer
+} // namespace GameEngine
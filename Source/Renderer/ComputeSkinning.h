@@ -0,0 +1,65 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <cstdint>
+
+namespace GameEngine {
+
+// Forward declarations
+namespace Mesh {
+    class Mesh;
+}
+
+namespace Renderer {
+
+class D3D11Renderer;
+
+using Microsoft::WRL::ComPtr;
+
+// Skinned vertices for one mesh instance, written by the skinning compute
+// shader and drawn as a static Vertex stream by every pass that frame
+struct SkinnedVertexOutput {
+    ComPtr<ID3D11Buffer> buffer;
+    ComPtr<ID3D11UnorderedAccessView> view;
+    UINT vertexCount = 0;
+
+    // No-op when the buffer already fits
+    bool Resize(D3D11Renderer* renderer, UINT count);
+};
+
+// Runs SkinningComputeShader: one thread per vertex, reading the mesh's raw
+// SkinnedVertex buffer and the frame's bone palette
+class ComputeSkinner {
+public:
+    ComputeSkinner() = default;
+    ~ComputeSkinner() = default;
+
+    void SetShader(ComPtr<ID3D11ComputeShader> shader) { m_shader = shader; }
+    bool IsAvailable() const { return m_shader != nullptr; }
+
+    // Bind the shader and palette shared by every dispatch this frame
+    bool Begin(D3D11Renderer* renderer, ID3D11ShaderResourceView* bonePalette);
+
+    // Skin one mesh instance; output is resized to the mesh as needed
+    bool Dispatch(D3D11Renderer* renderer, const Mesh::Mesh& mesh, std::uint32_t boneOffset,
+                  SkinnedVertexOutput& output);
+
+    // Unbind the UAV so the outputs can be used as vertex buffers
+    void End(D3D11Renderer* renderer);
+
+private:
+    static constexpr UINT THREAD_GROUP_SIZE = 64;
+
+    struct SkinningParams {
+        std::uint32_t vertexCount;
+        std::uint32_t boneOffset;
+        std::uint32_t padding[2];
+    };
+
+    ComPtr<ID3D11ComputeShader> m_shader;
+    ComPtr<ID3D11Buffer> m_paramsBuffer;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
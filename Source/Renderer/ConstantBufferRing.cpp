@@ -0,0 +1,206 @@
+#include "ConstantBufferRing.h"
+#include "GpuMemory.h"
+#include "../Core/Logger.h"
+#include <cstring>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+UINT AlignConstants(UINT size) {
+    return (size + ConstantBufferRing::ALIGNMENT - 1) & ~(ConstantBufferRing::ALIGNMENT - 1);
+}
+
+} // namespace
+
+ConstantBufferRing::ConstantBufferRing()
+    : m_context(nullptr)
+    , m_size(0)
+    , m_offset(0)
+    , m_discardPending(true)
+    , m_mappedData(nullptr)
+    , m_generation(0)
+{
+}
+
+bool ConstantBufferRing::Initialize(ID3D11Device* device, ID3D11DeviceContext* context, UINT size) {
+    Shutdown();
+    if (!device || !context) {
+        return false;
+    }
+
+    // Offsets need the D3D11.1 runtime and driver support
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    if (FAILED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) ||
+        !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer) {
+        LOG_INFO("Constant buffer offsetting not supported, using per-draw constant buffers");
+        return false;
+    }
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+    bufferDesc.ByteWidth = AlignConstants(size);
+    bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+    HRESULT hr = device->CreateBuffer(&bufferDesc, nullptr, &m_buffer);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create " << bufferDesc.ByteWidth << " byte constant ring");
+        return false;
+    }
+    TrackGpuMemory(m_buffer.Get(), Core::MemoryCategory::Renderer);
+
+    m_context = context;
+    m_size = bufferDesc.ByteWidth;
+    m_offset = 0;
+    m_discardPending = true;
+    return true;
+}
+
+void ConstantBufferRing::Shutdown() {
+    Unmap();
+    m_buffer.Reset();
+    m_context = nullptr;
+    m_size = 0;
+    m_offset = 0;
+}
+
+void ConstantBufferRing::BeginFrame() {
+    Unmap();
+    m_offset = 0;
+    m_discardPending = true;
+    m_stats = ConstantRingStats();
+}
+
+bool ConstantBufferRing::Map() {
+    if (!m_buffer) {
+        return false;
+    }
+    if (m_mappedData) {
+        return true;
+    }
+
+    return MapBuffer(m_discardPending ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE);
+}
+
+void ConstantBufferRing::Unmap() {
+    if (m_mappedData) {
+        m_context->Unmap(m_buffer.Get(), 0);
+        m_mappedData = nullptr;
+    }
+}
+
+ConstantAllocation ConstantBufferRing::Allocate(UINT size) {
+    ConstantAllocation allocation;
+    UINT alignedSize = AlignConstants(size);
+    if (!m_mappedData || alignedSize == 0 || alignedSize > m_size) {
+        return allocation;
+    }
+
+    // Out of space: start over in a fresh copy of the buffer
+    if (m_offset + alignedSize > m_size) {
+        Unmap();
+        m_offset = 0;
+        if (!MapBuffer(D3D11_MAP_WRITE_DISCARD)) {
+            return allocation;
+        }
+    }
+
+    allocation.buffer = m_buffer.Get();
+    allocation.firstConstant = m_offset / 16;
+    allocation.constantCount = alignedSize / 16;
+    allocation.data = m_mappedData + m_offset;
+
+    m_offset += alignedSize;
+    m_stats.allocations++;
+    m_stats.bytesAllocated += alignedSize;
+    return allocation;
+}
+
+ConstantBinding ConstantBufferRing::Upload(const void* data, UINT size) {
+    bool wasMapped = IsMapped();
+    if (!Map()) {
+        return ConstantBinding();
+    }
+
+    ConstantAllocation allocation = Allocate(size);
+    if (allocation.data) {
+        std::memcpy(allocation.data, data, size);
+    }
+
+    if (!wasMapped) {
+        Unmap();
+    }
+    return allocation;
+}
+
+bool ConstantBufferRing::MapBuffer(D3D11_MAP mapType) {
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = m_context->Map(m_buffer.Get(), 0, mapType, 0, &mappedResource);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to map constant ring");
+        return false;
+    }
+
+    m_mappedData = static_cast<std::uint8_t*>(mappedResource.pData);
+    m_stats.maps++;
+    if (mapType == D3D11_MAP_WRITE_DISCARD) {
+        m_discardPending = false;
+        m_generation++;
+        m_stats.discards++;
+    }
+    return true;
+}
+
+bool StaticConstantBuffer::Build(ID3D11Device* device, const std::vector<DirectX::XMFLOAT4X4>& worldMatrices) {
+    Clear();
+    if (!device || worldMatrices.empty()) {
+        return false;
+    }
+
+    // Each record holds the transposed world matrix like a per-draw upload
+    const UINT recordSize = ConstantBufferRing::ALIGNMENT;
+    std::vector<std::uint8_t> records(worldMatrices.size() * recordSize, 0);
+    for (size_t i = 0; i < worldMatrices.size(); i++) {
+        DirectX::XMFLOAT4X4 transposed;
+        DirectX::XMStoreFloat4x4(&transposed, DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&worldMatrices[i])));
+        std::memcpy(&records[i * recordSize], &transposed, sizeof(transposed));
+    }
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    bufferDesc.ByteWidth = static_cast<UINT>(records.size());
+    bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem = records.data();
+
+    HRESULT hr = device->CreateBuffer(&bufferDesc, &initData, &m_buffer);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create static constants for " << worldMatrices.size() << " objects");
+        return false;
+    }
+    TrackGpuMemory(m_buffer.Get(), Core::MemoryCategory::Renderer);
+
+    m_objectCount = static_cast<UINT>(worldMatrices.size());
+    return true;
+}
+
+void StaticConstantBuffer::Clear() {
+    m_buffer.Reset();
+    m_objectCount = 0;
+}
+
+ConstantBinding StaticConstantBuffer::GetBinding(UINT index) const {
+    ConstantBinding binding;
+    if (index < m_objectCount) {
+        binding.buffer = m_buffer.Get();
+        binding.firstConstant = index * (ConstantBufferRing::ALIGNMENT / 16);
+        binding.constantCount = ConstantBufferRing::ALIGNMENT / 16;
+    }
+    return binding;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <d3d11_1.h>
+#include <DirectXMath.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer {
+
+using Microsoft::WRL::ComPtr;
+
+// Window of a constant buffer bound with VSSetConstantBuffers1, in
+// 16-byte constants
+struct ConstantBinding {
+    ID3D11Buffer* buffer = nullptr;
+    UINT firstConstant = 0;
+    UINT constantCount = 0;
+
+    bool IsValid() const { return buffer != nullptr; }
+
+    // Bind on a D3D11.1 context
+    void BindVS(ID3D11DeviceContext1* context, UINT slot) const {
+        context->VSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &constantCount);
+    }
+    void BindPS(ID3D11DeviceContext1* context, UINT slot) const {
+        context->PSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &constantCount);
+    }
+};
+
+// Ring allocation, writable until the ring is unmapped
+struct ConstantAllocation : ConstantBinding {
+    void* data = nullptr;
+};
+
+struct ConstantRingStats {
+    UINT allocations = 0;
+    UINT maps = 0;
+    UINT discards = 0;          // Frame starts plus wraps
+    std::uint64_t bytesAllocated = 0;
+};
+
+// Per-frame linear upload heap for constants.
+//
+// One large dynamic constant buffer is sub-allocated front to back and bound
+// with offsets (D3D11.1 constant buffer offsetting), replacing one
+// Map(WRITE_DISCARD) of a dedicated buffer per draw. The first map of a
+// frame discards the buffer, later maps use WRITE_NO_OVERWRITE. When the
+// ring fills up it is discarded and restarted; draws already issued keep
+// the old contents, but command lists not yet recorded would not, so work
+// recorded on deferred contexts is uploaded before recording.
+class ConstantBufferRing {
+public:
+    // Offsets must be multiples of 16 constants
+    static constexpr UINT ALIGNMENT = 256;
+    static constexpr UINT DEFAULT_SIZE = 4 * 1024 * 1024;
+
+    ConstantBufferRing();
+    ~ConstantBufferRing() = default;
+
+    // False when the device cannot bind constant buffers with offsets
+    bool Initialize(ID3D11Device* device, ID3D11DeviceContext* context, UINT size = DEFAULT_SIZE);
+    void Shutdown();
+    bool IsAvailable() const { return m_buffer != nullptr; }
+    UINT GetSize() const { return m_size; }
+
+    // Next map discards; call once per frame
+    void BeginFrame();
+
+    // Several allocations can share one map; write each one before the next
+    // Allocate, which may wrap and remap the ring
+    bool Map();
+    void Unmap();
+    bool IsMapped() const { return m_mappedData != nullptr; }
+    ConstantAllocation Allocate(UINT size);
+
+    // Map, copy and unmap in one call
+    ConstantBinding Upload(const void* data, UINT size);
+
+    // Changes whenever the buffer is discarded, which invalidates every
+    // earlier allocation for draws issued afterwards
+    std::uint64_t GetGeneration() const { return m_generation; }
+
+    const ConstantRingStats& GetStats() const { return m_stats; }
+
+private:
+    bool MapBuffer(D3D11_MAP mapType);
+
+    ComPtr<ID3D11Buffer> m_buffer;
+    ID3D11DeviceContext* m_context;
+    UINT m_size;
+    UINT m_offset;
+    bool m_discardPending;
+    std::uint8_t* m_mappedData;
+    std::uint64_t m_generation;
+    ConstantRingStats m_stats;
+};
+
+// Constants for objects that never move, uploaded once into a default-usage
+// buffer and bound with offsets each frame without any map
+class StaticConstantBuffer {
+public:
+    // One 256-byte record per world matrix
+    bool Build(ID3D11Device* device, const std::vector<DirectX::XMFLOAT4X4>& worldMatrices);
+    void Clear();
+
+    UINT GetObjectCount() const { return m_objectCount; }
+    ConstantBinding GetBinding(UINT index) const;
+
+private:
+    ComPtr<ID3D11Buffer> m_buffer;
+    UINT m_objectCount = 0;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,343 @@
+#include "ContextStateCache.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+    // Get* calls add a reference; the cache only tracks identity
+    template<typename T>
+    T* ReleaseAndKeep(T* object) {
+        if (object) {
+            object->Release();
+        }
+        return object;
+    }
+
+    // Blend factor and sample mask are never changed by the engine
+    const float BLEND_FACTOR[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    constexpr UINT SAMPLE_MASK = 0xffffffff;
+}
+
+ContextStateCache::ContextStateCache()
+    : m_context(nullptr)
+    , m_context1(nullptr)
+    , m_topology(D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED)
+    , m_indexBuffer(nullptr)
+    , m_indexFormat(DXGI_FORMAT_UNKNOWN)
+    , m_vertexShader(nullptr)
+    , m_inputLayout(nullptr)
+    , m_pixelShader(nullptr)
+    , m_rasterizerState(nullptr)
+    , m_depthStencilState(nullptr)
+    , m_stencilRef(0)
+    , m_blendState(nullptr)
+    , m_redundantBinds(0)
+    , m_stateChanges(0)
+    , m_shaderBinds(0)
+{
+    for (UINT i = 0; i < MAX_VERTEX_SLOTS; i++) {
+        m_vertexBuffers[i] = nullptr;
+        m_vertexStrides[i] = 0;
+    }
+    for (UINT i = 0; i < MAX_CONSTANT_SLOTS; i++) {
+        m_vsConstants[i] = ConstantSlot{ nullptr, 0, 0 };
+        m_psConstants[i] = ConstantSlot{ nullptr, 0, 0 };
+    }
+    for (UINT i = 0; i < MAX_SHADER_RESOURCE_SLOTS; i++) {
+        m_shaderResources[i] = nullptr;
+    }
+    for (UINT i = 0; i < MAX_SAMPLER_SLOTS; i++) {
+        m_samplers[i] = nullptr;
+    }
+}
+
+void ContextStateCache::Reset(ID3D11DeviceContext* context) {
+    m_context = context;
+    m_context1 = nullptr;
+    if (!m_context) {
+        return;
+    }
+
+    if (SUCCEEDED(m_context->QueryInterface(IID_PPV_ARGS(&m_context1)))) {
+        ReleaseAndKeep(m_context1);
+    }
+
+    m_context->IAGetPrimitiveTopology(&m_topology);
+
+    UINT offsets[MAX_VERTEX_SLOTS];
+    m_context->IAGetVertexBuffers(0, MAX_VERTEX_SLOTS, m_vertexBuffers, m_vertexStrides, offsets);
+    for (UINT i = 0; i < MAX_VERTEX_SLOTS; i++) {
+        ReleaseAndKeep(m_vertexBuffers[i]);
+    }
+
+    UINT indexOffset = 0;
+    m_context->IAGetIndexBuffer(&m_indexBuffer, &m_indexFormat, &indexOffset);
+    ReleaseAndKeep(m_indexBuffer);
+
+    m_context->VSGetShader(&m_vertexShader, nullptr, nullptr);
+    ReleaseAndKeep(m_vertexShader);
+    m_context->IAGetInputLayout(&m_inputLayout);
+    ReleaseAndKeep(m_inputLayout);
+    m_context->PSGetShader(&m_pixelShader, nullptr, nullptr);
+    ReleaseAndKeep(m_pixelShader);
+
+    // Windows are only visible through the D3D11.1 getters
+    for (UINT i = 0; i < MAX_CONSTANT_SLOTS; i++) {
+        ConstantSlot& vs = m_vsConstants[i];
+        ConstantSlot& ps = m_psConstants[i];
+        vs = ConstantSlot{ nullptr, 0, 0 };
+        ps = ConstantSlot{ nullptr, 0, 0 };
+        if (m_context1) {
+            m_context1->VSGetConstantBuffers1(i, 1, &vs.buffer, &vs.firstConstant, &vs.constantCount);
+            m_context1->PSGetConstantBuffers1(i, 1, &ps.buffer, &ps.firstConstant, &ps.constantCount);
+        }
+        else {
+            m_context->VSGetConstantBuffers(i, 1, &vs.buffer);
+            m_context->PSGetConstantBuffers(i, 1, &ps.buffer);
+        }
+        ReleaseAndKeep(vs.buffer);
+        ReleaseAndKeep(ps.buffer);
+    }
+
+    m_context->PSGetShaderResources(0, MAX_SHADER_RESOURCE_SLOTS, m_shaderResources);
+    for (UINT i = 0; i < MAX_SHADER_RESOURCE_SLOTS; i++) {
+        ReleaseAndKeep(m_shaderResources[i]);
+    }
+    m_context->PSGetSamplers(0, MAX_SAMPLER_SLOTS, m_samplers);
+    for (UINT i = 0; i < MAX_SAMPLER_SLOTS; i++) {
+        ReleaseAndKeep(m_samplers[i]);
+    }
+
+    m_context->RSGetState(&m_rasterizerState);
+    ReleaseAndKeep(m_rasterizerState);
+    m_context->OMGetDepthStencilState(&m_depthStencilState, &m_stencilRef);
+    ReleaseAndKeep(m_depthStencilState);
+    float blendFactor[4];
+    UINT sampleMask = 0;
+    m_context->OMGetBlendState(&m_blendState, blendFactor, &sampleMask);
+    ReleaseAndKeep(m_blendState);
+}
+
+void ContextStateCache::SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {
+    if (topology != m_topology) {
+        m_context->IASetPrimitiveTopology(topology);
+        m_stateChanges++;
+        m_topology = topology;
+    }
+    else {
+        m_redundantBinds++;
+    }
+}
+
+void ContextStateCache::SetVertexBuffer(ID3D11Buffer* buffer, UINT stride, UINT slot) {
+    if (slot < MAX_VERTEX_SLOTS && buffer == m_vertexBuffers[slot] && stride == m_vertexStrides[slot]) {
+        m_redundantBinds++;
+        return;
+    }
+
+    UINT offset = 0;
+    m_context->IASetVertexBuffers(slot, 1, &buffer, &stride, &offset);
+    m_stateChanges++;
+
+    if (slot < MAX_VERTEX_SLOTS) {
+        m_vertexBuffers[slot] = buffer;
+        m_vertexStrides[slot] = stride;
+    }
+}
+
+void ContextStateCache::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format) {
+    if (buffer != m_indexBuffer || format != m_indexFormat) {
+        m_context->IASetIndexBuffer(buffer, format, 0);
+        m_stateChanges++;
+        m_indexBuffer = buffer;
+        m_indexFormat = format;
+    }
+    else {
+        m_redundantBinds++;
+    }
+}
+
+void ContextStateCache::SetVertexShader(ID3D11VertexShader* shader, ID3D11InputLayout* layout) {
+    if (shader != m_vertexShader) {
+        m_context->VSSetShader(shader, nullptr, 0);
+        m_stateChanges++;
+        m_shaderBinds++;
+        m_vertexShader = shader;
+    }
+    else {
+        m_redundantBinds++;
+    }
+
+    if (layout != m_inputLayout) {
+        m_context->IASetInputLayout(layout);
+        m_stateChanges++;
+        m_inputLayout = layout;
+    }
+    else {
+        m_redundantBinds++;
+    }
+}
+
+void ContextStateCache::SetPixelShader(ID3D11PixelShader* shader) {
+    if (shader != m_pixelShader) {
+        m_context->PSSetShader(shader, nullptr, 0);
+        m_stateChanges++;
+        m_shaderBinds++;
+        m_pixelShader = shader;
+    }
+    else {
+        m_redundantBinds++;
+    }
+}
+
+void ContextStateCache::SetConstantBuffer(UINT slot, ID3D11Buffer* buffer, bool vertex, bool pixel) {
+    ConstantBinding binding;
+    binding.buffer = buffer;
+    BindConstants(slot, binding, vertex, pixel, false);
+}
+
+void ContextStateCache::SetConstantBuffer(UINT slot, const ConstantBinding& binding, bool vertex, bool pixel) {
+    // Without the D3D11.1 interface there is no way to bind a window
+    if (!m_context1) {
+        return;
+    }
+    BindConstants(slot, binding, vertex, pixel, true);
+}
+
+void ContextStateCache::BindConstants(UINT slot, const ConstantBinding& binding, bool vertex, bool pixel, bool offset) {
+    bool tracked = slot < MAX_CONSTANT_SLOTS;
+
+    if (vertex) {
+        if (tracked && m_vsConstants[slot].Matches(binding)) {
+            m_redundantBinds++;
+        }
+        else {
+            if (offset) {
+                binding.BindVS(m_context1, slot);
+            }
+            else {
+                m_context->VSSetConstantBuffers(slot, 1, &binding.buffer);
+            }
+            m_stateChanges++;
+            if (tracked) {
+                m_vsConstants[slot] = ConstantSlot{ binding.buffer, binding.firstConstant, binding.constantCount };
+            }
+        }
+    }
+
+    if (pixel) {
+        if (tracked && m_psConstants[slot].Matches(binding)) {
+            m_redundantBinds++;
+        }
+        else {
+            if (offset) {
+                binding.BindPS(m_context1, slot);
+            }
+            else {
+                m_context->PSSetConstantBuffers(slot, 1, &binding.buffer);
+            }
+            m_stateChanges++;
+            if (tracked) {
+                m_psConstants[slot] = ConstantSlot{ binding.buffer, binding.firstConstant, binding.constantCount };
+            }
+        }
+    }
+}
+
+void ContextStateCache::SetShaderResource(UINT slot, ID3D11ShaderResourceView* view) {
+    if (slot < MAX_SHADER_RESOURCE_SLOTS && view == m_shaderResources[slot]) {
+        m_redundantBinds++;
+        return;
+    }
+
+    m_context->PSSetShaderResources(slot, 1, &view);
+    m_stateChanges++;
+    if (slot < MAX_SHADER_RESOURCE_SLOTS) {
+        m_shaderResources[slot] = view;
+    }
+}
+
+void ContextStateCache::SetSampler(UINT slot, ID3D11SamplerState* sampler) {
+    if (slot < MAX_SAMPLER_SLOTS && sampler == m_samplers[slot]) {
+        m_redundantBinds++;
+        return;
+    }
+
+    m_context->PSSetSamplers(slot, 1, &sampler);
+    m_stateChanges++;
+    if (slot < MAX_SAMPLER_SLOTS) {
+        m_samplers[slot] = sampler;
+    }
+}
+
+void ContextStateCache::SetShaderResources(UINT firstSlot, UINT count, ID3D11ShaderResourceView* const* views) {
+    // Untracked slots always count as changed
+    bool changed = firstSlot + count > MAX_SHADER_RESOURCE_SLOTS;
+    for (UINT i = 0; i < count && !changed; i++) {
+        changed = views[i] != m_shaderResources[firstSlot + i];
+    }
+    if (!changed) {
+        m_redundantBinds++;
+        return;
+    }
+
+    m_context->PSSetShaderResources(firstSlot, count, views);
+    m_stateChanges++;
+    for (UINT i = 0; i < count && firstSlot + i < MAX_SHADER_RESOURCE_SLOTS; i++) {
+        m_shaderResources[firstSlot + i] = views[i];
+    }
+}
+
+void ContextStateCache::SetSamplers(UINT firstSlot, UINT count, ID3D11SamplerState* const* samplers) {
+    bool changed = firstSlot + count > MAX_SAMPLER_SLOTS;
+    for (UINT i = 0; i < count && !changed; i++) {
+        changed = samplers[i] != m_samplers[firstSlot + i];
+    }
+    if (!changed) {
+        m_redundantBinds++;
+        return;
+    }
+
+    m_context->PSSetSamplers(firstSlot, count, samplers);
+    m_stateChanges++;
+    for (UINT i = 0; i < count && firstSlot + i < MAX_SAMPLER_SLOTS; i++) {
+        m_samplers[firstSlot + i] = samplers[i];
+    }
+}
+
+void ContextStateCache::SetRasterizerState(ID3D11RasterizerState* state) {
+    if (state != m_rasterizerState) {
+        m_context->RSSetState(state);
+        m_stateChanges++;
+        m_rasterizerState = state;
+    }
+    else {
+        m_redundantBinds++;
+    }
+}
+
+void ContextStateCache::SetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef) {
+    if (state != m_depthStencilState || stencilRef != m_stencilRef) {
+        m_context->OMSetDepthStencilState(state, stencilRef);
+        m_stateChanges++;
+        m_depthStencilState = state;
+        m_stencilRef = stencilRef;
+    }
+    else {
+        m_redundantBinds++;
+    }
+}
+
+void ContextStateCache::SetBlendState(ID3D11BlendState* state) {
+    if (state != m_blendState) {
+        m_context->OMSetBlendState(state, BLEND_FACTOR, SAMPLE_MASK);
+        m_stateChanges++;
+        m_blendState = state;
+    }
+    else {
+        m_redundantBinds++;
+    }
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <d3d11.h>
+#include <d3d11_1.h>
+#include "ConstantBufferRing.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+// Shadow copy of the pipeline state bound on one device context. Setters
+// skip the D3D call when the value is already bound. Each context (the
+// immediate one, or a deferred context on a worker thread) gets its own cache,
+// so no locking is needed.
+//
+// Code that binds on the context directly must Reset the cache that tracks
+// it before using it again; constant buffers bound with an offset are only
+// tracked when the context has the D3D11.1 interface.
+class ContextStateCache {
+public:
+    ContextStateCache();
+
+    // Re-read the bound state from the context; call whenever the context
+    // may have been changed without going through the cache
+    void Reset(ID3D11DeviceContext* context);
+    ID3D11DeviceContext* GetContext() const { return m_context; }
+
+    void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+    void SetVertexBuffer(ID3D11Buffer* buffer, UINT stride, UINT slot = 0);
+    void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format = DXGI_FORMAT_R32_UINT);
+    void SetVertexShader(ID3D11VertexShader* shader, ID3D11InputLayout* layout);
+    void SetPixelShader(ID3D11PixelShader* shader);
+
+    // Constant buffers, whole or as a window of a larger one
+    void SetConstantBuffer(UINT slot, ID3D11Buffer* buffer, bool vertex = true, bool pixel = true);
+    void SetConstantBuffer(UINT slot, const ConstantBinding& binding, bool vertex = true, bool pixel = true);
+
+    // Pixel shader resources
+    void SetShaderResource(UINT slot, ID3D11ShaderResourceView* view);
+    void SetSampler(UINT slot, ID3D11SamplerState* sampler);
+    // Contiguous tables, bound with one call when any entry differs
+    void SetShaderResources(UINT firstSlot, UINT count, ID3D11ShaderResourceView* const* views);
+    void SetSamplers(UINT firstSlot, UINT count, ID3D11SamplerState* const* samplers);
+
+    // Fixed-function state objects
+    void SetRasterizerState(ID3D11RasterizerState* state);
+    void SetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef = 0);
+    void SetBlendState(ID3D11BlendState* state);
+
+    // Currently bound state
+    ID3D11VertexShader* GetVertexShader() const { return m_vertexShader; }
+    ID3D11InputLayout* GetInputLayout() const { return m_inputLayout; }
+    ID3D11PixelShader* GetPixelShader() const { return m_pixelShader; }
+    ID3D11RasterizerState* GetRasterizerState() const { return m_rasterizerState; }
+    ID3D11DepthStencilState* GetDepthStencilState() const { return m_depthStencilState; }
+    ID3D11BlendState* GetBlendState() const { return m_blendState; }
+
+    // Binds skipped because the value was already bound, and binds issued
+    // (shader binds are also state changes); kept across Reset
+    UINT GetRedundantBindCount() const { return m_redundantBinds; }
+    UINT GetStateChangeCount() const { return m_stateChanges; }
+    UINT GetShaderBindCount() const { return m_shaderBinds; }
+    void ResetStats() {
+        m_redundantBinds = 0;
+        m_stateChanges = 0;
+        m_shaderBinds = 0;
+    }
+
+private:
+    static constexpr UINT MAX_VERTEX_SLOTS = 2;
+    static constexpr UINT MAX_CONSTANT_SLOTS = 4;
+    static constexpr UINT MAX_SHADER_RESOURCE_SLOTS = 8;
+    static constexpr UINT MAX_SAMPLER_SLOTS = 4;
+
+    struct ConstantSlot {
+        ID3D11Buffer* buffer;
+        UINT firstConstant;
+        UINT constantCount;
+
+        bool Matches(const ConstantBinding& binding) const {
+            return buffer == binding.buffer && firstConstant == binding.firstConstant &&
+                   constantCount == binding.constantCount;
+        }
+    };
+
+    void BindConstants(UINT slot, const ConstantBinding& binding, bool vertex, bool pixel, bool offset);
+
+    ID3D11DeviceContext* m_context;
+    ID3D11DeviceContext1* m_context1;
+
+    D3D11_PRIMITIVE_TOPOLOGY m_topology;
+    ID3D11Buffer* m_vertexBuffers[MAX_VERTEX_SLOTS];
+    UINT m_vertexStrides[MAX_VERTEX_SLOTS];
+    ID3D11Buffer* m_indexBuffer;
+    DXGI_FORMAT m_indexFormat;
+    ID3D11VertexShader* m_vertexShader;
+    ID3D11InputLayout* m_inputLayout;
+    ID3D11PixelShader* m_pixelShader;
+    ConstantSlot m_vsConstants[MAX_CONSTANT_SLOTS];
+    ConstantSlot m_psConstants[MAX_CONSTANT_SLOTS];
+    ID3D11ShaderResourceView* m_shaderResources[MAX_SHADER_RESOURCE_SLOTS];
+    ID3D11SamplerState* m_samplers[MAX_SAMPLER_SLOTS];
+    ID3D11RasterizerState* m_rasterizerState;
+    ID3D11DepthStencilState* m_depthStencilState;
+    UINT m_stencilRef;
+    ID3D11BlendState* m_blendState;
+    UINT m_redundantBinds;
+    UINT m_stateChanges;
+    UINT m_shaderBinds;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -1,19 +1,36 @@
 #include "D3D11Renderer.h"
+#include "GpuMemory.h"
 #include "../Core/Logger.h"
+#include "../Core/JobSystem.h"
+#include "../Core/MemoryTracker.h"
+#include "../Mesh/Vertex.h"
+#include "../Mesh/Material.h"
 #include <d3d11.h>
-#include <thread>
+#include <algorithm>
 // #include <DirectXTex.h> // Temporarily disabled for compilation
 
 namespace GameEngine {
 namespace Renderer {
 
 D3D11Renderer::D3D11Renderer()
-    : m_screenWidth(0)
+    : m_shadowAtlas(std::make_unique<ShadowAtlas>())
+    , m_clusteredLighting(std::make_unique<ClusteredLighting>())
+    , m_deferredShading(std::make_unique<DeferredShading>())
+    , m_deferredContexts(std::make_unique<DeferredContextPool>())
+    , m_frameLatencyWaitable(nullptr)
+    , m_swapChainFlags(0)
+    , m_flipModel(false)
+    , m_tearingSupported(false)
+    , m_screenWidth(0)
     , m_screenHeight(0)
     , m_initialized(false)
     , m_vsyncEnabled(true)
     , m_maxFPS(60)
-    , m_lastFrameTime(std::chrono::high_resolution_clock::now())
+    , m_maxFrameLatency(1)
+    , m_profilerOverlayEnabled(false)
+    , m_statsLogInterval(0.0f)
+    , m_lastStatsLogTime(0)
+    , m_viewConstantsValid(false)
 {
 }
 
@@ -27,6 +44,8 @@ bool D3D11Renderer::Initialize(HWND hwnd, int width, int height, bool fullscreen
         return true;
     }
 
+    MEMORY_SCOPE(Renderer);
+
     m_screenWidth = width;
     m_screenHeight = height;
 
@@ -56,19 +75,35 @@ bool D3D11Renderer::Initialize(HWND hwnd, int width, int height, bool fullscreen
         return false;
     }
 
+    // Compiled shader variants persist across runs
+    m_shaderCache.Initialize();
+
     // Create default states
+    m_stateObjects.Initialize(m_device.Get());
     if (!CreateDefaultStates()) {
         LOG_ERROR("Failed to create default states");
         return false;
     }
 
     // Create constant buffers
-    m_matrixBuffer = CreateConstantBuffer(sizeof(ConstantBuffer));
+    m_matrixBuffer = CreateConstantBuffer(sizeof(ObjectConstants));
     if (!m_matrixBuffer) {
         LOG_ERROR("Failed to create constant buffer");
         return false;
     }
 
+    m_viewBuffer = CreateConstantBuffer(sizeof(ViewConstants));
+    if (!m_viewBuffer) {
+        LOG_ERROR("Failed to create view constant buffer");
+        return false;
+    }
+    m_viewConstantsValid = false;
+
+    // Per-draw constants are sub-allocated from one ring where offsets are supported
+    if (SUCCEEDED(m_context.As(&m_context1))) {
+        m_constantRing.Initialize(m_device.Get(), m_context.Get());
+    }
+
     m_boneBuffer = CreateConstantBuffer(sizeof(BoneBuffer));
     if (!m_boneBuffer) {
         LOG_ERROR("Failed to create bone buffer");
@@ -84,6 +119,7 @@ bool D3D11Renderer::Initialize(HWND hwnd, int width, int height, bool fullscreen
 
     float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
     m_context->OMSetBlendState(m_blendState.Get(), blendFactor, 0xffffffff);
+    m_stateCache.Reset(m_context.Get());
 
     // Initialize lighting system
     m_lightManager = std::make_unique<LightManager>();
@@ -99,6 +135,48 @@ bool D3D11Renderer::Initialize(HWND hwnd, int width, int height, bool fullscreen
         return false;
     }
 
+    // Draws without a material see the default properties
+    m_defaultMaterial = std::make_shared<Mesh::Material>();
+    if (!m_defaultMaterial->PrepareConstants(m_device.Get())) {
+        return false;
+    }
+
+    // Per-light shadow maps, plus shared cached tiles for spot and directional lights
+    m_transientTextures.Initialize(m_device.Get());
+    m_shadowMapManager = std::make_unique<ShadowMapManager>(m_device.Get());
+    m_shadowMapManager->SetTransientTextures(&m_transientTextures);
+    ComPtr<ID3D11ComputeShader> shadowBlurShader;
+    if (LoadComputeShader(L"Shaders/ShadowBlurComputeShader.hlsl", shadowBlurShader)) {
+        D3D11_SAMPLER_DESC momentsSamplerDesc = {};
+        momentsSamplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
+        momentsSamplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+        momentsSamplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+        momentsSamplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        momentsSamplerDesc.MaxAnisotropy = 8;
+        momentsSamplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+        momentsSamplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+        m_shadowMapManager->SetBlurShader(shadowBlurShader);
+        m_shadowMapManager->SetMomentsSampler(m_stateObjects.GetSamplerState(momentsSamplerDesc));
+    } else {
+        LOG_WARNING("Shadow blur unavailable, VSM shadows use plain depth");
+    }
+    if (!m_shadowAtlas->Initialize(m_device.Get())) {
+        LOG_WARNING("Shadow atlas unavailable, cached shadows disabled");
+    }
+
+    // Pass timings; the overlay is optional
+    GPU_PROFILER.Initialize(m_device.Get(), m_context.Get());
+    if (!m_profilerOverlay.Initialize(m_device.Get(), m_stateObjects)) {
+        LOG_WARNING("Profiler overlay unavailable");
+    }
+
+    // Deferred contexts, one per thread that can record
+    if (JOB_SYSTEM.IsInitialized() && JOB_SYSTEM.GetWorkerCount() > 0) {
+        if (!m_deferredContexts->Initialize(m_device.Get(), JOB_SYSTEM.GetWorkerCount() + 1)) {
+            LOG_WARNING("Deferred contexts unavailable, rendering on the immediate context only");
+        }
+    }
+
     m_initialized = true;
     LOG_INFO("D3D11 Renderer initialized successfully");
 
@@ -115,9 +193,36 @@ void D3D11Renderer::Shutdown() {
         m_context->ClearState();
     }
 
+    // Release deferred contexts before the device goes away
+    m_deferredContexts->Shutdown();
+
     // Cleanup lighting system
     m_lightManager.reset();
+    m_shadowMapManager.reset();
     m_lightBuffer.Reset();
+    m_defaultMaterial.reset();
+    m_deferredShading = std::make_unique<DeferredShading>();
+    m_frameGraph.Reset();
+    m_transientTextures.Clear();
+
+    m_profilerOverlay.Shutdown();
+    GPU_PROFILER.Shutdown();
+
+    m_constantRing.Shutdown();
+    m_context1.Reset();
+    m_adapter.Reset();
+    m_stateCache.Reset(nullptr);
+    m_stateObjects.Clear();
+
+    if (m_frameLatencyWaitable) {
+        CloseHandle(m_frameLatencyWaitable);
+        m_frameLatencyWaitable = nullptr;
+    }
+
+    // Flip-model swap chains must leave exclusive fullscreen before release
+    if (m_swapChain) {
+        m_swapChain->SetFullscreenState(FALSE, nullptr);
+    }
 
     m_initialized = false;
     LOG_INFO("D3D11 Renderer shutdown complete");
@@ -128,6 +233,29 @@ void D3D11Renderer::BeginFrame(float r, float g, float b, float a) {
         return;
     }
 
+    GPU_PROFILER.BeginFrame();
+
+    // Counters start over; the ring's own stats are folded in at EndFrame
+    std::uint64_t frameIndex = m_lastFrameStats.frameIndex + 1;
+    m_frameStats = RenderFrameStats();
+    m_frameStats.frameIndex = frameIndex;
+    m_stateCache.ResetStats();
+    for (UINT i = 0; i < m_deferredContexts->GetContextCount(); i++) {
+        m_deferredContexts->GetStateCache(i).ResetStats();
+    }
+    m_shadowMapManager->ResetStats();
+
+    // Constants uploaded last frame may still be in flight
+    m_constantRing.BeginFrame();
+
+    // Flip-model presents unbind the back buffer
+    m_context->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+    m_context->RSSetViewports(1, &m_viewport);
+
+    // Pick up anything bound behind the state cache's back last frame
+    m_stateCache.Reset(m_context.Get());
+    m_defaultMaterial->Apply(m_stateCache);
+
     // Clear render target
     float clearColor[4] = { r, g, b, a };
     m_context->ClearRenderTargetView(m_renderTargetView.Get(), clearColor);
@@ -143,40 +271,69 @@ void D3D11Renderer::EndFrame() {
         return;
     }
 
-    // FPS limiting (only if VSync is disabled and max FPS is set)
-    if (!m_vsyncEnabled && m_maxFPS > 0) {
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        auto frameTime = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - m_lastFrameTime);
-        auto targetFrameTime = std::chrono::microseconds(1000000 / m_maxFPS);
+    if (m_profilerOverlayEnabled) {
+        GPU_PROFILE_SCOPE(m_context.Get(), "Overlay");
+        m_profilerOverlay.Render(m_context.Get(), PROFILER.GetFrameStats(), MEMORY_TRACKER.TakeSnapshot());
 
-        if (frameTime < targetFrameTime) {
-            auto sleepTime = targetFrameTime - frameTime;
-            std::this_thread::sleep_for(sleepTime);
-        }
+        // Back to the default states for the next frame
+        m_context->RSSetState(m_rasterizerState.Get());
+        m_context->OMSetDepthStencilState(m_depthStencilState.Get(), 1);
+        float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        m_context->OMSetBlendState(m_blendState.Get(), blendFactor, 0xffffffff);
+        InvalidateStateCache();
+    }
+
+    GPU_PROFILER.EndFrame();
+    FinishFrameStats();
+    UpdateVideoMemoryInfo();
+    m_transientTextures.EndFrame();
+
+    PROFILE_SCOPE("Present");
 
-        m_lastFrameTime = std::chrono::high_resolution_clock::now();
+    // Tearing is only allowed for windowed (including borderless) presents
+    UINT presentFlags = 0;
+    if (!m_vsyncEnabled && m_tearingSupported) {
+        BOOL fullscreen = FALSE;
+        m_swapChain->GetFullscreenState(&fullscreen, nullptr);
+        if (!fullscreen) {
+            presentFlags |= DXGI_PRESENT_ALLOW_TEARING;
+        }
     }
 
     // Present the frame
-    HRESULT hr = m_swapChain->Present(m_vsyncEnabled ? 1 : 0, 0);
+    HRESULT hr = m_swapChain->Present(m_vsyncEnabled ? 1 : 0, presentFlags);
 
     if (FAILED(hr)) {
         LOG_ERROR("Failed to present frame: " << std::hex << hr);
     }
 }
 
+void D3D11Renderer::WaitForFrame() {
+    if (!m_initialized) {
+        return;
+    }
+
+    // Signalled once fewer than the maximum latency frames are queued
+    if (m_frameLatencyWaitable) {
+        WaitForSingleObjectEx(m_frameLatencyWaitable, 1000, TRUE);
+    }
+
+    m_frameLimiter.Wait();
+}
+
 void D3D11Renderer::Resize(int width, int height) {
     if (!m_initialized || (width == m_screenWidth && height == m_screenHeight)) {
         return;
     }
 
     LOG_INFO("Resizing renderer to " << width << "x" << height);
+    MEMORY_SCOPE(Renderer);
 
     // Clear render targets
     CleanupRenderTargets();
 
     // Resize swap chain
-    HRESULT hr = m_swapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, 0);
+    HRESULT hr = m_swapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, m_swapChainFlags);
     if (FAILED(hr)) {
         LOG_ERROR("Failed to resize swap chain buffers");
         return;
@@ -221,13 +378,18 @@ ComPtr<ID3D11Buffer> D3D11Renderer::CreateVertexBuffer(const void* data, UINT si
         }
     }
 
+    TrackGpuMemory(buffer.Get());
     return buffer;
 }
 
 ComPtr<ID3D11Buffer> D3D11Renderer::CreateIndexBuffer(const UINT* indices, UINT count) {
+    return CreateIndexBuffer(indices, count, DXGI_FORMAT_R32_UINT);
+}
+
+ComPtr<ID3D11Buffer> D3D11Renderer::CreateIndexBuffer(const void* indices, UINT count, DXGI_FORMAT format) {
     D3D11_BUFFER_DESC bufferDesc = {};
     bufferDesc.Usage = D3D11_USAGE_DEFAULT;
-    bufferDesc.ByteWidth = sizeof(UINT) * count;
+    bufferDesc.ByteWidth = (format == DXGI_FORMAT_R16_UINT ? 2 : 4) * count;
     bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
     bufferDesc.CPUAccessFlags = 0;
 
@@ -241,6 +403,7 @@ ComPtr<ID3D11Buffer> D3D11Renderer::CreateIndexBuffer(const UINT* indices, UINT
         return nullptr;
     }
 
+    TrackGpuMemory(buffer.Get());
     return buffer;
 }
 
@@ -261,36 +424,158 @@ ComPtr<ID3D11Buffer> D3D11Renderer::CreateConstantBuffer(UINT size) {
         return nullptr;
     }
 
+    TrackGpuMemory(buffer.Get());
     return buffer;
 }
 
-bool D3D11Renderer::LoadVertexShader(const std::wstring& filename, ComPtr<ID3D11VertexShader>& shader,
-                                     ComPtr<ID3D11InputLayout>& layout, const D3D11_INPUT_ELEMENT_DESC* elements, UINT elementCount) {
-    ComPtr<ID3DBlob> shaderBlob;
-    ComPtr<ID3DBlob> errorBlob;
+ComPtr<ID3D11Buffer> D3D11Renderer::CreateRawBuffer(const void* data, UINT size, UINT bindFlags) {
+    // Raw views address the buffer in 4-byte words
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+    bufferDesc.ByteWidth = (size + 3) & ~3;
+    bufferDesc.BindFlags = bindFlags;
+    bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
 
-    HRESULT hr = D3DCompileFromFile(filename.c_str(), nullptr, nullptr, "main", "vs_5_0",
-                                   D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, 0,
-                                   &shaderBlob, &errorBlob);
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem = data;
 
+    ComPtr<ID3D11Buffer> buffer;
+    HRESULT hr = m_device->CreateBuffer(&bufferDesc, data ? &initData : nullptr, &buffer);
     if (FAILED(hr)) {
-        if (errorBlob) {
-            LOG_ERROR("Vertex shader compilation failed: " << (char*)errorBlob->GetBufferPointer());
-        }
-        return false;
+        LOG_ERROR("Failed to create raw buffer of " << size << " bytes");
+        return nullptr;
     }
 
-    // Create vertex shader
-    hr = m_device->CreateVertexShader(shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(),
-                                     nullptr, &shader);
+    TrackGpuMemory(buffer.Get());
+    return buffer;
+}
+
+ComPtr<ID3D11ShaderResourceView> D3D11Renderer::CreateRawShaderResourceView(ID3D11Buffer* buffer, UINT size) {
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
+    srvDesc.BufferEx.FirstElement = 0;
+    srvDesc.BufferEx.NumElements = (size + 3) / 4;
+    srvDesc.BufferEx.Flags = D3D11_BUFFEREX_SRV_FLAG_RAW;
+
+    ComPtr<ID3D11ShaderResourceView> view;
+    HRESULT hr = m_device->CreateShaderResourceView(buffer, &srvDesc, &view);
     if (FAILED(hr)) {
-        LOG_ERROR("Failed to create vertex shader");
+        LOG_ERROR("Failed to create raw shader resource view");
+        return nullptr;
+    }
+
+    return view;
+}
+
+ComPtr<ID3D11UnorderedAccessView> D3D11Renderer::CreateRawUnorderedAccessView(ID3D11Buffer* buffer, UINT size) {
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+    uavDesc.Buffer.FirstElement = 0;
+    uavDesc.Buffer.NumElements = (size + 3) / 4;
+    uavDesc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
+
+    ComPtr<ID3D11UnorderedAccessView> view;
+    HRESULT hr = m_device->CreateUnorderedAccessView(buffer, &uavDesc, &view);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create raw unordered access view");
+        return nullptr;
+    }
+
+    return view;
+}
+
+ComPtr<ID3D11Buffer> D3D11Renderer::CreateStructuredBuffer(const void* data, UINT elementSize, UINT elementCount,
+                                                          UINT bindFlags) {
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+    bufferDesc.ByteWidth = elementSize * elementCount;
+    bufferDesc.BindFlags = bindFlags;
+    bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    bufferDesc.StructureByteStride = elementSize;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem = data;
+
+    ComPtr<ID3D11Buffer> buffer;
+    HRESULT hr = m_device->CreateBuffer(&bufferDesc, data ? &initData : nullptr, &buffer);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create structured buffer of " << elementCount << " x " << elementSize << " bytes");
+        return nullptr;
+    }
+
+    TrackGpuMemory(buffer.Get());
+    return buffer;
+}
+
+ComPtr<ID3D11ShaderResourceView> D3D11Renderer::CreateStructuredShaderResourceView(ID3D11Buffer* buffer, UINT elementCount) {
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+    srvDesc.Buffer.FirstElement = 0;
+    srvDesc.Buffer.NumElements = elementCount;
+
+    ComPtr<ID3D11ShaderResourceView> view;
+    HRESULT hr = m_device->CreateShaderResourceView(buffer, &srvDesc, &view);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create structured shader resource view");
+        return nullptr;
+    }
+
+    return view;
+}
+
+ComPtr<ID3D11UnorderedAccessView> D3D11Renderer::CreateStructuredUnorderedAccessView(ID3D11Buffer* buffer, UINT elementCount) {
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+    uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+    uavDesc.Buffer.FirstElement = 0;
+    uavDesc.Buffer.NumElements = elementCount;
+
+    ComPtr<ID3D11UnorderedAccessView> view;
+    HRESULT hr = m_device->CreateUnorderedAccessView(buffer, &uavDesc, &view);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create structured unordered access view");
+        return nullptr;
+    }
+
+    return view;
+}
+
+ComPtr<ID3D11Buffer> D3D11Renderer::CreateIndirectArgsBuffer(const D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS* args,
+                                                            UINT drawCount) {
+    // Indirect argument buffers cannot be structured, compute writes them raw
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+    bufferDesc.ByteWidth = drawCount * sizeof(D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS);
+    bufferDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS | D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem = args;
+
+    ComPtr<ID3D11Buffer> buffer;
+    HRESULT hr = m_device->CreateBuffer(&bufferDesc, args ? &initData : nullptr, &buffer);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create indirect argument buffer for " << drawCount << " draws");
+        return nullptr;
+    }
+
+    TrackGpuMemory(buffer.Get());
+    return buffer;
+}
+
+bool D3D11Renderer::LoadVertexShader(const std::wstring& filename, ComPtr<ID3D11VertexShader>& shader,
+                                     ComPtr<ID3D11InputLayout>& layout, const D3D11_INPUT_ELEMENT_DESC* elements, UINT elementCount,
+                                     std::uint32_t features) {
+    ShaderBytecode bytecode;
+    if (!CompileVertexShader(filename, features, shader, bytecode)) {
         return false;
     }
 
     // Create input layout
-    hr = m_device->CreateInputLayout(elements, elementCount, shaderBlob->GetBufferPointer(),
-                                    shaderBlob->GetBufferSize(), &layout);
+    HRESULT hr = m_device->CreateInputLayout(elements, elementCount, bytecode->data(), bytecode->size(), &layout);
     if (FAILED(hr)) {
         LOG_ERROR("Failed to create input layout");
         return false;
@@ -299,24 +584,58 @@ bool D3D11Renderer::LoadVertexShader(const std::wstring& filename, ComPtr<ID3D11
     return true;
 }
 
-bool D3D11Renderer::LoadPixelShader(const std::wstring& filename, ComPtr<ID3D11PixelShader>& shader) {
-    ComPtr<ID3DBlob> shaderBlob;
-    ComPtr<ID3DBlob> errorBlob;
+bool D3D11Renderer::LoadVertexShader(const std::wstring& filename, ComPtr<ID3D11VertexShader>& shader,
+                                     Mesh::VertexInputLayouts& layouts, const Mesh::VertexLayoutDesc* formatLayouts,
+                                     std::uint32_t features) {
+    ShaderBytecode bytecode;
+    if (!formatLayouts || !CompileVertexShader(filename, features, shader, bytecode)) {
+        return false;
+    }
 
-    HRESULT hr = D3DCompileFromFile(filename.c_str(), nullptr, nullptr, "main", "ps_5_0",
-                                   D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, 0,
-                                   &shaderBlob, &errorBlob);
+    layouts = Mesh::VertexInputLayouts();
+    for (UINT format = 0; format < Mesh::VertexFormatCount; format++) {
+        const Mesh::VertexLayoutDesc& desc = formatLayouts[format];
+        if (!desc.elements) {
+            continue;
+        }
 
-    if (FAILED(hr)) {
-        if (errorBlob) {
-            LOG_ERROR("Pixel shader compilation failed: " << (char*)errorBlob->GetBufferPointer());
+        HRESULT hr = m_device->CreateInputLayout(desc.elements, desc.elementCount, bytecode->data(),
+                                                bytecode->size(), &layouts.layouts[format]);
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create input layout for vertex format " << format);
+            return false;
         }
+    }
+
+    return true;
+}
+
+bool D3D11Renderer::CompileVertexShader(const std::wstring& filename, std::uint32_t features,
+                                        ComPtr<ID3D11VertexShader>& shader, ShaderBytecode& bytecode) {
+    bytecode = m_shaderCache.GetBytecode(filename, ShaderStage::Vertex, features);
+    if (!bytecode) {
+        return false;
+    }
+
+    // Create vertex shader
+    HRESULT hr = m_device->CreateVertexShader(bytecode->data(), bytecode->size(), nullptr, &shader);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create vertex shader");
+        return false;
+    }
+
+    return true;
+}
+
+bool D3D11Renderer::LoadPixelShader(const std::wstring& filename, ComPtr<ID3D11PixelShader>& shader,
+                                    std::uint32_t features) {
+    ShaderBytecode bytecode = m_shaderCache.GetBytecode(filename, ShaderStage::Pixel, features);
+    if (!bytecode) {
         return false;
     }
 
     // Create pixel shader
-    hr = m_device->CreatePixelShader(shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(),
-                                    nullptr, &shader);
+    HRESULT hr = m_device->CreatePixelShader(bytecode->data(), bytecode->size(), nullptr, &shader);
     if (FAILED(hr)) {
         LOG_ERROR("Failed to create pixel shader");
         return false;
@@ -325,80 +644,283 @@ bool D3D11Renderer::LoadPixelShader(const std::wstring& filename, ComPtr<ID3D11P
     return true;
 }
 
+bool D3D11Renderer::LoadComputeShader(const std::wstring& filename, ComPtr<ID3D11ComputeShader>& shader,
+                                      std::uint32_t features) {
+    ShaderBytecode bytecode = m_shaderCache.GetBytecode(filename, ShaderStage::Compute, features);
+    if (!bytecode) {
+        return false;
+    }
+
+    // Create compute shader
+    HRESULT hr = m_device->CreateComputeShader(bytecode->data(), bytecode->size(), nullptr, &shader);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create compute shader");
+        return false;
+    }
+
+    return true;
+}
+
 void D3D11Renderer::SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {
-    m_context->IASetPrimitiveTopology(topology);
+    m_stateCache.SetPrimitiveTopology(topology);
 }
 
 void D3D11Renderer::SetVertexBuffer(ID3D11Buffer* buffer, UINT stride, UINT offset) {
+    if (offset == 0) {
+        m_stateCache.SetVertexBuffer(buffer, stride, 0);
+        return;
+    }
+
+    // The cache does not track offsets
     m_context->IASetVertexBuffers(0, 1, &buffer, &stride, &offset);
+    InvalidateStateCache();
+}
+
+void D3D11Renderer::SetInstanceBuffer(ID3D11Buffer* buffer, UINT stride, UINT slot) {
+    m_stateCache.SetVertexBuffer(buffer, stride, slot);
 }
 
 void D3D11Renderer::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format) {
-    m_context->IASetIndexBuffer(buffer, format, 0);
+    m_stateCache.SetIndexBuffer(buffer, format);
 }
 
 void D3D11Renderer::SetVertexShader(ID3D11VertexShader* shader, ID3D11InputLayout* layout) {
-    m_context->VSSetShader(shader, nullptr, 0);
-    m_context->IASetInputLayout(layout);
+    m_stateCache.SetVertexShader(shader, layout);
 }
 
 void D3D11Renderer::SetPixelShader(ID3D11PixelShader* shader) {
-    m_context->PSSetShader(shader, nullptr, 0);
+    m_stateCache.SetPixelShader(shader);
 }
 
 void D3D11Renderer::SetConstantBuffer(ID3D11Buffer* buffer, UINT slot, bool vertex, bool pixel) {
-    if (vertex) {
-        m_context->VSSetConstantBuffers(slot, 1, &buffer);
-    }
-    if (pixel) {
-        m_context->PSSetConstantBuffers(slot, 1, &buffer);
-    }
+    m_stateCache.SetConstantBuffer(slot, buffer, vertex, pixel);
 }
 
 void D3D11Renderer::SetTexture(ID3D11ShaderResourceView* texture, UINT slot) {
-    m_context->PSSetShaderResources(slot, 1, &texture);
+    m_stateCache.SetShaderResource(slot, texture);
 }
 
 void D3D11Renderer::SetSampler(ID3D11SamplerState* sampler, UINT slot) {
-    m_context->PSSetSamplers(slot, 1, &sampler);
+    m_stateCache.SetSampler(slot, sampler);
+}
+
+void D3D11Renderer::SetRasterizerState(ID3D11RasterizerState* state) {
+    m_stateCache.SetRasterizerState(state);
+}
+
+void D3D11Renderer::SetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef) {
+    m_stateCache.SetDepthStencilState(state, stencilRef);
+}
+
+void D3D11Renderer::SetBlendState(ID3D11BlendState* state) {
+    m_stateCache.SetBlendState(state);
 }
 
 void D3D11Renderer::DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex) {
     m_context->DrawIndexed(indexCount, startIndex, baseVertex);
+    RecordDraw(indexCount, 1);
+}
+
+void D3D11Renderer::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex,
+                                         INT baseVertex, UINT startInstance) {
+    m_context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+    RecordDraw(indexCount, instanceCount);
+    m_frameStats.instancedDrawCalls++;
+    m_frameStats.instancesDrawn += instanceCount;
 }
 
 void D3D11Renderer::Draw(UINT vertexCount, UINT startVertex) {
     m_context->Draw(vertexCount, startVertex);
+    RecordDraw(vertexCount, 1);
+}
+
+void D3D11Renderer::RecordDraw(UINT indexCount, UINT instanceCount) {
+    m_frameStats.drawCalls++;
+    m_frameStats.trianglesDrawn += static_cast<std::uint64_t>(indexCount / 3) * instanceCount;
+}
+
+void D3D11Renderer::RecordBufferMap(UINT bytes) {
+    m_frameStats.bufferMaps++;
+    m_frameStats.bytesMapped += bytes;
+}
+
+void D3D11Renderer::AddFrameStats(const RenderFrameStats& stats) {
+    m_frameStats.drawCalls += stats.drawCalls;
+    m_frameStats.instancedDrawCalls += stats.instancedDrawCalls;
+    m_frameStats.indirectDrawCalls += stats.indirectDrawCalls;
+    m_frameStats.instancesDrawn += stats.instancesDrawn;
+    m_frameStats.trianglesDrawn += stats.trianglesDrawn;
+    m_frameStats.bufferMaps += stats.bufferMaps;
+    m_frameStats.bytesMapped += stats.bytesMapped;
+    m_frameStats.lightsVisible += stats.lightsVisible;
+    m_frameStats.lightsCulled += stats.lightsCulled;
+    m_frameStats.shadowMapsRendered += stats.shadowMapsRendered;
+    m_frameStats.shadowMapsFiltered += stats.shadowMapsFiltered;
+}
+
+void D3D11Renderer::FinishFrameStats() {
+    // Binds counted by the immediate cache and every deferred one
+    m_frameStats.stateChanges = m_stateCache.GetStateChangeCount();
+    m_frameStats.redundantBinds = m_stateCache.GetRedundantBindCount();
+    m_frameStats.shaderBinds = m_stateCache.GetShaderBindCount();
+    for (UINT i = 0; i < m_deferredContexts->GetContextCount(); i++) {
+        const ContextStateCache& stateCache = m_deferredContexts->GetStateCache(i);
+        m_frameStats.stateChanges += stateCache.GetStateChangeCount();
+        m_frameStats.redundantBinds += stateCache.GetRedundantBindCount();
+        m_frameStats.shaderBinds += stateCache.GetShaderBindCount();
+    }
+
+    const ConstantRingStats& ringStats = m_constantRing.GetStats();
+    m_frameStats.bufferMaps += ringStats.maps;
+    m_frameStats.bytesMapped += ringStats.bytesAllocated;
+    m_frameStats.shadowMapsRendered += m_shadowMapManager->GetShadowMapsRendered();
+    m_frameStats.shadowMapsFiltered += m_shadowMapManager->GetMomentMapsFiltered();
+    m_frameStats.framePasses = m_frameGraph.GetPassCount();
+    m_frameStats.framePassesCulled = m_frameGraph.GetCulledPassCount();
+    m_frameStats.transientAcquires = m_transientTextures.GetAcquireCount();
+    m_frameStats.transientReuses = m_transientTextures.GetReuseCount();
+    m_frameStats.transientTextures = static_cast<UINT>(m_transientTextures.GetTextureCount());
+    m_frameStats.transientBytes = m_transientTextures.GetAllocatedBytes();
+
+    m_lastFrameStats = m_frameStats;
+
+    if (m_statsLogInterval > 0.0f) {
+        std::int64_t now = Core::Profiler::Now();
+        if (now - m_lastStatsLogTime >= static_cast<std::int64_t>(m_statsLogInterval * 1000000.0f)) {
+            m_lastStatsLogTime = now;
+            LogFrameStats();
+        }
+    }
+}
+
+void D3D11Renderer::UpdateVideoMemoryInfo() {
+    // Covers everything the process has on the GPU, tracked or not, including the swap chain
+    DXGI_QUERY_VIDEO_MEMORY_INFO info = {};
+    if (m_adapter && SUCCEEDED(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info))) {
+        MEMORY_TRACKER.SetVideoMemoryInfo(static_cast<std::int64_t>(info.CurrentUsage),
+                                          static_cast<std::int64_t>(info.Budget));
+    }
+}
+
+void D3D11Renderer::LogFrameStats() const {
+    const RenderFrameStats& stats = m_lastFrameStats;
+    LOG_INFO("Render stats (frame " << stats.frameIndex << "): "
+             << stats.drawCalls << " draws (" << stats.instancedDrawCalls << " instanced, "
+             << stats.indirectDrawCalls << " indirect), " << stats.trianglesDrawn << " triangles, "
+             << stats.GetInstancesPerBatch() << " instances per batch");
+    LOG_INFO("  " << stats.stateChanges << " state changes (" << stats.shaderBinds << " shader binds, "
+             << stats.redundantBinds << " redundant skipped), " << stats.bufferMaps << " maps ("
+             << stats.bytesMapped / 1024 << " KB)");
+    LOG_INFO("  " << stats.lightsVisible << " lights visible, " << stats.lightsCulled << " culled, "
+             << stats.shadowMapsRendered << " shadow maps rendered (" << stats.shadowMapsFiltered << " filtered)");
+    LOG_INFO("  " << stats.framePasses << " frame graph passes (" << stats.framePassesCulled << " culled), "
+             << stats.transientAcquires << " transient acquires (" << stats.transientReuses << " aliased), "
+             << stats.transientTextures << " transient textures (" << stats.transientBytes / 1024 << " KB)");
+}
+
+void D3D11Renderer::SetStatsLogInterval(float seconds) {
+    m_statsLogInterval = std::max(seconds, 0.0f);
+    m_lastStatsLogTime = Core::Profiler::Now();
 }
 
 void D3D11Renderer::UpdateConstantBuffer(const Math::Matrix4& world, const Math::Matrix4& view, const Math::Matrix4& projection) {
+    UpdateViewConstants(view.ToXMMATRIX(), projection.ToXMMATRIX());
+
+    ObjectConstants objectConstants;
+    objectConstants.World = DirectX::XMMatrixTranspose(world.ToXMMATRIX());
+
+    if (m_constantRing.IsAvailable()) {
+        ConstantBinding binding = m_constantRing.Upload(&objectConstants, sizeof(ObjectConstants));
+        if (binding.IsValid()) {
+            m_stateCache.SetConstantBuffer(OBJECT_CONSTANT_SLOT, binding);
+            return;
+        }
+    }
+
     D3D11_MAPPED_SUBRESOURCE mappedResource;
     HRESULT hr = m_context->Map(m_matrixBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 
     if (SUCCEEDED(hr)) {
-        ConstantBuffer* cb = (ConstantBuffer*)mappedResource.pData;
-        cb->World = DirectX::XMMatrixTranspose(world.ToXMMATRIX());
-        cb->View = DirectX::XMMatrixTranspose(view.ToXMMATRIX());
-        cb->Projection = DirectX::XMMatrixTranspose(projection.ToXMMATRIX());
-
+        memcpy(mappedResource.pData, &objectConstants, sizeof(ObjectConstants));
         m_context->Unmap(m_matrixBuffer.Get(), 0);
+        RecordBufferMap(sizeof(ObjectConstants));
+        SetConstantBuffer(m_matrixBuffer.Get(), OBJECT_CONSTANT_SLOT, true, true);
     }
 }
 
-bool D3D11Renderer::CreateDeviceAndSwapChain(HWND hwnd, bool fullscreen) {
-    DXGI_SWAP_CHAIN_DESC swapChainDesc = {};
-    swapChainDesc.BufferCount = 1;
-    swapChainDesc.BufferDesc.Width = m_screenWidth;
-    swapChainDesc.BufferDesc.Height = m_screenHeight;
-    swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    swapChainDesc.BufferDesc.RefreshRate.Numerator = 60;
-    swapChainDesc.BufferDesc.RefreshRate.Denominator = 1;
-    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.OutputWindow = hwnd;
-    swapChainDesc.SampleDesc.Count = 1;
-    swapChainDesc.SampleDesc.Quality = 0;
-    swapChainDesc.Windowed = !fullscreen;
+void D3D11Renderer::UpdateViewConstants(const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& projection) {
+    if (!m_viewBuffer) {
+        return;
+    }
+
+    // Most draws share the camera, skip the map when nothing changed
+    DirectX::XMFLOAT4X4 viewMatrix, projectionMatrix;
+    DirectX::XMStoreFloat4x4(&viewMatrix, view);
+    DirectX::XMStoreFloat4x4(&projectionMatrix, projection);
+    if (!m_viewConstantsValid ||
+        memcmp(&viewMatrix, &m_uploadedView, sizeof(viewMatrix)) != 0 ||
+        memcmp(&projectionMatrix, &m_uploadedProjection, sizeof(projectionMatrix)) != 0) {
+        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        HRESULT hr = m_context->Map(m_viewBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to map view constant buffer");
+            return;
+        }
+
+        ViewConstants* constants = static_cast<ViewConstants*>(mappedResource.pData);
+        constants->View = DirectX::XMMatrixTranspose(view);
+        constants->Projection = DirectX::XMMatrixTranspose(projection);
+        m_context->Unmap(m_viewBuffer.Get(), 0);
+        RecordBufferMap(sizeof(ViewConstants));
+
+        m_uploadedView = viewMatrix;
+        m_uploadedProjection = projectionMatrix;
+        m_viewConstantsValid = true;
+    }
+
+    SetConstantBuffer(m_viewBuffer.Get(), VIEW_CONSTANT_SLOT, true, true);
+}
+
+void D3D11Renderer::UpdateBoneBuffer(const DirectX::XMMATRIX* boneTransforms, UINT boneCount) {
+    if (!boneTransforms || !m_boneBuffer) {
+        return;
+    }
+
+    // Only the palette in use is written, the ring hands out 256-byte windows
+    const UINT maxBones = static_cast<UINT>(sizeof(BoneBuffer) / sizeof(DirectX::XMMATRIX));
+    if (boneCount > maxBones) {
+        LOG_WARNING("Bone count " << boneCount << " exceeds " << maxBones << ", clamping");
+        boneCount = maxBones;
+    }
 
+    if (m_constantRing.IsAvailable() && m_constantRing.Map()) {
+        ConstantAllocation allocation = m_constantRing.Allocate(static_cast<UINT>(sizeof(BoneBuffer)));
+        if (allocation.data) {
+            DirectX::XMMATRIX* bones = static_cast<DirectX::XMMATRIX*>(allocation.data);
+            for (UINT i = 0; i < boneCount; i++) {
+                bones[i] = DirectX::XMMatrixTranspose(boneTransforms[i]);
+            }
+            m_constantRing.Unmap();
+            m_stateCache.SetConstantBuffer(BONE_CONSTANT_SLOT, allocation, true, false);
+            return;
+        }
+        m_constantRing.Unmap();
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = m_context->Map(m_boneBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+    if (SUCCEEDED(hr)) {
+        BoneBuffer* bones = static_cast<BoneBuffer*>(mappedResource.pData);
+        for (UINT i = 0; i < boneCount; i++) {
+            bones->BoneTransforms[i] = DirectX::XMMatrixTranspose(boneTransforms[i]);
+        }
+        m_context->Unmap(m_boneBuffer.Get(), 0);
+        RecordBufferMap(sizeof(BoneBuffer));
+        SetConstantBuffer(m_boneBuffer.Get(), BONE_CONSTANT_SLOT, true, false);
+    }
+}
+
+bool D3D11Renderer::CreateDeviceAndSwapChain(HWND hwnd, bool fullscreen) {
     D3D_FEATURE_LEVEL featureLevel;
     UINT createDeviceFlags = 0;
 
@@ -406,7 +928,7 @@ bool D3D11Renderer::CreateDeviceAndSwapChain(HWND hwnd, bool fullscreen) {
     createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
 #endif
 
-    HRESULT hr = D3D11CreateDeviceAndSwapChain(
+    HRESULT hr = D3D11CreateDevice(
         nullptr,
         D3D_DRIVER_TYPE_HARDWARE,
         nullptr,
@@ -414,15 +936,13 @@ bool D3D11Renderer::CreateDeviceAndSwapChain(HWND hwnd, bool fullscreen) {
         nullptr,
         0,
         D3D11_SDK_VERSION,
-        &swapChainDesc,
-        &m_swapChain,
         &m_device,
         &featureLevel,
         &m_context
     );
 
     if (FAILED(hr)) {
-        LOG_ERROR("Failed to create D3D11 device and swap chain");
+        LOG_ERROR("Failed to create D3D11 device");
         return false;
     }
 
@@ -430,6 +950,85 @@ bool D3D11Renderer::CreateDeviceAndSwapChain(HWND hwnd, bool fullscreen) {
         LOG_WARNING("D3D11 feature level not supported, using: " << featureLevel);
     }
 
+    return CreateSwapChain(hwnd, fullscreen);
+}
+
+bool D3D11Renderer::CreateSwapChain(HWND hwnd, bool fullscreen) {
+    // The swap chain has to come from the factory that created the device
+    ComPtr<IDXGIDevice1> dxgiDevice;
+    ComPtr<IDXGIAdapter> adapter;
+    ComPtr<IDXGIFactory2> factory;
+    if (FAILED(m_device.As(&dxgiDevice)) || FAILED(dxgiDevice->GetAdapter(&adapter)) ||
+        FAILED(adapter->GetParent(IID_PPV_ARGS(&factory)))) {
+        LOG_ERROR("Failed to get DXGI factory");
+        return false;
+    }
+
+    adapter.As(&m_adapter);
+
+    ComPtr<IDXGIFactory5> factory5;
+    if (SUCCEEDED(factory.As(&factory5))) {
+        BOOL allowTearing = FALSE;
+        m_tearingSupported = SUCCEEDED(factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING,
+                                                                     &allowTearing, sizeof(allowTearing))) && allowTearing;
+    }
+
+    DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
+    swapChainDesc.Width = m_screenWidth;
+    swapChainDesc.Height = m_screenHeight;
+    swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    swapChainDesc.SampleDesc.Count = 1;
+    swapChainDesc.SampleDesc.Quality = 0;
+    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    swapChainDesc.Scaling = DXGI_SCALING_STRETCH;
+    swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+
+    // Flip model: the compositor takes the back buffer without a copy, and a
+    // waitable swap chain lets us block until the queue has room
+    swapChainDesc.BufferCount = 2;
+    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    if (m_tearingSupported) {
+        swapChainDesc.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    }
+
+    DXGI_SWAP_CHAIN_FULLSCREEN_DESC fullscreenDesc = {};
+    fullscreenDesc.RefreshRate.Numerator = 60;
+    fullscreenDesc.RefreshRate.Denominator = 1;
+    fullscreenDesc.Windowed = !fullscreen;
+
+    HRESULT hr = factory->CreateSwapChainForHwnd(m_device.Get(), hwnd, &swapChainDesc, &fullscreenDesc,
+                                                 nullptr, &m_swapChain);
+    m_flipModel = SUCCEEDED(hr);
+
+    // FLIP_DISCARD needs Windows 10; fall back to the blt model
+    if (!m_flipModel) {
+        LOG_WARNING("Flip-model swap chain unavailable, using blt-model presentation");
+        m_tearingSupported = false;
+        swapChainDesc.BufferCount = 1;
+        swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+        swapChainDesc.Flags = 0;
+        hr = factory->CreateSwapChainForHwnd(m_device.Get(), hwnd, &swapChainDesc, &fullscreenDesc,
+                                             nullptr, &m_swapChain);
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create swap chain");
+            return false;
+        }
+    }
+    m_swapChainFlags = swapChainDesc.Flags;
+
+    ComPtr<IDXGISwapChain2> swapChain2;
+    if (m_flipModel && SUCCEEDED(m_swapChain.As(&swapChain2))) {
+        swapChain2->SetMaximumFrameLatency(m_maxFrameLatency);
+        m_frameLatencyWaitable = swapChain2->GetFrameLatencyWaitableObject();
+    }
+    else {
+        dxgiDevice->SetMaximumFrameLatency(m_maxFrameLatency);
+    }
+
+    LOG_INFO("Swap chain: " << (m_flipModel ? "flip" : "blt") << " model, tearing "
+             << (m_tearingSupported ? "supported" : "unsupported")
+             << ", frame latency " << m_maxFrameLatency);
     return true;
 }
 
@@ -450,18 +1049,36 @@ bool D3D11Renderer::CreateDepthStencilBuffer() {
     depthStencilDesc.Height = m_screenHeight;
     depthStencilDesc.MipLevels = 1;
     depthStencilDesc.ArraySize = 1;
-    depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    // Typeless so occlusion culling can read depth back through a view
+    depthStencilDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
     depthStencilDesc.SampleDesc.Count = 1;
     depthStencilDesc.SampleDesc.Quality = 0;
     depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
-    depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+    depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
 
     HRESULT hr = m_device->CreateTexture2D(&depthStencilDesc, nullptr, &m_depthStencilBuffer);
     if (FAILED(hr)) {
         return false;
     }
+    TrackGpuMemory(m_depthStencilBuffer.Get(), Core::MemoryCategory::Renderer);
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+    dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+    dsvDesc.Texture2D.MipSlice = 0;
+
+    hr = m_device->CreateDepthStencilView(m_depthStencilBuffer.Get(), &dsvDesc, &m_depthStencilView);
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = 1;
 
-    hr = m_device->CreateDepthStencilView(m_depthStencilBuffer.Get(), nullptr, &m_depthStencilView);
+    hr = m_device->CreateShaderResourceView(m_depthStencilBuffer.Get(), &srvDesc, &m_depthShaderResourceView);
     return SUCCEEDED(hr);
 }
 
@@ -491,8 +1108,8 @@ bool D3D11Renderer::CreateDefaultStates() {
     rasterizerDesc.ScissorEnable = false;
     rasterizerDesc.SlopeScaledDepthBias = 0.0f;
 
-    HRESULT hr = m_device->CreateRasterizerState(&rasterizerDesc, &m_rasterizerState);
-    if (FAILED(hr)) {
+    m_rasterizerState = m_stateObjects.GetRasterizerState(rasterizerDesc);
+    if (!m_rasterizerState) {
         return false;
     }
 
@@ -505,8 +1122,8 @@ bool D3D11Renderer::CreateDefaultStates() {
     depthStencilDesc.StencilReadMask = 0xFF;
     depthStencilDesc.StencilWriteMask = 0xFF;
 
-    hr = m_device->CreateDepthStencilState(&depthStencilDesc, &m_depthStencilState);
-    if (FAILED(hr)) {
+    m_depthStencilState = m_stateObjects.GetDepthStencilState(depthStencilDesc);
+    if (!m_depthStencilState) {
         return false;
     }
 
@@ -515,52 +1132,88 @@ bool D3D11Renderer::CreateDefaultStates() {
     blendDesc.RenderTarget[0].BlendEnable = FALSE;
     blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-    hr = m_device->CreateBlendState(&blendDesc, &m_blendState);
-    return SUCCEEDED(hr);
+    m_blendState = m_stateObjects.GetBlendState(blendDesc);
+    if (!m_blendState) {
+        return false;
+    }
+
+    m_defaultSampler = CreateSamplerState();
+    return m_defaultSampler != nullptr;
+}
+
+ComPtr<ID3D11SamplerState> D3D11Renderer::CreateSamplerState() {
+    // Trilinear wrap, shared with every other request for the same description
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+    samplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+    return m_stateObjects.GetSamplerState(samplerDesc);
 }
 
 void D3D11Renderer::CleanupRenderTargets() {
     m_context->OMSetRenderTargets(0, nullptr, nullptr);
     m_renderTargetView.Reset();
     m_depthStencilView.Reset();
+    m_depthShaderResourceView.Reset();
     m_depthStencilBuffer.Reset();
 }
 
-void D3D11Renderer::UpdateLightBuffer(const LightManager& lightManager, const Math::Vector3& cameraPosition) {
+void D3D11Renderer::UpdateLightBuffer(LightManager& lightManager, const Math::Vector3& cameraPosition) {
     if (!m_lightBuffer || !m_context) {
         LOG_WARNING("Light buffer or context is null");
         return;
     }
 
-    // Prepare light data for shaders
-    auto lightData = lightManager.PrepareShaderData(8); // Max 8 lights for demo
-
-    if (lightData.empty()) {
-        // No lights, set default ambient
-        LightBuffer defaultBuffer = {};
-        defaultBuffer.ambientLight = DirectX::XMFLOAT4(0.1f, 0.1f, 0.15f, 0.3f);
-
-        D3D11_MAPPED_SUBRESOURCE mappedResource;
-        HRESULT hr = m_context->Map(m_lightBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        if (SUCCEEDED(hr)) {
-            memcpy(mappedResource.pData, &defaultBuffer, sizeof(LightBuffer));
-            m_context->Unmap(m_lightBuffer.Get(), 0);
+    DirectX::XMMATRIX view = m_viewMatrix.ToXMMATRIX();
+    DirectX::XMMATRIX projection = m_projectionMatrix.ToXMMATRIX();
+
+    // Every visible light, assigned to view-space clusters
+    lightManager.CullLights(view, projection);
+    m_frameStats.lightsVisible += static_cast<UINT>(lightManager.GetVisibleLightCount());
+    m_frameStats.lightsCulled += static_cast<UINT>(lightManager.GetLightCount() - lightManager.GetVisibleLightCount());
+
+    // Atlas tiles for the visible shadowed lights; the scene's Shadows pass
+    // draws the dirty ones before anything is lit
+    m_shadowAtlas->BeginFrame();
+    for (size_t i = 0; i < lightManager.GetVisibleLightCount(); i++) {
+        const Light* light = lightManager.GetVisibleLight(i);
+        if (light->IsCastingShadows() && light->GetType() != LightType::Point) {
+            m_shadowAtlas->Request(light);
         }
+    }
+
+    auto lightData = lightManager.PrepareShaderData(MAX_CLUSTERED_LIGHTS, m_shadowAtlas.get());
+    m_clusteredLighting->Build(lightData, view, projection,
+                               static_cast<UINT>(m_screenWidth), static_cast<UINT>(m_screenHeight));
+    if (!m_clusteredLighting->Upload(m_device.Get(), m_context.Get())) {
         return;
     }
 
-    // Use first light for now (can be extended for multiple lights)
-    const auto& firstLight = lightData[0];
+    // One map per non-empty clustered list
+    const UINT clusteredLights = m_clusteredLighting->GetLightCount();
+    const UINT clusteredIndices = m_clusteredLighting->GetLightIndexCount();
+    if (clusteredLights > 0) {
+        RecordBufferMap(clusteredLights * static_cast<UINT>(sizeof(LightData)));
+    }
+    RecordBufferMap(ClusteredLighting::CLUSTER_COUNT * static_cast<UINT>(sizeof(DirectX::XMUINT2)));
+    if (clusteredIndices > 0) {
+        RecordBufferMap(clusteredIndices * static_cast<UINT>(sizeof(std::uint32_t)));
+    }
 
     LightBuffer lightBuffer = {};
-
-    // Convert LightData to LightBuffer format
-    lightBuffer.lightDirection = firstLight.direction;
-    lightBuffer.lightColor = firstLight.color;
-    lightBuffer.lightPosition = firstLight.position;
-    lightBuffer.lightParams = firstLight.shadowParams;
-    lightBuffer.lightSpaceMatrix = firstLight.lightSpaceMatrix;
     lightBuffer.ambientLight = DirectX::XMFLOAT4(0.1f, 0.1f, 0.15f, 0.3f);
+    lightBuffer.cameraPosition = DirectX::XMFLOAT4(cameraPosition.x, cameraPosition.y, cameraPosition.z, 0.0f);
+    lightBuffer.clusterCounts = DirectX::XMUINT4(ClusteredLighting::CLUSTERS_X, ClusteredLighting::CLUSTERS_Y,
+                                                 ClusteredLighting::CLUSTERS_Z,
+                                                 m_clusteredLighting->GetDirectionalLightCount());
+    lightBuffer.clusterParams = DirectX::XMFLOAT4(m_clusteredLighting->GetDepthSliceScale(),
+                                                  m_clusteredLighting->GetDepthSliceBias(),
+                                                  m_clusteredLighting->GetTileScale().x,
+                                                  m_clusteredLighting->GetTileScale().y);
 
     // Map and update the buffer
     D3D11_MAPPED_SUBRESOURCE mappedResource;
@@ -568,11 +1221,13 @@ void D3D11Renderer::UpdateLightBuffer(const LightManager& lightManager, const Ma
     if (SUCCEEDED(hr)) {
         memcpy(mappedResource.pData, &lightBuffer, sizeof(LightBuffer));
         m_context->Unmap(m_lightBuffer.Get(), 0);
+        RecordBufferMap(sizeof(LightBuffer));
 
-        // Bind to pixel shader (slot 1, after constant buffer)
-        m_context->PSSetConstantBuffers(1, 1, m_lightBuffer.GetAddressOf());
-
-        LOG_DEBUG("Light buffer updated successfully");
+        // Bind to pixel shader (slot 1, after constant buffer), lights after the material textures
+        SetConstantBuffer(m_lightBuffer.Get(), LIGHT_CONSTANT_SLOT, false, true);
+        m_clusteredLighting->Bind(m_context.Get());
+        m_shadowAtlas->Bind(m_context.Get());
+        InvalidateStateCache();
     } else {
         LOG_ERROR("Failed to map light buffer");
     }
@@ -580,12 +1235,13 @@ void D3D11Renderer::UpdateLightBuffer(const LightManager& lightManager, const Ma
 
 void D3D11Renderer::SetVSync(bool enabled) {
     m_vsyncEnabled = enabled;
+    UpdateFrameLimiter();
     LOG_INFO("VSync " << (enabled ? "enabled" : "disabled"));
 }
 
 void D3D11Renderer::SetMaxFPS(int maxFPS) {
     m_maxFPS = maxFPS;
-    m_lastFrameTime = std::chrono::high_resolution_clock::now();
+    UpdateFrameLimiter();
 
     if (maxFPS <= 0) {
         LOG_INFO("FPS limiting disabled");
@@ -594,5 +1250,33 @@ void D3D11Renderer::SetMaxFPS(int maxFPS) {
     }
 }
 
+void D3D11Renderer::SetProfilerOverlayEnabled(bool enabled) {
+    m_profilerOverlayEnabled = enabled && m_profilerOverlay.IsInitialized();
+    if (m_profilerOverlayEnabled) {
+        m_profilerOverlay.LogLegend(PROFILER.GetFrameStats(), MEMORY_TRACKER.TakeSnapshot());
+    }
+}
+
+void D3D11Renderer::SetMaxFrameLatency(int frames) {
+    m_maxFrameLatency = static_cast<UINT>(std::max(frames, 1));
+    if (!m_swapChain) {
+        return;
+    }
+
+    ComPtr<IDXGISwapChain2> swapChain2;
+    ComPtr<IDXGIDevice1> dxgiDevice;
+    if (m_frameLatencyWaitable && SUCCEEDED(m_swapChain.As(&swapChain2))) {
+        swapChain2->SetMaximumFrameLatency(m_maxFrameLatency);
+    }
+    else if (SUCCEEDED(m_device.As(&dxgiDevice))) {
+        dxgiDevice->SetMaximumFrameLatency(m_maxFrameLatency);
+    }
+}
+
+void D3D11Renderer::UpdateFrameLimiter() {
+    // VSync already paces presentation to the display
+    m_frameLimiter.SetTargetFPS(m_vsyncEnabled ? 0 : m_maxFPS);
+}
+
 } // namespace Renderer
 } // namespace GameEngine
@@ -1,48 +1,86 @@
 #pragma once
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <d3dcompiler.h>
-#include <dxgi.h>
+#include <dxgi1_5.h>
 #include <DirectXMath.h>
 #include <wrl/client.h>
 #include <string>
 #include <memory>
-#include <chrono>
 #include "../Math/Matrix4.h"
 #include "../Math/Vector3.h"
 #include "Light.h"
 #include "ShadowMap.h"
+#include "ShadowAtlas.h"
+#include "ClusteredLighting.h"
+#include "DeferredShading.h"
+#include "FrameGraph.h"
+#include "TransientTexturePool.h"
+#include "DeferredContextPool.h"
+#include "ConstantBufferRing.h"
+#include "ContextStateCache.h"
+#include "StateObjectCache.h"
+#include "ShaderCache.h"
+#include "FrameLimiter.h"
+#include "GpuProfiler.h"
+#include "ProfilerOverlay.h"
+#include "RenderStats.h"
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 
 namespace GameEngine {
+
+// Forward declarations
+namespace Mesh {
+    class Material;
+    struct VertexLayoutDesc;
+    struct VertexInputLayouts;
+}
+
 namespace Renderer {
 
 using Microsoft::WRL::ComPtr;
 
-struct ConstantBuffer {
+// Per-object constants (b0); static objects keep theirs in a StaticConstantBuffer
+struct ObjectConstants {
     DirectX::XMMATRIX World;
+};
+
+// Per-view constants (b2), written once per pass rather than per draw
+struct ViewConstants {
     DirectX::XMMATRIX View;
     DirectX::XMMATRIX Projection;
 };
 
+// Legacy per-draw bone constants for SkinnedVertexShader; the render queue
+// uses BonePalette instead, which has no bone limit
 struct BoneBuffer {
     DirectX::XMMATRIX BoneTransforms[100]; // Max 100 bones
 };
 
-// Light buffer for shaders
+// Light buffer for shaders; the lights themselves are in the clustered
+// lighting StructuredBuffers
 struct LightBuffer {
-    DirectX::XMFLOAT4 lightDirection;    // w = light type
-    DirectX::XMFLOAT4 lightColor;        // w = intensity
-    DirectX::XMFLOAT4 lightPosition;     // w = range
-    DirectX::XMFLOAT4 lightParams;       // x = inner cone, y = outer cone, z = shadow bias, w = shadow strength
-    DirectX::XMFLOAT4X4 lightSpaceMatrix;
     DirectX::XMFLOAT4 ambientLight;      // w = ambient intensity
+    DirectX::XMFLOAT4 cameraPosition;    // w unused, specular power is per material
+    DirectX::XMUINT4 clusterCounts;      // xyz = clusters per axis, w = directional light count
+    DirectX::XMFLOAT4 clusterParams;     // x = depth slice scale, y = depth slice bias, zw = tiles per pixel
 };
 
 class D3D11Renderer {
 public:
+    // Upper bound on lights handed to clustered shading each frame
+    static constexpr size_t MAX_CLUSTERED_LIGHTS = 4096;
+
+    // Constant buffer slots shared by the engine's shaders
+    static constexpr UINT OBJECT_CONSTANT_SLOT = 0;
+    static constexpr UINT BONE_CONSTANT_SLOT = 1;     // Vertex shader
+    static constexpr UINT LIGHT_CONSTANT_SLOT = 1;    // Pixel shader
+    static constexpr UINT VIEW_CONSTANT_SLOT = 2;
+    static constexpr UINT MATERIAL_CONSTANT_SLOT = 3; // Pixel shader
+
     D3D11Renderer();
     ~D3D11Renderer();
 
@@ -56,12 +94,40 @@ public:
     // Resource creation
     ComPtr<ID3D11Buffer> CreateVertexBuffer(const void* data, UINT size, bool dynamic = false);
     ComPtr<ID3D11Buffer> CreateIndexBuffer(const UINT* indices, UINT count);
+    // format is DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT
+    ComPtr<ID3D11Buffer> CreateIndexBuffer(const void* indices, UINT count, DXGI_FORMAT format);
     ComPtr<ID3D11Buffer> CreateConstantBuffer(UINT size);
 
-    // Shader management
+    // Buffers that compute shaders can address as ByteAddressBuffer / RWByteAddressBuffer
+    ComPtr<ID3D11Buffer> CreateRawBuffer(const void* data, UINT size, UINT bindFlags);
+    ComPtr<ID3D11ShaderResourceView> CreateRawShaderResourceView(ID3D11Buffer* buffer, UINT size);
+    ComPtr<ID3D11UnorderedAccessView> CreateRawUnorderedAccessView(ID3D11Buffer* buffer, UINT size);
+
+    // StructuredBuffer / RWStructuredBuffer of elementCount elements
+    ComPtr<ID3D11Buffer> CreateStructuredBuffer(const void* data, UINT elementSize, UINT elementCount,
+                                                UINT bindFlags = D3D11_BIND_SHADER_RESOURCE);
+    ComPtr<ID3D11ShaderResourceView> CreateStructuredShaderResourceView(ID3D11Buffer* buffer, UINT elementCount);
+    ComPtr<ID3D11UnorderedAccessView> CreateStructuredUnorderedAccessView(ID3D11Buffer* buffer, UINT elementCount);
+
+    // DrawIndexedInstancedIndirect arguments, writable by compute shaders
+    // through a raw UAV
+    ComPtr<ID3D11Buffer> CreateIndirectArgsBuffer(const D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS* args, UINT drawCount);
+
+    // Shader management. Bytecode comes from the shader cache; features
+    // selects a permutation (ShaderFeature bits, compiled as defines).
     bool LoadVertexShader(const std::wstring& filename, ComPtr<ID3D11VertexShader>& shader,
-                         ComPtr<ID3D11InputLayout>& layout, const D3D11_INPUT_ELEMENT_DESC* elements, UINT elementCount);
-    bool LoadPixelShader(const std::wstring& filename, ComPtr<ID3D11PixelShader>& shader);
+                         ComPtr<ID3D11InputLayout>& layout, const D3D11_INPUT_ELEMENT_DESC* elements, UINT elementCount,
+                         std::uint32_t features = ShaderFeature::None);
+    // Compile once and create a layout for every vertex format in the table
+    // (one entry per Mesh::VertexFormat, e.g. Mesh::StaticVertexLayouts)
+    bool LoadVertexShader(const std::wstring& filename, ComPtr<ID3D11VertexShader>& shader,
+                         Mesh::VertexInputLayouts& layouts, const Mesh::VertexLayoutDesc* formatLayouts,
+                         std::uint32_t features = ShaderFeature::None);
+    bool LoadPixelShader(const std::wstring& filename, ComPtr<ID3D11PixelShader>& shader,
+                         std::uint32_t features = ShaderFeature::None);
+    bool LoadComputeShader(const std::wstring& filename, ComPtr<ID3D11ComputeShader>& shader,
+                           std::uint32_t features = ShaderFeature::None);
+    ShaderCache& GetShaderCache() { return m_shaderCache; }
 
     // Texture management
     ComPtr<ID3D11ShaderResourceView> LoadTexture(const std::wstring& filename);
@@ -70,23 +136,61 @@ public:
     // State management
     void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
     void SetVertexBuffer(ID3D11Buffer* buffer, UINT stride, UINT offset = 0);
+    void SetInstanceBuffer(ID3D11Buffer* buffer, UINT stride, UINT slot = 1);
     void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format = DXGI_FORMAT_R32_UINT);
     void SetVertexShader(ID3D11VertexShader* shader, ID3D11InputLayout* layout);
     void SetPixelShader(ID3D11PixelShader* shader);
     void SetConstantBuffer(ID3D11Buffer* buffer, UINT slot, bool vertex = true, bool pixel = true);
     void SetTexture(ID3D11ShaderResourceView* texture, UINT slot);
     void SetSampler(ID3D11SamplerState* sampler, UINT slot);
+    void SetRasterizerState(ID3D11RasterizerState* state);
+    void SetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef = 1);
+    void SetBlendState(ID3D11BlendState* state);
+
+    // The setters above go through a shadow copy of the immediate context's
+    // state and skip redundant binds. Code that binds on GetContext()
+    // directly must call InvalidateStateCache() when it is done.
+    ContextStateCache& GetStateCache() { return m_stateCache; }
+    void InvalidateStateCache() { m_stateCache.Reset(m_context.Get()); }
+    UINT GetRedundantBindCount() const { return m_stateCache.GetRedundantBindCount(); }
+
+    // Default properties and a white diffuse map, applied for draws without a
+    // material so they do not inherit the previous draw's
+    Mesh::Material* GetDefaultMaterial() const { return m_defaultMaterial.get(); }
+
+    // Shared state objects keyed by description
+    StateObjectCache& GetStateObjects() { return m_stateObjects; }
 
     // Drawing
     void DrawIndexed(UINT indexCount, UINT startIndex = 0, INT baseVertex = 0);
+    void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex = 0,
+                              INT baseVertex = 0, UINT startInstance = 0);
     void Draw(UINT vertexCount, UINT startVertex = 0);
 
-    // Matrix operations
+    // Matrix operations. Object constants come from the per-frame constant
+    // ring when the device supports offsets, view constants are only
+    // rewritten when they change.
     void UpdateConstantBuffer(const Math::Matrix4& world, const Math::Matrix4& view, const Math::Matrix4& projection);
+    void UpdateViewConstants(const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& projection);
     void UpdateBoneBuffer(const DirectX::XMMATRIX* boneTransforms, UINT boneCount);
+    // Fallback per-draw object constants when the ring is unavailable
+    ID3D11Buffer* GetMatrixBuffer() const { return m_matrixBuffer.Get(); }
+    ID3D11Buffer* GetViewBuffer() const { return m_viewBuffer.Get(); }
+
+    // Per-frame upload heap for constants, reset by BeginFrame
+    ConstantBufferRing& GetConstantRing() { return m_constantRing; }
+
+    // Camera matrices used by scene rendering
+    void SetViewProjection(const Math::Matrix4& view, const Math::Matrix4& projection) {
+        m_viewMatrix = view;
+        m_projectionMatrix = projection;
+    }
+    const Math::Matrix4& GetViewMatrix() const { return m_viewMatrix; }
+    const Math::Matrix4& GetProjectionMatrix() const { return m_projectionMatrix; }
 
     // ✨ NEW: Light and Shadow system integration
-    void UpdateLightBuffer(const LightManager& lightManager, const Math::Vector3& cameraPosition);
+    // Culls lightManager against the camera, then uploads the visible lights
+    void UpdateLightBuffer(LightManager& lightManager, const Math::Vector3& cameraPosition);
     void SetLightBuffer(ID3D11Buffer* lightBuffer, UINT slot = 1);
 
     // Shadow rendering
@@ -94,19 +198,65 @@ public:
     void EndShadowPass();
     void SetShadowMap(ID3D11ShaderResourceView* shadowMap, UINT slot = 1);
 
+    // Deferred contexts for recording command lists on worker threads
+    DeferredContextPool& GetDeferredContexts() { return *m_deferredContexts; }
+
     // Light management
     LightManager& GetLightManager() { return *m_lightManager; }
     ShadowMapManager& GetShadowMapManager() { return *m_shadowMapManager; }
+    ShadowAtlas& GetShadowAtlas() { return *m_shadowAtlas; }
+    const ClusteredLighting& GetClusteredLighting() const { return *m_clusteredLighting; }
+    // Light constants written by UpdateLightBuffer
+    ID3D11Buffer* GetLightBuffer() const { return m_lightBuffer.Get(); }
+
+    // Forward, depth prepass or deferred; scenes drive the passes through GetDeferredShading
+    void SetRenderPath(RenderPath path) { m_deferredShading->SetRenderPath(this, path); }
+    RenderPath GetRenderPath() const { return m_deferredShading->GetRenderPath(); }
+    DeferredShading& GetDeferredShading() { return *m_deferredShading; }
+
+    // Scenes build the frame's passes into the graph and execute it against
+    // the transient pool; textures unused for a few frames are freed in EndFrame
+    FrameGraph& GetFrameGraph() { return m_frameGraph; }
+    TransientTexturePool& GetTransientTextures() { return m_transientTextures; }
 
     // Performance settings
     void SetVSync(bool enabled);
     bool GetVSync() const { return m_vsyncEnabled; }
     void SetMaxFPS(int maxFPS);
     int GetMaxFPS() const { return m_maxFPS; }
+    // Frames the CPU may queue ahead of the display
+    void SetMaxFrameLatency(int frames);
+    int GetMaxFrameLatency() const { return static_cast<int>(m_maxFrameLatency); }
+
+    // Call before sampling input for a frame: waits until the swap chain can
+    // take another frame, then for the frame limiter's slot, so the frame is
+    // simulated against the freshest input
+    void WaitForFrame();
+
+    // Frame timing bars drawn over the back buffer in EndFrame
+    void SetProfilerOverlayEnabled(bool enabled);
+    bool IsProfilerOverlayEnabled() const { return m_profilerOverlayEnabled; }
+
+    // Per-frame statistics, collected between BeginFrame and EndFrame. Draws
+    // and maps issued through the renderer are counted already; code that
+    // draws or maps on a context directly reports them with AddFrameStats
+    // (from the render thread). Logged every interval seconds, 0 disables.
+    const RenderFrameStats& GetLastFrameStats() const { return m_lastFrameStats; }
+    void AddFrameStats(const RenderFrameStats& stats);
+    void RecordBufferMap(UINT bytes);
+    void SetStatsLogInterval(float seconds);
+    float GetStatsLogInterval() const { return m_statsLogInterval; }
+
+    bool IsFlipModel() const { return m_flipModel; }
+    bool IsTearingSupported() const { return m_tearingSupported; }
 
     // Getters
     ID3D11Device* GetDevice() const { return m_device.Get(); }
     ID3D11DeviceContext* GetContext() const { return m_context.Get(); }
+    // D3D11.1 interface of the immediate context, null on older runtimes
+    ID3D11DeviceContext1* GetContext1() const { return m_context1.Get(); }
+    // Scene depth as a shader resource; unbind the depth target before reading it
+    ID3D11ShaderResourceView* GetDepthShaderResourceView() const { return m_depthShaderResourceView.Get(); }
     int GetWidth() const { return m_screenWidth; }
     int GetHeight() const { return m_screenHeight; }
     bool IsInitialized() const { return m_initialized; }
@@ -115,25 +265,55 @@ private:
     // Core DirectX objects
     ComPtr<ID3D11Device> m_device;
     ComPtr<ID3D11DeviceContext> m_context;
-    ComPtr<IDXGISwapChain> m_swapChain;
+    ComPtr<ID3D11DeviceContext1> m_context1;
+    ComPtr<IDXGISwapChain1> m_swapChain;
+    ComPtr<IDXGIAdapter3> m_adapter;  // For the OS video memory budget; null before Windows 10
+    HANDLE m_frameLatencyWaitable;    // Null without a waitable flip-model swap chain
+    UINT m_swapChainFlags;
+    bool m_flipModel;
+    bool m_tearingSupported;
     ComPtr<ID3D11RenderTargetView> m_renderTargetView;
     ComPtr<ID3D11DepthStencilView> m_depthStencilView;
     ComPtr<ID3D11Texture2D> m_depthStencilBuffer;
+    ComPtr<ID3D11ShaderResourceView> m_depthShaderResourceView;
 
     // States
     ComPtr<ID3D11RasterizerState> m_rasterizerState;
     ComPtr<ID3D11DepthStencilState> m_depthStencilState;
     ComPtr<ID3D11BlendState> m_blendState;
     ComPtr<ID3D11SamplerState> m_defaultSampler;
+    StateObjectCache m_stateObjects;
+    ShaderCache m_shaderCache;
+    ContextStateCache m_stateCache;
 
     // Constant buffers
     ComPtr<ID3D11Buffer> m_matrixBuffer;
+    ComPtr<ID3D11Buffer> m_viewBuffer;
     ComPtr<ID3D11Buffer> m_boneBuffer;
     ComPtr<ID3D11Buffer> m_lightBuffer;
+    std::shared_ptr<Mesh::Material> m_defaultMaterial;
+    ConstantBufferRing m_constantRing;
+
+    // Last view constants written, to skip redundant uploads
+    DirectX::XMFLOAT4X4 m_uploadedView;
+    DirectX::XMFLOAT4X4 m_uploadedProjection;
+    bool m_viewConstantsValid;
 
     // ✨ NEW: Light and Shadow managers
     std::unique_ptr<LightManager> m_lightManager;
     std::unique_ptr<ShadowMapManager> m_shadowMapManager;
+    std::unique_ptr<ShadowAtlas> m_shadowAtlas;
+    std::unique_ptr<ClusteredLighting> m_clusteredLighting;
+    std::unique_ptr<DeferredShading> m_deferredShading;
+    FrameGraph m_frameGraph;
+    TransientTexturePool m_transientTextures;
+
+    // One deferred context per job system thread
+    std::unique_ptr<DeferredContextPool> m_deferredContexts;
+
+    // Camera
+    Math::Matrix4 m_viewMatrix;
+    Math::Matrix4 m_projectionMatrix;
 
     // Viewport and screen info
     D3D11_VIEWPORT m_viewport;
@@ -144,10 +324,23 @@ private:
 
     // Performance settings
     int m_maxFPS;
-    std::chrono::high_resolution_clock::time_point m_lastFrameTime;
+    UINT m_maxFrameLatency;
+    FrameLimiter m_frameLimiter;
+
+    // Profiling
+    ProfilerOverlay m_profilerOverlay;
+    bool m_profilerOverlayEnabled;
+
+    // Render statistics
+    RenderFrameStats m_frameStats;
+    RenderFrameStats m_lastFrameStats;
+    float m_statsLogInterval;
+    std::int64_t m_lastStatsLogTime;
 
     // Helper methods
     bool CreateDeviceAndSwapChain(HWND hwnd, bool fullscreen);
+    bool CreateSwapChain(HWND hwnd, bool fullscreen);
+    void UpdateFrameLimiter();
     bool CreateRenderTargetView();
     bool CreateDepthStencilBuffer();
     bool CreateStates();
@@ -155,6 +348,12 @@ private:
     bool CreateViewport();
     bool CreateDefaultStates();
     void CleanupRenderTargets();
+    void RecordDraw(UINT indexCount, UINT instanceCount);
+    void FinishFrameStats();
+    void UpdateVideoMemoryInfo();
+    void LogFrameStats() const;
+    bool CompileVertexShader(const std::wstring& filename, std::uint32_t features, ComPtr<ID3D11VertexShader>& shader,
+                             ShaderBytecode& bytecode);
 };
 
 } // namespace Renderer
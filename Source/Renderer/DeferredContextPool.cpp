@@ -0,0 +1,168 @@
+#include "DeferredContextPool.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Logger.h"
+#include <atomic>
+
+namespace GameEngine {
+namespace Renderer {
+
+void PipelineStateSnapshot::Capture(ID3D11DeviceContext* context) {
+    *this = PipelineStateSnapshot();
+
+    context->OMGetRenderTargets(1, renderTarget.GetAddressOf(), depthStencil.GetAddressOf());
+    viewportCount = 1;
+    context->RSGetViewports(&viewportCount, &viewport);
+
+    context->RSGetState(rasterizerState.GetAddressOf());
+    context->OMGetDepthStencilState(depthStencilState.GetAddressOf(), &stencilRef);
+    context->OMGetBlendState(blendState.GetAddressOf(), blendFactor, &sampleMask);
+
+    context->IAGetPrimitiveTopology(&topology);
+    context->VSGetShader(vertexShader.GetAddressOf(), nullptr, nullptr);
+    context->IAGetInputLayout(inputLayout.GetAddressOf());
+    context->PSGetShader(pixelShader.GetAddressOf(), nullptr, nullptr);
+
+    for (UINT i = 0; i < BUFFER_SLOTS; i++) {
+        context->VSGetConstantBuffers(i, 1, vsConstantBuffers[i].GetAddressOf());
+        context->PSGetConstantBuffers(i, 1, psConstantBuffers[i].GetAddressOf());
+    }
+    for (UINT i = 0; i < TEXTURE_SLOTS; i++) {
+        context->PSGetShaderResources(i, 1, psTextures[i].GetAddressOf());
+    }
+    for (UINT i = 0; i < SAMPLER_SLOTS; i++) {
+        context->PSGetSamplers(i, 1, psSamplers[i].GetAddressOf());
+    }
+}
+
+void PipelineStateSnapshot::Apply(ID3D11DeviceContext* context) const {
+    ID3D11RenderTargetView* renderTargets[] = { renderTarget.Get() };
+    context->OMSetRenderTargets(renderTarget ? 1 : 0, renderTarget ? renderTargets : nullptr, depthStencil.Get());
+    if (viewportCount > 0) {
+        context->RSSetViewports(1, &viewport);
+    }
+
+    context->RSSetState(rasterizerState.Get());
+    context->OMSetDepthStencilState(depthStencilState.Get(), stencilRef);
+    context->OMSetBlendState(blendState.Get(), blendFactor, sampleMask);
+
+    context->IASetPrimitiveTopology(topology);
+    context->VSSetShader(vertexShader.Get(), nullptr, 0);
+    context->IASetInputLayout(inputLayout.Get());
+    context->PSSetShader(pixelShader.Get(), nullptr, 0);
+
+    for (UINT i = 0; i < BUFFER_SLOTS; i++) {
+        ID3D11Buffer* vsBuffer = vsConstantBuffers[i].Get();
+        ID3D11Buffer* psBuffer = psConstantBuffers[i].Get();
+        context->VSSetConstantBuffers(i, 1, &vsBuffer);
+        context->PSSetConstantBuffers(i, 1, &psBuffer);
+    }
+    for (UINT i = 0; i < TEXTURE_SLOTS; i++) {
+        ID3D11ShaderResourceView* texture = psTextures[i].Get();
+        context->PSSetShaderResources(i, 1, &texture);
+    }
+    for (UINT i = 0; i < SAMPLER_SLOTS; i++) {
+        ID3D11SamplerState* sampler = psSamplers[i].Get();
+        context->PSSetSamplers(i, 1, &sampler);
+    }
+}
+
+DeferredContextPool::DeferredContextPool()
+    : m_driverCommandLists(false)
+{
+}
+
+DeferredContextPool::~DeferredContextPool() {
+    Shutdown();
+}
+
+bool DeferredContextPool::Initialize(ID3D11Device* device, UINT contextCount) {
+    Shutdown();
+
+    if (!device || contextCount == 0) {
+        return false;
+    }
+
+    D3D11_FEATURE_DATA_THREADING threading = {};
+    if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading)))) {
+        m_driverCommandLists = threading.DriverCommandLists == TRUE;
+    }
+
+    m_slots.resize(contextCount);
+    for (UINT i = 0; i < contextCount; i++) {
+        HRESULT hr = device->CreateDeferredContext(0, m_slots[i].context.GetAddressOf());
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create deferred context " << i << ": " << std::hex << hr);
+            Shutdown();
+            return false;
+        }
+    }
+
+    LOG_INFO("Created " << contextCount << " deferred contexts (driver command lists: "
+             << (m_driverCommandLists ? "yes" : "emulated") << ")");
+    return true;
+}
+
+void DeferredContextPool::Shutdown() {
+    m_slots.clear();
+    m_snapshot = PipelineStateSnapshot();
+}
+
+ID3D11DeviceContext* DeferredContextPool::BeginRecording(UINT index) {
+    if (index >= m_slots.size()) {
+        return nullptr;
+    }
+
+    Slot& slot = m_slots[index];
+    slot.commandList.Reset();
+
+    ID3D11DeviceContext* context = slot.context.Get();
+    m_snapshot.Apply(context);
+    slot.stateCache.Reset(context);
+    return context;
+}
+
+bool DeferredContextPool::FinishRecording(UINT index) {
+    if (index >= m_slots.size()) {
+        return false;
+    }
+
+    Slot& slot = m_slots[index];
+    HRESULT hr = slot.context->FinishCommandList(FALSE, slot.commandList.ReleaseAndGetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to finish command list " << index);
+        return false;
+    }
+    return true;
+}
+
+bool DeferredContextPool::Record(UINT count, const RecordFunc& record) {
+    if (count > m_slots.size()) {
+        LOG_ERROR("Requested " << count << " command lists but only " << m_slots.size() << " deferred contexts exist");
+        return false;
+    }
+
+    std::atomic<bool> succeeded(true);
+    JOB_SYSTEM.ParallelFor(count, [&](std::uint32_t begin, std::uint32_t end) {
+        for (std::uint32_t i = begin; i < end; i++) {
+            ID3D11DeviceContext* context = BeginRecording(i);
+            record(i, context, m_slots[i].stateCache);
+            if (!FinishRecording(i)) {
+                succeeded = false;
+            }
+        }
+    }, 1);
+
+    return succeeded;
+}
+
+void DeferredContextPool::ExecuteCommandLists(ID3D11DeviceContext* immediateContext, bool restoreState) {
+    for (auto& slot : m_slots) {
+        if (slot.commandList) {
+            immediateContext->ExecuteCommandList(slot.commandList.Get(), restoreState ? TRUE : FALSE);
+            slot.commandList.Reset();
+        }
+    }
+}
+
+} // namespace Renderer
+} // namespace GameEngine
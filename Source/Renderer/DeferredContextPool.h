@@ -0,0 +1,95 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <functional>
+#include <vector>
+#include "ContextStateCache.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+using Microsoft::WRL::ComPtr;
+
+// Pipeline state copied from the immediate context into each deferred
+// context, since deferred contexts start out with default state.
+struct PipelineStateSnapshot {
+    static constexpr UINT BUFFER_SLOTS = 4;
+    static constexpr UINT TEXTURE_SLOTS = 8;
+    static constexpr UINT SAMPLER_SLOTS = 2;
+
+    ComPtr<ID3D11RenderTargetView> renderTarget;
+    ComPtr<ID3D11DepthStencilView> depthStencil;
+    D3D11_VIEWPORT viewport = {};
+    UINT viewportCount = 0;
+
+    ComPtr<ID3D11RasterizerState> rasterizerState;
+    ComPtr<ID3D11DepthStencilState> depthStencilState;
+    UINT stencilRef = 0;
+    ComPtr<ID3D11BlendState> blendState;
+    float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    UINT sampleMask = 0xffffffff;
+
+    D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+    ComPtr<ID3D11VertexShader> vertexShader;
+    ComPtr<ID3D11InputLayout> inputLayout;
+    ComPtr<ID3D11PixelShader> pixelShader;
+
+    ComPtr<ID3D11Buffer> vsConstantBuffers[BUFFER_SLOTS];
+    ComPtr<ID3D11Buffer> psConstantBuffers[BUFFER_SLOTS];
+    ComPtr<ID3D11ShaderResourceView> psTextures[TEXTURE_SLOTS];
+    ComPtr<ID3D11SamplerState> psSamplers[SAMPLER_SLOTS];
+
+    void Capture(ID3D11DeviceContext* context);
+    void Apply(ID3D11DeviceContext* context) const;
+};
+
+// Called on a worker thread with the slot index, its deferred context and
+// that context's state cache
+using RecordFunc = std::function<void(UINT index, ID3D11DeviceContext* context, ContextStateCache& stateCache)>;
+
+// A fixed set of deferred contexts for recording command lists on worker
+// threads. Lists are always played back in slot order, so splitting a pass
+// across slots keeps the original draw order.
+class DeferredContextPool {
+public:
+    DeferredContextPool();
+    ~DeferredContextPool();
+
+    bool Initialize(ID3D11Device* device, UINT contextCount);
+    void Shutdown();
+
+    bool IsAvailable() const { return !m_slots.empty(); }
+    UINT GetContextCount() const { return static_cast<UINT>(m_slots.size()); }
+
+    // False when the driver emulates command lists; recording still works but gains less
+    bool HasDriverCommandLists() const { return m_driverCommandLists; }
+
+    // Snapshot the immediate context; each recording starts from this state
+    void CaptureState(ID3D11DeviceContext* immediateContext) { m_snapshot.Capture(immediateContext); }
+
+    // Manual recording of one slot, from any single thread
+    ID3D11DeviceContext* BeginRecording(UINT index);
+    bool FinishRecording(UINT index);
+    ContextStateCache& GetStateCache(UINT index) { return m_slots[index].stateCache; }
+
+    // Record slots [0, count) in parallel on the job system
+    bool Record(UINT count, const RecordFunc& record);
+
+    // Play back every finished command list in slot order and release them
+    void ExecuteCommandLists(ID3D11DeviceContext* immediateContext, bool restoreState = true);
+
+private:
+    struct Slot {
+        ComPtr<ID3D11DeviceContext> context;
+        ComPtr<ID3D11CommandList> commandList;
+        ContextStateCache stateCache;
+    };
+
+    std::vector<Slot> m_slots;
+    PipelineStateSnapshot m_snapshot;
+    bool m_driverCommandLists;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
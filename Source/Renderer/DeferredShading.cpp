@@ -0,0 +1,278 @@
+#include "DeferredShading.h"
+#include "D3D11Renderer.h"
+#include "../Core/Logger.h"
+#include "../Core/Profiler.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+RenderPath ParseRenderPath(const std::string& name) {
+    if (name == "DepthPrepass") {
+        return RenderPath::DepthPrepass;
+    }
+    if (name == "Deferred") {
+        return RenderPath::Deferred;
+    }
+    return RenderPath::Forward;
+}
+
+const char* GetRenderPathName(RenderPath path) {
+    switch (path) {
+    case RenderPath::DepthPrepass: return "DepthPrepass";
+    case RenderPath::Deferred: return "Deferred";
+    default: return "Forward";
+    }
+}
+
+DeferredShading::DeferredShading()
+    : m_path(RenderPath::Forward)
+    , m_shadersLoaded(false)
+    , m_prepassDepthState(nullptr)
+    , m_shadingDepthState(nullptr)
+    , m_gBuffer{ FrameGraph::INVALID_RESOURCE, FrameGraph::INVALID_RESOURCE }
+    , m_litTarget(FrameGraph::INVALID_RESOURCE)
+    , m_tileCount(0)
+{
+}
+
+void DeferredShading::SetRenderPath(D3D11Renderer* renderer, RenderPath path) {
+    if (path != RenderPath::Forward && !CreateStates(renderer)) {
+        path = RenderPath::Forward;
+    }
+    if (path == RenderPath::Deferred && !LoadShaders(renderer)) {
+        LOG_WARNING("Deferred shaders unavailable, using a depth prepass instead");
+        path = RenderPath::DepthPrepass;
+    }
+
+    if (path != m_path) {
+        LOG_INFO("Render path: " << GetRenderPathName(path));
+    }
+    m_path = path;
+}
+
+void DeferredShading::AddPasses(FrameGraph& graph, D3D11Renderer* renderer, FrameGraph::ResourceHandle sceneColor,
+                                FrameGraph::ResourceHandle sceneDepth, GeometryCallback drawGeometry) {
+    if (m_path == RenderPath::Forward) {
+        graph.AddPass("Shading",
+            [=](FrameGraph::Builder& builder) {
+                builder.Write(sceneColor);
+                builder.Write(sceneDepth);
+            },
+            [=](D3D11Renderer* renderer, const FrameGraph& graph) {
+                ID3D11RenderTargetView* target = graph.GetRenderTargetView(sceneColor);
+                renderer->GetContext()->OMSetRenderTargets(1, &target, graph.GetDepthStencilView(sceneDepth));
+                renderer->InvalidateStateCache();
+                drawGeometry(nullptr, false);
+            });
+        return;
+    }
+
+    // Depth only; no pixel shader runs at all
+    graph.AddPass("DepthPrepass",
+        [=](FrameGraph::Builder& builder) {
+            builder.Write(sceneDepth);
+        },
+        [=](D3D11Renderer* renderer, const FrameGraph& graph) {
+            PROFILE_SCOPE("DepthPrepass");
+            ContextStateCache& stateCache = renderer->GetStateCache();
+            ID3D11PixelShader* savedPixelShader = stateCache.GetPixelShader();
+            ID3D11DepthStencilState* savedDepthState = stateCache.GetDepthStencilState();
+
+            renderer->GetContext()->OMSetRenderTargets(0, nullptr, graph.GetDepthStencilView(sceneDepth));
+            renderer->InvalidateStateCache();
+            renderer->SetPixelShader(nullptr);
+            renderer->SetDepthStencilState(m_prepassDepthState);
+            drawGeometry(nullptr, true);
+
+            renderer->SetPixelShader(savedPixelShader);
+            renderer->SetDepthStencilState(savedDepthState);
+        });
+
+    // Depth is final from here, so only the nearest fragment of each pixel passes
+    auto shade = [this, drawGeometry](D3D11Renderer* renderer, UINT targetCount, ID3D11RenderTargetView* const* targets,
+                                      ID3D11DepthStencilView* depthTarget, ID3D11PixelShader* pixelShader) {
+        ContextStateCache& stateCache = renderer->GetStateCache();
+        ID3D11DepthStencilState* savedDepthState = stateCache.GetDepthStencilState();
+
+        renderer->GetContext()->OMSetRenderTargets(targetCount, targets, depthTarget);
+        renderer->InvalidateStateCache();
+        renderer->SetDepthStencilState(m_shadingDepthState);
+        drawGeometry(pixelShader, false);
+        renderer->SetDepthStencilState(savedDepthState);
+    };
+
+    if (m_path != RenderPath::Deferred) {
+        graph.AddPass("Shading",
+            [=](FrameGraph::Builder& builder) {
+                builder.Read(sceneDepth);
+                builder.Write(sceneColor);
+            },
+            [=](D3D11Renderer* renderer, const FrameGraph& graph) {
+                ID3D11RenderTargetView* target = graph.GetRenderTargetView(sceneColor);
+                shade(renderer, 1, &target, graph.GetDepthStencilView(sceneDepth), nullptr);
+            });
+        return;
+    }
+
+    UINT width = static_cast<UINT>(renderer->GetWidth());
+    UINT height = static_cast<UINT>(renderer->GetHeight());
+
+    // Nothing reads texels no geometry covered, so the targets are not cleared
+    graph.AddPass("GBuffer",
+        [=](FrameGraph::Builder& builder) {
+            const DXGI_FORMAT formats[TARGET_COUNT] = { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT };
+            for (UINT i = 0; i < TARGET_COUNT; i++) {
+                TransientTextureDesc desc;
+                desc.width = width;
+                desc.height = height;
+                desc.format = formats[i];
+                desc.bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+                m_gBuffer[i] = builder.Create(i == ALBEDO_TARGET ? "GBufferAlbedo" : "GBufferNormal", desc);
+            }
+            builder.Read(sceneDepth);
+        },
+        [=](D3D11Renderer* renderer, const FrameGraph& graph) {
+            ID3D11RenderTargetView* targets[TARGET_COUNT] = {
+                graph.GetRenderTargetView(m_gBuffer[ALBEDO_TARGET]), graph.GetRenderTargetView(m_gBuffer[NORMAL_TARGET])
+            };
+            shade(renderer, TARGET_COUNT, targets, graph.GetDepthStencilView(sceneDepth), m_gBufferShader.Get());
+        });
+
+    graph.AddPass("DeferredLighting",
+        [=](FrameGraph::Builder& builder) {
+            builder.Read(m_gBuffer[ALBEDO_TARGET]);
+            builder.Read(m_gBuffer[NORMAL_TARGET]);
+            builder.Read(sceneDepth);
+            builder.Read(sceneColor);
+
+            // Same format as the back buffer so it can be copied both ways
+            TransientTextureDesc desc;
+            desc.width = width;
+            desc.height = height;
+            desc.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            desc.bindFlags = D3D11_BIND_UNORDERED_ACCESS;
+            m_litTarget = builder.Create("DeferredLit", desc);
+            builder.Write(sceneColor);
+        },
+        [=](D3D11Renderer* renderer, const FrameGraph& graph) {
+            Light(renderer, graph, sceneColor, sceneDepth, m_litTarget);
+        });
+}
+
+void DeferredShading::Light(D3D11Renderer* renderer, const FrameGraph& graph, FrameGraph::ResourceHandle sceneColor,
+                            FrameGraph::ResourceHandle sceneDepth, FrameGraph::ResourceHandle lit) {
+    ID3D11DeviceContext* context = renderer->GetContext();
+    ID3D11RenderTargetView* colorTarget = graph.GetRenderTargetView(sceneColor);
+    ID3D11ShaderResourceView* depthView = graph.GetShaderResourceView(sceneDepth);
+    ID3D11UnorderedAccessView* litView = graph.GetUnorderedAccessView(lit);
+    if (!colorTarget || !depthView || !litView) {
+        return;
+    }
+
+    UINT width = static_cast<UINT>(renderer->GetWidth());
+    UINT height = static_cast<UINT>(renderer->GetHeight());
+    DirectX::XMMATRIX view = renderer->GetViewMatrix().ToXMMATRIX();
+    DirectX::XMMATRIX projection = renderer->GetProjectionMatrix().ToXMMATRIX();
+    DirectX::XMFLOAT4X4 projectionValues;
+    DirectX::XMStoreFloat4x4(&projectionValues, projection);
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if (FAILED(context->Map(m_paramsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+        return;
+    }
+    LightingParams* params = static_cast<LightingParams*>(mappedResource.pData);
+    DirectX::XMStoreFloat4x4(&params->inverseViewProjection, DirectX::XMMatrixInverse(nullptr, view * projection));
+    params->screenSize[0] = width;
+    params->screenSize[1] = height;
+    params->depthToViewZ[0] = projectionValues._33;
+    params->depthToViewZ[1] = projectionValues._43;
+    context->Unmap(m_paramsBuffer.Get(), 0);
+    renderer->RecordBufferMap(sizeof(LightingParams));
+
+    // The compute pass writes covered pixels only, the rest keep the back buffer
+    ComPtr<ID3D11Resource> backBuffer;
+    ComPtr<ID3D11Resource> litTexture;
+    colorTarget->GetResource(&backBuffer);
+    litView->GetResource(&litTexture);
+    context->CopyResource(litTexture.Get(), backBuffer.Get());
+
+    ID3D11Buffer* buffers[] = { m_paramsBuffer.Get(), renderer->GetLightBuffer() };
+    ID3D11ShaderResourceView* views[] = {
+        graph.GetShaderResourceView(m_gBuffer[ALBEDO_TARGET]), graph.GetShaderResourceView(m_gBuffer[NORMAL_TARGET]), depthView
+    };
+    context->CSSetShader(m_lightingShader.Get(), nullptr, 0);
+    context->CSSetConstantBuffers(0, 2, buffers);
+    context->CSSetShaderResources(0, 3, views);
+    renderer->GetClusteredLighting().BindCompute(context);
+    renderer->GetShadowAtlas().BindCompute(context);
+    context->CSSetUnorderedAccessViews(0, 1, &litView, nullptr);
+
+    UINT tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    UINT tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    context->Dispatch(tilesX, tilesY, 1);
+    m_tileCount = tilesX * tilesY;
+
+    // The atlas too, so the next Shadows pass can write it
+    ID3D11ShaderResourceView* nullViews[3] = {};
+    ID3D11UnorderedAccessView* nullUAV = nullptr;
+    context->CSSetShaderResources(0, 3, nullViews);
+    context->CSSetShaderResources(ShadowAtlas::TEXTURE_SLOT, 1, nullViews);
+    context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    context->CopyResource(backBuffer.Get(), litTexture.Get());
+}
+
+bool DeferredShading::LoadShaders(D3D11Renderer* renderer) {
+    if (m_shadersLoaded) {
+        return true;
+    }
+    if (!renderer) {
+        return false;
+    }
+
+    if (!renderer->LoadPixelShader(L"Shaders/GBufferPixelShader.hlsl", m_gBufferShader) ||
+        !renderer->LoadComputeShader(L"Shaders/DeferredLightingComputeShader.hlsl", m_lightingShader)) {
+        m_gBufferShader.Reset();
+        m_lightingShader.Reset();
+        return false;
+    }
+
+    m_paramsBuffer = renderer->CreateConstantBuffer(sizeof(LightingParams));
+    if (!m_paramsBuffer) {
+        LOG_ERROR("Failed to create deferred lighting parameter buffer");
+        return false;
+    }
+
+    m_shadersLoaded = true;
+    return true;
+}
+
+bool DeferredShading::CreateStates(D3D11Renderer* renderer) {
+    if (m_prepassDepthState && m_shadingDepthState) {
+        return true;
+    }
+    if (!renderer) {
+        return false;
+    }
+
+    D3D11_DEPTH_STENCIL_DESC depthDesc = {};
+    depthDesc.DepthEnable = true;
+    depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+    depthDesc.DepthFunc = D3D11_COMPARISON_LESS;
+    m_prepassDepthState = renderer->GetStateObjects().GetDepthStencilState(depthDesc);
+
+    // Equal depths pass; the shading pass reproduces the prepass positions exactly
+    depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+    depthDesc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
+    m_shadingDepthState = renderer->GetStateObjects().GetDepthStencilState(depthDesc);
+
+    if (!m_prepassDepthState || !m_shadingDepthState) {
+        LOG_ERROR("Failed to create depth prepass states");
+        return false;
+    }
+    return true;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
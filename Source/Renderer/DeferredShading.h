@@ -0,0 +1,105 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "FrameGraph.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+class D3D11Renderer;
+
+using Microsoft::WRL::ComPtr;
+
+enum class RenderPath {
+    Forward,        // One lit pass; hidden fragments are shaded too
+    DepthPrepass,   // Depth first, then the lit pass shades visible fragments only
+    Deferred        // Depth first, thin G-buffer, lighting in a tiled compute pass
+};
+
+// Forward for names it does not know
+RenderPath ParseRenderPath(const std::string& name);
+const char* GetRenderPathName(RenderPath path);
+
+// Frame graph passes for the scene's geometry under each render path.
+//
+// Both paths draw the geometry twice: depth-only with no pixel shader, then
+// with depth writes off and a LESS_EQUAL test, so each pixel runs the
+// second pass's shader once however much overdraw there is. The prepass
+// path keeps the caller's lit shader for the second pass. The deferred path
+// swaps in GBufferPixelShader and DeferredLightingComputeShader then lights
+// the screen in TILE_SIZE x TILE_SIZE pixel groups from the G-buffer, depth
+// and the clustered light lists, so shading cost follows the pixel count.
+// The lit image is copied over the back buffer; pixels nothing was drawn to
+// keep what the back buffer held.
+//
+// G-buffer (the depth buffer completes it), transient in the frame graph:
+//   ALBEDO_TARGET  R8G8B8A8_UNORM       texture * material diffuse, a = specular intensity
+//   NORMAL_TARGET  R16G16B16A16_FLOAT   world normal, w = specular power
+// Per-material ambient colour is not stored; ambient light scales albedo.
+class DeferredShading {
+public:
+    static constexpr UINT TILE_SIZE = 16;
+    static constexpr UINT ALBEDO_TARGET = 0;
+    static constexpr UINT NORMAL_TARGET = 1;
+    static constexpr UINT TARGET_COUNT = 2;
+
+    // Draws the scene's geometry into the bound targets. With depthOnly no
+    // pixel shader runs; otherwise a non-null pixelShader replaces the
+    // materials' shaders.
+    using GeometryCallback = std::function<void(ID3D11PixelShader* pixelShader, bool depthOnly)>;
+
+    DeferredShading();
+    ~DeferredShading() = default;
+
+    // Loads the deferred shaders on first use; falls back to DepthPrepass
+    // when they are unavailable
+    void SetRenderPath(D3D11Renderer* renderer, RenderPath path);
+    RenderPath GetRenderPath() const { return m_path; }
+
+    // Adds the path's passes drawing into sceneColor and sceneDepth (imported
+    // with render target / depth views; depth also with a shader resource
+    // view for deferred): DepthPrepass unless forward, then Shading, or
+    // GBuffer and DeferredLighting. drawGeometry is called from Execute.
+    void AddPasses(FrameGraph& graph, D3D11Renderer* renderer, FrameGraph::ResourceHandle sceneColor,
+                   FrameGraph::ResourceHandle sceneDepth, GeometryCallback drawGeometry);
+
+    // Tiles lit by the last deferred frame
+    UINT GetTileCount() const { return m_tileCount; }
+
+private:
+    // Matches LightingParams in DeferredLightingComputeShader.hlsl
+    struct LightingParams {
+        DirectX::XMFLOAT4X4 inverseViewProjection;
+        std::uint32_t screenSize[2];
+        float depthToViewZ[2];  // viewZ = y / (depth - x)
+    };
+
+    bool LoadShaders(D3D11Renderer* renderer);
+    bool CreateStates(D3D11Renderer* renderer);
+    void Light(D3D11Renderer* renderer, const FrameGraph& graph, FrameGraph::ResourceHandle sceneColor,
+               FrameGraph::ResourceHandle sceneDepth, FrameGraph::ResourceHandle lit);
+
+    RenderPath m_path;
+    bool m_shadersLoaded;
+
+    ComPtr<ID3D11PixelShader> m_gBufferShader;
+    ComPtr<ID3D11ComputeShader> m_lightingShader;
+    ComPtr<ID3D11Buffer> m_paramsBuffer;
+
+    // From the renderer's StateObjectCache
+    ID3D11DepthStencilState* m_prepassDepthState;
+    ID3D11DepthStencilState* m_shadingDepthState;
+
+    // Transients of the frame being built
+    FrameGraph::ResourceHandle m_gBuffer[TARGET_COUNT];
+    FrameGraph::ResourceHandle m_litTarget;
+    UINT m_tileCount;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
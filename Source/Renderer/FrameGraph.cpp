@@ -0,0 +1,295 @@
+#include "FrameGraph.h"
+#include "D3D11Renderer.h"
+#include "../Core/Logger.h"
+#include "../Core/Profiler.h"
+#include <algorithm>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+// Shader input slots unbound before a pass overwrites something read earlier
+constexpr UINT UNBIND_SLOT_COUNT = 16;
+
+} // namespace
+
+FrameGraph::ResourceHandle FrameGraph::Builder::Create(const char* name, const TransientTextureDesc& desc) {
+    Resource resource = {};
+    resource.name = name;
+    resource.desc = desc;
+    m_graph.m_resources.push_back(resource);
+
+    ResourceHandle handle = static_cast<ResourceHandle>(m_graph.m_resources.size() - 1);
+    m_graph.m_passes[m_pass].creates.push_back(handle);
+    Write(handle);
+    return handle;
+}
+
+void FrameGraph::Builder::Read(ResourceHandle resource) {
+    if (m_graph.IsValid(resource)) {
+        m_graph.m_passes[m_pass].reads.push_back(resource);
+    }
+}
+
+void FrameGraph::Builder::Write(ResourceHandle resource) {
+    if (m_graph.IsValid(resource)) {
+        m_graph.m_passes[m_pass].writes.push_back(resource);
+        m_graph.m_resources[resource].writers.push_back(m_pass);
+    }
+}
+
+void FrameGraph::Builder::Clear(ResourceHandle resource, const float color[4]) {
+    if (!m_graph.IsValid(resource)) {
+        return;
+    }
+
+    Pass& pass = m_graph.m_passes[m_pass];
+    if (std::find(pass.writes.begin(), pass.writes.end(), resource) == pass.writes.end()) {
+        Write(resource);
+    }
+
+    ClearRequest request = { resource, { color[0], color[1], color[2], color[3] } };
+    pass.clears.push_back(request);
+}
+
+void FrameGraph::Builder::SetSideEffect() {
+    m_graph.m_passes[m_pass].sideEffect = true;
+}
+
+FrameGraph::FrameGraph()
+    : m_culledPasses(0)
+    , m_transientCount(0)
+{
+}
+
+void FrameGraph::Reset() {
+    m_resources.clear();
+    m_passes.clear();
+}
+
+FrameGraph::ResourceHandle FrameGraph::Import(const char* name, ID3D11RenderTargetView* renderTarget,
+                                              ID3D11DepthStencilView* depthStencil,
+                                              ID3D11ShaderResourceView* shaderResource, bool output) {
+    Resource resource = {};
+    resource.name = name;
+    resource.imported = true;
+    resource.output = output;
+    resource.importedRenderTarget = renderTarget;
+    resource.importedDepthStencil = depthStencil;
+    resource.importedShaderResource = shaderResource;
+    m_resources.push_back(resource);
+    return static_cast<ResourceHandle>(m_resources.size() - 1);
+}
+
+void FrameGraph::AddPass(const char* name, const SetupFunction& setup, ExecuteFunction execute) {
+    Pass pass = {};
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+
+    Builder builder(*this, m_passes.size() - 1);
+    setup(builder);
+}
+
+void FrameGraph::Execute(D3D11Renderer* renderer, TransientTexturePool& pool) {
+    PROFILE_SCOPE("FrameGraph");
+    Cull();
+    ComputeLifetimes();
+
+    ID3D11DeviceContext* context = renderer->GetContext();
+    ComPtr<ID3D11RenderTargetView> savedTarget;
+    ComPtr<ID3D11DepthStencilView> savedDepthTarget;
+    context->OMGetRenderTargets(1, &savedTarget, &savedDepthTarget);
+
+    m_transientCount = 0;
+    for (size_t i = 0; i < m_passes.size(); i++) {
+        Pass& pass = m_passes[i];
+        if (pass.culled) {
+            continue;
+        }
+
+        // Transients get memory right before their first pass
+        bool allocated = true;
+        for (ResourceHandle handle : pass.creates) {
+            Resource& resource = m_resources[handle];
+            resource.texture = pool.Acquire(resource.desc);
+            allocated = allocated && resource.texture;
+            m_transientCount++;
+        }
+        if (!allocated) {
+            LOG_ERROR("Frame graph pass " << pass.name << " skipped, its textures could not be created");
+        } else {
+            PrepareResources(renderer, pass);
+
+            GPU_PROFILE_SCOPE(context, pass.name);
+            pass.execute(renderer, *this);
+        }
+
+        for (ResourceHandle handle : pass.writes) {
+            m_resources[handle].written = true;
+        }
+        for (ResourceHandle handle : pass.reads) {
+            m_resources[handle].read = true;
+        }
+
+        // ...and give it back after their last, for later passes to reuse
+        for (Resource& resource : m_resources) {
+            if (resource.texture && resource.lastPass == i) {
+                pool.Release(resource.texture);
+                resource.texture = nullptr;
+            }
+        }
+    }
+
+    context->OMSetRenderTargets(1, savedTarget.GetAddressOf(), savedDepthTarget.Get());
+    renderer->InvalidateStateCache();
+}
+
+void FrameGraph::Cull() {
+    std::vector<ResourceHandle> unreferenced;
+
+    for (Pass& pass : m_passes) {
+        pass.refCount = static_cast<UINT>(pass.writes.size());
+        pass.culled = false;
+    }
+    for (Resource& resource : m_resources) {
+        resource.refCount = resource.output ? 1 : 0;
+        resource.firstPass = m_passes.size();
+        resource.lastPass = 0;
+        resource.texture = nullptr;
+        resource.written = false;
+        resource.read = false;
+    }
+    for (const Pass& pass : m_passes) {
+        for (ResourceHandle handle : pass.reads) {
+            m_resources[handle].refCount++;
+        }
+    }
+
+    // Culling a pass releases its reads, which may leave their writers unused
+    auto cullPass = [this, &unreferenced](Pass& pass) {
+        pass.culled = true;
+        for (ResourceHandle handle : pass.reads) {
+            if (--m_resources[handle].refCount == 0) {
+                unreferenced.push_back(handle);
+            }
+        }
+    };
+
+    // Resources nothing reads to begin with; after this, a resource is queued
+    // only on the decrement that takes it to zero, so never twice
+    for (ResourceHandle handle = 0; handle < m_resources.size(); handle++) {
+        if (m_resources[handle].refCount == 0) {
+            unreferenced.push_back(handle);
+        }
+    }
+    for (Pass& pass : m_passes) {
+        if (pass.refCount == 0 && !pass.sideEffect) {
+            cullPass(pass);
+        }
+    }
+
+    while (!unreferenced.empty()) {
+        ResourceHandle handle = unreferenced.back();
+        unreferenced.pop_back();
+
+        for (size_t writer : m_resources[handle].writers) {
+            Pass& pass = m_passes[writer];
+            if (!pass.culled && --pass.refCount == 0 && !pass.sideEffect) {
+                cullPass(pass);
+            }
+        }
+    }
+
+    m_culledPasses = 0;
+    for (const Pass& pass : m_passes) {
+        if (pass.culled) {
+            m_culledPasses++;
+        }
+    }
+}
+
+void FrameGraph::ComputeLifetimes() {
+    for (size_t i = 0; i < m_passes.size(); i++) {
+        const Pass& pass = m_passes[i];
+        if (pass.culled) {
+            continue;
+        }
+
+        auto touch = [this, i](ResourceHandle handle) {
+            Resource& resource = m_resources[handle];
+            resource.firstPass = std::min(resource.firstPass, i);
+            resource.lastPass = std::max(resource.lastPass, i);
+        };
+        std::for_each(pass.reads.begin(), pass.reads.end(), touch);
+        std::for_each(pass.writes.begin(), pass.writes.end(), touch);
+    }
+}
+
+void FrameGraph::PrepareResources(D3D11Renderer* renderer, const Pass& pass) {
+    bool unbindInputs = false;
+    bool unbindOutputs = false;
+    for (ResourceHandle handle : pass.writes) {
+        unbindInputs = unbindInputs || m_resources[handle].read;
+    }
+    for (ResourceHandle handle : pass.reads) {
+        unbindOutputs = unbindOutputs || m_resources[handle].written;
+    }
+
+    ID3D11DeviceContext* context = renderer->GetContext();
+    if (unbindInputs) {
+        ID3D11ShaderResourceView* nullViews[UNBIND_SLOT_COUNT] = {};
+        context->PSSetShaderResources(0, UNBIND_SLOT_COUNT, nullViews);
+        context->CSSetShaderResources(0, UNBIND_SLOT_COUNT, nullViews);
+    }
+    if (unbindOutputs) {
+        ID3D11UnorderedAccessView* nullUAVs[D3D11_PS_CS_UAV_REGISTER_COUNT] = {};
+        context->OMSetRenderTargets(0, nullptr, nullptr);
+        context->CSSetUnorderedAccessViews(0, D3D11_PS_CS_UAV_REGISTER_COUNT, nullUAVs, nullptr);
+    }
+    if (unbindInputs || unbindOutputs) {
+        renderer->InvalidateStateCache();
+    }
+
+    for (const ClearRequest& clear : pass.clears) {
+        if (ID3D11RenderTargetView* view = GetRenderTargetView(clear.resource)) {
+            context->ClearRenderTargetView(view, clear.color);
+        } else if (ID3D11UnorderedAccessView* view = GetUnorderedAccessView(clear.resource)) {
+            context->ClearUnorderedAccessViewFloat(view, clear.color);
+        }
+    }
+}
+
+ID3D11RenderTargetView* FrameGraph::GetRenderTargetView(ResourceHandle resource) const {
+    if (!IsValid(resource)) {
+        return nullptr;
+    }
+    const Resource& entry = m_resources[resource];
+    return entry.imported ? entry.importedRenderTarget
+                          : (entry.texture ? entry.texture->renderTargetView.Get() : nullptr);
+}
+
+ID3D11DepthStencilView* FrameGraph::GetDepthStencilView(ResourceHandle resource) const {
+    return IsValid(resource) ? m_resources[resource].importedDepthStencil : nullptr;
+}
+
+ID3D11ShaderResourceView* FrameGraph::GetShaderResourceView(ResourceHandle resource) const {
+    if (!IsValid(resource)) {
+        return nullptr;
+    }
+    const Resource& entry = m_resources[resource];
+    return entry.imported ? entry.importedShaderResource
+                          : (entry.texture ? entry.texture->shaderResourceView.Get() : nullptr);
+}
+
+ID3D11UnorderedAccessView* FrameGraph::GetUnorderedAccessView(ResourceHandle resource) const {
+    if (!IsValid(resource)) {
+        return nullptr;
+    }
+    const Resource& entry = m_resources[resource];
+    return entry.texture ? entry.texture->unorderedAccessView.Get() : nullptr;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "TransientTexturePool.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+class D3D11Renderer;
+
+// One frame's passes, declared with the textures they read and write, then
+// executed in declaration order.
+//
+// Execute culls passes whose outputs nothing reads: a pass survives if it
+// writes an imported output, a resource a surviving pass reads, or is marked
+// with SetSideEffect. Textures a pass creates are transient: they come from
+// the renderer's TransientTexturePool just before their first pass and go
+// back after their last, so passes that don't overlap share memory.
+//
+// Before each pass the graph does the hazard work in one go: shader inputs
+// are unbound once if the pass writes something read earlier, outputs once
+// if it reads something written earlier, then all of the pass's clears are
+// issued. Passes bind their own targets; the caller's render targets are
+// restored when the graph is done. Names must outlive the frame (literals).
+class FrameGraph {
+public:
+    using ResourceHandle = std::uint32_t;
+    static constexpr ResourceHandle INVALID_RESOURCE = 0xFFFFFFFFu;
+
+    class Builder {
+    public:
+        // New transient texture written by this pass
+        ResourceHandle Create(const char* name, const TransientTextureDesc& desc);
+        void Read(ResourceHandle resource);
+        void Write(ResourceHandle resource);
+        // Write that starts from a cleared render target or UAV
+        void Clear(ResourceHandle resource, const float color[4]);
+        // Run even if nothing reads the pass's outputs (GPU readback, queries)
+        void SetSideEffect();
+
+    private:
+        friend class FrameGraph;
+        Builder(FrameGraph& graph, size_t pass) : m_graph(graph), m_pass(pass) {}
+
+        FrameGraph& m_graph;
+        size_t m_pass;
+    };
+
+    using SetupFunction = std::function<void(Builder&)>;
+    using ExecuteFunction = std::function<void(D3D11Renderer*, const FrameGraph&)>;
+
+    FrameGraph();
+    ~FrameGraph() = default;
+
+    // Drops the last frame's passes and resources
+    void Reset();
+
+    // Texture owned outside the graph, e.g. the back buffer. Outputs are
+    // what the frame produces and keep the passes writing them.
+    ResourceHandle Import(const char* name, ID3D11RenderTargetView* renderTarget, ID3D11DepthStencilView* depthStencil,
+                          ID3D11ShaderResourceView* shaderResource, bool output);
+
+    // Setup runs now; execute runs from Execute if the pass survives culling
+    void AddPass(const char* name, const SetupFunction& setup, ExecuteFunction execute);
+
+    void Execute(D3D11Renderer* renderer, TransientTexturePool& pool);
+
+    // Views of a resource, valid while the passes using it execute; null
+    // for bindings it was not created with
+    ID3D11RenderTargetView* GetRenderTargetView(ResourceHandle resource) const;
+    ID3D11DepthStencilView* GetDepthStencilView(ResourceHandle resource) const;
+    ID3D11ShaderResourceView* GetShaderResourceView(ResourceHandle resource) const;
+    ID3D11UnorderedAccessView* GetUnorderedAccessView(ResourceHandle resource) const;
+
+    // Last Execute
+    UINT GetPassCount() const { return static_cast<UINT>(m_passes.size()); }
+    UINT GetCulledPassCount() const { return m_culledPasses; }
+    UINT GetTransientCount() const { return m_transientCount; }
+
+private:
+    struct ClearRequest {
+        ResourceHandle resource;
+        float color[4];
+    };
+
+    struct Resource {
+        const char* name;
+        TransientTextureDesc desc;
+        bool imported;
+        bool output;
+        ID3D11RenderTargetView* importedRenderTarget;
+        ID3D11DepthStencilView* importedDepthStencil;
+        ID3D11ShaderResourceView* importedShaderResource;
+        TransientTexture* texture;
+        std::vector<size_t> writers;
+        UINT refCount;
+        size_t firstPass;
+        size_t lastPass;
+        bool written;   // During Execute: by a pass already run
+        bool read;
+    };
+
+    struct Pass {
+        const char* name;
+        ExecuteFunction execute;
+        std::vector<ResourceHandle> creates;
+        std::vector<ResourceHandle> reads;
+        std::vector<ResourceHandle> writes;
+        std::vector<ClearRequest> clears;
+        bool sideEffect;
+        UINT refCount;
+        bool culled;
+    };
+
+    void Cull();
+    void ComputeLifetimes();
+    void PrepareResources(D3D11Renderer* renderer, const Pass& pass);
+    bool IsValid(ResourceHandle resource) const { return resource < m_resources.size(); }
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    UINT m_culledPasses;
+    UINT m_transientCount;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
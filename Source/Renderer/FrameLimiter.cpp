@@ -0,0 +1,93 @@
+#include "FrameLimiter.h"
+#include "../Core/Logger.h"
+#include <mmsystem.h>
+
+#pragma comment(lib, "winmm.lib")
+
+// Windows 10 1803+; older SDK headers do not define it
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+// Wakeup jitter left to the spin loop for each kind of timer
+constexpr std::chrono::microseconds HIGH_RESOLUTION_SPIN(500);
+constexpr std::chrono::microseconds LOW_RESOLUTION_SPIN(2000);
+
+} // namespace
+
+FrameLimiter::FrameLimiter()
+    : m_timer(nullptr)
+    , m_highResolutionTimer(false)
+    , m_timerPeriodRaised(false)
+    , m_targetFPS(0)
+    , m_period(Clock::duration::zero())
+    , m_nextFrame(Clock::now())
+{
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (m_timer) {
+        m_highResolutionTimer = true;
+        return;
+    }
+
+    // Older systems: a regular timer is only as fine as the system tick
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    m_timerPeriodRaised = timeBeginPeriod(1) == TIMERR_NOERROR;
+    if (!m_timer) {
+        LOG_WARNING("Failed to create frame limiter timer, spinning for frame pacing");
+    }
+}
+
+FrameLimiter::~FrameLimiter() {
+    if (m_timer) {
+        CloseHandle(m_timer);
+    }
+    if (m_timerPeriodRaised) {
+        timeEndPeriod(1);
+    }
+}
+
+void FrameLimiter::SetTargetFPS(int fps) {
+    m_targetFPS = fps > 0 ? fps : 0;
+    m_period = m_targetFPS > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFPS))
+        : Clock::duration::zero();
+    m_nextFrame = Clock::now() + m_period;
+}
+
+void FrameLimiter::Wait() {
+    if (m_targetFPS <= 0) {
+        return;
+    }
+
+    Clock::time_point now = Clock::now();
+    if (now >= m_nextFrame) {
+        m_nextFrame = now + m_period;
+        return;
+    }
+
+    // Sleep through all but the last stretch, which the timer could overshoot
+    Clock::duration spin = m_highResolutionTimer ? Clock::duration(HIGH_RESOLUTION_SPIN) : Clock::duration(LOW_RESOLUTION_SPIN);
+    Clock::duration remaining = m_nextFrame - now;
+    if (m_timer && remaining > spin) {
+        LARGE_INTEGER dueTime;
+        // Negative is relative, in 100 ns units
+        dueTime.QuadPart = -static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining - spin).count() / 100);
+        if (SetWaitableTimerEx(m_timer, &dueTime, 0, nullptr, nullptr, nullptr, 0)) {
+            WaitForSingleObject(m_timer, INFINITE);
+        }
+    }
+
+    while (Clock::now() < m_nextFrame) {
+        YieldProcessor();
+    }
+
+    m_nextFrame += m_period;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
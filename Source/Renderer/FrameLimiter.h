@@ -0,0 +1,40 @@
+#pragma once
+
+#include <windows.h>
+#include <chrono>
+
+namespace GameEngine {
+namespace Renderer {
+
+// Holds frames to a target rate. Most of the wait sleeps on a high-resolution
+// waitable timer and only the last stretch spins, so frames start within
+// microseconds of their slot instead of at Sleep's 1-15 ms granularity.
+class FrameLimiter {
+public:
+    FrameLimiter();
+    ~FrameLimiter();
+
+    FrameLimiter(const FrameLimiter&) = delete;
+    FrameLimiter& operator=(const FrameLimiter&) = delete;
+
+    // 0 or less disables limiting
+    void SetTargetFPS(int fps);
+    int GetTargetFPS() const { return m_targetFPS; }
+
+    // Block until the next frame slot. A late frame moves the schedule
+    // instead of letting later frames run fast to catch up.
+    void Wait();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    HANDLE m_timer;
+    bool m_highResolutionTimer;
+    bool m_timerPeriodRaised;
+    int m_targetFPS;
+    Clock::duration m_period;
+    Clock::time_point m_nextFrame;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,128 @@
+#include "GpuMemory.h"
+#include <DirectXTex.h>
+#include <algorithm>
+#include <atomic>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+// {7B1E3C52-9A4D-4F7E-8C21-5D6A0E4B9F13}
+const GUID GPU_MEMORY_RECORD_GUID = { 0x7b1e3c52, 0x9a4d, 0x4f7e, { 0x8c, 0x21, 0x5d, 0x6a, 0x0e, 0x4b, 0x9f, 0x13 } };
+
+// Owned by the resource's private data; gives the bytes back when released
+class GpuMemoryRecord final : public IUnknown {
+public:
+    GpuMemoryRecord(Core::MemoryCategory category, std::int64_t bytes)
+        : m_refCount(1)
+        , m_category(category)
+        , m_bytes(bytes)
+    {
+        Core::MemoryTracker::TrackGpu(m_category, m_bytes);
+    }
+
+    ~GpuMemoryRecord() {
+        Core::MemoryTracker::TrackGpu(m_category, -m_bytes);
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override {
+        if (!object) {
+            return E_POINTER;
+        }
+        if (riid == __uuidof(IUnknown)) {
+            *object = static_cast<IUnknown*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override {
+        return m_refCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override {
+        ULONG count = m_refCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (count == 0) {
+            delete this;
+        }
+        return count;
+    }
+
+private:
+    std::atomic<ULONG> m_refCount;
+    Core::MemoryCategory m_category;
+    std::int64_t m_bytes;
+};
+
+std::int64_t ComputeMipChainSize(DXGI_FORMAT format, UINT width, UINT height, UINT depth, UINT mipLevels) {
+    std::int64_t total = 0;
+    for (UINT mip = 0; mip < mipLevels; mip++) {
+        size_t rowPitch = 0;
+        size_t slicePitch = 0;
+        if (FAILED(DirectX::ComputePitch(format, std::max(width >> mip, 1u), std::max(height >> mip, 1u),
+                                         rowPitch, slicePitch))) {
+            return 0;
+        }
+        total += static_cast<std::int64_t>(slicePitch) * std::max(depth >> mip, 1u);
+    }
+    return total;
+}
+
+// MipLevels of 0 in a description means the full chain, but created resources report the real count
+UINT GetMipCount(UINT mipLevels) {
+    return std::max(mipLevels, 1u);
+}
+
+} // namespace
+
+std::int64_t ComputeResourceSize(ID3D11Resource* resource) {
+    D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    resource->GetType(&dimension);
+
+    switch (dimension) {
+    case D3D11_RESOURCE_DIMENSION_BUFFER: {
+        D3D11_BUFFER_DESC desc;
+        static_cast<ID3D11Buffer*>(resource)->GetDesc(&desc);
+        return desc.ByteWidth;
+    }
+    case D3D11_RESOURCE_DIMENSION_TEXTURE1D: {
+        D3D11_TEXTURE1D_DESC desc;
+        static_cast<ID3D11Texture1D*>(resource)->GetDesc(&desc);
+        return ComputeMipChainSize(desc.Format, desc.Width, 1, 1, GetMipCount(desc.MipLevels)) * desc.ArraySize;
+    }
+    case D3D11_RESOURCE_DIMENSION_TEXTURE2D: {
+        D3D11_TEXTURE2D_DESC desc;
+        static_cast<ID3D11Texture2D*>(resource)->GetDesc(&desc);
+        return ComputeMipChainSize(desc.Format, desc.Width, desc.Height, 1, GetMipCount(desc.MipLevels)) *
+               desc.ArraySize * std::max(desc.SampleDesc.Count, 1u);
+    }
+    case D3D11_RESOURCE_DIMENSION_TEXTURE3D: {
+        D3D11_TEXTURE3D_DESC desc;
+        static_cast<ID3D11Texture3D*>(resource)->GetDesc(&desc);
+        return ComputeMipChainSize(desc.Format, desc.Width, desc.Height, desc.Depth, GetMipCount(desc.MipLevels));
+    }
+    default:
+        return 0;
+    }
+}
+
+void TrackGpuMemory(ID3D11Resource* resource, Core::MemoryCategory category) {
+    if (!resource) {
+        return;
+    }
+
+    // The resource takes its own reference; replacing an earlier record releases it
+    GpuMemoryRecord* record = new GpuMemoryRecord(category, ComputeResourceSize(resource));
+    resource->SetPrivateDataInterface(GPU_MEMORY_RECORD_GUID, record);
+    record->Release();
+}
+
+void TrackGpuMemory(ID3D11Resource* resource) {
+    TrackGpuMemory(resource, Core::MemoryTracker::GetCurrentCategory());
+}
+
+} // namespace Renderer
+} // namespace GameEngine
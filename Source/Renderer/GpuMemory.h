@@ -0,0 +1,27 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstdint>
+#include "../Core/MemoryTracker.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+// Charges a resource's size to a memory category until D3D destroys it.
+//
+// The size comes from the resource's description (mips, array slices,
+// samples and block compression included, driver padding not). A small
+// COM record attached as private data holds the charge; D3D releases it
+// with the resource, which credits the bytes back however the last
+// reference was dropped. Tracking a resource again moves it to the new
+// category. Null resources are ignored.
+void TrackGpuMemory(ID3D11Resource* resource, Core::MemoryCategory category);
+
+// Charged to the calling thread's MEMORY_SCOPE
+void TrackGpuMemory(ID3D11Resource* resource);
+
+// Bytes a resource's description implies
+std::int64_t ComputeResourceSize(ID3D11Resource* resource);
+
+} // namespace Renderer
+} // namespace GameEngine
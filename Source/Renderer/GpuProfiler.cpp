@@ -0,0 +1,226 @@
+#include "GpuProfiler.h"
+#include "../Core/Logger.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+// Ignored scope begins still push so EndScope stays balanced
+constexpr UINT UNTRACKED_SCOPE = 0xFFFFFFFF;
+
+std::int64_t TicksToMicroseconds(UINT64 ticks, UINT64 frequency) {
+    return static_cast<std::int64_t>((ticks / frequency) * 1000000 + (ticks % frequency) * 1000000 / frequency);
+}
+
+} // namespace
+
+GpuProfiler& GpuProfiler::GetInstance() {
+    static GpuProfiler instance;
+    return instance;
+}
+
+GpuProfiler::GpuProfiler()
+    : m_device(nullptr)
+    , m_context(nullptr)
+    , m_frameIndex(0)
+    , m_inFrame(false)
+    , m_droppedFrames(0)
+{
+}
+
+bool GpuProfiler::Initialize(ID3D11Device* device, ID3D11DeviceContext* context) {
+    Shutdown();
+    if (!device || !context) {
+        return false;
+    }
+
+    m_device = device;
+    for (Frame& frame : m_frames) {
+        if (!CreateFrame(frame)) {
+            LOG_WARNING("Failed to create GPU profiler queries, GPU timings disabled");
+            Shutdown();
+            return false;
+        }
+    }
+
+    m_context = context;
+    return true;
+}
+
+void GpuProfiler::Shutdown() {
+    for (Frame& frame : m_frames) {
+        frame = Frame();
+    }
+    m_openScopes.clear();
+    m_device = nullptr;
+    m_context = nullptr;
+    m_inFrame = false;
+}
+
+bool GpuProfiler::CreateFrame(Frame& frame) {
+    D3D11_QUERY_DESC desc = {};
+    desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+    if (FAILED(m_device->CreateQuery(&desc, &frame.disjoint))) {
+        return false;
+    }
+
+    frame.begin.Attach(CreateTimestamp());
+    frame.end.Attach(CreateTimestamp());
+    return frame.begin && frame.end;
+}
+
+ID3D11Query* GpuProfiler::CreateTimestamp() {
+    D3D11_QUERY_DESC desc = {};
+    desc.Query = D3D11_QUERY_TIMESTAMP;
+
+    ID3D11Query* query = nullptr;
+    if (FAILED(m_device->CreateQuery(&desc, &query))) {
+        return nullptr;
+    }
+    return query;
+}
+
+void GpuProfiler::BeginFrame() {
+    if (!m_context || !PROFILER.IsEnabled()) {
+        return;
+    }
+
+    Frame& frame = m_frames[m_frameIndex];
+
+    // Never resolved in time; reusing the queries discards it
+    if (frame.pending) {
+        m_droppedFrames++;
+        frame.pending = false;
+    }
+
+    frame.scopeCount = 0;
+    frame.cpuBegin = Core::Profiler::Now();
+    m_openScopes.clear();
+
+    m_context->Begin(frame.disjoint.Get());
+    m_context->End(frame.begin.Get());
+    m_inFrame = true;
+}
+
+void GpuProfiler::EndFrame() {
+    if (!m_inFrame) {
+        return;
+    }
+
+    Frame& frame = m_frames[m_frameIndex];
+
+    // Close anything left open so the pairs stay consistent
+    while (!m_openScopes.empty()) {
+        EndScope(m_context);
+    }
+
+    m_context->End(frame.end.Get());
+    m_context->End(frame.disjoint.Get());
+    frame.pending = true;
+    m_inFrame = false;
+
+    m_frameIndex = (m_frameIndex + 1) % FRAME_LATENCY;
+
+    // Oldest frames first, so results arrive in order
+    for (UINT i = 0; i < FRAME_LATENCY; i++) {
+        Frame& oldest = m_frames[(m_frameIndex + i) % FRAME_LATENCY];
+        if (oldest.pending && !Resolve(oldest)) {
+            break;
+        }
+    }
+}
+
+void GpuProfiler::BeginScope(ID3D11DeviceContext* context, const char* name) {
+    if (!m_inFrame || context != m_context) {
+        return;
+    }
+
+    Frame& frame = m_frames[m_frameIndex];
+    if (frame.scopeCount >= MAX_SCOPES) {
+        m_openScopes.push_back(UNTRACKED_SCOPE);
+        return;
+    }
+
+    if (frame.scopeCount == frame.scopes.size()) {
+        Scope scope;
+        scope.begin.Attach(CreateTimestamp());
+        scope.end.Attach(CreateTimestamp());
+        if (!scope.begin || !scope.end) {
+            m_openScopes.push_back(UNTRACKED_SCOPE);
+            return;
+        }
+        frame.scopes.push_back(scope);
+    }
+
+    UINT index = frame.scopeCount++;
+    Scope& scope = frame.scopes[index];
+    scope.name = name;
+    scope.depth = static_cast<std::uint16_t>(m_openScopes.size());
+    m_context->End(scope.begin.Get());
+    m_openScopes.push_back(index);
+}
+
+void GpuProfiler::EndScope(ID3D11DeviceContext* context) {
+    if (!m_inFrame || context != m_context || m_openScopes.empty()) {
+        return;
+    }
+
+    UINT index = m_openScopes.back();
+    m_openScopes.pop_back();
+    if (index != UNTRACKED_SCOPE) {
+        m_context->End(m_frames[m_frameIndex].scopes[index].end.Get());
+    }
+}
+
+bool GpuProfiler::Resolve(Frame& frame) {
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+    if (m_context->GetData(frame.disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+        return false;
+    }
+    frame.pending = false;
+
+    // Clock changed mid-frame (power state, driver); the timestamps are meaningless
+    if (disjoint.Disjoint || disjoint.Frequency == 0) {
+        m_droppedFrames++;
+        return true;
+    }
+
+    UINT64 frameBegin = 0;
+    UINT64 frameEnd = 0;
+    if (m_context->GetData(frame.begin.Get(), &frameBegin, sizeof(frameBegin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+        m_context->GetData(frame.end.Get(), &frameEnd, sizeof(frameEnd), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+        m_droppedFrames++;
+        return true;
+    }
+
+    // GPU clock mapped onto the CPU timeline at the point the frame began recording
+    m_resolvedEvents.clear();
+    for (UINT i = 0; i < frame.scopeCount; i++) {
+        const Scope& scope = frame.scopes[i];
+        UINT64 begin = 0;
+        UINT64 end = 0;
+        if (m_context->GetData(scope.begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            m_context->GetData(scope.end.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            begin < frameBegin || end < begin) {
+            continue;
+        }
+
+        Core::ProfileEvent event;
+        event.name = scope.name;
+        event.begin = frame.cpuBegin + TicksToMicroseconds(begin - frameBegin, disjoint.Frequency);
+        event.end = frame.cpuBegin + TicksToMicroseconds(end - frameBegin, disjoint.Frequency);
+        event.threadId = Core::Profiler::GPU_THREAD_ID;
+        event.depth = scope.depth;
+        m_resolvedEvents.push_back(event);
+    }
+
+    double gpuMilliseconds = frameEnd > frameBegin
+        ? static_cast<double>(TicksToMicroseconds(frameEnd - frameBegin, disjoint.Frequency)) / 1000.0
+        : 0.0;
+    PROFILER.SubmitGpuFrame(m_resolvedEvents, gpuMilliseconds);
+    return true;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
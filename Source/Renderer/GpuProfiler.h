@@ -0,0 +1,105 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <vector>
+#include "../Core/Profiler.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+using Microsoft::WRL::ComPtr;
+
+// GPU pass timing with timestamp queries.
+//
+// Every frame is bracketed by a TIMESTAMP_DISJOINT query and each scope by a
+// pair of timestamps. Results are read back FRAME_LATENCY frames later
+// without stalling (a frame still unresolved by then is dropped) and handed
+// to the CPU profiler, so both show up in the overlay and the trace. Only
+// the immediate context is timed; scopes on deferred contexts are ignored.
+class GpuProfiler {
+public:
+    static constexpr UINT FRAME_LATENCY = 4;
+    static constexpr UINT MAX_SCOPES = 64;
+
+    static GpuProfiler& GetInstance();
+
+    bool Initialize(ID3D11Device* device, ID3D11DeviceContext* context);
+    void Shutdown();
+
+    void BeginFrame();
+    // Closes the frame and resolves the oldest one in flight
+    void EndFrame();
+
+    void BeginScope(ID3D11DeviceContext* context, const char* name);
+    void EndScope(ID3D11DeviceContext* context);
+
+    bool IsInitialized() const { return m_context != nullptr; }
+    unsigned int GetDroppedFrameCount() const { return m_droppedFrames; }
+
+private:
+    GpuProfiler();
+    ~GpuProfiler() = default;
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    struct Scope {
+        const char* name = nullptr;
+        ComPtr<ID3D11Query> begin;
+        ComPtr<ID3D11Query> end;
+        std::uint16_t depth = 0;
+    };
+
+    struct Frame {
+        ComPtr<ID3D11Query> disjoint;
+        ComPtr<ID3D11Query> begin;
+        ComPtr<ID3D11Query> end;
+        std::vector<Scope> scopes;      // Query pool; the first scopeCount are in use
+        UINT scopeCount = 0;
+        std::int64_t cpuBegin = 0;      // Profiler time the frame started recording
+        bool pending = false;
+    };
+
+    bool CreateFrame(Frame& frame);
+    ID3D11Query* CreateTimestamp();
+    bool Resolve(Frame& frame);
+
+    ID3D11Device* m_device;
+    ID3D11DeviceContext* m_context;
+    Frame m_frames[FRAME_LATENCY];
+    UINT m_frameIndex;
+    bool m_inFrame;
+    std::vector<UINT> m_openScopes;
+    std::vector<Core::ProfileEvent> m_resolvedEvents;
+    unsigned int m_droppedFrames;
+};
+
+// Times the GPU work recorded in the enclosing scope
+class GpuProfileScope {
+public:
+    GpuProfileScope(ID3D11DeviceContext* context, const char* name)
+        : m_context(context)
+    {
+        GpuProfiler::GetInstance().BeginScope(m_context, name);
+    }
+
+    ~GpuProfileScope() {
+        GpuProfiler::GetInstance().EndScope(m_context);
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    ID3D11DeviceContext* m_context;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
+
+#define GPU_PROFILER GameEngine::Renderer::GpuProfiler::GetInstance()
+
+#define GPU_PROFILE_SCOPE(context, name) \
+    GameEngine::Renderer::GpuProfileScope PROFILE_CONCAT(gpuProfileScope_, __LINE__)(context, name)
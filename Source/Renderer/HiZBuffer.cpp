@@ -0,0 +1,167 @@
+#include "HiZBuffer.h"
+#include "GpuMemory.h"
+#include "D3D11Renderer.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+
+namespace GameEngine {
+namespace Renderer {
+
+HiZBuffer::HiZBuffer()
+    : m_width(0)
+    , m_height(0)
+    , m_mipCount(0)
+    , m_valid(false)
+{
+    DirectX::XMStoreFloat4x4(&m_viewProjection, DirectX::XMMatrixIdentity());
+}
+
+bool HiZBuffer::Build(D3D11Renderer* renderer, const DirectX::XMMATRIX& viewProjection) {
+    m_valid = false;
+    ID3D11ShaderResourceView* depthView = renderer ? renderer->GetDepthShaderResourceView() : nullptr;
+    if (!m_shader || !depthView) {
+        return false;
+    }
+
+    UINT depthWidth = static_cast<UINT>(renderer->GetWidth());
+    UINT depthHeight = static_cast<UINT>(renderer->GetHeight());
+    UINT width = std::max((depthWidth + 1) / 2, 1u);
+    UINT height = std::max((depthHeight + 1) / 2, 1u);
+    if (width != m_width || height != m_height || !m_texture) {
+        if (!CreateResources(renderer, width, height)) {
+            return false;
+        }
+    }
+
+    ID3D11DeviceContext* context = renderer->GetContext();
+
+    // Depth cannot be read while it is bound for writing
+    ComPtr<ID3D11RenderTargetView> renderTarget;
+    ComPtr<ID3D11DepthStencilView> depthTarget;
+    context->OMGetRenderTargets(1, &renderTarget, &depthTarget);
+    context->OMSetRenderTargets(1, renderTarget.GetAddressOf(), nullptr);
+
+    context->CSSetShader(m_shader.Get(), nullptr, 0);
+    context->CSSetConstantBuffers(0, 1, m_paramsBuffer.GetAddressOf());
+
+    ID3D11ShaderResourceView* nullView = nullptr;
+    ID3D11UnorderedAccessView* nullUAV = nullptr;
+    UINT sourceWidth = depthWidth;
+    UINT sourceHeight = depthHeight;
+
+    for (UINT mip = 0; mip < m_mipCount; mip++) {
+        UINT destWidth = std::max(width >> mip, 1u);
+        UINT destHeight = std::max(height >> mip, 1u);
+
+        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        if (FAILED(context->Map(m_paramsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+            break;
+        }
+        DownsampleParams* params = static_cast<DownsampleParams*>(mappedResource.pData);
+        params->sourceSize[0] = sourceWidth;
+        params->sourceSize[1] = sourceHeight;
+        params->destSize[0] = destWidth;
+        params->destSize[1] = destHeight;
+        context->Unmap(m_paramsBuffer.Get(), 0);
+
+        // The previous level is read through its own view while this one is written
+        ID3D11ShaderResourceView* source = mip == 0 ? depthView : m_mipViews[mip - 1].Get();
+        context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+        context->CSSetShaderResources(0, 1, &source);
+        context->CSSetUnorderedAccessViews(0, 1, m_mipUAVs[mip].GetAddressOf(), nullptr);
+        context->Dispatch((destWidth + THREAD_GROUP_SIZE - 1) / THREAD_GROUP_SIZE,
+                          (destHeight + THREAD_GROUP_SIZE - 1) / THREAD_GROUP_SIZE, 1);
+        context->CSSetShaderResources(0, 1, &nullView);
+
+        sourceWidth = destWidth;
+        sourceHeight = destHeight;
+        m_valid = mip + 1 == m_mipCount;
+    }
+
+    context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+    context->OMSetRenderTargets(1, renderTarget.GetAddressOf(), depthTarget.Get());
+
+    DirectX::XMStoreFloat4x4(&m_viewProjection, viewProjection);
+    return m_valid;
+}
+
+bool HiZBuffer::CreateResources(D3D11Renderer* renderer, UINT width, UINT height) {
+    m_texture.Reset();
+    m_view.Reset();
+    m_mipViews.clear();
+    m_mipUAVs.clear();
+    m_width = 0;
+    m_height = 0;
+    m_mipCount = 0;
+
+    ID3D11Device* device = renderer->GetDevice();
+
+    if (!m_paramsBuffer) {
+        m_paramsBuffer = renderer->CreateConstantBuffer(sizeof(DownsampleParams));
+        if (!m_paramsBuffer) {
+            LOG_ERROR("Failed to create Hi-Z parameter buffer");
+            return false;
+        }
+    }
+
+    UINT mipCount = 1;
+    while ((std::max(width, height) >> mipCount) > 0) {
+        mipCount++;
+    }
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = width;
+    textureDesc.Height = height;
+    textureDesc.MipLevels = mipCount;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+
+    if (FAILED(device->CreateTexture2D(&textureDesc, nullptr, &m_texture))) {
+        LOG_ERROR("Failed to create " << width << "x" << height << " Hi-Z pyramid");
+        return false;
+    }
+    TrackGpuMemory(m_texture.Get(), Core::MemoryCategory::Renderer);
+
+    if (FAILED(device->CreateShaderResourceView(m_texture.Get(), nullptr, &m_view))) {
+        LOG_ERROR("Failed to create Hi-Z shader resource view");
+        m_texture.Reset();
+        return false;
+    }
+
+    m_mipViews.resize(mipCount);
+    m_mipUAVs.resize(mipCount);
+    for (UINT mip = 0; mip < mipCount; mip++) {
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MostDetailedMip = mip;
+        srvDesc.Texture2D.MipLevels = 1;
+
+        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+        uavDesc.Texture2D.MipSlice = mip;
+
+        if (FAILED(device->CreateShaderResourceView(m_texture.Get(), &srvDesc, &m_mipViews[mip])) ||
+            FAILED(device->CreateUnorderedAccessView(m_texture.Get(), &uavDesc, &m_mipUAVs[mip]))) {
+            LOG_ERROR("Failed to create Hi-Z views for mip " << mip);
+            m_texture.Reset();
+            m_view.Reset();
+            m_mipViews.clear();
+            m_mipUAVs.clear();
+            return false;
+        }
+    }
+
+    m_width = width;
+    m_height = height;
+    m_mipCount = mipCount;
+    return true;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer {
+
+class D3D11Renderer;
+
+using Microsoft::WRL::ComPtr;
+
+// Hierarchical-Z pyramid built from the scene depth buffer.
+//
+// Each texel of mip 0 holds the farthest depth of the depth-buffer texels
+// it covers (mip 0 is half the screen), and each further mip the farthest
+// of the level below, so a box whose nearest depth is behind the pyramid
+// value over its screen rectangle is hidden. The pyramid is built after a
+// frame's draws and tested against the next frame with the view it was
+// built from, which is exact for static geometry.
+class HiZBuffer {
+public:
+    HiZBuffer();
+    ~HiZBuffer() = default;
+
+    void SetShader(ComPtr<ID3D11ComputeShader> shader) { m_shader = shader; }
+    bool IsAvailable() const { return m_shader != nullptr; }
+
+    // Downsample the renderer's depth buffer, rendered with viewProjection.
+    // The depth target is unbound while it is read and restored afterwards.
+    bool Build(D3D11Renderer* renderer, const DirectX::XMMATRIX& viewProjection);
+    void Invalidate() { m_valid = false; }
+    bool IsValid() const { return m_valid; }
+
+    // Every mip, for Texture2D<float>::Load
+    ID3D11ShaderResourceView* GetView() const { return m_view.Get(); }
+    UINT GetWidth() const { return m_width; }
+    UINT GetHeight() const { return m_height; }
+    UINT GetMipCount() const { return m_mipCount; }
+    const DirectX::XMFLOAT4X4& GetViewProjection() const { return m_viewProjection; }
+
+private:
+    static constexpr UINT THREAD_GROUP_SIZE = 8;
+
+    struct DownsampleParams {
+        std::uint32_t sourceSize[2];
+        std::uint32_t destSize[2];
+    };
+
+    bool CreateResources(D3D11Renderer* renderer, UINT width, UINT height);
+
+    ComPtr<ID3D11ComputeShader> m_shader;
+    ComPtr<ID3D11Buffer> m_paramsBuffer;
+
+    ComPtr<ID3D11Texture2D> m_texture;
+    ComPtr<ID3D11ShaderResourceView> m_view;
+    std::vector<ComPtr<ID3D11ShaderResourceView>> m_mipViews;
+    std::vector<ComPtr<ID3D11UnorderedAccessView>> m_mipUAVs;
+
+    UINT m_width;
+    UINT m_height;
+    UINT m_mipCount;
+    DirectX::XMFLOAT4X4 m_viewProjection;
+    bool m_valid;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,319 @@
+#include "IndirectDrawPipeline.h"
+#include "D3D11Renderer.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/Material.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+constexpr UINT ARGS_STRIDE = sizeof(D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS);
+
+} // namespace
+
+IndirectDrawPipeline::IndirectDrawPipeline()
+    : m_culled(false)
+{
+}
+
+void IndirectDrawPipeline::Clear() {
+    m_instances.clear();
+    m_groups.clear();
+    m_initialArgs.clear();
+    ReleaseResources();
+    m_stats = IndirectDrawStats();
+}
+
+void IndirectDrawPipeline::Add(std::shared_ptr<Mesh::Mesh> mesh, UINT subMeshIndex, std::shared_ptr<Mesh::Material> material,
+                               const DirectX::XMMATRIX& worldMatrix, const DirectX::BoundingBox& worldBounds) {
+    if (!mesh || subMeshIndex >= mesh->GetSubMeshCount()) {
+        return;
+    }
+
+    PendingInstance instance;
+    instance.mesh = mesh;
+    instance.material = material;
+    instance.subMeshIndex = subMeshIndex;
+    instance.bounds = worldBounds;
+
+    // Quantized positions are expanded by the world matrix
+    if (mesh->GetVertexFormat() == Mesh::VertexFormat::Quantized) {
+        DirectX::XMStoreFloat4x4(&instance.world, mesh->GetPositionDequantization() * worldMatrix);
+    }
+    else {
+        DirectX::XMStoreFloat4x4(&instance.world, worldMatrix);
+    }
+
+    m_instances.push_back(instance);
+}
+
+bool IndirectDrawPipeline::Build(D3D11Renderer* renderer) {
+    m_groups.clear();
+    m_initialArgs.clear();
+    ReleaseResources();
+
+    if (!renderer || !renderer->GetDevice() || m_instances.empty()) {
+        return false;
+    }
+
+    // Material first so consecutive indirect draws share bindings
+    std::sort(m_instances.begin(), m_instances.end(), [](const PendingInstance& a, const PendingInstance& b) {
+        if (a.material != b.material) {
+            return a.material.get() < b.material.get();
+        }
+        if (a.mesh != b.mesh) {
+            return a.mesh.get() < b.mesh.get();
+        }
+        return a.subMeshIndex < b.subMeshIndex;
+    });
+
+    std::vector<InstanceRecord> records;
+    records.reserve(m_instances.size());
+
+    for (UINT i = 0; i < static_cast<UINT>(m_instances.size()); i++) {
+        const PendingInstance& instance = m_instances[i];
+
+        // Each group's visible instances are appended after its StartInstanceLocation
+        if (m_groups.empty() || m_groups.back().mesh != instance.mesh || m_groups.back().material != instance.material ||
+            m_groups.back().subMeshIndex != instance.subMeshIndex) {
+            DrawGroup group;
+            group.mesh = instance.mesh;
+            group.material = instance.material;
+            group.subMeshIndex = instance.subMeshIndex;
+            DirectX::BoundingSphere::CreateFromBoundingBox(group.bounds, instance.bounds);
+            m_groups.push_back(group);
+
+            Mesh::LODRange range = instance.mesh->GetLODRange(0, instance.subMeshIndex);
+            D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS args = {};
+            args.IndexCountPerInstance = range.indexCount;
+            args.InstanceCount = 0;
+            args.StartIndexLocation = instance.mesh->GetBaseIndex() + range.startIndex;
+            args.BaseVertexLocation = instance.mesh->GetBaseVertex();
+            args.StartInstanceLocation = i;
+            m_initialArgs.push_back(args);
+        }
+        else {
+            DirectX::BoundingSphere sphere;
+            DirectX::BoundingSphere::CreateFromBoundingBox(sphere, instance.bounds);
+            DirectX::BoundingSphere::CreateMerged(m_groups.back().bounds, m_groups.back().bounds, sphere);
+        }
+
+        InstanceRecord record;
+        record.world = instance.world;
+        record.boundsCenter = instance.bounds.Center;
+        record.groupIndex = static_cast<std::uint32_t>(m_groups.size() - 1);
+        record.boundsExtents = instance.bounds.Extents;
+        record.padding = 0;
+        records.push_back(record);
+    }
+
+    UINT instanceCount = static_cast<UINT>(records.size());
+    UINT groupCount = static_cast<UINT>(m_groups.size());
+    UINT visibleSize = instanceCount * sizeof(Mesh::InstanceData);
+
+    m_instanceBuffer = renderer->CreateStructuredBuffer(records.data(), sizeof(InstanceRecord), instanceCount);
+    if (m_instanceBuffer) {
+        m_instanceView = renderer->CreateStructuredShaderResourceView(m_instanceBuffer.Get(), instanceCount);
+    }
+
+    m_visibleBuffer = renderer->CreateRawBuffer(nullptr, visibleSize, D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_UNORDERED_ACCESS);
+    if (m_visibleBuffer) {
+        m_visibleView = renderer->CreateRawUnorderedAccessView(m_visibleBuffer.Get(), visibleSize);
+    }
+
+    m_argsBuffer = renderer->CreateIndirectArgsBuffer(m_initialArgs.data(), groupCount);
+    if (m_argsBuffer) {
+        m_argsView = renderer->CreateRawUnorderedAccessView(m_argsBuffer.Get(), groupCount * ARGS_STRIDE);
+    }
+
+    m_paramsBuffer = renderer->CreateConstantBuffer(sizeof(CullParams));
+
+    if (!m_instanceView || !m_visibleView || !m_argsView || !m_paramsBuffer) {
+        LOG_ERROR("Failed to create indirect draw buffers for " << instanceCount << " instances");
+        ReleaseResources();
+        return false;
+    }
+
+    LOG_INFO("Indirect draws built: " << instanceCount << " instances in " << groupCount << " draw groups");
+    return true;
+}
+
+void IndirectDrawPipeline::Cull(D3D11Renderer* renderer, const DirectX::XMMATRIX& viewProjection) {
+    m_culled = false;
+    if (!IsBuilt() || !m_cullShader) {
+        return;
+    }
+
+    ID3D11DeviceContext* context = renderer->GetContext();
+    UINT instanceCount = static_cast<UINT>(m_instances.size());
+
+    // Restart every group at zero visible instances
+    context->UpdateSubresource(m_argsBuffer.Get(), 0, nullptr, m_initialArgs.data(), 0, 0);
+
+    // World-space frustum planes from the columns of viewProjection (D3D depth range)
+    DirectX::XMMATRIX columns = DirectX::XMMatrixTranspose(viewProjection);
+    DirectX::XMVECTOR planes[6] = {
+        DirectX::XMVectorAdd(columns.r[3], columns.r[0]),        // Left
+        DirectX::XMVectorSubtract(columns.r[3], columns.r[0]),   // Right
+        DirectX::XMVectorAdd(columns.r[3], columns.r[1]),        // Bottom
+        DirectX::XMVectorSubtract(columns.r[3], columns.r[1]),   // Top
+        columns.r[2],                                            // Near
+        DirectX::XMVectorSubtract(columns.r[3], columns.r[2])    // Far
+    };
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if (FAILED(context->Map(m_paramsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+        return;
+    }
+    CullParams* params = static_cast<CullParams*>(mappedResource.pData);
+    for (int i = 0; i < 6; i++) {
+        DirectX::XMStoreFloat4(&params->frustumPlanes[i], DirectX::XMPlaneNormalize(planes[i]));
+    }
+    bool occlusion = m_hiZBuffer.IsValid();
+    DirectX::XMStoreFloat4x4(&params->occlusionViewProjection,
+                             DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_hiZBuffer.GetViewProjection())));
+    params->hiZSize[0] = static_cast<float>(m_hiZBuffer.GetWidth());
+    params->hiZSize[1] = static_cast<float>(m_hiZBuffer.GetHeight());
+    params->hiZMipCount = m_hiZBuffer.GetMipCount();
+    params->occlusionEnabled = occlusion ? 1 : 0;
+    params->instanceCount = instanceCount;
+    params->padding[0] = 0;
+    params->padding[1] = 0;
+    params->padding[2] = 0;
+    context->Unmap(m_paramsBuffer.Get(), 0);
+    renderer->RecordBufferMap(sizeof(CullParams));
+
+    ID3D11ShaderResourceView* inputs[2] = { m_instanceView.Get(), occlusion ? m_hiZBuffer.GetView() : nullptr };
+    ID3D11UnorderedAccessView* views[2] = { m_argsView.Get(), m_visibleView.Get() };
+    context->CSSetShader(m_cullShader.Get(), nullptr, 0);
+    context->CSSetConstantBuffers(0, 1, m_paramsBuffer.GetAddressOf());
+    context->CSSetShaderResources(0, 2, inputs);
+    context->CSSetUnorderedAccessViews(0, 2, views, nullptr);
+    context->Dispatch((instanceCount + THREAD_GROUP_SIZE - 1) / THREAD_GROUP_SIZE, 1, 1);
+
+    // Unbind so the outputs can be used as vertex and argument buffers
+    ID3D11ShaderResourceView* nullViews[2] = { nullptr, nullptr };
+    ID3D11UnorderedAccessView* nullUAVs[2] = { nullptr, nullptr };
+    context->CSSetShaderResources(0, 2, nullViews);
+    context->CSSetUnorderedAccessViews(0, 2, nullUAVs, nullptr);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    m_culled = true;
+}
+
+void IndirectDrawPipeline::Draw(D3D11Renderer* renderer) {
+    m_stats = IndirectDrawStats();
+    m_stats.instances = static_cast<UINT>(m_instances.size());
+    m_stats.drawGroups = static_cast<UINT>(m_groups.size());
+
+    if (!m_culled || !m_instancedShader) {
+        return;
+    }
+
+    // Shared with the renderer's setters so they stay in sync afterwards
+    ID3D11DeviceContext* context = renderer->GetContext();
+    ContextStateCache& stateCache = renderer->GetStateCache();
+    stateCache.Reset(context);
+    ID3D11VertexShader* baseVertexShader = stateCache.GetVertexShader();
+    ID3D11InputLayout* baseInputLayout = stateCache.GetInputLayout();
+    ID3D11RasterizerState* baseRasterizerState = stateCache.GetRasterizerState();
+    ID3D11BlendState* baseBlendState = stateCache.GetBlendState();
+
+    // World comes from the instance stream, only the view constants matter
+    renderer->UpdateViewConstants(renderer->GetViewMatrix().ToXMMATRIX(), renderer->GetProjectionMatrix().ToXMMATRIX());
+
+    stateCache.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    stateCache.SetVertexBuffer(m_visibleBuffer.Get(), sizeof(Mesh::InstanceData), 1);
+
+    const Mesh::Material* currentMaterial = nullptr;
+    for (UINT i = 0; i < static_cast<UINT>(m_groups.size()); i++) {
+        const DrawGroup& group = m_groups[i];
+
+        // A mismatched layout would read garbage, so formats without one are not drawn
+        ID3D11InputLayout* inputLayout = m_instancedLayouts.Get(group.mesh->GetVertexFormat());
+        if (!inputLayout) {
+            continue;
+        }
+
+        stateCache.SetVertexShader(m_instancedShader.Get(), inputLayout);
+        stateCache.SetIndexBuffer(group.mesh->GetIndexBuffer(), group.mesh->GetIndexFormat());
+        stateCache.SetVertexBuffer(group.mesh->GetVertexBuffer(), group.mesh->GetVertexStride());
+
+        if (group.material.get() != currentMaterial) {
+            Mesh::Material* applied = group.material ? group.material.get() : renderer->GetDefaultMaterial();
+            if (applied) {
+                applied->Apply(stateCache);
+            }
+            ID3D11RasterizerState* rasterizerState = group.material ? group.material->GetRasterizerState() : nullptr;
+            ID3D11BlendState* blendState = group.material ? group.material->GetBlendState() : nullptr;
+            stateCache.SetRasterizerState(rasterizerState ? rasterizerState : baseRasterizerState);
+            stateCache.SetBlendState(blendState ? blendState : baseBlendState);
+            currentMaterial = group.material.get();
+            m_stats.materialChanges++;
+        }
+
+        context->DrawIndexedInstancedIndirect(m_argsBuffer.Get(), i * ARGS_STRIDE);
+        m_stats.indirectDrawCalls++;
+    }
+
+    // Leave the caller's states bound for the passes that follow
+    stateCache.SetVertexShader(baseVertexShader, baseInputLayout);
+    stateCache.SetRasterizerState(baseRasterizerState);
+    stateCache.SetBlendState(baseBlendState);
+
+    RenderFrameStats frameStats;
+    frameStats.drawCalls = m_stats.indirectDrawCalls;
+    frameStats.indirectDrawCalls = m_stats.indirectDrawCalls;
+    renderer->AddFrameStats(frameStats);
+}
+
+void IndirectDrawPipeline::BuildOcclusion(D3D11Renderer* renderer, const DirectX::XMMATRIX& viewProjection) {
+    // Nothing reads the pyramid without GPU-driven instances
+    if (!IsBuilt() || !m_hiZBuffer.IsAvailable()) {
+        m_hiZBuffer.Invalidate();
+        return;
+    }
+
+    m_hiZBuffer.Build(renderer, viewProjection);
+}
+
+void IndirectDrawPipeline::RequestTextureResolution(const DirectX::XMFLOAT3& cameraPosition, float projectionScale,
+                                                    float screenHeight) const {
+    DirectX::XMVECTOR camera = DirectX::XMLoadFloat3(&cameraPosition);
+
+    // Groups are sorted by material, so each material's groups are consecutive
+    float largest = 0.0f;
+    for (size_t i = 0; i < m_groups.size(); i++) {
+        const DrawGroup& group = m_groups[i];
+        float radius = group.bounds.Radius;
+        float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(
+            DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&group.bounds.Center), camera)));
+        float screenSize = distance > radius ? radius * projectionScale / distance : projectionScale;
+        largest = std::max(largest, screenSize);
+
+        bool lastOfMaterial = i + 1 == m_groups.size() || m_groups[i + 1].material != group.material;
+        if (lastOfMaterial) {
+            if (group.material) {
+                group.material->RequestTextureResolution(static_cast<UINT>(std::max(largest * screenHeight, 1.0f)));
+            }
+            largest = 0.0f;
+        }
+    }
+}
+
+void IndirectDrawPipeline::ReleaseResources() {
+    m_instanceView.Reset();
+    m_instanceBuffer.Reset();
+    m_visibleView.Reset();
+    m_visibleBuffer.Reset();
+    m_argsView.Reset();
+    m_argsBuffer.Reset();
+    m_paramsBuffer.Reset();
+    m_culled = false;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
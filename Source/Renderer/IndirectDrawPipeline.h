@@ -0,0 +1,155 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "HiZBuffer.h"
+#include "../Mesh/Vertex.h"
+
+namespace GameEngine {
+
+// Forward declarations
+namespace Mesh {
+    class Mesh;
+    class Material;
+}
+
+namespace Renderer {
+
+class D3D11Renderer;
+
+using Microsoft::WRL::ComPtr;
+
+// Per-frame indirect drawing statistics
+struct IndirectDrawStats {
+    UINT instances = 0;          // Static instances culled on the GPU
+    UINT drawGroups = 0;         // (material, mesh, submesh) groups, one indirect draw each
+    UINT indirectDrawCalls = 0;
+    UINT materialChanges = 0;
+};
+
+// GPU-driven drawing for static geometry.
+//
+// Instance transforms, world bounds and per-group mesh ranges are uploaded
+// once by Build. Each frame CullInstancesComputeShader tests every instance
+// against the view frustum, appends the visible ones to an instance stream
+// and counts them into DrawIndexedInstancedIndirect arguments, one record
+// per (material, mesh, submesh) group. The CPU then issues one indirect
+// draw per group with the instancing shader, so its cost depends on the
+// number of groups rather than the number of objects. Meshes packed by
+// StaticMeshBatcher draw from their shared buffers with base offsets.
+//
+// With a Hi-Z shader set, instances that passed the frustum test are also
+// tested against the previous frame's depth pyramid, reprojected with the
+// view it was built from; BuildOcclusion refreshes it after the frame's draws.
+class IndirectDrawPipeline {
+public:
+    IndirectDrawPipeline();
+    ~IndirectDrawPipeline() = default;
+
+    // Both shaders are needed; the vertex shader takes InstanceData like
+    // RenderQueue's instancing shader
+    void SetCullingShader(ComPtr<ID3D11ComputeShader> shader) { m_cullShader = shader; }
+    void SetInstancingShader(ComPtr<ID3D11VertexShader> shader, const Mesh::VertexInputLayouts& layouts) {
+        m_instancedShader = shader;
+        m_instancedLayouts = layouts;
+    }
+    bool IsAvailable() const { return m_cullShader && m_instancedShader; }
+
+    // Occlusion culling against last frame's depth (HiZDownsampleComputeShader)
+    void SetHiZShader(ComPtr<ID3D11ComputeShader> shader) { m_hiZBuffer.SetShader(shader); }
+    void BuildOcclusion(D3D11Renderer* renderer, const DirectX::XMMATRIX& viewProjection);
+    void ResetOcclusion() { m_hiZBuffer.Invalidate(); }
+    const HiZBuffer& GetHiZBuffer() const { return m_hiZBuffer; }
+
+    // Build-time: add every static draw, then upload them
+    void Clear();
+    void Add(std::shared_ptr<Mesh::Mesh> mesh, UINT subMeshIndex, std::shared_ptr<Mesh::Material> material,
+             const DirectX::XMMATRIX& worldMatrix, const DirectX::BoundingBox& worldBounds);
+    bool Build(D3D11Renderer* renderer);
+    bool IsBuilt() const { return m_argsBuffer != nullptr; }
+    size_t GetInstanceCount() const { return m_instances.size(); }
+
+    // Per frame: cull against viewProjection, then draw with the pixel
+    // shader bound by the caller. Bound vertex shader and layout are restored.
+    void Cull(D3D11Renderer* renderer, const DirectX::XMMATRIX& viewProjection);
+    void Draw(D3D11Renderer* renderer);
+
+    // Texture streaming feedback, once per material rather than per object:
+    // the largest screen height any of its groups' bounding spheres projects to
+    void RequestTextureResolution(const DirectX::XMFLOAT3& cameraPosition, float projectionScale, float screenHeight) const;
+
+    const IndirectDrawStats& GetStats() const { return m_stats; }
+
+private:
+    static constexpr UINT THREAD_GROUP_SIZE = 64;
+
+    void ReleaseResources();
+
+    // Matches CullInstancesComputeShader's InstanceRecord
+    struct InstanceRecord {
+        DirectX::XMFLOAT4X4 world;
+        DirectX::XMFLOAT3 boundsCenter;
+        std::uint32_t groupIndex;
+        DirectX::XMFLOAT3 boundsExtents;
+        std::uint32_t padding;
+    };
+
+    struct CullParams {
+        DirectX::XMFLOAT4 frustumPlanes[6];
+        DirectX::XMFLOAT4X4 occlusionViewProjection;   // Transposed for HLSL
+        float hiZSize[2];
+        std::uint32_t hiZMipCount;
+        std::uint32_t occlusionEnabled;
+        std::uint32_t instanceCount;
+        std::uint32_t padding[3];
+    };
+
+    struct DrawGroup {
+        std::shared_ptr<Mesh::Mesh> mesh;
+        std::shared_ptr<Mesh::Material> material;
+        UINT subMeshIndex;
+        DirectX::BoundingSphere bounds;     // Around every instance in the group
+    };
+
+    // Instance added before Build, grouped when it is uploaded
+    struct PendingInstance {
+        std::shared_ptr<Mesh::Mesh> mesh;
+        std::shared_ptr<Mesh::Material> material;
+        UINT subMeshIndex;
+        DirectX::XMFLOAT4X4 world;
+        DirectX::BoundingBox bounds;
+    };
+
+    std::vector<DrawGroup> m_groups;
+    std::vector<PendingInstance> m_instances;
+
+    // Arguments with zero instance counts, copied over the live ones each frame
+    std::vector<D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS> m_initialArgs;
+
+    // Shaders
+    ComPtr<ID3D11ComputeShader> m_cullShader;
+    ComPtr<ID3D11VertexShader> m_instancedShader;
+    Mesh::VertexInputLayouts m_instancedLayouts;
+
+    // GPU resources
+    ComPtr<ID3D11Buffer> m_instanceBuffer;
+    ComPtr<ID3D11ShaderResourceView> m_instanceView;
+    ComPtr<ID3D11Buffer> m_visibleBuffer;              // InstanceData stream, vertex slot 1
+    ComPtr<ID3D11UnorderedAccessView> m_visibleView;
+    ComPtr<ID3D11Buffer> m_argsBuffer;
+    ComPtr<ID3D11UnorderedAccessView> m_argsView;
+    ComPtr<ID3D11Buffer> m_paramsBuffer;
+
+    HiZBuffer m_hiZBuffer;
+
+    IndirectDrawStats m_stats;
+    bool m_culled;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -1,7 +1,10 @@
 #include "Light.h"
+#include "ShadowAtlas.h"
 #include "../Core/Logger.h"
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <numeric>
 
 namespace GameEngine {
 namespace Renderer {
@@ -24,10 +27,9 @@ DirectionalLight::DirectionalLight()
     : Light(LightType::Directional)
     , m_direction(0.0f, -1.0f, 0.0f)
     , m_cascadeCount(3)
+    , m_splitLambda(0.75f)
     , m_shadowDistance(100.0f)
 {
-    // Default cascade distances
-    m_cascadeDistances = { 10.0f, 30.0f, 100.0f };
 }
 
 void DirectionalLight::SetDirection(const DirectX::XMFLOAT3& direction) {
@@ -63,76 +65,131 @@ DirectX::XMMATRIX DirectionalLight::GetProjectionMatrix() const {
     return DirectX::XMMatrixOrthographicLH(size, size, 0.1f, m_shadowDistance);
 }
 
-std::vector<DirectX::XMMATRIX> DirectionalLight::GetCascadeViewProjectionMatrices(
+std::vector<float> DirectionalLight::ComputeCascadeSplits(float nearPlane, float farPlane) const {
+    std::vector<float> splits;
+    if (m_cascadeCount <= 0) {
+        return splits;
+    }
+
+    farPlane = std::min(farPlane, m_shadowDistance);
+    nearPlane = std::max(std::min(nearPlane, farPlane * 0.5f), 0.001f);
+
+    // Explicit distances win over the split scheme
+    if (!m_cascadeDistances.empty()) {
+        for (int i = 0; i < m_cascadeCount; i++) {
+            float distance = i < static_cast<int>(m_cascadeDistances.size()) ? m_cascadeDistances[i] : farPlane;
+            splits.push_back(std::min(distance, farPlane));
+        }
+        return splits;
+    }
+
+    // Practical split scheme: blend logarithmic and uniform distributions
+    float lambda = std::max(0.0f, std::min(m_splitLambda, 1.0f));
+    for (int i = 1; i <= m_cascadeCount; i++) {
+        float fraction = static_cast<float>(i) / static_cast<float>(m_cascadeCount);
+        float logSplit = nearPlane * std::pow(farPlane / nearPlane, fraction);
+        float uniformSplit = nearPlane + (farPlane - nearPlane) * fraction;
+        splits.push_back(lambda * logSplit + (1.0f - lambda) * uniformSplit);
+    }
+
+    return splits;
+}
+
+std::vector<DirectionalLight::ShadowCascade> DirectionalLight::GetCascades(
     const DirectX::XMMATRIX& cameraView,
-    const DirectX::XMMATRIX& cameraProjection) const {
+    const DirectX::XMMATRIX& cameraProjection,
+    int resolution) const {
 
-    std::vector<DirectX::XMMATRIX> cascadeMatrices;
-    cascadeMatrices.reserve(m_cascadeCount);
+    std::vector<ShadowCascade> cascades;
+
+    // Camera range from a left-handed perspective projection
+    DirectX::XMFLOAT4X4 projection;
+    DirectX::XMStoreFloat4x4(&projection, cameraProjection);
+    float cameraNear = -projection._43 / projection._33;
+    float cameraFar = projection._43 / (1.0f - projection._33);
 
-    float nearPlane = 0.1f;
-    for (int i = 0; i < m_cascadeCount; i++) {
-        float farPlane = m_cascadeDistances[i];
+    std::vector<float> splits = ComputeCascadeSplits(cameraNear, cameraFar);
+    cascades.reserve(splits.size());
 
-        // Get frustum corners for this cascade
+    float nearPlane = std::max(cameraNear, 0.001f);
+    for (float farPlane : splits) {
         auto frustumCorners = GetFrustumCorners(cameraView, cameraProjection, nearPlane, farPlane);
 
-        // Calculate light space matrix for this cascade
-        DirectX::XMMATRIX lightSpaceMatrix = CalculateLightSpaceMatrix(frustumCorners);
-        cascadeMatrices.push_back(lightSpaceMatrix);
+        ShadowCascade cascade = FitCascade(frustumCorners, std::max(resolution, 1));
+        cascade.splitNear = nearPlane;
+        cascade.splitFar = farPlane;
+        cascades.push_back(cascade);
 
         nearPlane = farPlane;
     }
 
-    return cascadeMatrices;
+    return cascades;
 }
 
-DirectX::XMMATRIX DirectionalLight::CalculateLightSpaceMatrix(
-    const std::vector<DirectX::XMFLOAT3>& frustumCorners) const {
+std::vector<DirectX::XMMATRIX> DirectionalLight::GetCascadeViewProjectionMatrices(
+    const DirectX::XMMATRIX& cameraView,
+    const DirectX::XMMATRIX& cameraProjection) const {
 
-    // Calculate center of frustum
-    DirectX::XMVECTOR center = DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f);
-    for (const auto& corner : frustumCorners) {
-        DirectX::XMVECTOR cornerVec = DirectX::XMLoadFloat3(&corner);
-        center = DirectX::XMVectorAdd(center, cornerVec);
+    std::vector<DirectX::XMMATRIX> cascadeMatrices;
+    cascadeMatrices.reserve(m_cascadeCount);
+
+    for (const ShadowCascade& cascade : GetCascades(cameraView, cameraProjection, m_shadowMapSize)) {
+        cascadeMatrices.push_back(DirectX::XMMatrixMultiply(cascade.view, cascade.projection));
     }
-    center = DirectX::XMVectorScale(center, 1.0f / frustumCorners.size());
 
-    // Create light view matrix
-    DirectX::XMVECTOR lightDir = DirectX::XMLoadFloat3(&m_direction);
-    DirectX::XMVECTOR lightPos = DirectX::XMVectorSubtract(center, DirectX::XMVectorScale(lightDir, 100.0f));
-    DirectX::XMMATRIX lightView = DirectX::XMMatrixLookAtLH(
-        lightPos,
-        DirectX::XMVectorAdd(lightPos, lightDir),
-        DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)
-    );
+    return cascadeMatrices;
+}
 
-    // Transform frustum corners to light space
-    float minX = FLT_MAX, maxX = -FLT_MAX;
-    float minY = FLT_MAX, maxY = -FLT_MAX;
-    float minZ = FLT_MAX, maxZ = -FLT_MAX;
+DirectionalLight::ShadowCascade DirectionalLight::FitCascade(
+    const std::vector<DirectX::XMFLOAT3>& frustumCorners,
+    int resolution) const {
 
+    // Bounding sphere of the slice; its size does not change as the camera
+    // rotates, so the texel footprint stays constant
+    DirectX::XMVECTOR center = DirectX::XMVectorZero();
     for (const auto& corner : frustumCorners) {
-        DirectX::XMVECTOR cornerVec = DirectX::XMLoadFloat3(&corner);
-        DirectX::XMVECTOR lightSpaceCorner = DirectX::XMVector3Transform(cornerVec, lightView);
-
-        float x = DirectX::XMVectorGetX(lightSpaceCorner);
-        float y = DirectX::XMVectorGetY(lightSpaceCorner);
-        float z = DirectX::XMVectorGetZ(lightSpaceCorner);
-
-        minX = std::min(minX, x);
-        maxX = std::max(maxX, x);
-        minY = std::min(minY, y);
-        maxY = std::max(maxY, y);
-        minZ = std::min(minZ, z);
-        maxZ = std::max(maxZ, z);
+        center = DirectX::XMVectorAdd(center, DirectX::XMLoadFloat3(&corner));
     }
+    center = DirectX::XMVectorScale(center, 1.0f / frustumCorners.size());
 
-    // Create orthographic projection
-    DirectX::XMMATRIX lightProjection = DirectX::XMMatrixOrthographicOffCenterLH(
-        minX, maxX, minY, maxY, minZ, maxZ);
-
-    return DirectX::XMMatrixMultiply(lightView, lightProjection);
+    float radius = 0.0f;
+    for (const auto& corner : frustumCorners) {
+        DirectX::XMVECTOR offset = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&corner), center);
+        radius = std::max(radius, DirectX::XMVectorGetX(DirectX::XMVector3Length(offset)));
+    }
+    // Quantize so float noise in the corners cannot change the scale
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+
+    // Fixed light rotation; only the projection follows the camera
+    DirectX::XMMATRIX lightView = GetViewMatrix();
+    DirectX::XMFLOAT3 lightCenter;
+    DirectX::XMStoreFloat3(&lightCenter, DirectX::XMVector3TransformCoord(center, lightView));
+
+    // Move in whole texels so edges do not shimmer
+    float texelSize = 2.0f * radius / static_cast<float>(resolution);
+    lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+    lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+    // Pull the near plane back so casters outside the slice still shadow it
+    float minZ = lightCenter.z - radius - m_shadowDistance;
+    float maxZ = lightCenter.z + radius;
+
+    ShadowCascade cascade;
+    cascade.view = lightView;
+    cascade.projection = DirectX::XMMatrixOrthographicOffCenterLH(
+        lightCenter.x - radius, lightCenter.x + radius,
+        lightCenter.y - radius, lightCenter.y + radius,
+        minZ, maxZ);
+
+    DirectX::BoundingOrientedBox lightBounds(
+        DirectX::XMFLOAT3(lightCenter.x, lightCenter.y, 0.5f * (minZ + maxZ)),
+        DirectX::XMFLOAT3(radius, radius, 0.5f * (maxZ - minZ)),
+        DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    lightBounds.Transform(cascade.bounds, DirectX::XMMatrixInverse(nullptr, lightView));
+
+    cascade.splitNear = 0.0f;
+    cascade.splitFar = 0.0f;
+    return cascade;
 }
 
 std::vector<DirectX::XMFLOAT3> DirectionalLight::GetFrustumCorners(
@@ -147,10 +204,16 @@ std::vector<DirectX::XMFLOAT3> DirectionalLight::GetFrustumCorners(
     std::vector<DirectX::XMFLOAT3> corners;
     corners.reserve(8);
 
+    // NDC depth of the slice planes for this perspective projection
+    DirectX::XMFLOAT4X4 proj;
+    DirectX::XMStoreFloat4x4(&proj, projection);
+    float nearZ = proj._33 + proj._43 / nearPlane;
+    float farZ = proj._33 + proj._43 / farPlane;
+
     // Define frustum corners in NDC space
     DirectX::XMFLOAT3 ndcCorners[8] = {
-        {-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}, // Near
-        {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}  // Far
+        {-1.0f, -1.0f, nearZ}, {1.0f, -1.0f, nearZ}, {1.0f, 1.0f, nearZ}, {-1.0f, 1.0f, nearZ}, // Near
+        {-1.0f, -1.0f, farZ}, {1.0f, -1.0f, farZ}, {1.0f, 1.0f, farZ}, {-1.0f, 1.0f, farZ}      // Far
     };
 
     // Transform to world space
@@ -280,6 +343,10 @@ void LightManager::RemoveLight(std::shared_ptr<Light> light) {
     auto it = std::find(m_lights.begin(), m_lights.end(), light);
     if (it != m_lights.end()) {
         m_lights.erase(it);
+
+        // Indices past the removed light are stale until the next cull
+        m_visibleLights.clear();
+        m_visibleScores.clear();
         LOG_DEBUG("Light removed from manager");
     }
 }
@@ -287,6 +354,7 @@ void LightManager::RemoveLight(std::shared_ptr<Light> light) {
 void LightManager::RemoveAllLights() {
     m_lights.clear();
     m_visibleLights.clear();
+    m_visibleScores.clear();
     LOG_DEBUG("All lights removed from manager");
 }
 
@@ -338,45 +406,208 @@ std::vector<std::shared_ptr<Light>> LightManager::GetShadowCastingLights() const
 
 void LightManager::CullLights(const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix) {
     m_visibleLights.clear();
+    m_visibleScores.clear();
+
+    GatherCullingData();
+
+    // Frustum planes from the columns of the row-vector view-projection, normals pointing in
+    DirectX::XMMATRIX columns = DirectX::XMMatrixTranspose(DirectX::XMMatrixMultiply(viewMatrix, projectionMatrix));
+    DirectX::XMVECTOR planes[6] = {
+        DirectX::XMVectorAdd(columns.r[3], columns.r[0]),       // Left
+        DirectX::XMVectorSubtract(columns.r[3], columns.r[0]),  // Right
+        DirectX::XMVectorAdd(columns.r[3], columns.r[1]),       // Bottom
+        DirectX::XMVectorSubtract(columns.r[3], columns.r[1]),  // Top
+        columns.r[2],                                           // Near
+        DirectX::XMVectorSubtract(columns.r[3], columns.r[2])   // Far
+    };
 
-    for (const auto& light : m_lights) {
-        if (light->IsEnabled() && IsLightVisible(light.get(), viewMatrix, projectionMatrix)) {
-            m_visibleLights.push_back(light);
+    // Splat each plane so one register holds a component for four lights
+    DirectX::XMVECTOR planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++) {
+        DirectX::XMVECTOR plane = DirectX::XMPlaneNormalize(planes[p]);
+        planeX[p] = DirectX::XMVectorSplatX(plane);
+        planeY[p] = DirectX::XMVectorSplatY(plane);
+        planeZ[p] = DirectX::XMVectorSplatZ(plane);
+        planeW[p] = DirectX::XMVectorSplatW(plane);
+    }
+
+    DirectX::XMVECTOR determinant;
+    DirectX::XMVECTOR cameraPosition = DirectX::XMMatrixInverse(&determinant, viewMatrix).r[3];
+
+    const DirectX::XMVECTOR zero = DirectX::XMVectorZero();
+    const DirectX::XMVECTOR one = DirectX::XMVectorSplatOne();
+
+    size_t lightCount = m_lights.size();
+    for (size_t i = 0; i < m_culling.radius.size(); i += 4) {
+        DirectX::XMVECTOR px = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.positionX[i]));
+        DirectX::XMVECTOR py = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.positionY[i]));
+        DirectX::XMVECTOR pz = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.positionZ[i]));
+        DirectX::XMVECTOR radius = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.radius[i]));
+        DirectX::XMVECTOR dx = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.directionX[i]));
+        DirectX::XMVECTOR dy = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.directionY[i]));
+        DirectX::XMVECTOR dz = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.directionZ[i]));
+        DirectX::XMVECTOR coneHeight = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.coneHeight[i]));
+        DirectX::XMVECTOR coneRadius = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&m_culling.coneRadius[i]));
+
+        DirectX::XMVECTOR negativeRadius = DirectX::XMVectorNegate(radius);
+        DirectX::XMVECTOR notCone = DirectX::XMVectorLessOrEqual(coneHeight, zero);
+        DirectX::XMVECTOR visible = DirectX::XMVectorTrueInt();
+
+        for (int p = 0; p < 6; p++) {
+            // Signed distance of the light position (sphere center, cone apex)
+            DirectX::XMVECTOR apex = DirectX::XMVectorMultiplyAdd(px, planeX[p],
+                DirectX::XMVectorMultiplyAdd(py, planeY[p], DirectX::XMVectorMultiplyAdd(pz, planeZ[p], planeW[p])));
+            DirectX::XMVECTOR insideSphere = DirectX::XMVectorGreaterOrEqual(apex, negativeRadius);
+
+            // Furthest point of the cone's base disk along the plane normal
+            DirectX::XMVECTOR axisDot = DirectX::XMVectorMultiplyAdd(dx, planeX[p],
+                DirectX::XMVectorMultiplyAdd(dy, planeY[p], DirectX::XMVectorMultiply(dz, planeZ[p])));
+            DirectX::XMVECTOR perpendicular = DirectX::XMVectorSqrt(DirectX::XMVectorMax(zero,
+                DirectX::XMVectorNegativeMultiplySubtract(axisDot, axisDot, one)));
+            DirectX::XMVECTOR base = DirectX::XMVectorMultiplyAdd(coneRadius, perpendicular,
+                DirectX::XMVectorMultiplyAdd(coneHeight, axisDot, apex));
+            DirectX::XMVECTOR insideCone = DirectX::XMVectorOrInt(DirectX::XMVectorGreaterOrEqual(apex, zero),
+                                                                  DirectX::XMVectorGreaterOrEqual(base, zero));
+
+            DirectX::XMVECTOR inside = DirectX::XMVectorAndInt(insideSphere, DirectX::XMVectorOrInt(insideCone, notCone));
+            visible = DirectX::XMVectorAndInt(visible, inside);
+        }
+
+        DirectX::XMUINT4 mask;
+        DirectX::XMStoreUInt4(&mask, visible);
+        const std::uint32_t lanes[4] = { mask.x, mask.y, mask.z, mask.w };
+        for (size_t lane = 0; lane < 4 && i + lane < lightCount; lane++) {
+            if (lanes[lane]) {
+                std::uint32_t index = static_cast<std::uint32_t>(i + lane);
+                m_visibleLights.push_back(index);
+                m_visibleScores.push_back(ComputeScreenContribution(m_lights[index].get(), cameraPosition));
+            }
         }
     }
 }
 
-std::vector<LightData> LightManager::PrepareShaderData(size_t maxLights) const {
+std::vector<LightData> LightManager::PrepareShaderData(size_t maxLights, const ShadowAtlas* shadowAtlas) const {
     std::vector<LightData> shaderData;
-    shaderData.reserve(std::min(m_visibleLights.size(), maxLights));
+    size_t count = std::min(m_visibleLights.size(), maxLights);
+    shaderData.reserve(count);
+
+    if (m_visibleLights.size() <= maxLights) {
+        for (std::uint32_t index : m_visibleLights) {
+            shaderData.push_back(ConvertToShaderData(m_lights[index].get(), shadowAtlas));
+        }
+        return shaderData;
+    }
 
-    size_t count = 0;
-    for (const auto& light : m_visibleLights) {
-        if (count >= maxLights) break;
+    // Over budget: keep the lights that cover the most screen
+    std::vector<std::uint32_t> order(m_visibleLights.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::nth_element(order.begin(), order.begin() + count, order.end(),
+        [this](std::uint32_t a, std::uint32_t b) {
+            return m_visibleScores[a] > m_visibleScores[b];
+        });
 
-        shaderData.push_back(ConvertToShaderData(light.get()));
-        count++;
+    for (size_t i = 0; i < count; i++) {
+        shaderData.push_back(ConvertToShaderData(m_lights[m_visibleLights[order[i]]].get(), shadowAtlas));
     }
 
     return shaderData;
 }
 
-bool LightManager::IsLightVisible(const Light* light,
-    const DirectX::XMMATRIX& viewMatrix,
-    const DirectX::XMMATRIX& projectionMatrix) const {
+void LightManager::CullingData::Resize(size_t count) {
+    positionX.resize(count);
+    positionY.resize(count);
+    positionZ.resize(count);
+    radius.resize(count);
+    directionX.resize(count);
+    directionY.resize(count);
+    directionZ.resize(count);
+    coneHeight.resize(count);
+    coneRadius.resize(count);
+}
 
-    // Simplified visibility test - in a real engine you'd do proper frustum culling
-    if (light->GetType() == LightType::Directional) {
-        return true; // Directional lights are always visible
+void LightManager::GatherCullingData() {
+    size_t lightCount = m_lights.size();
+    size_t paddedCount = (lightCount + 3) & ~static_cast<size_t>(3);
+    m_culling.Resize(paddedCount);
+
+    for (size_t i = 0; i < paddedCount; i++) {
+        const Light* light = i < lightCount ? m_lights[i].get() : nullptr;
+
+        DirectX::XMFLOAT3 position(0.0f, 0.0f, 0.0f);
+        DirectX::XMFLOAT3 direction(0.0f, 0.0f, 0.0f);
+        float radius = -FLT_MAX; // Never passes a plane test
+        float coneHeight = 0.0f;
+        float coneRadius = 0.0f;
+
+        if (light && light->IsEnabled()) {
+            switch (light->GetType()) {
+                case LightType::Directional:
+                    radius = FLT_MAX;
+                    break;
+                case LightType::Point: {
+                    auto pointLight = static_cast<const PointLight*>(light);
+                    position = pointLight->GetPosition();
+                    radius = pointLight->GetRange();
+                    break;
+                }
+                case LightType::Spot: {
+                    auto spotLight = static_cast<const SpotLight*>(light);
+                    position = spotLight->GetPosition();
+                    direction = spotLight->GetDirection();
+                    radius = spotLight->GetRange();
+
+                    // Wide cones are no tighter than their sphere
+                    float angle = spotLight->GetOuterConeAngle();
+                    if (angle < DirectX::XM_PIDIV2 * 0.95f) {
+                        coneHeight = radius;
+                        coneRadius = radius * std::tan(angle);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        m_culling.positionX[i] = position.x;
+        m_culling.positionY[i] = position.y;
+        m_culling.positionZ[i] = position.z;
+        m_culling.radius[i] = radius;
+        m_culling.directionX[i] = direction.x;
+        m_culling.directionY[i] = direction.y;
+        m_culling.directionZ[i] = direction.z;
+        m_culling.coneHeight[i] = coneHeight;
+        m_culling.coneRadius[i] = coneRadius;
     }
+}
+
+float LightManager::ComputeScreenContribution(const Light* light, const DirectX::XMVECTOR& cameraPosition) const {
+    const DirectX::XMFLOAT3& color = light->GetColor();
+    float brightness = light->GetIntensity() * std::max(color.x, std::max(color.y, color.z));
 
-    // For point and spot lights, check if they're within range
-    // This is a simplified implementation
-    return true;
+    DirectX::XMFLOAT3 position;
+    switch (light->GetType()) {
+        case LightType::Point:
+            position = static_cast<const PointLight*>(light)->GetPosition();
+            break;
+        case LightType::Spot:
+            position = static_cast<const SpotLight*>(light)->GetPosition();
+            break;
+        default:
+            return FLT_MAX; // Directional lights always make the cut
+    }
+
+    // Squared projected radius, saturating once the camera is inside the range
+    float range = light->GetRange();
+    float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(
+        DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&position), cameraPosition)));
+    float coverage = range / std::max(distance, std::max(range, 0.0001f));
+    return brightness * coverage * coverage;
 }
 
-LightData LightManager::ConvertToShaderData(const Light* light) const {
+LightData LightManager::ConvertToShaderData(const Light* light, const ShadowAtlas* shadowAtlas) const {
     LightData data;
+    data.shadowAtlasRect = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
 
     // Set common properties
     data.color = DirectX::XMFLOAT4(light->GetColor().x, light->GetColor().y, light->GetColor().z, light->GetIntensity());
@@ -409,6 +640,12 @@ LightData LightManager::ConvertToShaderData(const Light* light) const {
 
     // Set light space matrix for shadow mapping
     DirectX::XMMATRIX lightSpace = DirectX::XMMatrixMultiply(light->GetViewMatrix(), light->GetProjectionMatrix());
+    ShadowAtlas::Tile tile;
+    if (shadowAtlas && light->IsCastingShadows() && shadowAtlas->GetShadowMatrix(light, lightSpace) &&
+        shadowAtlas->GetTile(light, tile)) {
+        float atlasSize = static_cast<float>(shadowAtlas->GetSize());
+        data.shadowAtlasRect = DirectX::XMFLOAT4(tile.x / atlasSize, tile.y / atlasSize, tile.size / atlasSize, tile.size / atlasSize);
+    }
     DirectX::XMStoreFloat4x4(&data.lightSpaceMatrix, lightSpace);
 
     return data;
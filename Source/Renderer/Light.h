@@ -1,12 +1,16 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
 namespace GameEngine {
 namespace Renderer {
 
+class ShadowAtlas;
+
 // Light types
 enum class LightType {
     Directional = 0,
@@ -75,16 +79,40 @@ public:
     void SetDirection(const DirectX::XMFLOAT3& direction);
     void SetDirection(float x, float y, float z);
 
+    // One cascade: an orthographic projection around the bounding sphere of
+    // its slice of the camera frustum, snapped to whole shadow map texels
+    struct ShadowCascade {
+        DirectX::XMMATRIX view;
+        DirectX::XMMATRIX projection;
+        DirectX::BoundingOrientedBox bounds;    // World-space caster volume
+        float splitNear;
+        float splitFar;
+    };
+
     // Cascade shadow map properties
     int GetCascadeCount() const { return m_cascadeCount; }
     void SetCascadeCount(int count) { m_cascadeCount = count; }
 
+    // Far distance of each cascade. Setting them overrides the PSSM splits.
     const std::vector<float>& GetCascadeDistances() const { return m_cascadeDistances; }
     void SetCascadeDistances(const std::vector<float>& distances) { m_cascadeDistances = distances; }
 
+    // PSSM blend between uniform (0) and logarithmic (1) split distances
+    float GetSplitLambda() const { return m_splitLambda; }
+    void SetSplitLambda(float lambda) { m_splitLambda = lambda; }
+
     float GetShadowDistance() const { return m_shadowDistance; }
     void SetShadowDistance(float distance) { m_shadowDistance = distance; }
 
+    // Cascade far distances for a camera range, capped at the shadow distance
+    std::vector<float> ComputeCascadeSplits(float nearPlane, float farPlane) const;
+
+    // Stable cascades for the camera; resolution is the cascade texture size
+    std::vector<ShadowCascade> GetCascades(
+        const DirectX::XMMATRIX& cameraView,
+        const DirectX::XMMATRIX& cameraProjection,
+        int resolution) const;
+
     // Light space matrices for cascades
     std::vector<DirectX::XMMATRIX> GetCascadeViewProjectionMatrices(
         const DirectX::XMMATRIX& cameraView,
@@ -100,11 +128,13 @@ private:
     // Cascade shadow mapping
     int m_cascadeCount;
     std::vector<float> m_cascadeDistances;
+    float m_splitLambda;
     float m_shadowDistance;
 
     // Helper methods
-    DirectX::XMMATRIX CalculateLightSpaceMatrix(
-        const std::vector<DirectX::XMFLOAT3>& frustumCorners) const;
+    ShadowCascade FitCascade(
+        const std::vector<DirectX::XMFLOAT3>& frustumCorners,
+        int resolution) const;
     std::vector<DirectX::XMFLOAT3> GetFrustumCorners(
         const DirectX::XMMATRIX& view,
         const DirectX::XMMATRIX& projection,
@@ -193,7 +223,8 @@ struct LightData {
     DirectX::XMFLOAT4 color;         // w = intensity
     DirectX::XMFLOAT4 attenuation;   // xyz = attenuation, w = inner cone angle
     DirectX::XMFLOAT4 shadowParams;  // x = outer cone angle, y = shadow bias, z = shadow strength, w = enabled
-    DirectX::XMFLOAT4X4 lightSpaceMatrix; // For shadow mapping
+    DirectX::XMFLOAT4 shadowAtlasRect; // Shadow tile in atlas UV, xy = offset, zw = size; zero size when unshadowed
+    DirectX::XMFLOAT4X4 lightSpaceMatrix; // World to atlas UV and depth with a tile, light view-projection otherwise
 };
 
 // Light manager for culling and batching
@@ -212,12 +243,16 @@ public:
     std::vector<std::shared_ptr<Light>> GetLightsInRange(const DirectX::XMFLOAT3& position, float radius) const;
     std::vector<std::shared_ptr<Light>> GetShadowCastingLights() const;
 
-    // Culling
+    // Culling: sphere-frustum for point lights, cone-frustum for spot lights,
+    // four lights at a time. Visible lights are kept as indices into GetAllLights.
     void CullLights(const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix);
-    const std::vector<std::shared_ptr<Light>>& GetVisibleLights() const { return m_visibleLights; }
+    const std::vector<std::uint32_t>& GetVisibleLightIndices() const { return m_visibleLights; }
+    const Light* GetVisibleLight(size_t index) const { return m_lights[m_visibleLights[index]].get(); }
 
-    // Shader data preparation
-    std::vector<LightData> PrepareShaderData(size_t maxLights = 64) const;
+    // Shader data preparation; over budget, the lights with the largest
+    // screen contribution are kept. Lights with a drawn tile in shadowAtlas
+    // get its shadow matrix and rectangle.
+    std::vector<LightData> PrepareShaderData(size_t maxLights = 64, const ShadowAtlas* shadowAtlas = nullptr) const;
 
     // Statistics
     size_t GetLightCount() const { return m_lights.size(); }
@@ -225,11 +260,25 @@ public:
 
 private:
     std::vector<std::shared_ptr<Light>> m_lights;
-    std::vector<std::shared_ptr<Light>> m_visibleLights;
+    std::vector<std::uint32_t> m_visibleLights;
+    std::vector<float> m_visibleScores;  // Parallel to m_visibleLights
+
+    // Culling inputs, structure of arrays padded to a multiple of four lights.
+    // Spot lights add a cone along dir of length coneHeight and base coneRadius.
+    struct CullingData {
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> radius;
+        std::vector<float> directionX, directionY, directionZ;
+        std::vector<float> coneHeight, coneRadius;
+
+        void Resize(size_t count);
+    };
+    CullingData m_culling;
 
     // Helper methods
-    bool IsLightVisible(const Light* light, const DirectX::XMMATRIX& viewMatrix, const DirectX::XMMATRIX& projectionMatrix) const;
-    LightData ConvertToShaderData(const Light* light) const;
+    void GatherCullingData();
+    float ComputeScreenContribution(const Light* light, const DirectX::XMVECTOR& cameraPosition) const;
+    LightData ConvertToShaderData(const Light* light, const ShadowAtlas* shadowAtlas) const;
 };
 
 } // namespace Renderer
@@ -0,0 +1,171 @@
+#include "OcclusionBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+// Box faces as corner quads, in BoundingOrientedBox::GetCorners order
+constexpr int BOX_FACES[6][4] = {
+    { 0, 1, 2, 3 }, { 4, 5, 6, 7 },
+    { 0, 1, 5, 4 }, { 3, 2, 6, 7 },
+    { 0, 3, 7, 4 }, { 1, 2, 6, 5 }
+};
+
+// Slack so an occluder does not hide itself through rounding
+constexpr float DEPTH_EPSILON = 1e-5f;
+
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer()
+    : m_width(0)
+    , m_height(0)
+    , m_active(false)
+{
+    DirectX::XMStoreFloat4x4(&m_viewProjection, DirectX::XMMatrixIdentity());
+}
+
+void OcclusionBuffer::Begin(const DirectX::XMMATRIX& viewProjection, unsigned int width, unsigned int height) {
+    DirectX::XMStoreFloat4x4(&m_viewProjection, viewProjection);
+    m_width = std::max(width, 1u);
+    m_height = std::max(height, 1u);
+    m_depth.assign(static_cast<size_t>(m_width) * m_height, 1.0f);
+    m_stats = OcclusionStats();
+    m_active = true;
+}
+
+void OcclusionBuffer::End() {
+    m_active = false;
+}
+
+void OcclusionBuffer::RasterizeOccluder(const DirectX::BoundingOrientedBox& box) {
+    if (!m_active) {
+        return;
+    }
+
+    // Clipping is not worth it at this resolution, near occluders are dropped
+    DirectX::XMFLOAT3 corners[8];
+    if (!ProjectBox(box, corners)) {
+        m_stats.occludersSkipped++;
+        return;
+    }
+
+    for (const auto& face : BOX_FACES) {
+        RasterizeTriangle(corners[face[0]], corners[face[1]], corners[face[2]]);
+        RasterizeTriangle(corners[face[0]], corners[face[2]], corners[face[3]]);
+    }
+    m_stats.occluders++;
+}
+
+bool OcclusionBuffer::IsOccluded(const DirectX::BoundingOrientedBox& box) {
+    if (!m_active) {
+        return false;
+    }
+
+    m_stats.tests++;
+
+    DirectX::XMFLOAT3 corners[8];
+    if (!ProjectBox(box, corners)) {
+        return false;
+    }
+
+    float minX = corners[0].x, maxX = corners[0].x;
+    float minY = corners[0].y, maxY = corners[0].y;
+    float minDepth = corners[0].z;
+    for (int i = 1; i < 8; i++) {
+        minX = std::min(minX, corners[i].x);
+        maxX = std::max(maxX, corners[i].x);
+        minY = std::min(minY, corners[i].y);
+        maxY = std::max(maxY, corners[i].y);
+        minDepth = std::min(minDepth, corners[i].z);
+    }
+
+    // Grow by a pixel so partly covered edge pixels are tested too
+    int x0 = std::max(static_cast<int>(std::floor(minX)) - 1, 0);
+    int y0 = std::max(static_cast<int>(std::floor(minY)) - 1, 0);
+    int x1 = std::min(static_cast<int>(std::ceil(maxX)) + 1, static_cast<int>(m_width) - 1);
+    int y1 = std::min(static_cast<int>(std::ceil(maxY)) + 1, static_cast<int>(m_height) - 1);
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    // Visible as soon as one pixel has nothing nearer in front of it
+    for (int y = y0; y <= y1; y++) {
+        const float* row = &m_depth[static_cast<size_t>(y) * m_width];
+        for (int x = x0; x <= x1; x++) {
+            if (minDepth <= row[x] + DEPTH_EPSILON) {
+                return false;
+            }
+        }
+    }
+
+    m_stats.occluded++;
+    return true;
+}
+
+bool OcclusionBuffer::ProjectBox(const DirectX::BoundingOrientedBox& box, DirectX::XMFLOAT3 corners[8]) const {
+    DirectX::XMFLOAT3 worldCorners[DirectX::BoundingOrientedBox::CORNER_COUNT];
+    box.GetCorners(worldCorners);
+
+    DirectX::XMMATRIX viewProjection = DirectX::XMLoadFloat4x4(&m_viewProjection);
+    float halfWidth = 0.5f * static_cast<float>(m_width);
+    float halfHeight = 0.5f * static_cast<float>(m_height);
+
+    for (int i = 0; i < 8; i++) {
+        DirectX::XMFLOAT4 clip;
+        DirectX::XMStoreFloat4(&clip, DirectX::XMVector4Transform(
+            DirectX::XMVectorSet(worldCorners[i].x, worldCorners[i].y, worldCorners[i].z, 1.0f), viewProjection));
+        if (clip.w <= 0.0f || clip.z < 0.0f) {
+            return false;
+        }
+
+        float invW = 1.0f / clip.w;
+        corners[i].x = (clip.x * invW + 1.0f) * halfWidth;
+        corners[i].y = (1.0f - clip.y * invW) * halfHeight;
+        corners[i].z = clip.z * invW;
+    }
+
+    return true;
+}
+
+void OcclusionBuffer::RasterizeTriangle(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, const DirectX::XMFLOAT3& c) {
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (std::fabs(area) < 1e-6f) {
+        return;
+    }
+
+    // Either winding; both sides of a box are nearer than what is behind it
+    const DirectX::XMFLOAT3& v1 = area > 0.0f ? b : c;
+    const DirectX::XMFLOAT3& v2 = area > 0.0f ? c : b;
+    float invArea = 1.0f / std::fabs(area);
+
+    int x0 = std::max(static_cast<int>(std::floor(std::min({ a.x, b.x, c.x }))), 0);
+    int y0 = std::max(static_cast<int>(std::floor(std::min({ a.y, b.y, c.y }))), 0);
+    int x1 = std::min(static_cast<int>(std::ceil(std::max({ a.x, b.x, c.x }))), static_cast<int>(m_width) - 1);
+    int y1 = std::min(static_cast<int>(std::ceil(std::max({ a.y, b.y, c.y }))), static_cast<int>(m_height) - 1);
+
+    for (int y = y0; y <= y1; y++) {
+        float py = static_cast<float>(y) + 0.5f;
+        float* row = &m_depth[static_cast<size_t>(y) * m_width];
+        for (int x = x0; x <= x1; x++) {
+            float px = static_cast<float>(x) + 0.5f;
+
+            // Edge functions at the pixel centre
+            float w0 = (v1.x - px) * (v2.y - py) - (v1.y - py) * (v2.x - px);
+            float w1 = (v2.x - px) * (a.y - py) - (v2.y - py) * (a.x - px);
+            float w2 = (a.x - px) * (v1.y - py) - (a.y - py) * (v1.x - px);
+            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                continue;
+            }
+
+            // Post-projection depth is linear in screen space
+            float depth = (w0 * a.z + w1 * v1.z + w2 * v2.z) * invArea;
+            row[x] = std::min(row[x], depth);
+        }
+    }
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer {
+
+// Per-frame software occlusion statistics
+struct OcclusionStats {
+    unsigned int occluders = 0;          // Occluder boxes rasterized
+    unsigned int occludersSkipped = 0;   // Occluders crossing the near plane
+    unsigned int tests = 0;
+    unsigned int occluded = 0;
+};
+
+// Low-resolution depth buffer rasterized on the CPU from occluder boxes.
+//
+// Large solid objects (buildings, walls) are drawn as their bounding boxes
+// into a small depth buffer each frame; other objects are then hidden when
+// their bounds are behind that depth everywhere they cover. It needs no GPU
+// readback, so it can cull draws before they are submitted.
+//
+// Depth is D3D post-projection z in [0, 1], nearer is smaller. Occluder
+// boxes must not be larger than the geometry they stand for, otherwise
+// objects behind the empty space are wrongly hidden.
+class OcclusionBuffer {
+public:
+    OcclusionBuffer();
+    ~OcclusionBuffer() = default;
+
+    // Clear to the far plane for a new view
+    void Begin(const DirectX::XMMATRIX& viewProjection, unsigned int width, unsigned int height);
+    // Stop testing until the next Begin
+    void End();
+    bool IsActive() const { return m_active; }
+
+    void RasterizeOccluder(const DirectX::BoundingOrientedBox& box);
+
+    // True when the box is hidden behind the occluders drawn so far
+    bool IsOccluded(const DirectX::BoundingOrientedBox& box);
+
+    unsigned int GetWidth() const { return m_width; }
+    unsigned int GetHeight() const { return m_height; }
+    const std::vector<float>& GetDepth() const { return m_depth; }
+    const OcclusionStats& GetStats() const { return m_stats; }
+
+private:
+    // Screen-space corners (pixels, depth in z); false if any is in front of the near plane
+    bool ProjectBox(const DirectX::BoundingOrientedBox& box, DirectX::XMFLOAT3 corners[8]) const;
+    void RasterizeTriangle(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, const DirectX::XMFLOAT3& c);
+
+    DirectX::XMFLOAT4X4 m_viewProjection;
+    unsigned int m_width;
+    unsigned int m_height;
+    std::vector<float> m_depth;
+    OcclusionStats m_stats;
+    bool m_active;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,333 @@
+#include "ProfilerOverlay.h"
+#include "GpuMemory.h"
+#include "StateObjectCache.h"
+#include "../Core/Logger.h"
+#include <d3dcompiler.h>
+#include <algorithm>
+#include <cstring>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+const char OVERLAY_SHADER[] = R"(
+struct VertexInput {
+    float2 position : POSITION;
+    float4 color : COLOR;
+};
+
+struct PixelInput {
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+PixelInput vsmain(VertexInput input) {
+    PixelInput output;
+    output.position = float4(input.position, 0.0f, 1.0f);
+    output.color = input.color;
+    return output;
+}
+
+float4 psmain(PixelInput input) : SV_TARGET {
+    return input.color;
+}
+)";
+
+constexpr UINT MAX_VERTICES = 4096;
+
+// Layout in normalized device coordinates; the bars span 33.3 ms
+constexpr float PANEL_LEFT = -0.98f;
+constexpr float PANEL_WIDTH = 0.8f;
+constexpr float SCALE_MILLISECONDS = 1000.0f / 30.0f;
+constexpr float CPU_BAR_TOP = 0.96f;
+constexpr float CPU_BAR_BOTTOM = 0.92f;
+constexpr float GPU_BAR_TOP = 0.90f;
+constexpr float GPU_BAR_BOTTOM = 0.86f;
+constexpr float GRAPH_TOP = 0.83f;
+constexpr float GRAPH_BOTTOM = 0.63f;
+constexpr float MEMORY_CPU_TOP = 0.60f;
+constexpr float MEMORY_CPU_BOTTOM = 0.58f;
+constexpr float MEMORY_GPU_TOP = 0.56f;
+constexpr float MEMORY_GPU_BOTTOM = 0.54f;
+
+const float PANEL_COLOR[4] = { 0.0f, 0.0f, 0.0f, 0.6f };
+const float MARKER_COLOR[4] = { 1.0f, 1.0f, 1.0f, 0.8f };
+const float CPU_COLOR[4] = { 1.0f, 0.6f, 0.1f, 0.9f };
+const float GPU_COLOR[4] = { 0.3f, 0.9f, 0.3f, 0.9f };
+const float OVER_BUDGET_COLOR[4] = { 1.0f, 0.1f, 0.1f, 1.0f };
+
+// Indexed by Core::MemoryCategory; red is kept for over budget
+const float MEMORY_COLORS[Core::MEMORY_CATEGORY_COUNT][4] = {
+    { 0.55f, 0.55f, 0.55f, 0.9f },
+    { 0.30f, 0.55f, 0.95f, 0.9f },
+    { 0.95f, 0.80f, 0.25f, 0.9f },
+    { 0.55f, 0.35f, 0.85f, 0.9f },
+    { 0.25f, 0.80f, 0.75f, 0.9f },
+    { 0.95f, 0.50f, 0.75f, 0.9f },
+    { 0.60f, 0.80f, 0.30f, 0.9f },
+    { 0.85f, 0.55f, 0.30f, 0.9f },
+};
+
+const float SCOPE_COLORS[][4] = {
+    { 0.90f, 0.30f, 0.30f, 0.9f },
+    { 0.30f, 0.55f, 0.95f, 0.9f },
+    { 0.95f, 0.80f, 0.25f, 0.9f },
+    { 0.55f, 0.35f, 0.85f, 0.9f },
+    { 0.25f, 0.80f, 0.75f, 0.9f },
+    { 0.95f, 0.50f, 0.75f, 0.9f },
+    { 0.60f, 0.80f, 0.30f, 0.9f },
+    { 0.85f, 0.55f, 0.30f, 0.9f },
+};
+constexpr size_t SCOPE_COLOR_COUNT = sizeof(SCOPE_COLORS) / sizeof(SCOPE_COLORS[0]);
+
+// Same name, same colour, on both bars and across frames
+const float* GetScopeColor(const char* name) {
+    std::uint32_t hash = 2166136261u;
+    for (const char* c = name ? name : ""; *c; c++) {
+        hash = (hash ^ static_cast<std::uint8_t>(*c)) * 16777619u;
+    }
+    return SCOPE_COLORS[hash % SCOPE_COLOR_COUNT];
+}
+
+float ToWidth(double milliseconds) {
+    return static_cast<float>(std::min(milliseconds / SCALE_MILLISECONDS, 1.0)) * PANEL_WIDTH;
+}
+
+bool CompileOverlayShader(const char* entry, const char* profile, ComPtr<ID3DBlob>& blob) {
+    ComPtr<ID3DBlob> errorBlob;
+    HRESULT hr = D3DCompile(OVERLAY_SHADER, sizeof(OVERLAY_SHADER) - 1, "ProfilerOverlay",
+                            nullptr, nullptr, entry, profile, 0, 0, &blob, &errorBlob);
+    if (FAILED(hr)) {
+        if (errorBlob) {
+            LOG_ERROR("Profiler overlay shader compilation failed: " << (char*)errorBlob->GetBufferPointer());
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ProfilerOverlay::ProfilerOverlay()
+    : m_blendState(nullptr)
+    , m_depthState(nullptr)
+    , m_rasterizerState(nullptr)
+    , m_historyIndex(0)
+    , m_hasLastMemory(false)
+{
+    std::fill(std::begin(m_cpuHistory), std::end(m_cpuHistory), 0.0f);
+    std::fill(std::begin(m_gpuHistory), std::end(m_gpuHistory), 0.0f);
+}
+
+bool ProfilerOverlay::Initialize(ID3D11Device* device, StateObjectCache& states) {
+    Shutdown();
+
+    ComPtr<ID3DBlob> vertexBlob;
+    ComPtr<ID3DBlob> pixelBlob;
+    if (!CompileOverlayShader("vsmain", "vs_5_0", vertexBlob) || !CompileOverlayShader("psmain", "ps_5_0", pixelBlob)) {
+        return false;
+    }
+
+    HRESULT hr = device->CreateVertexShader(vertexBlob->GetBufferPointer(), vertexBlob->GetBufferSize(), nullptr, &m_vertexShader);
+    if (SUCCEEDED(hr)) {
+        hr = device->CreatePixelShader(pixelBlob->GetBufferPointer(), pixelBlob->GetBufferSize(), nullptr, &m_pixelShader);
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create profiler overlay shaders");
+        return false;
+    }
+
+    const D3D11_INPUT_ELEMENT_DESC elements[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    };
+    hr = device->CreateInputLayout(elements, 2, vertexBlob->GetBufferPointer(), vertexBlob->GetBufferSize(), &m_inputLayout);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create profiler overlay input layout");
+        return false;
+    }
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+    bufferDesc.ByteWidth = MAX_VERTICES * sizeof(Vertex);
+    bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    hr = device->CreateBuffer(&bufferDesc, nullptr, &m_vertexBuffer);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create profiler overlay vertex buffer");
+        return false;
+    }
+    TrackGpuMemory(m_vertexBuffer.Get(), Core::MemoryCategory::Renderer);
+
+    D3D11_BLEND_DESC blendDesc = {};
+    blendDesc.RenderTarget[0].BlendEnable = TRUE;
+    blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+    blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+    blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+    blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+    blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+    m_blendState = states.GetBlendState(blendDesc);
+
+    D3D11_DEPTH_STENCIL_DESC depthDesc = {};
+    depthDesc.DepthEnable = FALSE;
+    depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+    depthDesc.DepthFunc = D3D11_COMPARISON_ALWAYS;
+    m_depthState = states.GetDepthStencilState(depthDesc);
+
+    D3D11_RASTERIZER_DESC rasterDesc = {};
+    rasterDesc.FillMode = D3D11_FILL_SOLID;
+    rasterDesc.CullMode = D3D11_CULL_NONE;
+    rasterDesc.DepthClipEnable = TRUE;
+    m_rasterizerState = states.GetRasterizerState(rasterDesc);
+
+    m_vertices.reserve(MAX_VERTICES);
+    return true;
+}
+
+void ProfilerOverlay::Shutdown() {
+    m_vertexShader.Reset();
+    m_pixelShader.Reset();
+    m_inputLayout.Reset();
+    m_vertexBuffer.Reset();
+    m_blendState = nullptr;
+    m_depthState = nullptr;
+    m_rasterizerState = nullptr;
+}
+
+void ProfilerOverlay::Render(ID3D11DeviceContext* context, const Core::ProfileFrameStats& stats,
+                             const Core::MemorySnapshot& memory) {
+    if (!context || !m_vertexBuffer) {
+        return;
+    }
+
+    m_cpuHistory[m_historyIndex] = static_cast<float>(stats.cpuMilliseconds);
+    m_gpuHistory[m_historyIndex] = static_cast<float>(stats.gpuMilliseconds);
+    m_historyIndex = (m_historyIndex + 1) % HISTORY_LENGTH;
+
+    m_vertices.clear();
+    AddQuad(PANEL_LEFT - 0.01f, CPU_BAR_TOP + 0.01f, PANEL_LEFT + PANEL_WIDTH + 0.01f, MEMORY_GPU_BOTTOM - 0.01f, PANEL_COLOR);
+
+    AddScopeBar(stats.cpuScopes, CPU_BAR_TOP, CPU_BAR_BOTTOM);
+    AddScopeBar(stats.gpuScopes, GPU_BAR_TOP, GPU_BAR_BOTTOM);
+
+    // Oldest on the left; each column shows CPU with GPU inset
+    float columnWidth = PANEL_WIDTH / HISTORY_LENGTH;
+    float graphHeight = GRAPH_TOP - GRAPH_BOTTOM;
+    for (UINT i = 0; i < HISTORY_LENGTH; i++) {
+        UINT sample = (m_historyIndex + i) % HISTORY_LENGTH;
+        float left = PANEL_LEFT + i * columnWidth;
+        float cpuHeight = std::min(m_cpuHistory[sample] / SCALE_MILLISECONDS, 1.0f) * graphHeight;
+        float gpuHeight = std::min(m_gpuHistory[sample] / SCALE_MILLISECONDS, 1.0f) * graphHeight;
+        AddQuad(left, GRAPH_BOTTOM + cpuHeight, left + columnWidth, GRAPH_BOTTOM, CPU_COLOR);
+        AddQuad(left + columnWidth * 0.25f, GRAPH_BOTTOM + gpuHeight, left + columnWidth * 0.75f, GRAPH_BOTTOM, GPU_COLOR);
+    }
+
+    // 16.7 ms marks on the bars and the graph
+    float markerX = PANEL_LEFT + PANEL_WIDTH * 0.5f;
+    AddQuad(markerX - 0.002f, CPU_BAR_TOP + 0.005f, markerX + 0.002f, GPU_BAR_BOTTOM - 0.005f, MARKER_COLOR);
+    float markerY = GRAPH_BOTTOM + graphHeight * 0.5f;
+    AddQuad(PANEL_LEFT, markerY + 0.002f, PANEL_LEFT + PANEL_WIDTH, markerY - 0.002f, MARKER_COLOR);
+
+    // Without a DXGI budget the GPU row is scaled to what is tracked
+    std::int64_t gpuScale = memory.videoMemoryBudget > 0 ? memory.videoMemoryBudget : memory.GetTotalGpuBytes();
+    AddMemoryBar(memory, false, memory.GetTotalCpuBytes(), MEMORY_CPU_TOP, MEMORY_CPU_BOTTOM);
+    AddMemoryBar(memory, true, gpuScale, MEMORY_GPU_TOP, MEMORY_GPU_BOTTOM);
+    if (memory.videoMemoryBudget > 0) {
+        float usage = static_cast<float>(std::min(static_cast<double>(memory.videoMemoryUsage) / memory.videoMemoryBudget, 1.0));
+        float usageX = PANEL_LEFT + PANEL_WIDTH * usage;
+        const float* color = memory.videoMemoryUsage > memory.videoMemoryBudget ? OVER_BUDGET_COLOR : MARKER_COLOR;
+        AddQuad(usageX - 0.002f, MEMORY_GPU_TOP + 0.005f, usageX + 0.002f, MEMORY_GPU_BOTTOM - 0.005f, color);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(context->Map(m_vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        return;
+    }
+    std::memcpy(mapped.pData, m_vertices.data(), m_vertices.size() * sizeof(Vertex));
+    context->Unmap(m_vertexBuffer.Get(), 0);
+
+    UINT stride = sizeof(Vertex);
+    UINT offset = 0;
+    float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    context->IASetInputLayout(m_inputLayout.Get());
+    context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->VSSetShader(m_vertexShader.Get(), nullptr, 0);
+    context->PSSetShader(m_pixelShader.Get(), nullptr, 0);
+    context->OMSetBlendState(m_blendState, blendFactor, 0xffffffff);
+    context->OMSetDepthStencilState(m_depthState, 0);
+    context->RSSetState(m_rasterizerState);
+    context->Draw(static_cast<UINT>(m_vertices.size()), 0);
+}
+
+void ProfilerOverlay::LogLegend(const Core::ProfileFrameStats& stats, const Core::MemorySnapshot& memory) {
+    LOG_INFO("Profiler: CPU " << stats.cpuMilliseconds << " ms, GPU " << stats.gpuMilliseconds << " ms (bars span 33.3 ms)");
+    for (const Core::ProfileScopeTotal& scope : stats.cpuScopes) {
+        LOG_INFO("  CPU " << scope.name << ": " << scope.milliseconds << " ms");
+    }
+    for (const Core::ProfileScopeTotal& scope : stats.gpuScopes) {
+        LOG_INFO("  GPU " << scope.name << ": " << scope.milliseconds << " ms");
+    }
+
+    MEMORY_TRACKER.LogSnapshot(memory);
+    if (m_hasLastMemory) {
+        MEMORY_TRACKER.LogSnapshot(memory, &m_lastMemory);
+    }
+    m_lastMemory = memory;
+    m_hasLastMemory = true;
+}
+
+void ProfilerOverlay::AddQuad(float left, float top, float right, float bottom, const float color[4]) {
+    if (m_vertices.size() + 6 > MAX_VERTICES) {
+        return;
+    }
+
+    Vertex topLeft = { left, top, color[0], color[1], color[2], color[3] };
+    Vertex topRight = { right, top, color[0], color[1], color[2], color[3] };
+    Vertex bottomLeft = { left, bottom, color[0], color[1], color[2], color[3] };
+    Vertex bottomRight = { right, bottom, color[0], color[1], color[2], color[3] };
+
+    m_vertices.push_back(topLeft);
+    m_vertices.push_back(topRight);
+    m_vertices.push_back(bottomLeft);
+    m_vertices.push_back(bottomLeft);
+    m_vertices.push_back(topRight);
+    m_vertices.push_back(bottomRight);
+}
+
+void ProfilerOverlay::AddScopeBar(const std::vector<Core::ProfileScopeTotal>& scopes, float top, float bottom) {
+    float x = PANEL_LEFT;
+    for (const Core::ProfileScopeTotal& scope : scopes) {
+        float width = std::min(ToWidth(scope.milliseconds), PANEL_LEFT + PANEL_WIDTH - x);
+        if (width <= 0.0f) {
+            break;
+        }
+        AddQuad(x, top, x + width, bottom, GetScopeColor(scope.name));
+        x += width;
+    }
+}
+
+void ProfilerOverlay::AddMemoryBar(const Core::MemorySnapshot& memory, bool gpu, std::int64_t scale, float top,
+                                   float bottom) {
+    if (scale <= 0) {
+        return;
+    }
+
+    float x = PANEL_LEFT;
+    for (size_t i = 0; i < Core::MEMORY_CATEGORY_COUNT; i++) {
+        const Core::MemoryCategoryUsage& usage = memory.categories[i];
+        double fraction = static_cast<double>(gpu ? usage.gpuBytes : usage.cpuBytes) / scale;
+        float width = std::min(static_cast<float>(fraction) * PANEL_WIDTH, PANEL_LEFT + PANEL_WIDTH - x);
+        if (width <= 0.0f) {
+            continue;
+        }
+        AddQuad(x, top, x + width, bottom, usage.IsOverBudget() ? OVER_BUDGET_COLOR : MEMORY_COLORS[i]);
+        x += width;
+    }
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <vector>
+#include "../Core/Profiler.h"
+#include "../Core/MemoryTracker.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+using Microsoft::WRL::ComPtr;
+
+class StateObjectCache;
+
+// On-screen frame timing drawn as untextured quads in the top-left corner:
+// one bar each for the main thread's and the GPU's top-level scopes, split
+// and coloured per scope, against a 33 ms scale with a mark at 16.7 ms, and
+// a rolling graph of recent CPU (orange) and GPU (green) frame times. Below
+// that, memory per category: tracked heap across the full width, and tracked
+// GPU resources against the OS video budget with a mark at the process's
+// whole usage; categories over their budget turn red. Scope names, memory
+// and what it did since the last legend are written to the log when the
+// overlay is shown.
+class ProfilerOverlay {
+public:
+    static constexpr UINT HISTORY_LENGTH = 120;
+
+    ProfilerOverlay();
+    ~ProfilerOverlay() = default;
+
+    bool Initialize(ID3D11Device* device, StateObjectCache& states);
+    void Shutdown();
+
+    // Leaves its own shaders and states bound
+    void Render(ID3D11DeviceContext* context, const Core::ProfileFrameStats& stats, const Core::MemorySnapshot& memory);
+
+    // Log a legend of the current top-level scopes and memory categories
+    void LogLegend(const Core::ProfileFrameStats& stats, const Core::MemorySnapshot& memory);
+
+    bool IsInitialized() const { return m_vertexBuffer != nullptr; }
+
+private:
+    struct Vertex {
+        float x, y;
+        float r, g, b, a;
+    };
+
+    void AddQuad(float left, float top, float right, float bottom, const float color[4]);
+    void AddScopeBar(const std::vector<Core::ProfileScopeTotal>& scopes, float top, float bottom);
+    void AddMemoryBar(const Core::MemorySnapshot& memory, bool gpu, std::int64_t scale, float top, float bottom);
+
+    ComPtr<ID3D11VertexShader> m_vertexShader;
+    ComPtr<ID3D11PixelShader> m_pixelShader;
+    ComPtr<ID3D11InputLayout> m_inputLayout;
+    ComPtr<ID3D11Buffer> m_vertexBuffer;
+    ID3D11BlendState* m_blendState;
+    ID3D11DepthStencilState* m_depthState;
+    ID3D11RasterizerState* m_rasterizerState;
+
+    std::vector<Vertex> m_vertices;
+    float m_cpuHistory[HISTORY_LENGTH];
+    float m_gpuHistory[HISTORY_LENGTH];
+    UINT m_historyIndex;
+
+    // Memory when the legend was last logged
+    Core::MemorySnapshot m_lastMemory;
+    bool m_hasLastMemory;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,710 @@
+#include "RenderQueue.h"
+#include "D3D11Renderer.h"
+#include "DeferredContextPool.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/Material.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace GameEngine {
+namespace Renderer {
+
+RenderQueue::RenderQueue()
+    : m_prepared(false)
+    , m_instancingReady(false)
+    , m_skinningReady(false)
+    , m_instanceCapacity(0)
+    , m_minInstanceCount(2)
+    , m_instancingEnabled(true)
+    , m_bonePaletteReady(false)
+    , m_skinningPrepared(false)
+    , m_computeSkinnedCount(0)
+    , m_constantGeneration(0)
+    , m_objectConstantsReady(false)
+    , m_pixelShaderOverride(nullptr)
+    , m_overridePixelShader(false)
+    , m_parallelPacketThreshold(512)
+{
+    m_packets.reserve(1024);
+}
+
+void RenderQueue::Clear() {
+    // Keep capacity so steady-state frames don't reallocate
+    m_packets.clear();
+    m_prepared = false;
+    m_stats = RenderQueueStats();
+    m_bonePalette.Reset();
+    m_bonePaletteReady = false;
+    m_skinningJobs.clear();
+    m_skinningPrepared = false;
+    m_computeSkinnedCount = 0;
+    m_objectConstantsReady = false;
+    m_shaderIDs.clear();
+    m_materialIDs.clear();
+    m_textureIDs.clear();
+    m_meshIDs.clear();
+}
+
+void RenderQueue::Submit(Mesh::Mesh* mesh, UINT subMeshIndex, Mesh::Material* material, const DirectX::XMMATRIX& worldMatrix,
+                         std::uint32_t boneOffset, SkinnedVertexOutput* skinnedVertices, UINT lod,
+                         const ConstantBinding* staticConstants) {
+    if (!mesh || !mesh->IsLoaded() || subMeshIndex >= mesh->GetSubMeshCount()) {
+        return;
+    }
+
+    const void* shader = material ? static_cast<const void*>(material->GetVertexShader()) : nullptr;
+    const void* texture = material ? static_cast<const void*>(material->GetDiffuseTexture()) : nullptr;
+
+    std::uint32_t features = material ? material->GetShaderFeatures() : ShaderFeature::None;
+
+    RenderPacket packet;
+    packet.sortKey = BuildSortKey(features, GetResourceID(m_shaderIDs, shader),
+                                  GetResourceID(m_materialIDs, material),
+                                  GetResourceID(m_textureIDs, texture),
+                                  GetResourceID(m_meshIDs, mesh));
+    packet.mesh = mesh;
+    packet.material = material;
+    packet.subMeshIndex = subMeshIndex;
+    packet.lod = lod < mesh->GetLODCount() ? lod : mesh->GetLODCount() - 1;
+
+    // Quantized positions are expanded by the world matrix
+    if (mesh->GetVertexFormat() == Mesh::VertexFormat::Quantized) {
+        DirectX::XMStoreFloat4x4(&packet.worldMatrix, mesh->GetPositionDequantization() * worldMatrix);
+    }
+    else {
+        DirectX::XMStoreFloat4x4(&packet.worldMatrix, worldMatrix);
+    }
+    packet.skinnedVertices = mesh->IsAnimated() ? skinnedVertices : nullptr;
+    packet.boneOffset = mesh->IsAnimated() && !packet.skinnedVertices ? boneOffset : BonePalette::INVALID_OFFSET;
+    packet.staticConstants = staticConstants && staticConstants->IsValid();
+    packet.objectConstants = packet.staticConstants ? *staticConstants : ConstantBinding();
+
+    m_packets.push_back(packet);
+    m_prepared = false;
+    m_objectConstantsReady = false;
+}
+
+void RenderQueue::QueueSkinning(Mesh::Mesh* mesh, std::uint32_t boneOffset, SkinnedVertexOutput* output) {
+    if (!mesh || !mesh->IsAnimated() || !output || boneOffset == BonePalette::INVALID_OFFSET) {
+        return;
+    }
+
+    SkinningJob job;
+    job.mesh = mesh;
+    job.boneOffset = boneOffset;
+    job.output = output;
+    m_skinningJobs.push_back(job);
+}
+
+void RenderQueue::PrepareSkinning(D3D11Renderer* renderer) {
+    // Once per frame no matter how many passes execute the queue
+    if (m_skinningPrepared || !renderer) {
+        return;
+    }
+    m_skinningPrepared = true;
+
+    m_bonePaletteReady = UploadBonePalette(renderer);
+    DispatchSkinning(renderer);
+}
+
+void RenderQueue::Sort() {
+    std::sort(m_packets.begin(), m_packets.end(),
+        [](const RenderPacket& a, const RenderPacket& b) {
+            if (a.sortKey != b.sortKey) {
+                return a.sortKey < b.sortKey;
+            }
+            if (a.subMeshIndex != b.subMeshIndex) {
+                return a.subMeshIndex < b.subMeshIndex;
+            }
+            return a.lod < b.lod;
+        });
+    m_prepared = false;
+}
+
+void RenderQueue::Prepare(D3D11Renderer* renderer) {
+    if (m_prepared || !renderer || m_packets.empty()) {
+        return;
+    }
+    m_prepared = true;
+    m_stats = RenderQueueStats();
+    m_reportedStats = RenderFrameStats();
+
+    // Group packets and stream all instance transforms and bones with a single map each
+    BuildBatches();
+    PrepareMaterials(renderer);
+    m_instancingReady = UploadInstanceData(renderer);
+    PrepareSkinning(renderer);
+    m_skinningReady = m_instancingReady && m_bonePaletteReady;
+    m_stats.bonesUploaded = m_bonePaletteReady ? m_bonePalette.GetMatrixCount() : 0;
+    m_stats.computeSkinnedMeshes = m_computeSkinnedCount;
+    UploadObjectConstants(renderer, m_instancingReady, m_skinningReady);
+}
+
+void RenderQueue::Execute(D3D11Renderer* renderer) {
+    if (!renderer || m_packets.empty()) {
+        return;
+    }
+
+    Prepare(renderer);
+    bool instancing = m_instancingReady;
+    bool skinning = m_skinningReady;
+    // Re-uploads only if the ring wrapped since Prepare
+    UploadObjectConstants(renderer, instancing, skinning);
+    renderer->UpdateViewConstants(renderer->GetViewMatrix().ToXMMATRIX(), renderer->GetProjectionMatrix().ToXMMATRIX());
+
+    // The renderer's cache, so its own setters stay in sync afterwards
+    ContextStateCache& stateCache = renderer->GetStateCache();
+    stateCache.Reset(renderer->GetContext());
+    ExecuteBatches(renderer, stateCache, 0, static_cast<UINT>(m_batches.size()), instancing, skinning, m_stats);
+    ReportFrameStats(renderer);
+}
+
+void RenderQueue::ExecuteParallel(D3D11Renderer* renderer, DeferredContextPool& contexts) {
+    if (!renderer || !contexts.IsAvailable() || m_packets.size() < m_parallelPacketThreshold) {
+        Execute(renderer);
+        return;
+    }
+
+    // Batching, uploads and compute skinning stay on the immediate context
+    Prepare(renderer);
+    bool instancing = m_instancingReady;
+    bool skinning = m_skinningReady;
+
+    // Constants must all be in the ring before recording; a wrap while the
+    // command lists wait for playback would discard what they reference
+    UploadObjectConstants(renderer, instancing, skinning);
+    renderer->UpdateViewConstants(renderer->GetViewMatrix().ToXMMATRIX(), renderer->GetProjectionMatrix().ToXMMATRIX());
+
+    // Split batches into contiguous chunks of roughly equal packet counts
+    UINT batchCount = static_cast<UINT>(m_batches.size());
+    UINT chunkCount = std::min(contexts.GetContextCount(), batchCount);
+    UINT packetsPerChunk = (static_cast<UINT>(m_packets.size()) + chunkCount - 1) / chunkCount;
+
+    std::vector<UINT> chunkStarts;
+    chunkStarts.reserve(chunkCount + 1);
+    chunkStarts.push_back(0);
+
+    UINT packetsInChunk = 0;
+    for (UINT i = 0; i < batchCount; i++) {
+        packetsInChunk += m_batches[i].packetCount;
+        if (packetsInChunk >= packetsPerChunk && chunkStarts.size() < chunkCount && i + 1 < batchCount) {
+            chunkStarts.push_back(i + 1);
+            packetsInChunk = 0;
+        }
+    }
+    chunkStarts.push_back(batchCount);
+    chunkCount = static_cast<UINT>(chunkStarts.size()) - 1;
+
+    // Record chunks on worker threads, starting from the caller's bound state
+    ID3D11DeviceContext* immediateContext = renderer->GetContext();
+    contexts.CaptureState(immediateContext);
+
+    std::vector<RenderQueueStats> chunkStats(chunkCount);
+    bool recorded = contexts.Record(chunkCount,
+        [&](UINT index, ID3D11DeviceContext* context, ContextStateCache& stateCache) {
+            ExecuteBatches(renderer, stateCache, chunkStarts[index], chunkStarts[index + 1],
+                           instancing, skinning, chunkStats[index]);
+        });
+
+    if (!recorded) {
+        LOG_WARNING("Parallel render queue recording failed, some draws were dropped this frame");
+    }
+
+    // Play back in order so the sorted submission order is preserved
+    contexts.ExecuteCommandLists(immediateContext);
+
+    for (const auto& stats : chunkStats) {
+        m_stats.drawCalls += stats.drawCalls;
+        m_stats.instancedDrawCalls += stats.instancedDrawCalls;
+        m_stats.instancesDrawn += stats.instancesDrawn;
+        m_stats.trianglesDrawn += stats.trianglesDrawn;
+        m_stats.skinnedInstancesDrawn += stats.skinnedInstancesDrawn;
+        m_stats.shaderChanges += stats.shaderChanges;
+        m_stats.materialChanges += stats.materialChanges;
+        m_stats.meshChanges += stats.meshChanges;
+        m_stats.bufferChanges += stats.bufferChanges;
+        m_stats.staticConstantDraws += stats.staticConstantDraws;
+        m_stats.redundantBinds += stats.redundantBinds;
+        m_stats.bufferMaps += stats.bufferMaps;
+        m_stats.bytesMapped += stats.bytesMapped;
+    }
+    ReportFrameStats(renderer);
+}
+
+void RenderQueue::ReportFrameStats(D3D11Renderer* renderer) {
+    // State changes are read from the context caches by the renderer itself
+    RenderFrameStats stats;
+    stats.drawCalls = m_stats.drawCalls - m_reportedStats.drawCalls;
+    stats.instancedDrawCalls = m_stats.instancedDrawCalls - m_reportedStats.instancedDrawCalls;
+    stats.instancesDrawn = m_stats.instancesDrawn - m_reportedStats.instancesDrawn;
+    stats.trianglesDrawn = m_stats.trianglesDrawn - m_reportedStats.trianglesDrawn;
+    stats.bufferMaps = m_stats.bufferMaps - m_reportedStats.bufferMaps;
+    stats.bytesMapped = m_stats.bytesMapped - m_reportedStats.bytesMapped;
+    renderer->AddFrameStats(stats);
+
+    m_reportedStats.drawCalls = m_stats.drawCalls;
+    m_reportedStats.instancedDrawCalls = m_stats.instancedDrawCalls;
+    m_reportedStats.instancesDrawn = m_stats.instancesDrawn;
+    m_reportedStats.trianglesDrawn = m_stats.trianglesDrawn;
+    m_reportedStats.bufferMaps = m_stats.bufferMaps;
+    m_reportedStats.bytesMapped = m_stats.bytesMapped;
+}
+
+void RenderQueue::ExecuteBatches(D3D11Renderer* renderer, ContextStateCache& stateCache, UINT firstBatch, UINT lastBatch,
+                                 bool instancing, bool skinning, RenderQueueStats& stats) const {
+    ID3D11DeviceContext* context = stateCache.GetContext();
+    ID3D11Buffer* matrixBuffer = renderer->GetMatrixBuffer();
+    ID3D11Buffer* viewBuffer = renderer->GetViewBuffer();
+    UINT redundantBindsBefore = stateCache.GetRedundantBindCount();
+
+    // Offset bindings need the D3D11.1 interface, deferred contexts have it too
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1;
+    context->QueryInterface(IID_PPV_ARGS(&context1));
+
+    // Shaders bound by the caller are used for materials without their own
+    ID3D11VertexShader* baseVertexShader = stateCache.GetVertexShader();
+    ID3D11InputLayout* baseInputLayout = stateCache.GetInputLayout();
+    ID3D11PixelShader* basePixelShader = stateCache.GetPixelShader();
+    ID3D11RasterizerState* baseRasterizerState = stateCache.GetRasterizerState();
+    ID3D11BlendState* baseBlendState = stateCache.GetBlendState();
+
+    // State shared by every packet
+    stateCache.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    stateCache.SetConstantBuffer(D3D11Renderer::OBJECT_CONSTANT_SLOT, matrixBuffer);
+    stateCache.SetConstantBuffer(D3D11Renderer::VIEW_CONSTANT_SLOT, viewBuffer);
+    if (instancing) {
+        stateCache.SetVertexBuffer(m_instanceBuffer.Get(), sizeof(Mesh::InstanceData), 1);
+    }
+    if (skinning) {
+        m_bonePalette.Bind(context, 0);
+    }
+
+    const Mesh::Material* currentMaterial = nullptr;
+    const Mesh::Mesh* currentMesh = nullptr;
+    ID3D11Buffer* currentIndexBuffer = nullptr;
+
+    for (UINT batchIndex = firstBatch; batchIndex < lastBatch; batchIndex++) {
+        const RenderBatch& batch = m_batches[batchIndex];
+        const RenderPacket& first = m_packets[batch.firstPacket];
+        Mesh::Material* material = first.material;
+        Mesh::Mesh* mesh = first.mesh;
+        bool instanced = IsDrawnInstanced(batch, instancing, skinning);
+        bool skinned = instanced && batch.skinned;
+
+        // Compute-skinned output is always a standard Vertex stream
+        Mesh::VertexFormat format = first.skinnedVertices ? Mesh::VertexFormat::Standard : mesh->GetVertexFormat();
+
+        // Resolve shaders for this batch
+        ID3D11VertexShader* vertexShader = baseVertexShader;
+        ID3D11InputLayout* inputLayout = format == Mesh::VertexFormat::Standard ? baseInputLayout : m_baseLayouts.Get(format);
+        ID3D11PixelShader* pixelShader = basePixelShader;
+        if (skinned) {
+            vertexShader = m_skinnedShader.Get();
+            inputLayout = m_skinnedLayouts.Get(format);
+        }
+        else if (instanced) {
+            vertexShader = m_instancedShader.Get();
+            inputLayout = m_instancedLayouts.Get(format);
+        }
+        else if (material && material->GetVertexShader()) {
+            vertexShader = material->GetVertexShader();
+            inputLayout = material->GetInputLayout(format);
+            pixelShader = material->GetPixelShader();
+        }
+        else if (batch.skinned && m_skinnedFallbackShader) {
+            // Off the palette path: bones come from each packet's BoneBuffer window
+            vertexShader = m_skinnedFallbackShader.Get();
+            inputLayout = m_skinnedFallbackLayouts.Get(format);
+        }
+
+        if (m_overridePixelShader) {
+            pixelShader = m_pixelShaderOverride;
+        }
+
+        // A mismatched layout would read garbage, so formats without one are not drawn
+        if (!inputLayout && format != Mesh::VertexFormat::Standard) {
+            continue;
+        }
+
+        if (vertexShader != stateCache.GetVertexShader()) {
+            stats.shaderChanges++;
+        }
+        stateCache.SetVertexShader(vertexShader, inputLayout);
+        stateCache.SetPixelShader(pixelShader);
+
+        if (mesh != currentMesh) {
+            // Meshes packed into shared buffers switch without rebinding
+            if (mesh->GetIndexBuffer() != currentIndexBuffer) {
+                currentIndexBuffer = mesh->GetIndexBuffer();
+                stats.bufferChanges++;
+            }
+            stateCache.SetIndexBuffer(currentIndexBuffer, mesh->GetIndexFormat());
+            currentMesh = mesh;
+            stats.meshChanges++;
+        }
+
+        // Compute-skinned instances draw their own static vertex stream
+        if (first.skinnedVertices) {
+            if (!first.skinnedVertices->buffer) {
+                continue;
+            }
+            stateCache.SetVertexBuffer(first.skinnedVertices->buffer.Get(), sizeof(Mesh::Vertex));
+        }
+        else {
+            stateCache.SetVertexBuffer(mesh->GetVertexBuffer(), mesh->GetVertexStride());
+        }
+
+        if (material != currentMaterial) {
+            // Depth-only passes sample nothing. Packets without a material get
+            // the default one rather than the previous batch's bindings.
+            Mesh::Material* applied = material ? material : renderer->GetDefaultMaterial();
+            if (applied && (pixelShader || !m_overridePixelShader)) {
+                applied->Apply(stateCache);
+            }
+
+            // Materials without their own states keep the pass's
+            ID3D11RasterizerState* rasterizerState = material ? material->GetRasterizerState() : nullptr;
+            ID3D11BlendState* blendState = material ? material->GetBlendState() : nullptr;
+            stateCache.SetRasterizerState(rasterizerState ? rasterizerState : baseRasterizerState);
+            stateCache.SetBlendState(blendState ? blendState : baseBlendState);
+            currentMaterial = material;
+            stats.materialChanges++;
+        }
+
+        Mesh::LODRange range = mesh->GetLODRange(first.lod, first.subMeshIndex);
+
+        if (instanced) {
+            // World comes from the instance stream, only the view constants matter
+            context->DrawIndexedInstanced(range.indexCount, batch.packetCount, mesh->GetBaseIndex() + range.startIndex,
+                                          mesh->GetBaseVertex(), batch.firstInstance);
+            stats.drawCalls++;
+            stats.instancedDrawCalls++;
+            stats.instancesDrawn += batch.packetCount;
+            stats.trianglesDrawn += static_cast<std::uint64_t>(range.indexCount / 3) * batch.packetCount;
+            if (skinned) {
+                stats.skinnedInstancesDrawn += batch.packetCount;
+            }
+            continue;
+        }
+
+        for (UINT i = 0; i < batch.packetCount; i++) {
+            const RenderPacket& packet = m_packets[batch.firstPacket + i];
+
+            // Per-draw transform, from the ring or static constants when available
+            if (context1 && packet.objectConstants.IsValid()) {
+                stateCache.SetConstantBuffer(D3D11Renderer::OBJECT_CONSTANT_SLOT, packet.objectConstants);
+                if (packet.staticConstants) {
+                    stats.staticConstantDraws++;
+                }
+            }
+            else {
+                WriteObjectConstants(context, matrixBuffer, DirectX::XMLoadFloat4x4(&packet.worldMatrix));
+                stateCache.SetConstantBuffer(D3D11Renderer::OBJECT_CONSTANT_SLOT, matrixBuffer);
+                stats.bufferMaps++;
+                stats.bytesMapped += sizeof(ObjectConstants);
+            }
+            if (context1 && packet.boneConstants.IsValid()) {
+                stateCache.SetConstantBuffer(D3D11Renderer::BONE_CONSTANT_SLOT, packet.boneConstants, true, false);
+            }
+            context->DrawIndexed(range.indexCount, mesh->GetBaseIndex() + range.startIndex, mesh->GetBaseVertex());
+            stats.drawCalls++;
+            stats.trianglesDrawn += range.indexCount / 3;
+        }
+    }
+
+    // Material states must not leak into the passes that follow
+    stateCache.SetRasterizerState(baseRasterizerState);
+    stateCache.SetBlendState(baseBlendState);
+
+    stats.redundantBinds += stateCache.GetRedundantBindCount() - redundantBindsBefore;
+}
+
+void RenderQueue::WriteObjectConstants(ID3D11DeviceContext* context, ID3D11Buffer* buffer, const DirectX::XMMATRIX& world) {
+    // Same layout and transposition as D3D11Renderer::UpdateConstantBuffer
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if (SUCCEEDED(context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+        ObjectConstants* constants = static_cast<ObjectConstants*>(mappedResource.pData);
+        constants->World = DirectX::XMMatrixTranspose(world);
+        context->Unmap(buffer, 0);
+    }
+}
+
+void RenderQueue::UploadObjectConstants(D3D11Renderer* renderer, bool instancing, bool skinning) {
+    ConstantBufferRing& ring = renderer->GetConstantRing();
+    if (!ring.IsAvailable()) {
+        return;
+    }
+
+    // Later passes reuse the windows unless the ring was discarded since
+    if (m_objectConstantsReady && m_constantGeneration == ring.GetGeneration()) {
+        return;
+    }
+
+    UINT uploadCount = 0;
+    UINT boneUploadCount = 0;
+    for (const auto& batch : m_batches) {
+        if (IsDrawnInstanced(batch, instancing, skinning)) {
+            continue;
+        }
+        for (UINT i = 0; i < batch.packetCount; i++) {
+            if (!m_packets[batch.firstPacket + i].staticConstants) {
+                uploadCount++;
+            }
+        }
+        if (batch.skinned) {
+            boneUploadCount += batch.packetCount;
+        }
+    }
+
+    m_objectConstantsReady = true;
+    if (uploadCount == 0 && boneUploadCount == 0) {
+        m_constantGeneration = ring.GetGeneration();
+        return;
+    }
+
+    // One allocation for the whole queue so it cannot wrap part way through;
+    // bone windows for per-draw skinned packets follow the world records
+    const UINT recordSize = ConstantBufferRing::ALIGNMENT;
+    const UINT boneRecordSize = static_cast<UINT>(sizeof(BoneBuffer));
+    static_assert(sizeof(BoneBuffer) % ConstantBufferRing::ALIGNMENT == 0, "Bone windows must stay aligned");
+    ConstantAllocation allocation;
+    if (ring.Map()) {
+        allocation = ring.Allocate(uploadCount * recordSize + boneUploadCount * boneRecordSize);
+    }
+    if (!allocation.data) {
+        ring.Unmap();
+        for (auto& packet : m_packets) {
+            if (!packet.staticConstants) {
+                packet.objectConstants = ConstantBinding();
+            }
+            packet.boneConstants = ConstantBinding();
+        }
+        m_objectConstantsReady = false;
+        LOG_WARNING("Constant ring cannot hold " << uploadCount << " draws, using per-draw constant buffers");
+        return;
+    }
+
+    std::uint8_t* records = static_cast<std::uint8_t*>(allocation.data);
+    std::uint8_t* boneRecords = records + uploadCount * recordSize;
+    UINT firstBoneConstant = allocation.firstConstant + uploadCount * (recordSize / 16);
+    const DirectX::XMFLOAT4X4* palette = m_bonePalette.GetMatrices();
+    const std::uint32_t paletteSize = m_bonePalette.GetMatrixCount();
+    const std::uint32_t maxBones = boneRecordSize / static_cast<UINT>(sizeof(DirectX::XMFLOAT4X4));
+    UINT record = 0;
+    UINT boneRecord = 0;
+    for (const auto& batch : m_batches) {
+        if (IsDrawnInstanced(batch, instancing, skinning)) {
+            continue;
+        }
+        for (UINT i = 0; i < batch.packetCount; i++) {
+            RenderPacket& packet = m_packets[batch.firstPacket + i];
+
+            if (batch.skinned) {
+                // The palette does not keep each character's bone count; copying
+                // past it is harmless since vertices only index their own bones
+                std::uint32_t boneCount = std::min(maxBones, paletteSize - packet.boneOffset);
+                std::memcpy(boneRecords + boneRecord * boneRecordSize, palette + packet.boneOffset,
+                            boneCount * sizeof(DirectX::XMFLOAT4X4));
+
+                packet.boneConstants.buffer = allocation.buffer;
+                packet.boneConstants.firstConstant = firstBoneConstant + boneRecord * (boneRecordSize / 16);
+                packet.boneConstants.constantCount = boneRecordSize / 16;
+                boneRecord++;
+            }
+
+            if (packet.staticConstants) {
+                continue;
+            }
+
+            ObjectConstants* constants = reinterpret_cast<ObjectConstants*>(records + record * recordSize);
+            constants->World = DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&packet.worldMatrix));
+
+            packet.objectConstants.buffer = allocation.buffer;
+            packet.objectConstants.firstConstant = allocation.firstConstant + record * (recordSize / 16);
+            packet.objectConstants.constantCount = recordSize / 16;
+            record++;
+        }
+    }
+    ring.Unmap();
+
+    m_constantGeneration = ring.GetGeneration();
+    m_stats.constantsUploaded = uploadCount;
+}
+
+void RenderQueue::BuildBatches() {
+    m_batches.clear();
+
+    UINT packetCount = static_cast<UINT>(m_packets.size());
+    UINT start = 0;
+    while (start < packetCount) {
+        const RenderPacket& first = m_packets[start];
+
+        UINT end = start + 1;
+        while (end < packetCount &&
+               m_packets[end].mesh == first.mesh &&
+               m_packets[end].subMeshIndex == first.subMeshIndex &&
+               m_packets[end].lod == first.lod &&
+               m_packets[end].material == first.material &&
+               m_packets[end].skinnedVertices == first.skinnedVertices &&
+               (m_packets[end].boneOffset == BonePalette::INVALID_OFFSET) ==
+                   (first.boneOffset == BonePalette::INVALID_OFFSET)) {
+            end++;
+        }
+
+        RenderBatch batch;
+        batch.firstPacket = start;
+        batch.packetCount = end - start;
+        batch.firstInstance = 0;
+        batch.skinned = first.boneOffset != BonePalette::INVALID_OFFSET;
+        batch.instanced = CanInstance(batch);
+        m_batches.push_back(batch);
+
+        start = end;
+    }
+}
+
+void RenderQueue::PrepareMaterials(D3D11Renderer* renderer) const {
+    // Batches recorded on worker threads must find their constants built
+    ID3D11Device* device = renderer->GetDevice();
+    const Mesh::Material* previous = nullptr;
+    for (const auto& batch : m_batches) {
+        Mesh::Material* material = m_packets[batch.firstPacket].material;
+        if (material && material != previous) {
+            material->PrepareConstants(device);
+            previous = material;
+        }
+    }
+}
+
+bool RenderQueue::CanInstance(const RenderBatch& batch) const {
+    // Materials with custom shaders keep the per-draw path
+    const RenderPacket& first = m_packets[batch.firstPacket];
+    if (first.material && first.material->GetVertexShader()) {
+        return false;
+    }
+
+    // Skinned draws need their palette offset from the instance stream, even alone
+    if (batch.skinned) {
+        return IsSkinningEnabled();
+    }
+
+    if (!IsInstancingEnabled() || batch.packetCount < m_minInstanceCount) {
+        return false;
+    }
+
+    // Animated meshes without a bone palette, or compute-skinned, keep the per-draw path
+    return !first.mesh->IsAnimated();
+}
+
+bool RenderQueue::UploadInstanceData(D3D11Renderer* renderer) {
+    UINT instanceCount = 0;
+    for (auto& batch : m_batches) {
+        if (batch.instanced) {
+            batch.firstInstance = instanceCount;
+            instanceCount += batch.packetCount;
+        }
+    }
+
+    if (instanceCount == 0) {
+        return false;
+    }
+
+    // Grow the instance buffer geometrically
+    if (instanceCount > m_instanceCapacity) {
+        UINT newCapacity = std::max(m_instanceCapacity * 2, instanceCount);
+        m_instanceBuffer = renderer->CreateVertexBuffer(nullptr, newCapacity * sizeof(Mesh::InstanceData), true);
+        if (!m_instanceBuffer) {
+            LOG_ERROR("Failed to create instance buffer for " << newCapacity << " instances");
+            m_instanceCapacity = 0;
+            return false;
+        }
+        m_instanceCapacity = newCapacity;
+    }
+
+    ID3D11DeviceContext* context = renderer->GetContext();
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    HRESULT hr = context->Map(m_instanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to map instance buffer");
+        return false;
+    }
+
+    Mesh::InstanceData* instances = static_cast<Mesh::InstanceData*>(mappedResource.pData);
+    for (const auto& batch : m_batches) {
+        if (!batch.instanced) {
+            continue;
+        }
+
+        for (UINT i = 0; i < batch.packetCount; i++) {
+            const RenderPacket& packet = m_packets[batch.firstPacket + i];
+            instances[batch.firstInstance + i].world = packet.worldMatrix;
+            instances[batch.firstInstance + i].boneOffset = batch.skinned ? packet.boneOffset : 0;
+        }
+    }
+
+    context->Unmap(m_instanceBuffer.Get(), 0);
+    renderer->RecordBufferMap(instanceCount * static_cast<UINT>(sizeof(Mesh::InstanceData)));
+    return true;
+}
+
+bool RenderQueue::UploadBonePalette(D3D11Renderer* renderer) {
+    if (m_bonePalette.IsEmpty()) {
+        return false;
+    }
+    if (!m_bonePalette.Upload(renderer->GetDevice(), renderer->GetContext())) {
+        return false;
+    }
+    renderer->RecordBufferMap(m_bonePalette.GetMatrixCount() * static_cast<UINT>(sizeof(DirectX::XMFLOAT4X4)));
+    return true;
+}
+
+void RenderQueue::DispatchSkinning(D3D11Renderer* renderer) {
+    if (m_skinningJobs.empty() || !m_bonePaletteReady) {
+        return;
+    }
+
+    if (!m_computeSkinner.Begin(renderer, m_bonePalette.GetShaderResourceView())) {
+        return;
+    }
+
+    for (const auto& job : m_skinningJobs) {
+        if (m_computeSkinner.Dispatch(renderer, *job.mesh, job.boneOffset, *job.output)) {
+            m_computeSkinnedCount++;
+        }
+    }
+
+    m_computeSkinner.End(renderer);
+}
+
+std::uint64_t RenderQueue::BuildSortKey(std::uint32_t shaderFeatures, std::uint16_t shaderID, std::uint16_t materialID,
+                                        std::uint16_t textureID, std::uint16_t meshID) {
+    static_assert(ShaderFeature::Count <= 4, "Shader permutation no longer fits the sort key");
+
+    // Shader IDs past the 12-bit field saturate like GetResourceID's
+    std::uint64_t shader = std::min<std::uint64_t>(shaderID, 0xFFF);
+    return (static_cast<std::uint64_t>(shaderFeatures & 0xF) << 60) |
+           (shader << 48) |
+           (static_cast<std::uint64_t>(materialID) << 32) |
+           (static_cast<std::uint64_t>(textureID) << 16) |
+           static_cast<std::uint64_t>(meshID);
+}
+
+std::uint16_t RenderQueue::GetResourceID(std::unordered_map<const void*, std::uint16_t>& ids, const void* resource) {
+    if (!resource) {
+        return 0;
+    }
+
+    auto it = ids.find(resource);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    // Saturate rather than wrap so ordering stays stable for huge frames
+    std::uint16_t id = ids.size() < 0xFFFE ? static_cast<std::uint16_t>(ids.size() + 1) : 0xFFFF;
+    ids[resource] = id;
+    return id;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "ContextStateCache.h"
+#include "ConstantBufferRing.h"
+#include "BonePalette.h"
+#include "ComputeSkinning.h"
+#include "RenderStats.h"
+#include "../Mesh/Vertex.h"
+
+namespace GameEngine {
+
+// Forward declarations
+namespace Mesh {
+    class Mesh;
+    class Material;
+}
+
+namespace Renderer {
+
+class D3D11Renderer;
+class DeferredContextPool;
+
+// Single draw submitted to the render queue
+struct RenderPacket {
+    std::uint64_t sortKey;
+    Mesh::Mesh* mesh;
+    Mesh::Material* material;
+    UINT subMeshIndex;
+    UINT lod; // Mesh detail level, 0 is the full mesh
+    DirectX::XMFLOAT4X4 worldMatrix;
+    std::uint32_t boneOffset; // BonePalette::INVALID_OFFSET unless skinned
+    SkinnedVertexOutput* skinnedVertices; // Compute-skinned stream replacing the mesh's vertices
+    ConstantBinding objectConstants; // World constants, uploaded before drawing unless static
+    ConstantBinding boneConstants; // BoneBuffer window for skinned packets drawn per draw
+    bool staticConstants; // objectConstants point into a StaticConstantBuffer
+};
+
+// Mesh instance to skin with the compute shader before drawing
+struct SkinningJob {
+    Mesh::Mesh* mesh;
+    std::uint32_t boneOffset;
+    SkinnedVertexOutput* output;
+};
+
+// Run of sorted packets sharing (mesh, submesh, LOD, material)
+struct RenderBatch {
+    UINT firstPacket;
+    UINT packetCount;
+    UINT firstInstance;
+    bool instanced;
+    bool skinned;
+};
+
+// Per-frame submission statistics
+struct RenderQueueStats {
+    UINT drawCalls = 0;
+    UINT instancedDrawCalls = 0;
+    UINT instancesDrawn = 0;
+    std::uint64_t trianglesDrawn = 0;
+    UINT skinnedInstancesDrawn = 0;
+    UINT bonesUploaded = 0;
+    UINT computeSkinnedMeshes = 0;
+    UINT shaderChanges = 0;
+    UINT materialChanges = 0;
+    UINT meshChanges = 0;
+    UINT bufferChanges = 0;     // Index buffer rebinds; meshes sharing static batch buffers skip them
+    UINT constantsUploaded = 0; // Per-draw object constants written this frame
+    UINT staticConstantDraws = 0; // Draws using constants uploaded at load time
+    UINT redundantBinds = 0;    // Binds skipped by the context state caches
+    UINT bufferMaps = 0;        // Instance, bone and per-draw constant maps outside the constant ring
+    std::uint64_t bytesMapped = 0;
+};
+
+// Collects draw packets for a frame, sorts them by state and submits them
+// with redundant state changes filtered out. When an instancing shader is
+// set, runs of identical (mesh, submesh, LOD, material) packets are drawn
+// with a single DrawIndexedInstanced call. Skinned packets always go through
+// the skinning shader as instances; their bones live in the frame's bone
+// palette, uploaded once alongside the instance data. Skinned packets that
+// cannot be instanced get a BoneBuffer window in the constant ring and are
+// drawn with the per-draw skinning shader instead. In compute-skinning
+// mode each skinned mesh instance is skinned once per frame into its own
+// vertex buffer and then drawn like a static mesh by every pass.
+//
+// Per-draw world matrices are written into the renderer's constant ring in
+// one map before any batch is recorded and bound with offsets; objects with
+// static constants skip the upload entirely. View and projection are bound
+// once per execute.
+//
+// Materials bind their constant buffer, texture table and sampler once per
+// run of packets sharing them; their constant buffers are built before any
+// recording starts.
+//
+// Sort key layout (most significant first):
+//   [63..60] shader permutation   [59..48] shader   [47..32] material
+//   [31..16] texture              [15..0] mesh
+class RenderQueue {
+public:
+    RenderQueue();
+    ~RenderQueue() = default;
+
+    // Frame lifecycle
+    void Clear();
+    void Submit(Mesh::Mesh* mesh, UINT subMeshIndex, Mesh::Material* material, const DirectX::XMMATRIX& worldMatrix,
+                std::uint32_t boneOffset = BonePalette::INVALID_OFFSET,
+                SkinnedVertexOutput* skinnedVertices = nullptr, UINT lod = 0,
+                const ConstantBinding* staticConstants = nullptr);
+    void Sort();
+    // Batch the sorted packets and upload instance data, bones and object
+    // constants once for every pass that executes the queue. Execute calls
+    // it if nothing has since the last Clear, Submit or Sort.
+    void Prepare(D3D11Renderer* renderer);
+    void Execute(D3D11Renderer* renderer);
+
+    // Record sorted batches on deferred contexts in parallel, then play them
+    // back in order. Falls back to Execute for small queues.
+    void ExecuteParallel(D3D11Renderer* renderer, DeferredContextPool& contexts);
+    void SetParallelPacketThreshold(size_t packetCount) { m_parallelPacketThreshold = packetCount; }
+
+    // Layouts matching the caller's bound vertex shader for compact meshes.
+    // Standard meshes keep the bound layout; packets whose format has no
+    // layout are skipped.
+    void SetVertexInputLayouts(const Mesh::VertexInputLayouts& layouts) { m_baseLayouts = layouts; }
+
+    // Pass-wide pixel shader replacing the bound one and the materials',
+    // e.g. the G-buffer shader. Null draws depth only and skips material
+    // binds, as a depth prepass wants.
+    void SetPixelShaderOverride(ID3D11PixelShader* shader) {
+        m_pixelShaderOverride = shader;
+        m_overridePixelShader = true;
+    }
+    void ClearPixelShaderOverride() {
+        m_pixelShaderOverride = nullptr;
+        m_overridePixelShader = false;
+    }
+
+    // Instancing
+    void SetInstancingShader(Microsoft::WRL::ComPtr<ID3D11VertexShader> shader,
+                             Microsoft::WRL::ComPtr<ID3D11InputLayout> layout) {
+        m_instancedShader = shader;
+        m_instancedLayouts = Mesh::VertexInputLayouts();
+        m_instancedLayouts.layouts[static_cast<UINT>(Mesh::VertexFormat::Standard)] = layout;
+    }
+    void SetInstancingShader(Microsoft::WRL::ComPtr<ID3D11VertexShader> shader, const Mesh::VertexInputLayouts& layouts) {
+        m_instancedShader = shader;
+        m_instancedLayouts = layouts;
+    }
+    void SetInstancingEnabled(bool enabled) { m_instancingEnabled = enabled; }
+    bool IsInstancingEnabled() const { return m_instancingEnabled && m_instancedShader; }
+    void SetMinInstanceCount(UINT count) { m_minInstanceCount = count; }
+
+    // Skinning: allocate a character's bones once, then pass the offset to Submit
+    void SetSkinningShader(Microsoft::WRL::ComPtr<ID3D11VertexShader> shader,
+                           Microsoft::WRL::ComPtr<ID3D11InputLayout> layout) {
+        m_skinnedShader = shader;
+        m_skinnedLayouts = Mesh::VertexInputLayouts();
+        m_skinnedLayouts.layouts[static_cast<UINT>(Mesh::VertexFormat::Standard)] = layout;
+    }
+    void SetSkinningShader(Microsoft::WRL::ComPtr<ID3D11VertexShader> shader, const Mesh::VertexInputLayouts& layouts) {
+        m_skinnedShader = shader;
+        m_skinnedLayouts = layouts;
+    }
+    bool IsSkinningEnabled() const { return m_skinnedShader != nullptr; }
+    // Per-draw skinning shader reading bones from the BoneBuffer constants
+    // (at most 100), for skinned packets off the palette path. The layouts
+    // must be created from this shader with Mesh::SkinnedVertexLayouts.
+    // Without it those packets draw in the bind pose.
+    void SetSkinningFallbackShader(Microsoft::WRL::ComPtr<ID3D11VertexShader> shader,
+                                   const Mesh::VertexInputLayouts& layouts) {
+        m_skinnedFallbackShader = shader;
+        m_skinnedFallbackLayouts = layouts;
+    }
+    std::uint32_t AllocateBones(const DirectX::XMMATRIX* boneTransforms, std::uint32_t boneCount) {
+        return m_bonePalette.Allocate(boneTransforms, boneCount);
+    }
+    const BonePalette& GetBonePalette() const { return m_bonePalette; }
+
+    // Compute skinning: queue a mesh instance once, then submit its packets with the same output
+    void SetComputeSkinningShader(Microsoft::WRL::ComPtr<ID3D11ComputeShader> shader) { m_computeSkinner.SetShader(shader); }
+    bool IsComputeSkinningEnabled() const { return m_computeSkinner.IsAvailable(); }
+    void QueueSkinning(Mesh::Mesh* mesh, std::uint32_t boneOffset, SkinnedVertexOutput* output);
+
+    // Upload bones and run queued skinning jobs; Execute calls this, later passes reuse the results
+    void PrepareSkinning(D3D11Renderer* renderer);
+
+    // Queries
+    size_t GetPacketCount() const { return m_packets.size(); }
+    bool IsEmpty() const { return m_packets.empty(); }
+    const RenderQueueStats& GetStats() const { return m_stats; }
+
+    // Key helpers
+    static std::uint64_t BuildSortKey(std::uint32_t shaderFeatures, std::uint16_t shaderID, std::uint16_t materialID,
+                                      std::uint16_t textureID, std::uint16_t meshID);
+
+private:
+    void BuildBatches();
+    void PrepareMaterials(D3D11Renderer* renderer) const;
+    bool UploadInstanceData(D3D11Renderer* renderer);
+    bool UploadBonePalette(D3D11Renderer* renderer);
+    void UploadObjectConstants(D3D11Renderer* renderer, bool instancing, bool skinning);
+    bool IsDrawnInstanced(const RenderBatch& batch, bool instancing, bool skinning) const {
+        // Skinned batches fall back to per-draw skinning if the palette upload failed
+        return instancing && batch.instanced && (skinning || !batch.skinned);
+    }
+    void DispatchSkinning(D3D11Renderer* renderer);
+    bool CanInstance(const RenderBatch& batch) const;
+
+    // Fold draws and maps not reported yet into the renderer's frame
+    // statistics, so uploads shared by several passes count once
+    void ReportFrameStats(D3D11Renderer* renderer);
+
+    // Submit batches [firstBatch, lastBatch) on the cache's context
+    void ExecuteBatches(D3D11Renderer* renderer, ContextStateCache& stateCache, UINT firstBatch, UINT lastBatch,
+                        bool instancing, bool skinning, RenderQueueStats& stats) const;
+    static void WriteObjectConstants(ID3D11DeviceContext* context, ID3D11Buffer* buffer, const DirectX::XMMATRIX& world);
+
+    std::uint16_t GetResourceID(std::unordered_map<const void*, std::uint16_t>& ids, const void* resource);
+
+    std::vector<RenderPacket> m_packets;
+    std::vector<RenderBatch> m_batches;
+    RenderQueueStats m_stats;           // Every pass since Prepare
+    RenderFrameStats m_reportedStats;   // Part of m_stats already given to the renderer
+
+    // Set by Prepare for the current packets
+    bool m_prepared;
+    bool m_instancingReady;
+    bool m_skinningReady;
+
+    // Instancing resources
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_instancedShader;
+    Mesh::VertexInputLayouts m_instancedLayouts;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_instanceBuffer;
+    UINT m_instanceCapacity;
+    UINT m_minInstanceCount;
+    bool m_instancingEnabled;
+
+    // Skinning resources
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_skinnedShader;
+    Mesh::VertexInputLayouts m_skinnedLayouts;
+    BonePalette m_bonePalette;
+    bool m_bonePaletteReady;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> m_skinnedFallbackShader;
+    Mesh::VertexInputLayouts m_skinnedFallbackLayouts;
+
+    // Compute skinning
+    ComputeSkinner m_computeSkinner;
+    std::vector<SkinningJob> m_skinningJobs;
+    bool m_skinningPrepared;
+    UINT m_computeSkinnedCount;
+
+    // Ring generation the packets' object constants were written in
+    std::uint64_t m_constantGeneration;
+    bool m_objectConstantsReady;
+
+    // Compact-format layouts for the caller's vertex shader
+    Mesh::VertexInputLayouts m_baseLayouts;
+
+    ID3D11PixelShader* m_pixelShaderOverride;
+    bool m_overridePixelShader;
+
+    size_t m_parallelPacketThreshold;
+
+    // Compact per-frame IDs for sort key fields (0 is reserved for "none")
+    std::unordered_map<const void*, std::uint16_t> m_shaderIDs;
+    std::unordered_map<const void*, std::uint16_t> m_materialIDs;
+    std::unordered_map<const void*, std::uint16_t> m_textureIDs;
+    std::unordered_map<const void*, std::uint16_t> m_meshIDs;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstdint>
+
+namespace GameEngine {
+namespace Renderer {
+
+// Counters for one frame, gathered by D3D11Renderer from its own draws and
+// uploads, the render queue, GPU-driven draws, the state caches, the
+// shadow passes and the frame graph. Triangles assume triangle lists; indirect draws are counted
+// but their instances and triangles are decided on the GPU and left out.
+struct RenderFrameStats {
+    std::uint64_t frameIndex = 0;
+    UINT drawCalls = 0;             // Every draw, including instanced and indirect ones
+    UINT instancedDrawCalls = 0;
+    UINT indirectDrawCalls = 0;
+    UINT instancesDrawn = 0;        // Instances across instanced draws
+    std::uint64_t trianglesDrawn = 0;
+    UINT stateChanges = 0;          // Binds issued through the context state caches
+    UINT redundantBinds = 0;        // Binds the caches skipped
+    UINT shaderBinds = 0;           // Vertex and pixel shader changes, included in stateChanges
+    UINT bufferMaps = 0;
+    std::uint64_t bytesMapped = 0;
+    UINT lightsVisible = 0;
+    UINT lightsCulled = 0;
+    UINT shadowMapsRendered = 0;    // ShadowMapManager views: 2D maps, cascades and cube faces
+    UINT shadowMapsFiltered = 0;    // VSM maps blurred and mipmapped, once per map however many slices
+    UINT framePasses = 0;           // Frame graph passes declared, including culled ones
+    UINT framePassesCulled = 0;
+    UINT transientAcquires = 0;     // Pooled textures handed out, by the graph and the shadow blur
+    UINT transientReuses = 0;       // Acquires that got a texture already used this frame
+    UINT transientTextures = 0;     // Pool size at the end of the frame, free or in use
+    std::uint64_t transientBytes = 0;
+
+    float GetInstancesPerBatch() const {
+        return instancedDrawCalls > 0 ? static_cast<float>(instancesDrawn) / instancedDrawCalls : 0.0f;
+    }
+};
+
+} // namespace Renderer
+} // namespace GameEngine
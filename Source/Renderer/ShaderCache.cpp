@@ -0,0 +1,235 @@
+#include "ShaderCache.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Logger.h"
+#include <d3dcompiler.h>
+#include <wrl/client.h>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+const char* const FEATURE_DEFINES[ShaderFeature::Count] = {
+    "SKINNED",
+    "INSTANCED",
+    "SHADOW",
+    "NORMAL_MAP"
+};
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t HashBytes(const void* data, size_t size, std::uint64_t hash = FNV_OFFSET_BASIS) {
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+std::string ToPath(const std::wstring& filename) {
+    return std::filesystem::path(filename).string();
+}
+
+// Shaders/Name.hlsl precompiles to Shaders/Name.cso, Name.hlsl.txt to Name.hlsl.cso
+std::string GetPrecompiledPath(const std::wstring& filename) {
+    std::filesystem::path path(filename);
+    path.replace_extension(".cso");
+    return path.string();
+}
+
+std::wstring GetVariantName(const std::wstring& filename, ShaderStage stage, std::uint32_t features) {
+    return filename + L"|" + std::to_wstring(static_cast<int>(stage)) + L"|" + std::to_wstring(features);
+}
+
+} // namespace
+
+ShaderCache::ShaderCache()
+    : m_cacheDirectory(DEFAULT_DIRECTORY)
+#ifdef _DEBUG
+    , m_compileFlags(D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION)
+#else
+    , m_compileFlags(D3DCOMPILE_OPTIMIZATION_LEVEL3)
+#endif
+{
+}
+
+void ShaderCache::Initialize(const std::string& cacheDirectory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cacheDirectory = cacheDirectory;
+    if (!m_cacheDirectory.empty()) {
+        FILE_SYSTEM.CreateDirectories(m_cacheDirectory);
+    }
+}
+
+ShaderBytecode ShaderCache::GetBytecode(const std::wstring& filename, ShaderStage stage, std::uint32_t features) {
+    std::wstring name = GetVariantName(filename, stage, features);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_variants.find(name);
+        if (it != m_variants.end()) {
+            m_stats.memoryHits++;
+            return it->second;
+        }
+    }
+
+    // Build-time shaders only exist for the base variant
+    ShaderBytecode bytecode;
+    if (features == ShaderFeature::None) {
+        bytecode = LoadPrecompiled(filename);
+    }
+    if (!bytecode) {
+        bytecode = Compile(filename, stage, features);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (bytecode) {
+        m_variants[name] = bytecode;
+    }
+    else {
+        m_stats.failures++;
+    }
+    return bytecode;
+}
+
+unsigned int ShaderCache::Precompile(const std::vector<ShaderVariantDesc>& variants) {
+    unsigned int available = 0;
+    for (const auto& variant : variants) {
+        if (GetBytecode(variant.filename, variant.stage, variant.features)) {
+            available++;
+        }
+    }
+    return available;
+}
+
+void ShaderCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_variants.clear();
+}
+
+ShaderCacheStats ShaderCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+const char* ShaderCache::GetFeatureDefine(std::uint32_t featureBit) {
+    for (std::uint32_t i = 0; i < ShaderFeature::Count; i++) {
+        if (featureBit == (1u << i)) {
+            return FEATURE_DEFINES[i];
+        }
+    }
+    return nullptr;
+}
+
+const char* ShaderCache::GetProfile(ShaderStage stage) {
+    switch (stage) {
+        case ShaderStage::Vertex: return "vs_5_0";
+        case ShaderStage::Pixel: return "ps_5_0";
+        case ShaderStage::Compute: return "cs_5_0";
+    }
+    return nullptr;
+}
+
+ShaderBytecode ShaderCache::LoadPrecompiled(const std::wstring& filename) {
+    std::string sourcePath = ToPath(filename);
+    std::string precompiledPath = GetPrecompiledPath(filename);
+    if (!FILE_SYSTEM.FileExists(precompiledPath)) {
+        return nullptr;
+    }
+
+    // A source edited since the build wins over the stale .cso
+    if (FILE_SYSTEM.FileExists(sourcePath) && !FILE_SYSTEM.IsFileNewer(precompiledPath, sourcePath)) {
+        return nullptr;
+    }
+
+    auto bytecode = std::make_shared<std::vector<std::uint8_t>>();
+    if (!FILE_SYSTEM.ReadBinaryFile(precompiledPath, *bytecode) || bytecode->empty()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.precompiledHits++;
+    return bytecode;
+}
+
+ShaderBytecode ShaderCache::Compile(const std::wstring& filename, ShaderStage stage, std::uint32_t features) {
+    std::string sourcePath = ToPath(filename);
+    std::vector<std::uint8_t> source;
+    if (!FILE_SYSTEM.ReadBinaryFile(sourcePath, source) || source.empty()) {
+        LOG_ERROR("Failed to read shader source: " << sourcePath);
+        return nullptr;
+    }
+
+    // Defines for the permutation, null-terminated as D3DCompile expects
+    std::vector<D3D_SHADER_MACRO> macros;
+    for (std::uint32_t i = 0; i < ShaderFeature::Count; i++) {
+        if (features & (1u << i)) {
+            macros.push_back({ FEATURE_DEFINES[i], "1" });
+        }
+    }
+    macros.push_back({ nullptr, nullptr });
+
+    const char* profile = GetProfile(stage);
+    std::uint64_t key = HashBytes(source.data(), source.size());
+    key = HashBytes(&features, sizeof(features), key);
+    key = HashBytes(profile, std::strlen(profile), key);
+    key = HashBytes(&m_compileFlags, sizeof(m_compileFlags), key);
+
+    std::string cachePath = GetCachePath(filename, key);
+    if (!cachePath.empty() && FILE_SYSTEM.FileExists(cachePath)) {
+        auto cached = std::make_shared<std::vector<std::uint8_t>>();
+        if (FILE_SYSTEM.ReadBinaryFile(cachePath, *cached) && !cached->empty()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.diskHits++;
+            return cached;
+        }
+    }
+
+    Microsoft::WRL::ComPtr<ID3DBlob> shaderBlob;
+    Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+    HRESULT hr = D3DCompile(source.data(), source.size(), sourcePath.c_str(), macros.data(),
+                            D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", profile, m_compileFlags, 0,
+                            &shaderBlob, &errorBlob);
+    if (FAILED(hr)) {
+        LOG_ERROR("Shader compilation failed: " << sourcePath << " (features " << features << ")"
+                  << (errorBlob ? ": " : "")
+                  << (errorBlob ? static_cast<const char*>(errorBlob->GetBufferPointer()) : ""));
+        return nullptr;
+    }
+
+    const std::uint8_t* begin = static_cast<const std::uint8_t*>(shaderBlob->GetBufferPointer());
+    auto bytecode = std::make_shared<std::vector<std::uint8_t>>(begin, begin + shaderBlob->GetBufferSize());
+
+    // Best effort; a read-only install just compiles again next run
+    if (!cachePath.empty() && !FILE_SYSTEM.WriteBinaryFile(cachePath, *bytecode)) {
+        LOG_WARNING("Failed to write shader cache file: " << cachePath);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.compiled++;
+    return bytecode;
+}
+
+std::string ShaderCache::GetCachePath(const std::wstring& filename, std::uint64_t key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_cacheDirectory.empty()) {
+        return std::string();
+    }
+
+    std::filesystem::path stem(filename);
+    stem = stem.filename();
+    while (stem.has_extension()) {
+        stem.replace_extension();
+    }
+
+    std::ostringstream name;
+    name << stem.string() << "_" << std::hex << std::setw(16) << std::setfill('0') << key << ".cso";
+    return FILE_SYSTEM.CombinePaths(m_cacheDirectory, name.str());
+}
+
+} // namespace Renderer
+} // namespace GameEngine
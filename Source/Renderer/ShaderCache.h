@@ -0,0 +1,94 @@
+#pragma once
+
+#include <d3d11.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer {
+
+enum class ShaderStage {
+    Vertex,
+    Pixel,
+    Compute
+};
+
+// Permutation bits; each one compiles the variant with a matching
+// preprocessor define set to 1
+namespace ShaderFeature {
+    constexpr std::uint32_t None = 0;
+    constexpr std::uint32_t Skinned = 1u << 0;      // SKINNED
+    constexpr std::uint32_t Instanced = 1u << 1;    // INSTANCED
+    constexpr std::uint32_t Shadow = 1u << 2;       // SHADOW
+    constexpr std::uint32_t NormalMap = 1u << 3;    // NORMAL_MAP
+    constexpr std::uint32_t Count = 4;
+}
+
+// Variant to compile ahead of time
+struct ShaderVariantDesc {
+    std::wstring filename;
+    ShaderStage stage;
+    std::uint32_t features;
+};
+
+struct ShaderCacheStats {
+    unsigned int memoryHits = 0;
+    unsigned int precompiledHits = 0;   // Build-time .cso next to the source
+    unsigned int diskHits = 0;          // Variants compiled on an earlier run
+    unsigned int compiled = 0;
+    unsigned int failures = 0;
+};
+
+using ShaderBytecode = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+// Compiled shader bytecode by (source, stage, permutation).
+//
+// Lookups go from memory to the base variant precompiled at build time
+// (Shaders/Name.cso, used while it is newer than its source) to the on-disk
+// cache, and compile with d3dcompiler only when all of those miss. Cache
+// files are named by a hash of the source text, defines, profile and flags,
+// so edited shaders or changed options simply miss and recompile. Files
+// pulled in with #include are not part of the hash.
+class ShaderCache {
+public:
+    static constexpr const char* DEFAULT_DIRECTORY = "ShaderCache";
+
+    ShaderCache();
+    ~ShaderCache() = default;
+
+    void Initialize(const std::string& cacheDirectory = DEFAULT_DIRECTORY);
+
+    // Null and logged if the variant does not compile
+    ShaderBytecode GetBytecode(const std::wstring& filename, ShaderStage stage, std::uint32_t features = ShaderFeature::None);
+
+    // Compile variants before they are needed so first use does not hitch;
+    // returns how many are available
+    unsigned int Precompile(const std::vector<ShaderVariantDesc>& variants);
+
+    // Drop the in-memory variants, e.g. after shader sources changed
+    void Clear();
+
+    ShaderCacheStats GetStats() const;
+
+    static const char* GetFeatureDefine(std::uint32_t featureBit);
+    static const char* GetProfile(ShaderStage stage);
+
+private:
+    ShaderBytecode LoadPrecompiled(const std::wstring& filename);
+    ShaderBytecode Compile(const std::wstring& filename, ShaderStage stage, std::uint32_t features);
+    std::string GetCachePath(const std::wstring& filename, std::uint64_t key) const;
+
+    std::string m_cacheDirectory;
+    UINT m_compileFlags;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::wstring, ShaderBytecode> m_variants;
+    ShaderCacheStats m_stats;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,536 @@
+#include "ShadowAtlas.h"
+#include "GpuMemory.h"
+#include "Light.h"
+#include "GpuProfiler.h"
+#include "../Core/Logger.h"
+#include <d3dcompiler.h>
+#include <algorithm>
+#include <cstring>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+// Full-viewport triangle at the far plane; with depth test ALWAYS it resets
+// just the bound viewport, which ClearDepthStencilView cannot do
+const char CLEAR_TILE_SHADER[] =
+    "float4 main(uint id : SV_VertexID) : SV_POSITION\n"
+    "{\n"
+    "    float2 uv = float2((id << 1) & 2, id & 2);\n"
+    "    return float4(uv * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f), 1.0f, 1.0f);\n"
+    "}\n";
+
+bool MatricesEqual(const DirectX::XMFLOAT4X4& a, const DirectX::XMFLOAT4X4& b) {
+    return std::memcmp(&a, &b, sizeof(DirectX::XMFLOAT4X4)) == 0;
+}
+
+// Conservative box vs clip volume test: only rejects when all eight corners
+// fall outside the same clip plane. Works for perspective and orthographic.
+bool BoxIntersectsVolume(const DirectX::BoundingBox& bounds, const DirectX::XMFLOAT4X4& viewProjection) {
+    DirectX::XMFLOAT3 corners[DirectX::BoundingBox::CORNER_COUNT];
+    bounds.GetCorners(corners);
+
+    DirectX::XMMATRIX matrix = DirectX::XMLoadFloat4x4(&viewProjection);
+    UINT outside[6] = {};
+    for (const DirectX::XMFLOAT3& corner : corners) {
+        DirectX::XMFLOAT4 clip;
+        DirectX::XMStoreFloat4(&clip, DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&corner), matrix));
+        outside[0] += clip.x < -clip.w;
+        outside[1] += clip.x > clip.w;
+        outside[2] += clip.y < -clip.w;
+        outside[3] += clip.y > clip.w;
+        outside[4] += clip.z < 0.0f;
+        outside[5] += clip.z > clip.w;
+    }
+
+    for (UINT count : outside) {
+        if (count == DirectX::BoundingBox::CORNER_COUNT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+ShadowAtlas::ShadowAtlas()
+    : m_size(0)
+    , m_levelCount(0)
+    , m_frame(0)
+{
+}
+
+bool ShadowAtlas::Initialize(ID3D11Device* device, UINT size, UINT minTileSize) {
+    if (!device || size == 0 || minTileSize == 0 || minTileSize > size) {
+        LOG_ERROR("Invalid shadow atlas size " << size << " / " << minTileSize);
+        return false;
+    }
+
+    // Both sizes must be powers of two for tiles to subdivide evenly
+    while ((size & (size - 1)) != 0) {
+        size &= size - 1;
+    }
+    while ((minTileSize & (minTileSize - 1)) != 0) {
+        minTileSize &= minTileSize - 1;
+    }
+
+    m_size = size;
+    m_levelCount = 1;
+    while ((m_size >> m_levelCount) >= minTileSize) {
+        m_levelCount++;
+    }
+
+    m_entries.clear();
+    m_freeTiles.assign(m_levelCount, std::vector<Tile>());
+    m_freeTiles[0].push_back(Tile{ 0, 0, m_size });
+
+    HRESULT hr;
+
+    // Same depth format as ShadowMap so existing sampling code applies
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = m_size;
+    textureDesc.Height = m_size;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.SampleDesc.Quality = 0;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+
+    hr = device->CreateTexture2D(&textureDesc, nullptr, &m_texture);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create shadow atlas texture");
+        return false;
+    }
+    TrackGpuMemory(m_texture.Get(), Core::MemoryCategory::Renderer);
+
+    D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+    dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+
+    hr = device->CreateDepthStencilView(m_texture.Get(), &dsvDesc, &m_depthStencilView);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create shadow atlas depth stencil view");
+        return false;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = 1;
+
+    hr = device->CreateShaderResourceView(m_texture.Get(), &srvDesc, &m_shaderResourceView);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create shadow atlas shader resource view");
+        return false;
+    }
+
+    // Outside every tile reads as lit
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter = D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.BorderColor[0] = 1.0f;
+    samplerDesc.BorderColor[1] = 1.0f;
+    samplerDesc.BorderColor[2] = 1.0f;
+    samplerDesc.BorderColor[3] = 1.0f;
+    samplerDesc.ComparisonFunc = D3D11_COMPARISON_LESS_EQUAL;
+    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+    hr = device->CreateSamplerState(&samplerDesc, &m_comparisonSampler);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create shadow atlas sampler");
+        return false;
+    }
+
+    if (!CreateClearResources(device)) {
+        return false;
+    }
+
+    LOG_DEBUG("Shadow atlas created (" << m_size << "x" << m_size << ", smallest tile "
+              << (m_size >> (m_levelCount - 1)) << ")");
+    return true;
+}
+
+bool ShadowAtlas::CreateClearResources(ID3D11Device* device) {
+    ComPtr<ID3DBlob> shaderBlob;
+    ComPtr<ID3DBlob> errorBlob;
+
+    HRESULT hr = D3DCompile(CLEAR_TILE_SHADER, sizeof(CLEAR_TILE_SHADER) - 1, "ShadowAtlasClear",
+                            nullptr, nullptr, "main", "vs_5_0", 0, 0, &shaderBlob, &errorBlob);
+    if (FAILED(hr)) {
+        if (errorBlob) {
+            LOG_ERROR("Shadow atlas clear shader compilation failed: " << (char*)errorBlob->GetBufferPointer());
+        }
+        return false;
+    }
+
+    hr = device->CreateVertexShader(shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(),
+                                    nullptr, &m_clearShader);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create shadow atlas clear shader");
+        return false;
+    }
+
+    D3D11_DEPTH_STENCIL_DESC depthDesc = {};
+    depthDesc.DepthEnable = TRUE;
+    depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+    depthDesc.DepthFunc = D3D11_COMPARISON_ALWAYS;
+
+    hr = device->CreateDepthStencilState(&depthDesc, &m_clearDepthState);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create shadow atlas clear depth state");
+        return false;
+    }
+
+    D3D11_RASTERIZER_DESC rasterDesc = {};
+    rasterDesc.FillMode = D3D11_FILL_SOLID;
+    rasterDesc.CullMode = D3D11_CULL_NONE;
+    rasterDesc.DepthClipEnable = TRUE;
+
+    hr = device->CreateRasterizerState(&rasterDesc, &m_rasterizerState);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create shadow atlas rasterizer state");
+        return false;
+    }
+
+    return true;
+}
+
+void ShadowAtlas::BeginFrame() {
+    m_frame++;
+    m_stats = Stats();
+}
+
+bool ShadowAtlas::Request(const Light* light, UINT resolution) {
+    if (!light || !m_texture || light->GetType() == LightType::Point) {
+        return false;
+    }
+
+    m_stats.tilesRequested++;
+
+    if (resolution == 0) {
+        resolution = static_cast<UINT>(std::max(light->GetShadowMapSize(), 1));
+    }
+    UINT level = LevelForResolution(resolution);
+
+    DirectX::XMMATRIX view = light->GetViewMatrix();
+    DirectX::XMMATRIX projection = light->GetProjectionMatrix();
+
+    Entry* entry = nullptr;
+    auto it = m_entries.find(light);
+    if (it != m_entries.end()) {
+        entry = &it->second;
+
+        // Resized: move when the new size fits as is, otherwise a degraded
+        // tile is kept so a full atlas does not redraw it every frame
+        UINT wantedSize = m_size >> level;
+        if (entry->tile.size != wantedSize) {
+            Tile resized;
+            if (AllocateTile(level, resized)) {
+                FreeTile(entry->tile);
+                entry->tile = resized;
+                entry->dirty = true;
+                entry->drawn = false;
+            } else if (entry->tile.size > wantedSize) {
+                FreeTile(entry->tile);
+                entry->tile = Tile();
+            }
+        }
+    } else {
+        entry = &m_entries[light];
+    }
+    entry->lastRequested = m_frame;
+
+    if (entry->tile.size == 0) {
+        // Prefer the requested size, evicting stale tiles, then degrade
+        bool allocated = false;
+        for (UINT l = level; l < m_levelCount && !allocated; l++) {
+            allocated = AllocateTile(l, entry->tile);
+            while (!allocated && EvictLeastRecent()) {
+                allocated = AllocateTile(l, entry->tile);
+            }
+        }
+
+        if (!allocated) {
+            LOG_WARNING("Shadow atlas full, light has no shadow this frame");
+            m_entries.erase(light);
+            return false;
+        }
+        entry->dirty = true;
+        entry->drawn = false;
+    }
+
+    DirectX::XMFLOAT4X4 newView;
+    DirectX::XMFLOAT4X4 newProjection;
+    DirectX::XMStoreFloat4x4(&newView, view);
+    DirectX::XMStoreFloat4x4(&newProjection, projection);
+
+    // A moved or reshaped light invalidates its own tile
+    if (entry->dirty || !MatricesEqual(newView, entry->view) || !MatricesEqual(newProjection, entry->projection)) {
+        entry->view = newView;
+        entry->projection = newProjection;
+        DirectX::XMStoreFloat4x4(&entry->viewProjection, DirectX::XMMatrixMultiply(view, projection));
+        entry->dirty = true;
+    }
+
+    if (!entry->dirty) {
+        m_stats.tilesCached++;
+    }
+    return true;
+}
+
+void ShadowAtlas::Invalidate(const DirectX::BoundingBox& bounds) {
+    for (auto& pair : m_entries) {
+        Entry& entry = pair.second;
+        if (!entry.dirty && BoxIntersectsVolume(bounds, entry.viewProjection)) {
+            entry.dirty = true;
+        }
+    }
+}
+
+void ShadowAtlas::InvalidateAll() {
+    for (auto& pair : m_entries) {
+        pair.second.dirty = true;
+    }
+}
+
+void ShadowAtlas::Release(const Light* light) {
+    auto it = m_entries.find(light);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    FreeTile(it->second.tile);
+    m_entries.erase(it);
+}
+
+void ShadowAtlas::Render(ID3D11DeviceContext* context, const RenderCallback& renderCallback) {
+    if (!context || !m_texture) {
+        return;
+    }
+
+    PROFILE_SCOPE("Shadow");
+    GPU_PROFILE_SCOPE(context, "Shadow");
+
+    // Save the state the tiles overwrite
+    ComPtr<ID3D11RenderTargetView> oldRenderTarget;
+    ComPtr<ID3D11DepthStencilView> oldDepthStencil;
+    context->OMGetRenderTargets(1, &oldRenderTarget, &oldDepthStencil);
+
+    UINT viewportCount = 1;
+    D3D11_VIEWPORT oldViewport = {};
+    context->RSGetViewports(&viewportCount, &oldViewport);
+
+    ComPtr<ID3D11RasterizerState> oldRasterizer;
+    context->RSGetState(&oldRasterizer);
+
+    ComPtr<ID3D11DepthStencilState> oldDepthState;
+    UINT oldStencilRef = 0;
+    context->OMGetDepthStencilState(&oldDepthState, &oldStencilRef);
+
+    // The atlas may still be bound for sampling from last frame
+    ID3D11ShaderResourceView* boundViews[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT] = {};
+    context->PSGetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, boundViews);
+    for (UINT slot = 0; slot < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; slot++) {
+        if (boundViews[slot] == m_shaderResourceView.Get()) {
+            ID3D11ShaderResourceView* nullView = nullptr;
+            context->PSSetShaderResources(slot, 1, &nullView);
+        }
+        if (boundViews[slot]) {
+            boundViews[slot]->Release();
+        }
+    }
+    context->OMSetRenderTargets(0, nullptr, m_depthStencilView.Get());
+
+    for (auto& pair : m_entries) {
+        Entry& entry = pair.second;
+        if (!entry.dirty || entry.lastRequested != m_frame) {
+            continue;
+        }
+
+        D3D11_VIEWPORT viewport;
+        viewport.TopLeftX = static_cast<float>(entry.tile.x);
+        viewport.TopLeftY = static_cast<float>(entry.tile.y);
+        viewport.Width = static_cast<float>(entry.tile.size);
+        viewport.Height = static_cast<float>(entry.tile.size);
+        viewport.MinDepth = 0.0f;
+        viewport.MaxDepth = 1.0f;
+        context->RSSetViewports(1, &viewport);
+
+        ClearTile(context, entry.tile);
+
+        // Casters draw with the caller's regular depth test
+        context->RSSetState(m_rasterizerState.Get());
+        context->OMSetDepthStencilState(oldDepthState.Get(), oldStencilRef);
+        if (renderCallback) {
+            renderCallback(DirectX::XMLoadFloat4x4(&entry.view), DirectX::XMLoadFloat4x4(&entry.projection));
+        }
+
+        entry.dirty = false;
+        entry.drawn = true;
+        m_stats.tilesRendered++;
+    }
+
+    // Restore state
+    context->OMSetRenderTargets(1, oldRenderTarget.GetAddressOf(), oldDepthStencil.Get());
+    context->RSSetViewports(1, &oldViewport);
+    context->RSSetState(oldRasterizer.Get());
+    context->OMSetDepthStencilState(oldDepthState.Get(), oldStencilRef);
+    Bind(context);
+}
+
+void ShadowAtlas::Bind(ID3D11DeviceContext* context) const {
+    ID3D11ShaderResourceView* view = m_shaderResourceView.Get();
+    ID3D11SamplerState* sampler = m_comparisonSampler.Get();
+    context->PSSetShaderResources(TEXTURE_SLOT, 1, &view);
+    context->PSSetSamplers(SAMPLER_SLOT, 1, &sampler);
+}
+
+void ShadowAtlas::BindCompute(ID3D11DeviceContext* context) const {
+    ID3D11ShaderResourceView* view = m_shaderResourceView.Get();
+    ID3D11SamplerState* sampler = m_comparisonSampler.Get();
+    context->CSSetShaderResources(TEXTURE_SLOT, 1, &view);
+    context->CSSetSamplers(SAMPLER_SLOT, 1, &sampler);
+}
+
+void ShadowAtlas::ClearTile(ID3D11DeviceContext* context, const Tile& tile) {
+    context->IASetInputLayout(nullptr);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->VSSetShader(m_clearShader.Get(), nullptr, 0);
+    context->PSSetShader(nullptr, nullptr, 0);
+    context->RSSetState(m_rasterizerState.Get());
+    context->OMSetDepthStencilState(m_clearDepthState.Get(), 0);
+    context->Draw(3, 0);
+}
+
+bool ShadowAtlas::GetShadowMatrix(const Light* light, DirectX::XMMATRIX& shadowMatrix) const {
+    auto it = m_entries.find(light);
+    if (it == m_entries.end() || it->second.tile.size == 0 || !it->second.drawn) {
+        return false;
+    }
+    const Tile& tile = it->second.tile;
+
+    // NDC [-1, 1] to the tile's UV rectangle, y flipped
+    float scale = 0.5f * static_cast<float>(tile.size) / static_cast<float>(m_size);
+    float offsetX = (static_cast<float>(tile.x) + 0.5f * tile.size) / static_cast<float>(m_size);
+    float offsetY = (static_cast<float>(tile.y) + 0.5f * tile.size) / static_cast<float>(m_size);
+
+    DirectX::XMMATRIX tileMatrix(
+        scale, 0.0f, 0.0f, 0.0f,
+        0.0f, -scale, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        offsetX, offsetY, 0.0f, 1.0f);
+
+    shadowMatrix = DirectX::XMLoadFloat4x4(&it->second.viewProjection) * tileMatrix;
+    return true;
+}
+
+bool ShadowAtlas::GetTile(const Light* light, Tile& tile) const {
+    auto it = m_entries.find(light);
+    if (it == m_entries.end() || it->second.tile.size == 0 || !it->second.drawn) {
+        return false;
+    }
+
+    tile = it->second.tile;
+    return true;
+}
+
+UINT ShadowAtlas::LevelForResolution(UINT resolution) const {
+    // Largest tile that does not exceed the resolution
+    UINT level = 0;
+    while (level + 1 < m_levelCount && (m_size >> level) > resolution) {
+        level++;
+    }
+    return level;
+}
+
+bool ShadowAtlas::AllocateTile(UINT level, Tile& tile) {
+    // Find the smallest free tile at or above this level
+    int source = static_cast<int>(level);
+    while (source >= 0 && m_freeTiles[source].empty()) {
+        source--;
+    }
+    if (source < 0) {
+        return false;
+    }
+
+    Tile current = m_freeTiles[source].back();
+    m_freeTiles[source].pop_back();
+
+    // Split down, keeping the top-left quarter and freeing the other three
+    for (UINT l = static_cast<UINT>(source); l < level; l++) {
+        UINT half = current.size / 2;
+        m_freeTiles[l + 1].push_back(Tile{ current.x + half, current.y, half });
+        m_freeTiles[l + 1].push_back(Tile{ current.x, current.y + half, half });
+        m_freeTiles[l + 1].push_back(Tile{ current.x + half, current.y + half, half });
+        current.size = half;
+    }
+
+    tile = current;
+    return true;
+}
+
+void ShadowAtlas::FreeTile(const Tile& tile) {
+    if (tile.size == 0) {
+        return;
+    }
+
+    Tile current = tile;
+    UINT level = LevelForResolution(current.size);
+
+    // Merge with the three siblings while they are all free
+    while (level > 0) {
+        UINT parentSize = current.size * 2;
+        UINT parentX = current.x - current.x % parentSize;
+        UINT parentY = current.y - current.y % parentSize;
+
+        std::vector<Tile>& freeList = m_freeTiles[level];
+        size_t siblings = 0;
+        for (const Tile& free : freeList) {
+            if (free.x - free.x % parentSize == parentX && free.y - free.y % parentSize == parentY) {
+                siblings++;
+            }
+        }
+        if (siblings < 3) {
+            break;
+        }
+
+        freeList.erase(std::remove_if(freeList.begin(), freeList.end(), [&](const Tile& free) {
+            return free.x - free.x % parentSize == parentX && free.y - free.y % parentSize == parentY;
+        }), freeList.end());
+
+        current = Tile{ parentX, parentY, parentSize };
+        level--;
+    }
+
+    m_freeTiles[level].push_back(current);
+}
+
+bool ShadowAtlas::EvictLeastRecent() {
+    // Only lights not requested this frame may lose their tile
+    auto oldest = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->second.lastRequested == m_frame) {
+            continue;
+        }
+        if (oldest == m_entries.end() || it->second.lastRequested < oldest->second.lastRequested) {
+            oldest = it;
+        }
+    }
+
+    if (oldest == m_entries.end()) {
+        return false;
+    }
+
+    FreeTile(oldest->second.tile);
+    m_entries.erase(oldest);
+    m_stats.tilesEvicted++;
+    return true;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
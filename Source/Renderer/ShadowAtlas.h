@@ -0,0 +1,132 @@
+#pragma once
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer {
+
+class Light;
+
+using Microsoft::WRL::ComPtr;
+
+// One depth texture shared by every spot and directional shadow. Each light
+// gets a square power-of-two tile from a quadtree allocator, sized by the
+// resolution it asks for. Tiles persist across frames and are only redrawn
+// when the light changes or something moves inside its volume, so static
+// lights over static geometry cost nothing after their first frame.
+//
+// Frame lifecycle: D3D11Renderer::UpdateLightBuffer calls BeginFrame and
+// Request per visible shadowed light and writes each light's shadow matrix
+// and tile into its LightData. The scene's Shadows pass then Invalidates
+// moved bounds and Renders the dirty tiles before any lit pass, and the
+// lighting shaders sample the atlas through Bind / BindCompute.
+class ShadowAtlas {
+public:
+    using RenderCallback = std::function<void(const DirectX::XMMATRIX&, const DirectX::XMMATRIX&)>;
+
+    // Lighting shaders read the atlas here, after the material textures and
+    // clustered light buffers, with a comparison sampler
+    static constexpr UINT TEXTURE_SLOT = 7;
+    static constexpr UINT SAMPLER_SLOT = 1;
+
+    struct Tile {
+        UINT x = 0;
+        UINT y = 0;
+        UINT size = 0;
+    };
+
+    struct Stats {
+        UINT tilesRequested = 0;
+        UINT tilesRendered = 0;     // Redrawn this frame
+        UINT tilesCached = 0;       // Reused without drawing
+        UINT tilesEvicted = 0;      // Freed to make room
+    };
+
+    ShadowAtlas();
+    ~ShadowAtlas() = default;
+
+    bool Initialize(ID3D11Device* device, UINT size = 4096, UINT minTileSize = 128);
+
+    // Start a frame; tiles not requested since are first in line for eviction
+    void BeginFrame();
+
+    // Reserve (or keep) a tile for light this frame. resolution of 0 uses the
+    // light's shadow map size; it is rounded down to a power of two and halved
+    // until it fits. Point lights need six faces and stay on CubeShadowMap.
+    bool Request(const Light* light, UINT resolution = 0);
+
+    // Mark every cached light whose volume touches bounds for redraw
+    void Invalidate(const DirectX::BoundingBox& bounds);
+    void InvalidateAll();
+
+    // Drop a light's tile, e.g. when the light is destroyed
+    void Release(const Light* light);
+
+    // Redraw the dirty tiles requested this frame through renderCallback; the
+    // callback draws shadow casters with the given light view and projection
+    // and must keep the viewport, which is set to the light's tile. Rebinds
+    // the atlas to the pixel shader afterwards.
+    void Render(ID3D11DeviceContext* context, const RenderCallback& renderCallback);
+
+    // Light view-projection followed by the NDC to atlas UV mapping of its
+    // tile. Both fail until the tile has been drawn once, so a light is never
+    // shaded from a tile that holds nothing yet.
+    bool GetShadowMatrix(const Light* light, DirectX::XMMATRIX& shadowMatrix) const;
+    bool GetTile(const Light* light, Tile& tile) const;
+
+    // Atlas and comparison sampler at TEXTURE_SLOT / SAMPLER_SLOT
+    void Bind(ID3D11DeviceContext* context) const;
+    void BindCompute(ID3D11DeviceContext* context) const;
+
+    ID3D11ShaderResourceView* GetShaderResourceView() const { return m_shaderResourceView.Get(); }
+    UINT GetSize() const { return m_size; }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry {
+        Tile tile;
+        DirectX::XMFLOAT4X4 view;
+        DirectX::XMFLOAT4X4 projection;
+        DirectX::XMFLOAT4X4 viewProjection;     // Light volume for invalidation
+        std::uint64_t lastRequested = 0;
+        bool dirty = true;
+        bool drawn = false;     // The tile holds this light's depth
+    };
+
+    // Quadtree allocation: tiles of one level are atlas size >> level
+    bool AllocateTile(UINT level, Tile& tile);
+    void FreeTile(const Tile& tile);
+    bool EvictLeastRecent();
+    UINT LevelForResolution(UINT resolution) const;
+
+    bool CreateClearResources(ID3D11Device* device);
+    void ClearTile(ID3D11DeviceContext* context, const Tile& tile);
+
+    ComPtr<ID3D11Texture2D> m_texture;
+    ComPtr<ID3D11DepthStencilView> m_depthStencilView;
+    ComPtr<ID3D11ShaderResourceView> m_shaderResourceView;
+    ComPtr<ID3D11SamplerState> m_comparisonSampler;
+
+    // Depth-only full-viewport triangle that resets one tile to the far plane
+    ComPtr<ID3D11VertexShader> m_clearShader;
+    ComPtr<ID3D11DepthStencilState> m_clearDepthState;
+    ComPtr<ID3D11RasterizerState> m_rasterizerState;
+
+    UINT m_size;
+    UINT m_levelCount;
+    std::vector<std::vector<Tile>> m_freeTiles; // Per level
+
+    std::unordered_map<const Light*, Entry> m_entries;
+    std::uint64_t m_frame;
+    Stats m_stats;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -1,10 +1,37 @@
 #include "ShadowMap.h"
+#include "GpuMemory.h"
 #include "Light.h"
+#include "GpuProfiler.h"
 #include "../Core/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace GameEngine {
 namespace Renderer {
 
+ShadowFilter ParseShadowFilter(const std::string& name) {
+    if (name == "None") {
+        return ShadowFilter::None;
+    }
+    if (name == "PCSS") {
+        return ShadowFilter::PCSS;
+    }
+    if (name == "VSM") {
+        return ShadowFilter::VSM;
+    }
+    return ShadowFilter::PCF;
+}
+
+const char* GetShadowFilterName(ShadowFilter filter) {
+    switch (filter) {
+    case ShadowFilter::None: return "None";
+    case ShadowFilter::PCSS: return "PCSS";
+    case ShadowFilter::VSM: return "VSM";
+    default: return "PCF";
+    }
+}
+
 // Base ShadowMap implementation
 ShadowMap::ShadowMap(ID3D11Device* device, ShadowMapType type, int width, int height)
     : m_type(type)
@@ -48,6 +75,7 @@ bool ShadowMap::CreateShadowMap(ID3D11Device* device) {
         LOG_ERROR("Failed to create shadow map texture");
         return false;
     }
+    TrackGpuMemory(m_shadowTexture.Get(), Core::MemoryCategory::Renderer);
 
     // Create depth stencil view
     D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
@@ -78,6 +106,78 @@ bool ShadowMap::CreateShadowMap(ID3D11Device* device) {
     return true;
 }
 
+bool ShadowMap::CreateMoments(ID3D11Device* device) {
+    ID3D11Texture2D* depthTexture = GetDepthTexture();
+    if (!device || !depthTexture) {
+        return false;
+    }
+
+    UINT sliceCount = static_cast<UINT>(GetSliceCount());
+    UINT mipCount = 1;
+    while ((static_cast<UINT>(std::max(m_width, m_height)) >> mipCount) > 0) {
+        mipCount++;
+    }
+
+    // The blur reads every kind of map as an array of depth slices
+    D3D11_SHADER_RESOURCE_VIEW_DESC depthDesc = {};
+    depthDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+    depthDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    depthDesc.Texture2DArray.MipLevels = 1;
+    depthDesc.Texture2DArray.ArraySize = sliceCount;
+
+    // Mips are generated, which needs the render target binding
+    D3D11_TEXTURE2D_DESC momentsDesc = {};
+    momentsDesc.Width = m_width;
+    momentsDesc.Height = m_height;
+    momentsDesc.MipLevels = mipCount;
+    momentsDesc.ArraySize = sliceCount;
+    momentsDesc.Format = DXGI_FORMAT_R32G32_FLOAT;
+    momentsDesc.SampleDesc.Count = 1;
+    momentsDesc.Usage = D3D11_USAGE_DEFAULT;
+    momentsDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_RENDER_TARGET;
+    momentsDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+    if (m_type == ShadowMapType::Cube) {
+        momentsDesc.MiscFlags |= D3D11_RESOURCE_MISC_TEXTURECUBE;
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.Format = DXGI_FORMAT_R32G32_FLOAT;
+    uavDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2DARRAY;
+    uavDesc.Texture2DArray.ArraySize = sliceCount;
+
+    // Sampled the same way as the depth it replaces
+    D3D11_SHADER_RESOURCE_VIEW_DESC momentsViewDesc = {};
+    momentsViewDesc.Format = DXGI_FORMAT_R32G32_FLOAT;
+    if (m_type == ShadowMapType::Cube) {
+        momentsViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+        momentsViewDesc.TextureCube.MipLevels = mipCount;
+    } else if (sliceCount > 1) {
+        momentsViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        momentsViewDesc.Texture2DArray.MipLevels = mipCount;
+        momentsViewDesc.Texture2DArray.ArraySize = sliceCount;
+    } else {
+        momentsViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        momentsViewDesc.Texture2D.MipLevels = mipCount;
+    }
+
+    if (FAILED(device->CreateShaderResourceView(depthTexture, &depthDesc, &m_depthArrayView)) ||
+        FAILED(device->CreateTexture2D(&momentsDesc, nullptr, &m_momentsTexture)) ||
+        FAILED(device->CreateUnorderedAccessView(m_momentsTexture.Get(), &uavDesc, &m_momentsUAV)) ||
+        FAILED(device->CreateShaderResourceView(m_momentsTexture.Get(), &momentsViewDesc, &m_momentsView))) {
+        LOG_ERROR("Failed to create " << m_width << "x" << m_height << " shadow moments");
+        m_depthArrayView.Reset();
+        m_momentsTexture.Reset();
+        m_momentsUAV.Reset();
+        m_momentsView.Reset();
+        return false;
+    }
+    TrackGpuMemory(m_momentsTexture.Get(), Core::MemoryCategory::Renderer);
+
+    LOG_DEBUG("Shadow moments created (" << m_width << "x" << m_height << ", " << sliceCount
+              << " slices, " << mipCount << " mips)");
+    return true;
+}
+
 void ShadowMap::Clear(ID3D11DeviceContext* context, float clearValue) {
     context->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, clearValue, 0);
 }
@@ -89,6 +189,10 @@ void ShadowMap::BindForRendering(ID3D11DeviceContext* context) {
 }
 
 void ShadowMap::BindForSampling(ID3D11DeviceContext* context, UINT slot) {
+    if (m_filter == ShadowFilter::VSM && m_momentsView) {
+        context->PSSetShaderResources(slot, 1, m_momentsView.GetAddressOf());
+        return;
+    }
     context->PSSetShaderResources(slot, 1, m_shaderResourceView.GetAddressOf());
 }
 
@@ -102,7 +206,14 @@ ShadowMap2D::ShadowMap2D(ID3D11Device* device, int width, int height)
 CascadeShadowMap::CascadeShadowMap(ID3D11Device* device, int cascadeCount, int width, int height)
     : ShadowMap(device, ShadowMapType::Cascade, width, height)
     , m_cascadeCount(cascadeCount)
+    , m_frame(0)
 {
+    for (int i = 0; i < m_cascadeCount; i++) {
+        m_updateIntervals.push_back(i < 2 ? 1 : 1 << (i - 1));
+    }
+    m_renderedCascades.resize(m_cascadeCount);
+    m_cascadeValid.assign(m_cascadeCount, false);
+
     CreateCascadeShadowMap(device);
 }
 
@@ -128,6 +239,7 @@ bool CascadeShadowMap::CreateCascadeShadowMap(ID3D11Device* device) {
         LOG_ERROR("Failed to create cascade shadow map texture");
         return false;
     }
+    TrackGpuMemory(m_cascadeTexture.Get(), Core::MemoryCategory::Renderer);
 
     // Create depth stencil views for each cascade
     m_cascadeDepthStencilViews.resize(m_cascadeCount);
@@ -181,6 +293,45 @@ void CascadeShadowMap::BindCascadeForRendering(ID3D11DeviceContext* context, int
     }
 }
 
+int CascadeShadowMap::GetUpdateInterval(int cascade) const {
+    if (cascade >= 0 && cascade < m_cascadeCount) {
+        return m_updateIntervals[cascade];
+    }
+    return 1;
+}
+
+void CascadeShadowMap::SetUpdateInterval(int cascade, int interval) {
+    if (cascade >= 0 && cascade < m_cascadeCount) {
+        m_updateIntervals[cascade] = std::max(interval, 1);
+    }
+}
+
+bool CascadeShadowMap::NeedsUpdate(int cascade) const {
+    if (cascade < 0 || cascade >= m_cascadeCount) {
+        return false;
+    }
+    if (!m_cascadeValid[cascade]) {
+        return true;
+    }
+
+    std::uint64_t interval = static_cast<std::uint64_t>(m_updateIntervals[cascade]);
+    return (m_frame + cascade) % interval == 0;
+}
+
+const DirectionalLight::ShadowCascade* CascadeShadowMap::GetRenderedCascade(int cascade) const {
+    if (cascade >= 0 && cascade < m_cascadeCount && m_cascadeValid[cascade]) {
+        return &m_renderedCascades[cascade];
+    }
+    return nullptr;
+}
+
+void CascadeShadowMap::SetRenderedCascade(int cascade, const DirectionalLight::ShadowCascade& rendered) {
+    if (cascade >= 0 && cascade < m_cascadeCount) {
+        m_renderedCascades[cascade] = rendered;
+        m_cascadeValid[cascade] = true;
+    }
+}
+
 // CubeShadowMap implementation
 CubeShadowMap::CubeShadowMap(ID3D11Device* device, int size)
     : ShadowMap(device, ShadowMapType::Cube, size, size)
@@ -210,6 +361,7 @@ bool CubeShadowMap::CreateCubeShadowMap(ID3D11Device* device) {
         LOG_ERROR("Failed to create cube shadow map texture");
         return false;
     }
+    TrackGpuMemory(m_cubeTexture.Get(), Core::MemoryCategory::Renderer);
 
     // Create depth stencil views for each face
     m_faceDepthStencilViews.resize(6);
@@ -265,6 +417,13 @@ ShadowMapManager::ShadowMapManager(ID3D11Device* device)
     : m_device(device)
     , m_shadowBias(0.001f)
     , m_shadowNormalBias(0.1f)
+    , m_shadowMapsRendered(0)
+    , m_filter(ShadowFilter::PCF)
+    , m_momentsSampler(nullptr)
+    , m_transientTextures(nullptr)
+    , m_blurRadius(2)
+    , m_momentsExponent(0.0f)
+    , m_momentMapsFiltered(0)
 {
     LOG_INFO("ShadowMapManager initialized");
 }
@@ -276,26 +435,47 @@ ShadowMapManager::~ShadowMapManager() {
 
 std::shared_ptr<ShadowMap2D> ShadowMapManager::CreateShadowMap2D(int width, int height) {
     auto shadowMap = std::make_shared<ShadowMap2D>(m_device, width, height);
+    shadowMap->SetFilter(m_filter);
     m_shadowMaps.push_back(shadowMap);
     return shadowMap;
 }
 
 std::shared_ptr<CascadeShadowMap> ShadowMapManager::CreateCascadeShadowMap(int cascadeCount, int width, int height) {
     auto shadowMap = std::make_shared<CascadeShadowMap>(m_device, cascadeCount, width, height);
+    shadowMap->SetFilter(m_filter);
     m_shadowMaps.push_back(shadowMap);
     return shadowMap;
 }
 
 std::shared_ptr<CubeShadowMap> ShadowMapManager::CreateCubeShadowMap(int size) {
     auto shadowMap = std::make_shared<CubeShadowMap>(m_device, size);
+    shadowMap->SetFilter(m_filter);
     m_shadowMaps.push_back(shadowMap);
     return shadowMap;
 }
 
+void ShadowMapManager::SetFilter(ShadowFilter filter) {
+    m_filter = filter;
+    for (const auto& shadowMap : m_shadowMaps) {
+        shadowMap->SetFilter(filter);
+    }
+}
+
+void ShadowMapManager::SetBlurRadius(int radius) {
+    m_blurRadius = std::clamp(radius, 0, MAX_BLUR_RADIUS);
+}
+
+void ShadowMapManager::SetMomentsExponent(float exponent) {
+    m_momentsExponent = std::clamp(exponent, 0.0f, 40.0f);
+}
+
 void ShadowMapManager::RenderShadowMap(ID3D11DeviceContext* context, Light* light, ShadowMap* shadowMap,
                                       const std::function<void(const DirectX::XMMATRIX&, const DirectX::XMMATRIX&)>& renderCallback) {
     if (!light || !shadowMap || !renderCallback) return;
 
+    PROFILE_SCOPE("Shadow");
+    GPU_PROFILE_SCOPE(context, "Shadow");
+
     // Save current render state
     SetShadowRenderState(context);
 
@@ -311,41 +491,55 @@ void ShadowMapManager::RenderShadowMap(ID3D11DeviceContext* context, Light* ligh
 
     // Render shadow casters
     renderCallback(viewMatrix, projectionMatrix);
+    m_shadowMapsRendered++;
 
     // Restore render state
     RestoreRenderState(context);
+    FilterMoments(context, shadowMap, 0, 1);
 }
 
 void ShadowMapManager::RenderDirectionalShadow(ID3D11DeviceContext* context, DirectionalLight* light,
                                               CascadeShadowMap* shadowMap, const DirectX::XMMATRIX& cameraView,
                                               const DirectX::XMMATRIX& cameraProjection,
-                                              const std::function<void(const DirectX::XMMATRIX&, const DirectX::XMMATRIX&)>& renderCallback) {
+                                              const std::function<void(const DirectionalLight::ShadowCascade&)>& renderCallback) {
     if (!light || !shadowMap || !renderCallback) return;
 
     // Save current render state
     SetShadowRenderState(context);
 
-    // Get cascade view-projection matrices
-    auto cascadeMatrices = light->GetCascadeViewProjectionMatrices(cameraView, cameraProjection);
+    // Fit this frame's cascades at the resolution they are drawn at
+    auto cascades = light->GetCascades(cameraView, cameraProjection, shadowMap->GetWidth());
+    shadowMap->BeginFrame();
+
+    // Render each cascade that is due
+    int firstUpdated = shadowMap->GetCascadeCount();
+    int lastUpdated = -1;
+    for (int i = 0; i < shadowMap->GetCascadeCount() && i < static_cast<int>(cascades.size()); i++) {
+        if (!shadowMap->NeedsUpdate(i)) {
+            continue;
+        }
+        firstUpdated = std::min(firstUpdated, i);
+        lastUpdated = i;
 
-    // Render each cascade
-    for (int i = 0; i < shadowMap->GetCascadeCount() && i < static_cast<int>(cascadeMatrices.size()); i++) {
         // Clear cascade
         context->ClearDepthStencilView(shadowMap->GetCascadeDepthStencilView(i), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
         // Bind cascade for rendering
         shadowMap->BindCascadeForRendering(context, i);
 
-        // Extract view and projection from combined matrix (simplified)
-        DirectX::XMMATRIX viewMatrix = light->GetViewMatrix();
-        DirectX::XMMATRIX projMatrix = light->GetProjectionMatrix();
-
-        // Render shadow casters for this cascade
-        renderCallback(viewMatrix, projMatrix);
+        // Render shadow casters for this cascade; the callback culls to its bounds
+        renderCallback(cascades[i]);
+        shadowMap->SetRenderedCascade(i, cascades[i]);
+        m_shadowMapsRendered++;
     }
 
     // Restore render state
     RestoreRenderState(context);
+
+    // Cascades in between that were skipped still hold their depth
+    if (lastUpdated >= firstUpdated) {
+        FilterMoments(context, shadowMap, firstUpdated, lastUpdated - firstUpdated + 1);
+    }
 }
 
 void ShadowMapManager::RenderPointShadow(ID3D11DeviceContext* context, PointLight* light, CubeShadowMap* shadowMap,
@@ -371,10 +565,12 @@ void ShadowMapManager::RenderPointShadow(ID3D11DeviceContext* context, PointLigh
 
         // Render shadow casters for this face
         renderCallback(viewMatrices[face], projectionMatrix);
+        m_shadowMapsRendered++;
     }
 
     // Restore render state
     RestoreRenderState(context);
+    FilterMoments(context, shadowMap, 0, 6);
 }
 
 void ShadowMapManager::RenderSpotShadow(ID3D11DeviceContext* context, SpotLight* light, ShadowMap2D* shadowMap,
@@ -396,9 +592,110 @@ void ShadowMapManager::RenderSpotShadow(ID3D11DeviceContext* context, SpotLight*
 
     // Render shadow casters
     renderCallback(viewMatrix, projectionMatrix);
+    m_shadowMapsRendered++;
 
     // Restore render state
     RestoreRenderState(context);
+    FilterMoments(context, shadowMap, 0, 1);
+}
+
+void ShadowMapManager::FilterMoments(ID3D11DeviceContext* context, ShadowMap* shadowMap, int firstSlice, int sliceCount) {
+    if (shadowMap->GetFilter() != ShadowFilter::VSM || !m_blurShader || !m_transientTextures || sliceCount <= 0) {
+        return;
+    }
+    if (!shadowMap->HasMoments() && !shadowMap->CreateMoments(m_device)) {
+        // Sampled as plain depth from now on
+        shadowMap->SetFilter(ShadowFilter::PCF);
+        return;
+    }
+    if (!m_blurParamsBuffer) {
+        D3D11_BUFFER_DESC bufferDesc = {};
+        bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+        bufferDesc.ByteWidth = sizeof(BlurParams);
+        bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        if (FAILED(m_device->CreateBuffer(&bufferDesc, nullptr, &m_blurParamsBuffer))) {
+            LOG_ERROR("Failed to create shadow blur parameter buffer");
+            m_blurShader.Reset();
+            return;
+        }
+        TrackGpuMemory(m_blurParamsBuffer.Get(), Core::MemoryCategory::Renderer);
+    }
+
+    // Only needed between the two passes, so maps of one size share it
+    TransientTextureDesc blurDesc;
+    blurDesc.width = static_cast<UINT>(shadowMap->GetWidth());
+    blurDesc.height = static_cast<UINT>(shadowMap->GetHeight());
+    blurDesc.arraySize = static_cast<UINT>(shadowMap->GetSliceCount());
+    blurDesc.format = DXGI_FORMAT_R32G32_FLOAT;
+    blurDesc.bindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+    blurDesc.arrayViews = true;
+    TransientTexture* blurTexture = m_transientTextures->Acquire(blurDesc);
+    if (!blurTexture) {
+        return;
+    }
+
+    GPU_PROFILE_SCOPE(context, "ShadowBlur");
+
+    // Normalized Gaussian; sigma of half the radius keeps the tails small
+    BlurParams params = {};
+    params.size[0] = static_cast<std::uint32_t>(shadowMap->GetWidth());
+    params.size[1] = static_cast<std::uint32_t>(shadowMap->GetHeight());
+    params.firstSlice = static_cast<std::uint32_t>(firstSlice);
+    params.exponent = m_momentsExponent;
+    params.radius = static_cast<std::uint32_t>(m_blurRadius);
+    float sigma = std::max(0.5f * m_blurRadius, 0.5f);
+    float total = 0.0f;
+    for (int i = 0; i <= m_blurRadius; i++) {
+        params.weights[i] = std::exp(-0.5f * (i * i) / (sigma * sigma));
+        total += i == 0 ? params.weights[i] : 2.0f * params.weights[i];
+    }
+    for (int i = 0; i <= m_blurRadius; i++) {
+        params.weights[i] /= total;
+    }
+
+    // Rows from depth into the blur texture, then columns into the moments
+    struct Pass {
+        ID3D11ShaderResourceView* source;
+        UINT sourceSlot;
+        ID3D11UnorderedAccessView* dest;
+        UINT lineLength;
+        UINT lineCount;
+    };
+    const Pass passes[2] = {
+        { shadowMap->m_depthArrayView.Get(), 0, blurTexture->unorderedAccessView.Get(), params.size[0], params.size[1] },
+        { blurTexture->shaderResourceView.Get(), 1, shadowMap->m_momentsUAV.Get(), params.size[1], params.size[0] }
+    };
+
+    ID3D11ShaderResourceView* nullView = nullptr;
+    ID3D11UnorderedAccessView* nullUAV = nullptr;
+    context->CSSetShader(m_blurShader.Get(), nullptr, 0);
+    context->CSSetConstantBuffers(0, 1, m_blurParamsBuffer.GetAddressOf());
+
+    for (std::uint32_t i = 0; i < 2; i++) {
+        const Pass& pass = passes[i];
+        params.vertical = i;
+
+        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        if (FAILED(context->Map(m_blurParamsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+            break;
+        }
+        std::memcpy(mappedResource.pData, &params, sizeof(BlurParams));
+        context->Unmap(m_blurParamsBuffer.Get(), 0);
+
+        context->CSSetShaderResources(pass.sourceSlot, 1, &pass.source);
+        context->CSSetUnorderedAccessViews(0, 1, &pass.dest, nullptr);
+        context->Dispatch((pass.lineLength + BLUR_GROUP_SIZE - 1) / BLUR_GROUP_SIZE, pass.lineCount,
+                          static_cast<UINT>(sliceCount));
+        context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+        context->CSSetShaderResources(pass.sourceSlot, 1, &nullView);
+    }
+    context->CSSetShader(nullptr, nullptr, 0);
+    m_transientTextures->Release(blurTexture);
+
+    // Filtered mips let distant receivers take one tap without aliasing
+    context->GenerateMips(shadowMap->m_momentsView.Get());
+    m_momentMapsFiltered++;
 }
 
 void ShadowMapManager::SetShadowRenderState(ID3D11DeviceContext* context) {
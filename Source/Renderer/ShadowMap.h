@@ -6,18 +6,16 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <cstdint>
+#include <string>
+#include "Light.h"
+#include "TransientTexturePool.h"
 
 using Microsoft::WRL::ComPtr;
 
 namespace GameEngine {
 namespace Renderer {
 
-// Forward declarations
-class Light;
-class DirectionalLight;
-class PointLight;
-class SpotLight;
-
 // Shadow map types
 enum class ShadowMapType {
     Simple2D,           // Basic 2D shadow map
@@ -34,6 +32,10 @@ enum class ShadowFilter {
     VSM                 // Variance Shadow Maps
 };
 
+// PCF for names it does not know
+ShadowFilter ParseShadowFilter(const std::string& name);
+const char* GetShadowFilterName(ShadowFilter filter);
+
 // Base shadow map class
 class ShadowMap {
 public:
@@ -52,6 +54,17 @@ public:
     ID3D11DepthStencilView* GetDepthStencilView() const { return m_depthStencilView.Get(); }
     ID3D11ShaderResourceView* GetShaderResourceView() const { return m_shaderResourceView.Get(); }
 
+    // Depth slices: 1, one per cascade or one per cube face
+    virtual int GetSliceCount() const { return 1; }
+
+    // VSM moments (depth, depth^2), or the exponentially warped pair when the
+    // manager's exponent is set. R32G32 with a full mip chain, blurred and
+    // mipmapped after every render, so one trilinear or anisotropic tap and a
+    // Chebyshev bound give a soft shadow at the same cost for any blur size.
+    // Viewed like the depth: Texture2D, Texture2DArray or TextureCube.
+    ID3D11ShaderResourceView* GetMomentsView() const { return m_momentsView.Get(); }
+    bool HasMoments() const { return m_momentsView != nullptr; }
+
     // Viewport
     const D3D11_VIEWPORT& GetViewport() const { return m_viewport; }
 
@@ -60,10 +73,15 @@ public:
 
     // Bind for rendering
     void BindForRendering(ID3D11DeviceContext* context);
+    // Binds the moments for VSM once they exist, the depth otherwise
     void BindForSampling(ID3D11DeviceContext* context, UINT slot);
 
 protected:
+    friend class ShadowMapManager;
+
     bool CreateShadowMap(ID3D11Device* device);
+    bool CreateMoments(ID3D11Device* device);
+    virtual ID3D11Texture2D* GetDepthTexture() const { return m_shadowTexture.Get(); }
 
     ShadowMapType m_type;
     ShadowFilter m_filter;
@@ -74,6 +92,13 @@ protected:
     ComPtr<ID3D11DepthStencilView> m_depthStencilView;
     ComPtr<ID3D11ShaderResourceView> m_shaderResourceView;
     D3D11_VIEWPORT m_viewport;
+
+    // VSM: the depth is converted and blurred across rows into a transient
+    // texture, then blurred down columns into mip 0 of the moments
+    ComPtr<ID3D11ShaderResourceView> m_depthArrayView;
+    ComPtr<ID3D11Texture2D> m_momentsTexture;
+    ComPtr<ID3D11ShaderResourceView> m_momentsView;
+    ComPtr<ID3D11UnorderedAccessView> m_momentsUAV;
 };
 
 // Simple 2D shadow map (for directional and spot lights)
@@ -90,6 +115,7 @@ public:
     virtual ~CascadeShadowMap() = default;
 
     int GetCascadeCount() const { return m_cascadeCount; }
+    int GetSliceCount() const override { return m_cascadeCount; }
 
     // Get depth stencil view for specific cascade
     ID3D11DepthStencilView* GetCascadeDepthStencilView(int cascade) const;
@@ -100,10 +126,32 @@ public:
     // Bind specific cascade for rendering
     void BindCascadeForRendering(ID3D11DeviceContext* context, int cascade);
 
+    // Redraw a cascade every interval frames. Far cascades cover more world
+    // per texel and tolerate lag; defaults are 1, 1, 2, 4, ...
+    int GetUpdateInterval(int cascade) const;
+    void SetUpdateInterval(int cascade, int interval);
+
+    // Advance the update schedule; call once per shadow pass
+    void BeginFrame() { m_frame++; }
+
+    // Staggered so cascades sharing an interval do not redraw together
+    bool NeedsUpdate(int cascade) const;
+
+    // Cascade as last rendered; sample with these, not this frame's fit
+    const DirectionalLight::ShadowCascade* GetRenderedCascade(int cascade) const;
+    void SetRenderedCascade(int cascade, const DirectionalLight::ShadowCascade& rendered);
+
+protected:
+    ID3D11Texture2D* GetDepthTexture() const override { return m_cascadeTexture.Get(); }
+
 private:
     bool CreateCascadeShadowMap(ID3D11Device* device);
 
     int m_cascadeCount;
+    std::vector<int> m_updateIntervals;
+    std::vector<DirectionalLight::ShadowCascade> m_renderedCascades;
+    std::vector<bool> m_cascadeValid;
+    std::uint64_t m_frame;
     ComPtr<ID3D11Texture2D> m_cascadeTexture;
     std::vector<ComPtr<ID3D11DepthStencilView>> m_cascadeDepthStencilViews;
     ComPtr<ID3D11ShaderResourceView> m_cascadeArraySRV;
@@ -115,6 +163,8 @@ public:
     CubeShadowMap(ID3D11Device* device, int size = 512);
     virtual ~CubeShadowMap() = default;
 
+    int GetSliceCount() const override { return 6; }
+
     // Get depth stencil view for specific face
     ID3D11DepthStencilView* GetFaceDepthStencilView(int face) const;
 
@@ -124,6 +174,9 @@ public:
     // Bind specific face for rendering
     void BindFaceForRendering(ID3D11DeviceContext* context, int face);
 
+protected:
+    ID3D11Texture2D* GetDepthTexture() const override { return m_cubeTexture.Get(); }
+
 private:
     bool CreateCubeShadowMap(ID3D11Device* device);
 
@@ -147,10 +200,12 @@ public:
     void RenderShadowMap(ID3D11DeviceContext* context, Light* light, ShadowMap* shadowMap,
                         const std::function<void(const DirectX::XMMATRIX&, const DirectX::XMMATRIX&)>& renderCallback);
 
+    // Fits stable PSSM cascades to the camera and redraws those that are due.
+    // The callback receives each cascade so it can cull casters to its bounds.
     void RenderDirectionalShadow(ID3D11DeviceContext* context, DirectionalLight* light,
                                 CascadeShadowMap* shadowMap, const DirectX::XMMATRIX& cameraView,
                                 const DirectX::XMMATRIX& cameraProjection,
-                                const std::function<void(const DirectX::XMMATRIX&, const DirectX::XMMATRIX&)>& renderCallback);
+                                const std::function<void(const DirectionalLight::ShadowCascade&)>& renderCallback);
 
     void RenderPointShadow(ID3D11DeviceContext* context, PointLight* light, CubeShadowMap* shadowMap,
                           const std::function<void(const DirectX::XMMATRIX&, const DirectX::XMMATRIX&)>& renderCallback);
@@ -165,8 +220,35 @@ public:
     void SetShadowNormalBias(float bias) { m_shadowNormalBias = bias; }
     float GetShadowNormalBias() const { return m_shadowNormalBias; }
 
-    // Statistics
+    // Filter for every managed map and the maps created after
+    void SetFilter(ShadowFilter filter);
+    ShadowFilter GetFilter() const { return m_filter; }
+
+    // VSM filtering (ShadowBlurComputeShader). Without the shader VSM maps
+    // keep plain depth and are sampled as such.
+    void SetBlurShader(ComPtr<ID3D11ComputeShader> shader) { m_blurShader = shader; }
+    // Trilinear, anisotropic clamp sampler for the moments
+    void SetMomentsSampler(ID3D11SamplerState* sampler) { m_momentsSampler = sampler; }
+    ID3D11SamplerState* GetMomentsSampler() const { return m_momentsSampler; }
+    // Source of the blur's intermediate texture, shared by maps of one size;
+    // without it VSM maps keep plain depth
+    void SetTransientTextures(TransientTexturePool* pool) { m_transientTextures = pool; }
+
+    // Gaussian blur radius in texels, 0 to 8. The blur is two
+    // one-dimensional passes, so it costs 4 * radius + 2 taps per texel.
+    void SetBlurRadius(int radius);
+    int GetBlurRadius() const { return m_blurRadius; }
+
+    // Exponential warp for EVSM, 0 for plain VSM. Larger values reduce light
+    // bleeding where occluders overlap; fp32 moments overflow above 40.
+    void SetMomentsExponent(float exponent);
+    float GetMomentsExponent() const { return m_momentsExponent; }
+
+    // Statistics; cascades and cube faces count as one map each
     size_t GetShadowMapCount() const { return m_shadowMaps.size(); }
+    UINT GetShadowMapsRendered() const { return m_shadowMapsRendered; }
+    UINT GetMomentMapsFiltered() const { return m_momentMapsFiltered; }
+    void ResetStats() { m_shadowMapsRendered = 0; m_momentMapsFiltered = 0; }
 
 private:
     ID3D11Device* m_device;
@@ -175,11 +257,39 @@ private:
     // Shadow settings
     float m_shadowBias;
     float m_shadowNormalBias;
+    UINT m_shadowMapsRendered;
+
+    static constexpr int MAX_BLUR_RADIUS = 8;
+    static constexpr UINT BLUR_GROUP_SIZE = 128;
+
+    // Matches BlurParams in ShadowBlurComputeShader.hlsl
+    struct BlurParams {
+        std::uint32_t size[2];
+        std::uint32_t firstSlice;
+        std::uint32_t vertical;
+        float exponent;
+        std::uint32_t radius;
+        float padding[2];
+        float weights[12];          // Center first; MAX_BLUR_RADIUS + 1 used
+    };
+
+    ShadowFilter m_filter;
+    ComPtr<ID3D11ComputeShader> m_blurShader;
+    ComPtr<ID3D11Buffer> m_blurParamsBuffer;
+    ID3D11SamplerState* m_momentsSampler;
+    TransientTexturePool* m_transientTextures;
+    int m_blurRadius;
+    float m_momentsExponent;
+    UINT m_momentMapsFiltered;
 
     // Helper methods
     void SetShadowRenderState(ID3D11DeviceContext* context);
     void RestoreRenderState(ID3D11DeviceContext* context);
 
+    // Rebuilds the moments of slices [firstSlice, firstSlice + sliceCount)
+    // from depth; no-op unless the map uses VSM. Depth must not be bound.
+    void FilterMoments(ID3D11DeviceContext* context, ShadowMap* shadowMap, int firstSlice, int sliceCount);
+
     // Saved render state
     ComPtr<ID3D11RenderTargetView> m_savedRenderTarget;
     ComPtr<ID3D11DepthStencilView> m_savedDepthStencil;
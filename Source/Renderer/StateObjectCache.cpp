@@ -0,0 +1,85 @@
+#include "StateObjectCache.h"
+#include "../Core/Logger.h"
+
+namespace GameEngine {
+namespace Renderer {
+
+void StateObjectCache::Initialize(ID3D11Device* device) {
+    Clear();
+    m_device = device;
+}
+
+void StateObjectCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rasterizerStates.clear();
+    m_blendStates.clear();
+    m_depthStencilStates.clear();
+    m_samplerStates.clear();
+    m_stats = StateObjectStats();
+    m_device = nullptr;
+}
+
+template<typename Desc, typename State, typename Create>
+State* StateObjectCache::Find(StateMap<Desc, State>& states, const Desc& desc, Create create) {
+    DescKey<Desc> key;
+    std::memcpy(&key.desc, &desc, sizeof(Desc));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = states.find(key);
+    if (it != states.end()) {
+        m_stats.reused++;
+        return it->second.Get();
+    }
+
+    if (!m_device) {
+        return nullptr;
+    }
+
+    ComPtr<State> state;
+    if (FAILED(create(desc, state.GetAddressOf()))) {
+        LOG_ERROR("Failed to create state object");
+        return nullptr;
+    }
+
+    m_stats.created++;
+    State* result = state.Get();
+    states.emplace(key, state);
+    return result;
+}
+
+ID3D11RasterizerState* StateObjectCache::GetRasterizerState(const D3D11_RASTERIZER_DESC& desc) {
+    return Find(m_rasterizerStates, desc, [this](const D3D11_RASTERIZER_DESC& d, ID3D11RasterizerState** state) {
+        return m_device->CreateRasterizerState(&d, state);
+    });
+}
+
+ID3D11BlendState* StateObjectCache::GetBlendState(const D3D11_BLEND_DESC& desc) {
+    return Find(m_blendStates, desc, [this](const D3D11_BLEND_DESC& d, ID3D11BlendState** state) {
+        return m_device->CreateBlendState(&d, state);
+    });
+}
+
+ID3D11DepthStencilState* StateObjectCache::GetDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc) {
+    return Find(m_depthStencilStates, desc, [this](const D3D11_DEPTH_STENCIL_DESC& d, ID3D11DepthStencilState** state) {
+        return m_device->CreateDepthStencilState(&d, state);
+    });
+}
+
+ID3D11SamplerState* StateObjectCache::GetSamplerState(const D3D11_SAMPLER_DESC& desc) {
+    return Find(m_samplerStates, desc, [this](const D3D11_SAMPLER_DESC& d, ID3D11SamplerState** state) {
+        return m_device->CreateSamplerState(&d, state);
+    });
+}
+
+StateObjectStats StateObjectCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+size_t StateObjectCache::GetStateCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rasterizerStates.size() + m_blendStates.size() + m_depthStencilStates.size() + m_samplerStates.size();
+}
+
+} // namespace Renderer
+} // namespace GameEngine
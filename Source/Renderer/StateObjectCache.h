@@ -0,0 +1,85 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace GameEngine {
+namespace Renderer {
+
+using Microsoft::WRL::ComPtr;
+
+struct StateObjectStats {
+    unsigned int created = 0;    // State objects created on the device
+    unsigned int reused = 0;     // Requests answered from the cache
+};
+
+// Rasterizer, blend, depth-stencil and sampler states keyed by their
+// descriptions. Materials and passes describe the state they need and get
+// the one shared object for that description, so nothing creates states per
+// frame and identical states compare equal by pointer (which is what lets
+// ContextStateCache filter the bind). Safe to call from any thread.
+class StateObjectCache {
+public:
+    StateObjectCache() : m_device(nullptr) {}
+    ~StateObjectCache() = default;
+
+    void Initialize(ID3D11Device* device);
+    void Clear();
+
+    // Null if the device rejects the description
+    ID3D11RasterizerState* GetRasterizerState(const D3D11_RASTERIZER_DESC& desc);
+    ID3D11BlendState* GetBlendState(const D3D11_BLEND_DESC& desc);
+    ID3D11DepthStencilState* GetDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc);
+    ID3D11SamplerState* GetSamplerState(const D3D11_SAMPLER_DESC& desc);
+
+    StateObjectStats GetStats() const;
+    size_t GetStateCount() const;
+
+private:
+    // Descriptions are plain structs; hash and compare their bytes. Callers
+    // zero-initialize them ("= {}") so padding is deterministic.
+    template<typename Desc>
+    struct DescKey {
+        Desc desc;
+
+        bool operator==(const DescKey& other) const {
+            return std::memcmp(&desc, &other.desc, sizeof(Desc)) == 0;
+        }
+    };
+
+    template<typename Desc>
+    struct DescHash {
+        size_t operator()(const DescKey<Desc>& key) const {
+            // FNV-1a over the description bytes
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&key.desc);
+            std::uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(Desc); i++) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    template<typename Desc, typename State>
+    using StateMap = std::unordered_map<DescKey<Desc>, ComPtr<State>, DescHash<Desc>>;
+
+    template<typename Desc, typename State, typename Create>
+    State* Find(StateMap<Desc, State>& states, const Desc& desc, Create create);
+
+    ID3D11Device* m_device;
+    mutable std::mutex m_mutex;
+
+    StateMap<D3D11_RASTERIZER_DESC, ID3D11RasterizerState> m_rasterizerStates;
+    StateMap<D3D11_BLEND_DESC, ID3D11BlendState> m_blendStates;
+    StateMap<D3D11_DEPTH_STENCIL_DESC, ID3D11DepthStencilState> m_depthStencilStates;
+    StateMap<D3D11_SAMPLER_DESC, ID3D11SamplerState> m_samplerStates;
+    StateObjectStats m_stats;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -1,25 +1,59 @@
 #include "Texture.h"
+#include "TextureCooker.h"
+#include "GpuMemory.h"
+#include "../Core/AssetArchive.h"
+#include "../Core/ConfigManager.h"
+#include "../Core/FileSystem.h"
 #include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
+#include "../Mesh/AsyncLoader.h"
 #include <DDSTextureLoader.h>
 #include <WICTextureLoader.h>
+#include <DirectXTex.h>
 #include <d3d11.h>
 #include <DirectXMath.h>
 #include <algorithm>
 #include <codecvt>
+#include <filesystem>
 #include <locale>
 
 using namespace GameEngine::Renderer;
 using namespace GameEngine::Core;
 
+namespace {
+
+// Streamable textures never drop below this size
+constexpr UINT STREAMING_RESIDENT_SIZE = 64;
+
+// Frames without feedback before a texture falls back to its resident floor
+constexpr std::uint64_t STREAMING_IDLE_FRAMES = 120;
+
+// Mip loads in flight at once, so streaming never floods the loader threads
+constexpr UINT MAX_PENDING_STREAM_LOADS = 4;
+
+} // namespace
+
 Texture::Texture()
     : m_width(0)
     , m_height(0)
     , m_format(DXGI_FORMAT_UNKNOWN)
+    , m_mipLevels(0)
     , m_isRenderTarget(false)
+    , m_streamable(false)
+    , m_fullWidth(0)
+    , m_fullHeight(0)
+    , m_fullMipLevels(0)
+    , m_residentMip(0)
+    , m_minResidentMip(0)
+    , m_wantedMip(0)
+    , m_streamPending(false)
+    , m_lastRequestFrame(0)
+    , m_requestedPixels(0)
 {
 }
 
 bool Texture::LoadFromFile(const std::wstring& filename, ID3D11Device* device) {
+    MEMORY_SCOPE(Textures);
     if (!device) {
         Logger::GetInstance().LogError("Texture::LoadFromFile - Device is null");
         return false;
@@ -35,7 +69,24 @@ bool Texture::LoadFromFile(const std::wstring& filename, ID3D11Device* device) {
     if (extension == L"dds") {
         success = LoadDDS(filename, device);
     } else {
-        success = LoadWIC(filename, device);
+        // Prefer the cooked DDS with mips and block compression, cooking on first use
+        const Core::AssetSettings& assetSettings = CONFIG_MANAGER.GetAssetSettings();
+        if (assetSettings.enableAssetCache) {
+            if (!TextureCooker::IsUpToDate(filename)) {
+                TextureCookOptions options;
+                options.usage = TextureCooker::GuessUsage(filename);
+                options.compress = assetSettings.compressTextures;
+                options.useBC7 = assetSettings.useBC7;
+                TextureCooker::Cook(filename, TextureCooker::GetCookedPath(filename), options);
+            }
+            if (TextureCooker::IsUpToDate(filename)) {
+                success = LoadDDS(TextureCooker::GetCookedPath(filename), device);
+            }
+        }
+
+        if (!success) {
+            success = LoadWIC(filename, device);
+        }
     }
 
     if (success) {
@@ -55,6 +106,7 @@ bool Texture::LoadFromFile(const std::wstring& filename, ID3D11Device* device) {
 }
 
 bool Texture::LoadFromMemory(const void* data, size_t dataSize, ID3D11Device* device) {
+    MEMORY_SCOPE(Textures);
     if (!device || !data || dataSize == 0) {
         Logger::GetInstance().LogError("Texture::LoadFromMemory - Invalid parameters");
         return false;
@@ -76,11 +128,7 @@ bool Texture::LoadFromMemory(const void* data, size_t dataSize, ID3D11Device* de
     }
 
     if (SUCCEEDED(hr)) {
-        D3D11_TEXTURE2D_DESC desc;
-        m_texture->GetDesc(&desc);
-        m_width = desc.Width;
-        m_height = desc.Height;
-        m_format = desc.Format;
+        ReadDescription();
         return true;
     }
 
@@ -97,12 +145,7 @@ bool Texture::CreateFromTexture2D(ID3D11Texture2D* texture, ID3D11Device* device
     Release();
 
     m_texture = texture;
-
-    D3D11_TEXTURE2D_DESC desc;
-    texture->GetDesc(&desc);
-    m_width = desc.Width;
-    m_height = desc.Height;
-    m_format = desc.Format;
+    ReadDescription();
 
     return CreateShaderResourceView(device);
 }
@@ -124,31 +167,7 @@ bool Texture::CreateCheckerboard(int width, int height, ID3D11Device* device, UI
         }
     }
 
-    D3D11_TEXTURE2D_DESC desc = {};
-    desc.Width = width;
-    desc.Height = height;
-    desc.MipLevels = 1;
-    desc.ArraySize = 1;
-    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    desc.SampleDesc.Count = 1;
-    desc.Usage = D3D11_USAGE_IMMUTABLE;
-    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = pixels.data();
-    initData.SysMemPitch = width * sizeof(UINT32);
-
-    HRESULT hr = device->CreateTexture2D(&desc, &initData, m_texture.GetAddressOf());
-    if (FAILED(hr)) {
-        Logger::GetInstance().LogError("Failed to create checkerboard texture");
-        return false;
-    }
-
-    m_width = width;
-    m_height = height;
-    m_format = desc.Format;
-
-    return CreateShaderResourceView(device);
+    return CreateFromPixels(pixels.data(), width, height, device);
 }
 
 bool Texture::CreateSolidColor(int width, int height, ID3D11Device* device, UINT32 color) {
@@ -161,34 +180,10 @@ bool Texture::CreateSolidColor(int width, int height, ID3D11Device* device, UINT
 
     std::vector<UINT32> pixels(width * height, color);
 
-    D3D11_TEXTURE2D_DESC desc = {};
-    desc.Width = width;
-    desc.Height = height;
-    desc.MipLevels = 1;
-    desc.ArraySize = 1;
-    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    desc.SampleDesc.Count = 1;
-    desc.Usage = D3D11_USAGE_IMMUTABLE;
-    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = pixels.data();
-    initData.SysMemPitch = width * sizeof(UINT32);
-
-    HRESULT hr = device->CreateTexture2D(&desc, &initData, m_texture.GetAddressOf());
-    if (FAILED(hr)) {
-        Logger::GetInstance().LogError("Failed to create solid color texture");
-        return false;
-    }
-
-    m_width = width;
-    m_height = height;
-    m_format = desc.Format;
-
-    return CreateShaderResourceView(device);
+    return CreateFromPixels(pixels.data(), width, height, device);
 }
 
-bool Texture::CreateRenderTarget(int width, int height, DXGI_FORMAT format, ID3D11Device* device) {
+bool Texture::CreateRenderTarget(int width, int height, DXGI_FORMAT format, ID3D11Device* device, UINT mipLevels) {
     if (!device || width <= 0 || height <= 0) {
         Logger::GetInstance().LogError("Texture::CreateRenderTarget - Invalid parameters");
         return false;
@@ -199,12 +194,13 @@ bool Texture::CreateRenderTarget(int width, int height, DXGI_FORMAT format, ID3D
     D3D11_TEXTURE2D_DESC desc = {};
     desc.Width = width;
     desc.Height = height;
-    desc.MipLevels = 1;
+    desc.MipLevels = mipLevels;
     desc.ArraySize = 1;
     desc.Format = format;
     desc.SampleDesc.Count = 1;
     desc.Usage = D3D11_USAGE_DEFAULT;
     desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+    desc.MiscFlags = mipLevels != 1 ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
 
     HRESULT hr = device->CreateTexture2D(&desc, nullptr, m_texture.GetAddressOf());
     if (FAILED(hr)) {
@@ -219,9 +215,7 @@ bool Texture::CreateRenderTarget(int width, int height, DXGI_FORMAT format, ID3D
         return false;
     }
 
-    m_width = width;
-    m_height = height;
-    m_format = format;
+    ReadDescription();
     m_isRenderTarget = true;
 
     return CreateShaderResourceView(device);
@@ -274,13 +268,17 @@ bool Texture::CreateDepthStencil(int width, int height, ID3D11Device* device) {
         return false;
     }
 
-    m_width = width;
-    m_height = height;
-    m_format = desc.Format;
+    ReadDescription();
 
     return true;
 }
 
+void Texture::GenerateMips(ID3D11DeviceContext* context) {
+    if (context && m_shaderResourceView && m_isRenderTarget && m_mipLevels > 1) {
+        context->GenerateMips(m_shaderResourceView.Get());
+    }
+}
+
 void Texture::Release() {
     m_texture.Reset();
     m_shaderResourceView.Reset();
@@ -291,7 +289,46 @@ void Texture::Release() {
     m_width = 0;
     m_height = 0;
     m_format = DXGI_FORMAT_UNKNOWN;
+    m_mipLevels = 0;
     m_isRenderTarget = false;
+
+    m_streamPath.clear();
+    m_streamable = false;
+    m_fullWidth = 0;
+    m_fullHeight = 0;
+    m_fullMipLevels = 0;
+    m_residentMip = 0;
+    m_minResidentMip = 0;
+    m_wantedMip = 0;
+    m_requestedPixels.store(0, std::memory_order_relaxed);
+}
+
+void Texture::TakeFrom(Texture& other) {
+    m_texture = std::move(other.m_texture);
+    m_shaderResourceView = std::move(other.m_shaderResourceView);
+    m_renderTargetView = std::move(other.m_renderTargetView);
+    m_depthStencilView = std::move(other.m_depthStencilView);
+
+    m_filename = std::move(other.m_filename);
+    m_width = other.m_width;
+    m_height = other.m_height;
+    m_format = other.m_format;
+    m_mipLevels = other.m_mipLevels;
+    m_isRenderTarget = other.m_isRenderTarget;
+
+    // m_streamPending stays: a stream load still in flight completes against
+    // this texture and is kept only if it is more detailed than the new mips
+    m_streamPath = std::move(other.m_streamPath);
+    m_streamable = other.m_streamable;
+    m_fullWidth = other.m_fullWidth;
+    m_fullHeight = other.m_fullHeight;
+    m_fullMipLevels = other.m_fullMipLevels;
+    m_residentMip = other.m_residentMip;
+    m_minResidentMip = other.m_minResidentMip;
+    m_wantedMip = other.m_wantedMip;
+    m_requestedPixels.store(0, std::memory_order_relaxed);
+
+    other.Release();
 }
 
 bool Texture::CreateShaderResourceView(ID3D11Device* device) {
@@ -308,11 +345,117 @@ bool Texture::CreateShaderResourceView(ID3D11Device* device) {
     return true;
 }
 
-bool Texture::LoadDDS(const std::wstring& filename, ID3D11Device* device) {
+bool Texture::CreateFromPixels(const UINT32* pixels, int width, int height, ID3D11Device* device) {
+    // Box-filter a full mip chain so procedural textures minify cleanly
+    std::vector<std::vector<UINT32>> levels;
+    levels.emplace_back(pixels, pixels + width * height);
+
+    int levelWidth = width;
+    int levelHeight = height;
+    while (levelWidth > 1 || levelHeight > 1) {
+        int nextWidth = std::max(levelWidth / 2, 1);
+        int nextHeight = std::max(levelHeight / 2, 1);
+        const std::vector<UINT32>& previous = levels.back();
+        std::vector<UINT32> next(nextWidth * nextHeight);
+
+        for (int y = 0; y < nextHeight; ++y) {
+            for (int x = 0; x < nextWidth; ++x) {
+                int x0 = std::min(x * 2, levelWidth - 1);
+                int x1 = std::min(x * 2 + 1, levelWidth - 1);
+                int y0 = std::min(y * 2, levelHeight - 1);
+                int y1 = std::min(y * 2 + 1, levelHeight - 1);
+                UINT32 samples[4] = {
+                    previous[y0 * levelWidth + x0], previous[y0 * levelWidth + x1],
+                    previous[y1 * levelWidth + x0], previous[y1 * levelWidth + x1]
+                };
+
+                UINT32 result = 0;
+                for (int channel = 0; channel < 4; ++channel) {
+                    UINT32 sum = 0;
+                    for (UINT32 sample : samples) {
+                        sum += (sample >> (channel * 8)) & 0xFF;
+                    }
+                    result |= ((sum + 2) / 4) << (channel * 8);
+                }
+                next[y * nextWidth + x] = result;
+            }
+        }
+
+        levels.push_back(std::move(next));
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = width;
+    desc.Height = height;
+    desc.MipLevels = static_cast<UINT>(levels.size());
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(levels.size());
+    for (size_t i = 0; i < levels.size(); ++i) {
+        initData[i].pSysMem = levels[i].data();
+        initData[i].SysMemPitch = std::max(width >> i, 1) * sizeof(UINT32);
+    }
+
+    HRESULT hr = device->CreateTexture2D(&desc, initData.data(), m_texture.GetAddressOf());
+    if (FAILED(hr)) {
+        Logger::GetInstance().LogError("Failed to create procedural texture");
+        return false;
+    }
+
+    ReadDescription();
+
+    return CreateShaderResourceView(device);
+}
+
+void Texture::ReadDescription() {
+    D3D11_TEXTURE2D_DESC desc;
+    m_texture->GetDesc(&desc);
+    m_width = desc.Width;
+    m_height = desc.Height;
+    m_format = desc.Format;
+    m_mipLevels = desc.MipLevels;
+
+    // Every path that sets m_texture ends here
+    TrackGpuMemory(m_texture.Get(), MemoryCategory::Textures);
+}
+
+bool Texture::LoadDDS(const std::wstring& filename, ID3D11Device* device, size_t maxSize) {
+    // Header and pixels are both read from one mapping of the file
+    MappedFile file(filename);
+    if (!file.IsValid()) {
+        return false;
+    }
+
+    // Plain 2D textures with a mip chain start at their low mips only
+    DirectX::TexMetadata metadata;
+    bool streamable = maxSize == 0
+        && CONFIG_MANAGER.GetGraphicsSettings().textureStreaming
+        && SUCCEEDED(DirectX::GetMetadataFromDDSMemory(file.GetData(), file.GetSize(), DirectX::DDS_FLAGS_NONE, metadata))
+        && metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE2D
+        && metadata.arraySize == 1 && metadata.depth == 1
+        && metadata.mipLevels > 1
+        && std::max(metadata.width, metadata.height) > STREAMING_RESIDENT_SIZE;
+    if (streamable) {
+        maxSize = STREAMING_RESIDENT_SIZE;
+    }
+
     ComPtr<ID3D11Resource> resource;
-    HRESULT hr = DirectX::CreateDDSTextureFromFile(
+    HRESULT hr = DirectX::CreateDDSTextureFromMemoryEx(
         device,
-        filename.c_str(),
+        file.GetData(),
+        file.GetSize(),
+        maxSize,
+        D3D11_USAGE_DEFAULT,
+        D3D11_BIND_SHADER_RESOURCE,
+        0,
+        0,
+        DirectX::DDS_LOADER_DEFAULT,
         resource.GetAddressOf(),
         m_shaderResourceView.GetAddressOf()
     );
@@ -322,22 +465,77 @@ bool Texture::LoadDDS(const std::wstring& filename, ID3D11Device* device) {
     }
 
     if (SUCCEEDED(hr)) {
-        D3D11_TEXTURE2D_DESC desc;
-        m_texture->GetDesc(&desc);
-        m_width = desc.Width;
-        m_height = desc.Height;
-        m_format = desc.Format;
+        ReadDescription();
+
+        if (streamable) {
+            m_streamPath = filename;
+            m_streamable = true;
+            m_fullWidth = static_cast<UINT>(metadata.width);
+            m_fullHeight = static_cast<UINT>(metadata.height);
+            m_fullMipLevels = static_cast<UINT>(metadata.mipLevels);
+            m_residentMip = m_fullMipLevels - m_mipLevels;
+            m_minResidentMip = m_residentMip;
+            m_wantedMip = m_residentMip;
+        }
         return true;
     }
 
     return false;
 }
 
+void Texture::RequestResolution(UINT pixels) {
+    UINT current = m_requestedPixels.load(std::memory_order_relaxed);
+    while (pixels > current &&
+           !m_requestedPixels.compare_exchange_weak(current, pixels, std::memory_order_relaxed)) {
+    }
+}
+
+size_t Texture::GetMemoryUsage() const {
+    return GetMemoryUsage(m_streamable ? m_residentMip : 0);
+}
+
+size_t Texture::GetMemoryUsage(UINT topMip) const {
+    if (!m_texture) {
+        return 0;
+    }
+
+    UINT width = m_streamable ? m_fullWidth : static_cast<UINT>(m_width);
+    UINT height = m_streamable ? m_fullHeight : static_cast<UINT>(m_height);
+    UINT levels = m_streamable ? m_fullMipLevels : m_mipLevels;
+
+    size_t total = 0;
+    for (UINT mip = topMip; mip < levels; mip++) {
+        size_t rowPitch = 0;
+        size_t slicePitch = 0;
+        if (SUCCEEDED(DirectX::ComputePitch(m_format, std::max(width >> mip, 1u), std::max(height >> mip, 1u),
+                                            rowPitch, slicePitch))) {
+            total += slicePitch;
+        }
+    }
+    return total;
+}
+
+UINT Texture::GetMipForResolution(UINT pixels) const {
+    // Most detailed mip still no larger than needed on screen
+    UINT size = std::max(m_fullWidth, m_fullHeight);
+    UINT mip = 0;
+    while (mip < m_minResidentMip && (size >> (mip + 1)) >= pixels) {
+        mip++;
+    }
+    return mip;
+}
+
 bool Texture::LoadWIC(const std::wstring& filename, ID3D11Device* device) {
+    MappedFile file(filename);
+    if (!file.IsValid()) {
+        return false;
+    }
+
     ComPtr<ID3D11Resource> resource;
-    HRESULT hr = DirectX::CreateWICTextureFromFile(
+    HRESULT hr = DirectX::CreateWICTextureFromMemory(
         device,
-        filename.c_str(),
+        file.GetData(),
+        file.GetSize(),
         resource.GetAddressOf(),
         m_shaderResourceView.GetAddressOf()
     );
@@ -347,11 +545,7 @@ bool Texture::LoadWIC(const std::wstring& filename, ID3D11Device* device) {
     }
 
     if (SUCCEEDED(hr)) {
-        D3D11_TEXTURE2D_DESC desc;
-        m_texture->GetDesc(&desc);
-        m_width = desc.Width;
-        m_height = desc.Height;
-        m_format = desc.Format;
+        ReadDescription();
         return true;
     }
 
@@ -364,49 +558,237 @@ TextureManager& TextureManager::GetInstance() {
     return instance;
 }
 
+TextureManager::TextureManager()
+    : m_textures([](const Texture& texture) { return texture.GetMemoryUsage(); })
+{
+}
+
 std::shared_ptr<Texture> TextureManager::LoadTexture(const std::wstring& filename, ID3D11Device* device) {
-    auto it = m_textures.find(filename);
-    if (it != m_textures.end()) {
-        if (auto existing = it->second.lock()) {
-            return existing;
-        } else {
-            m_textures.erase(it);
+    // Decoded outside any lock; other threads asking for the same file wait for this load
+    return m_textures.GetOrLoad(filename, [&filename, device]() -> std::shared_ptr<Texture> {
+        auto texture = std::make_shared<Texture>();
+        if (!texture->LoadFromFile(filename, device)) {
+            return nullptr;
         }
-    }
-
-    auto texture = std::make_shared<Texture>();
-    if (texture->LoadFromFile(filename, device)) {
-        m_textures[filename] = texture;
         return texture;
-    }
-
-    return nullptr;
+    });
 }
 
 std::shared_ptr<Texture> TextureManager::GetTexture(const std::wstring& filename) {
-    auto it = m_textures.find(filename);
-    if (it != m_textures.end()) {
-        if (auto existing = it->second.lock()) {
-            return existing;
-        } else {
-            m_textures.erase(it);
-        }
-    }
-    return nullptr;
+    return m_textures.Find(filename);
+}
+
+void TextureManager::AddTexture(const std::wstring& filename, std::shared_ptr<Texture> texture) {
+    m_textures.Insert(filename, std::move(texture));
 }
 
 void TextureManager::UnloadTexture(const std::wstring& filename) {
-    auto it = m_textures.find(filename);
-    if (it != m_textures.end()) {
-        m_textures.erase(it);
+    m_textures.Remove(filename);
+}
+
+bool TextureManager::ReloadTexture(const std::wstring& filename, ID3D11Device* device) {
+    // Callers spell paths differently, so compare normalized forms
+    std::string changed = AssetArchive::NormalizePath(std::filesystem::path(filename).string());
+    std::vector<std::pair<std::wstring, std::shared_ptr<Texture>>> matches;
+    m_textures.ForEach([&](const std::wstring& key, const std::shared_ptr<Texture>& texture) {
+        if (AssetArchive::NormalizePath(std::filesystem::path(key).string()) == changed) {
+            matches.emplace_back(key, texture);
+        }
+    });
+
+    bool reloaded = false;
+    for (auto& [key, texture] : matches) {
+        // Decode on the side, so a file that fails to load keeps the old image
+        Texture fresh;
+        if (!fresh.LoadFromFile(key, device)) {
+            continue;
+        }
+        texture->TakeFrom(fresh);
+        m_textures.Insert(key, texture);
+        reloaded = true;
     }
+    return reloaded;
 }
 
 void TextureManager::UnloadAll() {
-    m_textures.clear();
+    m_textures.Clear();
     m_defaultSampler.Reset();
 }
 
+void TextureManager::TrimCache(size_t budgetBytes) {
+    size_t evicted = m_textures.Trim(budgetBytes);
+    if (evicted > 0) {
+        LOG_DEBUG("Evicted " << evicted << " unused textures to stay within " << (budgetBytes / (1024 * 1024)) << " MB");
+    }
+}
+
+void TextureManager::UpdateStreaming(ID3D11Device* device, ID3D11DeviceContext* context) {
+    const GraphicsSettings& graphicsSettings = CONFIG_MANAGER.GetGraphicsSettings();
+    if (!graphicsSettings.textureStreaming || !device || !context) {
+        return;
+    }
+
+    m_streamingFrame++;
+    m_streamingStats = StreamingStats();
+    m_streamingStats.budgetBytes = static_cast<size_t>(graphicsSettings.textureBudgetMB) * 1024 * 1024;
+    m_streamingStats.pendingLoads = m_pendingStreamLoads;
+
+    m_streamingScratch.clear();
+    m_textures.ForEach([this](const std::wstring&, const std::shared_ptr<Texture>& texture) {
+        if (texture->IsStreamable()) {
+            m_streamingScratch.push_back(texture);
+        }
+    });
+
+    // Turn this frame's feedback into a wanted mip per texture
+    size_t wantedBytes = 0;
+    for (const auto& texture : m_streamingScratch) {
+        UINT requested = texture->m_requestedPixels.exchange(0, std::memory_order_relaxed);
+        if (requested > 0) {
+            texture->m_lastRequestFrame = m_streamingFrame;
+            texture->m_wantedMip = texture->GetMipForResolution(requested);
+        }
+        else if (m_streamingFrame - texture->m_lastRequestFrame > STREAMING_IDLE_FRAMES) {
+            texture->m_wantedMip = texture->m_minResidentMip;
+        }
+        wantedBytes += texture->GetMemoryUsage(texture->m_wantedMip);
+    }
+
+    // Over budget: least recently seen textures give up their top mips first
+    if (wantedBytes > m_streamingStats.budgetBytes) {
+        std::sort(m_streamingScratch.begin(), m_streamingScratch.end(),
+            [](const std::shared_ptr<Texture>& a, const std::shared_ptr<Texture>& b) {
+                if (a->m_lastRequestFrame != b->m_lastRequestFrame) {
+                    return a->m_lastRequestFrame < b->m_lastRequestFrame;
+                }
+                return a->m_wantedMip < b->m_wantedMip;
+            });
+
+        for (const auto& texture : m_streamingScratch) {
+            while (wantedBytes > m_streamingStats.budgetBytes && texture->m_wantedMip < texture->m_minResidentMip) {
+                wantedBytes -= texture->GetMemoryUsage(texture->m_wantedMip) - texture->GetMemoryUsage(texture->m_wantedMip + 1);
+                texture->m_wantedMip++;
+            }
+            if (wantedBytes <= m_streamingStats.budgetBytes) {
+                break;
+            }
+        }
+    }
+
+    for (const auto& texture : m_streamingScratch) {
+        if (texture->m_wantedMip > texture->m_residentMip) {
+            UINT dropped = texture->m_wantedMip - texture->m_residentMip;
+            if (Evict(*texture, texture->m_wantedMip, device, context)) {
+                m_streamingStats.mipsEvicted += dropped;
+            }
+        }
+        else if (texture->m_wantedMip < texture->m_residentMip && !texture->m_streamPending &&
+                 m_pendingStreamLoads < MAX_PENDING_STREAM_LOADS) {
+            StreamIn(texture, device);
+        }
+
+        m_streamingStats.residentBytes += texture->GetMemoryUsage();
+    }
+    m_streamingStats.streamingTextures = static_cast<UINT>(m_streamingScratch.size());
+    m_streamingScratch.clear();
+}
+
+void TextureManager::StreamIn(const std::shared_ptr<Texture>& texture, ID3D11Device* device) {
+    struct StreamResult {
+        ComPtr<ID3D11Resource> resource;
+        ComPtr<ID3D11ShaderResourceView> view;
+    };
+
+    auto result = std::make_shared<StreamResult>();
+    std::wstring path = texture->m_streamPath;
+    UINT topMip = texture->m_wantedMip;
+    size_t maxSize = std::max(std::max(texture->m_fullWidth, texture->m_fullHeight) >> topMip, 1u);
+    std::weak_ptr<Texture> weakTexture = texture;
+
+    texture->m_streamPending = true;
+    m_pendingStreamLoads++;
+
+    // Read and upload on a loader thread, swap views on the main thread
+    ASYNC_LOADER.Enqueue(Mesh::LoadPriority::Low,
+        [result, path, maxSize, device]() {
+            MEMORY_SCOPE(Textures);
+
+            // Mapped, so only the pages of the mips being uploaded are read
+            MappedFile file(path);
+            HRESULT hr = file.IsValid()
+                ? DirectX::CreateDDSTextureFromMemoryEx(device, file.GetData(), file.GetSize(), maxSize,
+                    D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, 0, DirectX::DDS_LOADER_DEFAULT,
+                    result->resource.GetAddressOf(), result->view.GetAddressOf())
+                : E_FAIL;
+            if (FAILED(hr)) {
+                result->resource.Reset();
+                result->view.Reset();
+            }
+        },
+        [this, result, path, weakTexture]() {
+            m_pendingStreamLoads--;
+
+            auto texture = weakTexture.lock();
+            if (!texture) {
+                return;
+            }
+            texture->m_streamPending = false;
+
+            ComPtr<ID3D11Texture2D> texture2D;
+            if (!result->resource || FAILED(result->resource.As(&texture2D)) || texture->m_streamPath != path) {
+                return;
+            }
+
+            D3D11_TEXTURE2D_DESC desc;
+            texture2D->GetDesc(&desc);
+            UINT topMip = texture->m_fullMipLevels - std::min(desc.MipLevels, texture->m_fullMipLevels);
+            if (topMip >= texture->m_residentMip) {
+                return;     // Eviction overtook this load
+            }
+
+            texture->m_texture = texture2D;
+            texture->m_shaderResourceView = result->view;
+            texture->ReadDescription();
+            texture->m_residentMip = topMip;
+        });
+}
+
+bool TextureManager::Evict(Texture& texture, UINT topMip, ID3D11Device* device, ID3D11DeviceContext* context) {
+    // Copy the surviving mips into a smaller texture on the GPU, no file reads
+    D3D11_TEXTURE2D_DESC desc;
+    texture.m_texture->GetDesc(&desc);
+
+    UINT skipped = topMip - texture.m_residentMip;
+    if (skipped >= desc.MipLevels) {
+        return false;
+    }
+
+    desc.Width = std::max(desc.Width >> skipped, 1u);
+    desc.Height = std::max(desc.Height >> skipped, 1u);
+    desc.MipLevels -= skipped;
+    desc.MiscFlags &= ~D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+    ComPtr<ID3D11Texture2D> smaller;
+    if (FAILED(device->CreateTexture2D(&desc, nullptr, smaller.GetAddressOf()))) {
+        return false;
+    }
+
+    for (UINT mip = 0; mip < desc.MipLevels; mip++) {
+        context->CopySubresourceRegion(smaller.Get(), mip, 0, 0, 0, texture.m_texture.Get(), mip + skipped, nullptr);
+    }
+
+    ComPtr<ID3D11ShaderResourceView> view;
+    if (FAILED(device->CreateShaderResourceView(smaller.Get(), nullptr, view.GetAddressOf()))) {
+        return false;
+    }
+
+    texture.m_texture = smaller;
+    texture.m_shaderResourceView = view;
+    texture.ReadDescription();
+    texture.m_residentMip = topMip;
+    return true;
+}
+
 ComPtr<ID3D11SamplerState> TextureManager::CreateSamplerState(ID3D11Device* device,
     D3D11_FILTER filter, D3D11_TEXTURE_ADDRESS_MODE addressMode) {
 
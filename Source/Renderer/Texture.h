@@ -1,9 +1,14 @@
 #pragma once
 #include <d3d11.h>
 #include <wrl/client.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
+#include "../Core/AssetCache.h"
 
 namespace GameEngine {
 namespace Renderer {
@@ -27,10 +32,13 @@ public:
                            UINT32 color1 = 0xFFFFFFFF, UINT32 color2 = 0xFF000000, int checkSize = 32);
     bool CreateSolidColor(int width, int height, ID3D11Device* device, UINT32 color = 0xFFFFFFFF);
 
-    // Render target creation
-    bool CreateRenderTarget(int width, int height, DXGI_FORMAT format, ID3D11Device* device);
+    // Render target creation; mipLevels other than 1 (0 for a full chain) enables GenerateMips
+    bool CreateRenderTarget(int width, int height, DXGI_FORMAT format, ID3D11Device* device, UINT mipLevels = 1);
     bool CreateDepthStencil(int width, int height, ID3D11Device* device);
 
+    // Rebuild the lower mips of a render target from its top level
+    void GenerateMips(ID3D11DeviceContext* context);
+
     // Getters
     ID3D11ShaderResourceView* GetSRV() const { return m_shaderResourceView.Get(); }
     ID3D11RenderTargetView* GetRTV() const { return m_renderTargetView.Get(); }
@@ -40,17 +48,37 @@ public:
     int GetWidth() const { return m_width; }
     int GetHeight() const { return m_height; }
     DXGI_FORMAT GetFormat() const { return m_format; }
+    UINT GetMipLevels() const { return m_mipLevels; }
     bool IsLoaded() const { return m_texture != nullptr; }
 
     const std::wstring& GetFilename() const { return m_filename; }
 
+    // Streaming. DDS files with a mip chain start with only their low mips
+    // resident; TextureManager::UpdateStreaming brings in top mips as the
+    // texture grows on screen and drops them again under budget pressure.
+    bool IsStreamable() const { return m_streamable; }
+    UINT GetFullMipLevels() const { return m_fullMipLevels; }
+    UINT GetResidentMip() const { return m_residentMip; }   // Most detailed mip in memory
+
+    // Feedback from rendering: largest on-screen size in pixels this frame
+    void RequestResolution(UINT pixels);
+
+    // Estimated size of the resident mips in bytes
+    size_t GetMemoryUsage() const;
+
     // Utility
     void Release();
 
 private:
     bool CreateShaderResourceView(ID3D11Device* device);
-    bool LoadDDS(const std::wstring& filename, ID3D11Device* device);
+    bool CreateFromPixels(const UINT32* pixels, int width, int height, ID3D11Device* device);
+    void ReadDescription();
+    bool LoadDDS(const std::wstring& filename, ID3D11Device* device, size_t maxSize = 0);
+    size_t GetMemoryUsage(UINT topMip) const;
+    UINT GetMipForResolution(UINT pixels) const;
     bool LoadWIC(const std::wstring& filename, ID3D11Device* device); // For PNG, JPG, etc.
+    // Take over another texture's resources and state, leaving it released
+    void TakeFrom(Texture& other);
 
 private:
     ComPtr<ID3D11Texture2D> m_texture;
@@ -62,35 +90,85 @@ private:
     int m_width;
     int m_height;
     DXGI_FORMAT m_format;
+    UINT m_mipLevels;
     bool m_isRenderTarget;
+
+    // Streaming state, owned by TextureManager on the main thread
+    std::wstring m_streamPath;
+    bool m_streamable;
+    UINT m_fullWidth;
+    UINT m_fullHeight;
+    UINT m_fullMipLevels;
+    UINT m_residentMip;
+    UINT m_minResidentMip;          // Least detailed level streaming may drop to
+    UINT m_wantedMip;
+    bool m_streamPending;
+    std::uint64_t m_lastRequestFrame;
+    std::atomic<UINT> m_requestedPixels;
+
+    friend class TextureManager;
 };
 
-// Texture Manager for resource management
+// Texture Manager for resource management. The cache is safe to use from
+// any thread; simultaneous loads of one file share a single decode.
 class TextureManager {
 public:
     static TextureManager& GetInstance();
 
     std::shared_ptr<Texture> LoadTexture(const std::wstring& filename, ID3D11Device* device);
     std::shared_ptr<Texture> GetTexture(const std::wstring& filename);
+    void AddTexture(const std::wstring& filename, std::shared_ptr<Texture> texture);
 
     void UnloadTexture(const std::wstring& filename);
     void UnloadAll();
 
+    // Drop textures nothing else references, least recently used first,
+    // while the cache is over budget
+    void TrimCache(size_t budgetBytes);
+    size_t GetCachedCount() const { return m_textures.GetCount(); }
+
+    // Reload cached textures loaded from a changed file in place, so
+    // materials holding them pick up the new image. Returns true if any were.
+    bool ReloadTexture(const std::wstring& filename, ID3D11Device* device);
+
+    // Stream mips of streamable textures towards the resolution rendering
+    // asked for, evicting least recently used top mips to stay in budget.
+    // Call once per frame on the main thread after rendering.
+    void UpdateStreaming(ID3D11Device* device, ID3D11DeviceContext* context);
+
+    struct StreamingStats {
+        size_t residentBytes = 0;
+        size_t budgetBytes = 0;
+        UINT streamingTextures = 0;
+        UINT pendingLoads = 0;
+        UINT mipsEvicted = 0;       // This frame
+    };
+    const StreamingStats& GetStreamingStats() const { return m_streamingStats; }
+
     // Create sampler states
     ComPtr<ID3D11SamplerState> CreateSamplerState(ID3D11Device* device,
         D3D11_FILTER filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
         D3D11_TEXTURE_ADDRESS_MODE addressMode = D3D11_TEXTURE_ADDRESS_WRAP);
 
 private:
-    TextureManager() = default;
+    TextureManager();
     ~TextureManager() = default;
 
     TextureManager(const TextureManager&) = delete;
     TextureManager& operator=(const TextureManager&) = delete;
 
 private:
-    std::unordered_map<std::wstring, std::weak_ptr<Texture>> m_textures;
+    void StreamIn(const std::shared_ptr<Texture>& texture, ID3D11Device* device);
+    bool Evict(Texture& texture, UINT topMip, ID3D11Device* device, ID3D11DeviceContext* context);
+
+    // Loader threads load material textures through here as well
+    Core::AssetCache<std::wstring, Texture> m_textures;
     ComPtr<ID3D11SamplerState> m_defaultSampler;
+
+    std::uint64_t m_streamingFrame = 0;
+    UINT m_pendingStreamLoads = 0;
+    std::vector<std::shared_ptr<Texture>> m_streamingScratch;
+    StreamingStats m_streamingStats;
 };
 
 } // namespace Renderer
@@ -0,0 +1,133 @@
+#include "TextureCooker.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Logger.h"
+#include <DirectXTex.h>
+#include <algorithm>
+#include <atomic>
+#include <codecvt>
+#include <cwctype>
+#include <filesystem>
+#include <locale>
+#include <system_error>
+
+using namespace GameEngine::Renderer;
+using namespace GameEngine::Core;
+
+namespace {
+
+std::string ToUtf8(const std::wstring& text) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+    return converter.to_bytes(text);
+}
+
+bool EndsWith(const std::wstring& text, const std::wstring& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+DXGI_FORMAT ChooseFormat(const DirectX::ScratchImage& image, const TextureCookOptions& options) {
+    if (options.usage == TextureUsage::Normal) {
+        return DXGI_FORMAT_BC5_UNORM;
+    }
+    if (options.useBC7) {
+        return DXGI_FORMAT_BC7_UNORM;
+    }
+    return image.IsAlphaAllOpaque() ? DXGI_FORMAT_BC1_UNORM : DXGI_FORMAT_BC3_UNORM;
+}
+
+} // namespace
+
+bool TextureCooker::Cook(const std::wstring& sourcePath, const std::wstring& cookedPath,
+                         const TextureCookOptions& options) {
+    DirectX::TexMetadata metadata;
+    DirectX::ScratchImage image;
+    HRESULT hr = DirectX::LoadFromWICFile(sourcePath.c_str(), DirectX::WIC_FLAGS_NONE, &metadata, image);
+    if (FAILED(hr)) {
+        Logger::GetInstance().LogError("TextureCooker - Failed to decode " + ToUtf8(sourcePath));
+        return false;
+    }
+
+    // Mips are filtered from the uncompressed image, never from BC blocks
+    if (options.generateMips && metadata.mipLevels == 1 && (metadata.width > 1 || metadata.height > 1)) {
+        DirectX::ScratchImage mipChain;
+        hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(),
+                                      DirectX::TEX_FILTER_DEFAULT, 0, mipChain);
+        if (FAILED(hr)) {
+            Logger::GetInstance().LogError("TextureCooker - Failed to generate mips for " + ToUtf8(sourcePath));
+            return false;
+        }
+        image = std::move(mipChain);
+    }
+
+    const DirectX::TexMetadata& source = image.GetMetadata();
+    bool blockAligned = source.width % 4 == 0 && source.height % 4 == 0;
+    if (options.compress && !blockAligned) {
+        Logger::GetInstance().LogWarning("TextureCooker - " + ToUtf8(sourcePath) +
+            " is not a multiple of 4, leaving it uncompressed");
+    }
+
+    if (options.compress && blockAligned && !DirectX::IsCompressed(source.format)) {
+        DXGI_FORMAT format = ChooseFormat(image, options);
+        DirectX::TEX_COMPRESS_FLAGS flags = DirectX::TEX_COMPRESS_PARALLEL;
+        if (format == DXGI_FORMAT_BC7_UNORM) {
+            flags |= DirectX::TEX_COMPRESS_BC7_QUICK;
+        }
+
+        DirectX::ScratchImage compressed;
+        hr = DirectX::Compress(image.GetImages(), image.GetImageCount(), source, format,
+                               flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+        if (FAILED(hr)) {
+            Logger::GetInstance().LogError("TextureCooker - Failed to compress " + ToUtf8(sourcePath));
+            return false;
+        }
+        image = std::move(compressed);
+    }
+
+    // Write beside the target and swap in, so readers never see a partial file
+    static std::atomic<unsigned int> s_tempCounter{ 0 };
+    std::wstring tempPath = cookedPath + L"." + std::to_wstring(s_tempCounter.fetch_add(1)) + L".tmp";
+
+    hr = DirectX::SaveToDDSFile(image.GetImages(), image.GetImageCount(), image.GetMetadata(),
+                                DirectX::DDS_FLAGS_NONE, tempPath.c_str());
+    if (FAILED(hr)) {
+        Logger::GetInstance().LogError("TextureCooker - Failed to write " + ToUtf8(tempPath));
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cookedPath, error);
+    if (error) {
+        Logger::GetInstance().LogError("TextureCooker - Failed to replace " + ToUtf8(cookedPath) + ": " + error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    const DirectX::TexMetadata& cooked = image.GetMetadata();
+    Logger::GetInstance().LogInfo("Cooked texture " + ToUtf8(cookedPath) + " (" +
+        std::to_string(cooked.width) + "x" + std::to_string(cooked.height) + ", " +
+        std::to_string(cooked.mipLevels) + " mips, format " + std::to_string(cooked.format) + ")");
+    return true;
+}
+
+std::wstring TextureCooker::GetCookedPath(const std::wstring& sourcePath) {
+    return sourcePath + L".dds";
+}
+
+bool TextureCooker::IsUpToDate(const std::wstring& sourcePath) {
+    std::string source = ToUtf8(sourcePath);
+    std::string cookedPath = ToUtf8(GetCookedPath(sourcePath));
+    if (!FILE_SYSTEM.FileExists(cookedPath)) {
+        return false;
+    }
+    // A missing source leaves the cooked copy as the only data there is
+    return !FILE_SYSTEM.FileExists(source) || !FILE_SYSTEM.IsFileNewer(source, cookedPath);
+}
+
+TextureUsage TextureCooker::GuessUsage(const std::wstring& sourcePath) {
+    std::wstring stem = std::filesystem::path(sourcePath).stem().wstring();
+    std::transform(stem.begin(), stem.end(), stem.begin(), ::towlower);
+
+    if (EndsWith(stem, L"_n") || EndsWith(stem, L"_nrm") || EndsWith(stem, L"_normal")) {
+        return TextureUsage::Normal;
+    }
+    return TextureUsage::Color;
+}
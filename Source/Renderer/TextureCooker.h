@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+
+namespace GameEngine {
+namespace Renderer {
+
+enum class TextureUsage {
+    Color,      // BC1 when opaque, BC3 with alpha, or BC7
+    Normal      // Two-channel BC5: blue reads as 0, so a shader sampling the
+                // map must rebuild z = sqrt(1 - x^2 - y^2). None does yet.
+};
+
+struct TextureCookOptions {
+    TextureUsage usage = TextureUsage::Color;
+    bool generateMips = true;
+    bool compress = true;
+    bool useBC7 = false;        // Higher quality colour, much slower to cook
+};
+
+// Offline-style import of source images (PNG, JPG, BMP, TGA...) into DDS.
+//
+// Cooking decodes with WIC, builds the full mip chain and block-compresses
+// every level, then writes a DDS next to the source so later runs upload
+// it as is. Textures whose top level is not a multiple of 4 keep their mip
+// chain but stay uncompressed, since D3D11 cannot create them as BC.
+class TextureCooker {
+public:
+    static bool Cook(const std::wstring& sourcePath, const std::wstring& cookedPath,
+                     const TextureCookOptions& options = TextureCookOptions());
+
+    // Cooked files sit next to their source: brick.png -> brick.png.dds
+    static std::wstring GetCookedPath(const std::wstring& sourcePath);
+
+    // True when the cooked file exists and is newer than its source
+    static bool IsUpToDate(const std::wstring& sourcePath);
+
+    // Normal maps are recognised by the usual _n, _nrm and _normal suffixes
+    static TextureUsage GuessUsage(const std::wstring& sourcePath);
+};
+
+} // namespace Renderer
+} // namespace GameEngine
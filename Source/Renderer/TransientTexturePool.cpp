@@ -0,0 +1,177 @@
+#include "TransientTexturePool.h"
+#include "GpuMemory.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+
+namespace GameEngine {
+namespace Renderer {
+
+namespace {
+
+UINT GetBytesPerPixel(DXGI_FORMAT format) {
+    switch (format) {
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        return 16;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R32G32_FLOAT:
+        return 8;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_R10G10B10A2_UNORM:
+    case DXGI_FORMAT_R11G11B10_FLOAT:
+    case DXGI_FORMAT_R16G16_FLOAT:
+    case DXGI_FORMAT_R32_FLOAT:
+        return 4;
+    case DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT_R8G8_UNORM:
+        return 2;
+    case DXGI_FORMAT_R8_UNORM:
+        return 1;
+    default:
+        return 4;
+    }
+}
+
+} // namespace
+
+TransientTexturePool::TransientTexturePool()
+    : m_device(nullptr)
+    , m_frame(0)
+    , m_allocatedBytes(0)
+    , m_acquires(0)
+    , m_reuses(0)
+{
+}
+
+std::uint64_t TransientTexturePool::GetTextureBytes(const TransientTextureDesc& desc) {
+    return static_cast<std::uint64_t>(desc.width) * desc.height * desc.arraySize * GetBytesPerPixel(desc.format);
+}
+
+TransientTexture* TransientTexturePool::Acquire(const TransientTextureDesc& desc) {
+    if (!m_device || desc.width == 0 || desc.height == 0 || desc.arraySize == 0) {
+        return nullptr;
+    }
+    m_acquires++;
+
+    for (const auto& texture : m_textures) {
+        if (!texture->inUse && texture->desc == desc) {
+            // Already used this frame means its memory is shared between passes
+            if (texture->lastUsedFrame == m_frame) {
+                m_reuses++;
+            }
+            texture->inUse = true;
+            texture->lastUsedFrame = m_frame;
+            return texture.get();
+        }
+    }
+
+    auto texture = std::make_unique<TransientTexture>();
+    texture->desc = desc;
+    if (!CreateTexture(*texture)) {
+        LOG_ERROR("Failed to create " << desc.width << "x" << desc.height << " transient texture");
+        return nullptr;
+    }
+
+    texture->inUse = true;
+    texture->lastUsedFrame = m_frame;
+    m_allocatedBytes += GetTextureBytes(desc);
+    m_textures.push_back(std::move(texture));
+    return m_textures.back().get();
+}
+
+void TransientTexturePool::Release(TransientTexture* texture) {
+    if (texture) {
+        texture->inUse = false;
+    }
+}
+
+void TransientTexturePool::EndFrame() {
+    // Anything still in use stays; its owner releases it later
+    auto expired = [this](const std::unique_ptr<TransientTexture>& texture) {
+        return !texture->inUse && m_frame - texture->lastUsedFrame >= RETAIN_FRAMES;
+    };
+    for (const auto& texture : m_textures) {
+        if (expired(texture)) {
+            m_allocatedBytes -= GetTextureBytes(texture->desc);
+        }
+    }
+    m_textures.erase(std::remove_if(m_textures.begin(), m_textures.end(), expired), m_textures.end());
+
+    m_frame++;
+    m_acquires = 0;
+    m_reuses = 0;
+}
+
+void TransientTexturePool::Clear() {
+    m_textures.clear();
+    m_allocatedBytes = 0;
+}
+
+bool TransientTexturePool::CreateTexture(TransientTexture& texture) {
+    const TransientTextureDesc& desc = texture.desc;
+    bool arrayViews = desc.arrayViews || desc.arraySize > 1;
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = desc.width;
+    textureDesc.Height = desc.height;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = desc.arraySize;
+    textureDesc.Format = desc.format;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = desc.bindFlags;
+    if (FAILED(m_device->CreateTexture2D(&textureDesc, nullptr, &texture.texture))) {
+        return false;
+    }
+    TrackGpuMemory(texture.texture.Get(), Core::MemoryCategory::Renderer);
+
+    if (desc.bindFlags & D3D11_BIND_RENDER_TARGET) {
+        D3D11_RENDER_TARGET_VIEW_DESC viewDesc = {};
+        viewDesc.Format = desc.format;
+        if (arrayViews) {
+            viewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+            viewDesc.Texture2DArray.ArraySize = desc.arraySize;
+        } else {
+            viewDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+        }
+        if (FAILED(m_device->CreateRenderTargetView(texture.texture.Get(), &viewDesc, &texture.renderTargetView))) {
+            return false;
+        }
+    }
+
+    if (desc.bindFlags & D3D11_BIND_SHADER_RESOURCE) {
+        D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+        viewDesc.Format = desc.format;
+        if (arrayViews) {
+            viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+            viewDesc.Texture2DArray.MipLevels = 1;
+            viewDesc.Texture2DArray.ArraySize = desc.arraySize;
+        } else {
+            viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+            viewDesc.Texture2D.MipLevels = 1;
+        }
+        if (FAILED(m_device->CreateShaderResourceView(texture.texture.Get(), &viewDesc, &texture.shaderResourceView))) {
+            return false;
+        }
+    }
+
+    if (desc.bindFlags & D3D11_BIND_UNORDERED_ACCESS) {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC viewDesc = {};
+        viewDesc.Format = desc.format;
+        if (arrayViews) {
+            viewDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2DARRAY;
+            viewDesc.Texture2DArray.ArraySize = desc.arraySize;
+        } else {
+            viewDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+        }
+        if (FAILED(m_device->CreateUnorderedAccessView(texture.texture.Get(), &viewDesc, &texture.unorderedAccessView))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace GameEngine {
+namespace Renderer {
+
+using Microsoft::WRL::ComPtr;
+
+// Size, format and bindings of a transient texture; textures are shared
+// between uses with equal descriptions. Colour formats only: depth needs
+// typeless textures and is not pooled.
+struct TransientTextureDesc {
+    UINT width = 0;
+    UINT height = 0;
+    UINT arraySize = 1;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    UINT bindFlags = 0;         // D3D11_BIND_RENDER_TARGET, _SHADER_RESOURCE, _UNORDERED_ACCESS
+    bool arrayViews = false;    // Views are Texture2DArray even for one slice
+
+    bool operator==(const TransientTextureDesc& other) const {
+        return width == other.width && height == other.height && arraySize == other.arraySize &&
+               format == other.format && bindFlags == other.bindFlags && arrayViews == other.arrayViews;
+    }
+    bool operator!=(const TransientTextureDesc& other) const { return !(*this == other); }
+};
+
+// A pooled texture with a view for each of its bindings
+struct TransientTexture {
+    TransientTextureDesc desc;
+    ComPtr<ID3D11Texture2D> texture;
+    ComPtr<ID3D11RenderTargetView> renderTargetView;
+    ComPtr<ID3D11ShaderResourceView> shaderResourceView;
+    ComPtr<ID3D11UnorderedAccessView> unorderedAccessView;
+    std::uint64_t lastUsedFrame = 0;
+    bool inUse = false;
+};
+
+// Render targets and scratch textures that only live for part of a frame.
+//
+// Acquire hands out a free texture with the same description or creates
+// one; Release gives it back, so a later use in the same frame gets the same
+// memory (lifetime aliasing). Contents are undefined on acquire. Textures
+// unused for RETAIN_FRAMES frames are freed by EndFrame, so resolution and
+// feature changes don't leave old targets behind. Render thread only.
+class TransientTexturePool {
+public:
+    static constexpr std::uint64_t RETAIN_FRAMES = 3;
+
+    TransientTexturePool();
+    ~TransientTexturePool() = default;
+
+    void Initialize(ID3D11Device* device) { m_device = device; }
+
+    // Null when creation fails
+    TransientTexture* Acquire(const TransientTextureDesc& desc);
+    void Release(TransientTexture* texture);
+
+    void EndFrame();
+    void Clear();
+
+    // Textures held, free or in use, and their memory
+    size_t GetTextureCount() const { return m_textures.size(); }
+    std::uint64_t GetAllocatedBytes() const { return m_allocatedBytes; }
+    // This frame: acquires, and how many of them reused a texture released earlier
+    UINT GetAcquireCount() const { return m_acquires; }
+    UINT GetReuseCount() const { return m_reuses; }
+
+    static std::uint64_t GetTextureBytes(const TransientTextureDesc& desc);
+
+private:
+    bool CreateTexture(TransientTexture& texture);
+
+    ID3D11Device* m_device;
+    std::vector<std::unique_ptr<TransientTexture>> m_textures;
+    std::uint64_t m_frame;
+    std::uint64_t m_allocatedBytes;
+    UINT m_acquires;
+    UINT m_reuses;
+};
+
+} // namespace Renderer
+} // namespace GameEngine
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 
 namespace GameEngine {
 namespace Scene {
@@ -8,6 +9,35 @@ namespace Scene {
 // Forward declarations
 class Entity;
 
+// Phases of Scene::Update, in order. LateTransform runs after world
+// matrices have been propagated.
+enum class UpdatePhase : std::uint8_t {
+    PreUpdate,
+    Update,
+    PostUpdate,
+    LateTransform
+};
+
+// Data a component type's update touches. Two types in the same phase run
+// concurrently only if neither writes what the other reads or writes.
+using SystemAccess = std::uint32_t;
+constexpr SystemAccess ACCESS_NONE = 0;
+constexpr SystemAccess ACCESS_TRANSFORM = 1u << 0;
+constexpr SystemAccess ACCESS_ANIMATION = 1u << 1;
+constexpr SystemAccess ACCESS_RENDERING = 1u << 2;
+constexpr SystemAccess ACCESS_LIGHTING = 1u << 3;
+constexpr SystemAccess ACCESS_GAMEPLAY = 1u << 4;
+constexpr SystemAccess ACCESS_ALL = 0xFFFFFFFFu;
+
+// How the scene updates a component type. Types override it with a static
+// GetUpdateDesc(); the default touches everything, so it always runs alone.
+struct ComponentUpdateDesc {
+    UpdatePhase phase = UpdatePhase::Update;
+    SystemAccess reads = ACCESS_ALL;
+    SystemAccess writes = ACCESS_ALL;
+    bool parallelChunks = false;   // OnUpdate only touches its own component and entity
+};
+
 class Component {
 public:
     Component() : m_entity(nullptr), m_enabled(true) {}
@@ -24,6 +54,9 @@ public:
     // Component type information
     virtual std::string GetTypeName() const = 0;
 
+    // Update scheduling, read by the type's pool
+    static ComponentUpdateDesc GetUpdateDesc() { return ComponentUpdateDesc(); }
+
     // Lifecycle callbacks
     virtual void OnAwake() {}
     virtual void OnStart() {}
@@ -0,0 +1,165 @@
+#include "ComponentPool.h"
+#include "../Core/JobSystem.h"
+#include <algorithm>
+
+namespace GameEngine {
+namespace Scene {
+
+std::uint32_t ComponentPoolBase::IndexOf(EntityID entity) const {
+    std::uint32_t slot = GetEntityIndex(entity);
+    size_t page = slot / SPARSE_PAGE_SIZE;
+    if (page >= m_sparsePages.size() || !m_sparsePages[page]) {
+        return INVALID_INDEX;
+    }
+
+    // The slot may belong to a newer entity than the one asked for
+    std::uint32_t index = m_sparsePages[page][slot % SPARSE_PAGE_SIZE];
+    return (index != INVALID_INDEX && m_dense[index] == entity) ? index : INVALID_INDEX;
+}
+
+void ComponentPoolBase::InsertEntity(EntityID entity) {
+    std::uint32_t slot = GetNextSlot();
+    if (m_freeSlots.empty()) {
+        m_slotCount++;
+    }
+    else {
+        m_freeSlots.pop_back();
+    }
+
+    SetSparse(entity, GetCount());
+    m_dense.push_back(entity);
+    m_slots.push_back(slot);
+}
+
+std::uint32_t ComponentPoolBase::EraseEntity(EntityID entity) {
+    std::uint32_t index = IndexOf(entity);
+    if (index == INVALID_INDEX) {
+        return INVALID_INDEX;
+    }
+
+    std::uint32_t slot = m_slots[index];
+    m_freeSlots.push_back(slot);
+
+    // Keep the dense arrays packed; components themselves stay put
+    EntityID last = m_dense.back();
+    m_dense[index] = last;
+    m_slots[index] = m_slots.back();
+    SetSparse(last, index);
+
+    m_dense.pop_back();
+    m_slots.pop_back();
+    SetSparse(entity, INVALID_INDEX);
+    return slot;
+}
+
+void ComponentPoolBase::ClearEntities() {
+    m_dense.clear();
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_slotCount = 0;
+    m_sparsePages.clear();
+}
+
+void ComponentPoolBase::SetSparse(EntityID entity, std::uint32_t index) {
+    std::uint32_t slot = GetEntityIndex(entity);
+    size_t page = slot / SPARSE_PAGE_SIZE;
+    if (page >= m_sparsePages.size()) {
+        m_sparsePages.resize(page + 1);
+    }
+
+    if (!m_sparsePages[page]) {
+        m_sparsePages[page] = std::make_unique<std::uint32_t[]>(SPARSE_PAGE_SIZE);
+        std::fill_n(m_sparsePages[page].get(), SPARSE_PAGE_SIZE, INVALID_INDEX);
+    }
+
+    m_sparsePages[page][slot % SPARSE_PAGE_SIZE] = index;
+}
+
+void ComponentRegistry::RemoveAll(EntityID entity) {
+    for (auto& pool : m_pools) {
+        if (pool) {
+            pool->Remove(entity);
+        }
+    }
+}
+
+void ComponentRegistry::Clear() {
+    for (auto& pool : m_pools) {
+        if (pool) {
+            pool->Clear();
+        }
+    }
+}
+
+namespace {
+
+bool AccessConflicts(const ComponentUpdateDesc& a, const ComponentUpdateDesc& b) {
+    return (a.writes & (b.reads | b.writes)) != 0 || (b.writes & a.reads) != 0;
+}
+
+} // namespace
+
+void ComponentRegistry::RunPhase(UpdatePhase phase, float deltaTime, bool parallel, std::uint32_t batchSize) {
+    m_phasePools.clear();
+    for (auto& pool : m_pools) {
+        if (pool && pool->GetCount() > 0 && pool->GetUpdateDesc().phase == phase) {
+            m_phasePools.push_back(pool.get());
+        }
+    }
+
+    // One linear pass per component type
+    if (!parallel) {
+        for (ComponentPoolBase* pool : m_phasePools) {
+            pool->UpdateAll(deltaTime);
+        }
+        return;
+    }
+
+    size_t waveBegin = 0;
+    while (waveBegin < m_phasePools.size()) {
+        // Grow the wave until the next pool conflicts with one already in it
+        size_t waveEnd = waveBegin + 1;
+        for (; waveEnd < m_phasePools.size(); waveEnd++) {
+            const ComponentUpdateDesc& next = m_phasePools[waveEnd]->GetUpdateDesc();
+            bool conflict = false;
+            for (size_t i = waveBegin; i < waveEnd && !conflict; i++) {
+                conflict = AccessConflicts(m_phasePools[i]->GetUpdateDesc(), next);
+            }
+            if (conflict) {
+                break;
+            }
+        }
+
+        RunWave(waveBegin, waveEnd, deltaTime, batchSize);
+        waveBegin = waveEnd;
+    }
+}
+
+void ComponentRegistry::RunWave(size_t begin, size_t end, float deltaTime, std::uint32_t batchSize) {
+    // A lone serial pool keeps UpdateAll's handling of components added mid-update
+    if (end - begin == 1 && !m_phasePools[begin]->GetUpdateDesc().parallelChunks) {
+        m_phasePools[begin]->UpdateAll(deltaTime);
+        return;
+    }
+
+    batchSize = std::max(batchSize, 1u);
+    m_work.clear();
+    for (size_t i = begin; i < end; i++) {
+        ComponentPoolBase* pool = m_phasePools[i];
+        std::uint32_t count = pool->GetCount();
+        std::uint32_t chunk = pool->GetUpdateDesc().parallelChunks ? batchSize : count;
+        for (std::uint32_t first = 0; first < count; first += chunk) {
+            m_work.push_back({ pool, first, std::min(first + chunk, count) });
+        }
+    }
+
+    JOB_SYSTEM.ParallelFor(static_cast<std::uint32_t>(m_work.size()),
+        [this, deltaTime](std::uint32_t first, std::uint32_t last) {
+            for (std::uint32_t i = first; i < last; i++) {
+                m_work[i].pool->UpdateRange(m_work[i].begin, m_work[i].end, deltaTime);
+            }
+        }, 1);
+}
+
+} // namespace Scene
+} // namespace GameEngine
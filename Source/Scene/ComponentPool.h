@@ -0,0 +1,321 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Component.h"
+
+namespace GameEngine {
+namespace Scene {
+
+// Entity IDs are generational handles: the low bits pick a slot in the
+// scene and the high bits count how often that slot has been reused, so an
+// ID kept past its entity's destruction no longer resolves. Generations
+// start at 1, which keeps 0 free for INVALID_ENTITY_ID.
+using EntityID = std::uint32_t;
+using ComponentTypeID = std::uint32_t;
+
+constexpr std::uint32_t ENTITY_INDEX_BITS = 20;
+constexpr std::uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr std::uint32_t ENTITY_GENERATION_MASK = 0xFFFFFFFFu >> ENTITY_INDEX_BITS;
+
+constexpr std::uint32_t GetEntityIndex(EntityID id) { return id & ENTITY_INDEX_MASK; }
+constexpr std::uint32_t GetEntityGeneration(EntityID id) { return id >> ENTITY_INDEX_BITS; }
+constexpr EntityID MakeEntityID(std::uint32_t index, std::uint32_t generation) {
+    return (generation << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
+// Sequential per-type IDs so pools can live in a flat array
+inline ComponentTypeID NextComponentTypeID() {
+    static ComponentTypeID s_nextID = 0;
+    return s_nextID++;
+}
+
+template<typename T>
+ComponentTypeID GetComponentTypeID() {
+    static const ComponentTypeID s_id = NextComponentTypeID();
+    return s_id;
+}
+
+// Sparse set mapping entity IDs to dense indices. The sparse side is indexed
+// by the ID's slot and paged so scattered slots only allocate the pages they
+// touch; the dense side stores full IDs so a stale generation misses.
+class ComponentPoolBase {
+public:
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    ComponentPoolBase() = default;
+    virtual ~ComponentPoolBase() = default;
+
+    ComponentPoolBase(const ComponentPoolBase&) = delete;
+    ComponentPoolBase& operator=(const ComponentPoolBase&) = delete;
+
+    bool Contains(EntityID entity) const { return IndexOf(entity) != INVALID_INDEX; }
+    std::uint32_t IndexOf(EntityID entity) const;
+
+    std::uint32_t GetCount() const { return static_cast<std::uint32_t>(m_dense.size()); }
+    EntityID GetEntityAt(std::uint32_t index) const { return m_dense[index]; }
+
+    // Type-erased access used by Entity and Scene
+    virtual Component* GetComponentAt(std::uint32_t index) = 0;
+    virtual bool Remove(EntityID entity) = 0;
+    virtual void Clear() = 0;
+
+    // Update every enabled component on an active entity in dense order
+    virtual void UpdateAll(float deltaTime) = 0;
+    // Same for the dense range [begin, end); the count must not change meanwhile
+    virtual void UpdateRange(std::uint32_t begin, std::uint32_t end, float deltaTime) = 0;
+
+    const ComponentUpdateDesc& GetUpdateDesc() const { return m_updateDesc; }
+
+    Component* GetComponent(EntityID entity) {
+        std::uint32_t index = IndexOf(entity);
+        return index != INVALID_INDEX ? GetComponentAt(index) : nullptr;
+    }
+
+protected:
+    static constexpr std::uint32_t SPARSE_PAGE_SIZE = 4096;
+
+    // Storage slot the next InsertEntity takes: a freed one, else a new one
+    std::uint32_t GetNextSlot() const { return m_freeSlots.empty() ? m_slotCount : m_freeSlots.back(); }
+    std::uint32_t GetSlot(std::uint32_t index) const { return m_slots[index]; }
+
+    // Appends a dense entry using GetNextSlot()
+    void InsertEntity(EntityID entity);
+    // Swap-and-pop of the dense entry; returns its storage slot, now free
+    std::uint32_t EraseEntity(EntityID entity);
+    void ClearEntities();
+
+    void SetSparse(EntityID entity, std::uint32_t index);
+
+    std::vector<EntityID> m_dense;
+    std::vector<std::uint32_t> m_slots;         // Storage slot of each dense entry
+    std::vector<std::uint32_t> m_freeSlots;
+    std::uint32_t m_slotCount = 0;
+    std::vector<std::unique_ptr<std::uint32_t[]>> m_sparsePages;
+
+    ComponentUpdateDesc m_updateDesc;
+};
+
+// Storage for one component type. Components are stored by value in
+// fixed-size pages and never move, so pointers stay valid until their own
+// component is removed. The dense index array stays packed for iteration;
+// removal swaps the last index into the hole and the component's slot is
+// reused by the next Emplace.
+template<typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    static_assert(std::is_base_of_v<Component, T>, "T must derive from Component");
+
+    ComponentPool() { m_updateDesc = T::GetUpdateDesc(); }
+    ~ComponentPool() override { Clear(); }
+
+    template<typename... Args>
+    T* Emplace(EntityID entity, Args&&... args);
+
+    T* Get(EntityID entity) {
+        std::uint32_t index = IndexOf(entity);
+        return index != INVALID_INDEX ? At(index) : nullptr;
+    }
+
+    T* At(std::uint32_t index) { return AtSlot(GetSlot(index)); }
+
+    Component* GetComponentAt(std::uint32_t index) override { return At(index); }
+    bool Remove(EntityID entity) override;
+    void Clear() override;
+
+    void UpdateAll(float deltaTime) override;
+    void UpdateRange(std::uint32_t begin, std::uint32_t end, float deltaTime) override;
+
+    // Visit components in dense order
+    template<typename Func>
+    void ForEach(Func func);
+
+private:
+    static constexpr std::uint32_t PAGE_SIZE = 256;
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+    T* AtSlot(std::uint32_t slot) {
+        return std::launder(reinterpret_cast<T*>(&m_pages[slot / PAGE_SIZE][slot % PAGE_SIZE]));
+    }
+
+    std::vector<std::unique_ptr<Storage[]>> m_pages;
+};
+
+// One pool per component type, indexed by ComponentTypeID
+class ComponentRegistry {
+public:
+    ComponentRegistry() = default;
+    ~ComponentRegistry() = default;
+
+    ComponentRegistry(const ComponentRegistry&) = delete;
+    ComponentRegistry& operator=(const ComponentRegistry&) = delete;
+
+    // Creates the pool on first use
+    template<typename T>
+    ComponentPool<T>& GetOrCreatePool();
+
+    // nullptr if no component of this type was ever added
+    template<typename T>
+    ComponentPool<T>* GetPool() const;
+
+    ComponentPoolBase* GetPool(ComponentTypeID typeID) const {
+        return typeID < m_pools.size() ? m_pools[typeID].get() : nullptr;
+    }
+
+    template<typename T>
+    T* Get(EntityID entity) const {
+        ComponentPool<T>* pool = GetPool<T>();
+        return pool ? pool->Get(entity) : nullptr;
+    }
+
+    // Visit every component owned by an entity, across all pools
+    template<typename Func>
+    void ForEachComponentOf(EntityID entity, Func func) const;
+
+    void RemoveAll(EntityID entity);
+    void Clear();
+
+    // Update every pool whose type runs in the phase. Serially, pools run in
+    // type ID order. In parallel, consecutive pools without conflicting
+    // access form a wave; each wave is spread over the job system (split
+    // into chunks of batchSize for parallelChunks types) and finishes
+    // before the next starts, so conflicting types keep their serial order.
+    void RunPhase(UpdatePhase phase, float deltaTime, bool parallel, std::uint32_t batchSize);
+
+    size_t GetPoolCount() const { return m_pools.size(); }
+
+private:
+    struct UpdateWork {
+        ComponentPoolBase* pool;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    void RunWave(size_t begin, size_t end, float deltaTime, std::uint32_t batchSize);
+
+    std::vector<std::unique_ptr<ComponentPoolBase>> m_pools;
+
+    // Scratch for RunPhase, reused across frames
+    std::vector<ComponentPoolBase*> m_phasePools;
+    std::vector<UpdateWork> m_work;
+};
+
+// ---------------------------------------------------------------------------
+// Template implementations
+
+namespace Internal {
+    // Enabled and owned by an active, live entity; defined in Entity.h
+    inline bool IsComponentRunnable(const Component* component);
+}
+
+template<typename T>
+template<typename... Args>
+T* ComponentPool<T>::Emplace(EntityID entity, Args&&... args) {
+    if (Contains(entity)) {
+        return nullptr;
+    }
+
+    std::uint32_t slot = GetNextSlot();
+    if (slot / PAGE_SIZE >= m_pages.size()) {
+        m_pages.push_back(std::make_unique<Storage[]>(PAGE_SIZE));
+    }
+
+    T* component = new (&m_pages[slot / PAGE_SIZE][slot % PAGE_SIZE]) T(std::forward<Args>(args)...);
+    InsertEntity(entity);
+    return component;
+}
+
+template<typename T>
+bool ComponentPool<T>::Remove(EntityID entity) {
+    std::uint32_t index = IndexOf(entity);
+    if (index == INVALID_INDEX) {
+        return false;
+    }
+
+    // Other components stay where they are; only the dense index moves
+    At(index)->~T();
+    EraseEntity(entity);
+    return true;
+}
+
+template<typename T>
+void ComponentPool<T>::Clear() {
+    std::uint32_t count = GetCount();
+    for (std::uint32_t i = 0; i < count; i++) {
+        At(i)->~T();
+    }
+
+    ClearEntities();
+    m_pages.clear();
+}
+
+template<typename T>
+void ComponentPool<T>::UpdateAll(float deltaTime) {
+    // Re-read the count so components added during the update are visited
+    for (std::uint32_t i = 0; i < GetCount(); i++) {
+        T* component = At(i);
+        if (Internal::IsComponentRunnable(component)) {
+            component->OnUpdate(deltaTime);
+        }
+    }
+}
+
+template<typename T>
+void ComponentPool<T>::UpdateRange(std::uint32_t begin, std::uint32_t end, float deltaTime) {
+    for (std::uint32_t i = begin; i < end; i++) {
+        T* component = At(i);
+        if (Internal::IsComponentRunnable(component)) {
+            component->OnUpdate(deltaTime);
+        }
+    }
+}
+
+template<typename T>
+template<typename Func>
+void ComponentPool<T>::ForEach(Func func) {
+    for (std::uint32_t i = 0; i < GetCount(); i++) {
+        func(*At(i));
+    }
+}
+
+template<typename T>
+ComponentPool<T>& ComponentRegistry::GetOrCreatePool() {
+    ComponentTypeID typeID = GetComponentTypeID<T>();
+    if (typeID >= m_pools.size()) {
+        m_pools.resize(static_cast<size_t>(typeID) + 1);
+    }
+
+    if (!m_pools[typeID]) {
+        m_pools[typeID] = std::make_unique<ComponentPool<T>>();
+    }
+
+    return *static_cast<ComponentPool<T>*>(m_pools[typeID].get());
+}
+
+template<typename T>
+ComponentPool<T>* ComponentRegistry::GetPool() const {
+    ComponentTypeID typeID = GetComponentTypeID<T>();
+    if (typeID >= m_pools.size()) {
+        return nullptr;
+    }
+    return static_cast<ComponentPool<T>*>(m_pools[typeID].get());
+}
+
+template<typename Func>
+void ComponentRegistry::ForEachComponentOf(EntityID entity, Func func) const {
+    for (const auto& pool : m_pools) {
+        if (pool) {
+            Component* component = pool->GetComponent(entity);
+            if (component) {
+                func(component);
+            }
+        }
+    }
+}
+
+} // namespace Scene
+} // namespace GameEngine
@@ -7,17 +7,24 @@
 namespace GameEngine {
 namespace Scene {
 
-Entity::Entity(EntityID id, const std::string& name)
+Entity::Entity(EntityID id, const std::string& name, Core::PoolAllocator<Transform>* transformPool)
     : m_id(id)
     , m_name(name)
+    , m_tags(0)
     , m_active(true)
     , m_destroyed(false)
     , m_started(false)
+    , m_componentRegistry(nullptr)
     , m_parent(nullptr)
     , m_scene(nullptr)
+    , m_spatialProxy(INVALID_SPATIAL_PROXY)
+    , m_nameIndex(EntityLookup::INVALID_INDEX)
+    , m_snapshotDirty(false)
 {
     // Every entity has a transform component
-    m_transform = std::make_unique<Transform>();
+    Transform* transform = transformPool ? transformPool->Create() : new Transform();
+    m_transform = std::unique_ptr<Transform, Core::PoolDeleter<Transform>>(
+        transform, Core::PoolDeleter<Transform>{ transformPool });
     m_transform->SetEntity(this);
 
     LOG_DEBUG("Entity created: " << m_name << " (ID: " << m_id << ")");
@@ -31,10 +38,13 @@ Entity::~Entity() {
         m_parent->RemoveChild(this);
     }
 
-    // Destroy all children
+    // Destroy all children and detach them, they may outlive this entity
     for (auto child : m_children) {
-        if (child && !child->IsDestroyed()) {
-            child->Destroy();
+        if (child) {
+            if (!child->IsDestroyed()) {
+                child->Destroy();
+            }
+            child->m_parent = nullptr;
         }
     }
 
@@ -42,10 +52,38 @@ Entity::~Entity() {
     RemoveAllComponents();
 }
 
+void Entity::SetName(const std::string& name) {
+    // Re-bucket under the new name if the scene has this entity indexed
+    bool indexed = m_scene && m_scene->m_entityLookup.Contains(this);
+    if (indexed) {
+        m_scene->m_entityLookup.RemoveName(this);
+    }
+
+    m_name = name;
+
+    if (indexed) {
+        m_scene->m_entityLookup.AddName(this);
+    }
+    MarkSnapshotDirty();
+}
+
+void Entity::SetTags(TagMask tags) {
+    TagMask oldTags = m_tags;
+    m_tags = tags;
+
+    if (m_scene && oldTags != tags && m_scene->m_entityLookup.Contains(this)) {
+        m_scene->m_entityLookup.UpdateTags(this, oldTags);
+    }
+    if (oldTags != tags) {
+        MarkSnapshotDirty();
+    }
+}
+
 void Entity::SetActive(bool active) {
     if (m_active != active) {
         m_active = active;
         SetActiveRecursive(active);
+        MarkSnapshotDirty();
     }
 }
 
@@ -53,6 +91,11 @@ void Entity::Destroy() {
     if (!m_destroyed) {
         m_destroyed = true;
         OnDestroy();
+
+        // Removed by the scene at the start of its next update
+        if (m_scene) {
+            m_scene->m_pendingDestroy.push(m_id);
+        }
         DestroyRecursive();
 
         LOG_DEBUG("Entity marked for destruction: " << m_name);
@@ -62,6 +105,8 @@ void Entity::Destroy() {
 void Entity::SetParent(Entity* parent) {
     if (m_parent == parent) return;
 
+    MarkSnapshotDirty();
+
     // Remove from current parent
     if (m_parent) {
         m_parent->RemoveChild(this);
@@ -75,8 +120,10 @@ void Entity::SetParent(Entity* parent) {
         m_parent->AddChild(this);
     }
 
-    // Update transform hierarchy
+    // Update transform hierarchy; the whole subtree moves, so every
+    // descendant gets its spatial proxy refreshed too
     if (m_transform) {
+        m_transform->MarkWorldMatrixDirty();
         m_transform->MarkDirty();
     }
 }
@@ -152,18 +199,18 @@ std::vector<Entity*> Entity::GetChildrenRecursive() const {
 }
 
 void Entity::RemoveAllComponents() {
-    // Notify components before removal
-    for (auto& [type, components] : m_components) {
-        for (auto& component : components) {
-            if (component) {
-                OnComponentRemoved(component.get());
-                component->OnDestroy();
-            }
-        }
+    if (!m_componentRegistry) {
+        return;
     }
 
-    // Clear all components
-    m_components.clear();
+    // Notify components before removal
+    m_componentRegistry->ForEachComponentOf(m_id, [this](Component* component) {
+        OnComponentRemoved(component);
+        component->OnDestroy();
+    });
+
+    // Free this entity's slot in every pool
+    m_componentRegistry->RemoveAll(m_id);
 }
 
 void Entity::SetActiveRecursive(bool active) {
@@ -184,5 +231,17 @@ void Entity::DestroyRecursive() {
     }
 }
 
+void Entity::MarkSnapshotDirty() {
+    if (m_scene) {
+        m_scene->MarkSnapshotDirty(this);
+    }
+}
+
+void Entity::MarkBoundsDirty() {
+    if (m_scene) {
+        m_scene->MarkBoundsDirty(this);
+    }
+}
+
 } // namespace Scene
 } // namespace GameEngine
@@ -2,9 +2,12 @@
 
 #include <memory>
 #include <vector>
-#include <unordered_map>
-#include <typeindex>
 #include <string>
+#include <typeinfo>
+#include "ComponentPool.h"
+#include "EntityLookup.h"
+#include "../Core/Logger.h"
+#include "../Core/PoolAllocator.h"
 #include "../Math/Vector3.h"
 #include "../Math/Matrix4.h"
 
@@ -16,18 +19,29 @@ class Component;
 class Transform;
 class Scene;
 
-using EntityID = std::uint32_t;
 constexpr EntityID INVALID_ENTITY_ID = 0;
 
+using SpatialProxyID = std::int32_t;
+constexpr SpatialProxyID INVALID_SPATIAL_PROXY = -1;
+
 class Entity {
 public:
-    Entity(EntityID id, const std::string& name = "Entity");
+    // The transform comes from transformPool when given, otherwise the heap
+    Entity(EntityID id, const std::string& name = "Entity",
+           Core::PoolAllocator<Transform>* transformPool = nullptr);
     virtual ~Entity();
 
     // Entity identification
     EntityID GetID() const { return m_id; }
     const std::string& GetName() const { return m_name; }
-    void SetName(const std::string& name) { m_name = name; }
+    void SetName(const std::string& name);
+
+    // Tags, kept in the owning scene's tag index
+    TagMask GetTags() const { return m_tags; }
+    void SetTags(TagMask tags);
+    void AddTags(TagMask tags) { SetTags(m_tags | tags); }
+    void RemoveTags(TagMask tags) { SetTags(m_tags & ~tags); }
+    bool HasTags(TagMask tags) const { return (m_tags & tags) == tags; }
 
     // Entity state
     bool IsActive() const { return m_active; }
@@ -39,7 +53,9 @@ public:
     // Transform access (every entity has a transform)
     Transform* GetTransform() const { return m_transform.get(); }
 
-    // Component management
+    // Component management. An entity holds at most one component of each
+    // type; adding a second returns the existing one. Entities outside a
+    // scene keep their components in a registry of their own.
     template<typename T, typename... Args>
     T* AddComponent(Args&&... args);
 
@@ -54,7 +70,7 @@ public:
 
     void RemoveAllComponents();
 
-    // Get all components of a specific type
+    // Get all components of a specific type (at most one per entity)
     template<typename T>
     std::vector<T*> GetComponents() const;
 
@@ -88,26 +104,41 @@ public:
 protected:
     EntityID m_id;
     std::string m_name;
+    TagMask m_tags;
     bool m_active;
     bool m_destroyed;
     bool m_started;
 
     // Transform component (always present)
-    std::unique_ptr<Transform> m_transform;
+    std::unique_ptr<Transform, Core::PoolDeleter<Transform>> m_transform;
 
-    // Component storage
-    std::unordered_map<std::type_index, std::vector<std::unique_ptr<Component>>> m_components;
+    // Components live in the owning scene's pools, or m_ownComponents when
+    // the entity is not in a scene
+    ComponentRegistry* m_componentRegistry;
+    std::unique_ptr<ComponentRegistry> m_ownComponents;
 
     // Hierarchy
     Entity* m_parent;
     std::vector<Entity*> m_children;
     Scene* m_scene;
 
+    // Leaf in the owning scene's spatial index
+    SpatialProxyID m_spatialProxy;
+
+    // Position in the owning scene's name bucket
+    std::uint32_t m_nameIndex;
+
+    // Already queued for the scene's next incremental save
+    bool m_snapshotDirty;
+
     // Internal methods
     void SetActiveRecursive(bool active);
     void DestroyRecursive();
+    void MarkSnapshotDirty();
+    void MarkBoundsDirty();
 
     friend class Scene;
+    friend class EntityLookup;
 };
 
 // Template implementations
@@ -115,32 +146,34 @@ template<typename T, typename... Args>
 T* Entity::AddComponent(Args&&... args) {
     static_assert(std::is_base_of_v<Component, T>, "T must derive from Component");
 
-    auto component = std::make_unique<T>(std::forward<Args>(args)...);
-    T* componentPtr = component.get();
+    if (!m_componentRegistry) {
+        m_ownComponents = std::make_unique<ComponentRegistry>();
+        m_componentRegistry = m_ownComponents.get();
+    }
+
+    // Pools hold one component of each type per entity
+    ComponentPool<T>& pool = m_componentRegistry->GetOrCreatePool<T>();
+    if (pool.Contains(m_id)) {
+        LOG_WARNING("Entity " << m_name << " already has a " << typeid(T).name());
+        return pool.Get(m_id);
+    }
+
+    T* componentPtr = pool.Emplace(m_id, std::forward<Args>(args)...);
 
     // Set component's entity reference
     componentPtr->SetEntity(this);
 
-    // Store component
-    auto typeIndex = std::type_index(typeid(T));
-    m_components[typeIndex].push_back(std::move(component));
-
     // Notify
     OnComponentAdded(componentPtr);
+    MarkSnapshotDirty();
+    MarkBoundsDirty();
 
     return componentPtr;
 }
 
 template<typename T>
 T* Entity::GetComponent() const {
-    auto typeIndex = std::type_index(typeid(T));
-    auto it = m_components.find(typeIndex);
-
-    if (it != m_components.end() && !it->second.empty()) {
-        return static_cast<T*>(it->second[0].get());
-    }
-
-    return nullptr;
+    return m_componentRegistry ? m_componentRegistry->Get<T>(m_id) : nullptr;
 }
 
 template<typename T>
@@ -150,44 +183,38 @@ bool Entity::HasComponent() const {
 
 template<typename T>
 bool Entity::RemoveComponent() {
-    auto typeIndex = std::type_index(typeid(T));
-    auto it = m_components.find(typeIndex);
-
-    if (it != m_components.end() && !it->second.empty()) {
-        Component* component = it->second[0].get();
-
-        // Notify before removal
-        OnComponentRemoved(component);
-
-        // Remove component
-        it->second.erase(it->second.begin());
-
-        // Remove empty entry
-        if (it->second.empty()) {
-            m_components.erase(it);
-        }
-
-        return true;
+    T* component = GetComponent<T>();
+    if (!component) {
+        return false;
     }
 
-    return false;
+    // Notify before removal
+    OnComponentRemoved(component);
+    MarkSnapshotDirty();
+
+    bool removed = m_componentRegistry->GetPool<T>()->Remove(m_id);
+    MarkBoundsDirty();
+    return removed;
 }
 
 template<typename T>
 std::vector<T*> Entity::GetComponents() const {
     std::vector<T*> components;
-    auto typeIndex = std::type_index(typeid(T));
-    auto it = m_components.find(typeIndex);
-
-    if (it != m_components.end()) {
-        components.reserve(it->second.size());
-        for (const auto& component : it->second) {
-            components.push_back(static_cast<T*>(component.get()));
-        }
+
+    T* component = GetComponent<T>();
+    if (component) {
+        components.push_back(component);
     }
 
     return components;
 }
 
+namespace Internal {
+    inline bool IsComponentRunnable(const Component* component) {
+        const Entity* entity = component->GetEntity();
+        return component->IsEnabled() && entity && entity->IsActive() && !entity->IsDestroyed();
+    }
+}
+
 } // namespace Scene
 } // namespace GameEngine
@@ -0,0 +1,132 @@
+#include "EntityLookup.h"
+#include "Entity.h"
+
+namespace GameEngine {
+namespace Scene {
+
+void EntityLookup::Add(Entity* entity) {
+    if (!entity || Contains(entity)) {
+        return;
+    }
+
+    AddName(entity);
+    UpdateTags(entity, 0);
+}
+
+void EntityLookup::Remove(Entity* entity) {
+    if (!entity || !Contains(entity)) {
+        return;
+    }
+
+    TagMask tags = entity->GetTags();
+    for (std::uint32_t bit = 0; bit < MAX_ENTITY_TAGS; bit++) {
+        if (tags & (1u << bit)) {
+            RemoveTag(entity, bit);
+        }
+    }
+    RemoveName(entity);
+}
+
+void EntityLookup::Clear() {
+    for (auto& pair : m_names) {
+        for (Entity* entity : pair.second) {
+            entity->m_nameIndex = INVALID_INDEX;
+        }
+    }
+    m_names.clear();
+
+    for (TagList& list : m_tags) {
+        list.members.clear();
+        list.positions.clear();
+    }
+}
+
+bool EntityLookup::Contains(const Entity* entity) const {
+    return entity->m_nameIndex != INVALID_INDEX;
+}
+
+void EntityLookup::AddName(Entity* entity) {
+    std::vector<Entity*>& bucket = m_names[entity->GetName()];
+    entity->m_nameIndex = static_cast<std::uint32_t>(bucket.size());
+    bucket.push_back(entity);
+}
+
+void EntityLookup::RemoveName(Entity* entity) {
+    auto it = m_names.find(entity->GetName());
+    if (it == m_names.end() || entity->m_nameIndex == INVALID_INDEX) {
+        return;
+    }
+
+    // Move the last entry into the hole
+    std::vector<Entity*>& bucket = it->second;
+    Entity* last = bucket.back();
+    bucket[entity->m_nameIndex] = last;
+    last->m_nameIndex = entity->m_nameIndex;
+    bucket.pop_back();
+    entity->m_nameIndex = INVALID_INDEX;
+
+    if (bucket.empty()) {
+        m_names.erase(it);
+    }
+}
+
+void EntityLookup::UpdateTags(Entity* entity, TagMask oldTags) {
+    TagMask newTags = entity->GetTags();
+    TagMask changed = oldTags ^ newTags;
+    for (std::uint32_t bit = 0; bit < MAX_ENTITY_TAGS; bit++) {
+        TagMask mask = 1u << bit;
+        if (!(changed & mask)) {
+            continue;
+        }
+        if (newTags & mask) {
+            AddTag(entity, bit);
+        }
+        else {
+            RemoveTag(entity, bit);
+        }
+    }
+}
+
+const std::vector<Entity*>* EntityLookup::FindByName(const std::string& name) const {
+    auto it = m_names.find(name);
+    return it != m_names.end() ? &it->second : nullptr;
+}
+
+const std::vector<Entity*>* EntityLookup::GetSmallestTagList(TagMask tags) const {
+    const std::vector<Entity*>* smallest = nullptr;
+    for (std::uint32_t bit = 0; bit < MAX_ENTITY_TAGS; bit++) {
+        if ((tags & (1u << bit)) && (!smallest || m_tags[bit].members.size() < smallest->size())) {
+            smallest = &m_tags[bit].members;
+        }
+    }
+    return smallest;
+}
+
+void EntityLookup::AddTag(Entity* entity, std::uint32_t bit) {
+    TagList& list = m_tags[bit];
+    std::uint32_t slot = GetEntityIndex(entity->GetID());
+    if (slot >= list.positions.size()) {
+        list.positions.resize(slot + 1, INVALID_INDEX);
+    }
+
+    list.positions[slot] = static_cast<std::uint32_t>(list.members.size());
+    list.members.push_back(entity);
+}
+
+void EntityLookup::RemoveTag(Entity* entity, std::uint32_t bit) {
+    TagList& list = m_tags[bit];
+    std::uint32_t slot = GetEntityIndex(entity->GetID());
+    if (slot >= list.positions.size() || list.positions[slot] == INVALID_INDEX) {
+        return;
+    }
+
+    std::uint32_t position = list.positions[slot];
+    Entity* last = list.members.back();
+    list.members[position] = last;
+    list.positions[GetEntityIndex(last->GetID())] = position;
+    list.members.pop_back();
+    list.positions[slot] = INVALID_INDEX;
+}
+
+} // namespace Scene
+} // namespace GameEngine
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace GameEngine {
+namespace Scene {
+
+class Entity;
+
+// Gameplay categories or layers, one bit each
+using TagMask = std::uint32_t;
+constexpr std::uint32_t MAX_ENTITY_TAGS = 32;
+
+// Incrementally maintained name and tag indices for a scene.
+//
+// Each name maps to a bucket of entities and each tag bit keeps its own
+// member list. Entities remember their bucket position (and the tag lists
+// remember theirs by entity slot), so registration, renames and tag changes
+// are O(1) swap-and-pop updates and a query only touches its result.
+class EntityLookup {
+public:
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    EntityLookup() = default;
+    ~EntityLookup() = default;
+
+    EntityLookup(const EntityLookup&) = delete;
+    EntityLookup& operator=(const EntityLookup&) = delete;
+
+    // Registration; Add indexes the entity's current name and tags
+    void Add(Entity* entity);
+    void Remove(Entity* entity);
+    void Clear();
+
+    bool Contains(const Entity* entity) const;
+
+    // Called by Entity around a rename and after its tags change
+    void RemoveName(Entity* entity);
+    void AddName(Entity* entity);
+    void UpdateTags(Entity* entity, TagMask oldTags);
+
+    // Entities with this name in no particular order, including ones pending
+    // destruction; nullptr when there are none
+    const std::vector<Entity*>* FindByName(const std::string& name) const;
+
+    // Members of the tag bit in the mask with the fewest members, or nullptr
+    // when the mask is empty; callers filter by the full mask
+    const std::vector<Entity*>* GetSmallestTagList(TagMask tags) const;
+
+private:
+    struct TagList {
+        std::vector<Entity*> members;
+        std::vector<std::uint32_t> positions;   // By entity slot index
+    };
+
+    void AddTag(Entity* entity, std::uint32_t bit);
+    void RemoveTag(Entity* entity, std::uint32_t bit);
+
+    std::unordered_map<std::string, std::vector<Entity*>> m_names;
+    TagList m_tags[MAX_ENTITY_TAGS];
+};
+
+} // namespace Scene
+} // namespace GameEngine
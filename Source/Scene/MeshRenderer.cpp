@@ -1,20 +1,44 @@
 #include "MeshRenderer.h"
 #include "Entity.h"
 #include "Transform.h"
+#include "Scene.h"
 #include "../Renderer/D3D11Renderer.h"
+#include "../Renderer/RenderQueue.h"
+#include "../Animation/AnimationController.h"
 #include "../Core/Logger.h"
 
 namespace GameEngine {
 namespace Scene {
 
+namespace {
+
+// Fraction a switch threshold must be crossed by before the LOD changes
+constexpr float LOD_HYSTERESIS = 0.1f;
+
+} // namespace
+
 MeshRenderer::MeshRenderer()
     : m_mesh(nullptr)
     , m_material(nullptr)
     , m_castShadows(true)
     , m_receiveShadows(true)
+    , m_static(false)
+    , m_gpuDriven(false)
+    , m_occluder(false)
+    , m_hasOccluderBox(false)
+    , m_lod(0)
 {
 }
 
+void MeshRenderer::SetMesh(std::shared_ptr<Mesh::Mesh> mesh) {
+    m_mesh = mesh;
+
+    Entity* entity = GetEntity();
+    if (entity && entity->GetScene()) {
+        entity->GetScene()->MarkBoundsDirty(entity);
+    }
+}
+
 void MeshRenderer::OnStart() {
     LOG_DEBUG("MeshRenderer started for entity: " << (GetEntity() ? GetEntity()->GetName() : "Unknown"));
 }
@@ -39,20 +63,111 @@ void MeshRenderer::Render(Renderer::D3D11Renderer* renderer) {
         return;
     }
 
-    // Get world matrix from transform
-    DirectX::XMMATRIX worldMatrix = transform->GetWorldMatrix();
+    // Drawn where it is between fixed simulation steps
+    DirectX::XMMATRIX worldMatrix = transform->GetRenderMatrix();
+
+    // Component material overrides the per-submesh materials
+    m_mesh->Render(renderer, worldMatrix, m_material.get());
+}
 
-    // Use material if available, otherwise use default material from mesh
-    std::shared_ptr<Mesh::Material> materialToUse = m_material ? m_material : m_mesh->GetMaterial();
+bool MeshRenderer::GetWorldBounds(DirectX::BoundingOrientedBox& bounds) const {
+    if (!m_mesh || !m_mesh->IsLoaded()) {
+        return false;
+    }
 
-    // Set material properties before rendering
-    if (materialToUse) {
-        // Apply material properties to renderer (this would need to be implemented)
-        // For now, just render the mesh
+    Entity* entity = GetEntity();
+    Transform* transform = entity ? entity->GetTransform() : nullptr;
+    if (!transform) {
+        return false;
     }
 
-    // Render the mesh with the world transform
-    m_mesh->Render(renderer, worldMatrix);
+    DirectX::BoundingOrientedBox localBounds;
+    DirectX::BoundingOrientedBox::CreateFromBoundingBox(localBounds, m_mesh->GetBoundingBox());
+    localBounds.Transform(bounds, transform->GetWorldMatrix());
+    return true;
+}
+
+bool MeshRenderer::GetOccluderBounds(DirectX::BoundingOrientedBox& bounds) const {
+    if (!m_hasOccluderBox) {
+        return GetWorldBounds(bounds);
+    }
+
+    Entity* entity = GetEntity();
+    Transform* transform = entity ? entity->GetTransform() : nullptr;
+    if (!transform) {
+        return false;
+    }
+
+    DirectX::BoundingOrientedBox localBounds;
+    DirectX::BoundingOrientedBox::CreateFromBoundingBox(localBounds, m_occluderBox);
+    localBounds.Transform(bounds, transform->GetWorldMatrix());
+    return true;
+}
+
+void MeshRenderer::Submit(Renderer::RenderQueue& queue) const {
+    if (!IsEnabled() || !m_mesh || !m_mesh->IsLoaded()) {
+        return;
+    }
+
+    Entity* entity = GetEntity();
+    if (!entity || !entity->IsActive()) {
+        return;
+    }
+
+    Transform* transform = entity->GetTransform();
+    if (!transform) {
+        return;
+    }
+
+    // Drawn where it is between fixed simulation steps
+    DirectX::XMMATRIX worldMatrix = transform->GetRenderMatrix();
+
+    // Skinned meshes share one palette allocation across their submeshes
+    std::uint32_t boneOffset = Renderer::BonePalette::INVALID_OFFSET;
+    Renderer::SkinnedVertexOutput* skinnedVertices = nullptr;
+    bool computeSkinning = queue.IsComputeSkinningEnabled() && m_mesh->GetSkinningSourceView();
+    if (m_mesh->IsAnimated() && (queue.IsSkinningEnabled() || computeSkinning)) {
+        Animation::AnimationController* animator = entity->GetComponent<Animation::AnimationController>();
+        if (animator && animator->IsEnabled()) {
+            const auto& bones = animator->GetBoneTransforms();
+            boneOffset = queue.AllocateBones(bones.data(), static_cast<std::uint32_t>(bones.size()));
+        }
+
+        // Skin once into a static vertex stream that every pass reuses
+        if (computeSkinning && boneOffset != Renderer::BonePalette::INVALID_OFFSET) {
+            if (!m_skinnedVertices) {
+                m_skinnedVertices = std::make_shared<Renderer::SkinnedVertexOutput>();
+            }
+            skinnedVertices = m_skinnedVertices.get();
+            queue.QueueSkinning(m_mesh.get(), boneOffset, skinnedVertices);
+        }
+    }
+
+    // Component material overrides the per-submesh materials
+    for (UINT i = 0; i < m_mesh->GetSubMeshCount(); i++) {
+        Mesh::Material* material = m_material ? m_material.get() : m_mesh->GetSubMesh(i).material.get();
+        queue.Submit(m_mesh.get(), i, material, worldMatrix, boneOffset, skinnedVertices, m_lod,
+                     m_staticConstants.IsValid() ? &m_staticConstants : nullptr);
+    }
+}
+
+void MeshRenderer::SelectLOD(float screenSize) const {
+    m_lod = m_mesh ? m_mesh->SelectLOD(screenSize, m_lod, LOD_HYSTERESIS) : 0;
+}
+
+void MeshRenderer::RequestTextureResolution(UINT pixels) const {
+    if (m_material) {
+        m_material->RequestTextureResolution(pixels);
+        return;
+    }
+
+    if (m_mesh) {
+        for (UINT i = 0; i < m_mesh->GetSubMeshCount(); i++) {
+            if (Mesh::Material* material = m_mesh->GetSubMesh(i).material.get()) {
+                material->RequestTextureResolution(pixels);
+            }
+        }
+    }
 }
 
 } // namespace Scene
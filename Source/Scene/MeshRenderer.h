@@ -3,12 +3,18 @@
 #include "Component.h"
 #include "../Mesh/Mesh.h"
 #include "../Mesh/Material.h"
+#include "../Renderer/ConstantBufferRing.h"
 #include <memory>
+#include <DirectXCollision.h>
 
 namespace GameEngine {
 
 // Forward declarations
-namespace Renderer { class D3D11Renderer; }
+namespace Renderer {
+    class D3D11Renderer;
+    class RenderQueue;
+    struct SkinnedVertexOutput;
+}
 
 namespace Scene {
 
@@ -19,9 +25,18 @@ public:
     MeshRenderer();
     virtual ~MeshRenderer() = default;
 
+    static ComponentUpdateDesc GetUpdateDesc() {
+        ComponentUpdateDesc desc;
+        desc.reads = ACCESS_TRANSFORM;
+        desc.writes = ACCESS_RENDERING;
+        desc.parallelChunks = true;
+        return desc;
+    }
+
     // Mesh and material access
     std::shared_ptr<Mesh::Mesh> GetMesh() const { return m_mesh; }
-    void SetMesh(std::shared_ptr<Mesh::Mesh> mesh) { m_mesh = mesh; }
+    // Queues the entity's spatial index bounds for a refresh
+    void SetMesh(std::shared_ptr<Mesh::Mesh> mesh);
 
     std::shared_ptr<Mesh::Material> GetMaterial() const { return m_material; }
     void SetMaterial(std::shared_ptr<Mesh::Material> material) { m_material = material; }
@@ -33,9 +48,50 @@ public:
     bool IsReceivingShadows() const { return m_receiveShadows; }
     void SetReceiveShadows(bool receiveShadows) { m_receiveShadows = receiveShadows; }
 
+    // Static geometry never changes its mesh and is packed into shared
+    // buffers by Scene::BuildStaticBatches
+    bool IsStatic() const { return m_static; }
+    void SetStatic(bool isStatic) { m_static = isStatic; }
+
+    // Occluders are drawn into the scene's software occlusion buffer as a
+    // box and hide the objects behind them. The box defaults to the mesh
+    // bounds; give a smaller one when the mesh does not fill its bounds.
+    bool IsOccluder() const { return m_occluder; }
+    void SetOccluder(bool occluder) { m_occluder = occluder; }
+    void SetOccluderBox(const DirectX::BoundingBox& localBox) { m_occluderBox = localBox; m_hasOccluderBox = true; }
+    bool HasOccluderBox() const { return m_hasOccluderBox; }
+    const DirectX::BoundingBox& GetOccluderBox() const { return m_occluderBox; }
+    bool GetOccluderBounds(DirectX::BoundingOrientedBox& bounds) const;
+
+    // Set by Scene::BuildStaticBatches when the scene's GPU-driven pipeline
+    // draws this renderer; it is then skipped by CPU submission
+    bool IsGPUDriven() const { return m_gpuDriven; }
+    void SetGPUDriven(bool gpuDriven) { m_gpuDriven = gpuDriven; }
+
+    // World constants uploaded once by Scene::BuildStaticBatches; cleared
+    // when the transform changes so the renderer falls back to per-frame
+    // uploads
+    void SetStaticConstants(const Renderer::ConstantBinding& binding) { m_staticConstants = binding; }
+    void ClearStaticConstants() { m_staticConstants = Renderer::ConstantBinding(); }
+    bool HasStaticConstants() const { return m_staticConstants.IsValid(); }
+
     // Render this component
     void Render(Renderer::D3D11Renderer* renderer);
 
+    // World-space oriented bounds of the mesh, false if there is nothing to draw
+    bool GetWorldBounds(DirectX::BoundingOrientedBox& bounds) const;
+
+    // Push one draw packet per submesh into the render queue
+    void Submit(Renderer::RenderQueue& queue) const;
+
+    // Pick the mesh detail level for a projected size (bounding radius over
+    // half the view height); later Submit calls draw that level
+    void SelectLOD(float screenSize) const;
+    UINT GetLOD() const { return m_lod; }
+
+    // Texture streaming feedback for every material this renderer draws with
+    void RequestTextureResolution(UINT pixels) const;
+
     // Component lifecycle
     virtual void OnStart() override;
     virtual void OnUpdate(float deltaTime) override;
@@ -46,6 +102,18 @@ private:
 
     bool m_castShadows;
     bool m_receiveShadows;
+    bool m_static;
+    bool m_gpuDriven;
+    bool m_occluder;
+    bool m_hasOccluderBox;
+    DirectX::BoundingBox m_occluderBox;
+    Renderer::ConstantBinding m_staticConstants;
+
+    // Detail level from the last SelectLOD, kept for hysteresis
+    mutable UINT m_lod;
+
+    // Compute-skinned vertices, created the first time they are needed
+    mutable std::shared_ptr<Renderer::SkinnedVertexOutput> m_skinnedVertices;
 };
 
 } // namespace Scene
@@ -1,15 +1,34 @@
 #include "Scene.h"
 #include "Component.h"
+#include "MeshRenderer.h"
 #include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
+#include "../Core/JobSystem.h"
+#include "../Core/ConfigManager.h"
+#include "../Animation/AnimationController.h"
 #include "../Renderer/D3D11Renderer.h"
+#include "../Core/Profiler.h"
+#include "../Math/SimdBatch.h"
+#include <algorithm>
+#include <limits>
 
 namespace GameEngine {
 namespace Scene {
 
+namespace {
+
+// Moved bounds kept for shadow invalidation before they are merged
+constexpr size_t MAX_MOVED_BOUNDS = 1024;
+
+} // namespace
+
 Scene::Scene(const std::string& name)
     : m_name(name)
     , m_active(true)
-    , m_nextEntityID(1) // Start from 1, 0 is INVALID_ENTITY_ID
+    , m_snapshotTracking(false)
+    , m_frustumCullingEnabled(true)
+    , m_interpolating(false)
+    , m_interpolationAlpha(1.0f)
 {
     LOG_INFO("Scene created: " << m_name);
 }
@@ -25,14 +44,35 @@ Entity* Scene::CreateEntity(const std::string& name) {
 }
 
 Entity* Scene::CreateEntity(EntityID id, const std::string& name) {
+    MEMORY_SCOPE(Scene);
+
+    std::uint32_t index = GetEntityIndex(id);
+    if (GetEntityGeneration(id) == 0) {
+        LOG_ERROR("Invalid entity ID " << id);
+        return nullptr;
+    }
+
+    // Slots an explicit ID skips over become free for generated IDs
+    while (m_entitySlots.size() < index) {
+        m_freeSlots.push_back(static_cast<std::uint32_t>(m_entitySlots.size()));
+        m_entitySlots.emplace_back();
+    }
+    if (index == m_entitySlots.size()) {
+        m_entitySlots.emplace_back();
+    }
+
     // Check if ID is already in use
-    if (m_entityLookup.find(id) != m_entityLookup.end()) {
+    EntitySlot& slot = m_entitySlots[index];
+    if (slot.denseIndex != INVALID_DENSE_INDEX) {
         LOG_ERROR("Entity ID " << id << " is already in use");
         return nullptr;
     }
+    slot.generation = GetEntityGeneration(id);
+    slot.denseIndex = static_cast<std::uint32_t>(m_entities.size());
 
     // Create the entity
-    auto entity = std::make_unique<Entity>(id, name);
+    EntityPtr entity(m_entityPool.Create(id, name, &m_transformPool),
+                     Core::PoolDeleter<Entity>{ &m_entityPool });
     Entity* entityPtr = entity.get();
 
     // Set scene reference
@@ -57,9 +97,8 @@ bool Scene::DestroyEntity(EntityID id) {
 bool Scene::DestroyEntity(Entity* entity) {
     if (!entity) return false;
 
-    // Mark for destruction
+    // Mark for destruction; the entity and its children queue themselves
     entity->Destroy();
-    m_pendingDestroy.push(entity->GetID());
 
     return true;
 }
@@ -74,9 +113,32 @@ void Scene::DestroyAllEntities() {
         }
     }
 
+    // Retire every ID before the destructors run, then free all slots
+    // lowest first
+    m_freeSlots.clear();
+    for (std::uint32_t index = static_cast<std::uint32_t>(m_entitySlots.size()); index-- > 0;) {
+        EntitySlot& slot = m_entitySlots[index];
+        if (slot.denseIndex != INVALID_DENSE_INDEX) {
+            if (m_snapshotTracking) {
+                m_snapshotRemoved.push_back(MakeEntityID(index, slot.generation));
+            }
+            slot.generation = slot.generation == ENTITY_GENERATION_MASK ? 1 : slot.generation + 1;
+            slot.denseIndex = INVALID_DENSE_INDEX;
+        }
+        m_freeSlots.push_back(index);
+    }
+
     // Clear all containers
+    m_transformHierarchy.Clear();
+    m_entityLookup.Clear();
     m_entities.clear();
-    m_entityLookup.clear();
+    m_componentRegistry.Clear();
+    m_spatialIndex.Clear();
+    m_spatialDirty.clear();
+
+    // Every pooled object is gone, so the arenas can go in bulk
+    m_transformPool.Release();
+    m_entityPool.Release();
 
     // Clear pending destroy queue
     while (!m_pendingDestroy.empty()) {
@@ -87,14 +149,31 @@ void Scene::DestroyAllEntities() {
 }
 
 Entity* Scene::FindEntity(EntityID id) const {
-    auto it = m_entityLookup.find(id);
-    return (it != m_entityLookup.end()) ? it->second : nullptr;
+    std::uint32_t index = GetEntityIndex(id);
+    if (index >= m_entitySlots.size()) {
+        return nullptr;
+    }
+
+    // A stale ID carries an older generation than its slot
+    const EntitySlot& slot = m_entitySlots[index];
+    if (slot.denseIndex == INVALID_DENSE_INDEX || slot.generation != GetEntityGeneration(id)) {
+        return nullptr;
+    }
+    return m_entities[slot.denseIndex].get();
+}
+
+bool Scene::IsAlive(EntityID id) const {
+    Entity* entity = FindEntity(id);
+    return entity && !entity->IsDestroyed();
 }
 
 Entity* Scene::FindEntityByName(const std::string& name) const {
-    for (const auto& entity : m_entities) {
-        if (entity && entity->GetName() == name && !entity->IsDestroyed()) {
-            return entity.get();
+    const std::vector<Entity*>* bucket = m_entityLookup.FindByName(name);
+    if (bucket) {
+        for (Entity* entity : *bucket) {
+            if (!entity->IsDestroyed()) {
+                return entity;
+            }
         }
     }
     return nullptr;
@@ -103,9 +182,30 @@ Entity* Scene::FindEntityByName(const std::string& name) const {
 std::vector<Entity*> Scene::FindEntitiesByName(const std::string& name) const {
     std::vector<Entity*> result;
 
-    for (const auto& entity : m_entities) {
-        if (entity && entity->GetName() == name && !entity->IsDestroyed()) {
-            result.push_back(entity.get());
+    const std::vector<Entity*>* bucket = m_entityLookup.FindByName(name);
+    if (bucket) {
+        result.reserve(bucket->size());
+        for (Entity* entity : *bucket) {
+            if (!entity->IsDestroyed()) {
+                result.push_back(entity);
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<Entity*> Scene::FindEntitiesWithTags(TagMask tags) const {
+    std::vector<Entity*> result;
+
+    // Walk the rarest of the requested tags and check the rest per entity
+    const std::vector<Entity*>* members = m_entityLookup.GetSmallestTagList(tags);
+    if (members) {
+        result.reserve(members->size());
+        for (Entity* entity : *members) {
+            if (entity->HasTags(tags) && !entity->IsDestroyed()) {
+                result.push_back(entity);
+            }
         }
     }
 
@@ -127,10 +227,12 @@ std::vector<Entity*> Scene::GetRootEntities() const {
 void Scene::Update(float deltaTime) {
     if (!m_active) return;
 
+    PROFILE_SCOPE("SceneUpdate");
+
     // Process entities pending destruction
     ProcessPendingDestroy();
 
-    // Update all active entities
+    // Entity callbacks, plus a one-time start of each entity's components
     for (const auto& entity : m_entities) {
         if (entity && entity->IsActive() && !entity->IsDestroyed()) {
             // Call OnStart for entities that haven't started yet
@@ -139,45 +241,718 @@ void Scene::Update(float deltaTime) {
                 entity->m_started = true;
 
                 // Start all components
-                for (auto& [type, components] : entity->m_components) {
-                    for (auto& component : components) {
-                        if (component && component->IsEnabled()) {
-                            component->OnStart();
-                        }
+                m_componentRegistry.ForEachComponentOf(entity->GetID(), [](Component* component) {
+                    if (component->IsEnabled()) {
+                        component->OnStart();
                     }
-                }
+                });
             }
 
             // Update entity
             entity->OnUpdate(deltaTime);
+        }
+    }
 
-            // Update all enabled components
-            for (auto& [type, components] : entity->m_components) {
-                for (auto& component : components) {
-                    if (component && component->IsEnabled()) {
-                        component->OnUpdate(deltaTime);
-                    }
+    // Component systems by phase; see ComponentRegistry::RunPhase
+    const Core::EngineSettings& settings = CONFIG_MANAGER.GetEngineSettings();
+    bool parallel = settings.parallelComponentUpdate;
+    std::uint32_t batchSize = static_cast<std::uint32_t>(settings.componentUpdateBatchSize);
+
+    m_componentRegistry.RunPhase(UpdatePhase::PreUpdate, deltaTime, parallel, batchSize);
+
+    // Evaluate animation controllers in parallel; their OnUpdate then no-ops
+    UpdateAnimation(deltaTime);
+
+    m_componentRegistry.RunPhase(UpdatePhase::Update, deltaTime, parallel, batchSize);
+    m_componentRegistry.RunPhase(UpdatePhase::PostUpdate, deltaTime, parallel, batchSize);
+
+    // Propagate world matrices in one pass, then refresh spatial data
+    UpdateTransforms();
+    UpdateSpatialIndex();
+
+    // Systems that follow final world transforms (attachments, cameras)
+    m_componentRegistry.RunPhase(UpdatePhase::LateTransform, deltaTime, parallel, batchSize);
+}
+
+void Scene::FixedUpdate(float fixedDeltaTime) {
+    if (!m_active) return;
+
+    // Settle changes made outside the step so they count as the previous state
+    UpdateTransforms();
+    m_transformHierarchy.StorePreviousWorld();
+    m_interpolating = true;
+
+    Update(fixedDeltaTime);
+}
+
+void Scene::Render(Renderer::D3D11Renderer* renderer) {
+    if (!m_active || !renderer) return;
+
+    PROFILE_SCOPE("SceneRender");
+
+    // Pick up transform changes made since the last update
+    UpdateTransforms();
+    UpdateSpatialIndex();
+
+    // Draw between the last two fixed steps; culling keeps using the latest state
+    if (m_interpolating) {
+        m_transformHierarchy.Interpolate(m_interpolationAlpha, [](std::uint32_t count, const std::function<void(std::uint32_t, std::uint32_t)>& body) {
+            JOB_SYSTEM.ParallelFor(count, body);
+        });
+    }
+
+    // Cached shadows only need redrawing where something moved
+    Renderer::ShadowAtlas& shadowAtlas = renderer->GetShadowAtlas();
+    for (const DirectX::BoundingBox& bounds : m_movedBounds) {
+        shadowAtlas.Invalidate(bounds);
+    }
+    m_movedBounds.clear();
+
+    m_cullingStats = CullingStats();
+
+    // Build the world-space camera frustum
+    DirectX::BoundingFrustum frustum;
+    DirectX::BoundingFrustum::CreateFromMatrix(frustum, renderer->GetProjectionMatrix().ToXMMATRIX());
+    frustum.Transform(frustum, renderer->GetViewMatrix().Inverse().ToXMMATRIX());
+
+    // Pick animation tiers for the next update from this view
+    UpdateAnimationLOD(renderer, frustum);
+
+    // cot(fovY / 2): converts radius / distance into screen size for mesh LODs and texture streaming
+    float projectionScale = DirectX::XMVectorGetY(renderer->GetProjectionMatrix().ToXMMATRIX().r[1]);
+    float screenHeight = static_cast<float>(renderer->GetHeight());
+    DirectX::XMMATRIX viewProjection = renderer->GetViewMatrix().ToXMMATRIX() * renderer->GetProjectionMatrix().ToXMMATRIX();
+    bool occlusionCulling = CONFIG_MANAGER.GetGraphicsSettings().occlusionCulling;
+
+    // Collect draw packets from all visible mesh renderers
+    m_renderQueue.Clear();
+
+    if (m_frustumCullingEnabled) {
+        // Coarse pass through the spatial index, exact test per renderer
+        m_visibleEntities.clear();
+        m_spatialIndex.QueryFrustum(frustum, m_visibleEntities);
+
+        // Occluders first, then everything else is tested against them
+        if (occlusionCulling) {
+            RasterizeOccluders(viewProjection, renderer);
+        }
+        else {
+            m_occlusionBuffer.End();
+        }
+
+        UINT visibleCount = 0;
+        for (EntityID id : m_visibleEntities) {
+            Entity* entity = FindEntity(id);
+            if (entity && entity->IsActive() && !entity->IsDestroyed() && SubmitEntity(entity, &frustum, frustum.Origin, projectionScale, screenHeight)) {
+                visibleCount++;
+            }
+        }
+
+        // Proxies without a renderer are only there for spatial queries; GPU-driven
+        // renderers are tested by the indirect pipeline instead, and disabled ones
+        // or those on inactive entities are not tested at all
+        m_cullingStats.objectsTested = 0;
+        ComponentPool<MeshRenderer>* meshRenderers = m_componentRegistry.GetPool<MeshRenderer>();
+        if (meshRenderers) {
+            for (std::uint32_t i = 0; i < meshRenderers->GetCount(); i++) {
+                const MeshRenderer* meshRenderer = meshRenderers->At(i);
+                if (Internal::IsComponentRunnable(meshRenderer) && !meshRenderer->IsGPUDriven()) {
+                    m_cullingStats.objectsTested++;
+                }
+            }
+        }
+        m_cullingStats.objectsCulled = m_cullingStats.objectsTested - visibleCount;
+    }
+    else {
+        m_occlusionBuffer.End();
+
+        ComponentPool<MeshRenderer>* meshRenderers = m_componentRegistry.GetPool<MeshRenderer>();
+        if (meshRenderers) {
+            for (std::uint32_t i = 0; i < meshRenderers->GetCount(); i++) {
+                Entity* entity = meshRenderers->At(i)->GetEntity();
+                if (entity && entity->IsActive() && !entity->IsDestroyed()) {
+                    SubmitEntity(entity, nullptr, frustum.Origin, projectionScale, screenHeight);
                 }
             }
         }
     }
+
+    // Static geometry is culled on the GPU and drawn with one indirect draw per group
+    bool indirect = m_indirectPipeline.IsBuilt();
+    if (indirect) {
+        GPU_PROFILE_SCOPE(renderer->GetContext(), "Cull");
+        m_indirectPipeline.Cull(renderer, viewProjection);
+        m_indirectPipeline.RequestTextureResolution(frustum.Origin, projectionScale, screenHeight);
+    }
+    m_renderQueue.Sort();
+
+    // The render path's passes draw into whatever targets the caller bound
+    ID3D11DeviceContext* context = renderer->GetContext();
+    Microsoft::WRL::ComPtr<ID3D11RenderTargetView> colorTarget;
+    Microsoft::WRL::ComPtr<ID3D11DepthStencilView> depthTarget;
+    context->OMGetRenderTargets(1, &colorTarget, &depthTarget);
+
+    Renderer::FrameGraph& graph = renderer->GetFrameGraph();
+    graph.Reset();
+    Renderer::FrameGraph::ResourceHandle sceneColor = graph.Import("SceneColor", colorTarget.Get(), nullptr, nullptr, true);
+    Renderer::FrameGraph::ResourceHandle sceneDepth =
+        graph.Import("SceneDepth", nullptr, depthTarget.Get(), renderer->GetDepthShaderResourceView(), true);
+
+    // Dirty atlas tiles of the lights UpdateLightBuffer requested, before anything samples them
+    graph.AddPass("Shadows",
+        [](Renderer::FrameGraph::Builder& builder) {
+            builder.SetSideEffect();
+        },
+        [this](Renderer::D3D11Renderer* renderer, const Renderer::FrameGraph&) {
+            // Tile clears replace the shaders on the context; casters use the caller's
+            Renderer::ContextStateCache& stateCache = renderer->GetStateCache();
+            ID3D11VertexShader* vertexShader = stateCache.GetVertexShader();
+            ID3D11InputLayout* inputLayout = stateCache.GetInputLayout();
+            ID3D11PixelShader* pixelShader = stateCache.GetPixelShader();
+
+            renderer->GetShadowAtlas().Render(renderer->GetContext(),
+                [this, renderer, vertexShader, inputLayout](const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& projection) {
+                    DrawShadowCasters(renderer, view, projection, vertexShader, inputLayout);
+                });
+
+            renderer->InvalidateStateCache();
+            renderer->SetVertexShader(vertexShader, inputLayout);
+            renderer->SetPixelShader(pixelShader);
+        });
+
+    renderer->GetDeferredShading().AddPasses(graph, renderer, sceneColor, sceneDepth,
+        [this, renderer, indirect](ID3D11PixelShader* pixelShader, bool depthOnly) {
+            if (depthOnly || pixelShader) {
+                m_renderQueue.SetPixelShaderOverride(pixelShader);
+            }
+            else {
+                m_renderQueue.ClearPixelShaderOverride();
+            }
+            DrawGeometry(renderer, indirect);
+            m_renderQueue.ClearPixelShaderOverride();
+        });
+
+    // Depth pyramid for next frame's GPU occlusion test
+    graph.AddPass("HiZ",
+        [sceneDepth](Renderer::FrameGraph::Builder& builder) {
+            builder.Read(sceneDepth);
+            builder.SetSideEffect();
+        },
+        [this, occlusionCulling, viewProjection](Renderer::D3D11Renderer* renderer, const Renderer::FrameGraph&) {
+            if (occlusionCulling) {
+                m_indirectPipeline.BuildOcclusion(renderer, viewProjection);
+            }
+            else {
+                m_indirectPipeline.ResetOcclusion();
+            }
+        });
+
+    graph.Execute(renderer, renderer->GetTransientTextures());
 }
 
-void Scene::Render(Renderer::D3D11Renderer* renderer) {
-    if (!m_active || !renderer) return;
+void Scene::DrawGeometry(Renderer::D3D11Renderer* renderer, bool indirect) {
+    if (indirect) {
+        GPU_PROFILE_SCOPE(renderer->GetContext(), "Indirect");
+        m_indirectPipeline.Draw(renderer);
+    }
 
-    // Render all active entities
-    // This is a basic implementation - in a real engine you'd have
-    // a proper render queue with sorting, frustum culling, etc.
+    // Submit sorted packets with redundant binds filtered
+    PROFILE_SCOPE("SubmitQueue");
+    GPU_PROFILE_SCOPE(renderer->GetContext(), "Queue");
+    m_renderQueue.ExecuteParallel(renderer, renderer->GetDeferredContexts());
+}
 
-    for (const auto& entity : m_entities) {
-        if (entity && entity->IsActive() && !entity->IsDestroyed()) {
-            // Here you would render mesh components, etc.
-            // For now, this is just a placeholder
+void Scene::DrawShadowCasters(Renderer::D3D11Renderer* renderer, const DirectX::XMMATRIX& view,
+                              const DirectX::XMMATRIX& projection, ID3D11VertexShader* vertexShader,
+                              ID3D11InputLayout* inputLayout) {
+    // The box around the clip volume's corners is a conservative query for
+    // perspective and orthographic lights alike
+    DirectX::XMMATRIX inverseViewProjection = DirectX::XMMatrixInverse(nullptr, view * projection);
+    DirectX::XMFLOAT3 corners[DirectX::BoundingBox::CORNER_COUNT];
+    for (UINT i = 0; i < DirectX::BoundingBox::CORNER_COUNT; i++) {
+        DirectX::XMVECTOR corner = DirectX::XMVectorSet((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : 0.0f, 1.0f);
+        DirectX::XMStoreFloat3(&corners[i], DirectX::XMVector3TransformCoord(corner, inverseViewProjection));
+    }
+    DirectX::BoundingBox volume;
+    DirectX::BoundingBox::CreateFromPoints(volume, DirectX::BoundingBox::CORNER_COUNT, corners, sizeof(DirectX::XMFLOAT3));
+
+    m_shadowCasters.clear();
+    m_spatialIndex.QueryBox(volume, m_shadowCasters);
+
+    m_shadowQueue.Clear();
+    for (EntityID id : m_shadowCasters) {
+        Entity* entity = FindEntity(id);
+        if (!entity || !entity->IsActive() || entity->IsDestroyed()) {
+            continue;
+        }
+
+        const MeshRenderer* meshRenderer = entity->GetComponent<MeshRenderer>();
+        if (meshRenderer && meshRenderer->IsEnabled()) {
+            meshRenderer->Submit(m_shadowQueue);
+        }
+    }
+    if (m_shadowQueue.IsEmpty()) {
+        return;
+    }
+    m_shadowQueue.Sort();
+
+    // The queue draws from the renderer's camera, so the light stands in for it
+    Math::Matrix4 cameraView = renderer->GetViewMatrix();
+    Math::Matrix4 cameraProjection = renderer->GetProjectionMatrix();
+    renderer->SetViewProjection(view, projection);
+
+    PROFILE_SCOPE("ShadowCasters");
+    renderer->InvalidateStateCache();
+    renderer->SetVertexShader(vertexShader, inputLayout);
+    m_shadowQueue.SetPixelShaderOverride(nullptr);
+    m_shadowQueue.Execute(renderer);
+
+    renderer->SetViewProjection(cameraView, cameraProjection);
+}
+
+void Scene::RasterizeOccluders(const DirectX::XMMATRIX& viewProjection, Renderer::D3D11Renderer* renderer) {
+    // Buffer height follows the screen's aspect ratio
+    UINT width = static_cast<UINT>(CONFIG_MANAGER.GetGraphicsSettings().occlusionBufferWidth);
+    UINT height = renderer->GetWidth() > 0 ? width * renderer->GetHeight() / renderer->GetWidth() : width;
+    m_occlusionBuffer.Begin(viewProjection, width, height);
+
+    for (EntityID id : m_visibleEntities) {
+        Entity* entity = FindEntity(id);
+        if (!entity || !entity->IsActive() || entity->IsDestroyed()) {
+            continue;
+        }
+
+        const MeshRenderer* meshRenderer = entity->GetComponent<MeshRenderer>();
+        DirectX::BoundingOrientedBox bounds;
+        if (meshRenderer && meshRenderer->IsEnabled() && meshRenderer->IsOccluder() && meshRenderer->GetOccluderBounds(bounds)) {
+            m_occlusionBuffer.RasterizeOccluder(bounds);
+        }
+    }
+}
+
+void Scene::UpdateAnimation(float deltaTime) {
+    const Core::AnimationSettings& settings = CONFIG_MANAGER.GetAnimationSettings();
+    ComponentPool<Animation::AnimationController>* animators = m_componentRegistry.GetPool<Animation::AnimationController>();
+    if (!settings.parallelUpdate || !animators || animators->GetCount() == 0) {
+        return;
+    }
+
+    m_animators.clear();
+    for (std::uint32_t i = 0; i < animators->GetCount(); i++) {
+        Animation::AnimationController* animator = animators->At(i);
+        if (Internal::IsComponentRunnable(animator)) {
+            m_animators.push_back(animator);
+        }
+    }
+
+    // State machines and pose sampling are independent per controller; bone
+    // palettes are written from the results when the scene is rendered
+    JOB_SYSTEM.ParallelFor(static_cast<std::uint32_t>(m_animators.size()),
+        [this, deltaTime](std::uint32_t begin, std::uint32_t end) {
+            for (std::uint32_t i = begin; i < end; i++) {
+                m_animators[i]->EvaluateFromSystem(deltaTime);
+            }
+        }, static_cast<std::uint32_t>(settings.updateBatchSize));
+}
+
+void Scene::UpdateAnimationLOD(Renderer::D3D11Renderer* renderer, const DirectX::BoundingFrustum& frustum) {
+    ComponentPool<Animation::AnimationController>* animators = m_componentRegistry.GetPool<Animation::AnimationController>();
+    if (!animators || animators->GetCount() == 0) {
+        return;
+    }
+
+    const Core::AnimationSettings& settings = CONFIG_MANAGER.GetAnimationSettings();
+
+    // cot(fovY / 2): converts radius / distance into a fraction of the screen height
+    DirectX::XMMATRIX projection = renderer->GetProjectionMatrix().ToXMMATRIX();
+    float projectionScale = DirectX::XMVectorGetY(projection.r[1]);
+    DirectX::XMVECTOR cameraPosition = DirectX::XMLoadFloat3(&frustum.Origin);
+
+    m_lodAnimators.clear();
+    m_lodCenterX.clear();
+    m_lodCenterY.clear();
+    m_lodCenterZ.clear();
+    m_lodRadii.clear();
+
+    for (std::uint32_t i = 0; i < animators->GetCount(); i++) {
+        Animation::AnimationController* animator = animators->At(i);
+        Entity* entity = animator->GetEntity();
+        if (!entity || !entity->IsActive() || entity->IsDestroyed()) {
+            continue;
+        }
+
+        animator->SetReducedChannelCount(static_cast<size_t>(settings.reducedChannelCount));
+
+        // Without bounds there is nothing to measure, keep full quality
+        const MeshRenderer* meshRenderer = entity->GetComponent<MeshRenderer>();
+        DirectX::BoundingOrientedBox bounds;
+        if (!meshRenderer || !meshRenderer->GetWorldBounds(bounds)) {
+            animator->SetLOD(Animation::AnimationLOD::Full);
+            continue;
+        }
+
+        m_lodAnimators.push_back(animator);
+        m_lodCenterX.push_back(bounds.Center.x);
+        m_lodCenterY.push_back(bounds.Center.y);
+        m_lodCenterZ.push_back(bounds.Center.z);
+        m_lodRadii.push_back(DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&bounds.Extents))));
+    }
+
+    if (m_lodAnimators.empty()) {
+        return;
+    }
+
+    // Test the enclosing spheres in one batch; slightly conservative next to
+    // the boxes, which only means an animator near the edge stays visible
+    DirectX::XMFLOAT4X4 viewProjection;
+    DirectX::XMStoreFloat4x4(&viewProjection, renderer->GetViewMatrix().ToXMMATRIX() * projection);
+    float planes[24];
+    Math::Simd::ExtractFrustumPlanes(&viewProjection._11, planes);
+
+    m_lodVisible.resize(m_lodAnimators.size());
+    Math::Simd::TestSpheresFrustum(planes, { m_lodCenterX.data(), m_lodCenterY.data(), m_lodCenterZ.data() },
+                                   m_lodRadii.data(), m_lodVisible.data(), m_lodAnimators.size());
+
+    for (size_t i = 0; i < m_lodAnimators.size(); i++) {
+        DirectX::XMVECTOR center = DirectX::XMVectorSet(m_lodCenterX[i], m_lodCenterY[i], m_lodCenterZ[i], 0.0f);
+        float radius = m_lodRadii[i];
+        float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(center, cameraPosition)));
+        float screenSize = distance > radius ? radius * projectionScale / distance : 1.0f;
+
+        m_lodAnimators[i]->SetLOD(Animation::SelectAnimationLOD(settings, m_lodVisible[i] != 0, screenSize));
+    }
+}
+
+std::vector<Entity*> Scene::QueryFrustum(const DirectX::BoundingFrustum& frustum) const {
+    std::vector<EntityID> ids;
+    m_spatialIndex.QueryFrustum(frustum, ids);
+    return ResolveEntities(ids);
+}
+
+std::vector<Entity*> Scene::QuerySphere(const DirectX::BoundingSphere& sphere) const {
+    std::vector<EntityID> ids;
+    m_spatialIndex.QuerySphere(sphere, ids);
+    return ResolveEntities(ids);
+}
+
+std::vector<Entity*> Scene::QueryBox(const DirectX::BoundingBox& box) const {
+    std::vector<EntityID> ids;
+    m_spatialIndex.QueryBox(box, ids);
+    return ResolveEntities(ids);
+}
+
+std::vector<Entity*> Scene::QueryOrientedBox(const DirectX::BoundingOrientedBox& box) const {
+    std::vector<EntityID> ids;
+    m_spatialIndex.QueryOrientedBox(box, ids);
+    return ResolveEntities(ids);
+}
+
+void Scene::GatherShadowCasters(const DirectX::BoundingOrientedBox& volume, std::vector<MeshRenderer*>& casters) const {
+    std::vector<EntityID> ids;
+    m_spatialIndex.QueryOrientedBox(volume, ids);
+
+    for (EntityID id : ids) {
+        Entity* entity = FindEntity(id);
+        if (!entity || !entity->IsActive() || entity->IsDestroyed()) {
+            continue;
+        }
+
+        MeshRenderer* meshRenderer = entity->GetComponent<MeshRenderer>();
+        if (!meshRenderer || !meshRenderer->IsEnabled() || !meshRenderer->IsCastingShadows()) {
+            continue;
+        }
+
+        // Exact test against the renderer bounds, as in the camera pass
+        DirectX::BoundingOrientedBox bounds;
+        if (meshRenderer->GetWorldBounds(bounds) && volume.Contains(bounds) != DirectX::DISJOINT) {
+            casters.push_back(meshRenderer);
         }
     }
 }
 
+std::vector<Entity*> Scene::Raycast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction,
+                                    float maxDistance) const {
+    std::vector<EntityID> ids;
+    m_spatialIndex.QueryRay(origin, direction, maxDistance, ids);
+    return ResolveEntities(ids);
+}
+
+void Scene::UpdateTransforms(const ParallelForFunc& parallelFor) {
+    if (parallelFor) {
+        m_transformHierarchy.Update(parallelFor);
+        return;
+    }
+
+    // Wide hierarchy levels fan out across the job system's workers
+    m_transformHierarchy.Update([](std::uint32_t count, const std::function<void(std::uint32_t, std::uint32_t)>& body) {
+        JOB_SYSTEM.ParallelFor(count, body);
+    });
+}
+
+void Scene::UpdateSpatialIndex() {
+    for (EntityID id : m_spatialDirty) {
+        Entity* entity = FindEntity(id);
+        if (!entity || entity->IsDestroyed()) {
+            continue;
+        }
+
+        DirectX::BoundingBox bounds = ComputeEntityBounds(entity);
+        if (entity->m_spatialProxy == INVALID_SPATIAL_PROXY) {
+            entity->m_spatialProxy = m_spatialIndex.CreateProxy(bounds, id);
+        }
+        else {
+            m_movedBounds.push_back(m_spatialIndex.GetFatBounds(entity->m_spatialProxy));
+            m_spatialIndex.MoveProxy(entity->m_spatialProxy, bounds);
+        }
+        m_movedBounds.push_back(bounds);
+
+        entity->GetTransform()->MarkClean();
+    }
+
+    m_spatialDirty.clear();
+
+    // Without a render to consume them, fold the moves into one box
+    if (m_movedBounds.size() > MAX_MOVED_BOUNDS) {
+        DirectX::BoundingBox merged = m_movedBounds[0];
+        for (const DirectX::BoundingBox& bounds : m_movedBounds) {
+            DirectX::BoundingBox::CreateMerged(merged, merged, bounds);
+        }
+        m_movedBounds.assign(1, merged);
+    }
+}
+
+void Scene::MarkSnapshotDirty(Entity* entity) {
+    if (m_snapshotTracking && entity && !entity->m_snapshotDirty) {
+        entity->m_snapshotDirty = true;
+        m_snapshotDirty.push_back(entity->GetID());
+    }
+}
+
+void Scene::MarkBoundsDirty(Entity* entity) {
+    if (entity && !entity->IsDestroyed()) {
+        m_spatialDirty.push_back(entity->GetID());
+    }
+}
+
+void Scene::OnTransformChanged(Entity* entity) {
+    if (entity && !entity->IsDestroyed()) {
+        MarkSnapshotDirty(entity);
+        m_transformHierarchy.MarkDirty(entity->GetTransform());
+        m_spatialDirty.push_back(entity->GetID());
+        ClearStaticConstants(entity);
+    }
+}
+
+void Scene::ClearStaticConstants(Entity* entity) {
+    // Moved "static" objects go back to per-frame constants, children move with them
+    MeshRenderer* meshRenderer = entity->GetComponent<MeshRenderer>();
+    if (meshRenderer && meshRenderer->HasStaticConstants()) {
+        meshRenderer->ClearStaticConstants();
+    }
+    for (Entity* child : entity->GetChildren()) {
+        ClearStaticConstants(child);
+    }
+}
+
+DirectX::BoundingBox Scene::ComputeEntityBounds(Entity* entity) const {
+    DirectX::BoundingBox result;
+    bool hasBounds = false;
+
+    const MeshRenderer* meshRenderer = entity->GetComponent<MeshRenderer>();
+    DirectX::BoundingOrientedBox orientedBounds;
+    if (meshRenderer && meshRenderer->GetWorldBounds(orientedBounds)) {
+        // Enclose the oriented box in a world-space AABB
+        DirectX::XMFLOAT3 corners[DirectX::BoundingOrientedBox::CORNER_COUNT];
+        orientedBounds.GetCorners(corners);
+
+        DirectX::BoundingBox::CreateFromPoints(result, DirectX::BoundingOrientedBox::CORNER_COUNT,
+                                               corners, sizeof(DirectX::XMFLOAT3));
+        hasBounds = true;
+    }
+
+    // Entities without geometry are indexed as a point
+    if (!hasBounds) {
+        result.Center = entity->GetTransform()->GetWorldPosition();
+        result.Extents = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+    }
+
+    return result;
+}
+
+UINT Scene::BuildStaticBatches(Renderer::D3D11Renderer* renderer) {
+    std::vector<std::shared_ptr<Mesh::Mesh>> meshes;
+    ComponentPool<MeshRenderer>* meshRenderers = m_componentRegistry.GetPool<MeshRenderer>();
+    if (meshRenderers) {
+        for (std::uint32_t i = 0; i < meshRenderers->GetCount(); i++) {
+            MeshRenderer* meshRenderer = meshRenderers->At(i);
+            if (meshRenderer->IsStatic() && meshRenderer->GetMesh()) {
+                meshes.push_back(meshRenderer->GetMesh());
+            }
+        }
+    }
+
+    UINT packed = m_staticBatcher.Build(meshes, renderer);
+
+    // Indirect draws capture the packed base offsets, so they are built after
+    BuildIndirectDraws(renderer);
+    BuildStaticConstants(renderer);
+    return packed;
+}
+
+UINT Scene::BuildStaticConstants(Renderer::D3D11Renderer* renderer) {
+    m_staticConstants.Clear();
+
+    ComponentPool<MeshRenderer>* meshRenderers = m_componentRegistry.GetPool<MeshRenderer>();
+    if (!meshRenderers || !renderer || !renderer->GetContext1()) {
+        return 0;
+    }
+
+    std::vector<MeshRenderer*> renderers;
+    std::vector<DirectX::XMFLOAT4X4> worldMatrices;
+    for (std::uint32_t i = 0; i < meshRenderers->GetCount(); i++) {
+        MeshRenderer* meshRenderer = meshRenderers->At(i);
+        meshRenderer->ClearStaticConstants();
+
+        std::shared_ptr<Mesh::Mesh> mesh = meshRenderer->GetMesh();
+        Entity* entity = meshRenderer->GetEntity();
+        if (!meshRenderer->IsStatic() || meshRenderer->IsGPUDriven() || !mesh || !mesh->IsLoaded() ||
+            mesh->IsAnimated() || !entity || !entity->GetTransform()) {
+            continue;
+        }
+
+        // Same world the render queue would upload, dequantization included
+        DirectX::XMMATRIX worldMatrix = entity->GetTransform()->GetWorldMatrix();
+        if (mesh->GetVertexFormat() == Mesh::VertexFormat::Quantized) {
+            worldMatrix = mesh->GetPositionDequantization() * worldMatrix;
+        }
+
+        DirectX::XMFLOAT4X4 world;
+        DirectX::XMStoreFloat4x4(&world, worldMatrix);
+        worldMatrices.push_back(world);
+        renderers.push_back(meshRenderer);
+    }
+
+    if (renderers.empty() || !m_staticConstants.Build(renderer->GetDevice(), worldMatrices)) {
+        return 0;
+    }
+
+    for (UINT i = 0; i < static_cast<UINT>(renderers.size()); i++) {
+        renderers[i]->SetStaticConstants(m_staticConstants.GetBinding(i));
+    }
+    return static_cast<UINT>(renderers.size());
+}
+
+UINT Scene::BuildIndirectDraws(Renderer::D3D11Renderer* renderer) {
+    m_indirectPipeline.Clear();
+
+    ComponentPool<MeshRenderer>* meshRenderers = m_componentRegistry.GetPool<MeshRenderer>();
+    if (!meshRenderers) {
+        return 0;
+    }
+
+    std::vector<MeshRenderer*> gpuDriven;
+    for (std::uint32_t i = 0; i < meshRenderers->GetCount(); i++) {
+        MeshRenderer* meshRenderer = meshRenderers->At(i);
+        meshRenderer->SetGPUDriven(false);
+
+        std::shared_ptr<Mesh::Mesh> mesh = meshRenderer->GetMesh();
+        Entity* entity = meshRenderer->GetEntity();
+        if (!m_indirectPipeline.IsAvailable() || !meshRenderer->IsStatic() || !meshRenderer->IsEnabled() ||
+            !mesh || !mesh->IsLoaded() || mesh->IsAnimated() || !entity || !entity->IsActive() || !entity->GetTransform()) {
+            continue;
+        }
+
+        // Materials with their own shaders stay on the render queue
+        std::shared_ptr<Mesh::Material> componentMaterial = meshRenderer->GetMaterial();
+        bool defaultShaders = !componentMaterial || !componentMaterial->GetVertexShader();
+        for (UINT subMesh = 0; subMesh < mesh->GetSubMeshCount() && defaultShaders && !componentMaterial; subMesh++) {
+            const std::shared_ptr<Mesh::Material>& material = mesh->GetSubMesh(subMesh).material;
+            defaultShaders = !material || !material->GetVertexShader();
+        }
+
+        DirectX::BoundingOrientedBox orientedBounds;
+        if (!defaultShaders || !meshRenderer->GetWorldBounds(orientedBounds)) {
+            continue;
+        }
+
+        DirectX::XMFLOAT3 corners[DirectX::BoundingOrientedBox::CORNER_COUNT];
+        orientedBounds.GetCorners(corners);
+        DirectX::BoundingBox worldBounds;
+        DirectX::BoundingBox::CreateFromPoints(worldBounds, DirectX::BoundingOrientedBox::CORNER_COUNT, corners, sizeof(DirectX::XMFLOAT3));
+
+        DirectX::XMMATRIX worldMatrix = entity->GetTransform()->GetWorldMatrix();
+        for (UINT subMesh = 0; subMesh < mesh->GetSubMeshCount(); subMesh++) {
+            std::shared_ptr<Mesh::Material> material = componentMaterial ? componentMaterial : mesh->GetSubMesh(subMesh).material;
+            m_indirectPipeline.Add(mesh, subMesh, material, worldMatrix, worldBounds);
+        }
+        gpuDriven.push_back(meshRenderer);
+    }
+
+    if (gpuDriven.empty() || !m_indirectPipeline.Build(renderer)) {
+        return 0;
+    }
+
+    for (MeshRenderer* meshRenderer : gpuDriven) {
+        meshRenderer->SetGPUDriven(true);
+    }
+    return static_cast<UINT>(gpuDriven.size());
+}
+
+bool Scene::SubmitEntity(Entity* entity, const DirectX::BoundingFrustum* frustum,
+                         const DirectX::XMFLOAT3& cameraPosition, float projectionScale, float screenHeight) {
+    const MeshRenderer* meshRenderer = entity->GetComponent<MeshRenderer>();
+    if (!meshRenderer || !meshRenderer->IsEnabled()) {
+        return false;
+    }
+
+    // Culled and drawn by the indirect draw pipeline, counted in its own stats
+    if (meshRenderer->IsGPUDriven()) {
+        return false;
+    }
+
+    DirectX::BoundingOrientedBox bounds;
+    bool hasBounds = meshRenderer->GetWorldBounds(bounds);
+    if (frustum && (!hasBounds || frustum->Contains(bounds) == DirectX::DISJOINT)) {
+        return false;
+    }
+
+    // Occluders are in the occlusion buffer themselves
+    if (frustum && !meshRenderer->IsOccluder() && m_occlusionBuffer.IsOccluded(bounds)) {
+        m_cullingStats.objectsOccluded++;
+        return false;
+    }
+
+    // Pick the mesh LOD and ask for texture mips matching the size the object covers on screen
+    if (hasBounds) {
+        float radius = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&bounds.Extents)));
+        float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(
+            DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&bounds.Center), DirectX::XMLoadFloat3(&cameraPosition))));
+        float screenSize = distance > radius ? radius * projectionScale / distance : projectionScale;
+        meshRenderer->SelectLOD(screenSize);
+        meshRenderer->RequestTextureResolution(static_cast<UINT>(std::max(screenSize * screenHeight, 1.0f)));
+    }
+    else {
+        meshRenderer->SelectLOD(std::numeric_limits<float>::max());
+    }
+
+    meshRenderer->Submit(m_renderQueue);
+    return true;
+}
+
+std::vector<Entity*> Scene::ResolveEntities(const std::vector<EntityID>& ids) const {
+    std::vector<Entity*> result;
+    result.reserve(ids.size());
+
+    for (EntityID id : ids) {
+        Entity* entity = FindEntity(id);
+        if (entity && !entity->IsDestroyed()) {
+            result.push_back(entity);
+        }
+    }
+
+    return result;
+}
+
 size_t Scene::GetActiveEntityCount() const {
     size_t count = 0;
     for (const auto& entity : m_entities) {
@@ -189,7 +964,20 @@ size_t Scene::GetActiveEntityCount() const {
 }
 
 EntityID Scene::GenerateEntityID() {
-    return m_nextEntityID++;
+    // Reuse freed slots first, skipping any an explicit ID has claimed since
+    while (!m_freeSlots.empty()) {
+        std::uint32_t index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        if (m_entitySlots[index].denseIndex == INVALID_DENSE_INDEX) {
+            return MakeEntityID(index, m_entitySlots[index].generation);
+        }
+    }
+
+    if (m_entitySlots.size() > ENTITY_INDEX_MASK) {
+        LOG_ERROR("Scene " << m_name << " has no free entity slots");
+        return INVALID_ENTITY_ID;
+    }
+    return MakeEntityID(static_cast<std::uint32_t>(m_entitySlots.size()), 1);
 }
 
 void Scene::ProcessPendingDestroy() {
@@ -197,37 +985,64 @@ void Scene::ProcessPendingDestroy() {
         EntityID id = m_pendingDestroy.front();
         m_pendingDestroy.pop();
 
-        // Find and remove entity
-        auto it = std::find_if(m_entities.begin(), m_entities.end(),
-            [id](const std::unique_ptr<Entity>& entity) {
-                return entity && entity->GetID() == id;
-            });
-
-        if (it != m_entities.end()) {
-            Entity* entity = it->get();
+        // IDs queued twice or already removed no longer resolve
+        Entity* entity = FindEntity(id);
+        if (entity) {
+            RemoveEntity(entity);
+            LOG_DEBUG("Entity destroyed and removed from scene: ID " << id);
+        }
+    }
+}
 
-            // Unregister entity
-            UnregisterEntity(entity);
+void Scene::RemoveEntity(Entity* entity) {
+    std::uint32_t index = GetEntityIndex(entity->GetID());
+    std::uint32_t denseIndex = m_entitySlots[index].denseIndex;
 
-            // Remove from container (this will call the destructor)
-            m_entities.erase(it);
+    UnregisterEntity(entity);
+    if (m_snapshotTracking) {
+        m_snapshotRemoved.push_back(entity->GetID());
+    }
 
-            LOG_DEBUG("Entity destroyed and removed from scene: ID " << id);
-        }
+    // Move the last entity into the hole to stay packed
+    std::uint32_t last = static_cast<std::uint32_t>(m_entities.size() - 1);
+    if (denseIndex != last) {
+        std::swap(m_entities[denseIndex], m_entities[last]);
+        m_entitySlots[GetEntityIndex(m_entities[denseIndex]->GetID())].denseIndex = denseIndex;
     }
+    EntityPtr removed = std::move(m_entities.back());
+    m_entities.pop_back();
+
+    // Retire the ID before the destructor runs so nothing resolves it
+    EntitySlot& slot = m_entitySlots[index];
+    slot.generation = slot.generation == ENTITY_GENERATION_MASK ? 1 : slot.generation + 1;
+    slot.denseIndex = INVALID_DENSE_INDEX;
+    m_freeSlots.push_back(index);
+
+    removed.reset();
 }
 
 void Scene::RegisterEntity(Entity* entity) {
     if (entity) {
-        m_entityLookup[entity->GetID()] = entity;
+        entity->m_componentRegistry = &m_componentRegistry;
+
+        m_entityLookup.Add(entity);
+        MarkSnapshotDirty(entity);
+
+        // Inserted into the transform store and spatial index on the next refresh
+        m_transformHierarchy.Add(entity->GetTransform());
+        m_spatialDirty.push_back(entity->GetID());
     }
 }
 
 void Scene::UnregisterEntity(Entity* entity) {
     if (entity) {
-        auto it = m_entityLookup.find(entity->GetID());
-        if (it != m_entityLookup.end()) {
-            m_entityLookup.erase(it);
+        m_entityLookup.Remove(entity);
+        m_transformHierarchy.Remove(entity->GetTransform());
+
+        if (entity->m_spatialProxy != INVALID_SPATIAL_PROXY) {
+            m_movedBounds.push_back(m_spatialIndex.GetFatBounds(entity->m_spatialProxy));
+            m_spatialIndex.DestroyProxy(entity->m_spatialProxy);
+            entity->m_spatialProxy = INVALID_SPATIAL_PROXY;
         }
     }
 }
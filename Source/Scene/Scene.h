@@ -2,18 +2,41 @@
 
 #include <memory>
 #include <vector>
-#include <unordered_map>
 #include <string>
 #include <queue>
+#include <cfloat>
+#include <DirectXCollision.h>
 #include "Entity.h"
+#include "ComponentPool.h"
+#include "SpatialIndex.h"
+#include "Transform.h"
+#include "TransformHierarchy.h"
+#include "../Core/PoolAllocator.h"
+#include "../Renderer/RenderQueue.h"
+#include "../Renderer/IndirectDrawPipeline.h"
+#include "../Renderer/OcclusionBuffer.h"
+#include "../Mesh/StaticMeshBatcher.h"
 
 namespace GameEngine {
 
 // Forward declarations
 namespace Renderer { class D3D11Renderer; }
+namespace Animation { class AnimationController; }
 
 namespace Scene {
 
+class MeshRenderer;
+
+// Entities are owned through their scene's pool
+using EntityPtr = std::unique_ptr<Entity, Core::PoolDeleter<Entity>>;
+
+// Per-frame visibility statistics
+struct CullingStats {
+    UINT objectsTested = 0;     // Active entities with an enabled MeshRenderer
+    UINT objectsCulled = 0;     // Entities that produced no draws
+    UINT objectsOccluded = 0;   // Culled ones hidden behind occluders
+};
+
 class Scene {
 public:
     Scene(const std::string& name = "Scene");
@@ -26,24 +49,52 @@ public:
     bool IsActive() const { return m_active; }
     void SetActive(bool active) { m_active = active; }
 
-    // Entity management
+    // Entity management. IDs are generational handles; a slot freed by a
+    // destroyed entity is reused with a new generation.
     Entity* CreateEntity(const std::string& name = "Entity");
+    // Claims the ID's slot with the ID's generation, e.g. when loading saved IDs
     Entity* CreateEntity(EntityID id, const std::string& name = "Entity");
 
+    // Destruction is deferred to the next update; children go with their parent
+
     bool DestroyEntity(EntityID id);
     bool DestroyEntity(Entity* entity);
     void DestroyAllEntities();
 
-    // Entity queries
+    // Entity queries. FindEntity returns nullptr once the entity has been
+    // removed, even if its slot now holds another entity.
     Entity* FindEntity(EntityID id) const;
+    bool IsAlive(EntityID id) const;
     Entity* FindEntityByName(const std::string& name) const;
     std::vector<Entity*> FindEntitiesByName(const std::string& name) const;
+    // Entities carrying every tag in the mask; an empty mask matches nothing
+    std::vector<Entity*> FindEntitiesWithTags(TagMask tags) const;
 
     template<typename T>
     std::vector<Entity*> FindEntitiesWithComponent() const;
 
-    // Get all entities
-    const std::vector<std::unique_ptr<Entity>>& GetAllEntities() const { return m_entities; }
+    // Spatial queries (served by the spatial index)
+    std::vector<Entity*> QueryFrustum(const DirectX::BoundingFrustum& frustum) const;
+    std::vector<Entity*> QuerySphere(const DirectX::BoundingSphere& sphere) const;
+    std::vector<Entity*> QueryBox(const DirectX::BoundingBox& box) const;
+    std::vector<Entity*> QueryOrientedBox(const DirectX::BoundingOrientedBox& box) const;
+    std::vector<Entity*> Raycast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction,
+                                 float maxDistance = FLT_MAX) const;
+
+    // Enabled shadow-casting mesh renderers inside a light volume, e.g. one
+    // cascade's bounds; appends to casters
+    void GatherShadowCasters(const DirectX::BoundingOrientedBox& volume, std::vector<MeshRenderer*>& casters) const;
+
+    // Batched world-matrix propagation; uses the job system when parallelFor is empty
+    void UpdateTransforms(const ParallelForFunc& parallelFor = nullptr);
+    const TransformHierarchy& GetTransformHierarchy() const { return m_transformHierarchy; }
+
+    // Apply pending transform changes to the spatial index
+    void UpdateSpatialIndex();
+    const SpatialIndex& GetSpatialIndex() const { return m_spatialIndex; }
+
+    // Get all entities; packed, so removal changes the order
+    const std::vector<EntityPtr>& GetAllEntities() const { return m_entities; }
     std::vector<Entity*> GetRootEntities() const;
 
     // Scene lifecycle
@@ -52,6 +103,27 @@ public:
     virtual void Update(float deltaTime);
     virtual void Render(Renderer::D3D11Renderer* renderer);
 
+    // Fixed-timestep simulation: keeps the current world matrices as the
+    // previous step's, then runs a regular update with the fixed step. Once
+    // a scene is stepped this way, Render draws moved transforms blended
+    // between the last two steps by the interpolation alpha.
+    void FixedUpdate(float fixedDeltaTime);
+    // Fraction of a fixed step accumulated since the last one, in [0, 1]
+    void SetInterpolationAlpha(float alpha) { m_interpolationAlpha = alpha; }
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+    bool IsInterpolating() const { return m_interpolating; }
+
+    // Incremental saves. Once SceneSerializer::Save turns tracking on,
+    // created, changed and removed entities are recorded until the next
+    // save. Edits to component data are not seen; flag those entities here.
+    void MarkSnapshotDirty(Entity* entity);
+    bool IsSnapshotTracking() const { return m_snapshotTracking; }
+
+    // Recompute the entity's spatial index bounds on the next refresh.
+    // Transform changes do this already; call it when what the entity
+    // draws changes, e.g. a new mesh or an added renderer.
+    void MarkBoundsDirty(Entity* entity);
+
     // Entity iteration
     template<typename Func>
     void ForEachEntity(Func func);
@@ -59,31 +131,151 @@ public:
     template<typename Func>
     void ForEachActiveEntity(Func func);
 
+    // Visit every component of one type in pool order
+    template<typename T, typename Func>
+    void ForEachComponent(Func func);
+
+    // Dense per-type component storage
+    const ComponentRegistry& GetComponentRegistry() const { return m_componentRegistry; }
+
     // Statistics
     size_t GetEntityCount() const { return m_entities.size(); }
     size_t GetActiveEntityCount() const;
+    const Renderer::RenderQueueStats& GetRenderStats() const { return m_renderQueue.GetStats(); }
+
+    // Frustum culling
+    void SetFrustumCullingEnabled(bool enabled) { m_frustumCullingEnabled = enabled; }
+    bool IsFrustumCullingEnabled() const { return m_frustumCullingEnabled; }
+    const CullingStats& GetCullingStats() const { return m_cullingStats; }
+
+    // Software occlusion culling of queued draws (GraphicsSettings::occlusionCulling)
+    const Renderer::OcclusionBuffer& GetOcclusionBuffer() const { return m_occlusionBuffer; }
+
+    // Pack the meshes of static mesh renderers into shared vertex/index
+    // buffers; call once the scene's content is loaded. When the indirect
+    // draw pipeline has its shaders, static renderers using the default
+    // shaders are also handed to it and culled and drawn on the GPU; call
+    // again after adding or removing static renderers. The world constants
+    // of the other static renderers are uploaded once here as well.
+    UINT BuildStaticBatches(Renderer::D3D11Renderer* renderer);
+    const Mesh::StaticBatchStats& GetStaticBatchStats() const { return m_staticBatcher.GetStats(); }
+
+    // GPU-driven static geometry (culling and instancing shaders)
+    Renderer::IndirectDrawPipeline& GetIndirectDrawPipeline() { return m_indirectPipeline; }
+    const Renderer::IndirectDrawStats& GetIndirectDrawStats() const { return m_indirectPipeline.GetStats(); }
+
+    // Render queue configuration (instancing shader, thresholds)
+    Renderer::RenderQueue& GetRenderQueue() { return m_renderQueue; }
+    // Queue the Shadows pass draws atlas tiles with, configured the same way
+    Renderer::RenderQueue& GetShadowQueue() { return m_shadowQueue; }
 
 protected:
     std::string m_name;
     bool m_active;
 
-    // Entity storage
-    std::vector<std::unique_ptr<Entity>> m_entities;
-    std::unordered_map<EntityID, Entity*> m_entityLookup;
+    // Component pools, declared first so they outlive the entities
+    ComponentRegistry m_componentRegistry;
+
+    // Entity and transform memory. Spawn/despawn reuses slots from these
+    // arenas; DestroyAllEntities drops their pages in one go.
+    Core::PoolAllocator<Entity> m_entityPool;
+    Core::PoolAllocator<Transform> m_transformPool;
+
+    // Entity storage. m_entities stays packed with swap-and-pop removal; each
+    // slot holds the generation of its current ID and where its entity sits.
+    static constexpr std::uint32_t INVALID_DENSE_INDEX = 0xFFFFFFFF;
+    struct EntitySlot {
+        std::uint32_t generation = 1;
+        std::uint32_t denseIndex = INVALID_DENSE_INDEX;
+    };
+
+    std::vector<EntityPtr> m_entities;
+    std::vector<EntitySlot> m_entitySlots;
+    std::vector<std::uint32_t> m_freeSlots;
     std::queue<EntityID> m_pendingDestroy;
 
-    // ID generation
-    EntityID m_nextEntityID;
+    // Name and tag indices behind the Find* queries
+    EntityLookup m_entityLookup;
+
+    // Changes since the last snapshot, see MarkSnapshotDirty
+    bool m_snapshotTracking;
+    std::vector<EntityID> m_snapshotDirty;
+    std::vector<EntityID> m_snapshotRemoved;
+
+    // Per-frame draw submission (reused to avoid reallocating)
+    Renderer::RenderQueue m_renderQueue;
+
+    // Depth-only casters of one shadow atlas tile at a time
+    Renderer::RenderQueue m_shadowQueue;
+    std::vector<EntityID> m_shadowCasters;
+
+    // Shared buffers for static geometry
+    Mesh::StaticMeshBatcher m_staticBatcher;
+
+    // Static geometry culled and drawn with indirect draws
+    Renderer::IndirectDrawPipeline m_indirectPipeline;
+
+    // World constants of the remaining static renderers, uploaded once
+    Renderer::StaticConstantBuffer m_staticConstants;
+
+    // Visibility
+    bool m_frustumCullingEnabled;
+    CullingStats m_cullingStats;
+    Renderer::OcclusionBuffer m_occlusionBuffer;
+
+    // Contiguous depth-sorted transform data
+    TransformHierarchy m_transformHierarchy;
+    bool m_interpolating;
+    float m_interpolationAlpha;
+
+    // Spatial index over entity world bounds
+    SpatialIndex m_spatialIndex;
+    std::vector<EntityID> m_spatialDirty;
+    std::vector<EntityID> m_visibleEntities;
+    std::vector<DirectX::BoundingBox> m_movedBounds;   // Old and new bounds, for shadow cache invalidation
+
+    // Controllers gathered for the parallel animation stage
+    std::vector<Animation::AnimationController*> m_animators;
+
+    // Bounding spheres of animated entities, split per axis for batch culling
+    std::vector<Animation::AnimationController*> m_lodAnimators;
+    std::vector<float> m_lodCenterX;
+    std::vector<float> m_lodCenterY;
+    std::vector<float> m_lodCenterZ;
+    std::vector<float> m_lodRadii;
+    std::vector<std::uint8_t> m_lodVisible;
 
     // Internal methods
     EntityID GenerateEntityID();
     void ProcessPendingDestroy();
+    void RemoveEntity(Entity* entity);
 
     // Entity registration
     void RegisterEntity(Entity* entity);
     void UnregisterEntity(Entity* entity);
 
+    // Spatial index maintenance
+    void OnTransformChanged(Entity* entity);
+    DirectX::BoundingBox ComputeEntityBounds(Entity* entity) const;
+    void RasterizeOccluders(const DirectX::XMMATRIX& viewProjection, Renderer::D3D11Renderer* renderer);
+    // One pass over the frame's culled geometry: indirect groups, then the queue
+    void DrawGeometry(Renderer::D3D11Renderer* renderer, bool indirect);
+    // Depth of everything inside a light's view volume, with the caller's vertex shader
+    void DrawShadowCasters(Renderer::D3D11Renderer* renderer, const DirectX::XMMATRIX& view,
+                           const DirectX::XMMATRIX& projection, ID3D11VertexShader* vertexShader,
+                           ID3D11InputLayout* inputLayout);
+    UINT BuildIndirectDraws(Renderer::D3D11Renderer* renderer);
+    UINT BuildStaticConstants(Renderer::D3D11Renderer* renderer);
+    void ClearStaticConstants(Entity* entity);
+    bool SubmitEntity(Entity* entity, const DirectX::BoundingFrustum* frustum,
+                      const DirectX::XMFLOAT3& cameraPosition, float projectionScale, float screenHeight);
+    void UpdateAnimation(float deltaTime);
+    void UpdateAnimationLOD(Renderer::D3D11Renderer* renderer, const DirectX::BoundingFrustum& frustum);
+    std::vector<Entity*> ResolveEntities(const std::vector<EntityID>& ids) const;
+
     friend class Entity;
+    friend class Transform;
+    friend class SceneSerializer;
 };
 
 // Template implementations
@@ -91,11 +283,16 @@ template<typename T>
 std::vector<Entity*> Scene::FindEntitiesWithComponent() const {
     std::vector<Entity*> result;
 
-    for (const auto& entity : m_entities) {
+    ComponentPool<T>* pool = m_componentRegistry.GetPool<T>();
+    if (!pool) {
+        return result;
+    }
+
+    result.reserve(pool->GetCount());
+    for (std::uint32_t i = 0; i < pool->GetCount(); i++) {
+        Entity* entity = pool->At(i)->GetEntity();
         if (entity && entity->IsActive() && !entity->IsDestroyed()) {
-            if (entity->HasComponent<T>()) {
-                result.push_back(entity.get());
-            }
+            result.push_back(entity);
         }
     }
 
@@ -120,5 +317,13 @@ void Scene::ForEachActiveEntity(Func func) {
     }
 }
 
+template<typename T, typename Func>
+void Scene::ForEachComponent(Func func) {
+    ComponentPool<T>* pool = m_componentRegistry.GetPool<T>();
+    if (pool) {
+        pool->ForEach(func);
+    }
+}
+
 } // namespace Scene
 } // namespace GameEngine
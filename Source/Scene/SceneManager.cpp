@@ -74,8 +74,9 @@ bool SceneManager::UnloadScene(const std::string& name) {
 void SceneManager::UnloadAllScenes() {
     LOG_INFO("Unloading all scenes");
 
-    // Clear active scene
+    // Clear active scene and streamed cells
     m_activeScene.reset();
+    m_streamer.RemoveAllCells();
 
     // Unload all scenes
     for (auto& [name, scene] : m_scenes) {
@@ -140,12 +141,49 @@ void SceneManager::Update(float deltaTime) {
     if (m_activeScene && m_activeScene->IsActive()) {
         m_activeScene->Update(deltaTime);
     }
+
+    m_streamer.Update();
+    for (const auto& cell : m_streamer.GetLoadedScenes()) {
+        if (cell->IsActive()) {
+            cell->Update(deltaTime);
+        }
+    }
+}
+
+void SceneManager::FixedUpdate(float fixedDeltaTime) {
+    if (m_activeScene && m_activeScene->IsActive()) {
+        m_activeScene->FixedUpdate(fixedDeltaTime);
+    }
+
+    for (const auto& cell : m_streamer.GetLoadedScenes()) {
+        if (cell->IsActive()) {
+            cell->FixedUpdate(fixedDeltaTime);
+        }
+    }
+}
+
+void SceneManager::SetInterpolationAlpha(float alpha) {
+    if (m_activeScene) {
+        m_activeScene->SetInterpolationAlpha(alpha);
+    }
+
+    for (const auto& cell : m_streamer.GetLoadedScenes()) {
+        cell->SetInterpolationAlpha(alpha);
+    }
 }
 
 void SceneManager::Render(Renderer::D3D11Renderer* renderer) {
-    if (m_activeScene && m_activeScene->IsActive() && renderer) {
+    if (!renderer) {
+        return;
+    }
+
+    if (m_activeScene && m_activeScene->IsActive()) {
         m_activeScene->Render(renderer);
     }
+
+    for (const auto& cell : m_streamer.GetLoadedScenes()) {
+        cell->Render(renderer);
+    }
 }
 
 size_t SceneManager::GetTotalEntityCount() const {
@@ -155,6 +193,9 @@ size_t SceneManager::GetTotalEntityCount() const {
             totalCount += scene->GetEntityCount();
         }
     }
+    for (const auto& cell : m_streamer.GetLoadedScenes()) {
+        totalCount += cell->GetEntityCount();
+    }
     return totalCount;
 }
 
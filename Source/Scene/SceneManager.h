@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Scene.h"
+#include "WorldStreamer.h"
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -33,8 +34,14 @@ public:
     std::shared_ptr<Scene> FindScene(const std::string& name) const;
     std::vector<std::string> GetSceneNames() const;
 
+    // Cells streamed in around the origin are updated and rendered with the
+    // active scene; set the origin (usually the camera) each frame
+    WorldStreamer& GetWorldStreamer() { return m_streamer; }
+
     // Scene lifecycle
     void Update(float deltaTime);
+    void FixedUpdate(float fixedDeltaTime);
+    void SetInterpolationAlpha(float alpha);
     void Render(Renderer::D3D11Renderer* renderer);
 
     // Statistics
@@ -48,10 +55,11 @@ private:
 
     std::unordered_map<std::string, std::shared_ptr<Scene>> m_scenes;
     std::shared_ptr<Scene> m_activeScene;
+    WorldStreamer m_streamer;
 };
 
 // Convenience macro
-#define SCENE_MANAGER SceneManager::GetInstance()
+#define SCENE_MANAGER GameEngine::Scene::SceneManager::GetInstance()
 
 } // namespace Scene
 } // namespace GameEngine
@@ -0,0 +1,681 @@
+#include "SceneSerializer.h"
+#include "Scene.h"
+#include "Transform.h"
+#include "MeshRenderer.h"
+#include "../Mesh/MeshManager.h"
+#include "../Mesh/Material.h"
+#include "../Renderer/D3D11Renderer.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
+#include "../Core/XmlManager.h"
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+namespace GameEngine {
+namespace Scene {
+
+namespace {
+
+constexpr std::uint32_t FLAG_DELTA = 1u << 0;
+constexpr size_t SECTION_ALIGNMENT = 16;
+
+struct SceneSnapshotHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint32_t entityCount;
+    std::uint32_t removedCount;
+    std::uint32_t stringCount;
+    std::uint32_t meshReferenceCount;
+    std::uint32_t textureReferenceCount;
+    std::uint64_t entityOffset;
+    std::uint64_t entitySize;
+    std::uint64_t removedOffset;        // removedCount entity IDs
+    std::uint64_t stringOffset;         // stringCount SnapshotString entries
+    std::uint64_t stringDataOffset;
+    std::uint64_t stringDataSize;
+    std::uint64_t meshReferenceOffset;  // meshReferenceCount string table indices
+    std::uint64_t textureReferenceOffset;   // textureReferenceCount string table indices
+    std::uint64_t fileSize;
+};
+
+struct SnapshotString {
+    std::uint32_t offset;               // Into the string data section
+    std::uint32_t length;
+};
+
+// Fixed part of an entity record; component records follow
+struct SnapshotEntity {
+    EntityID id;
+    EntityID parent;
+    std::uint32_t name;                 // String table index
+    TagMask tags;
+    DirectX::XMFLOAT3 position;
+    DirectX::XMFLOAT3 rotation;
+    DirectX::XMFLOAT3 scale;
+    std::uint16_t componentCount;
+    std::uint8_t active;
+    std::uint8_t reserved;
+};
+
+// MeshRenderer flags
+constexpr std::uint8_t RENDERER_CAST_SHADOWS = 1u << 0;
+constexpr std::uint8_t RENDERER_RECEIVE_SHADOWS = 1u << 1;
+constexpr std::uint8_t RENDERER_STATIC = 1u << 2;
+constexpr std::uint8_t RENDERER_OCCLUDER = 1u << 3;
+constexpr std::uint8_t RENDERER_OCCLUDER_BOX = 1u << 4;
+constexpr std::uint8_t RENDERER_MATERIAL = 1u << 5;
+
+size_t Align(size_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+// Appends a section at the next aligned offset and returns where it starts
+size_t AppendSection(std::vector<uint8_t>& buffer, const void* data, size_t size) {
+    size_t offset = Align(buffer.size());
+    buffer.resize(offset + size, 0);
+    if (size > 0) {
+        std::memcpy(buffer.data() + offset, data, size);
+    }
+    return offset;
+}
+
+bool SectionFits(std::uint64_t offset, std::uint64_t size, size_t fileSize) {
+    return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+// ---------------------------------------------------------------------------
+// Built-in component codecs
+
+void SaveMeshRenderer(const MeshRenderer& renderer, SnapshotWriter& writer) {
+    std::shared_ptr<Mesh::Material> material = renderer.GetMaterial();
+
+    std::uint8_t flags = 0;
+    flags |= renderer.IsCastingShadows() ? RENDERER_CAST_SHADOWS : 0;
+    flags |= renderer.IsReceivingShadows() ? RENDERER_RECEIVE_SHADOWS : 0;
+    flags |= renderer.IsStatic() ? RENDERER_STATIC : 0;
+    flags |= renderer.IsOccluder() ? RENDERER_OCCLUDER : 0;
+    flags |= renderer.HasOccluderBox() ? RENDERER_OCCLUDER_BOX : 0;
+    flags |= material ? RENDERER_MATERIAL : 0;
+
+    std::string meshName = MESH_MANAGER.FindMeshName(renderer.GetMesh());
+    writer.Write(flags);
+    writer.WriteString(meshName);
+    if (!meshName.empty()) {
+        writer.AddMeshReference(meshName);
+    }
+    if (renderer.HasOccluderBox()) {
+        writer.Write(renderer.GetOccluderBox());
+    }
+    if (material) {
+        writer.WriteString(material->GetName());
+        writer.Write(material->GetProperties());
+        writer.WriteString(material->GetDiffuseTexturePath());
+        writer.WriteString(material->GetNormalTexturePath());
+        writer.WriteString(material->GetSpecularTexturePath());
+        for (const std::string* path : { &material->GetDiffuseTexturePath(), &material->GetNormalTexturePath(),
+                                         &material->GetSpecularTexturePath() }) {
+            if (!path->empty()) {
+                writer.AddTextureReference(*path);
+            }
+        }
+    }
+}
+
+bool LoadMeshRenderer(MeshRenderer& renderer, SnapshotReader& reader, SnapshotLoadContext& context) {
+    std::uint8_t flags = reader.Read<std::uint8_t>();
+    std::string meshName = reader.ReadString();
+
+    renderer.SetCastShadows((flags & RENDERER_CAST_SHADOWS) != 0);
+    renderer.SetReceiveShadows((flags & RENDERER_RECEIVE_SHADOWS) != 0);
+    renderer.SetStatic((flags & RENDERER_STATIC) != 0);
+    renderer.SetOccluder((flags & RENDERER_OCCLUDER) != 0);
+    if (flags & RENDERER_OCCLUDER_BOX) {
+        renderer.SetOccluderBox(reader.Read<DirectX::BoundingBox>());
+    }
+
+    if (flags & RENDERER_MATERIAL) {
+        std::string name = reader.ReadString();
+        Mesh::MaterialProperties properties = reader.Read<Mesh::MaterialProperties>();
+        std::string diffuse = reader.ReadString();
+        std::string normal = reader.ReadString();
+        std::string specular = reader.ReadString();
+
+        // Identical records share one material
+        std::string key = name + '\n' + diffuse + '\n' + normal + '\n' + specular + '\n';
+        key.append(reinterpret_cast<const char*>(&properties), sizeof(properties));
+
+        std::shared_ptr<Mesh::Material>& material = context.materials[key];
+        if (!material) {
+            material = std::make_shared<Mesh::Material>(name);
+            material->SetProperties(properties);
+            if (context.renderer) {
+                ID3D11Device* device = context.renderer->GetDevice();
+                if (!diffuse.empty()) {
+                    material->LoadDiffuseTexture(device, diffuse);
+                }
+                if (!normal.empty()) {
+                    material->LoadNormalTexture(device, normal);
+                }
+                if (!specular.empty()) {
+                    material->LoadSpecularTexture(device, specular);
+                }
+            }
+        }
+        renderer.SetMaterial(material);
+    }
+
+    if (!meshName.empty()) {
+        std::shared_ptr<Mesh::Mesh> mesh = MESH_MANAGER.ResolveMesh(meshName);
+        if (!mesh) {
+            LOG_WARNING("Scene snapshot references missing mesh: " << meshName);
+        }
+        renderer.SetMesh(mesh);
+    }
+
+    return reader.IsValid();
+}
+
+void ExportMeshRenderer(const MeshRenderer& renderer, Core::XmlNode& node) {
+    node.SetAttribute("mesh", MESH_MANAGER.FindMeshName(renderer.GetMesh()));
+    if (renderer.GetMaterial()) {
+        node.SetAttribute("material", renderer.GetMaterial()->GetName());
+    }
+    node.SetAttribute("castShadows", renderer.IsCastingShadows());
+    node.SetAttribute("receiveShadows", renderer.IsReceivingShadows());
+    node.SetAttribute("static", renderer.IsStatic());
+    node.SetAttribute("occluder", renderer.IsOccluder());
+}
+
+void SetVectorAttributes(Core::XmlNode& node, const std::string& prefix, const DirectX::XMFLOAT3& value) {
+    node.SetAttribute(prefix + "X", value.x);
+    node.SetAttribute(prefix + "Y", value.y);
+    node.SetAttribute(prefix + "Z", value.z);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SnapshotWriter / SnapshotReader
+
+void SnapshotWriter::WriteBytes(const void* data, size_t size) {
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+std::uint32_t SnapshotWriter::AddString(const std::string& value) {
+    auto result = m_stringIndices.emplace(value, static_cast<std::uint32_t>(m_strings.size()));
+    if (result.second) {
+        m_strings.push_back(value);
+    }
+    return result.first->second;
+}
+
+void SnapshotWriter::AddMeshReference(const std::string& name) {
+    std::uint32_t index = AddString(name);
+    if (std::find(m_meshReferences.begin(), m_meshReferences.end(), index) == m_meshReferences.end()) {
+        m_meshReferences.push_back(index);
+    }
+}
+
+void SnapshotWriter::AddTextureReference(const std::string& path) {
+    std::uint32_t index = AddString(path);
+    if (std::find(m_textureReferences.begin(), m_textureReferences.end(), index) == m_textureReferences.end()) {
+        m_textureReferences.push_back(index);
+    }
+}
+
+void SnapshotReader::ReadBytes(void* data, size_t size) {
+    if (!m_valid || size > m_size - m_offset) {
+        m_valid = false;
+        std::memset(data, 0, size);
+        return;
+    }
+
+    std::memcpy(data, m_data + m_offset, size);
+    m_offset += size;
+}
+
+std::string SnapshotReader::ReadString() {
+    std::uint32_t index = Read<std::uint32_t>();
+    if (!m_valid || !m_strings || index >= m_strings->size()) {
+        m_valid = false;
+        return std::string();
+    }
+    return std::string((*m_strings)[index]);
+}
+
+// ---------------------------------------------------------------------------
+// SceneSerializer
+
+std::vector<SceneSerializer::Codec>& SceneSerializer::GetCodecs() {
+    static std::vector<Codec> s_codecs = {
+        MakeCodec<MeshRenderer>("MeshRenderer", &SaveMeshRenderer, &LoadMeshRenderer, &ExportMeshRenderer)
+    };
+    return s_codecs;
+}
+
+const SceneSerializer::Codec* SceneSerializer::FindCodec(Core::StringId typeId) {
+    for (const Codec& codec : GetCodecs()) {
+        if (codec.typeId == typeId) {
+            return &codec;
+        }
+    }
+    return nullptr;
+}
+
+bool SceneSerializer::Save(Scene& scene, const std::string& path) {
+    return Write(scene, path, false);
+}
+
+bool SceneSerializer::SaveDelta(Scene& scene, const std::string& path) {
+    if (!scene.m_snapshotTracking) {
+        LOG_ERROR("Cannot save a delta of scene " << scene.GetName() << " before a full save or load");
+        return false;
+    }
+    return Write(scene, path, true);
+}
+
+bool SceneSerializer::Write(Scene& scene, const std::string& path, bool delta) {
+    SnapshotWriter writer;
+    std::vector<EntityID> removed;
+    std::uint32_t entityCount = 0;
+
+    if (delta) {
+        removed = scene.m_snapshotRemoved;
+        for (EntityID id : scene.m_snapshotDirty) {
+            Entity* entity = scene.FindEntity(id);
+            if (!entity) {
+                continue;
+            }
+            // Destroyed but not yet removed counts as removed
+            if (entity->IsDestroyed()) {
+                removed.push_back(id);
+                continue;
+            }
+            WriteEntity(scene, *entity, writer);
+            entityCount++;
+        }
+    }
+    else {
+        for (const auto& entity : scene.m_entities) {
+            if (entity && !entity->IsDestroyed()) {
+                WriteEntity(scene, *entity, writer);
+                entityCount++;
+            }
+        }
+    }
+
+    // String table: offsets into one character blob
+    std::vector<SnapshotString> strings;
+    std::vector<char> stringData;
+    strings.reserve(writer.m_strings.size());
+    for (const std::string& value : writer.m_strings) {
+        strings.push_back({ static_cast<std::uint32_t>(stringData.size()), static_cast<std::uint32_t>(value.size()) });
+        stringData.insert(stringData.end(), value.begin(), value.end());
+    }
+
+    SceneSnapshotHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.flags = delta ? FLAG_DELTA : 0;
+    header.entityCount = entityCount;
+    header.removedCount = static_cast<std::uint32_t>(removed.size());
+    header.stringCount = static_cast<std::uint32_t>(strings.size());
+    header.meshReferenceCount = static_cast<std::uint32_t>(writer.m_meshReferences.size());
+    header.textureReferenceCount = static_cast<std::uint32_t>(writer.m_textureReferences.size());
+
+    std::vector<uint8_t> buffer(sizeof(SceneSnapshotHeader), 0);
+    header.entityOffset = AppendSection(buffer, writer.m_buffer.data(), writer.m_buffer.size());
+    header.entitySize = writer.m_buffer.size();
+    header.removedOffset = AppendSection(buffer, removed.data(), removed.size() * sizeof(EntityID));
+    header.stringOffset = AppendSection(buffer, strings.data(), strings.size() * sizeof(SnapshotString));
+    header.stringDataOffset = AppendSection(buffer, stringData.data(), stringData.size());
+    header.stringDataSize = stringData.size();
+    header.meshReferenceOffset = AppendSection(buffer, writer.m_meshReferences.data(),
+                                               writer.m_meshReferences.size() * sizeof(std::uint32_t));
+    header.textureReferenceOffset = AppendSection(buffer, writer.m_textureReferences.data(),
+                                                  writer.m_textureReferences.size() * sizeof(std::uint32_t));
+    header.fileSize = buffer.size();
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    // Write beside the target and swap in, so readers never see a partial file
+    std::string tempPath = path + ".tmp";
+    if (!FILE_SYSTEM.WriteBinaryFile(tempPath, buffer)) {
+        LOG_ERROR("Failed to write scene snapshot: " << tempPath);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR("Failed to replace scene snapshot " << path << ": " << error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    // Everything up to now is on disk; later deltas start from here
+    ClearChanges(scene);
+    scene.m_snapshotTracking = true;
+
+    LOG_INFO("Saved " << (delta ? "delta" : "snapshot") << " of scene " << scene.GetName() << " to " << path
+             << " (" << entityCount << " entities, " << removed.size() << " removed, " << buffer.size() << " bytes)");
+    return true;
+}
+
+void SceneSerializer::WriteEntity(const Scene& scene, const Entity& entity, SnapshotWriter& writer) {
+    EntityID id = entity.GetID();
+    const ComponentRegistry& registry = scene.GetComponentRegistry();
+    const Transform* transform = entity.GetTransform();
+
+    std::uint16_t componentCount = 0;
+    for (const Codec& codec : GetCodecs()) {
+        ComponentPoolBase* pool = registry.GetPool(codec.componentType);
+        if (pool && pool->Contains(id)) {
+            componentCount++;
+        }
+    }
+
+    SnapshotEntity record = {};
+    record.id = id;
+    record.parent = entity.GetParent() ? entity.GetParent()->GetID() : INVALID_ENTITY_ID;
+    record.name = writer.AddString(entity.GetName());
+    record.tags = entity.GetTags();
+    record.position = transform->GetLocalPosition();
+    record.rotation = transform->GetLocalRotation();
+    record.scale = transform->GetLocalScale();
+    record.componentCount = componentCount;
+    record.active = entity.IsActive() ? 1 : 0;
+
+    writer.Write(record);
+
+    // Each component record is its type and size, then the codec's payload
+    for (const Codec& codec : GetCodecs()) {
+        ComponentPoolBase* pool = registry.GetPool(codec.componentType);
+        Component* component = pool ? pool->GetComponent(id) : nullptr;
+        if (!component) {
+            continue;
+        }
+
+        writer.Write(codec.typeId.GetHash());
+        size_t sizeOffset = writer.GetSize();
+        writer.Write(std::uint32_t(0));
+        codec.save(*component, writer);
+
+        std::uint32_t size = static_cast<std::uint32_t>(writer.GetSize() - sizeOffset - sizeof(std::uint32_t));
+        std::memcpy(writer.m_buffer.data() + sizeOffset, &size, sizeof(size));
+    }
+}
+
+bool SceneSerializer::Load(Scene& scene, const std::string& path, Renderer::D3D11Renderer* renderer) {
+    Core::MappedFile view(path);
+    if (!view.GetData()) {
+        LOG_ERROR("Failed to map scene snapshot: " << path);
+        return false;
+    }
+
+    if (!LoadFromMemory(scene, view.GetData(), view.GetSize(), renderer)) {
+        LOG_ERROR("Failed to load scene snapshot: " << path);
+        return false;
+    }
+    return true;
+}
+
+bool SceneSerializer::ReadStrings(const std::uint8_t* data, size_t size, std::vector<std::string_view>& outStrings,
+                                  bool& outDelta) {
+    if (!data || size < sizeof(SceneSnapshotHeader)) {
+        return false;
+    }
+
+    SceneSnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) {
+        LOG_WARNING("Scene snapshot has an unsupported format version");
+        return false;
+    }
+
+    bool valid = header.fileSize == size
+        && SectionFits(header.entityOffset, header.entitySize, size)
+        && SectionFits(header.removedOffset, static_cast<std::uint64_t>(header.removedCount) * sizeof(EntityID), size)
+        && SectionFits(header.stringOffset, static_cast<std::uint64_t>(header.stringCount) * sizeof(SnapshotString), size)
+        && SectionFits(header.stringDataOffset, header.stringDataSize, size)
+        && SectionFits(header.meshReferenceOffset,
+                       static_cast<std::uint64_t>(header.meshReferenceCount) * sizeof(std::uint32_t), size)
+        && SectionFits(header.textureReferenceOffset,
+                       static_cast<std::uint64_t>(header.textureReferenceCount) * sizeof(std::uint32_t), size);
+    if (!valid) {
+        LOG_ERROR("Scene snapshot is corrupt or truncated");
+        return false;
+    }
+
+    // Strings are views into the caller's memory, copied only when a record uses them
+    outStrings.clear();
+    outStrings.reserve(header.stringCount);
+    const char* stringData = reinterpret_cast<const char*>(data + header.stringDataOffset);
+    for (std::uint32_t i = 0; i < header.stringCount; i++) {
+        SnapshotString entry;
+        std::memcpy(&entry, data + header.stringOffset + i * sizeof(SnapshotString), sizeof(entry));
+        if (static_cast<std::uint64_t>(entry.offset) + entry.length > header.stringDataSize) {
+            LOG_ERROR("Scene snapshot string " << i << " is out of range");
+            return false;
+        }
+        outStrings.emplace_back(stringData + entry.offset, entry.length);
+    }
+
+    outDelta = (header.flags & FLAG_DELTA) != 0;
+    return true;
+}
+
+bool SceneSerializer::ReadMeshReferences(const std::uint8_t* data, size_t size, std::vector<std::string>& outNames) {
+    return ReadReferences(data, size, false, outNames);
+}
+
+bool SceneSerializer::ReadTextureReferences(const std::uint8_t* data, size_t size, std::vector<std::string>& outPaths) {
+    return ReadReferences(data, size, true, outPaths);
+}
+
+bool SceneSerializer::ReadReferences(const std::uint8_t* data, size_t size, bool textures,
+                                     std::vector<std::string>& outValues) {
+    std::vector<std::string_view> strings;
+    bool delta = false;
+    if (!ReadStrings(data, size, strings, delta)) {
+        return false;
+    }
+
+    SceneSnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    std::uint32_t count = textures ? header.textureReferenceCount : header.meshReferenceCount;
+    std::uint64_t offset = textures ? header.textureReferenceOffset : header.meshReferenceOffset;
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::uint32_t index;
+        std::memcpy(&index, data + offset + i * sizeof(std::uint32_t), sizeof(index));
+        if (index < strings.size()) {
+            outValues.emplace_back(strings[index]);
+        }
+    }
+    return true;
+}
+
+bool SceneSerializer::LoadFromMemory(Scene& scene, const std::uint8_t* data, size_t size,
+                                     Renderer::D3D11Renderer* renderer) {
+    MEMORY_SCOPE(Scene);
+
+    std::vector<std::string_view> strings;
+    bool delta = false;
+    if (!ReadStrings(data, size, strings, delta)) {
+        return false;
+    }
+
+    SceneSnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (delta) {
+        for (std::uint32_t i = 0; i < header.removedCount; i++) {
+            EntityID id;
+            std::memcpy(&id, data + header.removedOffset + i * sizeof(EntityID), sizeof(id));
+            scene.DestroyEntity(id);
+        }
+        scene.ProcessPendingDestroy();
+    }
+    else {
+        scene.DestroyAllEntities();
+    }
+
+    SnapshotLoadContext context;
+    context.renderer = renderer;
+
+    std::vector<std::pair<Entity*, EntityID>> parents;
+    SnapshotReader reader(data + header.entityOffset, static_cast<size_t>(header.entitySize), &strings);
+    for (std::uint32_t i = 0; i < header.entityCount; i++) {
+        if (!ReadEntity(scene, reader, context, delta, parents)) {
+            LOG_ERROR("Scene snapshot entity record " << i << " is corrupt");
+            break;
+        }
+    }
+
+    // Parents may be stored after their children, so link once all exist
+    for (const auto& link : parents) {
+        link.first->SetParent(link.second != INVALID_ENTITY_ID ? scene.FindEntity(link.second) : nullptr);
+    }
+
+    // The scene now matches the file
+    ClearChanges(scene);
+    scene.m_snapshotTracking = true;
+
+    LOG_INFO("Loaded " << (delta ? "delta" : "snapshot") << " into scene " << scene.GetName() << " ("
+             << header.entityCount << " entities, " << header.removedCount << " removed)");
+    return reader.IsValid();
+}
+
+bool SceneSerializer::ReadEntity(Scene& scene, SnapshotReader& reader, SnapshotLoadContext& context, bool delta,
+                                 std::vector<std::pair<Entity*, EntityID>>& parents) {
+    SnapshotEntity record = reader.Read<SnapshotEntity>();
+    if (!reader.IsValid() || record.name >= reader.m_strings->size()) {
+        return false;
+    }
+
+    std::string name((*reader.m_strings)[record.name]);
+    Entity* entity = delta ? scene.FindEntity(record.id) : nullptr;
+    bool existing = entity != nullptr;
+    if (entity) {
+        entity->SetName(name);
+    }
+    else {
+        entity = scene.CreateEntity(record.id, name);
+        if (!entity) {
+            LOG_WARNING("Skipping scene snapshot entity " << record.id << " (" << name << ")");
+        }
+    }
+
+    std::vector<const Codec*> loaded;
+    for (std::uint16_t i = 0; i < record.componentCount; i++) {
+        std::uint32_t typeHash = reader.Read<std::uint32_t>();
+        std::uint32_t size = reader.Read<std::uint32_t>();
+        if (!reader.IsValid() || size > reader.GetRemaining()) {
+            return false;
+        }
+
+        // Codecs read from a window over their own payload
+        SnapshotReader payload(reader.m_data + reader.m_offset, size, reader.m_strings);
+        reader.m_offset += size;
+
+        const Codec* codec = FindCodec(Core::StringId(typeHash));
+        if (!codec) {
+            LOG_WARNING("Skipping component with unknown type " << Core::StringId(typeHash) << " on " << name);
+            continue;
+        }
+        if (entity && !codec->load(*entity, payload, context)) {
+            LOG_WARNING("Failed to load " << codec->typeName << " on " << name);
+        }
+        loaded.push_back(codec);
+    }
+
+    if (!entity) {
+        return true;
+    }
+
+    // A delta record holds all of the entity's components; drop the rest
+    if (existing) {
+        const ComponentRegistry& registry = scene.GetComponentRegistry();
+        for (const Codec& codec : GetCodecs()) {
+            ComponentPoolBase* pool = registry.GetPool(codec.componentType);
+            if (pool && pool->Contains(entity->GetID())
+                && std::find(loaded.begin(), loaded.end(), &codec) == loaded.end()) {
+                codec.remove(*entity);
+            }
+        }
+    }
+
+    Transform* transform = entity->GetTransform();
+    transform->SetLocalPosition(record.position);
+    transform->SetLocalRotation(record.rotation);
+    transform->SetLocalScale(record.scale);
+    entity->SetTags(record.tags);
+    entity->SetActive(record.active != 0);
+
+    parents.emplace_back(entity, record.parent);
+    return true;
+}
+
+void SceneSerializer::ClearChanges(Scene& scene) {
+    for (EntityID id : scene.m_snapshotDirty) {
+        Entity* entity = scene.FindEntity(id);
+        if (entity) {
+            entity->m_snapshotDirty = false;
+        }
+    }
+    scene.m_snapshotDirty.clear();
+    scene.m_snapshotRemoved.clear();
+}
+
+bool SceneSerializer::ExportXml(const Scene& scene, const std::string& path) {
+    auto document = XML_MANAGER.CreateDocument();
+    document->AddDeclaration("1.0", "UTF-8");
+
+    auto root = document->CreateRoot("Scene");
+    root.SetAttribute("name", scene.GetName());
+
+    const ComponentRegistry& registry = scene.GetComponentRegistry();
+    for (const auto& entity : scene.GetAllEntities()) {
+        if (!entity || entity->IsDestroyed()) {
+            continue;
+        }
+
+        EntityID id = entity->GetID();
+        auto entityNode = root.AppendChild("Entity");
+        entityNode.SetAttribute("id", std::to_string(id));
+        entityNode.SetAttribute("name", entity->GetName());
+        entityNode.SetAttribute("parent", std::to_string(entity->GetParent() ? entity->GetParent()->GetID() : INVALID_ENTITY_ID));
+        entityNode.SetAttribute("tags", std::to_string(entity->GetTags()));
+        entityNode.SetAttribute("active", entity->IsActive());
+
+        const Transform* transform = entity->GetTransform();
+        auto transformNode = entityNode.AppendChild("Transform");
+        SetVectorAttributes(transformNode, "position", transform->GetLocalPosition());
+        SetVectorAttributes(transformNode, "rotation", transform->GetLocalRotation());
+        SetVectorAttributes(transformNode, "scale", transform->GetLocalScale());
+
+        for (const Codec& codec : GetCodecs()) {
+            ComponentPoolBase* pool = registry.GetPool(codec.componentType);
+            Component* component = pool ? pool->GetComponent(id) : nullptr;
+            if (component) {
+                auto componentNode = entityNode.AppendChild("Component");
+                componentNode.SetAttribute("type", codec.typeName);
+                if (codec.exportXml) {
+                    codec.exportXml(*component, componentNode);
+                }
+            }
+        }
+    }
+
+    if (!XML_MANAGER.SaveDocument(document, path)) {
+        LOG_ERROR("Failed to export scene " << scene.GetName() << " to " << path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Scene
+} // namespace GameEngine
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "Entity.h"
+#include "../Core/StringId.h"
+
+namespace GameEngine {
+
+// Forward declarations
+namespace Renderer { class D3D11Renderer; }
+namespace Core { class XmlNode; }
+namespace Mesh { class Material; }
+
+namespace Scene {
+
+class Scene;
+
+// State shared by the component codecs during one Load
+struct SnapshotLoadContext {
+    Renderer::D3D11Renderer* renderer = nullptr;    // Needed to load material textures
+    // Materials created so far, keyed by their saved contents, so renderers
+    // that shared a material before saving share one again
+    std::unordered_map<std::string, std::shared_ptr<Mesh::Material>> materials;
+};
+
+// Appends plain values to a snapshot. Strings are pooled: each distinct
+// string is stored once in the file's string table and written as an index.
+class SnapshotWriter {
+public:
+    SnapshotWriter() = default;
+
+    template<typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot values must be trivially copyable");
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteBytes(const void* data, size_t size);
+    void WriteString(const std::string& value) { Write(AddString(value)); }
+
+    // Pools the string and returns its table index
+    std::uint32_t AddString(const std::string& value);
+
+    // List a mesh or texture the snapshot needs, so loaders can fetch it ahead of time
+    void AddMeshReference(const std::string& name);
+    void AddTextureReference(const std::string& path);
+
+    size_t GetSize() const { return m_buffer.size(); }
+
+private:
+    std::vector<std::uint8_t> m_buffer;
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string, std::uint32_t> m_stringIndices;
+    std::vector<std::uint32_t> m_meshReferences;
+    std::vector<std::uint32_t> m_textureReferences;
+
+    friend class SceneSerializer;
+};
+
+// Reads values back in the order they were written. Reading past the end
+// marks the reader invalid and yields zeroes, so callers check IsValid once
+// after a whole record instead of after every value.
+class SnapshotReader {
+public:
+    SnapshotReader(const std::uint8_t* data, size_t size, const std::vector<std::string_view>* strings)
+        : m_data(data), m_size(size), m_offset(0), m_strings(strings), m_valid(true) {}
+
+    template<typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot values must be trivially copyable");
+        T value{};
+        ReadBytes(&value, sizeof(T));
+        return value;
+    }
+
+    void ReadBytes(void* data, size_t size);
+    std::string ReadString();
+
+    bool IsValid() const { return m_valid; }
+    size_t GetRemaining() const { return m_size - m_offset; }
+
+private:
+    const std::uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset;
+    const std::vector<std::string_view>* m_strings;
+    bool m_valid;
+
+    friend class SceneSerializer;
+};
+
+// Binary scene snapshots.
+//
+// A full snapshot stores every live entity: ID, parent, name, tags, active
+// flag, local transform and one record per component type that has a
+// registered codec. Component records carry their size, so a reader skips
+// types it has no codec for. Asset references (mesh names, texture paths)
+// are stored as strings and resolved through the asset managers on load.
+//
+// After a full Save the scene tracks its changes, and SaveDelta writes only
+// the entities created, changed or removed since the previous save. Deltas
+// are applied in order on top of their base with Load.
+//
+// Layout: SceneSnapshotHeader, then 16-byte aligned sections for the entity
+// records, removed IDs, string table, and referenced mesh names and
+// texture paths. Loading maps
+// the file and reads records and strings straight from the mapped view.
+class SceneSerializer {
+public:
+    static constexpr std::uint32_t MAGIC = 0x43534547;    // "GESC"
+    static constexpr std::uint32_t VERSION = 2;
+    static constexpr const char* EXTENSION = ".gscene";
+    static constexpr const char* DELTA_EXTENSION = ".gdelta";
+
+    template<typename T>
+    using SaveFunc = void (*)(const T& component, SnapshotWriter& writer);
+    template<typename T>
+    using LoadFunc = bool (*)(T& component, SnapshotReader& reader, SnapshotLoadContext& context);
+    template<typename T>
+    using ExportFunc = void (*)(const T& component, Core::XmlNode& node);
+
+    // Add or replace the codec for a component type. typeName identifies the
+    // records in files, so it must stay stable once scenes have been saved.
+    template<typename T>
+    static void RegisterComponent(const std::string& typeName, SaveFunc<T> save, LoadFunc<T> load,
+                                  ExportFunc<T> exportXml = nullptr);
+
+    // Full snapshot of every live entity; turns on change tracking
+    static bool Save(Scene& scene, const std::string& path);
+    // Entities changed or removed since the last Save or SaveDelta
+    static bool SaveDelta(Scene& scene, const std::string& path);
+
+    // A full snapshot replaces the scene's entities; a delta is applied on
+    // top. The renderer is needed to load material textures.
+    static bool Load(Scene& scene, const std::string& path, Renderer::D3D11Renderer* renderer = nullptr);
+    static bool LoadFromMemory(Scene& scene, const std::uint8_t* data, size_t size,
+                               Renderer::D3D11Renderer* renderer = nullptr);
+
+    // Meshes and material textures a snapshot in memory refers to, without loading it
+    static bool ReadMeshReferences(const std::uint8_t* data, size_t size, std::vector<std::string>& outNames);
+    static bool ReadTextureReferences(const std::uint8_t* data, size_t size, std::vector<std::string>& outPaths);
+
+    // Readable dump of the scene for debugging; not loadable
+    static bool ExportXml(const Scene& scene, const std::string& path);
+
+private:
+    struct Codec {
+        std::string typeName;
+        Core::StringId typeId;
+        ComponentTypeID componentType;
+        std::function<void(const Component&, SnapshotWriter&)> save;
+        std::function<bool(Entity&, SnapshotReader&, SnapshotLoadContext&)> load;
+        std::function<void(Entity&)> remove;
+        std::function<void(const Component&, Core::XmlNode&)> exportXml;
+    };
+
+    template<typename T>
+    static Codec MakeCodec(const std::string& typeName, SaveFunc<T> save, LoadFunc<T> load, ExportFunc<T> exportXml);
+
+    static std::vector<Codec>& GetCodecs();
+    static const Codec* FindCodec(Core::StringId typeId);
+
+    static bool Write(Scene& scene, const std::string& path, bool delta);
+    static bool ReadStrings(const std::uint8_t* data, size_t size, std::vector<std::string_view>& outStrings,
+                            bool& outDelta);
+    static bool ReadReferences(const std::uint8_t* data, size_t size, bool textures, std::vector<std::string>& outValues);
+    static void WriteEntity(const Scene& scene, const Entity& entity, SnapshotWriter& writer);
+    static bool ReadEntity(Scene& scene, SnapshotReader& reader, SnapshotLoadContext& context, bool delta,
+                           std::vector<std::pair<Entity*, EntityID>>& parents);
+    static void ClearChanges(Scene& scene);
+};
+
+// ---------------------------------------------------------------------------
+// Template implementations
+
+template<typename T>
+SceneSerializer::Codec SceneSerializer::MakeCodec(const std::string& typeName, SaveFunc<T> save, LoadFunc<T> load,
+                                                  ExportFunc<T> exportXml) {
+    static_assert(std::is_base_of_v<Component, T>, "T must derive from Component");
+
+    Codec codec;
+    codec.typeName = typeName;
+    codec.typeId = Core::StringId(typeName);
+    codec.componentType = GetComponentTypeID<T>();
+    codec.save = [save](const Component& component, SnapshotWriter& writer) {
+        save(static_cast<const T&>(component), writer);
+    };
+    codec.load = [load](Entity& entity, SnapshotReader& reader, SnapshotLoadContext& context) {
+        T* component = entity.GetComponent<T>();
+        if (!component) {
+            component = entity.AddComponent<T>();
+        }
+        return component && load(*component, reader, context);
+    };
+    codec.remove = [](Entity& entity) {
+        entity.RemoveComponent<T>();
+    };
+    if (exportXml) {
+        codec.exportXml = [exportXml](const Component& component, Core::XmlNode& node) {
+            exportXml(static_cast<const T&>(component), node);
+        };
+    }
+    return codec;
+}
+
+template<typename T>
+void SceneSerializer::RegisterComponent(const std::string& typeName, SaveFunc<T> save, LoadFunc<T> load,
+                                        ExportFunc<T> exportXml) {
+    Codec codec = MakeCodec<T>(typeName, save, load, exportXml);
+    std::vector<Codec>& codecs = GetCodecs();
+    for (Codec& existing : codecs) {
+        if (existing.typeId == codec.typeId) {
+            existing = std::move(codec);
+            return;
+        }
+    }
+    codecs.push_back(std::move(codec));
+}
+
+} // namespace Scene
+} // namespace GameEngine
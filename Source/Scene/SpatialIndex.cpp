@@ -0,0 +1,374 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+
+namespace GameEngine {
+namespace Scene {
+
+SpatialIndex::SpatialIndex(float fatMargin)
+    : m_root(NULL_NODE)
+    , m_freeList(NULL_NODE)
+    , m_proxyCount(0)
+    , m_fatMargin(fatMargin)
+{
+}
+
+SpatialProxyID SpatialIndex::CreateProxy(const DirectX::BoundingBox& bounds, EntityID entity) {
+    std::int32_t leaf = AllocateNode();
+    Node& node = m_nodes[leaf];
+
+    // Fatten the bounds so small movements stay inside
+    node.minBounds = DirectX::XMFLOAT3(bounds.Center.x - bounds.Extents.x - m_fatMargin,
+                                       bounds.Center.y - bounds.Extents.y - m_fatMargin,
+                                       bounds.Center.z - bounds.Extents.z - m_fatMargin);
+    node.maxBounds = DirectX::XMFLOAT3(bounds.Center.x + bounds.Extents.x + m_fatMargin,
+                                       bounds.Center.y + bounds.Extents.y + m_fatMargin,
+                                       bounds.Center.z + bounds.Extents.z + m_fatMargin);
+    node.entity = entity;
+    node.height = 0;
+
+    InsertLeaf(leaf);
+    m_proxyCount++;
+
+    return leaf;
+}
+
+void SpatialIndex::DestroyProxy(SpatialProxyID proxy) {
+    if (proxy < 0 || proxy >= static_cast<SpatialProxyID>(m_nodes.size()) || m_nodes[proxy].height != 0) {
+        return;
+    }
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_proxyCount--;
+}
+
+bool SpatialIndex::MoveProxy(SpatialProxyID proxy, const DirectX::BoundingBox& bounds) {
+    Node& node = m_nodes[proxy];
+
+    DirectX::XMFLOAT3 newMin(bounds.Center.x - bounds.Extents.x,
+                             bounds.Center.y - bounds.Extents.y,
+                             bounds.Center.z - bounds.Extents.z);
+    DirectX::XMFLOAT3 newMax(bounds.Center.x + bounds.Extents.x,
+                             bounds.Center.y + bounds.Extents.y,
+                             bounds.Center.z + bounds.Extents.z);
+
+    // Still inside the fat bounds, nothing to do
+    if (newMin.x >= node.minBounds.x && newMin.y >= node.minBounds.y && newMin.z >= node.minBounds.z &&
+        newMax.x <= node.maxBounds.x && newMax.y <= node.maxBounds.y && newMax.z <= node.maxBounds.z) {
+        return false;
+    }
+
+    RemoveLeaf(proxy);
+
+    node.minBounds = DirectX::XMFLOAT3(newMin.x - m_fatMargin, newMin.y - m_fatMargin, newMin.z - m_fatMargin);
+    node.maxBounds = DirectX::XMFLOAT3(newMax.x + m_fatMargin, newMax.y + m_fatMargin, newMax.z + m_fatMargin);
+
+    InsertLeaf(proxy);
+    return true;
+}
+
+void SpatialIndex::Clear() {
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_freeList = NULL_NODE;
+    m_proxyCount = 0;
+}
+
+DirectX::BoundingBox SpatialIndex::GetFatBounds(SpatialProxyID proxy) const {
+    return ToBoundingBox(m_nodes[proxy]);
+}
+
+void SpatialIndex::QueryFrustum(const DirectX::BoundingFrustum& frustum, std::vector<EntityID>& results) const {
+    Query([&frustum](const DirectX::BoundingBox& box) { return frustum.Contains(box); }, results);
+}
+
+void SpatialIndex::QuerySphere(const DirectX::BoundingSphere& sphere, std::vector<EntityID>& results) const {
+    Query([&sphere](const DirectX::BoundingBox& box) { return sphere.Contains(box); }, results);
+}
+
+void SpatialIndex::QueryBox(const DirectX::BoundingBox& queryBox, std::vector<EntityID>& results) const {
+    Query([&queryBox](const DirectX::BoundingBox& box) { return queryBox.Contains(box); }, results);
+}
+
+void SpatialIndex::QueryOrientedBox(const DirectX::BoundingOrientedBox& queryBox, std::vector<EntityID>& results) const {
+    Query([&queryBox](const DirectX::BoundingBox& box) { return queryBox.Contains(box); }, results);
+}
+
+void SpatialIndex::QueryRay(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float maxDistance,
+                            std::vector<EntityID>& results) const {
+    DirectX::XMVECTOR rayOrigin = DirectX::XMLoadFloat3(&origin);
+    DirectX::XMVECTOR rayDirection = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&direction));
+
+    // A ray never fully contains a box, so every hit keeps descending
+    Query([&](const DirectX::BoundingBox& box) {
+        float distance = 0.0f;
+        if (box.Intersects(rayOrigin, rayDirection, distance) && distance <= maxDistance) {
+            return DirectX::INTERSECTS;
+        }
+        return DirectX::DISJOINT;
+    }, results);
+}
+
+std::int32_t SpatialIndex::AllocateNode() {
+    std::int32_t nodeIndex;
+
+    if (m_freeList != NULL_NODE) {
+        nodeIndex = m_freeList;
+        m_freeList = m_nodes[nodeIndex].parent;
+    }
+    else {
+        nodeIndex = static_cast<std::int32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[nodeIndex];
+    node.entity = INVALID_ENTITY_ID;
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+
+    return nodeIndex;
+}
+
+void SpatialIndex::FreeNode(std::int32_t nodeIndex) {
+    Node& node = m_nodes[nodeIndex];
+    node.parent = m_freeList;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = -1;
+    m_freeList = nodeIndex;
+}
+
+void SpatialIndex::InsertLeaf(std::int32_t leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Find the best sibling using the surface area heuristic
+    const Node& leafNode = m_nodes[leaf];
+    std::int32_t index = m_root;
+
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+        std::int32_t child1 = node.child1;
+        std::int32_t child2 = node.child2;
+
+        float area = SurfaceArea(node.minBounds, node.maxBounds);
+
+        DirectX::XMFLOAT3 combinedMin, combinedMax;
+        Union(node, leafNode, combinedMin, combinedMax);
+        float combinedArea = SurfaceArea(combinedMin, combinedMax);
+
+        // Cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](std::int32_t childIndex) {
+            const Node& child = m_nodes[childIndex];
+            DirectX::XMFLOAT3 unionMin, unionMax;
+            Union(child, leafNode, unionMin, unionMax);
+            float unionArea = SurfaceArea(unionMin, unionMax);
+            if (child.IsLeaf()) {
+                return unionArea + inheritanceCost;
+            }
+            return (unionArea - SurfaceArea(child.minBounds, child.maxBounds)) + inheritanceCost;
+        };
+
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+
+        index = (cost1 < cost2) ? child1 : child2;
+    }
+
+    std::int32_t sibling = index;
+
+    // Create a new parent for the sibling and the leaf
+    std::int32_t oldParent = m_nodes[sibling].parent;
+    std::int32_t newParent = AllocateNode();
+
+    Node& parentNode = m_nodes[newParent];
+    parentNode.parent = oldParent;
+    Union(m_nodes[leaf], m_nodes[sibling], parentNode.minBounds, parentNode.maxBounds);
+    parentNode.height = m_nodes[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+
+    if (oldParent != NULL_NODE) {
+        if (m_nodes[oldParent].child1 == sibling) {
+            m_nodes[oldParent].child1 = newParent;
+        }
+        else {
+            m_nodes[oldParent].child2 = newParent;
+        }
+    }
+    else {
+        m_root = newParent;
+    }
+
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    // Walk back up fixing heights and bounds
+    RefitAncestors(m_nodes[leaf].parent);
+}
+
+void SpatialIndex::RemoveLeaf(std::int32_t leaf) {
+    if (leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    std::int32_t parent = m_nodes[leaf].parent;
+    std::int32_t grandParent = m_nodes[parent].parent;
+    std::int32_t sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != NULL_NODE) {
+        // Connect the sibling to the grandparent and drop the parent
+        if (m_nodes[grandParent].child1 == parent) {
+            m_nodes[grandParent].child1 = sibling;
+        }
+        else {
+            m_nodes[grandParent].child2 = sibling;
+        }
+        m_nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        RefitAncestors(grandParent);
+    }
+    else {
+        m_root = sibling;
+        m_nodes[sibling].parent = NULL_NODE;
+        FreeNode(parent);
+    }
+
+    m_nodes[leaf].parent = NULL_NODE;
+}
+
+void SpatialIndex::RefitAncestors(std::int32_t index) {
+    while (index != NULL_NODE) {
+        index = Balance(index);
+
+        Node& node = m_nodes[index];
+        const Node& child1 = m_nodes[node.child1];
+        const Node& child2 = m_nodes[node.child2];
+
+        node.height = 1 + std::max(child1.height, child2.height);
+        Union(child1, child2, node.minBounds, node.maxBounds);
+
+        index = node.parent;
+    }
+}
+
+// Rotate the subtree rooted at a if it is imbalanced. Returns the new root.
+std::int32_t SpatialIndex::Balance(std::int32_t a) {
+    Node& nodeA = m_nodes[a];
+    if (nodeA.IsLeaf() || nodeA.height < 2) {
+        return a;
+    }
+
+    std::int32_t b = nodeA.child1;
+    std::int32_t c = nodeA.child2;
+    int balance = m_nodes[c].height - m_nodes[b].height;
+
+    // Rotate c up (or b up, symmetrically)
+    auto rotate = [this, a](std::int32_t up, std::int32_t other, bool upIsChild2) {
+        Node& nodeA = m_nodes[a];
+        Node& nodeUp = m_nodes[up];
+        std::int32_t f = nodeUp.child1;
+        std::int32_t g = nodeUp.child2;
+
+        // Swap a and up
+        nodeUp.child1 = a;
+        nodeUp.parent = nodeA.parent;
+        nodeA.parent = up;
+
+        if (nodeUp.parent != NULL_NODE) {
+            if (m_nodes[nodeUp.parent].child1 == a) {
+                m_nodes[nodeUp.parent].child1 = up;
+            }
+            else {
+                m_nodes[nodeUp.parent].child2 = up;
+            }
+        }
+        else {
+            m_root = up;
+        }
+
+        // Keep the taller grandchild under up
+        std::int32_t keep = (m_nodes[f].height > m_nodes[g].height) ? f : g;
+        std::int32_t move = (keep == f) ? g : f;
+
+        nodeUp.child2 = keep;
+        if (upIsChild2) {
+            nodeA.child2 = move;
+        }
+        else {
+            nodeA.child1 = move;
+        }
+        m_nodes[move].parent = a;
+
+        Union(m_nodes[other], m_nodes[move], nodeA.minBounds, nodeA.maxBounds);
+        Union(nodeA, m_nodes[keep], nodeUp.minBounds, nodeUp.maxBounds);
+
+        nodeA.height = 1 + std::max(m_nodes[other].height, m_nodes[move].height);
+        nodeUp.height = 1 + std::max(nodeA.height, m_nodes[keep].height);
+
+        return up;
+    };
+
+    if (balance > 1) {
+        return rotate(c, b, true);
+    }
+    if (balance < -1) {
+        return rotate(b, c, false);
+    }
+
+    return a;
+}
+
+void SpatialIndex::CollectLeaves(std::int32_t nodeIndex, std::vector<EntityID>& results) const {
+    const Node& node = m_nodes[nodeIndex];
+    if (node.IsLeaf()) {
+        results.push_back(node.entity);
+        return;
+    }
+
+    CollectLeaves(node.child1, results);
+    CollectLeaves(node.child2, results);
+}
+
+DirectX::BoundingBox SpatialIndex::ToBoundingBox(const Node& node) {
+    DirectX::BoundingBox box;
+    DirectX::BoundingBox::CreateFromPoints(box,
+        DirectX::XMLoadFloat3(&node.minBounds),
+        DirectX::XMLoadFloat3(&node.maxBounds));
+    return box;
+}
+
+float SpatialIndex::SurfaceArea(const DirectX::XMFLOAT3& minBounds, const DirectX::XMFLOAT3& maxBounds) {
+    float dx = maxBounds.x - minBounds.x;
+    float dy = maxBounds.y - minBounds.y;
+    float dz = maxBounds.z - minBounds.z;
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+void SpatialIndex::Union(const Node& a, const Node& b, DirectX::XMFLOAT3& minBounds, DirectX::XMFLOAT3& maxBounds) {
+    minBounds = DirectX::XMFLOAT3(std::min(a.minBounds.x, b.minBounds.x),
+                                  std::min(a.minBounds.y, b.minBounds.y),
+                                  std::min(a.minBounds.z, b.minBounds.z));
+    maxBounds = DirectX::XMFLOAT3(std::max(a.maxBounds.x, b.maxBounds.x),
+                                  std::max(a.maxBounds.y, b.maxBounds.y),
+                                  std::max(a.maxBounds.z, b.maxBounds.z));
+}
+
+} // namespace Scene
+} // namespace GameEngine
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <vector>
+#include <cstdint>
+#include "Entity.h"
+
+namespace GameEngine {
+namespace Scene {
+
+// Dynamic AABB tree keyed by entity.
+//
+// Leaves store "fat" bounds enlarged by a margin so small movements don't
+// require a reinsert. Internal nodes are kept height-balanced with tree
+// rotations, giving logarithmic insert, remove and query cost.
+class SpatialIndex {
+public:
+    SpatialIndex(float fatMargin = 0.1f);
+    ~SpatialIndex() = default;
+
+    // Proxy management
+    SpatialProxyID CreateProxy(const DirectX::BoundingBox& bounds, EntityID entity);
+    void DestroyProxy(SpatialProxyID proxy);
+    bool MoveProxy(SpatialProxyID proxy, const DirectX::BoundingBox& bounds);
+    void Clear();
+
+    EntityID GetEntity(SpatialProxyID proxy) const { return m_nodes[proxy].entity; }
+    DirectX::BoundingBox GetFatBounds(SpatialProxyID proxy) const;
+
+    // Queries append matching entities to results
+    void QueryFrustum(const DirectX::BoundingFrustum& frustum, std::vector<EntityID>& results) const;
+    void QuerySphere(const DirectX::BoundingSphere& sphere, std::vector<EntityID>& results) const;
+    void QueryBox(const DirectX::BoundingBox& box, std::vector<EntityID>& results) const;
+    void QueryOrientedBox(const DirectX::BoundingOrientedBox& box, std::vector<EntityID>& results) const;
+    void QueryRay(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float maxDistance,
+                  std::vector<EntityID>& results) const;
+
+    // Statistics
+    size_t GetProxyCount() const { return m_proxyCount; }
+    int GetHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+
+private:
+    static constexpr std::int32_t NULL_NODE = -1;
+
+    struct Node {
+        DirectX::XMFLOAT3 minBounds;
+        DirectX::XMFLOAT3 maxBounds;
+        EntityID entity;
+        std::int32_t parent;       // Also used as the free-list link
+        std::int32_t child1;
+        std::int32_t child2;
+        std::int32_t height;       // Leaf = 0, free node = -1
+
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::int32_t AllocateNode();
+    void FreeNode(std::int32_t node);
+
+    void InsertLeaf(std::int32_t leaf);
+    void RemoveLeaf(std::int32_t leaf);
+    std::int32_t Balance(std::int32_t node);
+    void RefitAncestors(std::int32_t node);
+
+    // Visit every leaf under node without further tests
+    void CollectLeaves(std::int32_t node, std::vector<EntityID>& results) const;
+
+    template<typename TestFunc>
+    void Query(TestFunc test, std::vector<EntityID>& results) const;
+
+    static DirectX::BoundingBox ToBoundingBox(const Node& node);
+    static float SurfaceArea(const DirectX::XMFLOAT3& minBounds, const DirectX::XMFLOAT3& maxBounds);
+    static void Union(const Node& a, const Node& b, DirectX::XMFLOAT3& minBounds, DirectX::XMFLOAT3& maxBounds);
+
+    std::vector<Node> m_nodes;
+    std::int32_t m_root;
+    std::int32_t m_freeList;
+    size_t m_proxyCount;
+    float m_fatMargin;
+};
+
+// Generic stack-based traversal. test returns DISJOINT, INTERSECTS or
+// CONTAINS; fully contained subtrees are accepted without more tests.
+template<typename TestFunc>
+void SpatialIndex::Query(TestFunc test, std::vector<EntityID>& results) const {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    std::int32_t stack[128];
+    int stackSize = 0;
+    stack[stackSize++] = m_root;
+
+    while (stackSize > 0) {
+        std::int32_t nodeIndex = stack[--stackSize];
+        const Node& node = m_nodes[nodeIndex];
+
+        DirectX::ContainmentType containment = test(ToBoundingBox(node));
+        if (containment == DirectX::DISJOINT) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            results.push_back(node.entity);
+        }
+        else if (containment == DirectX::CONTAINS) {
+            CollectLeaves(nodeIndex, results);
+        }
+        else if (stackSize + 2 <= 128) {
+            stack[stackSize++] = node.child1;
+            stack[stackSize++] = node.child2;
+        }
+        else {
+            // Balanced trees never get this deep; fall back to a conservative result
+            CollectLeaves(nodeIndex, results);
+        }
+    }
+}
+
+} // namespace Scene
+} // namespace GameEngine
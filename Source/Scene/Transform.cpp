@@ -1,5 +1,6 @@
 #include "Transform.h"
 #include "Entity.h"
+#include "Scene.h"
 #include "../Core/Logger.h"
 #include <algorithm>
 
@@ -15,6 +16,9 @@ Transform::Transform()
     , m_localMatrixDirty(true)
     , m_worldMatrixDirty(true)
     , m_isDirty(true)
+    , m_renderMatrix(DirectX::XMMatrixIdentity())
+    , m_hasRenderMatrix(false)
+    , m_hierarchyIndex(0xFFFFFFFF)
 {
 }
 
@@ -163,6 +167,10 @@ DirectX::XMMATRIX Transform::GetInverseWorldMatrix() const {
     return DirectX::XMMatrixInverse(nullptr, GetWorldMatrix());
 }
 
+DirectX::XMMATRIX Transform::GetRenderMatrix() const {
+    return m_hasRenderMatrix ? m_renderMatrix : GetWorldMatrix();
+}
+
 // Transform operations
 void Transform::Translate(const DirectX::XMFLOAT3& translation) {
     m_localPosition.x += translation.x;
@@ -279,6 +287,19 @@ Transform* Transform::GetParent() const {
     return nullptr;
 }
 
+void Transform::MarkDirty() {
+    if (m_isDirty) {
+        return;
+    }
+
+    m_isDirty = true;
+
+    // Let the scene refresh spatial data for this entity
+    if (m_entity && m_entity->GetScene()) {
+        m_entity->GetScene()->OnTransformChanged(m_entity);
+    }
+}
+
 // Private methods
 void Transform::UpdateLocalMatrix() const {
     if (m_localMatrixDirty) {
@@ -358,6 +379,7 @@ void Transform::MarkWorldMatrixDirty() const {
     if (m_entity) {
         for (Entity* child : m_entity->GetChildren()) {
             if (child && child->GetTransform()) {
+                child->GetTransform()->MarkDirty();
                 child->GetTransform()->MarkWorldMatrixDirty();
             }
         }
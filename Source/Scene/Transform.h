@@ -4,6 +4,7 @@
 #include "../Math/Vector3.h"
 #include "../Math/Matrix4.h"
 #include <DirectXMath.h>
+#include <cstdint>
 
 namespace GameEngine {
 namespace Scene {
@@ -49,6 +50,9 @@ public:
     DirectX::XMMATRIX GetLocalMatrix() const;
     DirectX::XMMATRIX GetWorldMatrix() const;
     DirectX::XMMATRIX GetInverseWorldMatrix() const;
+    // What to draw with: blended between the last two fixed steps when the
+    // scene interpolates, otherwise the world matrix
+    DirectX::XMMATRIX GetRenderMatrix() const;
 
     // Transform operations
     void Translate(const DirectX::XMFLOAT3& translation);
@@ -74,7 +78,7 @@ public:
 
     // Dirty flag for optimization
     bool IsDirty() const { return m_isDirty; }
-    void MarkDirty() { m_isDirty = true; }
+    void MarkDirty();
     void MarkClean() { m_isDirty = false; }
 
     // Lifecycle
@@ -93,6 +97,10 @@ private:
     mutable bool m_worldMatrixDirty;
     bool m_isDirty;
 
+    // Written by TransformHierarchy::Interpolate
+    DirectX::XMMATRIX m_renderMatrix;
+    bool m_hasRenderMatrix;
+
     // Helper methods
     void UpdateLocalMatrix() const;
     void UpdateWorldMatrix() const;
@@ -101,6 +109,12 @@ private:
 
     // Mark world matrix dirty for this transform and all children
     void MarkWorldMatrixDirty() const;
+
+    // Slot in the scene's batched transform hierarchy
+    std::uint32_t m_hierarchyIndex;
+
+    friend class Entity;
+    friend class TransformHierarchy;
 };
 
 } // namespace Scene
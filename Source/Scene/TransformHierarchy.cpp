@@ -0,0 +1,326 @@
+#include "TransformHierarchy.h"
+#include "Transform.h"
+#include <algorithm>
+#include <cstring>
+
+namespace GameEngine {
+namespace Scene {
+
+namespace {
+    constexpr std::uint8_t CLEAN = 0;
+    constexpr std::uint8_t LOCAL_DIRTY = 1;   // Local matrix must be re-read from the Transform
+    constexpr std::uint8_t WORLD_DIRTY = 2;   // Only the parent moved
+}
+
+TransformHierarchy::TransformHierarchy()
+    : m_orderDirty(false)
+    , m_anyDirty(false)
+    , m_parallelThreshold(1024)
+    , m_lastUpdatedCount(0)
+{
+}
+
+void TransformHierarchy::Add(Transform* transform) {
+    if (!transform || transform->m_hierarchyIndex != INVALID_INDEX) {
+        return;
+    }
+
+    transform->m_hierarchyIndex = static_cast<std::uint32_t>(m_owners.size());
+
+    m_owners.push_back(transform);
+    m_parents.push_back(-1);
+    m_depths.push_back(0);
+    m_dirty.push_back(LOCAL_DIRTY);
+    m_localMatrices.push_back(DirectX::XMMatrixIdentity());
+    m_worldMatrices.push_back(DirectX::XMMatrixIdentity());
+    m_previousWorldMatrices.push_back(DirectX::XMMatrixIdentity());
+    m_hasPrevious.push_back(0);
+
+    // Appending breaks the depth ordering
+    m_orderDirty = true;
+    m_anyDirty = true;
+}
+
+void TransformHierarchy::Remove(Transform* transform) {
+    if (!transform || transform->m_hierarchyIndex == INVALID_INDEX) {
+        return;
+    }
+
+    // Leave a hole that the next rebuild compacts
+    m_owners[transform->m_hierarchyIndex] = nullptr;
+    m_dirty[transform->m_hierarchyIndex] = CLEAN;
+    transform->m_hierarchyIndex = INVALID_INDEX;
+    m_orderDirty = true;
+}
+
+void TransformHierarchy::Clear() {
+    for (Transform* owner : m_owners) {
+        if (owner) {
+            owner->m_hierarchyIndex = INVALID_INDEX;
+        }
+    }
+
+    m_owners.clear();
+    m_parents.clear();
+    m_depths.clear();
+    m_dirty.clear();
+    m_localMatrices.clear();
+    m_worldMatrices.clear();
+    m_previousWorldMatrices.clear();
+    m_hasPrevious.clear();
+    m_levelOffsets.clear();
+    m_orderDirty = false;
+    m_anyDirty = false;
+}
+
+void TransformHierarchy::MarkDirty(Transform* transform) {
+    if (!transform || transform->m_hierarchyIndex == INVALID_INDEX) {
+        return;
+    }
+
+    m_dirty[transform->m_hierarchyIndex] = LOCAL_DIRTY;
+    m_anyDirty = true;
+}
+
+void TransformHierarchy::Update(const ParallelForFunc& parallelFor) {
+    m_lastUpdatedCount = 0;
+
+    if (!m_anyDirty && !m_orderDirty) {
+        return;
+    }
+
+    // Detect reparenting among changed entries
+    std::uint32_t count = static_cast<std::uint32_t>(m_owners.size());
+    for (std::uint32_t i = 0; i < count; i++) {
+        if (m_dirty[i] == LOCAL_DIRTY && m_owners[i] && ResolveParent(i) != m_parents[i]) {
+            m_orderDirty = true;
+            break;
+        }
+    }
+
+    if (m_orderDirty) {
+        Rebuild();
+    }
+
+    // Walk level by level; each level only depends on the one above it
+    size_t levelCount = GetLevelCount();
+
+    for (size_t level = 0; level < levelCount; level++) {
+        std::uint32_t begin = m_levelOffsets[level];
+        std::uint32_t end = m_levelOffsets[level + 1];
+        std::uint32_t levelSize = end - begin;
+
+        if (parallelFor && levelSize >= m_parallelThreshold) {
+            parallelFor(levelSize, [this, begin](std::uint32_t chunkBegin, std::uint32_t chunkEnd) {
+                UpdateRange(begin + chunkBegin, begin + chunkEnd);
+            });
+        }
+        else {
+            UpdateRange(begin, end);
+        }
+    }
+
+    // Count and clear in a separate pass so children could read parent flags above
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(m_dirty.size()); i++) {
+        if (m_dirty[i] != CLEAN) {
+            m_dirty[i] = CLEAN;
+            m_lastUpdatedCount++;
+        }
+    }
+
+    m_anyDirty = false;
+}
+
+void TransformHierarchy::UpdateRange(std::uint32_t begin, std::uint32_t end) {
+    for (std::uint32_t i = begin; i < end; i++) {
+        std::int32_t parent = m_parents[i];
+
+        // Inherit dirtiness from the parent
+        if (m_dirty[i] == CLEAN) {
+            if (parent < 0 || m_dirty[parent] == CLEAN) {
+                continue;
+            }
+            m_dirty[i] = WORLD_DIRTY;
+        }
+
+        Transform* owner = m_owners[i];
+        if (m_dirty[i] == LOCAL_DIRTY) {
+            m_localMatrices[i] = owner->GetLocalMatrix();
+        }
+
+        m_worldMatrices[i] = (parent >= 0)
+            ? DirectX::XMMatrixMultiply(m_localMatrices[i], m_worldMatrices[parent])
+            : m_localMatrices[i];
+
+        // Write back so Transform::GetWorldMatrix hits its cache
+        owner->m_worldMatrix = m_worldMatrices[i];
+        owner->m_worldMatrixDirty = false;
+    }
+}
+
+void TransformHierarchy::StorePreviousWorld() {
+    m_previousWorldMatrices = m_worldMatrices;
+    std::fill(m_hasPrevious.begin(), m_hasPrevious.end(), static_cast<std::uint8_t>(1));
+}
+
+void TransformHierarchy::Interpolate(float alpha, const ParallelForFunc& parallelFor) {
+    alpha = std::min(std::max(alpha, 0.0f), 1.0f);
+    std::uint32_t count = static_cast<std::uint32_t>(m_owners.size());
+
+    if (parallelFor && count >= m_parallelThreshold) {
+        parallelFor(count, [this, alpha](std::uint32_t begin, std::uint32_t end) {
+            InterpolateRange(begin, end, alpha);
+        });
+    }
+    else {
+        InterpolateRange(0, count, alpha);
+    }
+}
+
+void TransformHierarchy::InterpolateRange(std::uint32_t begin, std::uint32_t end, float alpha) {
+    for (std::uint32_t i = begin; i < end; i++) {
+        Transform* owner = m_owners[i];
+        if (!owner) {
+            continue;
+        }
+
+        // Entries that did not move (or are new) draw their world matrix
+        const DirectX::XMMATRIX& previous = m_previousWorldMatrices[i];
+        const DirectX::XMMATRIX& current = m_worldMatrices[i];
+        owner->m_hasRenderMatrix = false;
+        if (!m_hasPrevious[i] || std::memcmp(&previous, &current, sizeof(DirectX::XMMATRIX)) == 0) {
+            continue;
+        }
+
+        // Blend the decomposed parts; lerping matrices directly would shear rotations
+        DirectX::XMVECTOR previousScale, previousRotation, previousTranslation;
+        DirectX::XMVECTOR currentScale, currentRotation, currentTranslation;
+        if (!DirectX::XMMatrixDecompose(&previousScale, &previousRotation, &previousTranslation, previous) ||
+            !DirectX::XMMatrixDecompose(&currentScale, &currentRotation, &currentTranslation, current)) {
+            continue;
+        }
+
+        owner->m_renderMatrix = DirectX::XMMatrixAffineTransformation(
+            DirectX::XMVectorLerp(previousScale, currentScale, alpha),
+            DirectX::XMVectorZero(),
+            DirectX::XMQuaternionSlerp(previousRotation, currentRotation, alpha),
+            DirectX::XMVectorLerp(previousTranslation, currentTranslation, alpha));
+        owner->m_hasRenderMatrix = true;
+    }
+}
+
+std::int32_t TransformHierarchy::ResolveParent(std::uint32_t index) const {
+    Transform* parent = m_owners[index]->GetParent();
+    if (!parent || parent->m_hierarchyIndex == INVALID_INDEX) {
+        return -1;
+    }
+    return static_cast<std::int32_t>(parent->m_hierarchyIndex);
+}
+
+void TransformHierarchy::Rebuild() {
+    std::uint32_t oldCount = static_cast<std::uint32_t>(m_owners.size());
+
+    // Refresh parent links for live entries, remembering who they were
+    std::vector<Transform*> previousParents(oldCount, nullptr);
+    for (std::uint32_t i = 0; i < oldCount; i++) {
+        if (m_parents[i] >= 0) {
+            previousParents[i] = m_owners[m_parents[i]];
+        }
+        m_parents[i] = m_owners[i] ? ResolveParent(i) : -1;
+    }
+
+    // Compute depths by walking up to the first entry with a known depth
+    const std::uint16_t UNKNOWN_DEPTH = 0xFFFF;
+    std::vector<std::uint16_t> depths(oldCount, UNKNOWN_DEPTH);
+    std::vector<std::uint32_t> chain;
+
+    std::uint16_t maxDepth = 0;
+    for (std::uint32_t i = 0; i < oldCount; i++) {
+        if (!m_owners[i] || depths[i] != UNKNOWN_DEPTH) {
+            continue;
+        }
+
+        chain.clear();
+        std::int32_t current = static_cast<std::int32_t>(i);
+        while (current >= 0 && depths[current] == UNKNOWN_DEPTH) {
+            chain.push_back(static_cast<std::uint32_t>(current));
+            current = m_parents[current];
+        }
+
+        std::uint16_t depth = (current >= 0) ? static_cast<std::uint16_t>(depths[current] + 1) : 0;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            depths[*it] = depth++;
+        }
+        maxDepth = std::max(maxDepth, static_cast<std::uint16_t>(depth - 1));
+    }
+
+    // Counting sort by depth, stable so siblings keep their relative order
+    std::vector<std::uint32_t> levelCounts(static_cast<size_t>(maxDepth) + 1, 0);
+    for (std::uint32_t i = 0; i < oldCount; i++) {
+        if (m_owners[i]) {
+            levelCounts[depths[i]]++;
+        }
+    }
+
+    m_levelOffsets.assign(levelCounts.size() + 1, 0);
+    for (size_t level = 0; level < levelCounts.size(); level++) {
+        m_levelOffsets[level + 1] = m_levelOffsets[level] + levelCounts[level];
+    }
+
+    std::uint32_t newCount = m_levelOffsets.back();
+    std::vector<std::uint32_t> remap(oldCount, INVALID_INDEX);
+    std::vector<std::uint32_t> cursor(m_levelOffsets.begin(), m_levelOffsets.end() - 1);
+    for (std::uint32_t i = 0; i < oldCount; i++) {
+        if (m_owners[i]) {
+            remap[i] = cursor[depths[i]]++;
+        }
+    }
+
+    // Permute every stream into the new order
+    std::vector<Transform*> owners(newCount);
+    std::vector<std::int32_t> parents(newCount);
+    std::vector<std::uint16_t> newDepths(newCount);
+    std::vector<std::uint8_t> dirty(newCount);
+    std::vector<DirectX::XMMATRIX> localMatrices(newCount);
+    std::vector<DirectX::XMMATRIX> worldMatrices(newCount);
+    std::vector<DirectX::XMMATRIX> previousWorldMatrices(newCount);
+    std::vector<std::uint8_t> hasPrevious(newCount);
+
+    for (std::uint32_t i = 0; i < oldCount; i++) {
+        std::uint32_t target = remap[i];
+        if (target == INVALID_INDEX) {
+            continue;
+        }
+
+        owners[target] = m_owners[i];
+        parents[target] = (m_parents[i] >= 0) ? static_cast<std::int32_t>(remap[m_parents[i]]) : -1;
+        newDepths[target] = depths[i];
+        dirty[target] = m_dirty[i];
+        localMatrices[target] = m_localMatrices[i];
+        worldMatrices[target] = m_worldMatrices[i];
+        previousWorldMatrices[target] = m_previousWorldMatrices[i];
+        hasPrevious[target] = m_hasPrevious[i];
+
+        // Reparented entries need a fresh world matrix
+        Transform* parent = (m_parents[i] >= 0) ? m_owners[m_parents[i]] : nullptr;
+        if (parent != previousParents[i] && dirty[target] == CLEAN) {
+            dirty[target] = WORLD_DIRTY;
+        }
+
+        owners[target]->m_hierarchyIndex = target;
+    }
+
+    m_owners.swap(owners);
+    m_parents.swap(parents);
+    m_depths.swap(newDepths);
+    m_dirty.swap(dirty);
+    m_localMatrices.swap(localMatrices);
+    m_worldMatrices.swap(worldMatrices);
+    m_previousWorldMatrices.swap(previousWorldMatrices);
+    m_hasPrevious.swap(hasPrevious);
+
+    m_orderDirty = false;
+}
+
+} // namespace Scene
+} // namespace GameEngine
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace GameEngine {
+namespace Scene {
+
+class Transform;
+
+// Splits [0, count) into chunks and runs body(begin, end) on each, possibly in parallel
+using ParallelForFunc = std::function<void(std::uint32_t count, const std::function<void(std::uint32_t, std::uint32_t)>& body)>;
+
+// Contiguous, depth-sorted store of local/world matrices for a scene.
+//
+// Entries are ordered by hierarchy depth so parents always precede their
+// children. One linear pass per frame recomputes the world matrix of every
+// dirty entry and its descendants, then writes the result back into the
+// owning Transform's cache. Entries inside one depth level only read
+// the previous level, so each level can be split across worker threads.
+class TransformHierarchy {
+public:
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    TransformHierarchy();
+    ~TransformHierarchy() = default;
+
+    // Registration
+    void Add(Transform* transform);
+    void Remove(Transform* transform);
+    void Clear();
+
+    // Flag a transform whose local matrix or parent changed
+    void MarkDirty(Transform* transform);
+
+    // Recompute dirty world matrices
+    void Update(const ParallelForFunc& parallelFor = nullptr);
+
+    // Fixed-timestep interpolation: remember the current world matrices as
+    // the previous step's, then after the next step blend alpha of the way
+    // from those into each moved Transform's render matrix
+    void StorePreviousWorld();
+    void Interpolate(float alpha, const ParallelForFunc& parallelFor = nullptr);
+
+    // Levels with at least this many entries are handed to parallelFor
+    void SetParallelThreshold(std::uint32_t threshold) { m_parallelThreshold = threshold; }
+
+    // Statistics
+    size_t GetCount() const { return m_owners.size(); }
+    size_t GetLevelCount() const { return m_levelOffsets.empty() ? 0 : m_levelOffsets.size() - 1; }
+    std::uint32_t GetLastUpdatedCount() const { return m_lastUpdatedCount; }
+
+private:
+    void Rebuild();
+    void UpdateRange(std::uint32_t begin, std::uint32_t end);
+    void InterpolateRange(std::uint32_t begin, std::uint32_t end, float alpha);
+    std::int32_t ResolveParent(std::uint32_t index) const;
+
+    // SoA storage, sorted by depth after Rebuild
+    std::vector<Transform*> m_owners;
+    std::vector<std::int32_t> m_parents;
+    std::vector<std::uint16_t> m_depths;
+    std::vector<std::uint8_t> m_dirty;
+    std::vector<DirectX::XMMATRIX> m_localMatrices;
+    std::vector<DirectX::XMMATRIX> m_worldMatrices;
+    std::vector<DirectX::XMMATRIX> m_previousWorldMatrices;
+    std::vector<std::uint8_t> m_hasPrevious;   // Zero until the entry's first stored step
+
+    // Start of each depth level, with a trailing end offset
+    std::vector<std::uint32_t> m_levelOffsets;
+
+    bool m_orderDirty;
+    bool m_anyDirty;
+    std::uint32_t m_parallelThreshold;
+    std::uint32_t m_lastUpdatedCount;
+};
+
+} // namespace Scene
+} // namespace GameEngine
@@ -0,0 +1,290 @@
+#include "WorldStreamer.h"
+#include "Scene.h"
+#include "SceneSerializer.h"
+#include "../Mesh/MeshManager.h"
+#include "../Renderer/Texture.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Logger.h"
+#include "../Core/MemoryTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+namespace GameEngine {
+namespace Scene {
+
+namespace {
+
+float DistanceToBox(const DirectX::XMFLOAT3& point, const DirectX::BoundingBox& box) {
+    float dx = std::max(std::fabs(point.x - box.Center.x) - box.Extents.x, 0.0f);
+    float dy = std::max(std::fabs(point.y - box.Center.y) - box.Extents.y, 0.0f);
+    float dz = std::max(std::fabs(point.z - box.Center.z) - box.Extents.z, 0.0f);
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+} // namespace
+
+WorldStreamer::WorldStreamer()
+    : m_origin(0.0f, 0.0f, 0.0f)
+    , m_residentBytes(0)
+    , m_renderer(nullptr)
+{
+}
+
+WorldStreamer::~WorldStreamer() {
+    RemoveAllCells();
+}
+
+bool WorldStreamer::AddCell(const std::string& name, const std::string& snapshotPath,
+                            const DirectX::BoundingBox& bounds, size_t memoryCost) {
+    if (!FILE_SYSTEM.FileExists(snapshotPath)) {
+        LOG_ERROR("Streaming cell '" << name << "' has no snapshot at " << snapshotPath);
+        return false;
+    }
+
+    auto cell = std::make_shared<Cell>();
+    cell->name = name;
+    cell->path = snapshotPath;
+    cell->bounds = bounds;
+    cell->memoryCost = memoryCost > 0 ? memoryCost : FILE_SYSTEM.GetFileSize(snapshotPath);
+    m_cells.push_back(cell);
+    return true;
+}
+
+void WorldStreamer::RemoveAllCells() {
+    for (auto& cell : m_cells) {
+        CancelLoad(*cell);
+        Unload(*cell);
+    }
+
+    // Loads still in flight hold weak references and are dropped on completion
+    m_cells.clear();
+    m_order.clear();
+    m_loadedScenes.clear();
+    m_residentBytes = 0;
+    m_stats = StreamingStats();
+}
+
+void WorldStreamer::Update() {
+    m_order.clear();
+    m_residentBytes = 0;
+    for (auto& cell : m_cells) {
+        cell->distance = DistanceToBox(m_origin, cell->bounds);
+        if (cell->state != CellState::Unloaded) {
+            m_residentBytes += cell->memoryCost;
+        }
+        m_order.push_back(cell.get());
+    }
+    std::sort(m_order.begin(), m_order.end(), [](const Cell* a, const Cell* b) {
+        return a->distance < b->distance;
+    });
+
+    // Drop what is out of range, farthest first
+    int unloads = 0;
+    for (auto it = m_order.rbegin(); it != m_order.rend() && (*it)->distance > m_settings.unloadRadius; ++it) {
+        Cell& cell = **it;
+        if (IsPending(cell)) {
+            CancelLoad(cell);
+        }
+        else if (cell.state == CellState::Loaded && unloads < m_settings.maxUnloadsPerFrame) {
+            Unload(cell);
+            unloads++;
+        }
+    }
+
+    // Cells whose meshes and textures have all arrived (or failed) can be activated
+    for (Cell* cell : m_order) {
+        if (cell->state == CellState::Fetching) {
+            bool fetching = std::any_of(cell->meshes.begin(), cell->meshes.end(),
+                    [](const Mesh::AssetHandle<Mesh::Mesh>& handle) { return handle.IsPending(); })
+                || std::any_of(cell->textures.begin(), cell->textures.end(),
+                    [](const Mesh::AssetHandle<Renderer::Texture>& handle) { return handle.IsPending(); });
+            if (!fetching) {
+                cell->state = CellState::Ready;
+            }
+        }
+    }
+
+    int activations = 0;
+    for (Cell* cell : m_order) {
+        if (activations >= m_settings.maxActivationsPerFrame) {
+            break;
+        }
+        if (cell->state == CellState::Ready) {
+            Activate(*cell);
+            activations++;
+        }
+    }
+
+    // Start loads nearest first while the budget allows
+    m_stats.deferredLoads = 0;
+    for (size_t i = 0; i < m_order.size() && m_order[i]->distance <= m_settings.loadRadius; i++) {
+        Cell* cell = m_order[i];
+        if (cell->state != CellState::Unloaded || cell->failed) {
+            continue;
+        }
+
+        if (m_stats.deferredLoads > 0
+            || (m_residentBytes + cell->memoryCost > m_settings.memoryBudget && !MakeRoom(cell->memoryCost, cell->distance))) {
+            m_stats.deferredLoads++;
+            continue;
+        }
+
+        for (auto& owned : m_cells) {
+            if (owned.get() == cell) {
+                RequestLoad(owned);
+                break;
+            }
+        }
+    }
+
+    m_loadedScenes.clear();
+    m_stats.cellCount = static_cast<std::uint32_t>(m_cells.size());
+    m_stats.loadedCells = 0;
+    m_stats.pendingCells = 0;
+    for (Cell* cell : m_order) {
+        if (cell->state == CellState::Loaded) {
+            m_loadedScenes.push_back(cell->scene);
+            m_stats.loadedCells++;
+        }
+        else if (IsPending(*cell)) {
+            m_stats.pendingCells++;
+        }
+    }
+    m_stats.residentBytes = m_residentBytes;
+}
+
+void WorldStreamer::RequestLoad(const std::shared_ptr<Cell>& cell) {
+    cell->state = CellState::Reading;
+    cell->request++;
+    m_residentBytes += cell->memoryCost;
+
+    Mesh::LoadPriority priority = cell->distance < m_settings.loadRadius * 0.5f
+        ? Mesh::LoadPriority::High : Mesh::LoadPriority::Normal;
+    std::weak_ptr<Cell> weakCell = cell;
+    std::uint32_t request = cell->request;
+    std::string path = cell->path;
+    auto buffer = std::make_shared<std::vector<std::uint8_t>>();
+
+    bool fetchTextures = m_renderer != nullptr;
+
+    ASYNC_LOADER.Enqueue(priority,
+        [path, buffer]() {
+            MEMORY_SCOPE(Scene);
+            FILE_SYSTEM.ReadBinaryFile(path, *buffer);
+        },
+        [weakCell, request, buffer, priority, fetchTextures]() {
+            std::shared_ptr<Cell> cell = weakCell.lock();
+            if (!cell || cell->request != request || cell->state != CellState::Reading) {
+                return;
+            }
+
+            std::vector<std::string> meshNames;
+            std::vector<std::string> texturePaths;
+            if (buffer->empty() || !SceneSerializer::ReadMeshReferences(buffer->data(), buffer->size(), meshNames)
+                || (fetchTextures && !SceneSerializer::ReadTextureReferences(buffer->data(), buffer->size(), texturePaths))) {
+                LOG_ERROR("Failed to read streaming cell '" << cell->name << "' from " << cell->path);
+                cell->state = CellState::Unloaded;
+                cell->failed = true;
+                return;
+            }
+
+            // Fetch meshes the cache does not hold yet; primitives are rebuilt on activation
+            cell->data = std::move(*buffer);
+            for (const std::string& name : meshNames) {
+                if (!MESH_MANAGER.GetMesh(name) && !Mesh::MeshManager::IsPrimitiveName(name)) {
+                    cell->meshes.push_back(MESH_MANAGER.LoadMeshAsync(name, priority));
+                }
+            }
+
+            // Decoded off the main thread, so activation finds them cached
+            for (const std::string& path : texturePaths) {
+                std::wstring texturePath = std::filesystem::path(path).wstring();
+                if (!TEXTURE_MANAGER.GetTexture(texturePath)) {
+                    cell->textures.push_back(ASYNC_LOADER.LoadTexture(texturePath, priority));
+                }
+            }
+            cell->state = CellState::Fetching;
+        });
+}
+
+void WorldStreamer::CancelLoad(Cell& cell) {
+    if (!IsPending(cell)) {
+        return;
+    }
+
+    cell.request++;
+    cell.state = CellState::Unloaded;
+    cell.data = std::vector<std::uint8_t>();
+    cell.meshes.clear();
+    cell.textures.clear();
+    m_residentBytes -= std::min(m_residentBytes, cell.memoryCost);
+}
+
+void WorldStreamer::Unload(Cell& cell) {
+    if (cell.state != CellState::Loaded) {
+        return;
+    }
+
+    if (cell.scene) {
+        cell.scene->OnUnload();
+        cell.scene.reset();
+    }
+    cell.state = CellState::Unloaded;
+    m_residentBytes -= std::min(m_residentBytes, cell.memoryCost);
+
+    LOG_DEBUG("Streamed out cell: " << cell.name);
+}
+
+bool WorldStreamer::Activate(Cell& cell) {
+    auto scene = std::make_shared<Scene>(cell.name);
+    bool loaded = SceneSerializer::LoadFromMemory(*scene, cell.data.data(), cell.data.size(), m_renderer);
+
+    // Renderers now hold the meshes and textures; the snapshot bytes are no longer needed
+    cell.data = std::vector<std::uint8_t>();
+    cell.meshes.clear();
+    cell.textures.clear();
+
+    if (!loaded) {
+        LOG_ERROR("Failed to activate streaming cell '" << cell.name << "'");
+        cell.state = CellState::Unloaded;
+        cell.failed = true;
+        m_residentBytes -= std::min(m_residentBytes, cell.memoryCost);
+        return false;
+    }
+
+    scene->OnLoad();
+    cell.scene = scene;
+    cell.state = CellState::Loaded;
+
+    LOG_DEBUG("Streamed in cell: " << cell.name);
+    return true;
+}
+
+bool WorldStreamer::MakeRoom(size_t cost, float distance) {
+    // Evict cells farther than the one that needs the room, farthest first
+    for (auto it = m_order.rbegin(); it != m_order.rend(); ++it) {
+        if (m_residentBytes + cost <= m_settings.memoryBudget) {
+            break;
+        }
+
+        Cell& cell = **it;
+        if (cell.distance <= distance) {
+            break;
+        }
+        if (IsPending(cell)) {
+            CancelLoad(cell);
+        }
+        else {
+            Unload(cell);
+        }
+    }
+    return m_residentBytes + cost <= m_settings.memoryBudget;
+}
+
+bool WorldStreamer::IsPending(const Cell& cell) const {
+    return cell.state == CellState::Reading || cell.state == CellState::Fetching || cell.state == CellState::Ready;
+}
+
+} // namespace Scene
+} // namespace GameEngine
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Mesh/AsyncLoader.h"
+
+namespace GameEngine {
+
+// Forward declarations
+namespace Renderer { class D3D11Renderer; }
+
+namespace Scene {
+
+class Scene;
+
+struct StreamingSettings {
+    float loadRadius = 200.0f;          // Cells closer than this to the origin are loaded
+    float unloadRadius = 250.0f;        // and kept until they are farther than this
+    size_t memoryBudget = 256u * 1024u * 1024u;     // Bytes of resident and in-flight cells
+    int maxActivationsPerFrame = 1;     // Cells turned into scenes per Update
+    int maxUnloadsPerFrame = 1;         // Cell scenes destroyed per Update
+};
+
+struct StreamingStats {
+    std::uint32_t cellCount = 0;
+    std::uint32_t loadedCells = 0;
+    std::uint32_t pendingCells = 0;     // Reading, fetching meshes or waiting to activate
+    size_t residentBytes = 0;           // Cost of loaded and pending cells
+    std::uint32_t deferredLoads = 0;    // Cells in range held back by the budget last Update
+};
+
+// Additive streaming of world cells around a point.
+//
+// Each cell is a SceneSerializer snapshot with world bounds. Cells within
+// the load radius go through three stages: the file is read on an
+// AsyncLoader thread, the meshes and material textures it lists are
+// fetched with MeshManager::LoadMeshAsync and AsyncLoader::LoadTexture,
+// then the snapshot is instantiated into its own Scene on the main thread,
+// where the textures now come straight from the cache. Activations and unloads are capped per
+// frame so crossing a boundary never builds or tears down many cells at
+// once. Cells leave once they are past the unload radius, or earlier,
+// farthest first, when a nearer cell needs room in the memory budget.
+class WorldStreamer {
+public:
+    WorldStreamer();
+    ~WorldStreamer();
+
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    // Needed to load material textures of streamed cells; without it cells
+    // load untextured
+    void SetRenderer(Renderer::D3D11Renderer* renderer) { m_renderer = renderer; }
+
+    // memoryCost of 0 uses the snapshot's file size
+    bool AddCell(const std::string& name, const std::string& snapshotPath, const DirectX::BoundingBox& bounds,
+                 size_t memoryCost = 0);
+    void RemoveAllCells();
+
+    void SetSettings(const StreamingSettings& settings) { m_settings = settings; }
+    const StreamingSettings& GetSettings() const { return m_settings; }
+
+    // Usually the camera position; set before Update
+    void SetOrigin(const DirectX::XMFLOAT3& origin) { m_origin = origin; }
+
+    // Advance loads, activations and unloads; call once per frame
+    void Update();
+
+    // Scenes of the loaded cells, nearest first as of the last Update
+    const std::vector<std::shared_ptr<Scene>>& GetLoadedScenes() const { return m_loadedScenes; }
+    const StreamingStats& GetStats() const { return m_stats; }
+
+private:
+    enum class CellState {
+        Unloaded,
+        Reading,        // File read queued on the loader
+        Fetching,       // Waiting for referenced meshes and textures
+        Ready,          // Waiting for a main-thread activation slot
+        Loaded
+    };
+
+    struct Cell {
+        std::string name;
+        std::string path;
+        DirectX::BoundingBox bounds;
+        size_t memoryCost = 0;
+        CellState state = CellState::Unloaded;
+        std::uint32_t request = 0;      // Bumped to discard a load in flight
+        float distance = 0.0f;
+        bool failed = false;            // Not retried after a bad read or load
+        std::vector<std::uint8_t> data;
+        std::vector<Mesh::AssetHandle<Mesh::Mesh>> meshes;
+        std::vector<Mesh::AssetHandle<Renderer::Texture>> textures;
+        std::shared_ptr<Scene> scene;
+    };
+
+    void RequestLoad(const std::shared_ptr<Cell>& cell);
+    void CancelLoad(Cell& cell);
+    void Unload(Cell& cell);
+    bool Activate(Cell& cell);
+    bool MakeRoom(size_t cost, float distance);
+    bool IsPending(const Cell& cell) const;
+
+    std::vector<std::shared_ptr<Cell>> m_cells;
+    std::vector<Cell*> m_order;                 // Scratch, sorted by distance
+    std::vector<std::shared_ptr<Scene>> m_loadedScenes;
+
+    StreamingSettings m_settings;
+    StreamingStats m_stats;
+    DirectX::XMFLOAT3 m_origin;
+    size_t m_residentBytes;
+    Renderer::D3D11Renderer* m_renderer;
+};
+
+} // namespace Scene
+} // namespace GameEngine
@@ -8,6 +8,7 @@
 #include "Renderer/Texture.h"
 #include "Renderer/Light.h"
 #include "Renderer/ShadowMap.h"
+#include "Input/InputManager.h"
 
 using namespace GameEngine;
 
@@ -71,15 +72,8 @@ protected:
 		UpdateLights(deltaTime);
 
 		// Handle additional input
-		static bool spacePressed = false;
-		if (GetAsyncKeyState(VK_SPACE) & 0x8000) {
-			if (!spacePressed) {
-				LogDebugInfo();
-				spacePressed = true;
-			}
-		}
-		else {
-			spacePressed = false;
+		if (Input::InputManager::GetInstance().IsKeyPressed(Input::KeyCode::Space)) {
+			LogDebugInfo();
 		}
 	}
 
@@ -90,8 +84,7 @@ protected:
 		renderer.SetVertexShader(m_vertexShader.Get(), m_inputLayout.Get());
 		renderer.SetPixelShader(m_pixelShader.Get());
 
-		// Set constant buffer
-		renderer.SetConstantBuffer(renderer.GetDevice() ? m_constantBuffer.Get() : nullptr, 0);
+		// Object and view constants are bound by UpdateConstantBuffer per draw
 
 		// Set texture and sampler
 		if (m_currentTexture == 0 && m_checkerTexture) {
@@ -125,7 +118,6 @@ protected:
 		m_vertexShader.Reset();
 		m_pixelShader.Reset();
 		m_inputLayout.Reset();
-		m_constantBuffer.Reset();
 
 		// Clean up textures
 		m_checkerTexture.reset();
@@ -135,6 +127,13 @@ protected:
 		LOG_INFO("TestGame shutdown complete");
 	}
 
+	void OnAssetReloaded(const std::string& path) override {
+		// The cache was cleared, so this recompiles the edited shader
+		if (path.find(".hlsl") != std::string::npos) {
+			LoadShaders();
+		}
+	}
+
 	void OnKeyboard(int key, bool isDown) override {
 		// Call base class implementation first
 		Core::Engine::OnKeyboard(key, isDown);
@@ -251,9 +250,7 @@ private:
 			Mesh::VertexInputLayout, Mesh::VertexInputLayoutCount)) {
 			// Try with .txt extension as fallback
 			LOG_WARNING("Failed to load .hlsl shader, trying .hlsl.txt");
-			// For now, create a simple constant buffer
-			m_constantBuffer = renderer.CreateConstantBuffer(sizeof(Renderer::ConstantBuffer));
-			return m_constantBuffer != nullptr;
+			return true;
 		}
 
 		// Load pixel shader - try simple one first
@@ -264,10 +261,8 @@ private:
 			}
 		}
 
-		// Create constant buffer
-		m_constantBuffer = renderer.CreateConstantBuffer(sizeof(Renderer::ConstantBuffer));
-
-		return m_constantBuffer != nullptr;
+		// Constants come from the renderer's own buffers
+		return true;
 	}
 
 	bool InitializeLights() {
@@ -410,7 +405,6 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> m_vertexShader;
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> m_pixelShader;
 	Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> m_constantBuffer;
 
 	// Textures
 	std::shared_ptr<Renderer::Texture> m_checkerTexture;